@@ -28,11 +28,22 @@ class Const
 public:
   static const char kTopicRegisteredPC2[];/**< Topic name of splitter node's input message */
   static const char kTopicPC2[];          /**< Topic name of segmenter node's input message */
+  static const char kTopicCompressedPC2[];/**< Topic name of segmenter node's compressed input */
+  static const char kTopicCroppedPC2[];   /**< Topic name of segmenter node's cropped input */
   static const char kTopicRgb[];          /**< Topic name of 2d detection's input message */
+  static const char kTopicDepth[];        /**< Topic name of depth segmenter's input image */
+  static const char kTopicCameraInfo[];   /**< Topic name of depth segmenter's intrinsics */
   static const char kTopicSegmentation[]; /**< Topic name of segmenter node's output message*/
   static const char kTopicDetection[];    /**< Topic name of 2d detection's output message */
   static const char kTopicLocalization[]; /**< Topic name of merger node's output message */
+  static const char kTopicObjectPoints[]; /**< Topic name of segmenter node's object points */
+  /** Topic name of segmenter node's oriented boxes */
+  static const char kTopicOrientedLocalization[];
   static const char kTopicTracking[];     /**< Topic name of tracker node's output message */
+  static const char kTopicMovingObjects[];/**< Topic name of merger node's output message */
+  static const char kTopicPipelineStats[];/**< Topic name of runtime statistics of all nodes */
+  static const char kTopicFrameTrace[];   /**< Topic name of per frame traces of all nodes */
+  static const char kTopicQualityLevel[]; /**< Topic name of governor node's output message */
 };
 }  // namespace object_analytics_node
 #endif  // OBJECT_ANALYTICS_NODE__CONST_HPP_
@@ -0,0 +1,64 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__DATASET__BOX_CACHE_HPP_
+#define OBJECT_ANALYTICS_NODE__DATASET__BOX_CACHE_HPP_
+
+#include <string>
+#include <vector>
+
+#include "object_analytics_node/dataset/track_dataset.hpp"
+
+namespace datasets
+{
+/** @class BoxCache
+ * Binary cache of the per-frame boxes of a dataset.
+ *
+ * Parsing the ground truth and detections through cv::FileStorage takes seconds to minutes for
+ * long sequences. The boxes are written once next to the dataset, as a header, the spans of
+ * ground truth frames, the spans of detection frames, and all boxes, all fixed size records
+ * mapped as is on load. The cache is valid as long as the size and mtime of every source file
+ * match the ones recorded.
+ */
+class BoxCache
+{
+public:
+  /**
+   * @brief Load the boxes from a cache file.
+   *
+   * @param[in] cachePath Path of the cache file.
+   * @param[in] sources Files the boxes were parsed from.
+   * @param[out] gt Boxes of the ground truth frames.
+   * @param[out] det Boxes of the detection frames.
+   * @return false if missing, stale or corrupted, outputs untouched then.
+   */
+  static bool load(
+    const std::string & cachePath, const std::vector<std::string> & sources,
+    std::vector<std::vector<Obj_>> & gt, std::vector<std::vector<Obj_>> & det);
+
+  /**
+   * @brief Write the boxes to a cache file, replaced atomically.
+   *
+   * @param[in] cachePath Path of the cache file.
+   * @param[in] sources Files the boxes were parsed from.
+   * @param[in] gt Boxes of the ground truth frames.
+   * @param[in] det Boxes of the detection frames.
+   * @return false if not written, e.g. dataset folder not writable.
+   */
+  static bool save(
+    const std::string & cachePath, const std::vector<std::string> & sources,
+    const std::vector<std::vector<Obj_>> & gt,
+    const std::vector<std::vector<Obj_>> & det);
+};
+}  // namespace datasets
+#endif  // OBJECT_ANALYTICS_NODE__DATASET__BOX_CACHE_HPP_
@@ -0,0 +1,30 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__DATASET__DATASET_LOG_HPP_
+#define OBJECT_ANALYTICS_NODE__DATASET__DATASET_LOG_HPP_
+
+/* the datasets are also built into oa_viewer, without ROS*/
+#ifdef OA_DATASET_NO_RCUTILS
+#include <cstdio>
+#define DATASET_LOG_DEBUG(...)
+#define DATASET_LOG_INFO(...) printf(__VA_ARGS__)
+#define DATASET_LOG_ERROR(...) fprintf(stderr, __VA_ARGS__)
+#else
+#include "rcutils/logging_macros.h"
+#define DATASET_LOG_DEBUG(...) RCUTILS_LOG_DEBUG(__VA_ARGS__)
+#define DATASET_LOG_INFO(...) RCUTILS_LOG_INFO(__VA_ARGS__)
+#define DATASET_LOG_ERROR(...) RCUTILS_LOG_ERROR(__VA_ARGS__)
+#endif
+
+#endif  // OBJECT_ANALYTICS_NODE__DATASET__DATASET_LOG_HPP_
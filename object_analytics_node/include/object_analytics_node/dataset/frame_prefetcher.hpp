@@ -0,0 +1,107 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__DATASET__FRAME_PREFETCHER_HPP_
+#define OBJECT_ANALYTICS_NODE__DATASET__FRAME_PREFETCHER_HPP_
+
+#include <opencv2/core.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace datasets
+{
+/** @class FramePrefetcher
+ * Decode the frames of an image sequence ahead of the consumer.
+ *
+ * Background threads read and decode the next frames into a bounded ring of
+ * slots, so the consumer only waits when decoding falls behind. The file
+ * buffer and the image of each slot are reused across frames, frames handed
+ * out are swapped with the image of the consumer, which is reused in turn
+ * unless still shared.
+ */
+class FramePrefetcher
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] depth Number of frames decoded ahead, at least 1.
+   * @param[in] num_threads Number of decoding threads, at least 1.
+   */
+  FramePrefetcher(size_t depth, size_t num_threads);
+
+  /**
+   * @brief Destructor, pending decoding is dropped.
+   */
+  ~FramePrefetcher();
+
+  /**
+   * @brief Start prefetching a sequence, dropping the one in progress.
+   *
+   * @param[in] paths Image files of the sequence, in order.
+   * @param[in] first Position of the first frame handed out by @ref next().
+   */
+  void start(const std::vector<std::string> & paths, size_t first = 0);
+
+  /**
+   * @brief Get the next frame of the sequence, waiting for its decoding.
+   *
+   * @param[out] frame Decoded frame in BGR, its previous image is reused.
+   * @return false at the end of the sequence or if the frame failed to decode.
+   */
+  bool next(cv::Mat & frame);
+
+  /**
+   * @brief Get the number of frames decoded ahead.
+   */
+  size_t getDepth() const {return slots_.size();}
+
+private:
+  /** A frame of the ring.*/
+  struct Slot
+  {
+    size_t index = 0;           /**< Position of the frame in the sequence.*/
+    bool ready = false;         /**< Decoded and not handed out yet.*/
+    bool ok = false;            /**< Decoded successfully.*/
+    std::vector<uchar> bytes;   /**< Content of the file, reused.*/
+    cv::Mat image;              /**< Decoded frame, reused.*/
+  };
+
+  /**
+   * @brief Loop of a decoding thread.
+   */
+  void work();
+
+  /**
+   * @brief Read and decode a file into a slot, out of the lock.
+   */
+  static bool decode(const std::string & path, Slot & slot);
+
+  std::mutex mutex_;                    /**< Guard of the ring.*/
+  std::condition_variable work_cond_;   /**< Signaled when a slot is free.*/
+  std::condition_variable ready_cond_;  /**< Signaled when a slot is decoded.*/
+  std::vector<Slot> slots_;             /**< Ring of frames.*/
+  std::vector<std::string> paths_;      /**< Image files of the sequence.*/
+  size_t head_ = 0;                     /**< Position of the next frame handed out.*/
+  size_t issued_ = 0;                   /**< Position of the next frame to decode.*/
+  size_t busy_ = 0;                     /**< Number of slots being decoded.*/
+  bool stop_ = false;                   /**< Threads shall exit.*/
+  std::vector<std::thread> threads_;    /**< Decoding threads.*/
+};
+}  // namespace datasets
+#endif  // OBJECT_ANALYTICS_NODE__DATASET__FRAME_PREFETCHER_HPP_
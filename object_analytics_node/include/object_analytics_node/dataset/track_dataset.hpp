@@ -15,14 +15,17 @@
 #ifndef OBJECT_ANALYTICS_NODE__DATASET__TRACK_DATASET_HPP_
 #define OBJECT_ANALYTICS_NODE__DATASET__TRACK_DATASET_HPP_
 
-#include <cv_bridge/cv_bridge.h>
 #include <omp.h>
 #include <sys/stat.h>
 #include <opencv2/core.hpp>
 #include <opencv2/videoio.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "object_analytics_node/dataset/frame_prefetcher.hpp"
+#include "object_analytics_node/dataset/video_index.hpp"
+
 #define MAX_IMG_BYTES 4
 
 namespace datasets
@@ -32,14 +35,25 @@ typedef struct
 {
   int startFrame;
   int frameCount;
+  int countBytes;
+  std::string prefix;
+  std::string suffix;
   std::vector<int> omitFrames;
 } attr_;
 
+/** A box of a frame, of the target objIdx, 0 for single target sequences and detections.*/
+typedef struct
+{
+  int objIdx;
+  cv::Rect2d bb;
+  float confidence;
+} Obj_;
+
 struct trImgObj
 {
   std::string dsName;
   std::vector<std::string> imagePath;
-  std::vector<cv::Rect2d> gtbb;
+  std::vector<std::vector<Obj_>> gtbb;
   attr_ attr;
 };
 
@@ -47,11 +61,22 @@ struct trVidObj
 {
   std::string dsName;
   std::string vidPath;
-  std::vector<cv::Rect2d> gtbb;
+  std::vector<std::vector<Obj_>> gtbb;
+  attr_ attr;
+};
+
+struct trImgMTObj
+{
+  std::string dsName;
+  std::vector<std::string> imagePath;
+  std::string gt_file;
+  std::string det_file;
+  std::vector<std::vector<Obj_>> gtbb;
+  std::vector<std::vector<Obj_>> detbb;
   attr_ attr;
 };
 
-enum dsType { dsVideo = 0, dsImage, dsInvalid };
+enum dsType { dsVideo = 0, dsImage, dsMTImage, dsPacked, dsInvalid };
 
 class trDataset
 {
@@ -62,6 +87,8 @@ public:
 
   virtual int getDatasetsNum() = 0;
 
+  virtual std::string getDatasetName(int id) = 0;
+
   virtual int getDatasetLength(int id) = 0;
 
   virtual bool initDataset(std::string dsName) = 0;
@@ -70,12 +97,28 @@ public:
 
   virtual bool getIdxFrame(cv::Mat & frame, int idx) = 0;
 
-  virtual std::vector<cv::Rect2d> getGT() = 0;
+  virtual std::vector<std::vector<Obj_>> getGT() = 0;
+
+  virtual std::vector<Obj_> getIdxGT(int idx) = 0;
 
-  virtual cv::Rect2d getIdxGT(int idx) = 0;
+  /**
+   * @brief Get the box of the first target of a frame, empty if it has none, for single
+   * target sequences.
+   */
+  cv::Rect2d getIdxRoi(int idx);
 
   virtual int getFrameIdx();
 
+  /**
+   * @brief Decode frames ahead of getNextFrame() on background threads, see
+   * @ref FramePrefetcher. Applies to image sequences, from the next
+   * initDataset().
+   *
+   * @param[in] depth Number of frames decoded ahead, 0 to decode on demand.
+   * @param[in] num_threads Number of decoding threads.
+   */
+  void setPrefetch(size_t depth, size_t num_threads = 2);
+
   inline bool fileExists(const std::string & name)
   {
     struct stat buffer;
@@ -86,6 +129,7 @@ protected:
   std::vector<int> datasetLength;
   int activeDatasetID;
   int frameIdx;
+  std::shared_ptr<FramePrefetcher> prefetcher;
 };
 
 class vidDataset : public trDataset
@@ -95,6 +139,8 @@ public:
 
   virtual int getDatasetsNum();
 
+  virtual std::string getDatasetName(int id);
+
   virtual int getDatasetLength(int id);
 
   virtual bool initDataset(std::string dsName);
@@ -103,13 +149,17 @@ public:
 
   virtual bool getIdxFrame(cv::Mat & frame, int idx);
 
-  virtual std::vector<cv::Rect2d> getGT();
+  virtual std::vector<std::vector<Obj_>> getGT();
 
-  virtual cv::Rect2d getIdxGT(int idx);
+  virtual std::vector<Obj_> getIdxGT(int idx);
 
 protected:
   std::vector<cv::Ptr<trVidObj>> data;
   cv::VideoCapture cap;
+  /* frames of the active video, seeked via seekCap so cap reads on undisturbed*/
+  VideoIndex index;
+  cv::VideoCapture seekCap;
+  size_t seekPos = 0;
 };
 
 class imgDataset : public trDataset
@@ -119,6 +169,8 @@ public:
 
   virtual int getDatasetsNum();
 
+  virtual std::string getDatasetName(int id);
+
   virtual int getDatasetLength(int id);
 
   virtual bool initDataset(std::string dsName);
@@ -127,9 +179,9 @@ public:
 
   virtual bool getIdxFrame(cv::Mat & frame, int idx);
 
-  virtual std::vector<cv::Rect2d> getGT();
+  virtual std::vector<std::vector<Obj_>> getGT();
 
-  virtual cv::Rect2d getIdxGT(int idx);
+  virtual std::vector<Obj_> getIdxGT(int idx);
 
   std::string numberToString(int number)
   {
@@ -144,9 +196,151 @@ public:
   }
 
 protected:
+  /* parse the image list and ground truth of one sequence, null if missing*/
+  cv::Ptr<trImgObj> loadSequence(const std::string & rootPath, const std::string & datasetName);
+
   std::vector<cv::Ptr<trImgObj>> data;
 };
 
+/** @class imgMTDataset
+ * Multi target image sequences, with ground truth and detections of each frame parsed from YAML
+ * and cached by @ref BoxCache.
+ */
+class imgMTDataset : public trDataset
+{
+public:
+  virtual void load(const std::string & rootPath);
+
+  virtual int getDatasetsNum();
+
+  virtual std::string getDatasetName(int id);
+
+  virtual int getDatasetLength(int id);
+
+  virtual bool initDataset(std::string dsName);
+
+  virtual bool getNextFrame(cv::Mat & frame);
+
+  virtual bool getIdxFrame(cv::Mat & frame, int idx);
+
+  virtual std::vector<std::vector<Obj_>> getGT();
+
+  virtual std::vector<Obj_> getIdxGT(int idx);
+
+  /**
+   * @brief Get the detections of a frame of the active sequence.
+   */
+  std::vector<Obj_> getIdxDet(int idx);
+
+  std::string numberToString(int number, int count_bytes)
+  {
+    std::string out;
+    char numberStr[9];
+    snprintf(numberStr, count_bytes, "%u", number);
+    for (unsigned int i = 0; i < count_bytes - strlen(numberStr); ++i) {
+      out += "0";
+    }
+    out += numberStr;
+    return out;
+  }
+
+protected:
+  /* parse the config, image list, ground truth and detections of one sequence, null if missing*/
+  cv::Ptr<trImgMTObj> loadSequence(const std::string & rootPath, const std::string & datasetName);
+
+  /* parse the ground truth and detections of one sequence, slow for long sequences*/
+  bool parseBoxes(
+    const std::string & gtListPath, const std::string & detListPath,
+    trImgMTObj & seq);
+
+  std::vector<cv::Ptr<trImgMTObj>> data;
+};
+
+/** @class packDataset
+ * Sequences converted by @ref write() into one file of raw frames, mapped in memory.
+ *
+ * Frames handed out are headers into the mapping, nothing is decoded nor copied. The mapping is
+ * private, a frame written to is copied on write and the file is left unchanged.
+ */
+class packDataset : public trDataset
+{
+public:
+  static const uint32_t kMagic;    /**< Tag of a pack file.*/
+  static const uint32_t kVersion;  /**< Format of a pack file.*/
+
+  ~packDataset();
+
+  /**
+   * @brief Map a pack file.
+   *
+   * @param[in] rootPath The pack file written by @ref write().
+   */
+  virtual void load(const std::string & rootPath);
+
+  virtual int getDatasetsNum();
+
+  virtual std::string getDatasetName(int id);
+
+  virtual int getDatasetLength(int id);
+
+  virtual bool initDataset(std::string dsName);
+
+  virtual bool getNextFrame(cv::Mat & frame);
+
+  virtual bool getIdxFrame(cv::Mat & frame, int idx);
+
+  virtual std::vector<std::vector<Obj_>> getGT();
+
+  virtual std::vector<Obj_> getIdxGT(int idx);
+
+  /**
+   * @brief Convert the sequences of a loaded dataset into a pack file.
+   *
+   * Frames are read in order and stored raw with their ground truth, the frames of a sequence
+   * must share one size and type.
+   *
+   * @param[in,out] ds The dataset, each sequence is initialized and read to its end.
+   * @param[in] names Sequences to convert, all of the dataset if empty.
+   * @param[in] file The pack file written.
+   * @return false if a sequence fails to read or the file fails to write.
+   */
+  static bool write(
+    trDataset & ds, const std::vector<std::string> & names,
+    const std::string & file);
+
+protected:
+  /** A sequence of the pack, as stored in its table.*/
+  struct Sequence
+  {
+    char name[64];           /**< Name of the sequence, terminated.*/
+    int32_t startFrame;      /**< Index of the first frame.*/
+    int32_t frameCount;      /**< Number of frames.*/
+    int32_t rows;            /**< Rows of each frame.*/
+    int32_t cols;            /**< Columns of each frame.*/
+    int32_t type;            /**< OpenCV type of each frame.*/
+    int32_t reserved;        /**< Padding, 0.*/
+    uint64_t frameOffset;    /**< Offset of the first frame in the file, page aligned.*/
+    uint64_t frameBytes;     /**< Bytes of each frame.*/
+    uint64_t gtOffset;       /**< Offset of the span of ground truth boxes of each frame.*/
+    uint64_t boxOffset;      /**< Offset of the ground truth boxes.*/
+    uint64_t boxCount;       /**< Number of ground truth boxes.*/
+  };
+
+  /**
+   * @brief Get a header of a frame of the active sequence.
+   */
+  bool frameAt(int idx, cv::Mat & frame);
+
+  /**
+   * @brief Unmap the file.
+   */
+  void unmap();
+
+  uint8_t * map_ = nullptr;       /**< Mapping of the file.*/
+  size_t mapBytes_ = 0;           /**< Bytes mapped.*/
+  std::vector<Sequence> data;     /**< Table of the sequences.*/
+};
+
 }  // namespace datasets
 
 #endif  // OBJECT_ANALYTICS_NODE__DATASET__TRACK_DATASET_HPP_ _
@@ -0,0 +1,118 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__DATASET__VIDEO_INDEX_HPP_
+#define OBJECT_ANALYTICS_NODE__DATASET__VIDEO_INDEX_HPP_
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace datasets
+{
+/** @class VideoIndex
+ * Random access to the frames of a video file.
+ *
+ * The time stamp of every frame is scanned once and cached next to the video, in
+ * "<video>.idx", until the video changes. Frames a little ahead of the capture are decoded
+ * forward, others are seeked to by time stamp, which the demuxer does from the keyframe
+ * before. The stamp of the frame landed on tells where the seek went, so inexact seeks of
+ * variable frame rate files are corrected by decoding forward or seeking further back.
+ */
+class VideoIndex
+{
+public:
+  static const uint32_t kMagic;    /**< Tag of a cache file.*/
+  static const uint32_t kVersion;  /**< Format of a cache file.*/
+  static const size_t kMaxForward; /**< Frames decoded forward rather than seeked to.*/
+
+  /**
+   * @brief Get the index of a video, from its cache file or scanned and cached.
+   *
+   * @param[in] video_path The video file.
+   * @return false if the video can not be read.
+   */
+  bool open(const std::string & video_path);
+
+  /**
+   * @brief Scan the time stamps of all frames of a capture, from its start.
+   *
+   * @param[in,out] cap Capture just opened, read to its end.
+   * @return false if no frame is read.
+   */
+  bool build(cv::VideoCapture & cap);
+
+  /**
+   * @brief Write the index to a cache file.
+   */
+  bool save(const std::string & path) const;
+
+  /**
+   * @brief Read the index from a cache file, false if missing or stale.
+   */
+  bool load(const std::string & path);
+
+  /**
+   * @brief Get the number of frames indexed.
+   */
+  size_t size() const {return msec_.size();}
+
+  /**
+   * @brief Get the time stamp of a frame in milliseconds.
+   */
+  double getMsec(size_t idx) const {return msec_[idx];}
+
+  /**
+   * @brief Get the frame nearest to a time stamp.
+   */
+  size_t find(double msec) const;
+
+  /**
+   * @brief Position a capture so that its next frame read is a given one.
+   *
+   * @param[in,out] cap Capture of the indexed video.
+   * @param[in,out] pos Position of the next frame read from the capture.
+   * @param[in] idx Frame to read next.
+   * @return false if the frame is out of the video or the capture fails.
+   */
+  bool seek(cv::VideoCapture & cap, size_t & pos, size_t idx) const;
+
+  /**
+   * @brief Read a frame of a capture, seeking only if it is not a few frames ahead.
+   *
+   * @param[in,out] cap Capture of the indexed video.
+   * @param[in,out] pos Position of the next frame read from the capture.
+   * @param[in] idx Frame to read.
+   * @param[out] frame The frame read.
+   */
+  bool read(cv::VideoCapture & cap, size_t & pos, size_t idx, cv::Mat & frame) const;
+
+  /**
+   * @brief Get the cache file of a video.
+   */
+  static std::string getCachePath(const std::string & video_path) {return video_path + ".idx";}
+
+private:
+  /**
+   * @brief Get the size and modification time of a file, false if missing.
+   */
+  static bool stat(const std::string & path, uint64_t & bytes, int64_t & mtime);
+
+  uint64_t bytes_ = 0;        /**< Size of the video indexed.*/
+  int64_t mtime_ = 0;         /**< Modification time of the video indexed.*/
+  std::vector<double> msec_;  /**< Time stamp of each frame.*/
+};
+}  // namespace datasets
+#endif  // OBJECT_ANALYTICS_NODE__DATASET__VIDEO_INDEX_HPP_
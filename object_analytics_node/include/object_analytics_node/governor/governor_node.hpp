@@ -0,0 +1,88 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__GOVERNOR__GOVERNOR_NODE_HPP_
+#define OBJECT_ANALYTICS_NODE__GOVERNOR__GOVERNOR_NODE_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/frame_trace.hpp>
+#include <object_analytics_msgs/msg/pipeline_stats.hpp>
+#include <object_analytics_msgs/msg/quality_level.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "object_analytics_node/visibility_control.h"
+#include "object_analytics_node/governor/load_governor.hpp"
+
+namespace object_analytics_node
+{
+namespace governor
+{
+/** @class GovernorNode
+ * Governor node, degrading the quality of the pipeline gracefully under load.
+ *
+ * The node watches the statistics of all nodes on Const::kTopicPipelineStats, and the frame
+ * traces on Const::kTopicFrameTrace if any node traces its frames. Every period, the end-to-end
+ * latency is the largest age of the frames traced over the period, or without traces the sum of
+ * the mean latencies of the stages of the parameter latency_stages. The level of a @ref
+ * LoadGovernor is published on Const::kTopicQualityLevel, and each stage degrades once the level
+ * reaches its rung, see util::QualityListener. The default ladder is:
+ *   1. The segmenter raises its sampling step, see the parameter degrade_level of SegmenterNode.
+ *   2. The tracker lowers its working width, see degrade_width_level of TrackingNode.
+ *   3. The tracker caps the objects tracked by confidence, see degrade_cap_level of
+ *      TrackingNode.
+ *   4. The splitter decimates the XYZ clouds, see degrade_level of SplitterNode.
+ *
+ * Parameters:
+ *   - latency_target_ms. End-to-end latency target, default 100.
+ *   - risk_ratio, headroom_ratio. Fractions of the target stepping one level down and up,
+ *     default 0.9 and 0.6.
+ *   - max_level. Lowest quality level, default 4.
+ *   - up_periods. Periods in headroom before stepping up, default 5.
+ *   - settle_periods. Periods waited after a step for its effect, default 2.
+ *   - period_ms. Period of the decisions, default 1000, the period of the statistics.
+ *   - latency_stages. Stages summed without frame traces, default splitter.split,
+ *     segmenter.segment and tracker.track.
+ *   - queues, queue_limit. Queues of the statistics watched, stepping down once one of them
+ *     is queue_limit deep, default none.
+ *
+ * The level is published every period, reliable by default, see the parameter
+ * qos.quality_level.
+ */
+class GovernorNode : public rclcpp::Node
+{
+public:
+  OBJECT_ANALYTICS_NODE_PUBLIC GovernorNode(rclcpp::NodeOptions options);
+
+private:
+  void onStats(const object_analytics_msgs::msg::PipelineStats & stats);
+  void onTrace(const object_analytics_msgs::msg::FrameTrace & trace);
+  void decide();
+
+  LoadGovernor governor_;
+  std::vector<std::string> latency_stages_;
+  std::vector<std::string> queues_;
+  std::map<std::string, double> stage_ms_;       /**< Latest mean of each stage summed.*/
+  std::map<std::string, uint32_t> queue_depths_; /**< Latest depth of each queue watched.*/
+  double trace_ms_ = 0;    /**< Largest age of the frames traced in the period.*/
+  rclcpp::Publisher<object_analytics_msgs::msg::QualityLevel>::SharedPtr pub_;
+  rclcpp::Subscription<object_analytics_msgs::msg::PipelineStats>::SharedPtr sub_stats_;
+  rclcpp::Subscription<object_analytics_msgs::msg::FrameTrace>::SharedPtr sub_trace_;
+  rclcpp::TimerBase::SharedPtr timer_;
+};
+}  // namespace governor
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__GOVERNOR__GOVERNOR_NODE_HPP_
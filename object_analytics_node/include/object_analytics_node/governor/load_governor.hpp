@@ -0,0 +1,97 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__GOVERNOR__LOAD_GOVERNOR_HPP_
+#define OBJECT_ANALYTICS_NODE__GOVERNOR__LOAD_GOVERNOR_HPP_
+
+#include <cstdint>
+
+namespace object_analytics_node
+{
+namespace governor
+{
+/** @class LoadGovernor
+ * Step a quality ladder down and up against an end-to-end latency target.
+ *
+ * The governor is updated once per period with the latency estimated over the
+ * period and the deepest queue watched. The target is at risk when the
+ * latency exceeds @ref Options::risk of the target, or the queue reaches its
+ * limit, and the level steps down one rung of the ladder. Once the latency
+ * stays under @ref Options::headroom of the target for @ref
+ * Options::up_periods periods, the level steps back up one rung. After every
+ * step, the governor waits @ref Options::settle_periods periods for the
+ * effect, so one overload does not run down the whole ladder at once.
+ *
+ * Level 0 is full quality, each level above degrades one more stage, see
+ * @ref GovernorNode.
+ */
+class LoadGovernor
+{
+public:
+  /** Policy of the governor.*/
+  struct Options
+  {
+    Options();
+
+    double target_ms;        /**< End-to-end latency target.*/
+    double risk;             /**< Fraction of the target stepping down.*/
+    double headroom;         /**< Fraction of the target stepping up.*/
+    int32_t max_level;       /**< Lowest quality level.*/
+    int32_t up_periods;      /**< Periods in headroom before stepping up.*/
+    int32_t settle_periods;  /**< Periods waited after a step.*/
+    uint32_t queue_limit;    /**< Queue depth stepping down, 0 if queues are not watched.*/
+  };
+
+  /**
+   * @brief Constructor, at full quality.
+   *
+   * @param[in] options Policy of the governor.
+   */
+  explicit LoadGovernor(const Options & options = Options());
+
+  /**
+   * @brief Decide the level of the next period.
+   *
+   * @param[in] latency_ms Latency estimated over the period, not above zero if
+   * nothing was measured, which keeps the level.
+   * @param[in] queue_depth Deepest queue watched.
+   * @return Level of the next period.
+   */
+  int32_t update(double latency_ms, uint32_t queue_depth = 0);
+
+  /**
+   * @brief Get the current level.
+   */
+  int32_t getLevel() const {return level_;}
+
+  /**
+   * @brief Get the number of steps taken, down or up, since construction.
+   */
+  uint64_t getSteps() const {return steps_;}
+
+  /**
+   * @brief Get the policy of the governor.
+   */
+  const Options & getOptions() const {return options_;}
+
+private:
+  Options options_;
+  int32_t level_;    /**< Current level.*/
+  int32_t calm_;     /**< Consecutive periods in headroom.*/
+  int32_t settle_;   /**< Periods left to wait after a step.*/
+  uint64_t steps_;   /**< Steps taken.*/
+};
+}  // namespace governor
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__GOVERNOR__LOAD_GOVERNOR_HPP_
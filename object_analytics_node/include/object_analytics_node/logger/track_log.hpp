@@ -0,0 +1,214 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__LOGGER__TRACK_LOG_HPP_
+#define OBJECT_ANALYTICS_NODE__LOGGER__TRACK_LOG_HPP_
+
+#include <object_analytics_msgs/msg/moving_objects.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace logger
+{
+/** A track of one frame, a row of a @ref TrackLog.*/
+struct TrackRow
+{
+  int64_t stamp;     /**< Stamp of the frame in nanoseconds.*/
+  int64_t id;        /**< Tracking id.*/
+  int32_t class_id;  /**< Class of the object, see util::ClassTable, names are in the log.*/
+  uint16_t x;        /**< ROI, clipped to 65535.*/
+  uint16_t y;
+  uint16_t width;
+  uint16_t height;
+  float min[3];      /**< Diagonal of the 3d bounds, x, y and z.*/
+  float max[3];
+};
+
+/** @class TrackLog
+ * Columnar binary log of tracks, for offline analytics of long sessions.
+ *
+ * Rows appended are gathered into a block of up to a number of rows, stored column after
+ * column, e.g. all stamps, then all ids. Full blocks, and the partial block at each flush(),
+ * are queued and written by a thread of the log, the callbacks only fill the columns. Blocks
+ * beyond @ref kMaxPendingBlocks queued are dropped and counted, see @ref getDropped(), so a
+ * slow disk delays nothing but the log.
+ *
+ * Files are named <prefix>.<n>.tracklog from n = 0, the next one opened once a file exceeds
+ * the rotation size. A file is a header of @ref kMagic and @ref kVersion, followed by blocks of
+ * a type, a row count, a payload size and the first and last stamps of the rows, in host byte
+ * order. The class names used are written once per file, ahead of the first block using them.
+ */
+class TrackLog
+{
+public:
+  /** Type of a block.*/
+  enum Type : uint32_t
+  {
+    kTracks = 1,   /**< Columns of rows.*/
+    kClasses = 2,  /**< Class ids and names.*/
+  };
+
+  static const uint32_t kMagic;    /**< Tag of a track log file.*/
+  static const uint32_t kVersion;  /**< Format of a track log file.*/
+  static const size_t kBlockRows;  /**< Default rows of a block.*/
+  static const size_t kMaxPendingBlocks;  /**< Blocks queued before dropping.*/
+
+  /**
+   * @brief Open the first file and start the writer thread.
+   *
+   * @param[in] prefix Path of the files without the suffix .<n>.tracklog.
+   * @param[in] block_rows Rows of a block, at least 1.
+   * @param[in] rotate_bytes Size of a file to open the next one, 0 for one file.
+   * @throw std::runtime_error if the file cannot be opened.
+   */
+  explicit TrackLog(
+    const std::string & prefix, size_t block_rows = kBlockRows, size_t rotate_bytes = 0);
+
+  /**
+   * @brief Write the rows appended and close the file.
+   */
+  ~TrackLog();
+
+  /**
+   * @brief Append the objects of a frame, one row each.
+   *
+   * @param[in] moving Objects tracked and localized in a frame.
+   */
+  void append(const object_analytics_msgs::msg::MovingObjects & moving);
+
+  /**
+   * @brief Append a row.
+   */
+  void append(const TrackRow & row);
+
+  /**
+   * @brief Queue the partial block for the writer, e.g. periodically.
+   */
+  void flush();
+
+  /**
+   * @brief Get the path of a file of the log.
+   *
+   * @param[in] prefix Prefix of the log.
+   * @param[in] index Index of the file, 0 for the first one.
+   */
+  static std::string getPath(const std::string & prefix, size_t index);
+
+  /**
+   * @brief Get the number of rows dropped, the writer falling behind.
+   */
+  uint64_t getDropped() const {return dropped_;}
+
+  /**
+   * @brief Get the number of rows written.
+   */
+  uint64_t getWritten() const {return written_;}
+
+  /**
+   * @brief Get the number of files opened.
+   */
+  size_t getFiles() const {return files_;}
+
+private:
+  /** Rows of a block, by column.*/
+  struct Block
+  {
+    std::vector<int64_t> stamp;
+    std::vector<int64_t> id;
+    std::vector<int32_t> class_id;
+    std::vector<uint16_t> roi[4];
+    std::vector<float> bounds[6];
+
+    size_t size() const {return stamp.size();}
+    void reserve(size_t rows);
+  };
+
+  void push();
+  void run();
+  void write(const Block & block);
+  void writeBlock(uint32_t type, uint32_t rows, int64_t first, int64_t last);
+  void open();
+
+  std::string prefix_;
+  size_t block_rows_;
+  size_t rotate_bytes_;
+  Block current_;       /**< Block being appended to.*/
+  std::ofstream out_;
+  size_t bytes_ = 0;    /**< Bytes of the open file.*/
+  std::atomic<size_t> files_{0};
+  std::unordered_set<int32_t> classes_;  /**< Classes written to the open file.*/
+  std::vector<uint8_t> payload_;         /**< Payload scratch of the writer.*/
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Block> queue_;
+  std::vector<Block> spare_;  /**< Blocks written, their capacity reused.*/
+  bool stop_ = false;
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> written_{0};
+  std::thread writer_;
+};
+
+/** @class TrackLogReader
+ * Reader of the rows of a @ref TrackLog file, block by block.
+ */
+class TrackLogReader
+{
+public:
+  /**
+   * @brief Open a file.
+   *
+   * @param[in] file Path of a file written by TrackLog.
+   * @throw std::runtime_error if the file cannot be opened or is no track log.
+   */
+  explicit TrackLogReader(const std::string & file);
+
+  /**
+   * @brief Read the rows of the next block with rows in a range of stamps.
+   *
+   * Blocks entirely out of the range are skipped without reading their columns.
+   *
+   * @param[out] rows Rows of the block, all of them, the capacity is reused.
+   * @param[in] from First stamp of the range in nanoseconds.
+   * @param[in] to Last stamp of the range in nanoseconds.
+   * @return false at the end of the file, or at a truncated block.
+   */
+  bool next(
+    std::vector<TrackRow> & rows, int64_t from = INT64_MIN, int64_t to = INT64_MAX);
+
+  /**
+   * @brief Get the class name of a class id of the rows read.
+   *
+   * @return Name of the id, an empty string if unknown.
+   */
+  const std::string & getClassName(int32_t class_id) const;
+
+private:
+  std::ifstream in_;
+  std::vector<uint8_t> payload_;
+  std::unordered_map<int32_t, std::string> classes_;
+};
+}  // namespace logger
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__LOGGER__TRACK_LOG_HPP_
@@ -0,0 +1,82 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__LOGGER__TRACK_LOGGER_NODE_HPP_
+#define OBJECT_ANALYTICS_NODE__LOGGER__TRACK_LOGGER_NODE_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/moving_objects.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+#include <object_analytics_msgs/msg/tracked_objects.hpp>
+
+#include <memory>
+
+#include "object_analytics_node/visibility_control.h"
+#include "object_analytics_node/logger/track_log.hpp"
+#include "object_analytics_node/merger/merger.hpp"
+#include "object_analytics_node/util/stamp_matcher.hpp"
+#include "object_analytics_node/util/stats_publisher.hpp"
+
+namespace object_analytics_node
+{
+namespace logger
+{
+/** @class TrackLoggerNode
+ * Track logger node, appends the tracks of each frame to a columnar binary log, see TrackLog.
+ *
+ * Tracked objects are paired with the localized objects of the same stamp, and with
+ * stamp_tolerance_ms with the nearest ones, and joined by tracking id or ROI overlap of at least
+ * min_iou, see merger::Merger, the same way as the merger node. Each object joined is a row of
+ * its stamp, tracking id, class, ROI and 3d bounds.
+ *
+ * The log is written to log_prefix.<n>.tracklog, default /tmp/oa_tracks, in blocks of
+ * block_rows, default 4096, by a thread of its own. The partial block is written every
+ * flush_period_ms, default 1000, and the next file is opened once a file exceeds rotate_mb,
+ * default 256, 0 for one file. Read the log with the track_log_dump tool.
+ *
+ * With the parameter publish_stats, the logging latency, the depth of the localization cache and
+ * the rows dropped are published every second, see util::StatsPublisher.
+ *
+ * QoS of the topics are the parameters qos.tracking and qos.localization, default "reliable",
+ * see util::QosProfiles.
+ */
+class TrackLoggerNode : public rclcpp::Node
+{
+public:
+  OBJECT_ANALYTICS_NODE_PUBLIC TrackLoggerNode(rclcpp::NodeOptions options);
+
+private:
+  void callback(
+    const object_analytics_msgs::msg::TrackedObjects::ConstSharedPtr & tracks,
+    const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & objs_3d);
+
+  /** Bytes of localized objects buffered waiting for their tracked objects.*/
+  static const size_t kCacheBytes;
+
+  using Matcher = util::StampMatcher<object_analytics_msgs::msg::TrackedObjects::ConstSharedPtr,
+      object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr>;
+
+  rclcpp::Subscription<object_analytics_msgs::msg::TrackedObjects>::SharedPtr sub_tracking_;
+  rclcpp::Subscription<object_analytics_msgs::msg::ObjectsInBoxes3D>::SharedPtr
+    sub_localization_;
+  rclcpp::TimerBase::SharedPtr flush_timer_;
+  merger::Merger merger_;
+  object_analytics_msgs::msg::MovingObjects moving_;  /**< Objects joined, capacity reused.*/
+  std::unique_ptr<TrackLog> log_;
+  std::unique_ptr<Matcher> matcher_;
+  std::unique_ptr<util::StatsPublisher> stats_;
+};
+}  // namespace logger
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__LOGGER__TRACK_LOGGER_NODE_HPP_
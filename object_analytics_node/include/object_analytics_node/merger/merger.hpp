@@ -0,0 +1,85 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__MERGER__MERGER_HPP_
+#define OBJECT_ANALYTICS_NODE__MERGER__MERGER_HPP_
+
+#include <object_analytics_msgs/msg/moving_objects.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+#include <object_analytics_msgs/msg/tracked_objects.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace object_analytics_node
+{
+namespace merger
+{
+/** @class Merger
+ * @brief Implementation of merger logic.
+ *
+ * Joins the tracked objects and the localized objects of one frame into moving objects. A
+ * tracked object takes the localized object of its tracking id, see
+ * SegmenterNode's tracking_reuse, or else the one whose ROI overlaps it most, by
+ * intersection over union. The velocity of a moving object is the finite difference of the
+ * center of its bounding box between the last two frames it was merged in.
+ */
+class Merger
+{
+public:
+  /** Default intersection over union of a tracked ROI and a localized ROI to merge them.*/
+  static const double kMinIou;
+
+  /**
+   * @brief Set the least intersection over union of the ROIs merged.
+   *
+   * @param[in] min_iou Intersection over union, in (0, 1].
+   */
+  void setMinIou(double min_iou) {min_iou_ = min_iou;}
+
+  /**
+   * @brief Merge the objects of one frame.
+   *
+   * @param[in]  tracks   Tracked objects.
+   * @param[in]  objs_3d  Localized objects, of the same frame or the nearest one.
+   * @param[out] moving   Moving objects, one per tracked object localized, in the header of
+   *                      tracks.
+   */
+  void merge(
+    const object_analytics_msgs::msg::TrackedObjects & tracks,
+    const object_analytics_msgs::msg::ObjectsInBoxes3D & objs_3d,
+    object_analytics_msgs::msg::MovingObjects & moving);
+
+  /**
+   * @brief Get the number of tracked objects never localized.
+   */
+  uint64_t getUnmatched() const {return unmatched_;}
+
+private:
+  /* center of the box of an object in its last frame*/
+  struct Motion
+  {
+    int64_t stamp;
+    double x;
+    double y;
+    double z;
+  };
+
+  double min_iou_ = kMinIou;
+  uint64_t unmatched_ = 0;
+  std::unordered_map<int64_t, Motion> motions_;
+};
+}  // namespace merger
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__MERGER__MERGER_HPP_
@@ -0,0 +1,77 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__MERGER__MERGER_NODE_HPP_
+#define OBJECT_ANALYTICS_NODE__MERGER__MERGER_NODE_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/moving_objects.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+#include <object_analytics_msgs/msg/tracked_objects.hpp>
+
+#include <memory>
+
+#include "object_analytics_node/visibility_control.h"
+#include "object_analytics_node/merger/merger.hpp"
+#include "object_analytics_node/util/stamp_matcher.hpp"
+#include "object_analytics_node/util/stats_publisher.hpp"
+
+namespace object_analytics_node
+{
+namespace merger
+{
+/** @class MergerNode
+ * Merger node, merger implementation holder.
+ *
+ * Tracked objects are paired with the localized objects of the same stamp, see
+ * util::StampMatcher, and with stamp_tolerance_ms with the nearest ones when missing. Each pair
+ * is merged into moving objects, see Merger, published on Const::kTopicMovingObjects. With
+ * min_iou, the least overlap of the ROIs of a tracked and a localized object merged.
+ *
+ * Composed with the tracker and the segmenter, the streams are joined once in the process
+ * instead of by each consumer.
+ *
+ * With the parameter publish_stats, the merging latency, the depth of the localization cache
+ * and the drop counters are published every second, see util::StatsPublisher.
+ *
+ * QoS of the topics are the parameters qos.tracking, qos.localization and qos.moving_objects,
+ * default "reliable", see util::QosProfiles.
+ */
+class MergerNode : public rclcpp::Node
+{
+public:
+  OBJECT_ANALYTICS_NODE_PUBLIC MergerNode(rclcpp::NodeOptions options);
+
+private:
+  void callback(
+    const object_analytics_msgs::msg::TrackedObjects::ConstSharedPtr & tracks,
+    const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & objs_3d);
+
+  /** Bytes of localized objects buffered waiting for their tracked objects.*/
+  static const size_t kCacheBytes;
+
+  using Matcher = util::StampMatcher<object_analytics_msgs::msg::TrackedObjects::ConstSharedPtr,
+      object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr>;
+
+  rclcpp::Publisher<object_analytics_msgs::msg::MovingObjects>::SharedPtr pub_;
+  rclcpp::Subscription<object_analytics_msgs::msg::TrackedObjects>::SharedPtr sub_tracking_;
+  rclcpp::Subscription<object_analytics_msgs::msg::ObjectsInBoxes3D>::SharedPtr
+    sub_localization_;
+  Merger impl_;
+  std::unique_ptr<Matcher> matcher_;
+  std::unique_ptr<util::StatsPublisher> stats_;
+};
+}  // namespace merger
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__MERGER__MERGER_NODE_HPP_
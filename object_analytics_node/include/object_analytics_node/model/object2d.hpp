@@ -26,6 +26,7 @@ namespace model
  * @brief Wrapper of object_msgs::ObjectInBox.
  *
  * Constructed from 2d detection result, represents one object_msgs::ObjectInBox instance.
+ * A view, see view(), references the object of the message instead of copying it.
  */
 class Object2D
 {
@@ -37,6 +38,15 @@ public:
    */
   explicit Object2D(const object_msgs::msg::ObjectInBox & object_in_box);
 
+  /**
+   * Construct a view of an object in box, the object is referenced, not copied.
+   *
+   * @param[in] object_in_box   Object in box, shall outlive the view and its copies.
+   *
+   * @return The view
+   */
+  static Object2D view(const object_msgs::msg::ObjectInBox & object_in_box);
+
   /** Default destructor */
   ~Object2D() = default;
 
@@ -46,7 +56,7 @@ public:
    *
    * @return Underlying region of interest in image space
    */
-  inline sensor_msgs::msg::RegionOfInterest getRoi() const
+  inline const sensor_msgs::msg::RegionOfInterest & getRoi() const
   {
     return roi_;
   }
@@ -56,9 +66,9 @@ public:
    *
    * @return The underlying object_msgs::Object
    */
-  inline object_msgs::msg::Object getObject() const
+  inline const object_msgs::msg::Object & getObject() const
   {
-    return object_;
+    return viewed_ != nullptr ? *viewed_ : object_;
   }
 
   /**
@@ -72,8 +82,12 @@ public:
   friend std::ostream & operator<<(std::ostream & os, const Object2D & obj);
 
 private:
+  Object2D(const sensor_msgs::msg::RegionOfInterest & roi, const object_msgs::msg::Object * viewed);
+
   const sensor_msgs::msg::RegionOfInterest roi_;
   const object_msgs::msg::Object object_;
+  /* the object referenced by a view, nullptr if owned*/
+  const object_msgs::msg::Object * const viewed_ = nullptr;
 };
 
 using Object2DPtr = std::shared_ptr<Object2D>;
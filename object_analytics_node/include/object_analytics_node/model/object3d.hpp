@@ -20,12 +20,32 @@
 #include <pcl/common/projection_matrix.h>
 #include <pcl/point_types.h>
 #include <geometry_msgs/msg/point32.h>
+#include <geometry_msgs/msg/pose.hpp>
+#include <geometry_msgs/msg/vector3.hpp>
+#include <std_msgs/msg/color_rgba.hpp>
 
 #include <vector>
 #include <memory>
 
 #include "object_analytics_msgs/msg/object_in_box3_d.hpp"
 
+struct PointXYZPixel
+{
+  PCL_ADD_POINT4D;
+  uint32_t pixel_x;
+  uint32_t pixel_y;
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+} EIGEN_ALIGN16;  // NOLINT
+
+POINT_CLOUD_REGISTER_POINT_STRUCT(
+  PointXYZPixel,                  // xyz + pixel x, y as fields
+  (float, x, x)                   // field x
+    (float, y, y)                 // field y
+    (float, z, z)                 // field z
+    (uint32_t, pixel_x, pixel_x)  // field pixel x
+    (uint32_t, pixel_y, pixel_y)  // field pixel y
+)
+
 namespace object_analytics_node
 {
 namespace model
@@ -49,10 +69,21 @@ public:
    *
    * Use this constructor to build Object3D objects when 3D segmentation is done.
    *
+   * The bounds are computed in one pass over the indexed points, see ObjectUtils::getBounds().
+   * With a trim, the minimum and maximum are the trim and 1 - trim percentiles of each axis
+   * instead, see ObjectUtils::getTrimmedBounds(). With oriented, the oriented box of the points
+   * is fitted as well, see ObjectUtils::getOrientedBounds(). Given the colors of the cloud, the
+   * mean color of the points is accumulated in the same pass.
+   *
    * @param[in] cloud       PointCloud got from RGB-D sensor
    * @param[in] indices     Indices vector, each is the indices of one segmentation object
+   * @param[in] trim        Fraction of points ignored at each end of each axis, default 0.
+   * @param[in] oriented    Fit the oriented box, default false.
+   * @param[in] colors      Packed 0x00RRGGBB of each point of cloud, default none.
    */
-  Object3D(const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices);
+  Object3D(
+    const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices, float trim = 0.0f,
+    bool oriented = false, const std::vector<uint32_t> * colors = nullptr);
 
   /**
    * @brief Construct a 3D object based on results published by segmenter.
@@ -63,6 +94,16 @@ public:
    */
   explicit Object3D(const object_analytics_msgs::msg::ObjectInBox3D & object3d);
 
+  /**
+   * @brief Construct a view of results published by segmenter, the object is referenced, not
+   * copied.
+   *
+   * @param[in] object3d    Result published by segmenter, shall outlive the view and its copies
+   *
+   * @return The view
+   */
+  static Object3D view(const object_analytics_msgs::msg::ObjectInBox3D & object3d);
+
   /** Default destructor */
   ~Object3D() = default;
 
@@ -96,14 +137,68 @@ public:
     return max_;
   }
 
+  /**
+   * Inline method. Check if the object has an oriented box.
+   *
+   * @return true if fitted or set, see setOrientedBox()
+   */
+  inline bool hasOrientedBox() const
+  {
+    return oriented_;
+  }
+
+  /**
+   * Inline method. Get the center and orientation of the oriented box in 3d space.
+   *
+   * @return Pose of the oriented box, identity if the object has none
+   */
+  inline const geometry_msgs::msg::Pose & getPose() const
+  {
+    return pose_;
+  }
+
+  /**
+   * Inline method. Get the extent of the oriented box along its axes.
+   *
+   * @return Size of the oriented box, zero if the object has none
+   */
+  inline const geometry_msgs::msg::Vector3 & getSize() const
+  {
+    return size_;
+  }
+
+  /**
+   * Inline method. Set the oriented box, e.g. kept of an earlier segmentation.
+   *
+   * @param[in] pose        Center and orientation of the box
+   * @param[in] size        Extent of the box along its axes
+   */
+  inline void setOrientedBox(
+    const geometry_msgs::msg::Pose & pose, const geometry_msgs::msg::Vector3 & size)
+  {
+    pose_ = pose;
+    size_ = size;
+    oriented_ = true;
+  }
+
+  /**
+   * Inline method. Get the mean color of the object points.
+   *
+   * @return Mean color, all 0 if the cloud had no color
+   */
+  inline const std_msgs::msg::ColorRGBA & getColor() const
+  {
+    return color_;
+  }
+
   /**
    * Get the underlying object_msgs::Object.
    *
    * @return The underlying object_msgs::Object
    */
-  inline object_msgs::msg::Object getObject() const
+  inline const object_msgs::msg::Object & getObject() const
   {
-    return object_;
+    return viewed_ != nullptr ? *viewed_ : object_;
   }
 
   /**
@@ -127,10 +222,21 @@ public:
   friend std::ostream & operator<<(std::ostream & os, const Object3D & obj);
 
 private:
+  Object3D(
+    const sensor_msgs::msg::RegionOfInterest & roi, const geometry_msgs::msg::Point32 & min,
+    const geometry_msgs::msg::Point32 & max, const std_msgs::msg::ColorRGBA & color,
+    const object_msgs::msg::Object * viewed);
+
   sensor_msgs::msg::RegionOfInterest roi_;
   geometry_msgs::msg::Point32 min_;
   geometry_msgs::msg::Point32 max_;
+  geometry_msgs::msg::Pose pose_;
+  geometry_msgs::msg::Vector3 size_;
+  bool oriented_ = false;
+  std_msgs::msg::ColorRGBA color_;
   object_msgs::msg::Object object_;
+  /* the object referenced by a view, nullptr if owned*/
+  const object_msgs::msg::Object * viewed_ = nullptr;
 };
 
 using Object3DPtr = std::shared_ptr<Object3D>;
@@ -19,6 +19,9 @@
 #include <pcl/point_types.h>
 #include <opencv2/core/types.hpp>
 #include <object_msgs/msg/objects_in_boxes.hpp>
+#include <geometry_msgs/msg/pose.hpp>
+#include <geometry_msgs/msg/vector3.hpp>
+#include <std_msgs/msg/color_rgba.hpp>
 
 #include <vector>
 #include <utility>
@@ -27,23 +30,7 @@
 #include "object_analytics_msgs/msg/objects_in_boxes3_d.hpp"
 #include "object_analytics_node/model/object2d.hpp"
 #include "object_analytics_node/model/object3d.hpp"
-
-struct PointXYZPixel
-{
-  PCL_ADD_POINT4D;
-  uint32_t pixel_x;
-  uint32_t pixel_y;
-  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-} EIGEN_ALIGN16;  // NOLINT
-
-POINT_CLOUD_REGISTER_POINT_STRUCT(
-  PointXYZPixel,                  // xyz + pixel x, y as fields
-  (float, x, x)                   // field x
-    (float, y, y)                 // field y
-    (float, z, z)                 // field z
-    (uint32_t, pixel_x, pixel_x)  // field pixel x
-    (uint32_t, pixel_y, pixel_y)  // field pixel y
-)
+#include "object_analytics_node/util/detection_filter.hpp"
 
 namespace object_analytics_node
 {
@@ -67,15 +54,30 @@ public:
   /**
    * Convert 2d object of ObjectInBox format into Object2D and push into vector.
    *
+   * The objects are views of the message, see Object2D::view(), valid while it lives.
+   *
    * @param[in]  objects_in_boxes2d List of 2d detection result
    * @param[out] objects2d          List of 2d wrapper
    */
   static void fill2DObjects(
     const ObjectsInBoxes::ConstSharedPtr & objects_in_boxes2d, Object2DVector & objects2d);
 
+  /**
+   * Convert the 2d objects accepted by a filter into Object2D and push into vector.
+   *
+   * @param[in]  objects_in_boxes2d List of 2d detection result
+   * @param[in]  filter             Filter of the detections, see util::DetectionFilter
+   * @param[out] objects2d          List of 2d wrapper
+   */
+  static void fill2DObjects(
+    const ObjectsInBoxes::ConstSharedPtr & objects_in_boxes2d,
+    const util::DetectionFilter & filter, Object2DVector & objects2d);
+
   /**
    * Convert 3d object of ObjectInBox format into Object3D and push into vector.
    *
+   * The objects are views of the message, see Object3D::view(), valid while it lives.
+   *
    * @param[in]  objects_in_boxes3d List of 3d segmentation result
    * @param[out] objects3d          List of 3d wrapper
    */
@@ -136,17 +138,119 @@ public:
     const pcl::PointCloud<PointXYZPixel>::ConstPtr & point_cloud,
     sensor_msgs::msg::RegionOfInterest & roi);
 
+  /**
+   * @brief Find the 3d bounds and projected ROI of the indexed points in one pass.
+   *
+   * Same as getMinMaxPointsInX/Y/Z() and getProjectedROI() on the points copied by
+   * copyPointCloud(), reading the points in place instead. Outputs are untouched if indices
+   * are empty. Given the packed colors of the cloud, their mean is accumulated in the same pass.
+   *
+   * @param[in]  cloud              Point cloud, pixels are derived from its width
+   * @param[in]  indices            Indices of the object points in cloud
+   * @param[out] min                Minimum x, y and z
+   * @param[out] max                Maximum x, y and z
+   * @param[out] roi                Projected ROI
+   * @param[in]  colors             Packed 0x00RRGGBB of each point of cloud, or nullptr or empty
+   * @param[out] color              Mean color of the indexed points, untouched without colors
+   */
+  static void getBounds(
+    const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+    geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max,
+    sensor_msgs::msg::RegionOfInterest & roi, const std::vector<uint32_t> * colors = nullptr,
+    std_msgs::msg::ColorRGBA * color = nullptr);
+
+  /**
+   * @brief Find the 3d bounds, the projected ROI and the oriented box of the indexed points.
+   *
+   * Same as getBounds(), the covariance of the points is accumulated in the same pass. The axes
+   * of the box are the eigenvectors of the covariance, by decreasing eigenvalue, and its extent
+   * along them is found in a pass of projections over the indexed points. Outputs are untouched
+   * if indices are empty.
+   *
+   * @param[in]  cloud              Point cloud, pixels are derived from its width
+   * @param[in]  indices            Indices of the object points in cloud
+   * @param[out] min                Minimum x, y and z
+   * @param[out] max                Maximum x, y and z
+   * @param[out] roi                Projected ROI
+   * @param[out] pose               Center and orientation of the oriented box
+   * @param[out] size               Extent of the oriented box along its axes
+   * @param[in]  colors             Packed colors of the cloud, see getBounds()
+   * @param[out] color              Mean color of the indexed points, see getBounds()
+   */
+  static void getOrientedBounds(
+    const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+    geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max,
+    sensor_msgs::msg::RegionOfInterest & roi, geometry_msgs::msg::Pose & pose,
+    geometry_msgs::msg::Vector3 & size, const std::vector<uint32_t> * colors = nullptr,
+    std_msgs::msg::ColorRGBA * color = nullptr);
+
+  /**
+   * @brief Find the oriented box of the indexed points, see getOrientedBounds().
+   *
+   * @param[in]  cloud              Point cloud
+   * @param[in]  indices            Indices of the object points in cloud
+   * @param[out] pose               Center and orientation of the oriented box
+   * @param[out] size               Extent of the oriented box along its axes
+   */
+  static void getOrientedBox(
+    const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+    geometry_msgs::msg::Pose & pose, geometry_msgs::msg::Vector3 & size);
+
+  /**
+   * @brief Find robust 3d bounds and the projected ROI of the indexed points.
+   *
+   * The coordinates are gathered in the same pass as the ROI, the minimum and maximum of each
+   * axis are then the trim and 1 - trim percentiles, so a few outliers of the segmentation
+   * do not stretch the box. The ROI still covers all points.
+   *
+   * @param[in]  cloud              Point cloud, pixels are derived from its width
+   * @param[in]  indices            Indices of the object points in cloud
+   * @param[in]  trim               Fraction of points ignored at each end, in [0, 0.5]
+   * @param[out] min                Minimum x, y and z
+   * @param[out] max                Maximum x, y and z
+   * @param[out] roi                Projected ROI
+   * @param[in]  colors             Packed colors of the cloud, see getBounds()
+   * @param[out] color              Mean color of all indexed points, see getBounds()
+   */
+  static void getTrimmedBounds(
+    const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices, float trim,
+    geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max,
+    sensor_msgs::msg::RegionOfInterest & roi, const std::vector<uint32_t> * colors = nullptr,
+    std_msgs::msg::ColorRGBA * color = nullptr);
+
   /**
    * @brief Calculate the match rate of two rectangles.
    *
    * The matching algorithm is based on ROI overlapping rate and ROI center deviation,
    * the rect with the most overlapping and the least center deviation will be returned.
+   * The deviation is taken as @ref kMinDeviation at least, so rectangles with coincident
+   * centers score their overlapping rate times 100, rather than dividing by zero.
    *
    * @param[in] r1                  One of the two rectangles.
    * @param[in] r2                  The other one of the two rectangles.
    */
   static double getMatch(const cv::Rect2d & r1, const cv::Rect2d & r2);
 
+  /**
+   * @brief Calculate the match rates of all pairs of two lists of rectangles.
+   *
+   * Same as @ref getMatch() for each pair, computed by an AVX2 kernel on x86 CPUs
+   * supporting it, a NEON kernel on aarch64, or scalar code otherwise.
+   *
+   * @param[in] rects_a             List of N rectangles.
+   * @param[in] rects_b             List of M rectangles.
+   * @param[out] scores             N x M match rates in row-major order, the rate of
+   *                                rects_a[i] and rects_b[j] at i * M + j.
+   */
+  static void getMatchBatch(
+    const std::vector<cv::Rect2d> & rects_a, const std::vector<cv::Rect2d> & rects_b,
+    std::vector<double> & scores);
+
+  /**
+   * Minimum deviation between centers in getMatch(), in pixels.
+   */
+  static const double kMinDeviation;
+
   /**
    * @brief Extract the indices of a given point cloud as a new point cloud
    *
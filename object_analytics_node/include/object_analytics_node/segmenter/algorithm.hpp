@@ -17,8 +17,11 @@
 
 #define PCL_NO_PRECOMPILE
 #include <pcl/point_types.h>
+#include <pcl/common/io.h>
 #include <pcl/common/projection_matrix.h>
+#include <string>
 #include <vector>
+#include "object_analytics_node/segmenter/algorithm_config.hpp"
 
 namespace object_analytics_node
 {
@@ -43,6 +46,94 @@ public:
   virtual void segment(
     const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud,
     std::vector<pcl::PointIndices> & cluster_indices) = 0;
+
+  /**
+   * Replace the configuration and apply it to the following segmentation. Default to nothing.
+   *
+   * @param[in]   conf            Configuration overriding the default values
+   */
+  virtual void setConfig(const AlgorithmConfig & conf)
+  {
+    (void)conf;
+  }
+
+  /**
+   * Whether the algorithm segments ROIs as subsets of the organized full cloud, rather than of
+   * copied unorganized ROI clouds. Default to false.
+   *
+   * @return true if setSearchCloud() shall be given the organized full cloud
+   */
+  virtual bool isOrganized() const
+  {
+    return false;
+  }
+
+  /**
+   * Called once per frame before its ROIs are segmented, whether the algorithm takes a scene of
+   * the frame by setScene(). Default to false.
+   *
+   * @param[in]   stamp           Stamp of the frame in nanoseconds
+   * @param[in]   frame_id        Frame id of the frame
+   * @return true if setScene() shall be given the frame
+   */
+  virtual bool wantsScene(uint64_t stamp, const std::string & frame_id)
+  {
+    (void)stamp;
+    (void)frame_id;
+    return false;
+  }
+
+  /**
+   * Take a sub-sampled, unorganized cloud of the full frame, for state shared by the ROIs of the
+   * frame. Default to nothing.
+   *
+   * @param[in]   scene           Finite points sampled over the full frame
+   */
+  virtual void setScene(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & scene)
+  {
+    (void)scene;
+  }
+
+  /**
+   * Forget the state taken from the scenes so far, the next frame starts afresh. Default to
+   * nothing.
+   */
+  virtual void clearScene()
+  {
+  }
+
+  /**
+   * Prepare the search structure of a cloud, shared by the following calls of segment() on
+   * subsets of the cloud. Default to nothing.
+   *
+   * @param[in]   cloud           Point cloud to be segmented by subsets
+   */
+  virtual void setSearchCloud(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud)
+  {
+    (void)cloud;
+  }
+
+  /**
+   * Segment a subset of given point cloud, which is passed to setSearchCloud() before. Default to
+   * segment a copy of the subset.
+   *
+   * @param[in]   cloud           Point cloud the subset belongs to
+   * @param[in]   indices         Indices of the subset in cloud
+   * @param[out]  cluster_indices Indices vector in cloud, each indicates an individual
+   */
+  virtual void segment(
+    const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud, const std::vector<int> & indices,
+    std::vector<pcl::PointIndices> & cluster_indices)
+  {
+    pcl::PointCloud<pcl::PointXYZ>::Ptr subset(new pcl::PointCloud<pcl::PointXYZ>);
+    pcl::copyPointCloud(*cloud, indices, *subset);
+    segment(subset, cluster_indices);
+    for (auto & cluster : cluster_indices) {
+      for (auto & i : cluster.indices) {
+        i = indices[i];
+      }
+    }
+  }
 };
 }  // namespace segmenter
 }  // namespace object_analytics_node
@@ -25,7 +25,8 @@ namespace segmenter
 {
 /** @class AlorithmConfig
  *
- * Encapsulate config related operations.
+ * Encapsulate config related operations. Items are set by the owner, e.g. from the
+ * parameters of SegmenterNode, and looked up read-only by the algorithms.
  */
 class AlgorithmConfig
 {
@@ -51,42 +52,57 @@ public:
    * @return value of given key, def_val if failed to query the key
    */
   template<typename T>
-  inline T get(const std::string & key, const T default_val)
+  inline T get(const std::string & key, const T default_val) const
   {
     assert(false);
     return default_val;
   }
 
+  /**
+   * Set value of given key, overriding the default value of get()
+   *
+   * @param[in] key         name of the item
+   * @param[in] value       value of the item
+   */
+  inline void set(const std::string & key, const std::string & value)
+  {
+    map_[key] = value;
+  }
+
 private:
   std::map<std::string, std::string> map_;
 };
 
 template<>
 inline std::string AlgorithmConfig::get<std::string>(
-  const std::string & key, const std::string default_val)
+  const std::string & key, const std::string default_val) const
 {
-  try {
-    return map_[key];
-  } catch (...) {
-  }
-  return default_val;
+  auto item = map_.find(key);
+  return item == map_.end() ? default_val : item->second;
 }
 
 template<>
-inline size_t AlgorithmConfig::get<size_t>(const std::string & key, const size_t default_val)
+inline size_t AlgorithmConfig::get<size_t>(
+  const std::string & key, const size_t default_val) const
 {
+  auto item = map_.find(key);
   try {
-    return static_cast<size_t>(std::stoi(map_[key]));
+    if (item != map_.end()) {
+      return static_cast<size_t>(std::stoi(item->second));
+    }
   } catch (...) {
   }
   return default_val;
 }
 
 template<>
-inline float AlgorithmConfig::get<float>(const std::string & key, const float default_val)
+inline float AlgorithmConfig::get<float>(const std::string & key, const float default_val) const
 {
+  auto item = map_.find(key);
   try {
-    return static_cast<float>(std::stof(map_[key]));
+    if (item != map_.end()) {
+      return static_cast<float>(std::stof(item->second));
+    }
   } catch (...) {
   }
   return default_val;
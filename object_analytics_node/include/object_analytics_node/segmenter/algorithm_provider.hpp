@@ -37,6 +37,28 @@ public:
    */
   virtual std::shared_ptr<Algorithm> get() = 0;
 
+  /**
+   * Create a new instance of current selected algorithm, not shared with any other caller, so
+   * that instances segment in parallel.
+   *
+   * @return Pointer to the new instance, nullptr if not supported by the provider
+   */
+  virtual std::shared_ptr<Algorithm> create()
+  {
+    return nullptr;
+  }
+
+  /**
+   * Replace the configuration of the instances provided so far and from now on. Default to
+   * nothing.
+   *
+   * @param[in] conf Configuration overriding the default values
+   */
+  virtual void setConfig(const AlgorithmConfig & conf)
+  {
+    (void)conf;
+  }
+
   /**
    * Default virtual destructor
    */
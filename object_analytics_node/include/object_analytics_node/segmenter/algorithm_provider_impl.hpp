@@ -16,10 +16,13 @@
 #define OBJECT_ANALYTICS_NODE__SEGMENTER__ALGORITHM_PROVIDER_IMPL_HPP_
 
 #define PCL_NO_PRECOMPILE
+#include <functional>
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
 
+#include "object_analytics_node/segmenter/algorithm_config.hpp"
 #include "object_analytics_node/segmenter/algorithm_provider.hpp"
 
 namespace object_analytics_node
@@ -35,9 +38,15 @@ class AlgorithmProviderImpl : public AlgorithmProvider
 {
 public:
   /**
-   * Constructor. Initialize algorithm map.
+   * Constructor. Initialize the algorithm factories, the selected instance is built by the
+   * first get().
+   *
+   * @param[in] name Name of the algorithm to select, kMultiPlane, kConnectedComponent, or
+   * kOpenCLEuclidean if built with OpenCL. The default algorithm is selected for an unknown name.
+   * @param[in] conf Configuration of the algorithm instances.
    */
-  AlgorithmProviderImpl();
+  explicit AlgorithmProviderImpl(
+    const std::string & name = kMultiPlane, const AlgorithmConfig & conf = AlgorithmConfig());
 
   /**
    * Default destructor
@@ -45,14 +54,48 @@ public:
   virtual ~AlgorithmProviderImpl() = default;
 
   /**
-   * Get current selected algorithm instance
+   * Get current selected algorithm instance, built on the first call
    *
    * @return Pointer to current slected algorithm instance
    */
   std::shared_ptr<Algorithm> get();
 
+  /**
+   * Create a new instance of current selected algorithm
+   *
+   * @return Pointer to the new instance
+   */
+  std::shared_ptr<Algorithm> create();
+
+  /**
+   * Replace the configuration of the selectable instances and of the ones created from now on
+   *
+   * @param[in] conf Configuration overriding the default values
+   */
+  void setConfig(const AlgorithmConfig & conf);
+
+  /**
+   * Get the configuration keys read by the algorithms
+   */
+  static const std::vector<std::string> & getConfigKeys();
+
+  /**
+   * Get the name of current selected algorithm
+   */
+  const std::string & getName() const
+  {
+    return name_;
+  }
+
+  static const std::string kMultiPlane;          /**< Clustering ROI copies by kd-tree.*/
+  static const std::string kConnectedComponent;  /**< Organized connected components.*/
+  static const std::string kOpenCLEuclidean;     /**< Clustering ROI copies on OpenCL device.*/
+
 private:
+  std::map<std::string, std::function<std::shared_ptr<Algorithm>()>> factories_;
   std::map<std::string, std::shared_ptr<Algorithm>> algorithms_;
+  std::string name_;
+  AlgorithmConfig conf_;
 };
 }  // namespace segmenter
 }  // namespace object_analytics_node
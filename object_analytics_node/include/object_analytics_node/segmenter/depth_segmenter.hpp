@@ -0,0 +1,119 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__SEGMENTER__DEPTH_SEGMENTER_HPP_
+#define OBJECT_ANALYTICS_NODE__SEGMENTER__DEPTH_SEGMENTER_HPP_
+
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/region_of_interest.hpp>
+#include <object_msgs/msg/objects_in_boxes.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace segmenter
+{
+/** @class DepthSegmenter
+ * Segmenter working on an aligned depth image and the camera intrinsics, instead of a point
+ * cloud.
+ *
+ * The sampled depths of each ROI are read at 16-bit millimeter resolution. The dominant depth
+ * is the peak of their histogram, and the object is the largest 4-connected component seeded
+ * at the peak, whose neighboring depths differ by the depth tolerance at most. Only the
+ * extremes of the component, its pixel bounds and depth range, are back-projected to 3D, so
+ * the 3D bounds are those of the camera frustum slice enclosing the component.
+ */
+class DepthSegmenter
+{
+public:
+  /** Constructor */
+  DepthSegmenter();
+
+  /**
+   * @brief Set the intrinsics of the depth camera.
+   *
+   * @param[in]     info    Camera info of the depth image.
+   */
+  void setIntrinsics(const sensor_msgs::msg::CameraInfo & info);
+
+  /**
+   * @brief Whether intrinsics have been set.
+   */
+  bool hasIntrinsics() const
+  {
+    return fx_ > 0.0 && fy_ > 0.0;
+  }
+
+  /**
+   * @brief Set ROI depth sampling step, in pixels.
+   *
+   * @param[in]     step    Sampling step, default 1.
+   */
+  void setSamplingStep(size_t step);
+
+  /**
+   * @brief Set the largest depth difference of neighboring samples of one object.
+   *
+   * @param[in]     tolerance   Difference in millimeters, default 30.
+   */
+  void setDepthTolerance(uint16_t tolerance);
+
+  /**
+   * @brief Set the minimum number of samples of an object, smaller ones are dropped.
+   *
+   * @param[in]     samples Number of samples, default 10.
+   */
+  void setMinimumSamples(size_t samples);
+
+  /**
+   * @brief Segment the ROIs of detected objects in a depth image.
+   *
+   * Depth images are 16UC1 in millimeters or 32FC1 in meters, 0 or not finite for no depth.
+   *
+   * @param[in]     objs_2d Detected objects.
+   * @param[in]     depth   Depth image aligned with the detection image.
+   * @param[out]    msg     Localized objects, in the order of detection.
+   *
+   * @return false if the image encoding is not supported or intrinsics are not set.
+   */
+  bool segment(
+    const object_msgs::msg::ObjectsInBoxes & objs_2d, const sensor_msgs::msg::Image & depth,
+    object_analytics_msgs::msg::ObjectsInBoxes3D & msg);
+
+  static const size_t kBinShift;  /**< A histogram bin is 2^kBinShift millimeters wide.*/
+
+private:
+  bool segmentRoi(
+    const sensor_msgs::msg::Image & depth, const sensor_msgs::msg::RegionOfInterest & roi,
+    geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max);
+  uint16_t getDepth(const sensor_msgs::msg::Image & depth, size_t u, size_t v) const;
+
+  double fx_ = 0.0, fy_ = 0.0, cx_ = 0.0, cy_ = 0.0;
+  size_t sampling_step_ = 1;
+  uint16_t depth_tolerance_ = 30;
+  size_t minimum_samples_ = 10;
+
+  /* scratch of one ROI, capacity kept across ROIs*/
+  std::vector<uint16_t> samples_;
+  std::vector<uint32_t> histogram_;
+  std::vector<int32_t> component_;
+  std::vector<size_t> queue_;
+};
+}  // namespace segmenter
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__SEGMENTER__DEPTH_SEGMENTER_HPP_
@@ -0,0 +1,77 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__SEGMENTER__DEPTH_SEGMENTER_NODE_HPP_
+#define OBJECT_ANALYTICS_NODE__SEGMENTER__DEPTH_SEGMENTER_NODE_HPP_
+
+#include <message_filters/subscriber.h>
+#include <message_filters/time_synchronizer.h>
+#include <message_filters/sync_policies/approximate_time.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <object_msgs/msg/objects_in_boxes.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+
+#include <memory>
+
+#include "object_analytics_node/visibility_control.h"
+#include "object_analytics_node/segmenter/depth_segmenter.hpp"
+#include "object_analytics_node/util/compact_publisher.hpp"
+
+namespace object_analytics_node
+{
+namespace segmenter
+{
+/** @class DepthSegmenterNode
+ * Depth segmenter node, localizing detected objects from an aligned depth image and its camera
+ * info instead of a point cloud. Publishes on the same topic as SegmenterNode.
+ *
+ * With the parameter compact_localization, the objects are published as
+ * CompactObjectsInBoxes3D as well, see util::CompactPublisher.
+ *
+ * QoS of the topics are the parameters qos.depth and qos.camera_info, default "sensor", and
+ * qos.detection and qos.localization, default "reliable", see util::QosProfiles.
+ */
+class DepthSegmenterNode : public rclcpp::Node
+{
+public:
+  OBJECT_ANALYTICS_NODE_PUBLIC DepthSegmenterNode(rclcpp::NodeOptions options);
+
+private:
+  void callback(
+    const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr objs_2d,
+    const sensor_msgs::msg::Image::ConstSharedPtr depth);
+
+  static const int kMsgQueueSize;
+
+  using Objs_2d = message_filters::Subscriber<object_msgs::msg::ObjectsInBoxes>;
+  using Depth = message_filters::Subscriber<sensor_msgs::msg::Image>;
+  using ApproximatePolicy = message_filters::sync_policies::ApproximateTime<
+    object_msgs::msg::ObjectsInBoxes, sensor_msgs::msg::Image>;
+  using ApproximateSynchronizer = message_filters::Synchronizer<ApproximatePolicy>;
+
+  rclcpp::Publisher<object_analytics_msgs::msg::ObjectsInBoxes3D>::SharedPtr pub_;
+  rclcpp::Subscription<sensor_msgs::msg::CameraInfo>::SharedPtr sub_info_;
+  std::unique_ptr<util::CompactPublisher> compact_;
+
+  DepthSegmenter impl_;
+  std::unique_ptr<Objs_2d> objs_2d_;
+  std::unique_ptr<Depth> depth_;
+  std::unique_ptr<ApproximateSynchronizer> sub_sync_;
+};
+}  // namespace segmenter
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__SEGMENTER__DEPTH_SEGMENTER_NODE_HPP_
@@ -0,0 +1,111 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__SEGMENTER__OPENCL_EUCLIDEAN_SEGMENTER_HPP_
+#define OBJECT_ANALYTICS_NODE__SEGMENTER__OPENCL_EUCLIDEAN_SEGMENTER_HPP_
+
+#define PCL_NO_PRECOMPILE
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+
+#include <memory>
+#include <vector>
+
+#include "object_analytics_node/segmenter/algorithm_config.hpp"
+#include "object_analytics_node/segmenter/algorithm.hpp"
+
+namespace object_analytics_node
+{
+namespace segmenter
+{
+/** @class OpenCLEuclideanSegmenter
+ * SegmentAlgorithm implementation clustering by Euclidean distance on an OpenCL device.
+ *
+ * Each point starts labeled by its index, and a kernel lowers every label to the minimum label
+ * of the neighbors within OBJECT_DISTANCE_THRESHOLD, followed by a pointer jumping kernel, until
+ * no label changes. The points of a label then form a cluster, as found by
+ * pcl::EuclideanClusterExtraction. Neighbors are searched by brute force on the device, which
+ * suits the sampled ROI clouds of a few thousand points.
+ *
+ * The first GPU device is used, or any device if there is none. Without a device, or on an
+ * OpenCL error, ROIs are segmented by OrganizedMultiPlaneSegmenter on the CPU.
+ */
+class OpenCLEuclideanSegmenter : public Algorithm
+{
+public:
+  /**
+   * Constructor, setting up the OpenCL device.
+   *
+   * @param[in]   conf            Configuration overriding the default values
+   */
+  explicit OpenCLEuclideanSegmenter(const AlgorithmConfig & conf = AlgorithmConfig());
+
+  /** Destructor, releasing the OpenCL objects */
+  ~OpenCLEuclideanSegmenter();
+
+  OpenCLEuclideanSegmenter(const OpenCLEuclideanSegmenter &) = delete;
+  OpenCLEuclideanSegmenter & operator=(const OpenCLEuclideanSegmenter &) = delete;
+
+  /**
+   * Segment given point cloud into individuals which could be tell from each other in 3d spaces.
+   *
+   * @param[in]   cloud           Ponit cloud to segment
+   * @param[out]  cluster_indices Indices vector, each indidcates an individual in cloud_segment
+   */
+  void segment(
+    const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud,
+    std::vector<pcl::PointIndices> & cluster_indices);
+
+  /**
+   * Replace the configuration, taking effect from the next segmentation.
+   *
+   * @param[in]   conf            Configuration overriding the default values
+   */
+  void setConfig(const AlgorithmConfig & conf);
+
+  /**
+   * Whether an OpenCL device is in use.
+   */
+  bool isAvailable() const
+  {
+    return queue_ != nullptr;
+  }
+
+private:
+  bool init();
+  void release();
+  bool reserve(size_t size);
+  bool label(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud);
+  void applyConfig();
+
+  AlgorithmConfig conf_;
+  std::unique_ptr<Algorithm> fallback_;
+  size_t object_minimum_points_;
+  size_t object_maximum_points_;
+  float object_distance_threshold_;
+
+  cl_context context_ = nullptr;
+  cl_command_queue queue_ = nullptr;
+  cl_program program_ = nullptr;
+  cl_kernel propagate_ = nullptr;
+  cl_kernel jump_ = nullptr;
+  cl_mem points_ = nullptr;
+  cl_mem labels_ = nullptr;
+  cl_mem changed_ = nullptr;
+  size_t capacity_ = 0;
+  std::vector<cl_int> labels_host_;
+};
+}  // namespace segmenter
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__SEGMENTER__OPENCL_EUCLIDEAN_SEGMENTER_HPP_
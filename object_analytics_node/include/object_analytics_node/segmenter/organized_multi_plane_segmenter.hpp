@@ -32,6 +32,8 @@
 #include <pcl/segmentation/impl/extract_clusters.hpp>
 #include <pcl/segmentation/impl/organized_multi_plane_segmentation.hpp>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "object_analytics_node/segmenter/algorithm_config.hpp"
@@ -47,14 +49,32 @@ using object_analytics_node::segmenter::AlgorithmConfig;
 
 /** @class OrganizedMultiPlaneSegmenter
  * SegmentAlgorithm implementation using organized multi plane segmentaion algorithm.
+ *
+ * Objects are clustered by Euclidean distance in a kd-tree by default. In organized mode, the
+ * organized full cloud is labeled once per frame by organized connected component segmentation,
+ * and each ROI takes the components of its pixels, without copying the ROI.
+ *
+ * With VOXEL_LEAF_SIZE configured, a ROI is clustered by kd-tree on the centroids of its
+ * occupied voxels, and each voxel cluster is expanded back to the points of its voxels, so
+ * the clusters still index every source point and keep the exact bounds.
+ *
+ * With PLANE_CACHE_FRAMES configured, the dominant plane is estimated by RANSAC on the scene
+ * of the full frame, at most once in that many frames or when the frame id changes, and points
+ * within PLANE_DISTANCE_THRESHOLD of it are dropped before clustering. A plane is kept only if
+ * it holds PLANE_MINIMUM_RATIO of the scene points. A ROI crop never refits the plane, so ROIs
+ * without any floor are not cut by a plane through the object.
  */
 class OrganizedMultiPlaneSegmenter : public Algorithm
 {
 public:
   /**
    * Constructor
+   *
+   * @param[in]   organized       true to cluster by organized connected components
+   * @param[in]   conf            Configuration overriding the default values
    */
-  OrganizedMultiPlaneSegmenter();
+  explicit OrganizedMultiPlaneSegmenter(
+    bool organized = false, const AlgorithmConfig & conf = AlgorithmConfig());
 
   /** Default destructor */
   ~OrganizedMultiPlaneSegmenter() = default;
@@ -70,19 +90,90 @@ public:
     const PointCloudT::ConstPtr & cloud,
     std::vector<pcl::PointIndices> & cluster_indices);
 
+  /**
+   * Build one kd-tree over the cloud, shared by the segmentation of its subsets.
+   *
+   * @param[in]   cloud           Point cloud to be segmented by subsets
+   */
+  void setSearchCloud(const PointCloudT::ConstPtr & cloud);
+
+  /**
+   * Replace the configuration and re-apply it, taking effect from the next segmentation.
+   *
+   * @param[in]   conf            Configuration overriding the default values
+   */
+  void setConfig(const AlgorithmConfig & conf);
+
+  /**
+   * Track the frames seen, a scene is wanted when the cached plane is due for a refit.
+   *
+   * @param[in]   stamp           Stamp of the frame in nanoseconds
+   * @param[in]   frame_id        Frame id of the frame
+   * @return true if the plane shall be estimated on the scene of this frame
+   */
+  bool wantsScene(uint64_t stamp, const std::string & frame_id);
+
+  /**
+   * Estimate the cached plane on the scene of the frame.
+   *
+   * @param[in]   scene           Finite points sampled over the full frame
+   */
+  void setScene(const PointCloudT::ConstPtr & scene);
+
+  /**
+   * Drop the cached plane and the frames seen.
+   */
+  void clearScene();
+
+  static const std::vector<std::string> kConfigKeys; /**< Keys read from AlgorithmConfig.*/
+
+  /**
+   * Whether organized connected components are clustered.
+   */
+  bool isOrganized() const
+  {
+    return organized_;
+  }
+
+  /**
+   * Segment a subset of the cloud passed to setSearchCloud() by Euclidean clustering against the
+   * shared kd-tree, neighbors out of the subset are ignored. Same clusters as segmenting a copy of
+   * the subset, without building a tree per subset.
+   *
+   * @param[in]   cloud           Point cloud the subset belongs to
+   * @param[in]   indices         Indices of the subset in cloud
+   * @param[out]  cluster_indices Indices vector in cloud, each indicates an individual
+   */
+  void segment(
+    const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+    std::vector<pcl::PointIndices> & cluster_indices);
+
 private:
   void estimateNormal(
     const PointCloudT::ConstPtr & cloud, pcl::PointCloud<pcl::Normal>::Ptr & cloud_normal);
   void segmentPlanes(
     const PointCloudT::ConstPtr & cloud, const pcl::PointCloud<pcl::Normal>::Ptr & normal_cloud,
     pcl::PointCloud<pcl::Label>::Ptr labels, std::vector<pcl::PointIndices> & label_indices);
-  void segmentObjects_ConnectComponent(
-    const PointCloudT::ConstPtr & cloud, std::vector<pcl::PointIndices> & cluster_indices);
+  void segmentObjects_ConnectComponent(const PointCloudT::ConstPtr & cloud);
+  void segmentSubset_ConnectComponent(
+    const std::vector<int> & indices, std::vector<pcl::PointIndices> & cluster_indices);
+  void segmentSubset_KdTree(
+    const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+    std::vector<pcl::PointIndices> & cluster_indices);
   void segmentObjects_KdTree(
-    const PointCloudT::ConstPtr & cloud, std::vector<pcl::PointIndices> & cluster_indices);
+    const PointCloudT::ConstPtr & cloud, const pcl::IndicesConstPtr & indices,
+    std::vector<pcl::PointIndices> & cluster_indices);
+  void segmentObjects_Voxel(
+    const PointCloudT::ConstPtr & cloud, const pcl::IndicesConstPtr & indices,
+    std::vector<pcl::PointIndices> & cluster_indices);
+  void downsample(const PointCloudT::ConstPtr & cloud, const pcl::IndicesConstPtr & indices);
+  pcl::IndicesConstPtr removePlane(
+    const PointCloudT::ConstPtr & cloud, const std::vector<int> * indices);
+  void estimatePlane(const PointCloudT::ConstPtr & cloud);
 
   void applyConfig();
 
+  bool organized_;
   AlgorithmConfig conf_;
   pcl::OrganizedMultiPlaneSegmentation<PointT, pcl::Normal, pcl::Label> plane_segmentation_;
   pcl::IntegralImageNormalEstimation<PointT, pcl::Normal> normal_estimation_;
@@ -92,10 +183,35 @@ private:
   pcl::EdgeAwarePlaneComparator<PointT, pcl::Normal>::Ptr edge_aware_comparator_;
   pcl::EuclideanClusterComparator<PointT, pcl::Normal, pcl::Label>::Ptr
     euclidean_cluster_comparator_;
+  pcl::search::KdTree<PointT>::Ptr search_;
+  PointCloudT::ConstPtr search_cloud_;
+  std::vector<uint8_t> search_state_;
+  pcl::PointCloud<pcl::Label>::Ptr input_labels_;
+  std::vector<bool> exclude_labels_;
+  pcl::PointCloud<pcl::Label> component_labels_;
   size_t plane_minimum_points_;
   size_t object_minimum_points_;
   size_t object_maximum_points_;
   float object_distance_threshold_;
+  float voxel_leaf_size_;
+  /* voxel centroids, and the source points of voxel v at voxel_points_[voxel_start_[v]...]*/
+  PointCloudT::Ptr voxel_cloud_;
+  std::unordered_map<uint64_t, int> voxel_ids_;
+  std::vector<int> voxel_of_;
+  std::vector<int> voxel_start_;
+  std::vector<int> voxel_points_;
+  std::vector<int> voxel_fill_;
+  size_t plane_cache_frames_;
+  float plane_distance_threshold_;
+  float plane_minimum_ratio_;
+  /* cached plane a x + b y + c z + d = 0 and the points kept of the last cloud*/
+  bool plane_valid_ = false;
+  float plane_[4];
+  size_t plane_age_ = 0;
+  bool plane_frame_seen_ = false;
+  uint64_t plane_stamp_ = 0;
+  std::string plane_frame_id_;
+  pcl::IndicesPtr plane_kept_;
 };
 }  // namespace segmenter
 }  // namespace object_analytics_node
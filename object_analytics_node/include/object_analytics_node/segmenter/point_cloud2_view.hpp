@@ -0,0 +1,139 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__SEGMENTER__POINT_CLOUD2_VIEW_HPP_
+#define OBJECT_ANALYTICS_NODE__SEGMENTER__POINT_CLOUD2_VIEW_HPP_
+
+#define PCL_NO_PRECOMPILE
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "object_analytics_node/model/object3d.hpp"
+
+namespace object_analytics_node
+{
+namespace segmenter
+{
+using object_analytics_node::model::PointT;
+using object_analytics_node::model::PointCloudT;
+
+/** @class PointCloud2View
+ * Read-only view of the x/y/z of a PointCloud2 message, addressed by pixel.
+ *
+ * Points are read straight from the message data by row and column offsets,
+ * so only the points asked for are touched, without converting the whole
+ * cloud. The packed rgb of a registered cloud is read the same way, if any.
+ * The message shall outlive the view.
+ */
+class PointCloud2View
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] points PointCloud2 with x/y/z fields, see @ref isSupported().
+   */
+  explicit PointCloud2View(const sensor_msgs::msg::PointCloud2 & points);
+
+  /**
+   * @brief Check if a message has FLOAT32 x/y/z fields in host byte order.
+   *
+   * @param[in] points PointCloud2 message.
+   * @return true if the message can be viewed.
+   */
+  static bool isSupported(const sensor_msgs::msg::PointCloud2 & points);
+
+  /**
+   * @brief Get the width of the cloud.
+   */
+  uint32_t getWidth() const {return width_;}
+
+  /**
+   * @brief Get the height of the cloud, 1 for an unorganized cloud.
+   */
+  uint32_t getHeight() const {return height_;}
+
+  /**
+   * @brief Get the number of points.
+   */
+  size_t size() const {return static_cast<size_t>(width_) * height_;}
+
+  /**
+   * @brief Check if the x coordinate of a point is finite.
+   *
+   * @param[in] idx Index of the point, column + row * width.
+   */
+  bool isFinite(size_t idx) const {return std::isfinite(field<float>(idx, x_));}
+
+  /**
+   * @brief Get a point.
+   *
+   * @param[in] idx Index of the point, column + row * width.
+   */
+  PointT at(size_t idx) const
+  {
+    return PointT(field<float>(idx, x_), field<float>(idx, y_), field<float>(idx, z_));
+  }
+
+  /**
+   * @brief Check if the message has a packed rgb or rgba field.
+   */
+  bool hasColor() const {return has_rgb_;}
+
+  /**
+   * @brief Get the packed color of a point, 0x00RRGGBB in the low bytes, see @ref hasColor().
+   *
+   * @param[in] idx Index of the point, column + row * width.
+   */
+  uint32_t color(size_t idx) const {return field<uint32_t>(idx, rgb_);}
+
+  /**
+   * @brief Copy points into an unorganized cloud, the capacity of out is reused.
+   *
+   * @param[in] indices Indices of the points.
+   * @param[out] out Cloud of the points, in the order of indices.
+   * @param[out] colors Packed colors of the points in the same pass if not nullptr, cleared if
+   * the message has no color.
+   */
+  void copy(
+    const std::vector<int> & indices, PointCloudT & out,
+    std::vector<uint32_t> * colors = nullptr) const;
+
+private:
+  template<typename T>
+  T field(size_t idx, uint32_t offset) const
+  {
+    T v;
+    std::memcpy(&v, data_ + (idx / width_) * row_step_ + (idx % width_) * point_step_ + offset,
+      sizeof(v));
+    return v;
+  }
+
+  const sensor_msgs::msg::PointCloud2 & msg_; /**< The viewed message.*/
+  const uint8_t * data_;  /**< Data of the message.*/
+  uint32_t width_;        /**< Width of the cloud.*/
+  uint32_t height_;       /**< Height of the cloud.*/
+  uint32_t point_step_;   /**< Bytes of a point.*/
+  uint32_t row_step_;     /**< Bytes of a row.*/
+  uint32_t x_;            /**< Offset of x in a point.*/
+  uint32_t y_;            /**< Offset of y in a point.*/
+  uint32_t z_;            /**< Offset of z in a point.*/
+  uint32_t rgb_;          /**< Offset of the packed rgb in a point.*/
+  bool has_rgb_;          /**< The message has a packed rgb.*/
+};
+
+}  // namespace segmenter
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__SEGMENTER__POINT_CLOUD2_VIEW_HPP_
@@ -18,19 +18,32 @@
 #define PCL_NO_PRECOMPILE
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <object_msgs/msg/object_in_box.hpp>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <memory>
+#include "object_analytics_msgs/msg/object_point_indices.hpp"
 #include "object_analytics_msgs/msg/objects_in_boxes3_d.hpp"
+#include "object_analytics_msgs/msg/oriented_objects_in_boxes3_d.hpp"
+#include "object_analytics_msgs/msg/tracked_objects.hpp"
 #include "object_analytics_node/model/object2d.hpp"
 #include "object_analytics_node/model/object3d.hpp"
 #include "object_analytics_node/segmenter/algorithm_provider.hpp"
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
 #include "object_analytics_node/model/object_utils.hpp"
+#include "object_analytics_node/util/detection_filter.hpp"
+#include "object_analytics_node/util/object_pool.hpp"
+#include "object_analytics_node/util/thread_policy.hpp"
+#include "object_analytics_node/util/thread_pool.hpp"
 
 namespace object_analytics_node
 {
 namespace segmenter
 {
+using object_analytics_msgs::msg::ObjectPointIndices;
 using object_analytics_msgs::msg::ObjectsInBoxes3D;
+using object_analytics_msgs::msg::OrientedObjectsInBoxes3D;
+using object_analytics_msgs::msg::TrackedObjects;
 using object_analytics_node::model::PointT;
 using object_analytics_node::model::PointCloudT;
 using object_analytics_node::segmenter::AlgorithmProvider;
@@ -38,12 +51,22 @@ using object_analytics_node::segmenter::AlgorithmProvider;
 /** @class Segmenter
  * Segmenter implmentation. Segment the coming point cloud into individual objects and publish
  * on segmentation topic.
+ *
+ * Only the sampled pixels of the ROIs are read from the PointCloud2 message, see
+ * PointCloud2View. The full cloud is converted only for an organized algorithm. The packed rgb
+ * of a registered cloud is gathered with the sampled points, and each object carries the mean
+ * color of its points.
+ *
+ * Given the tracked objects, see setTrackedObjects(), each detection is published with the id
+ * of the tracked object it overlaps, and the bounds of a tracked object are reused in later
+ * frames, see setTemporalReuse().
  */
 class Segmenter
 {
 public:
   using Object3DVector = std::vector<object_analytics_node::model::Object3D>;
   using Object2D = object_analytics_node::model::Object2D;
+  using Object3D = object_analytics_node::model::Object3D;
   /**
    * Constructor
    *
@@ -65,6 +88,39 @@ public:
     const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
     ObjectsInBoxes3D::SharedPtr & msg);
 
+  /**
+   * @brief Do segmentation, and get the points of the cluster each object was bounded by.
+   *
+   * The clusters found are kept as indices into points, not recomputed nor copied. Only the
+   * sampled points of the ROIs are in the clusters, see setSamplingStep().
+   *
+   * @param[in]     points  Pointer point to PointCloud2 message from sensor.
+   * @param[in,out] msg     Pointer pint to ObjectsInBoxes3D message to take back.
+   * @param[out]    indices Points of each object of msg, the capacity of its arrays is reused.
+   */
+  void segment(
+    const ObjectsInBoxes::ConstSharedPtr objs_2d,
+    const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
+    ObjectsInBoxes3D::SharedPtr & msg, ObjectPointIndices & indices);
+
+  /**
+   * @brief Do segmentation, and get the points and the oriented boxes of the objects if given.
+   *
+   * The oriented box of an object is fitted to its cluster in the pass taking its bounds, see
+   * ObjectUtils::getOrientedBounds(). Objects whose bounds are reused keep the box last fitted,
+   * or get the axis aligned box of their bounds.
+   *
+   * @param[in]     points    Pointer point to PointCloud2 message from sensor.
+   * @param[in,out] msg       Pointer pint to ObjectsInBoxes3D message to take back.
+   * @param[out]    indices   Points of each object of msg, or nullptr.
+   * @param[out]    oriented  Oriented box of each object of msg, or nullptr.
+   */
+  void segment(
+    const ObjectsInBoxes::ConstSharedPtr objs_2d,
+    const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
+    ObjectsInBoxes3D::SharedPtr & msg, ObjectPointIndices * indices,
+    OrientedObjectsInBoxes3D * oriented);
+
   /**
    * @brief Set ROI cloud sampling step.
    *
@@ -72,22 +128,240 @@ public:
    */
   void setSamplingStep(size_t step);
 
+  /**
+   * @brief Set the number of points sampled from each ROI, choosing the step per ROI.
+   *
+   * The step of a ROI is the smallest one sampling at most the target number of pixels from
+   * it, so large near objects are sampled sparsely and small far ones densely. With a frame
+   * budget, the target is lowered to share the budget among the ROIs of the frame. The fixed
+   * step of setSamplingStep() is used when the target is 0.
+   *
+   * @param[in]     target_points Points sampled from each ROI, default 0 for the fixed step.
+   * @param[in]     frame_budget  Points sampled from all ROIs of a frame, default 0 for no limit.
+   */
+  void setTargetPoints(size_t target_points, size_t frame_budget = 0);
+
+  /**
+   * @brief Set if all ROIs of a frame are segmented against one search structure.
+   *
+   * The sampled points of all ROIs are gathered into one cloud, and the algorithm builds its
+   * search structure once per frame, see Algorithm::setSearchCloud(). Otherwise each ROI is
+   * copied into a cloud of its own and searched separately.
+   *
+   * @param[in]     shared true to share the search structure, default false.
+   */
+  void setSharedSearch(bool shared);
+
+  /**
+   * @brief Set the number of ROIs segmented in parallel.
+   *
+   * Each worker segments with an algorithm instance of its own, see AlgorithmProvider::create().
+   * Results are kept in the order of detection. With a provider not able to create instances,
+   * ROIs are segmented one by one. ROIs of a shared search or of an organized algorithm are always
+   * segmented one by one.
+   *
+   * @param[in]     num_threads Number of workers, default 1.
+   */
+  void setNumThreads(size_t num_threads);
+
+  /**
+   * @brief Pin the worker threads segmenting ROIs in parallel, failures are logged.
+   *
+   * The policy is kept for the workers of a later @ref setNumThreads(), the calling thread keeps
+   * its own policy, that of the executor.
+   *
+   * @param[in]     policy Affinity and priority of the workers.
+   * @return false if the policy was not applied to every worker.
+   */
+  bool setThreadPolicy(const util::ThreadPolicy & policy);
+
+  /**
+   * @brief Describe the policy the worker threads run with.
+   */
+  std::string getThreadPolicy() const {return pool_ ? pool_->getPolicy() : "no workers";}
+
+  /**
+   * @brief Get the number of point cloud buffers allocated so far.
+   *
+   * Buffers are pooled and reused across frames, the number stays constant once the segmenter
+   * has seen its largest frame.
+   */
+  size_t getBufferAllocations() const;
+
+  /**
+   * @brief Set the fraction of object points ignored at each end of each axis of the 3d bounds.
+   *
+   * A trim of 0.02 takes the 2nd and 98th percentiles as the bounds, so the box is not stretched
+   * by a few stray points of the cluster, see Object3D.
+   *
+   * @param[in]     trim Fraction in [0, 0.5], default 0 for the exact bounds.
+   */
+  void setBoundsTrim(float trim);
+
+  /**
+   * @brief Set the filter of the detections segmented, the others are not published.
+   *
+   * @param[in]     filter  Filter of the detections, default accepting all.
+   */
+  void setFilter(const util::DetectionFilter & filter) {filter_ = filter;}
+
+  /**
+   * @brief Replace the configuration of the algorithm instances, see AlgorithmConfig.
+   *
+   * Takes effect from the next segmentation, shall not be called while segment() runs.
+   *
+   * @param[in]     conf Configuration overriding the default values.
+   */
+  void setConfig(const AlgorithmConfig & conf);
+
+  /**
+   * @brief Set the tracked objects, taken for the detections of the following frames.
+   *
+   * A detection overlapping a tracked object by kTrackOverlap is published with its id. The
+   * bounds kept of objects no longer tracked are dropped.
+   *
+   * @param[in]     tracks  Tracked objects published by the tracker.
+   */
+  void setTrackedObjects(const TrackedObjects & tracks);
+
+  /**
+   * @brief Set how the 3d bounds of a tracked object are reused in later frames.
+   *
+   * When none of the offset and size of the ROI changed by more than still_shift pixels since
+   * the object was last segmented, its bounds are published as they are, up to max_reuse frames
+   * in a row. Otherwise the object is segmented from the ROI points within depth_margin of its
+   * last depth range.
+   *
+   * @param[in]     still_shift   ROI change in pixels to reuse the bounds, default 0 to never.
+   * @param[in]     depth_margin  Margin in meters of the depth range, default 0 for no gating.
+   * @param[in]     max_reuse     Frames the bounds are reused in a row.
+   */
+  void setTemporalReuse(size_t still_shift, float depth_margin = 0.0f, size_t max_reuse = 0);
+
+  /**
+   * @brief Segment a synthetic frame, so the first real frame does not pay for cold paths.
+   *
+   * The frame is a plane with a box in front, detected once per worker, so every algorithm
+   * instance builds its search structure and the pooled buffers are allocated. The filter is
+   * bypassed, the scene state of the algorithms such as a cached plane is cleared, and the
+   * statistics of the segmenter stages recorded meanwhile are dropped. Shall be called before
+   * any tracked objects are set.
+   *
+   * @param[in]     width   Width of the synthetic cloud.
+   * @param[in]     height  Height of the synthetic cloud.
+   */
+  void warmup(uint32_t width, uint32_t height);
+
+  /** Minimum overlap of a detection and a tracked object to take its id*/
+  static const float kTrackOverlap;
+
+  /** Points sampled over the full frame for the scene of an algorithm, see Algorithm::setScene()*/
+  static const size_t kScenePoints;
+
 private:
+  /** Per-worker algorithm and scratch buffers.*/
+  struct Worker
+  {
+    std::shared_ptr<Algorithm> algo;
+    PointCloudT::Ptr roi_cloud;
+    std::vector<int> roi_indices;
+    /* packed colors of roi_cloud, empty if the cloud has none*/
+    std::vector<uint32_t> roi_colors;
+    std::vector<pcl::PointIndices> cluster_indices;
+  };
+
+  /** Bounds of a tracked object as last segmented.*/
+  struct Track
+  {
+    object_analytics_msgs::msg::ObjectInBox3D bounds;
+    size_t reused;
+    /* oriented box as last fitted, if any*/
+    bool oriented = false;
+    geometry_msgs::msg::Pose pose;
+    geometry_msgs::msg::Vector3 size;
+  };
+
+  void segmentRoi(
+    const PointCloud2View & cloud, const Object2D & obj2d, size_t step, const Track * track,
+    Worker & worker, std::shared_ptr<Object3D> & object3d, std::vector<uint32_t> * points);
+  void matchTracks(const Object2DVector & objects2d);
+  bool isStill(const Object2D & obj2d, const Track & track) const;
+  void gateRoiCloud(
+    const Track & track, PointCloudT & cloud, std::vector<int> & indices,
+    std::vector<uint32_t> & colors) const;
+  void gateDepth(const Track & track, const PointCloudT & cloud, std::vector<int> & indices) const;
+  void updateTracks(const RelationVector & relations);
+  Object3D getReused(const Object2D & obj2d, const Track & track) const;
   void getPclPointCloud(const sensor_msgs::msg::PointCloud2::ConstSharedPtr &, PointCloudT &);
   void getRoiPointCloud(
-    const PointCloudT::ConstPtr & cloud, PointCloudT::Ptr & roi_cloud, const Object2D & obj2d);
-  void getRoiPointCloud(
-    const PointCloudT::ConstPtr & cloud, const pcl::PointCloud<PointXYZPixel>::Ptr & pixel_pcl,
-    PointCloudT::Ptr & roi_cloud, const Object2D & obj2d);
-  void getPixelPointCloud(
-    const PointCloudT::ConstPtr & cloud, pcl::PointCloud<PointXYZPixel>::Ptr & pixel_pcl);
+    const PointCloud2View & cloud, PointCloudT::Ptr & roi_cloud, std::vector<int> & roi_indices,
+    std::vector<uint32_t> & roi_colors, const Object2D & obj2d, size_t step);
+  void getRoiIndices(
+    const PointCloud2View & cloud, const Object2D & obj2d, size_t step,
+    std::vector<int> & roi_indices);
+  void getSamplingSteps(const Object2DVector & objects2d, const PointCloud2View & cloud);
+  /* a sub-sampled scene of the frame, for the algorithms that want one*/
+  void prepareScene(const PointCloud2View & cloud, const std_msgs::msg::Header & header);
+  void doSharedSegment(
+    const Object2DVector & objects2d, const PointCloud2View & cloud,
+    RelationVector & relations);
+  void doOrganizedSegment(
+    const Object2DVector & objects2d, const PointCloud2View & cloud,
+    const PointCloudT::ConstPtr & full_cloud, RelationVector & relations);
+  void segmentSubsets(
+    const Object2DVector & objects2d, const PointCloudT::ConstPtr & cloud,
+    const std::vector<std::vector<int>> & rois, const std::vector<int> * cloud_of,
+    const std::vector<uint32_t> & colors, RelationVector & relations);
   void doSegment(
-    const ObjectsInBoxes::ConstSharedPtr, const PointCloudT::ConstPtr &, RelationVector &);
+    const ObjectsInBoxes::ConstSharedPtr, const sensor_msgs::msg::PointCloud2::ConstSharedPtr &,
+    RelationVector &);
   void composeResult(const RelationVector &, ObjectsInBoxes3D::SharedPtr &);
+  void composePoints(const RelationVector &, ObjectPointIndices &) const;
+  void composeOriented(const RelationVector &, OrientedObjectsInBoxes3D &) const;
 
   std::unique_ptr<AlgorithmProvider> provider_;
+  util::ObjectPool<PointCloudT, PointCloudT::Ptr> cloud_pool_;
+  std::vector<Worker> workers_;
+  std::unique_ptr<util::ThreadPool> pool_;
+  util::ThreadPolicy policy_;
+
+  /* per-frame scratch of shared and organized segmentation, capacity kept across frames*/
+  std::vector<std::vector<int>> rois_;
+  std::vector<int> shared_of_;
+  std::vector<int> shared_indices_;
+  /* packed colors of the searched cloud, empty if the cloud has none*/
+  std::vector<uint32_t> colors_;
+  /* sampled points of the scene and the algorithms taking it*/
+  std::vector<int> scene_indices_;
+  std::vector<Algorithm *> scene_algos_;
 
   size_t sampling_step_ = 1;
+  size_t target_points_ = 0;
+  size_t frame_budget_ = 0;
+  /* sampling step of each ROI of the frame*/
+  std::vector<size_t> steps_;
+  bool shared_search_ = false;
+  float bounds_trim_ = 0.0f;
+  util::DetectionFilter filter_;
+
+  /* tracked objects of the latest tracking message and their bounds*/
+  TrackedObjects tracks_;
+  std::unordered_map<int64_t, Track> track_bounds_;
+  size_t still_shift_ = 0;
+  float depth_margin_ = 0.0f;
+  size_t max_reuse_ = 0;
+  /* per detection of the frame, the id and kept bounds of its tracked object*/
+  std::vector<int64_t> track_ids_;
+  std::vector<const Track *> prior_;
+  std::vector<bool> reuse_;
+  std::vector<int> gated_indices_;
+  /* detection of each relation of the frame*/
+  std::vector<size_t> relation_of_;
+  /* points of the cluster of each detection of the frame, if collected*/
+  bool collect_points_ = false;
+  std::vector<std::vector<uint32_t>> points_of_;
+  /* oriented boxes of the objects are fitted, if composed*/
+  bool fit_oriented_ = false;
 };
 }  // namespace segmenter
 }  // namespace object_analytics_node
@@ -15,18 +15,27 @@
 #ifndef OBJECT_ANALYTICS_NODE__SEGMENTER__SEGMENTER_NODE_HPP_
 #define OBJECT_ANALYTICS_NODE__SEGMENTER__SEGMENTER_NODE_HPP_
 
-#include <message_filters/subscriber.h>
-#include <message_filters/time_synchronizer.h>
-#include <message_filters/sync_policies/approximate_time.h>
-
 #include <rclcpp/rclcpp.hpp>
 #include <std_msgs/msg/header.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
+#include <object_analytics_msgs/msg/compressed_point_cloud.hpp>
+#include <object_analytics_msgs/msg/cropped_point_cloud.hpp>
 
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "object_analytics_node/visibility_control.h"
 #include "object_analytics_node/segmenter/segmenter.hpp"
+#include "object_analytics_node/util/compact_publisher.hpp"
+#include "object_analytics_node/util/object_pool.hpp"
+#include "object_analytics_node/util/frame_tracer.hpp"
+#include "object_analytics_node/util/memory_account.hpp"
+#include "object_analytics_node/util/quality_listener.hpp"
+#include "object_analytics_node/util/roi_crop.hpp"
+#include "object_analytics_node/util/stamp_matcher.hpp"
+#include "object_analytics_node/util/stats_publisher.hpp"
 
 namespace object_analytics_node
 {
@@ -34,6 +43,56 @@ namespace segmenter
 {
 /** @class SegmenterNode
  * Segmenter node, segmenter implementation holder.
+ *
+ * Detections are paired with the point cloud of the same stamp, see util::StampMatcher. Up to
+ * cloud_cache_mb of point clouds are buffered waiting for their detections, and with
+ * stamp_tolerance_ms a detection whose cloud is missing takes the nearest one.
+ *
+ * With the parameter registered_points, the node subscribes to the registered XYZRGB cloud
+ * instead of the XYZ cloud of the splitter. Points are read at their offsets in the message
+ * either way, see PointCloud2View. With compressed_points, it subscribes to the compressed
+ * cloud instead, see util::CloudCodec. With cropped_points, it subscribes to the ROI windows
+ * cropped by a splitter with roi_crop instead, expanded back into an organized cloud, see
+ * util::RoiCrop.
+ *
+ * Each AlgorithmConfig item, e.g. OBJECT_DISTANCE_THRESHOLD, is the parameter
+ * algorithm.OBJECT_DISTANCE_THRESHOLD, which may be given in a parameter file and is re-applied
+ * to the algorithm when changed at runtime. A change is rejected as a whole, and nothing of it
+ * applied, if an item is negative or of the wrong type, COMPARATOR being the only string. The
+ * ROI pixels are sampled every sampling_step, default 10, see Segmenter::setSamplingStep().
+ * Both can be tuned on recorded frames against a latency budget by the segmenter_tuning tool,
+ * which writes them as a parameter file. Once the
+ * quality level of the governor reaches the parameter degrade_level, default 1, the ROI pixels
+ * are sampled every degraded_sampling_step, default twice sampling_step, till the level falls
+ * back, see util::QualityListener. A degrade_level of 0 never degrades.
+ *
+ * With the parameter tracking_reuse, the node subscribes to the tracking topic, attaches the
+ * tracking ids to the published objects and reuses the bounds of tracked objects, see
+ * Segmenter::setTemporalReuse().
+ *
+ * With the parameter publish_stats, latencies of the segmenter stages, the depth of the cloud
+ * cache, its bytes against cloud_cache_mb, and the drop counters of util::StampMatcher are
+ * published every second, see util::StatsPublisher. With frame_trace, the time each matched
+ * pair spends in segmentation is traced, see util::FrameTracer. Time waiting for the pair shows
+ * in the latency since capture.
+ *
+ * With the parameter compact_localization, the objects are published as CompactObjectsInBoxes3D
+ * as well, for consumers of many objects at a high rate, see util::CompactPublisher. With
+ * object_points, the points of the cluster bounding each object are published as indices into
+ * the cloud on @ref Const::kTopicObjectPoints, so consumers of the object points need not
+ * segment the cloud again. With oriented_boxes, the oriented box of each object is fitted in the
+ * pass taking its bounds and published on @ref Const::kTopicOrientedLocalization, see
+ * ObjectUtils::getOrientedBounds(). Both are computed only while the topic has subscribers.
+ *
+ * With the parameter warmup, default true, a synthetic cloud of warmup_width x warmup_height,
+ * default 640 x 480, is segmented at construction and the time taken is logged, see
+ * Segmenter::warmup(), so the first frame meets the steady state latency.
+ *
+ * QoS of the topics are the parameters qos.pointcloud, qos.compressed_points or
+ * qos.cropped_points, default
+ * "sensor", and qos.detection, qos.tracking, qos.localization, qos.object_points and
+ * qos.oriented_localization, default "reliable", see util::QosProfiles. A dropped cloud drops
+ * its detections, a dropped detection its cloud.
  */
 class SegmenterNode : public rclcpp::Node
 {
@@ -45,20 +104,42 @@ private:
     const ObjectsInBoxes::ConstSharedPtr objs_2d,
     const sensor_msgs::msg::PointCloud2::ConstSharedPtr pcls);
 
-  static const int kMsgQueueSize;
+  bool checkConfig(const rclcpp::Parameter & param);
+  bool setConfig(const rclcpp::Parameter & param);
+  rcl_interfaces::msg::SetParametersResult onParametersSet(
+    const std::vector<rclcpp::Parameter> & params);
+
+  void logDrops();
+
+  static const std::string kConfigPrefix;
 
-  using Objs_2d = message_filters::Subscriber<ObjectsInBoxes>;
-  using Pcls = message_filters::Subscriber<sensor_msgs::msg::PointCloud2>;
-  using ApproximatePolicy =
-    message_filters::sync_policies::ApproximateTime<ObjectsInBoxes, sensor_msgs::msg::PointCloud2>;
-  using ApproximateSynchronizer = message_filters::Synchronizer<ApproximatePolicy>;
+  using Matcher = util::StampMatcher<ObjectsInBoxes::ConstSharedPtr,
+      sensor_msgs::msg::PointCloud2::ConstSharedPtr>;
 
   rclcpp::Publisher<object_analytics_msgs::msg::ObjectsInBoxes3D>::SharedPtr pub_;
+  rclcpp::Publisher<ObjectPointIndices>::SharedPtr pub_points_;
+  rclcpp::Publisher<OrientedObjectsInBoxes3D>::SharedPtr pub_oriented_;
+  rclcpp::Subscription<object_analytics_msgs::msg::TrackedObjects>::SharedPtr sub_tracking_;
 
   std::unique_ptr<Segmenter> impl_;
-  std::unique_ptr<Objs_2d> objs_2d;
-  std::unique_ptr<Pcls> pcls;
-  std::unique_ptr<ApproximateSynchronizer> sub_sync_seg;
+  AlgorithmConfig conf_;
+  std::unique_ptr<Matcher> matcher_;
+  uint64_t dropped_ = 0;
+  uint64_t evicted_ = 0;
+  rclcpp::Subscription<ObjectsInBoxes>::SharedPtr sub_objs_;
+  rclcpp::Subscription<sensor_msgs::msg::PointCloud2>::SharedPtr sub_pcls_;
+  rclcpp::Subscription<object_analytics_msgs::msg::CompressedPointCloud>::SharedPtr
+    sub_compressed_;
+  rclcpp::Subscription<object_analytics_msgs::msg::CroppedPointCloud>::SharedPtr sub_cropped_;
+  util::ObjectPool<sensor_msgs::msg::PointCloud2> decoded_pool_;
+  /* windows holding points of each pooled cloud expanded from cropped points*/
+  std::unordered_map<const sensor_msgs::msg::PointCloud2 *, std::vector<util::RoiCrop::Window>>
+  expanded_windows_;
+  std::unique_ptr<util::MemoryAccount> cloud_memory_;
+  std::unique_ptr<util::StatsPublisher> stats_;
+  std::unique_ptr<util::FrameTracer> tracer_;
+  std::unique_ptr<util::CompactPublisher> compact_;
+  std::unique_ptr<util::QualityListener> quality_;
 };
 }  // namespace segmenter
 }  // namespace object_analytics_node
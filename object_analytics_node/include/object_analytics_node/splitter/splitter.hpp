@@ -50,6 +50,14 @@ public:
     const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
     sensor_msgs::msg::Image::SharedPtr & image);
 
+  /**
+   * @brief Split PointCloud2 w/ RGB into Image.
+   *
+   * param[in]      points  PointCloud2 w/ RGB
+   * param[out]     image   Image, e.g. owned by a unique_ptr to be published
+   */
+  static void split(const sensor_msgs::msg::PointCloud2 & points, sensor_msgs::msg::Image & image);
+
   /**
    * @brief Split PointCloud2 w/ XYZRGB to XYZ.
    *
@@ -59,6 +67,31 @@ public:
   static void splitPointsToXYZ(
     const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
     sensor_msgs::msg::PointCloud2::SharedPtr & points_xyz);
+
+  /**
+   * @brief Split PointCloud2 w/ XYZRGB to XYZ.
+   *
+   * param[in]      points      PointCloud2 w/ XYZRGB
+   * param[out]     points_xyz  PointCloud2 w/ XYZ, e.g. owned by a unique_ptr to be published
+   */
+  static void splitPointsToXYZ(
+    const sensor_msgs::msg::PointCloud2 & points,
+    sensor_msgs::msg::PointCloud2 & points_xyz);
+
+  /**
+   * @brief Split PointCloud2 w/ XYZRGB into Image and PointCloud2 w/ XYZ in one pass.
+   *
+   * Same results as split() and splitPointsToXYZ(), but each point is read once, copying its
+   * rgb and xyz bytes at the field offsets found up front. Clouds with other than float xyz
+   * fields are split in two passes.
+   *
+   * param[in]      points      PointCloud2 w/ XYZRGB
+   * param[out]     image       Image, bgr8
+   * param[out]     points_xyz  PointCloud2 w/ XYZ
+   */
+  static void split(
+    const sensor_msgs::msg::PointCloud2 & points, sensor_msgs::msg::Image & image,
+    sensor_msgs::msg::PointCloud2 & points_xyz);
 };
 }  // namespace splitter
 }  // namespace object_analytics_node
@@ -17,9 +17,20 @@
 
 #include <rclcpp/rclcpp.hpp>
 #include <std_msgs/msg/string.hpp>
+#include <object_analytics_msgs/msg/compressed_point_cloud.hpp>
+#include <object_analytics_msgs/msg/cropped_point_cloud.hpp>
+#include <object_msgs/msg/objects_in_boxes.hpp>
+
+#include <memory>
+#include <vector>
 
 #include "object_analytics_node/visibility_control.h"
 #include "object_analytics_node/splitter/splitter.hpp"
+#include "object_analytics_node/util/frame_tracer.hpp"
+#include "object_analytics_node/util/quality_listener.hpp"
+#include "object_analytics_node/util/roi_crop.hpp"
+#include "object_analytics_node/util/stamp_matcher.hpp"
+#include "object_analytics_node/util/stats_publisher.hpp"
 
 namespace object_analytics_node
 {
@@ -27,6 +38,29 @@ namespace splitter
 {
 /** @class SplitterNode
  * Splitter node, splitter implementation holder.
+ *
+ * The image and the XYZ cloud are only split out while they have subscribers. With the
+ * parameter xyz_decimation, the XYZ cloud is published for one in every xyz_decimation clouds
+ * received. The compressed cloud, see util::CloudCodec, goes with the XYZ cloud for a
+ * segmenter across a slow link.
+ *
+ * Once the quality level of the governor reaches the parameter degrade_level, default 4, the
+ * XYZ cloud is decimated by degraded_xyz_decimation, default twice xyz_decimation, till the
+ * level falls back, see util::QualityListener. A degrade_level of 0 never degrades.
+ *
+ * With the parameter roi_crop, the node subscribes to the detections as well, and publishes on
+ * @ref Const::kTopicCroppedPC2 only the points of the ROIs of each cloud, each expanded by
+ * roi_margin pixels, default 16, see util::RoiCrop. Clouds wait for their detections in a cache
+ * of up to cloud_cache_mb, default 64, see util::StampMatcher, and a cloud without detections
+ * publishes nothing.
+ *
+ * With the parameter publish_stats, latencies of splitting and encoding and the count of clouds
+ * failed to split are published every second, see util::StatsPublisher. With frame_trace, the
+ * time each cloud spends in the splitter is traced, see util::FrameTracer.
+ *
+ * QoS of the topics are the parameters qos.registered_points, default "sensor", and qos.rgb,
+ * qos.pointcloud, qos.compressed_points, qos.detection and qos.cropped_points, default
+ * "reliable", see util::QosProfiles.
  */
 class SplitterNode : public rclcpp::Node
 {
@@ -34,9 +68,29 @@ public:
   OBJECT_ANALYTICS_NODE_PUBLIC SplitterNode(rclcpp::NodeOptions options);
 
 private:
+  void crop(
+    const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+    const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points);
+
+  using Matcher = util::StampMatcher<object_msgs::msg::ObjectsInBoxes::ConstSharedPtr,
+      sensor_msgs::msg::PointCloud2::ConstSharedPtr>;
+
   rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr pub_2d_;
   rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr pub_3d_;
+  rclcpp::Publisher<object_analytics_msgs::msg::CompressedPointCloud>::SharedPtr pub_compressed_;
+  rclcpp::Publisher<object_analytics_msgs::msg::CroppedPointCloud>::SharedPtr pub_cropped_;
   rclcpp::Subscription<sensor_msgs::msg::PointCloud2>::SharedPtr sub_pc2_;
+  rclcpp::Subscription<object_msgs::msg::ObjectsInBoxes>::SharedPtr sub_objs_;
+  std::unique_ptr<Matcher> matcher_;
+  std::vector<util::RoiCrop::Window> windows_;
+  uint32_t roi_margin_ = 0;
+  uint64_t xyz_decimation_ = 1;
+  uint64_t full_decimation_ = 1;   /**< Decimation at full quality.*/
+  uint64_t frames_ = 0;
+  uint64_t errors_ = 0;
+  std::unique_ptr<util::StatsPublisher> stats_;
+  std::unique_ptr<util::FrameTracer> tracer_;
+  std::unique_ptr<util::QualityListener> quality_;
 };
 }  // namespace splitter
 }  // namespace object_analytics_node
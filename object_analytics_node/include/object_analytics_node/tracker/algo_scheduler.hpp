@@ -0,0 +1,116 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__ALGO_SCHEDULER_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__ALGO_SCHEDULER_HPP_
+
+#include <opencv2/core/types.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class AlgoScheduler
+ * Choose the tracker algorithm of each tracking against a frame time budget.
+ *
+ * Algorithms are ranked in three levels, from the most accurate to the
+ * cheapest:
+ * - large, for objects with a roi area not less than @ref setLargeArea(),
+ * e.g. "KCF".
+ * - small, for smaller objects, e.g. "MEDIAN_FLOW".
+ * - fallback, e.g. "KALMAN".
+ *
+ * The update cost of each algorithm is learned from the trackings updated,
+ * see @ref observe(). When the estimated cost of a frame exceeds the budget,
+ * trackings are degraded one level at a time, smallest rois first, until the
+ * frame fits in the budget or all trackings run the fallback algorithm.
+ */
+class AlgoScheduler
+{
+public:
+  /**
+   * @brief Constructor, scheduling is disabled until a budget is set.
+   */
+  AlgoScheduler();
+
+  /**
+   * @brief Set the frame time budget.
+   *
+   * @param[in] budget_ms Time budget of tracking a frame, in milliseconds. Not
+   * above zero disables scheduling.
+   * @param[in] num_threads Number of threads updating trackers in parallel.
+   */
+  void setBudget(double budget_ms, int32_t num_threads);
+
+  /**
+   * @brief Check if scheduling is enabled.
+   */
+  bool isEnabled() const {return budget_ms_ > 0;}
+
+  /**
+   * @brief Set the algorithms of each level.
+   */
+  void setAlgos(
+    const std::string & large, const std::string & small,
+    const std::string & fallback);
+
+  /**
+   * @brief Get the algorithms of the levels set, from the most accurate.
+   */
+  std::vector<std::string> getAlgos() const;
+
+  /**
+   * @brief Set the minimum roi area, in pixels, of large objects.
+   */
+  void setLargeArea(double area) {large_area_ = area;}
+
+  /**
+   * @brief Learn the update cost of an algorithm.
+   *
+   * @param[in] algo Algorithm name.
+   * @param[in] cost_ms Time spent by one tracker update, in milliseconds.
+   */
+  void observe(const std::string & algo, double cost_ms);
+
+  /**
+   * @brief Get the estimated update cost of an algorithm.
+   *
+   * @param[in] algo Algorithm name.
+   * @return Cost in milliseconds, a prior until the algorithm was observed.
+   */
+  double getCost(const std::string & algo) const;
+
+  /**
+   * @brief Choose the algorithm of each tracking.
+   *
+   * @param[in] rects Rois of the trackings.
+   * @return Algorithm name of each roi.
+   */
+  std::vector<std::string> schedule(const std::vector<cv::Rect2d> & rects) const;
+
+private:
+  static const double kSmoothing; /**< Weight of a new cost observation.*/
+
+  double budget_ms_;    /**< Time budget of a frame, not above zero if disabled.*/
+  int32_t num_threads_; /**< Number of threads updating trackers.*/
+  double large_area_;   /**< Minimum roi area of large objects.*/
+  std::string levels_[3]; /**< Algorithms from the most accurate.*/
+  std::map<std::string, double> cost_; /**< Estimated update cost per algorithm.*/
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__ALGO_SCHEDULER_HPP_
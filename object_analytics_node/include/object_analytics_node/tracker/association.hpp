@@ -0,0 +1,96 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__ASSOCIATION_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__ASSOCIATION_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class Association
+ * Global assignment of detections to trackings for one frame.
+ *
+ * Instead of greedily picking the best tracking for every detection in turn,
+ * the scores of all detection-tracking pairs of a frame are gathered into one
+ * matrix, and the assignment maximizing the sum of scores is solved at once
+ * with the Hungarian (Kuhn-Munkres) algorithm. Pairs which shall never be
+ * associated, e.g. of different object names, are gated by @ref kInfeasible.
+ *
+ * When only a few pairs are feasible, e.g. gated by a spatial index, the
+ * sparse variant splits the problem into independent groups of rows and
+ * columns connected by feasible pairs, and solves each group on its own.
+ */
+class Association
+{
+public:
+  /**
+   * A feasible pair of the sparse problem.
+   */
+  struct Edge
+  {
+    size_t row;    /**< Row of the pair, e.g. a detection.*/
+    size_t col;    /**< Column of the pair, e.g. a tracking.*/
+    double score;  /**< Score of the pair.*/
+  };
+
+  /**
+   * Score of a pair which shall never be associated.
+   */
+  static const double kInfeasible;
+
+  /**
+   * Scores above this value are saturated, so that the solver works on
+   * finite values only.
+   */
+  static const double kMaxScore;
+
+  /**
+   * @brief Solve the assignment maximizing the sum of matched scores.
+   *
+   * @param[in] scores Score matrix, scores[row][col] for detection row
+   * against tracking col. All rows shall have the same size.
+   * @param[in] min_score Pairs with a score not above this value are not
+   * associated.
+   * @return Column assigned to every row, -1 if the row is not assigned.
+   */
+  static std::vector<int> solve(
+    const std::vector<std::vector<double>> & scores,
+    double min_score);
+
+  /**
+   * @brief Solve the assignment of a sparse problem.
+   *
+   * Pairs not listed in @p edges are infeasible. The result is the same as
+   * solving the dense matrix, but the cost is driven by the size of the
+   * largest group of connected pairs instead of the size of the whole matrix.
+   *
+   * @param[in] rows Number of rows.
+   * @param[in] cols Number of columns.
+   * @param[in] edges Feasible pairs, each pair listed once at most.
+   * @param[in] min_score Pairs with a score not above this value are not
+   * associated.
+   * @return Column assigned to every row, -1 if the row is not assigned.
+   */
+  static std::vector<int> solve(
+    size_t rows, size_t cols,
+    const std::vector<Edge> & edges,
+    double min_score);
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__ASSOCIATION_HPP_
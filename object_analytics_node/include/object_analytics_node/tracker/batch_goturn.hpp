@@ -0,0 +1,157 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__BATCH_GOTURN_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__BATCH_GOTURN_HPP_
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/thread_pool.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class BatchGoturn
+ * GOTURN regression network run once per frame for all objects, algorithm
+ * "GOTURN_BATCH" of @ref Tracking.
+ *
+ * cv::TrackerGOTURN runs one forward of the network per object and frame.
+ * Here the region around the roi of each object in the previous frame, and
+ * the same region of the current frame, are stacked into two batches of
+ * @ref kInputSize square patches, and one forward regresses the rois of all
+ * objects. The cost of a frame is then roughly that of one forward, whatever
+ * the number of objects, see TrackingManager::track().
+ *
+ * The network is that of cv::TrackerGOTURN, goturn.prototxt and
+ * goturn.caffemodel, run by cv::dnn on a device, see @ref load(): with the
+ * OpenVINO inference engine on "CPU", "GPU" for an integrated GPU, or
+ * "MYRIAD" for a VPU, or by OpenCV itself on "OPENCV". Forwards are
+ * serialized, the network is shared by the trackings of a manager.
+ */
+class BatchGoturn
+{
+public:
+  static const int kInputSize;   /**< Side of the patches of the network.*/
+  static const double kPadding;  /**< Side of the region around a roi, of its side.*/
+
+  /** State of one object between frames.*/
+  struct Target
+  {
+    cv::Rect2d rect;  /**< Roi in the latest frame.*/
+    cv::Mat patch;    /**< Region around the roi in the latest frame, empty if not seeded.*/
+  };
+
+  BatchGoturn();
+  ~BatchGoturn();
+
+  /**
+   * @brief Load the network.
+   *
+   * @param[in] prototxt Path of the network definition, e.g. "goturn.prototxt".
+   * @param[in] weights Path of the weights, e.g. "goturn.caffemodel".
+   * @param[in] device Device running the network, see @ref parseDevice().
+   * @param[out] error Reason of a failure, unchanged on success.
+   * @return false if the network or the device is not available.
+   */
+  bool load(
+    const std::string & prototxt, const std::string & weights,
+    const std::string & device, std::string & error);
+
+  /**
+   * @brief Check if the network is loaded.
+   */
+  bool isLoaded() const {return loaded_;}
+
+  /**
+   * @brief Get the cv::dnn backend and target of a device.
+   *
+   * @param[in] device "CPU", "GPU", "GPU_FP16" or "MYRIAD" for the OpenVINO
+   * inference engine, or "OPENCV" for the OpenCV backend on the CPU.
+   * @param[out] backend cv::dnn::Backend of the device.
+   * @param[out] target cv::dnn::Target of the device.
+   * @return false if the device is unknown, or not supported by this OpenCV.
+   */
+  static bool parseDevice(const std::string & device, int & backend, int & target);
+
+  /**
+   * @brief Get the region cropped around a roi, @ref kPadding times its size
+   * on the same center.
+   */
+  static cv::Rect2d getRegion(const cv::Rect2d & rect);
+
+  /**
+   * @brief Crop a region of a frame into a patch of the network, the border
+   * of the frame replicated outside.
+   *
+   * @param[in] bgr Frame in BGR.
+   * @param[in] region Region of the frame, see @ref getRegion().
+   * @param[out] patch Patch of @ref kInputSize square, in BGR.
+   */
+  static void crop(const cv::Mat & bgr, const cv::Rect2d & region, cv::Mat & patch);
+
+  /**
+   * @brief Seed a target with a roi.
+   *
+   * @param[in] bgr Frame in BGR.
+   * @param[in] rect Roi of the object in the frame.
+   * @param[out] target The target.
+   */
+  static void seed(const cv::Mat & bgr, const cv::Rect2d & rect, Target & target);
+
+  /**
+   * @brief Track a batch of targets into a new frame, with one forward.
+   *
+   * The roi of each target tracked is moved to the new frame, and its patch
+   * cropped there for the next frame.
+   *
+   * @param[in] bgr New frame in BGR.
+   * @param[in] targets Targets seeded, of the previous frame.
+   * @param[out] tracked For each target, false if the network lost it.
+   * @param[in] pool Pool cropping the patches in parallel, may be empty.
+   * @return false if the network is not loaded or failed, no target tracked.
+   */
+  bool update(
+    const cv::Mat & bgr, const std::vector<Target *> & targets,
+    std::vector<char> & tracked, util::ThreadPool * pool = nullptr);
+
+  /**
+   * @brief Get the number of forwards run.
+   */
+  uint64_t getForwards() const {return forwards_;}
+
+  /**
+   * @brief Get the number of objects tracked by the forwards.
+   */
+  uint64_t getTracked() const {return tracked_;}
+
+private:
+  struct Network;  /**< The network, of cv::dnn.*/
+
+  std::unique_ptr<Network> net_;
+  bool loaded_;
+  std::mutex mutex_;                /**< Guard of the forwards.*/
+  std::vector<cv::Mat> previous_;   /**< Patches of the previous frame, of a batch.*/
+  std::vector<cv::Mat> current_;    /**< Patches of the new frame, of a batch.*/
+  std::vector<cv::Rect2d> regions_; /**< Regions of the patches, of a batch.*/
+  std::atomic<uint64_t> forwards_{0};
+  std::atomic<uint64_t> tracked_{0};
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__BATCH_GOTURN_HPP_
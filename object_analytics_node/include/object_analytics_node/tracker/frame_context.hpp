@@ -0,0 +1,177 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__FRAME_CONTEXT_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__FRAME_CONTEXT_HPP_
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class FrameContext
+ * Preprocessed data of one frame, shared by all trackings of the frame.
+ *
+ * Each OpenCV tracker preprocesses the frame on its own, e.g. MEDIAN_FLOW and
+ * TLD convert the BGR frame to grayscale for every object tracked. The frame
+ * context computes such data once per frame and hands it to the trackers,
+ * see @ref getInput().
+ *
+ * The frame may come in BGR, RGB or grayscale, see @ref isSupported(), and is
+ * only converted to what the trackers of the frame consume. E.g. a grayscale
+ * camera frame is handed to MEDIAN_FLOW as is, with no conversion at all.
+ *
+ * Data is computed lazily on first access, and access is thread safe, so the
+ * context can be used by trackings updated in parallel. @ref prepare() computes
+ * the data ahead for a set of algorithms, to keep workers from waiting on the
+ * first access.
+ *
+ * Trackings working at a lower resolution, see Tracking::setCropping(), share
+ * the levels of the input pyramid, each level halving the one above, see
+ * getInput(const std::string &, int).
+ */
+class FrameContext
+{
+public:
+  /**
+   * Number of levels of the optical flow pyramid.
+   */
+  static const int kPyramidLevels;
+
+  /**
+   * Number of levels of the input pyramid, the full resolution included.
+   */
+  static const int kInputLevels;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] bgr The frame, in BGR. Data is shared, not copied.
+   */
+  explicit FrameContext(const cv::Mat & bgr);
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] image The frame. Data is shared, not copied.
+   * @param[in] encoding Encoding of the frame, see @ref isSupported().
+   */
+  FrameContext(const cv::Mat & image, const std::string & encoding);
+
+  /**
+   * @brief Get the size of the frame.
+   */
+  cv::Size getSize() const {return image_.size();}
+
+  /**
+   * @brief Get the frame in BGR, converted once if needed.
+   */
+  const cv::Mat & getBgr();
+
+  /**
+   * @brief Get the frame in grayscale, converted once.
+   */
+  const cv::Mat & getGray();
+
+  /**
+   * @brief Get the optical flow pyramid of the grayscale frame, built once.
+   *
+   * The pyramid is built by cv::buildOpticalFlowPyramid() with a window of
+   * 21x21 and @ref kPyramidLevels levels, and can be passed to
+   * cv::calcOpticalFlowPyrLK() as is.
+   */
+  const std::vector<cv::Mat> & getPyramid();
+
+  /**
+   * @brief Get the input frame for a tracker algorithm.
+   *
+   * Algorithms working on grayscale internally get the shared grayscale frame,
+   * others get the BGR frame.
+   *
+   * @param[in] algo Algorithm name, see @ref Tracking::setAlgo().
+   * @return The frame to pass to the tracker.
+   */
+  const cv::Mat & getInput(const std::string & algo);
+
+  /**
+   * @brief Get the input frame for a tracker algorithm at a pyramid level.
+   *
+   * Level 0 is the frame of @ref getInput(const std::string &), each level is
+   * built once by cv::pyrDown() from the one above, of half its size rounded
+   * up.
+   *
+   * @param[in] algo Algorithm name, see @ref Tracking::setAlgo().
+   * @param[in] level Level of the input pyramid, below @ref kInputLevels.
+   * @return The frame to pass to the tracker.
+   */
+  const cv::Mat & getInput(const std::string & algo, int level);
+
+  /**
+   * @brief Compute ahead the data needed by a set of algorithms.
+   *
+   * @param[in] algos Algorithm names.
+   */
+  void prepare(const std::vector<std::string> & algos);
+
+  /**
+   * @brief Get the bytes of the data derived from the frame.
+   *
+   * The frame as given is not counted, it is owned by the caller. Derived data
+   * sharing it is not counted either. Data is counted once built, so the count
+   * is safe to read while other threads build more.
+   */
+  size_t getBytes() const {return bytes_;}
+
+  /**
+   * @brief Check if an algorithm consumes the grayscale frame.
+   *
+   * @param[in] algo Algorithm name.
+   */
+  static bool isGrayInput(const std::string & algo);
+
+  /**
+   * @brief Check if the frame encoding is accepted without conversion ahead.
+   *
+   * @param[in] encoding Encoding name of sensor_msgs::msg::Image, one of "bgr8",
+   * "rgb8" and "mono8" is supported.
+   */
+  static bool isSupported(const std::string & encoding);
+
+private:
+  /**
+   * @brief Count the bytes of derived data just built.
+   */
+  void addBytes(const cv::Mat & mat);
+
+  cv::Mat image_;                /**< The frame as given.*/
+  std::string encoding_;         /**< Encoding of the frame.*/
+  cv::Mat bgr_;                  /**< The frame in BGR.*/
+  cv::Mat gray_;                 /**< The frame in grayscale.*/
+  std::vector<cv::Mat> pyramid_; /**< Optical flow pyramid.*/
+  std::vector<cv::Mat> bgr_levels_;  /**< Input pyramid of BGR, from level 1.*/
+  std::vector<cv::Mat> gray_levels_; /**< Input pyramid of grayscale, from level 1.*/
+  std::mutex levels_mutex_;      /**< Input pyramid levels built.*/
+  std::once_flag bgr_once_;      /**< BGR converted.*/
+  std::once_flag gray_once_;     /**< Grayscale converted.*/
+  std::once_flag pyramid_once_;  /**< Pyramid built.*/
+  std::atomic<size_t> bytes_{0};  /**< Bytes of the derived data built.*/
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__FRAME_CONTEXT_HPP_
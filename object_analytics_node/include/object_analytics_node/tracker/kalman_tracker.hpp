@@ -0,0 +1,102 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__KALMAN_TRACKER_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__KALMAN_TRACKER_HPP_
+
+#include <opencv2/core.hpp>
+#include <opencv2/video/tracking.hpp>
+#include <cstdint>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class KalmanTracker
+ * Constant velocity motion model of a roi, filtered by a Kalman filter.
+ *
+ * The state is the roi center, width and height, and their velocities. The
+ * roi is predicted from the elapsed time at tracking frames, without looking
+ * at the image, and corrected with the detected roi at detection frames. This
+ * costs microseconds per object, against milliseconds for image based
+ * trackers.
+ *
+ * Time stamps are in nanoseconds. A correction may come with a stamp older
+ * than the latest prediction, e.g. when detection lags behind the camera, the
+ * model is then extrapolated back to the stamp of the correction.
+ */
+class KalmanTracker
+{
+public:
+  /**
+   * @brief Constructor, the tracker is not initialized.
+   */
+  KalmanTracker();
+
+  /**
+   * @brief Initialize the state with a roi, at rest.
+   *
+   * @param[in] rect Roi detected.
+   * @param[in] stamp Time stamp of the roi.
+   */
+  void init(const cv::Rect2d & rect, int64_t stamp);
+
+  /**
+   * @brief Check if the tracker was initialized.
+   */
+  bool isInitialized() const {return initialized_;}
+
+  /**
+   * @brief Predict the roi at a stamp.
+   *
+   * @param[in] stamp Time stamp to predict at.
+   * @return Roi predicted.
+   */
+  cv::Rect2d predict(int64_t stamp);
+
+  /**
+   * @brief Correct the state with a detected roi.
+   *
+   * @param[in] rect Roi detected.
+   * @param[in] stamp Time stamp of the roi.
+   * @return Roi filtered.
+   */
+  cv::Rect2d correct(const cv::Rect2d & rect, int64_t stamp);
+
+  /**
+   * @brief Get the velocity of the roi center, in pixels per second.
+   */
+  cv::Point2d getVelocity() const;
+
+private:
+  /**
+   * @brief Set transition and process noise for a time step.
+   */
+  void setTimeStep(double dt);
+
+  /**
+   * @brief Get the roi of a state.
+   */
+  static cv::Rect2d toRect(const cv::Mat & state);
+
+  static const float kMeasurementNoise; /**< Variance of measured roi, pixel^2.*/
+  static const float kPositionNoise;    /**< Growth of position variance per second.*/
+  static const float kVelocityNoise;    /**< Growth of velocity variance per second.*/
+  cv::KalmanFilter kf_; /**< Filter over [cx, cy, w, h, vcx, vcy, vw, vh].*/
+  int64_t stamp_;       /**< Time stamp of the state.*/
+  bool initialized_;    /**< Tracker initialized.*/
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__KALMAN_TRACKER_HPP_
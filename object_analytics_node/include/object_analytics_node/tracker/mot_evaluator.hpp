@@ -0,0 +1,95 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__MOT_EVALUATOR_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__MOT_EVALUATOR_HPP_
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class MotEvaluator
+ * Multi object tracking accuracy of a sequence, CLEAR MOT (MOTA, MOTP) and IDF1.
+ *
+ * Frames are added in order with their ground truth and tracked boxes. In each frame a target
+ * keeps the tracking it was matched to before if they still overlap, the others are matched by
+ * @ref Association maximizing the sum of IoU. A target matched to another tracking than before
+ * is an identity switch. For IDF1, the frames each target and tracking overlap are counted, and
+ * targets are assigned to trackings once for the whole sequence.
+ */
+class MotEvaluator
+{
+public:
+  /** A box of a frame, of a target or of a tracking.*/
+  struct Box
+  {
+    int64_t id;      /**< Identifier of the target or tracking.*/
+    cv::Rect2d roi;  /**< Region of the box.*/
+  };
+
+  /** Accuracy over the frames added.*/
+  struct Summary
+  {
+    uint64_t frames = 0;        /**< Frames added.*/
+    uint64_t targets = 0;       /**< Ground truth boxes.*/
+    uint64_t hypotheses = 0;    /**< Tracked boxes.*/
+    uint64_t matches = 0;       /**< Ground truth boxes matched.*/
+    uint64_t misses = 0;        /**< Ground truth boxes not matched, false negatives.*/
+    uint64_t false_positives = 0;  /**< Tracked boxes not matched.*/
+    uint64_t id_switches = 0;   /**< Targets matched to another tracking than before.*/
+    double mota = 0.;           /**< 1 - (misses + false positives + switches) / targets.*/
+    double motp = 0.;           /**< Mean IoU of the matches.*/
+    double idf1 = 0.;           /**< F1 score of the boxes matched with consistent identities.*/
+  };
+
+  /** Default least IoU of a match.*/
+  static const double kDefaultIou;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] min_iou Least IoU of a ground truth box and a tracked box to be matched.
+   */
+  explicit MotEvaluator(double min_iou = kDefaultIou);
+
+  /**
+   * @brief Add the next frame of the sequence.
+   *
+   * @param[in] targets Ground truth boxes, of distinct ids.
+   * @param[in] hypotheses Tracked boxes, of distinct ids.
+   */
+  void addFrame(const std::vector<Box> & targets, const std::vector<Box> & hypotheses);
+
+  /**
+   * @brief Get the accuracy of the frames added so far.
+   */
+  Summary getSummary() const;
+
+private:
+  double min_iou_;
+  Summary counts_;
+  double iou_sum_ = 0.;
+  /* tracking each target was matched to last*/
+  std::map<int64_t, int64_t> last_match_;
+  /* frames each target and tracking overlap, for IDF1*/
+  std::map<std::pair<int64_t, int64_t>, uint64_t> overlaps_;
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__MOT_EVALUATOR_HPP_
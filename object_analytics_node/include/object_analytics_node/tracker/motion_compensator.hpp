@@ -0,0 +1,60 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__MOTION_COMPENSATOR_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__MOTION_COMPENSATOR_HPP_
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "object_analytics_node/tracker/frame_context.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class MotionCompensator
+ * Carry the rois detected in a frame over to a later frame, so a late
+ * detection is rectified against the latest frame at once, instead of
+ * rectifying the frame of the detection and replaying the frames since.
+ *
+ * A grid of points in each roi is tracked by sparse optical flow between the
+ * optical flow pyramids of the two frames, shared with the trackers, see
+ * FrameContext::getPyramid(). Points are tracked forward and back, and those
+ * not coming back near their start are dropped. The roi is shifted by the
+ * median flow of the points kept, which is robust to the background inside
+ * the roi. The cost depends on the number of rois, not on the frames between.
+ */
+class MotionCompensator
+{
+public:
+  /** Points of the grid along each side of a roi.*/
+  static const int kGridSide;
+
+  /**
+   * @brief Estimate the shift of each roi from a frame to a later one.
+   *
+   * @param[in] from Context of the frame the rois are detected in.
+   * @param[in] to Context of the later frame, of the same size.
+   * @param[in] rois Rois in the pixels of the frames.
+   * @param[out] shifts Median flow of each roi in pixels, zero if not found.
+   * @return Number of rois whose shift is found, the others are too few
+   * points tracked back.
+   */
+  static size_t estimate(
+    FrameContext & from, FrameContext & to, const std::vector<cv::Rect2d> & rois,
+    std::vector<cv::Point2d> & shifts);
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__MOTION_COMPENSATOR_HPP_
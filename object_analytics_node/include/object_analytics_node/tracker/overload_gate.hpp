@@ -0,0 +1,119 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__OVERLOAD_GATE_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__OVERLOAD_GATE_HPP_
+
+#include <cstdint>
+#include <string>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class OverloadGate
+ * Decide how a tracking frame is processed, against a latency target.
+ *
+ * The latency of a frame is the age of its stamp when the frame is taken from
+ * the subscription queue. When it exceeds the target, tracking is running
+ * behind the camera, and the frame is handled by the overload policy:
+ * - "none", track every frame regardless of latency.
+ * - "latest", skip late frames, so the backlog is drained down to the latest.
+ * - "every_k", track one of every k late frames and skip the others.
+ * - "interpolate", extrapolate late frames from the tracking history instead
+ * of updating the trackers.
+ *
+ * Whatever the policy, no more than max_skip frames in a row are left
+ * untracked, so trackers keep a minimum update cadence under a sustained
+ * overload rather than drifting until it is over.
+ */
+class OverloadGate
+{
+public:
+  /** Overload policies, see @ref OverloadGate.*/
+  enum Policy
+  {
+    kNone,
+    kLatest,
+    kEveryK,
+    kInterpolate,
+  };
+
+  /** How a frame shall be processed.*/
+  enum Action
+  {
+    kTrack,        /**< Update trackers with the frame.*/
+    kSkip,         /**< Drop the frame.*/
+    kExtrapolate,  /**< Publish rois extrapolated from history.*/
+  };
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] policy Overload policy.
+   * @param[in] latency_target_ms Latency above which a frame is late.
+   * @param[in] interval Interval k of policy "every_k", at least 1.
+   * @param[in] max_skip Frames not tracked in a row before a late frame is
+   * tracked anyway, at least 1.
+   */
+  OverloadGate(
+    Policy policy = kNone, double latency_target_ms = 0, uint32_t interval = 2,
+    uint32_t max_skip = 5);
+
+  /**
+   * @brief Parse the policy name.
+   *
+   * @param[in] name One of "none", "latest", "every_k" and "interpolate".
+   * @param[out] policy Policy parsed.
+   * @return true if the name is valid.
+   */
+  static bool parse(const std::string & name, Policy & policy);
+
+  /**
+   * @brief Decide the processing of a frame.
+   *
+   * @param[in] latency_ms Latency of the frame.
+   * @return Action to take.
+   */
+  Action admit(double latency_ms);
+
+  /**
+   * @brief Check if the latest frame admitted was late.
+   */
+  bool isOverloaded() const {return overloaded_;}
+
+  /**
+   * @brief Get the number of frames not tracked since construction.
+   */
+  uint64_t getSkipped() const {return skipped_;}
+
+  /**
+   * @brief Get the number of frames not tracked in the current overload.
+   */
+  uint64_t getSkippedInOverload() const {return skipped_in_overload_;}
+
+private:
+  Policy policy_;              /**< Overload policy.*/
+  double latency_target_ms_;   /**< Latency above which a frame is late.*/
+  uint32_t interval_;          /**< Track one of this many late frames.*/
+  uint32_t max_skip_;          /**< Frames not tracked in a row at most.*/
+  uint32_t since_track_;       /**< Frames not tracked since the last tracked.*/
+  bool overloaded_;            /**< Latest frame was late.*/
+  uint64_t late_;              /**< Number of late frames in this overload.*/
+  uint64_t skipped_;           /**< Total number of frames not tracked.*/
+  uint64_t skipped_in_overload_; /**< Frames not tracked in this overload.*/
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__OVERLOAD_GATE_HPP_
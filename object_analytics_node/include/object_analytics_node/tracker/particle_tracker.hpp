@@ -0,0 +1,129 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__PARTICLE_TRACKER_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__PARTICLE_TRACKER_HPP_
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class ParticleTracker
+ * Particle filter over the roi, weighted by its intensity histogram.
+ *
+ * Each particle is a roi hypothesis [cx, cy, w, h]. At every update the
+ * particles are diffused by gaussian noise relative to the roi size, weighted
+ * by the Bhattacharyya similarity of their grayscale histogram to the one of
+ * the initial roi, and resampled. The roi tracked is the weighted mean.
+ *
+ * The histograms of all particles are read from per bin integral images of
+ * the region covered by the particles, built once per update, so the cost of
+ * a particle does not depend on its size. Particles are weighted in parallel.
+ *
+ * The number of particles trades accuracy for cost, by default it scales with
+ * the number of cores, see @ref setParticles().
+ */
+class ParticleTracker
+{
+public:
+  static const int kBins;             /**< Histogram bins, of 256 / kBins levels.*/
+  static const int kParticlesPerCore; /**< Default particles per core.*/
+
+  /**
+   * @brief Constructor, the tracker is not initialized.
+   *
+   * @param[in] particles Number of particles, 0 to scale with the cores.
+   * @param[in] seed Seed of the random generator.
+   */
+  explicit ParticleTracker(int particles = 0, uint64_t seed = 0x5eed);
+
+  /**
+   * @brief Set the number of particles, taken at the next @ref init().
+   *
+   * @param[in] particles Number of particles, 0 for @ref kParticlesPerCore per
+   * core.
+   */
+  void setParticles(int particles);
+
+  /**
+   * @brief Get the number of particles used at the next @ref init().
+   */
+  int getParticles() const;
+
+  /**
+   * @brief Initialize the particles and the reference histogram with a roi.
+   *
+   * @param[in] gray Frame in grayscale.
+   * @param[in] rect Roi of the object.
+   */
+  void init(const cv::Mat & gray, const cv::Rect2d & rect);
+
+  /**
+   * @brief Check if the tracker was initialized.
+   */
+  bool isInitialized() const {return !particles_.empty();}
+
+  /**
+   * @brief Drop the particles, the tracker is no more initialized.
+   */
+  void reset();
+
+  /**
+   * @brief Track the roi in a new frame.
+   *
+   * @param[in] gray Frame in grayscale.
+   * @param[out] rect Roi tracked.
+   * @return false if no particle looks like the object any more.
+   */
+  bool update(const cv::Mat & gray, cv::Rect2d & rect);
+
+  /**
+   * @brief Get the best similarity of the latest update, in [0, 1].
+   */
+  double getSimilarity() const {return similarity_;}
+
+  /**
+   * @brief Get the bytes held by the particles and histograms.
+   */
+  size_t getBytes() const;
+
+private:
+  /**
+   * @brief Build the per bin integral images of a region of the frame.
+   */
+  void integrate(const cv::Mat & gray, const cv::Rect & region);
+
+  static const double kPositionStd;   /**< Diffusion of the center, of the roi size.*/
+  static const double kScaleStd;      /**< Diffusion of the roi size, relative.*/
+  static const double kLambda;        /**< Sharpness of the weights.*/
+  static const double kMinSimilarity; /**< Similarity below which the object is lost.*/
+  int particles_count_;    /**< Particles requested, 0 to scale with the cores.*/
+  cv::RNG rng_;            /**< Random generator of diffusion and resampling.*/
+  cv::Mat particles_;      /**< Particles, N x [cx, cy, w, h] in CV_64F.*/
+  cv::Mat noise_;          /**< Diffusion noise, of the particles size.*/
+  cv::Mat weights_;        /**< Weights of the particles, N x 1 in CV_64F.*/
+  cv::Mat similarities_;   /**< Similarities of the particles, N x 1 in CV_64F.*/
+  cv::Mat resampled_;      /**< Particles drawn by resampling, swapped with particles_.*/
+  std::vector<float> reference_;   /**< Histogram of the initial roi.*/
+  std::vector<cv::Mat> integrals_; /**< Per bin integral images of the region.*/
+  cv::Rect region_;        /**< Region of the integral images in the frame.*/
+  double similarity_;      /**< Best similarity of the latest update.*/
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__PARTICLE_TRACKER_HPP_
@@ -0,0 +1,149 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__REID_INDEX_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__REID_INDEX_HPP_
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class ReidIndex
+ * Approximate nearest neighbour index of the appearance of trackings lost, to
+ * give an object coming back the ID it had, see TrackingManager::setReid().
+ *
+ * The appearance of an object is a compact descriptor of @ref kDims floats,
+ * the color histograms of the upper and the lower half of its roi, by hue and
+ * saturation, or by value for pixels nearly gray,
+ * see @ref describe(). Descriptors are unit length, compared by their dot
+ * product, the cosine similarity.
+ *
+ * Entries are hashed by random hyperplanes, each of @ref kTables tables
+ * keyed by the class and the @ref kBits signs of the descriptor against its
+ * planes. A query visits the bucket of its key and the buckets one bit apart
+ * in every table, and scores only the entries found there, so a lookup costs
+ * about the same with thousands of entries as with a few. Entries older than
+ * the maximum age, or beyond the capacity, are dropped oldest first.
+ */
+class ReidIndex
+{
+public:
+  static const int kDims;    /**< Floats of a descriptor.*/
+  static const int kTables;  /**< Hash tables.*/
+  static const int kBits;    /**< Planes of a hash table.*/
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] capacity Most entries kept.
+   * @param[in] max_age Nanoseconds an entry is kept, 0 if forever.
+   * @param[in] min_similarity Least cosine similarity of a match, in (0, 1].
+   */
+  ReidIndex(size_t capacity, int64_t max_age, double min_similarity);
+
+  /**
+   * @brief Compute the descriptor of the appearance of an object.
+   *
+   * At most 32 x 32 pixels of the roi are sampled, whatever its size.
+   *
+   * @param[in] bgr The frame, 8 bit BGR.
+   * @param[in] rect Roi of the object, clipped to the frame.
+   * @param[out] desc Descriptor of @ref kDims floats, unit length, empty if
+   * the roi is out of the frame.
+   */
+  static void describe(const cv::Mat & bgr, const cv::Rect2d & rect, std::vector<float> & desc);
+
+  /**
+   * @brief Blend a descriptor into a running one, unit length.
+   *
+   * @param[in,out] running Running descriptor, set to desc if empty.
+   * @param[in] desc Descriptor of a new detection.
+   * @param[in] weight Weight of desc, in (0, 1].
+   */
+  static void blend(std::vector<float> & running, const std::vector<float> & desc, float weight);
+
+  /**
+   * @brief Add the appearance of a tracking lost.
+   *
+   * @param[in] id ID of the tracking.
+   * @param[in] class_id Class of the object, see util::ClassTable.
+   * @param[in] desc Descriptor, see @ref describe().
+   * @param[in] stamp Stamp of the latest detection in nanoseconds.
+   */
+  void insert(int64_t id, int32_t class_id, const std::vector<float> & desc, int64_t stamp);
+
+  /**
+   * @brief Take the most similar entry of a class, removed from the index.
+   *
+   * @param[in] class_id Class of the object.
+   * @param[in] desc Descriptor of the object.
+   * @param[in] stamp Stamp of the detection in nanoseconds, entries older
+   * than the maximum age are dropped first.
+   * @return ID of the entry, -1 if none is at least the least similarity.
+   */
+  int64_t take(int32_t class_id, const std::vector<float> & desc, int64_t stamp);
+
+  /**
+   * @brief Get the number of entries.
+   */
+  size_t size() const {return size_;}
+
+  /**
+   * @brief Get the number of places in the order of insertion, stale ones too.
+   */
+  size_t getOrdered() const {return order_.size();}
+
+private:
+  /** Appearance of a tracking lost.*/
+  struct Entry
+  {
+    int64_t id;
+    int32_t class_id;
+    int64_t stamp;
+    std::vector<float> desc;
+    std::vector<uint32_t> keys;  /**< Key in each table.*/
+    uint64_t seq;       /**< Order of insertion.*/
+    bool alive;
+    uint64_t visited;   /**< Query which scored it last.*/
+  };
+
+  void hash(int32_t class_id, const std::vector<float> & desc, std::vector<uint32_t> & keys) const;
+  void remove(size_t slot);
+  void expire(int64_t stamp);
+  void compact();
+
+  size_t capacity_;
+  int64_t max_age_;
+  double min_similarity_;
+  cv::Mat planes_;   /**< kTables * kBits planes, one per row.*/
+  std::vector<Entry> entries_;
+  std::vector<size_t> free_;   /**< Slots of entries removed.*/
+  /** Slot and sequence of the entries in the order inserted, removed ones too,
+   * at most twice the capacity.*/
+  std::deque<std::pair<size_t, uint64_t>> order_;
+  std::vector<std::unordered_map<uint32_t, std::vector<size_t>>> tables_;
+  size_t size_ = 0;
+  uint64_t seq_ = 0;
+  uint64_t queries_ = 0;
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__REID_INDEX_HPP_
@@ -0,0 +1,101 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__SPATIAL_GRID_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__SPATIAL_GRID_HPP_
+
+#include <opencv2/core/types.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class SpatialGrid
+ * Uniform grid index over a set of rois, to find rois near a query roi.
+ *
+ * Every roi is registered in all the cells it covers. A query visits the cells
+ * covered by the query roi only, and returns the rois registered there. Two
+ * rois which do not share any cell have no overlap, hence never match, see
+ * @ref model::ObjectUtils::getMatch().
+ *
+ * The grid is meant to be rebuilt once per frame, see @ref build(). Only the
+ * cells covered by the rois of the frame are kept, as one array of cell and
+ * roi pairs sorted by cell, so the index is bounded by the rois of the frame
+ * and its storage reused from frame to frame, wherever the rois move.
+ */
+class SpatialGrid
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] cell_size Width and height of a cell in pixels. With a value not
+   * above zero the cell size is derived from the mean roi size in @ref build().
+   */
+  explicit SpatialGrid(double cell_size = 0);
+
+  /**
+   * @brief Rebuild the grid over a set of rois.
+   *
+   * @param[in] rects Rois to index, the index of a roi in this list is the
+   * value returned from @ref query().
+   */
+  void build(const std::vector<cv::Rect2d> & rects);
+
+  /**
+   * @brief Find the rois sharing at least one cell with a query roi.
+   *
+   * @param[in] rect The query roi.
+   * @param[out] indices Indices of the rois found, in ascending order.
+   */
+  void query(const cv::Rect2d & rect, std::vector<size_t> & indices) const;
+
+  /**
+   * @brief Get the cell size in use.
+   */
+  double getCellSize() const {return cell_;}
+
+  /**
+   * @brief Get the number of cell and roi pairs indexed, each roi counted once
+   * per cell it covers.
+   */
+  size_t getEntryCount() const {return entries_.size();}
+
+private:
+  /**
+   * @brief Get the cell range covered by a roi.
+   */
+  void getCells(
+    const cv::Rect2d & rect, int64_t & x0, int64_t & y0,
+    int64_t & x1, int64_t & y1) const;
+
+  /**
+   * @brief Key of the cell at column x, row y.
+   */
+  static uint64_t getKey(int64_t x, int64_t y)
+  {
+    return (static_cast<uint64_t>(y) << 32) ^ (static_cast<uint64_t>(x) & 0xffffffff);
+  }
+
+  double cell_size_;   /**< Cell size configured, not above zero for auto.*/
+  double cell_;        /**< Cell size in use.*/
+  size_t count_;       /**< Number of rois indexed.*/
+  std::vector<std::pair<uint64_t, size_t>> entries_; /**< Key of a cell and a roi in it.*/
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__SPATIAL_GRID_HPP_
@@ -0,0 +1,137 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__TRACKER_POOL_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__TRACKER_POOL_HPP_
+
+#include <opencv2/tracking.hpp>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class TrackerPool
+ * Pool of tracker instances, one stock per algorithm.
+ *
+ * Trackings acquire a tracker from the pool instead of creating one, and
+ * release it back instead of destroying it. Creation and destruction are then
+ * done in @ref replenish(), which is called between frames, so that rectify
+ * and cleanup in the frame path do not allocate or free tracker models.
+ *
+ * An OpenCV tracker refuses to be initialized twice, so a released tracker is
+ * retired and destroyed in @ref replenish(), while acquisitions are served from
+ * the stock of fresh trackers created ahead. Calling @ref replenish() is only
+ * a hint to move that work out of the frame path: at most the stock size, or
+ * @ref kMinRetired, trackers are retired, those released beyond are destroyed
+ * by their last owner, so callers which never replenish do not leak trackers.
+ *
+ * The pool is shared by trackings updated in parallel, all methods are thread
+ * safe.
+ */
+class TrackerPool
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] stock Number of trackers kept ready per algorithm.
+   */
+  explicit TrackerPool(size_t stock = 0);
+
+  static const size_t kMinRetired;  /**< Trackers retired at least, whatever the stock.*/
+
+  /**
+   * @brief Create trackers for an algorithm up to the stock size.
+   *
+   * @param[in] algo Algorithm name.
+   */
+  void prewarm(const std::string & algo);
+
+  /**
+   * @brief Get a tracker of an algorithm, created only if the stock is empty.
+   *
+   * @param[in] algo Algorithm name.
+   * @return Tracker not yet initialized.
+   */
+  cv::Ptr<cv::Tracker> acquire(const std::string & algo);
+
+  /**
+   * @brief Give a tracker back to the pool.
+   *
+   * @param[in] algo Algorithm name of the tracker.
+   * @param[in] tracker Tracker released by a tracking, destroyed in @ref
+   * replenish(), or by the caller dropping it if too many are retired.
+   */
+  void release(const std::string & algo, const cv::Ptr<cv::Tracker> & tracker);
+
+  /**
+   * @brief Destroy retired trackers and refill the stock of used algorithms.
+   *
+   * Optional, best called out of the frame path, e.g. after publishing
+   * results.
+   */
+  void replenish();
+
+  /**
+   * @brief Set the number of trackers kept ready per algorithm.
+   */
+  void setStock(size_t stock);
+
+  /**
+   * @brief Get the rate of acquisitions served from the stock.
+   *
+   * @return Hit rate in [0, 1], 0 if nothing acquired yet.
+   */
+  double getHitRate();
+
+  /**
+   * @brief Get the count of acquisitions.
+   */
+  uint64_t getAcquired();
+
+  /**
+   * @brief Get the number of trackers released and not yet destroyed.
+   */
+  size_t getRetired();
+
+  /**
+   * @brief Get the number of trackers in stock, of all algorithms.
+   */
+  size_t getIdle();
+
+  /**
+   * @brief Create a tracker by algorithm name.
+   *
+   * @param[in] algo Algorithm name, see @ref Tracking::setAlgo().
+   * @return The tracker created, empty for "KALMAN", "PARTICLE" and
+   * "GOTURN_BATCH" which need no OpenCV tracker.
+   */
+  static cv::Ptr<cv::Tracker> create(const std::string & algo);
+
+private:
+  std::mutex mutex_;  /**< Guard of the pool.*/
+  size_t stock_;      /**< Number of trackers kept ready per algorithm.*/
+  std::map<std::string, std::vector<cv::Ptr<cv::Tracker>>> ready_; /**< Stock.*/
+  std::vector<cv::Ptr<cv::Tracker>> retired_; /**< Trackers to destroy.*/
+  uint64_t acquired_; /**< Count of acquisitions.*/
+  uint64_t hits_;     /**< Count of acquisitions served from the stock.*/
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__TRACKER_POOL_HPP_
@@ -17,9 +17,18 @@
 
 #include <opencv2/tracking.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
+#include "object_analytics_node/tracker/batch_goturn.hpp"
+#include "object_analytics_node/tracker/frame_context.hpp"
+#include "object_analytics_node/tracker/kalman_tracker.hpp"
+#include "object_analytics_node/tracker/particle_tracker.hpp"
+#include "object_analytics_node/tracker/tracker_pool.hpp"
+#include "object_analytics_node/tracker/tracking_snapshot.hpp"
+#include "object_analytics_node/util/class_table.hpp"
+#include "object_analytics_node/util/stamped_ring_buffer.hpp"
 
 namespace object_analytics_node
 {
@@ -35,12 +44,24 @@ namespace tracker
  *
  * Also a tracking has some internal attributs
  * - ageing, will be increased by one upon a tracking frame arrives, and will be
- * reset to zero when a detection frame arrives. @ref kAgeingThreshold specify
- * the maximum age of an active tracking. Trackings below this age are actively
- * updated when tracking frame arrives. Trackings above this age are consider
- * inactive, and to be removed from the list.
+ * reset to zero when a detection frame arrives.
  * - detected, will be set when a detection frame arrives. Tracking associated
  * to a detected object will have its detected flag set as true.
+ * - state, the stage of its lifecycle, see @ref State and @ref Lifecycle. A
+ * tracking starts tentative, and is confirmed once detected often enough. A
+ * confirmed tracking gets lost when its tracker fails, or when its age reaches
+ * the maximum, its tracker is then released and its roi only extrapolated
+ * until detected again. A tentative tracking missing a detection, and any
+ * tracking missing too many, is deleted, and to be removed from the list.
+ *
+ * Besides the OpenCV trackers, algorithm "KALMAN" tracks the roi with a
+ * constant velocity motion model, see @ref KalmanTracker. It is predicted at
+ * tracking frames without looking at the image, and corrected at detection
+ * frames. Algorithm "PARTICLE" tracks the roi with a particle filter over the
+ * grayscale frame, see @ref ParticleTracker, of a cost set by its number of
+ * particles, see @ref setParticles(). Algorithm "GOTURN_BATCH" is the GOTURN
+ * network run once per frame for the objects of all trackings, see @ref
+ * BatchGoturn and TrackingManager::track().
  *
  * When a tracking is created, it is assigned a tracking ID, and associated with
  * the name and roi of the detected object. When a detection frame arrives, a
@@ -51,6 +72,25 @@ namespace tracker
 class Tracking
 {
 public:
+  /** Stage of the lifecycle of a tracking.*/
+  enum State
+  {
+    kTentative,   /**< Not detected often enough to be published.*/
+    kConfirmed,   /**< Published, its tracker updated with every frame.*/
+    kLost,        /**< Tracker failed or aged out, its roi only extrapolated.*/
+    kDeleted      /**< To be removed from the list.*/
+  };
+
+  /** Lifecycle policy of a tracking, see @ref setLifecycle().*/
+  struct Lifecycle
+  {
+    Lifecycle();
+
+    int32_t confirm_hits;  /**< Detections confirming a tentative tracking.*/
+    int32_t max_age;       /**< Tracking frames without detection before lost, 0 if never.*/
+    int32_t max_misses;    /**< Detection frames missed before deleted, 0 if never.*/
+  };
+
   /**
    * @brief Constructor of Tracking.
    *
@@ -60,7 +100,7 @@ public:
    * @param[in] rect Roi of the tracked object.
    */
   explicit Tracking(
-    int32_t tracking_id, const std::string & name,
+    int64_t tracking_id, const std::string & name,
     const float & probability, const cv::Rect2d & rect);
 
   /**
@@ -71,15 +111,36 @@ public:
   /**
    * @brief Rectify tracker with the roi of the detected object.
    *
+   * The tracker is re-seeded with the detected roi, unless warm rectify is
+   * enabled, see @ref setRectifyThreshold(), and the roi tracked at the
+   * detection stamp still agrees with the detected one. In that case the
+   * tracker is kept alive, which saves the cost of re-creating its model.
+   *
    * @param[in] mat The detection frame.
    * @param[in] tracked_rect Roi of the tracked object.
    * @param[in] detected_rect Roi of the detected object.
+   * @return true if the tracker was re-seeded, false if kept.
    */
-  void rectifyTracker(
+  bool rectifyTracker(
     const cv::Mat & mat, const cv::Rect2d & tracked_rect,
     const cv::Rect2d & detected_rect,
     builtin_interfaces::msg::Time stamp);
 
+  /**
+   * @brief Rectify tracker with the roi of the detected object.
+   *
+   * Same as above, with the frame preprocessed in a shared context.
+   *
+   * @param[in] ctx Context of the detection frame.
+   * @param[in] tracked_rect Roi of the tracked object.
+   * @param[in] detected_rect Roi of the detected object.
+   * @return true if the tracker was re-seeded, false if kept.
+   */
+  bool rectifyTracker(
+    FrameContext & ctx, const cv::Rect2d & tracked_rect,
+    const cv::Rect2d & detected_rect,
+    builtin_interfaces::msg::Time stamp);
+
   /**
    * @brief Update tracker with the tracking frame.
    *
@@ -88,6 +149,26 @@ public:
    */
   bool updateTracker(const cv::Mat & mat, builtin_interfaces::msg::Time stamp);
 
+  /**
+   * @brief Update tracker with the tracking frame.
+   *
+   * Same as above, with the frame preprocessed in a shared context.
+   *
+   * @param[in] ctx Context of the tracking frame.
+   * @return true if tracker was updated successfully, otherwise false.
+   */
+  bool updateTracker(FrameContext & ctx, builtin_interfaces::msg::Time stamp);
+
+  /**
+   * @brief Move the tracked roi to a frame without updating the tracker.
+   *
+   * The roi is extrapolated with @ref getVelocity() from the latest entry of
+   * history, and collected into history as if tracked.
+   *
+   * @param[in] stamp Time stamp of the frame.
+   */
+  void extrapolate(builtin_interfaces::msg::Time stamp);
+
   /**
    * @brief Get the roi of tracked object.
    *
@@ -95,12 +176,75 @@ public:
    */
   cv::Rect2d getTrackedRect();
 
+  /**
+   * @brief Get the velocity of the roi center, in pixels per second.
+   *
+   * With algorithm "KALMAN" the velocity is estimated by the motion model,
+   * otherwise from the latest two entries of history.
+   *
+   * @return Velocity of the tracked object, zero if unknown.
+   */
+  cv::Point2d getVelocity();
+
+  /**
+   * @brief Set the 3d centroid of the object, as localized in its latest
+   * detection.
+   *
+   * @param[in] centroid Center of the 3d bounds, in camera coordinates.
+   */
+  void setCentroid(const cv::Point3d & centroid)
+  {
+    centroid_ = centroid;
+    has_centroid_ = true;
+  }
+
+  /**
+   * @brief Check if the object was ever localized, see @ref setCentroid().
+   */
+  bool hasCentroid() const {return has_centroid_;}
+
+  /**
+   * @brief Get the 3d centroid of the object in its latest localization.
+   */
+  const cv::Point3d & getCentroid() const {return centroid_;}
+
+  /**
+   * @brief Blend the appearance of a detection into that of the object, see
+   * ReidIndex::blend().
+   *
+   * @param[in] desc Descriptor of the detected roi, see ReidIndex::describe().
+   */
+  void updateAppearance(const std::vector<float> & desc);
+
+  /**
+   * @brief Get the running appearance of the object, empty if never set.
+   */
+  const std::vector<float> & getAppearance() const {return appearance_;}
+
+  /**
+   * @brief Check if the tracking was ever confirmed, see @ref
+   * Lifecycle::confirm_hits.
+   */
+  bool wasConfirmed() const {return hits_ >= lifecycle_.confirm_hits;}
+
   /**
    * @brief Get the name of the tracked object.
    *
    * @return Name of the tracked object.
    */
-  std::string getObjName();
+  const std::string & getObjName() const {return util::ClassTable::name(class_id_);}
+
+  /**
+   * @brief Get the interned class ID of the tracked object.
+   *
+   * @return Class ID, the same for all objects of a name.
+   */
+  int32_t getClassId() const {return class_id_;}
+
+  /**
+   * @brief Get the number of tracking frames since the latest detection.
+   */
+  int32_t getAgeing() const {return ageing_;}
 
   /**
    * @brief Get the probability of the tracked object.
@@ -121,14 +265,36 @@ public:
    *
    * @return ID of the tracking.
    */
-  int32_t getTrackingId();
+  int64_t getTrackingId();
+
+  /**
+   * @brief Get the active status of a tracking, see @ref State.
+   *
+   * @return true if tracking is not deleted, otherwise false.
+   */
+  bool isActive() const {return state_ != kDeleted;}
+
+  /**
+   * @brief Get the stage of the lifecycle of a tracking.
+   */
+  State getState() const {return state_;}
+
+  /**
+   * @brief Set the lifecycle policy of a tracking.
+   *
+   * @param[in] lifecycle Policy of the state transitions.
+   */
+  void setLifecycle(const Lifecycle & lifecycle) {lifecycle_ = lifecycle;}
 
   /**
-   * @brief Get the active status of a tracking, see @ref kAgeingThreshold.
+   * @brief Apply the misses of a detection frame to the state.
    *
-   * @return true if tracking is active, otherwise false.
+   * To be called once per detection frame, after all trackings detected are
+   * marked, see @ref setDetected(). A tentative tracking not detected, or a
+   * tracking missing @ref Lifecycle::max_misses detections in a row, is
+   * deleted.
    */
-  bool isActive();
+  void updateState();
 
   /**
    * @brief Get the detected status of a tracking.
@@ -139,6 +305,9 @@ public:
 
   /**
    * @brief Set the detected status of a tracking. Ageing is set to zero also.
+   *
+   * A tentative tracking detected @ref Lifecycle::confirm_hits times, or a
+   * lost tracking detected again, is confirmed.
    */
   void setDetected();
 
@@ -155,16 +324,106 @@ public:
 
   /**
    * @brief Set algorithm used for tracking.
+   *
+   * A running tracker keeps its algorithm, the new one is taken when the
+   * tracker is re-seeded at the next rectify.
    * @return true if the algorithm is available.
    */
   bool setAlgo(std::string algo);
 
+  /**
+   * @brief Get algorithm of the running tracker.
+   * @return tracking algorithm name, empty before the first rectify.
+   */
+  std::string getActiveAlgo() {return active_algo_;}
+
+  /**
+   * @brief Get the time spent by the latest tracker update.
+   * @return Update cost in milliseconds.
+   */
+  double getUpdateCost() {return update_cost_;}
+
+  /**
+   * @brief Get an estimate of the bytes held by this tracking.
+   *
+   * OpenCV trackers do not expose their model, it is taken as one BGR patch of
+   * the tracked roi, plus the history of this tracking. "TLD" grows its model
+   * with the examples learned at every update, see @ref kTldLearnedBytes.
+   */
+  size_t getModelBytes();
+
+  /**
+   * @brief Set the budget of the model of the tracker.
+   *
+   * Online-learning trackers ("TLD", "MIL", "BOOSTING") learn at every update,
+   * a long-lived tracking grows in memory or in update time. A tracker over
+   * either budget is re-seeded at its tracked roi, or at the detection roi on
+   * the next rectify, dropping what it learned, see @ref getCompactions().
+   * @param[in] bytes Budget of @ref getModelBytes(), 0 if any.
+   * @param[in] update_ms Budget of the mean update cost in ms, 0 if any.
+   */
+  void setModelBudget(size_t bytes, double update_ms);
+
+  /**
+   * @brief Get the number of re-seeds by the model budget, see @ref setModelBudget().
+   */
+  uint32_t getCompactions() const {return compactions_;}
+
+  /**
+   * @brief Get the number of updates of the tracker since it was seeded.
+   */
+  uint32_t getModelUpdates() const {return model_updates_;}
+
+  /**
+   * @brief Get the mean update cost of the tracker since it was seeded, in ms.
+   *
+   * Averaged over the latest 10 updates or so, the cost of a model grown.
+   */
+  double getMeanUpdateCost() const {return mean_cost_;}
+
   /**
    * @brief create Tracker accoring to algorithm name.
+   *
+   * The tracker is taken from the tracker pool if set, see @ref
+   * setTrackerPool().
    * @return the tracker created.
    */
   cv::Ptr<cv::Tracker> createTrackerByAlgo(std::string name);
 
+  /**
+   * @brief Set the pool to acquire trackers from and release trackers to.
+   * @param[in] pool Tracker pool shared by trackings.
+   */
+  void setTrackerPool(const std::shared_ptr<TrackerPool> & pool) {tracker_pool_ = pool;}
+
+  /**
+   * @brief Set the network of algorithm "GOTURN_BATCH".
+   *
+   * Without a network loaded, "GOTURN_BATCH" is seeded as "GOTURN".
+   * @param[in] batch Network shared by the trackings of a manager.
+   */
+  void setBatchGoturn(const std::shared_ptr<BatchGoturn> & batch) {batch_ = batch;}
+
+  /**
+   * @brief Check if the tracker is updated in a batch, see BatchGoturn::update().
+   */
+  bool isBatched() const {return active_algo_ == "GOTURN_BATCH" && !batch_target_.patch.empty();}
+
+  /**
+   * @brief Get the target of the batch of the tracker, see @ref isBatched().
+   */
+  BatchGoturn::Target * getBatchTarget() {return &batch_target_;}
+
+  /**
+   * @brief Complete the update of a tracker run in a batch, as updateTracker().
+   *
+   * @param[in] stamp Time stamp of the tracking frame.
+   * @param[in] tracked false if the batch lost the target.
+   * @param[in] cost Share of the tracking in the cost of the batch, in ms.
+   * @return false if the object is lost.
+   */
+  bool finishBatch(builtin_interfaces::msg::Time stamp, bool tracked, double cost);
+
   /**
    * @brief collect the history coordination with time stamps.
    * @param[in] stamp The tracking frame stamp.
@@ -193,20 +452,193 @@ public:
    */
   bool checkTimeZone(builtin_interfaces::msg::Time stamp);
 
+  /**
+   * @brief Set the number of tracked coordinates kept in history.
+   *
+   * The history shall cover the latency of detection, in frames. Existing
+   * history is dropped.
+   *
+   * @param[in] capacity Maximum number of history entries.
+   */
+  void setHistoryCapacity(size_t capacity);
+
+  /**
+   * @brief Get the number of tracked coordinates kept in history.
+   */
+  size_t getHistoryCapacity() {return hisCor_.capacity();}
+
+  /**
+   * @brief Set the threshold of warm rectify.
+   *
+   * When rectifying, a tracker is kept if the overlap rate (intersection over
+   * union) between the detected roi and the tracked roi of the same frame is
+   * not less than this threshold. A threshold not above zero disables warm
+   * rectify, every rectify re-seeds the tracker.
+   *
+   * @param[in] threshold Minimum overlap rate to keep the tracker.
+   */
+  void setRectifyThreshold(double threshold) {rectify_threshold_ = threshold;}
+
+  /**
+   * @brief Set the cropping of the frame around the tracked roi.
+   *
+   * With a margin, the tracker is seeded and updated on a window of the frame,
+   * the roi expanded by margin times its size on each side, instead of on the
+   * full frame. The window is kept while the tracked roi stays inside it, the
+   * tracker is re-seeded on a new window around the roi otherwise. With a
+   * maximum side, a roi larger than it is tracked on the coarsest level of the
+   * input pyramid it fits, see FrameContext::getInput(const std::string &, int).
+   * Either applies on the next seed, rois are mapped back to the frame.
+   *
+   * @param[in] margin Margin of the window in times of the roi size, not above
+   * 0 to track on the full frame.
+   * @param[in] max_side Largest side of a roi tracked at full resolution, in
+   * pixels, not above 0 to always track at full resolution.
+   */
+  void setCropping(double margin, int max_side);
+
+  /**
+   * @brief Set the number of particles of algorithm "PARTICLE", on the next seed.
+   *
+   * @param[in] particles Number of particles, 0 to scale with the cores.
+   */
+  void setParticles(int particles) {particle_.setParticles(particles);}
+
+  /**
+   * @brief Get the state of the tracking for a snapshot, see @ref
+   * TrackingSnapshot.
+   *
+   * @param[in] scale Working scale of the rois tracked, rois are kept in
+   * camera pixels.
+   */
+  TrackingSnapshot::Entry getSnapshot(double scale);
+
+  /**
+   * @brief Restore the state of a snapshot, the tracker is seeded at the next
+   * frame, see @ref resume().
+   *
+   * @param[in] entry State of the tracking, rois in camera pixels.
+   */
+  void restore(const TrackingSnapshot::Entry & entry);
+
+  /**
+   * @brief Check if restored and waiting for its first frame.
+   */
+  bool isRestored() const {return restored_;}
+
+  /**
+   * @brief Resume a restored tracking with the first frame after the restore.
+   *
+   * The rois are scaled to the working scale, and the history shifted to end
+   * at the frame, so the motion before the restart is extrapolated on. The
+   * tracker of a live tracking is seeded with the roi tracked, without waiting
+   * for a detection.
+   *
+   * @param[in] ctx Context of the frame.
+   * @param[in] stamp Time stamp of the frame.
+   * @param[in] scale Working scale of the frame against the camera frame.
+   */
+  void resume(FrameContext & ctx, builtin_interfaces::msg::Time stamp, double scale);
+
+  /**
+   * The default number of tracked coordinates kept in history.
+   */
+  static const size_t kHistoryCapacity;
+
 private:
+  /**
+   * @brief Release the tracker, back to the tracker pool if set.
+   */
+  void releaseTracker();
+
+  /**
+   * @brief Age the tracking by one frame, lost when reaching the maximum age.
+   */
+  void age();
+
+  /**
+   * @brief Stop updating the tracker, deleted if never confirmed.
+   */
+  void lose();
+
+  /**
+   * @brief Seed the tracker, choosing the level and window of its input.
+   */
+  void initTracker(FrameContext & ctx, const std::string & algo, const cv::Rect2d & rect);
+
+  /**
+   * @brief Create and seed the tracker of the algorithm, see @ref setAlgo().
+   */
+  void seed(FrameContext & ctx, const cv::Rect2d & rect);
+
+  /**
+   * @brief Check if the tracker learns online, see @ref setModelBudget().
+   */
+  bool isLearning() const;
+
+  /**
+   * @brief Check if the tracker exceeds its budget, see @ref setModelBudget().
+   */
+  bool isOverBudget();
+
+  /**
+   * @brief Get the input of the tracker, the window of its level of the frame.
+   */
+  cv::Mat getWindow(FrameContext & ctx, const std::string & algo);
+
+  /**
+   * @brief Map a roi of the frame to the tracker input.
+   */
+  cv::Rect2d toWindow(const cv::Rect2d & rect);
+
+  /**
+   * @brief Map a roi of the tracker input to the frame.
+   */
+  cv::Rect2d fromWindow(const cv::Rect2d & rect);
+
+  static const int32_t
+    kAgeingThreshold;   /**< The default maximum ageing of a confirmed tracking.*/
   static const int32_t
-    kAgeingThreshold;   /**< The maximum ageing of an active tracking.*/
+    kMaxMisses;         /**< The default detections missed before deleted.*/
+  static const size_t
+    kTldLearnedBytes;   /**< Estimate of the model grown by a "TLD" update.*/
+  static const uint32_t
+    kMinBudgetUpdates;  /**< Updates of a tracker before checked against its budget.*/
   cv::Ptr<cv::Tracker> tracker_; /**< Tracker associated to this tracking.*/
   cv::Rect2d tracked_rect_;      /**< Roi of the tracked object.*/
-  std::string obj_name_;         /**< Name of the tracked object.*/
+  int32_t class_id_;             /**< Interned name of the tracked object.*/
   float probability_;            /**< Probability of the tracked object.*/
   cv::Rect2d detected_rect_;     /**< Roi of the detected object. */
-  int32_t tracking_id_;          /**< ID of this tracking.*/
+  int64_t tracking_id_;          /**< ID of this tracking.*/
   int32_t ageing_;               /**< Age of this tracking.*/
   bool detected_;                /**< Detected status of this tracking.*/
   int32_t detect_mis_;           /**< Count of missed in detection.*/
+  int32_t hits_;                 /**< Count of detections.*/
+  State state_;                  /**< Stage of the lifecycle.*/
+  Lifecycle lifecycle_;          /**< Policy of the state transitions.*/
   std::string algo_;             /**< Algorithm name for the tracking.*/
-  std::vector<std::pair<builtin_interfaces::msg::Time, cv::Rect2d>>
+  std::string active_algo_;      /**< Algorithm name of the running tracker.*/
+  double rectify_threshold_;     /**< Minimum overlap to keep the tracker.*/
+  std::shared_ptr<TrackerPool> tracker_pool_; /**< Pool of trackers.*/
+  std::shared_ptr<BatchGoturn> batch_;  /**< Network of algorithm "GOTURN_BATCH".*/
+  BatchGoturn::Target batch_target_;    /**< Target of algorithm "GOTURN_BATCH".*/
+  KalmanTracker kalman_;         /**< Motion model for algorithm "KALMAN".*/
+  ParticleTracker particle_;     /**< Particle filter for algorithm "PARTICLE".*/
+  double update_cost_;           /**< Time of the latest update, in ms.*/
+  double crop_margin_;           /**< Margin of the window, 0 for the full frame.*/
+  int crop_max_side_;            /**< Largest roi side at full resolution, 0 if any.*/
+  cv::Rect window_;              /**< Window of the tracker input, empty if full frame.*/
+  int level_;                    /**< Input pyramid level of the tracker input.*/
+  size_t budget_bytes_;          /**< Model budget in bytes, 0 if any.*/
+  double budget_cost_;           /**< Mean update cost budget in ms, 0 if any.*/
+  uint32_t model_updates_;       /**< Updates of the tracker since seeded.*/
+  double mean_cost_;             /**< Recent mean update cost since seeded, in ms.*/
+  uint32_t compactions_;         /**< Re-seeds by the model budget.*/
+  cv::Point3d centroid_;         /**< 3d centroid of the latest localization.*/
+  bool has_centroid_;            /**< Localized in any detection.*/
+  bool restored_;                /**< Restored from a snapshot, not resumed yet.*/
+  std::vector<float> appearance_;  /**< Running appearance of the object.*/
+  util::StampedRingBuffer<cv::Rect2d>
   hisCor_;     /*tracked coordinates history.*/
 };
 }  // namespace tracker
@@ -0,0 +1,224 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_CAPTURE_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_CAPTURE_HPP_
+
+#include <object_msgs/msg/objects_in_boxes.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class TrackingCapture
+ * Binary log of the inputs of a @ref TrackingManager, in the order they are
+ * given, for offline replay, see @ref CaptureReader.
+ *
+ * A stream records each frame it buffers, encoded by cv::imencode(), and each
+ * call of TrackingManager::detect(), track(), extrapolate() and replenish()
+ * with the stamp of its frame. Replaying the calls reproduces the work of the
+ * manager, whatever the interleaving of the callbacks and the decisions of
+ * the stream, e.g. of its overload gate, were.
+ *
+ * Records are queued and written by a thread of the capture, frames are
+ * encoded there too, the callbacks only queue references to the messages.
+ * Frames beyond @ref kMaxPendingFrames queued are dropped and counted, see
+ * @ref getDropped(), so a slow disk delays nothing but the log.
+ *
+ * A log is a header of @ref kMagic and @ref kVersion, followed by records of
+ * a type, a payload size and a stamp, in host byte order.
+ */
+class TrackingCapture
+{
+public:
+  /** Type of a record.*/
+  enum Type : uint32_t
+  {
+    kFrame = 1,        /**< A frame buffered, encoded.*/
+    kDetect = 2,       /**< Detection of a frame, with its localization if any.*/
+    kTrack = 3,        /**< Tracking of a frame.*/
+    kExtrapolate = 4,  /**< Extrapolation to a frame.*/
+    kReplenish = 5,    /**< Replenish of the tracker pool.*/
+    kAlgo = 6,         /**< Tracker algorithm of the manager, recorded when changed.*/
+  };
+
+  static const uint32_t kMagic;    /**< Tag of a capture file.*/
+  static const uint32_t kVersion;  /**< Format of a capture file.*/
+  static const size_t kMaxPendingFrames;  /**< Frames queued before dropping.*/
+
+  /**
+   * @brief Open the log and start the writer thread.
+   *
+   * @param[in] file Path of the log, truncated.
+   * @param[in] format Extension of the image format of cv::imencode(), e.g.
+   * ".jpg" or ".png" for lossless frames.
+   * @throw std::runtime_error if the file cannot be opened.
+   */
+  explicit TrackingCapture(const std::string & file, const std::string & format = ".jpg");
+
+  /**
+   * @brief Write the records queued and close the log.
+   */
+  ~TrackingCapture();
+
+  /**
+   * @brief Record a frame.
+   *
+   * @param[in] stamp Stamp of the frame in nanoseconds.
+   * @param[in] image Frame as handed to the manager, data shared, not copied.
+   * @param[in] encoding Encoding of the frame, see FrameContext::isSupported().
+   * @param[in] scale Working scale of the manager for the frame.
+   * @param[in] owner Owner of the image data, kept till the frame is written.
+   */
+  void frame(
+    int64_t stamp, const cv::Mat & image, const std::string & encoding, double scale,
+    const std::shared_ptr<const void> & owner);
+
+  /**
+   * @brief Record a detection.
+   *
+   * @param[in] stamp Stamp of the frame detected in nanoseconds.
+   * @param[in] objs Objects detected.
+   * @param[in] loc Localization of the objects, may be empty.
+   */
+  void detect(
+    int64_t stamp, const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+    const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc);
+
+  /**
+   * @brief Record a tracking frame.
+   *
+   * @param[in] stamp Stamp of the frame in nanoseconds.
+   */
+  void track(int64_t stamp) {push(Pending(kTrack, stamp));}
+
+  /**
+   * @brief Record a frame extrapolated to.
+   *
+   * @param[in] stamp Stamp of the frame in nanoseconds.
+   */
+  void extrapolate(int64_t stamp) {push(Pending(kExtrapolate, stamp));}
+
+  /**
+   * @brief Record a replenish of the tracker pool.
+   */
+  void replenish() {push(Pending(kReplenish, 0));}
+
+  /**
+   * @brief Record the tracker algorithm, only when changed.
+   *
+   * @param[in] algo Algorithm of the manager, see TrackingManager::getAlgo().
+   */
+  void algo(const std::string & algo);
+
+  /**
+   * @brief Get the number of frames dropped, the writer falling behind.
+   */
+  uint64_t getDropped() const {return dropped_;}
+
+  /**
+   * @brief Get the number of records written.
+   */
+  uint64_t getWritten() const {return written_;}
+
+private:
+  /** A record waiting for the writer.*/
+  struct Pending
+  {
+    Pending(Type t, int64_t s)
+    : type(t), stamp(s) {}
+
+    Type type;
+    int64_t stamp;
+    cv::Mat image;
+    std::string text;  /**< Encoding of a frame, or algorithm.*/
+    double scale = 1.0;
+    std::shared_ptr<const void> owner;
+    object_msgs::msg::ObjectsInBoxes::ConstSharedPtr objs;
+    object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr loc;
+  };
+
+  void push(Pending && pending);
+  void run();
+  void write(const Pending & pending);
+
+  std::ofstream out_;
+  std::string format_;
+  std::string algo_;   /**< Algorithm last recorded.*/
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Pending> queue_;
+  size_t queued_frames_ = 0;
+  bool stop_ = false;
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> written_{0};
+  std::vector<uint8_t> payload_;   /**< Payload scratch of the writer.*/
+  std::vector<uint8_t> encoded_;   /**< Encoded frame scratch of the writer.*/
+  std::thread writer_;
+};
+
+/** @class CaptureReader
+ * Reader of the records of a @ref TrackingCapture log, in order.
+ */
+class CaptureReader
+{
+public:
+  /** A record read.*/
+  struct Record
+  {
+    TrackingCapture::Type type;
+    int64_t stamp;
+    cv::Mat image;         /**< Decoded frame of kFrame.*/
+    std::string encoding;  /**< Encoding of the frame of kFrame.*/
+    double scale;          /**< Working scale of kFrame.*/
+    object_msgs::msg::ObjectsInBoxes::SharedPtr objs;  /**< Objects of kDetect.*/
+    object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr loc;  /**< Of kDetect, or empty.*/
+    std::string algo;      /**< Algorithm of kAlgo.*/
+  };
+
+  /**
+   * @brief Open a log.
+   *
+   * @param[in] file Path of the log written by TrackingCapture.
+   * @throw std::runtime_error if the file cannot be opened or is no capture.
+   */
+  explicit CaptureReader(const std::string & file);
+
+  /**
+   * @brief Read the next record.
+   *
+   * @param[out] record The record, its image is decoded.
+   * @return false at the end of the log, or at a truncated record.
+   */
+  bool next(Record & record);
+
+private:
+  std::ifstream in_;
+  std::vector<uint8_t> payload_;
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_CAPTURE_HPP_
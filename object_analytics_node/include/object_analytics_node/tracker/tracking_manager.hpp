@@ -18,11 +18,23 @@
 #include <object_msgs/msg/objects_in_boxes.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <sensor_msgs/msg/image.hpp>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
+#include "object_analytics_msgs/msg/objects_in_boxes3_d.hpp"
 #include "object_analytics_msgs/msg/tracked_objects.hpp"
+#include "object_analytics_node/tracker/algo_scheduler.hpp"
+#include "object_analytics_node/tracker/batch_goturn.hpp"
+#include "object_analytics_node/tracker/frame_context.hpp"
+#include "object_analytics_node/tracker/reid_index.hpp"
+#include "object_analytics_node/tracker/spatial_grid.hpp"
+#include "object_analytics_node/tracker/tracker_pool.hpp"
 #include "object_analytics_node/tracker/tracking.hpp"
+#include "object_analytics_node/tracker/tracking_snapshot.hpp"
+#include "object_analytics_node/tracker/tracking_state.hpp"
+#include "object_analytics_node/util/detection_filter.hpp"
+#include "object_analytics_node/util/thread_pool.hpp"
 
 namespace object_analytics_node
 {
@@ -36,49 +48,88 @@ namespace tracker
  * when it is initially detected, see @ref detect(). Then in the successive
  * frames, every tracking is updated independently, see @ref track().
  *
- * For an object detected, TrackingManager search the existing list if it is
- * tracked already. A detected object has its own object name (e.g. person, dog,
+ * The objects detected in a frame are associated with the existing trackings
+ * as a whole. A detected object has its own object name (e.g. person, dog,
  * etc.) and a roi (region of interest, also known as bounding box). The roi's
  * matching level is measured by its overlapping rate and its centor deviation,
  * see @ref model::ObjectUtils::getMatch(). A @ref kMatchThreshold is used as
- * the minimum matching level of roi. By matching the object name and the roi,
- * see
- * @ref getTracking(), TrackingManager find an existing tracking for this
- * object. Or a new tracking should be added, see @ref addTracking().
+ * the minimum matching level of roi. Pairs of the same object name are scored,
+ * and the assignment maximizing the total matching level of the frame is
+ * solved by @ref Association::solve(), see @ref associate(), so a tracking
+ * is never taken by a detection matching it worse than another one would.
+ * A new tracking is added for each object left unassigned, see @ref
+ * addTracking().
  *
  * TrackingManager maintains a @ref tracking_cnt. When adding a new tracking,
  * the value of tracking_cnt will be assigned to that tracking, as a unique ID
- * across frames. Then the tracking_cnt automatically increased by one.
+ * across frames. Then the tracking_cnt automatically increased by one. The
+ * counter is 64 bits wide, shared by all managers of a process and updated
+ * atomically, so IDs stay unique across camera streams and never wrap.
  *
- * TrackingManager also maintains a @ref kProbabilityThreshold, only when
- * detected with a confidence level not less than this threshold will the object
+ * TrackingManager also maintains a @ref util::DetectionFilter, only the
+ * objects detected with a confidence level not less than @ref
+ * kProbabilityThreshold by default, and of the classes and sizes accepted, will
  * be added to the tracking list. This is necessary to mask any unexpected or
  * unstable detection results.
  *
- * Paralleling computation is enabled in TrackingManager, supported by openmp
- * from compilers.
- * @ref kNumOfThread specifies the number of threads used for paralleling
- * computation. Usually this should be less than the maximum number of threads
- * supported by the platform.
+ * Paralleling computation is enabled in TrackingManager. Trackers of a frame
+ * are updated concurrently on a persistent @ref util::ThreadPool, the number
+ * of worker threads is given at construction, @ref kNumOfThread by default.
+ * Usually this should be less than the maximum number of threads supported by
+ * the platform. Results are always reported in the order of the tracking list,
+ * regardless of the order in which the workers finished.
+ *
+ * With a frame time budget set, see @ref setTrackingBudget(), the algorithm
+ * of each tracking is chosen by an @ref AlgoScheduler on every detection, and
+ * the update cost of every tracker feeds the scheduler back.
+ *
+ * Given the localization of a detection frame, each tracking keeps the 3d
+ * centroid of the object it was last associated with, and with a depth gate
+ * set, see @ref setDepthGate(), pairs of centroids farther apart are never
+ * scored, so objects crossing in the image but apart in depth keep their
+ * trackings.
+ *
+ * With an occlusion threshold set, see @ref setOcclusionThreshold(), the
+ * tracker of an object hidden behind another one is frozen, its roi coasted
+ * on its motion instead, see @ref findOccluded(), so it neither drifts onto
+ * the occluder nor costs an update.
+ *
+ * The trackings may be saved, see @ref snapshot(), and restored by the manager
+ * of a restarted node, see @ref restore(), keeping their IDs. Their trackers
+ * are seeded from the first frame after the restore, without waiting for a
+ * detection.
+ *
+ * With re-identification set, see @ref setReid(), the appearance of each
+ * confirmed tracking is kept when it is removed, in a @ref ReidIndex, and a
+ * detection of the same class and a similar appearance left unassigned later
+ * takes back its ID instead of a new one.
  */
 class TrackingManager
 {
 public:
+  // The default minimum confidence level of detected object
+  static const float kProbabilityThreshold;
+
   /**
    * @brief Constructor, a TrackingManager shall be created for one stream.
+   *
+   * @param[in] node Node used for logging.
+   * @param[in] num_threads Number of worker threads updating trackers.
    */
-  explicit TrackingManager(const rclcpp::Node * node);
+  explicit TrackingManager(
+    const rclcpp::Node * node,
+    int32_t num_threads = kNumOfThread);
 
   /**
    * @brief Manage trackings when objects detected from a new frame.
    *
-   * For each object detected, TrackingManager will search the list if this
-   * object has been tracked already. This is done by @ref getTracking(). If
-   * tracking does not exist for this object, a new tracking will be added.
+   * The objects detected are assigned to the trackings of the list all at
+   * once, by the assignment maximizing the total matching level, see @ref
+   * associate(). A new tracking is added for each object left unassigned.
    *
-   * Only when detected with a confidence level not less than @ref
-   * kProbabilityThreshold will the object be marked as "Detected" in this
-   * function, see @ref Tracking::setDetected().
+   * Only when accepted by the filter, see @ref setFilter(), will the object
+   * be marked as "Detected" in this function, see @ref
+   * Tracking::setDetected(). Rejected objects are skipped before any copy.
    *
    * For all "Detected" objects, their trackers will be rectified with the
    * detection rois, see @ref Tracking::rectifyTracker().
@@ -93,22 +144,83 @@ public:
     const cv::Mat & mat,
     const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs);
 
+  /**
+   * @brief Manage trackings when objects detected from a new frame.
+   *
+   * Same as above, with the frame preprocessed in a context cached by the
+   * caller, see @ref FrameContext.
+   *
+   * Objects of the localization of the same frame are taken for the detected
+   * objects of the same roi and name, see @ref setDepthGate().
+   *
+   * @param[in] ctx Context of the new frame.
+   * @param[in] objs Objects detected from this frame.
+   * @param[in] loc Localization of objs by the segmenter, may be empty.
+   */
+  void detect(
+    FrameContext & ctx,
+    const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+    const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc = nullptr);
+
   /**
    * @brief Manage trackings when a new frame arrives.
    *
    * When a new frame arrives, for all existing trackings, TrackingManager will
-   * update their trackers, each calculating a new roi.
+   * update their trackers, each calculating a new roi. Trackers are updated in
+   * parallel on the worker pool, sharing one preprocessed @ref FrameContext.
+   * Lost trackings are extrapolated instead, without looking at the frame, and
+   * deleted ones are left alone until removed, see @ref Tracking::State.
+   * Occluded trackings are extrapolated as well, see @ref findOccluded().
    *
    * @param[in] mat A new frame.
    * @param[in] stamp Time stamp for this track.
    */
   void track(const cv::Mat & mat, builtin_interfaces::msg::Time stamp);
 
+  /**
+   * @brief Manage trackings when a new frame arrives.
+   *
+   * Same as above, with the frame preprocessed in a context cached by the
+   * caller, see @ref FrameContext.
+   *
+   * @param[in] ctx Context of the new frame.
+   * @param[in] stamp Time stamp for this track.
+   */
+  void track(FrameContext & ctx, builtin_interfaces::msg::Time stamp);
+
+  /**
+   * @brief Manage trackings when a new frame is not tracked under overload.
+   *
+   * Rois of all trackings are extrapolated to the frame from their history,
+   * see @ref Tracking::extrapolate(), no tracker is updated.
+   *
+   * @param[in] stamp Time stamp of the frame.
+   */
+  void extrapolate(builtin_interfaces::msg::Time stamp);
+
+  /**
+   * @brief Save the state of the trackings, see @ref TrackingSnapshot.
+   *
+   * @param[out] entries State of each tracking not deleted.
+   */
+  void snapshot(std::vector<TrackingSnapshot::Entry> & entries);
+
+  /**
+   * @brief Restore trackings saved by @ref snapshot(), with their IDs.
+   *
+   * The trackings are added to the list as restored, see
+   * Tracking::restore(), and resumed by the next frame tracked or detected,
+   * which only seeds their trackers. IDs given later follow the IDs restored.
+   *
+   * @param[in] entries State of the trackings.
+   * @return Number of trackings restored.
+   */
+  size_t restore(const std::vector<TrackingSnapshot::Entry> & entries);
+
   /**
    * @brief Get Tracked objects list.
    *
-   * Only objects marked as "Detected" in the latest @ref detect() shall be
-   * returned.
+   * Only confirmed trackings shall be returned, see @ref Tracking::State.
    *
    * @param[out] objs List of tracked objects.
    * @return Count of tracked objects.
@@ -116,6 +228,18 @@ public:
   int32_t getTrackedObjs(
     const object_analytics_msgs::msg::TrackedObjects::SharedPtr & objs);
 
+  /**
+   * @brief Append tracked objects to a message, reserving for all trackings.
+   *
+   * @param[in,out] objs Message of tracked objects, its storage is reused.
+   * @param[in,out] velocities If given, velocities of the rois appended in
+   * the same order, in camera pixels per second, see Tracking::getVelocity().
+   * @return Count of tracked objects in the message.
+   */
+  int32_t getTrackedObjs(
+    object_analytics_msgs::msg::TrackedObjects & objs,
+    std::vector<cv::Point2d> * velocities = nullptr);
+
   /**
    * @brief Get algorithm name used by trackers.
    */
@@ -126,20 +250,334 @@ public:
    */
   void setAlgo(std::string algo) {algo_ = algo;}
 
+  /**
+   * @brief Set the maximum 3d distance of a detection to a tracking it may be
+   * associated with.
+   *
+   * Only pairs both localized are gated, see @ref detect(), others are scored
+   * on their rois alone.
+   *
+   * @param[in] meters Distance between the centroids, 0 to disable.
+   */
+  void setDepthGate(double meters) {depth_gate_ = meters > 0 ? meters : 0;}
+
+  /**
+   * @brief Get the count of detection-tracking pairs not scored for the depth
+   * gate, see @ref setDepthGate().
+   */
+  uint64_t getDepthGated() {return depth_gated_;}
+
+  /**
+   * @brief Set the overlap beyond which the farther of two trackings is
+   * frozen, see @ref findOccluded().
+   *
+   * @param[in] overlap Fraction of the smaller roi covered by the other one,
+   * not above 0 to update every tracker.
+   */
+  void setOcclusionThreshold(double overlap) {occlusion_ = overlap > 0 ? overlap : 0;}
+
+  /**
+   * @brief Get the count of tracker updates skipped for occlusion.
+   */
+  uint64_t getOccluded() {return occluded_;}
+
+  /**
+   * @brief Set the re-identification of the trackings lost, see @ref
+   * ReidIndex.
+   *
+   * @param[in] capacity Most trackings lost kept, 0 to disable.
+   * @param[in] max_age Seconds a tracking lost is kept, 0 if till evicted.
+   * @param[in] min_similarity Least cosine similarity of the appearances.
+   */
+  void setReid(size_t capacity, double max_age, double min_similarity);
+
+  /**
+   * @brief Get the count of detections given back the ID of a tracking lost.
+   */
+  uint64_t getReidentified() {return reidentified_;}
+
+  /**
+   * @brief Set the history capacity of trackings added afterwards, see @ref
+   * Tracking::setHistoryCapacity().
+   */
+  void setHistoryCapacity(size_t capacity) {history_capacity_ = capacity;}
+
+  /**
+   * @brief Set the warm rectify threshold of trackings added afterwards, see
+   * @ref Tracking::setRectifyThreshold().
+   */
+  void setRectifyThreshold(double threshold) {rectify_threshold_ = threshold;}
+
+  /**
+   * @brief Set the cropping of trackings added afterwards, see @ref
+   * Tracking::setCropping().
+   */
+  void setCropping(double margin, int max_side)
+  {
+    crop_margin_ = margin;
+    crop_max_side_ = max_side;
+  }
+
+  /**
+   * @brief Set the particles of trackings added afterwards, see @ref
+   * Tracking::setParticles().
+   */
+  void setParticles(int particles) {particles_ = particles;}
+
+  /**
+   * @brief Load the network of algorithm "GOTURN_BATCH", see BatchGoturn.
+   *
+   * Trackings of "GOTURN_BATCH" are updated by one forward per frame in
+   * @ref track(). Without the network, they are seeded as "GOTURN".
+   *
+   * @param[in] prototxt Path of the network definition.
+   * @param[in] weights Path of the weights.
+   * @param[in] device Device running the network, see BatchGoturn::parseDevice().
+   * @return false if the network is not loaded.
+   */
+  bool setBatchModel(
+    const std::string & prototxt, const std::string & weights,
+    const std::string & device);
+
+  /**
+   * @brief Get the network of algorithm "GOTURN_BATCH".
+   */
+  const BatchGoturn & getBatchGoturn() const {return *batch_goturn_;}
+
+  /**
+   * @brief Set the filter of the detected objects tracked.
+   *
+   * @param[in] filter Filter of the detections, accepting by default those
+   * not less than @ref kProbabilityThreshold.
+   */
+  void setFilter(const util::DetectionFilter & filter) {filter_ = filter;}
+
+  /**
+   * @brief Set the scale of the frames tracked against the camera frames.
+   *
+   * Detected rois are scaled by it in @ref detect(), and tracked rois back in
+   * @ref getTrackedObjs(), so that trackings run on downscaled frames while
+   * the messages stay in camera coordinates.
+   *
+   * When the scale changes, e.g. the working width lowered under load, the
+   * trackings are kept with their IDs and history, and reseeded at the new
+   * scale on the next frame, as if restored, see @ref restore().
+   *
+   * @param[in] scale Width of the tracked frames over the camera width, 1 at
+   * full resolution.
+   */
+  void setWorkingScale(double scale);
+
+  /**
+   * @brief Set the cap of the trackings.
+   *
+   * Beyond the cap, only the most probable detections of a frame are tracked,
+   * and the least probable trackings not detected are removed when cleaning
+   * up, both counted by @ref getCapped().
+   *
+   * @param[in] max Most trackings, 0 if unlimited.
+   */
+  void setMaxTrackings(size_t max) {max_trackings_ = max;}
+
+  /**
+   * @brief Get the count of detections and trackings dropped for @ref
+   * setMaxTrackings().
+   */
+  uint64_t getCapped() {return capped_;}
+
+  /**
+   * @brief Set the lifecycle policy of trackings added afterwards, see @ref
+   * Tracking::setLifecycle().
+   */
+  void setLifecycle(const Tracking::Lifecycle & lifecycle) {lifecycle_ = lifecycle;}
+
+  /**
+   * @brief Set the number of trackers kept ready per algorithm, and create
+   * them for the algorithm in use, see @ref TrackerPool.
+   */
+  void setTrackerPoolSize(size_t size);
+
+  /**
+   * @brief Run the trackers of the algorithms in use on a synthetic frame.
+   *
+   * One throwaway tracking per worker thread is seeded and updated twice for
+   * the algorithm given by @ref setAlgo(), and for the scheduled ones with a
+   * budget set, so models are loaded and first-touch allocations are done
+   * before the first real frame. The steady update cost feeds the scheduler,
+   * and the tracker pool is refilled afterwards. No tracking ID is taken.
+   *
+   * @param[in] size Size of the synthetic frame, that of the tracked frames.
+   */
+  void warmup(const cv::Size & size);
+
+  /**
+   * @brief Pin the worker threads updating trackers, failures are logged.
+   *
+   * The thread calling the manager keeps its own policy, that of the
+   * executor, see util::ThreadPool::setPolicy().
+   *
+   * @param[in] policy Affinity and priority of the workers.
+   * @return false if the policy was not applied to every worker.
+   */
+  bool setThreadPolicy(const util::ThreadPolicy & policy);
+
+  /**
+   * @brief Describe the policy the worker threads run with.
+   */
+  std::string getThreadPolicy() {return pool_->getPolicy();}
+
+  /**
+   * @brief Get the number of threads updating trackers, the calling one
+   * included.
+   */
+  size_t getNumOfThread() const {return pool_->getNumOfThread() + 1;}
+
+  /**
+   * @brief Refill the tracker pool, shall be called out of the frame path.
+   */
+  void replenish();
+
+  /**
+   * @brief Get the hit rate of the tracker pool, see @ref TrackerPool.
+   */
+  double getTrackerPoolHitRate() {return tracker_pool_->getHitRate();}
+
+  /**
+   * @brief Get the number of idle trackers in the tracker pool.
+   */
+  size_t getTrackerPoolIdle() {return tracker_pool_->getIdle();}
+
+  /**
+   * @brief Get the number of trackings in the list.
+   */
+  size_t getTrackingCount() {return trackings_.size();}
+
+  /**
+   * @brief Get an estimate of the bytes held by all trackings, see @ref
+   * Tracking::getModelBytes().
+   */
+  size_t getModelBytes();
+
+  /**
+   * @brief Set the hard limit of @ref getModelBytes().
+   *
+   * When cleaning up after a detection frame, trackings the longest undetected
+   * are removed till the estimate is within the limit.
+   *
+   * @param[in] bytes Limit in bytes, 0 if unlimited.
+   */
+  void setModelLimit(size_t bytes) {model_limit_ = bytes;}
+
+  /**
+   * @brief Get the count of trackings removed for @ref setModelLimit().
+   */
+  uint64_t getModelEvicted() {return model_evicted_;}
+
+  /**
+   * @brief Set the budget of the model of each tracker, see
+   * Tracking::setModelBudget().
+   *
+   * @param[in] bytes Budget in bytes of each tracking, 0 if any.
+   * @param[in] update_ms Budget of the mean update cost in ms, 0 if any.
+   */
+  void setModelBudget(size_t bytes, double update_ms)
+  {
+    budget_bytes_ = bytes;
+    budget_ms_ = update_ms;
+  }
+
+  /**
+   * @brief Get the count of trackers re-seeded for @ref setModelBudget().
+   */
+  uint64_t getModelCompacted();
+
+  /**
+   * @brief Set the time budget of tracking a frame, see @ref AlgoScheduler.
+   *
+   * @param[in] budget_ms Budget in milliseconds, not above zero to disable
+   * scheduling and keep the algorithm given by @ref setAlgo().
+   */
+  void setTrackingBudget(double budget_ms);
+
+  /**
+   * @brief Set the algorithms the scheduler chooses from, see @ref
+   * AlgoScheduler::setAlgos().
+   */
+  void setScheduledAlgos(
+    const std::string & large, const std::string & small,
+    const std::string & fallback)
+  {
+    scheduler_.setAlgos(large, small, fallback);
+  }
+
 private:
   // The minimum matching level of roi
   static const float kMatchThreshold;
-  // The minimum confidence level of detected object
-  static const float kProbabilityThreshold;
-  // Count of trackings, as a unique ID of a same object
-  static int32_t tracking_cnt;
-  // Number of threads used for paralleling computation
+  // Count of trackings, as a unique ID of a same object across all managers
+  static std::atomic<int64_t> tracking_cnt;
+  // Default number of threads used for paralleling computation
   static const int32_t kNumOfThread;
   const rclcpp::Node * node_;
+  // Persistent workers updating trackers
+  std::unique_ptr<util::ThreadPool> pool_;
+  // Spatial index over candidate trackings, rebuilt per detection frame
+  SpatialGrid grid_;
   // List of trackings, each for one detected object
   std::vector<std::shared_ptr<Tracking>> trackings_;
+  // Arrays mirroring the list, refreshed per detection frame
+  TrackingState state_;
   // Algorithm name to create tracker
   std::string algo_;
+  // History capacity of each tracking
+  size_t history_capacity_;
+  // Minimum overlap to keep a tracker when rectifying
+  double rectify_threshold_;
+  // Margin of the window tracked around each roi, 0 for the full frame
+  double crop_margin_;
+  // Largest roi side tracked at full resolution, 0 if any
+  int crop_max_side_;
+  // Particles of algorithm "PARTICLE", 0 to scale with the cores
+  int particles_;
+  // Lifecycle policy of each tracking
+  Tracking::Lifecycle lifecycle_;
+  // Filter of the detected objects tracked
+  util::DetectionFilter filter_;
+  // Scale of the tracked frames against the camera frames
+  double scale_;
+  // Trackers shared by all trackings
+  std::shared_ptr<TrackerPool> tracker_pool_;
+  // Network shared by the trackings of "GOTURN_BATCH"
+  std::shared_ptr<BatchGoturn> batch_goturn_;
+  // Limit of the bytes held by trackings, 0 if unlimited
+  size_t model_limit_;
+  // Count of trackings removed for the limit
+  uint64_t model_evicted_;
+  // Model budget of each tracking in bytes, 0 if any
+  size_t budget_bytes_;
+  // Mean update cost budget of each tracking in ms, 0 if any
+  double budget_ms_;
+  // Re-seeds by the model budget of the trackings removed
+  uint64_t model_compacted_;
+  // Per-tracking algorithm choice against the frame budget
+  AlgoScheduler scheduler_;
+  // Maximum distance of the centroids of an associated pair, 0 if ungated
+  double depth_gate_;
+  // Count of pairs not scored for the depth gate
+  uint64_t depth_gated_;
+  // Overlap of the smaller roi freezing the farther tracking, 0 if off
+  double occlusion_;
+  // Count of tracker updates skipped for occlusion
+  uint64_t occluded_;
+  // Appearances of the trackings lost, nullptr if re-identification is off
+  std::unique_ptr<ReidIndex> reid_;
+  // Count of detections re-identified
+  uint64_t reidentified_;
+  // Trackings restored and not resumed yet
+  bool restored_;
+  // Cap of the trackings, 0 if unlimited
+  size_t max_trackings_;
+  // Count of detections and trackings dropped for the cap
+  uint64_t capped_;
 
   /**
    * @brief Add a new tracking to the list.
@@ -151,51 +589,112 @@ private:
    * @param[in] obj_name Name of the object (e.g. people, dog, etc.).
    * @param[in] probability the object.
    * @param[in] rect Roi of the tracked object.
+   * @param[in] id ID of the tracking, negative for the next of tracking_cnt.
    * @return Pointer to the tracking added.
    */
   std::shared_ptr<Tracking> addTracking(
     const std::string & obj_name,
     const float & probability,
-    const cv::Rect2d & rect);
+    const cv::Rect2d & rect,
+    int64_t id = -1);
+
+  /**
+   * @brief Resume the trackings restored with a frame, see
+   * Tracking::resume().
+   *
+   * @param[in] ctx Context of the frame.
+   * @param[in] stamp Time stamp of the frame.
+   * @return false if no tracking was restored.
+   */
+  bool resume(FrameContext & ctx, builtin_interfaces::msg::Time stamp);
+
+  /**
+   * @brief Find the trackings occluded by another one in the latest frame.
+   *
+   * Live trackings are indexed by @ref grid_, and each pair sharing a cell is
+   * taken as an occlusion when the intersection covers at least the occlusion
+   * threshold of the smaller roi. The farther of the pair is occluded: the one
+   * of the farther 3d centroid when both are localized, otherwise the one of
+   * the higher bottom edge, for objects standing on the ground plane seen by
+   * the camera. Frozen trackers keep their model of the object before the
+   * occlusion, and resume once the overlap clears.
+   *
+   * @param[out] occluded For each tracking, true if to be frozen.
+   */
+  void findOccluded(std::vector<char> & occluded);
 
   /**
    * @brief Clean up inactive tracking in the list.
    *
-   * See @ref Tracking::isActive() for inactive trackings.
+   * The misses of the detection frame are applied first, see @ref
+   * Tracking::updateState(), and deleted trackings are removed by swapping
+   * with the last of the list, so the order of the list is not kept. Deleted
+   * trackings once confirmed are kept for re-identification, see @ref
+   * setReid(). Then trackings are evicted if over the limit, see @ref
+   * setModelLimit().
+   *
+   * @param[in] stamp Time stamp of the detection frame.
    */
-  void cleanTrackings();
+  void cleanTrackings(builtin_interfaces::msg::Time stamp);
 
   /**
-   * @brief Get the most matching tracking from the list.
+   * @brief Associate detected objects with trackings of the list.
    *
-   * For a detected object, this function returns the most matching tracking,
-   * with the same object name, and the most matching roi measured by @ref
-   * model::ObjectUtils::getMatch(), not less than @ref kMatchThreshold.
+   * The list is mirrored into @ref state_ first. Trackings with history
+   * reaching the detection stamp are candidates, and are indexed by a @ref
+   * SpatialGrid. Every detection-candidate pair of the same class ID sharing a
+   * grid cell and within the depth gate is scored by @ref
+   * model::ObjectUtils::getMatch(), and the assignment maximizing the total
+   * score over the frame is solved by @ref Association::solve(). Pairs not
+   * above @ref kMatchThreshold are never associated. A new tracking is added
+   * for each detection left unassigned, in the order of detections, with the
+   * ID of a tracking lost of a similar appearance if any, see @ref setReid().
+   * The centroid of each detection localized is kept by its tracking.
    *
-   * @param[in] obj_name Name of the object (e.g. people, dog, etc.).
-   * @param[in] roi Bounding box of the object.
-   * @return Pointer to the tracking matched. An empty pointer if none tracking
-   * matched.
+   * @param[in] ctx Context of the detection frame.
+   * @param[in] dobjs Detected objects.
+   * @param[in] rects Bounding boxes of the detected objects.
+   * @param[in] centroids 3d centroids of the detected objects, nullptr if not
+   * localized.
+   * @param[in] stamp Time stamp of the detection frame.
+   * @return Tracking associated with each detected object, an empty pointer if
+   * none tracking associated.
    */
-  std::shared_ptr<Tracking> getTracking(
-    const std::string & obj_name,
-    const cv::Rect2d & roi,
-    float probability,
+  std::vector<std::shared_ptr<Tracking>> associate(
+    FrameContext & ctx,
+    const std::vector<const object_msgs::msg::Object *> & dobjs,
+    const std::vector<cv::Rect2d> & rects,
+    const std::vector<const cv::Point3d *> & centroids,
     builtin_interfaces::msg::Time stamp);
 
   /**
-   * @brief Validate the ROI against the size of an image array.
+   * @brief Preprocess a frame for the algorithms of all trackings.
+   *
+   * @param[in] ctx Context of the frame, see @ref FrameContext.
+   */
+  void prepareContext(FrameContext & ctx);
+
+  /**
+   * @brief Choose the algorithm of every tracking, when a budget is set.
+   *
+   * Takes effect at the next re-seed of each tracker, see @ref
+   * Tracking::setAlgo().
+   */
+  void scheduleAlgos();
+
+  /**
+   * @brief Validate the ROI against the size of an image.
    *
    * In Debug build, ROS_ASSERT failure will be raised in case unexpected ROI
    * detected. In Release build, false shall be returned in case unexpected ROI
    * detected.
    *
-   * @param[in] mat Input image arrary
+   * @param[in] size Size of the input image
    * @param[in] droi ROI
    * @return true if ROI valid, otherwise false.
    */
   bool validateROI(
-    const cv::Mat & mat,
+    const cv::Size & size,
     const sensor_msgs::msg::RegionOfInterest & droi);
 };
 }  // namespace tracker
@@ -15,18 +15,14 @@
 #ifndef OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_NODE_HPP_
 #define OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_NODE_HPP_
 
-#include <message_filters/subscriber.h>
-#include <message_filters/time_synchronizer.h>
-#include <object_analytics_msgs/msg/tracked_objects.hpp>
-#include <object_msgs/msg/objects_in_boxes.hpp>
 #include <rclcpp/rclcpp.hpp>
-#include <sensor_msgs/msg/image.hpp>
 #include <vector>
 #include <string>
 #include <memory>
 
-#include "object_analytics_node/tracker/tracking.hpp"
-#include "object_analytics_node/tracker/tracking_manager.hpp"
+#include "object_analytics_node/tracker/tracking_stream.hpp"
+#include "object_analytics_node/util/quality_listener.hpp"
+#include "object_analytics_node/util/stats_publisher.hpp"
 #include "object_analytics_node/visibility_control.h"
 
 namespace object_analytics_node
@@ -37,37 +33,169 @@ namespace tracker
  * ROS Node of multiple trackings, each against one object detected across
  * camera frames.
  *
+ * The node hosts one @ref TrackingStream per camera, each with its own
+ * topics and @ref TrackingManager, see parameter "streams". By default one
+ * unnamed stream is hosted:
+ *
  * - Subscribe topics
  *   - /object_analytics/rgb. This class listen to "sensor_msgs::Image"
- * published by an RGBD camera, see @ref rgb_cb().
- *   - /object_analytics/detection. This class also listen to
- * "object_msgs::ObjectsInBoxes" published by object detection node, see @ref
- * obj_cb().
+ * published by an RGBD camera.
+ *   - /object_analytics/detected_objects. This class also listen to
+ * "object_msgs::ObjectsInBoxes" published by object detection node.
  * - Publish topic
  *   - /object_analytics/tracking. This class publish
- * "object_analytics_msgs::TrackedObjects", see @ref tracking_publish().
- *
- * The tracking workflow is initiated by a detection frame. Roi of each detected
- * object will be used to initialize a tracker for that object. Then the tracker
- * will be kept updated with each successive frames arrived, we calling them
- * tracking frames, till next detection frame arrives. So the rhythm of the
- * workflow is to repeat this sequence:
- *
- * [detection, tracking, tracking, tracking, ..., tracking]
+ * "object_analytics_msgs::TrackedObjects".
  *
- * It pending on the frequency of detection, several tracking frames are
- * processed in between. The faster the tracker algorithm or the less objects to
- * track, the more tracking frames being processed before the next detection
- * frame arrives.
+ * Tracking IDs are unique across the streams of a process.
  *
- * TrackingNode simply buffers the RGB image in @ref rgb_cb(), and waiting for
- * the arrival of the detection frame. Then in @ref obj_cb(), TrackingNode noted
- * down this object frame and last object frame. The "last" object frame is used
- * to initiate trackings, then TrackingNode will process all successive frames
- * before "this" object frame.
- *
- * TrackingNode has a @ref TrackingManager to process tracking updates from both
- * detection frames and tracking frames.
+ * - Parameters
+ *   - tracking_threads. Number of threads updating trackers in parallel,
+ * default 4. They are shared out among the streams, each stream having at
+ * least the executor thread calling its manager, see getStreamThreads().
+ *   - tracking_cores and tracking_priority. Cores the threads updating
+ * trackers are pinned to, and their SCHED_FIFO priority, see
+ * util::ThreadPolicy, default empty and 0 for the policy of the process. The
+ * executor threads are pinned by the process, see object_analytics_node.
+ *   - tracking_history. Number of frames of tracked rois kept by a tracking,
+ * default 30, at least 1. It shall cover the latency of detection.
+ *   - rectify_threshold. Minimum overlap rate between detected and tracked rois
+ * to keep a tracker alive when rectifying, default 0 to always re-seed.
+ *   - tracker_pool_size. Number of trackers created ahead per algorithm, so
+ * that rectify does not create trackers in the frame path, default 8.
+ *   - tracking_budget_ms. Time budget of tracking a frame in milliseconds, the
+ * tracker algorithm of each object is degraded to fit in, default 0 to always
+ * use the configured algorithm.
+ *   - crop_margin. Track each object on a window of the frame, its roi expanded
+ * by this many times its size on each side, instead of on the full frame, see
+ * Tracking::setCropping(), default 0 for the full frame.
+ *   - crop_max_side. Track objects larger than this many pixels on a coarser
+ * level of the input pyramid shared by the trackings of a frame, default 0 to
+ * always track at full resolution.
+ *   - working_width. Width in pixels wider rgb frames are downscaled to once
+ * before tracking, e.g. 640 for a 1280x720 camera, rois are published in
+ * camera coordinates still, default 0 to track at the camera resolution.
+ *   - particles. Number of particles of each tracking with algorithm
+ * "PARTICLE", default 0 for ParticleTracker::kParticlesPerCore per core.
+ *   - goturn_batch_model. Path of the GOTURN network without extension, e.g.
+ * "/opt/goturn" for goturn.prototxt and goturn.caffemodel of cv::TrackerGOTURN,
+ * run once per frame for all objects of algorithm "GOTURN_BATCH", see @ref
+ * BatchGoturn, default empty for "GOTURN_BATCH" to track as "GOTURN".
+ *   - goturn_batch_device. Device running the network of "GOTURN_BATCH", one of
+ * "CPU", "GPU", "GPU_FP16" and "MYRIAD" of the OpenVINO inference engine, or
+ * "OPENCV", default "CPU".
+ *   - min_probability. Minimum confidence of the detected objects tracked,
+ * default 0.8, see util::DetectionFilter.
+ *   - min_roi_area. Minimum roi area in pixels of the detected objects
+ * tracked, default 0.
+ *   - object_classes. Names of the object classes tracked, default empty to
+ * track any class.
+ *   - confirm_hits. Detections of an object before its tracking is published,
+ * default 1, see Tracking::Lifecycle.
+ *   - max_age. Tracking frames without detection before a tracking is lost and
+ * its tracker stops being updated, default 60, 0 for never.
+ *   - max_misses. Detection frames missed in a row before a tracking is
+ * deleted, default 30, 0 for never. The defaults are the former thresholds,
+ * but each now applies on its own: a tracking used to be kept, and updated,
+ * till both were reached, it is now lost at max_age and deleted at
+ * max_misses, whichever comes first.
+ *   - overload_policy. How tracking frames later than latency_target_ms are
+ * processed, one of "none", "latest", "every_k" and "interpolate", see @ref
+ * OverloadGate, default "none".
+ *   - latency_target_ms. Maximum age of a tracking frame taken from the queue
+ * before it is late, default 100. Stamps are compared against the node clock,
+ * so use_sim_time shall be set when playing recorded data.
+ *   - overload_interval. Track one of every this many late frames with policy
+ * "every_k", default 2, at least 1.
+ *   - overload_max_skip. Late frames not tracked in a row before one is tracked
+ * anyway, whatever the policy, default 5, at least 1.
+ *   - rgb_queue_size. Number of rgb frames buffered to match detections, default
+ * 20. It shall cover the latency of detection at the camera frame rate, e.g. 15
+ * for a 500ms detector at 30fps.
+ *   - catch_up. After rectifying with a detection older than the latest frame,
+ * track again the frames buffered since the detection, so the output does not
+ * lag behind the detector, default true.
+ *   - motion_compensate. Carry a detection older than the latest frame over to
+ * it, shifting each roi by the median optical flow of its points, and rectify
+ * against the latest frame instead of replaying the frames buffered since, so
+ * the cost of a late detection does not grow with the latency of the
+ * detector, see MotionCompensator. Detections carried over count as
+ * detections_compensated in the stats, default false.
+ *   - async_rectify. Rectify against a detection frame and replay the frames
+ * buffered since on a worker thread of each stream, while the rgb frames are
+ * published with the objects tracked before, extrapolated at their
+ * velocities, so the output does not stall on the arrival of a detection,
+ * see TrackingStream. The frames published so count as frames_rectifying in
+ * the stats, default false.
+ *   - check_rectify. Skip rectifying when every detected object is already
+ * tracked well, which keeps the tracked objects of the buffered frames for the
+ * comparison, default false.
+ *   - streams. Names of the camera streams, e.g. ["cam0", "cam1"] for topics
+ * /cam0/object_analytics/rgb etc. Each stream is served by a callback group of
+ * its own, so streams are processed in parallel by a multi-threaded executor.
+ * Default empty for one stream on the topics without prefix.
+ *   - rgb_cache_mb. Limit of the rgb frames buffered by a stream in MB, the
+ * oldest frames are evicted over it, default 0 for no limit but rgb_queue_size.
+ *   - tracker_model_mb. Limit of the estimated bytes of the trackings of a
+ * stream in MB, the longest undetected trackings are evicted over it, see
+ * TrackingManager::setModelLimit(), default 0 for no limit.
+ *   - tracker_budget_kb, tracker_budget_ms. Budget of the estimated model in
+ * KB and of the mean update cost in ms of each "TLD", "MIL" or "BOOSTING"
+ * tracker, over either the tracker is re-seeded dropping what it learned, see
+ * Tracking::setModelBudget(), default 0 for no budget.
+ *   - publish_stats. Publish the latencies of detect and track, the depth of
+ * the rgb queues, the trackings and idle pool trackers, the frames skipped and
+ * evicted, and the memory accounts of all streams every second on
+ * /object_analytics/pipeline_stats, see util::StatsPublisher, default true.
+ *   - frame_trace. Trace the time each tracking frame spends in the stream on
+ * /object_analytics/frame_trace, see util::FrameTracer, default false.
+ *   - depth_gate_m. Subscribe to /object_analytics/localization of each stream,
+ * and never associate a detection with a tracking whose 3d centroids are
+ * farther apart than this many meters, see TrackingManager::setDepthGate().
+ * Detection frames wait for their localization, so the segmenter shall run on
+ * the same detections. Default 0 to associate on the rois alone.
+ *   - occlusion_overlap. Freeze the tracker of the farther of two objects
+ * overlapping by at least this fraction of the smaller roi, by depth when
+ * both are localized, coasting its roi on its motion instead, see
+ * TrackingManager::setOcclusionThreshold(). The updates skipped count as
+ * updates_occluded in the stats, default 0 to update every tracker.
+ *   - reid_capacity. Keep the appearance of up to this many confirmed trackings
+ * lost, and give a new detection of the same class and a similar appearance
+ * the ID of the most similar one, see TrackingManager::setReid(). Counted as
+ * trackings_reidentified in the stats, default 0 to always take a new ID.
+ *   - reid_max_age_s. Seconds a tracking lost may be re-identified, default 30.
+ *   - reid_min_similarity. Least cosine similarity of the appearances of a
+ * tracking lost and a detection re-identified, default 0.8.
+ *   - coalesce_detections. When detection frames are queued back-to-back, e.g.
+ * after a stall of the detector, rectify only against the latest one with its
+ * rgb frame, and count the others in the stats, default true.
+ *   - warmup. Seed and update the trackers of each stream on a synthetic frame
+ * at construction, and log the time taken, so the first frames meet the steady
+ * state latency, see TrackingManager::warmup(), default true.
+ *   - capture_file. Record the frames and detections given to the manager of
+ * each stream into this file, suffixed by the name of a named stream, for
+ * replay by tracking_replay, see @ref TrackingCapture, default empty for none.
+ *   - capture_format. Image format of the captured frames, ".jpg" by default,
+ * or ".png" for lossless frames.
+ *   - snapshot_file. Save the trackings of each stream into this file,
+ * suffixed by the name of a named stream, and restore them at start, so a
+ * restarted node keeps their IDs and re-seeds their trackers from its first
+ * frame, see @ref TrackingSnapshot, default empty for none. Snapshots not
+ * written count as snapshot_failed in the stats.
+ *   - snapshot_interval. Seconds between snapshots, default 1.0.
+ *   - snapshot_max_age. Seconds after which a snapshot is too old to restore,
+ * default 10.0, 0 to restore any.
+ *   - degrade_width_level and degraded_working_width. Track at this working
+ * width once the quality level of the governor reaches this level, see
+ * util::QualityListener, default 2 and 320. The trackings are reseeded at the
+ * new scale with their IDs, see TrackingManager::setWorkingScale().
+ *   - degrade_cap_level and degraded_max_trackings. Track at most this many
+ * objects, the most probable ones, once the quality level reaches this level,
+ * see TrackingManager::setMaxTrackings(), default 3 and 10. The detections and
+ * trackings dropped count as detections_capped in the stats. A level of 0
+ * never degrades.
+ *   - qos.rgb, qos.detection, qos.tracking, qos.localization and
+ * qos.quality_level. QoS of the topics of all streams, see util::QosProfiles,
+ * default "sensor" for rgb, "reliable" for the others.
  */
 class TrackingNode : public rclcpp::Node
 {
@@ -75,63 +203,57 @@ public:
   OBJECT_ANALYTICS_NODE_PUBLIC TrackingNode(rclcpp::NodeOptions options);
 
   /**
-   * @brief Set tracker manager algorithm.
+   * @brief Declare the parameters of the streams on a node, see above.
+   *
+   * @param[in] node Node declaring the parameters, e.g. a replayer configured
+   * as the node was.
+   * @return Configuration of the streams.
    */
-  void setAlgo(std::string algo) {tm_->setAlgo(algo);}
+  OBJECT_ANALYTICS_NODE_PUBLIC static TrackingStream::Options declareOptions(rclcpp::Node * node);
 
   /**
-   * @brief Get tracker manager algorithm in current use.
+   * @brief Share the threads updating trackers out among the streams.
+   *
+   * @param[in] threads Threads of all streams, see parameter tracking_threads.
+   * @param[in] streams Number of streams.
+   * @param[in] index Index of a stream.
+   * @return Threads of the stream, at least 1 for the executor thread calling
+   * its manager.
    */
-  std::string getAlgo() {return tm_->getAlgo();}
+  OBJECT_ANALYTICS_NODE_PUBLIC static int32_t getStreamThreads(
+    int32_t threads, size_t streams,
+    size_t index);
 
-private:
   /**
-   * @brief Callback from the object detection.
-   *
-   * @param[in] objs List of objects detected in a detection frame.
+   * @brief Set tracker manager algorithm of all streams.
    */
-  void obj_cb(const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs);
+  void setAlgo(std::string algo);
 
   /**
-   * @brief Callback from the rgb image.
-   *
-   * @param[in] img Image frame captured by camera.
+   * @brief Get tracker manager algorithm in current use.
    */
-  void rgb_cb(const sensor_msgs::msg::Image::ConstSharedPtr & img);
+  std::string getAlgo() {return streams_.front()->getManager().getAlgo();}
 
   /**
-   * @brief Publish tracked objects.
-   *
-   * @param[in] header Message header of the tracked objects.
+   * @brief Get the number of tracking frames not tracked under overload, over
+   * all streams.
    */
-  void tracking_publish(const std_msgs::msg::Header & header);
+  uint64_t getSkippedFrames();
 
   /**
-   * @brief Check if the objects tracked well and no need rectify.
-   *
-   * @param[in] objs List of objects detected in a detection frame.
-   * @return true if new object apprear in detection or tracked result not
-   * precision enough.
+   * @brief Get the number of streams hosted.
    */
-  bool check_rectify(
-    const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs);
+  size_t getStreamCount() {return streams_.size();}
 
-  rclcpp::Publisher<object_analytics_msgs::msg::TrackedObjects>::SharedPtr
-    pub_tracking_;   /**< Tracking publisher.*/
-  rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr
-    sub_rgb_;   /**< Rgb image subscriber.*/
-  rclcpp::Subscription<object_msgs::msg::ObjectsInBoxes>::SharedPtr
-    sub_obj_;                           /**< Object detection subscriber.*/
-  std::unique_ptr<TrackingManager> tm_; /**< TrackingManager*/
-  std::vector<sensor_msgs::msg::Image::ConstSharedPtr>
-  rgbs_;     /**< Rgb image buffer.*/
-  std::vector<object_analytics_msgs::msg::TrackedObjects::SharedPtr>
-  tracks_;     /**< tracked objs records.*/
-  object_msgs::msg::ObjectsInBoxes::ConstSharedPtr last_obj_,
-    this_obj_;   /**< Last detection frame, and this detection frame.*/
-  builtin_interfaces::msg::Time last_detection_,
-    this_detection_;   /**< Timestamp of last and this detection frame.*/
-  uint32_t kRgbQueueSize;
+  /**
+   * @brief Get a stream hosted, in the order of parameter streams.
+   */
+  TrackingStream & getStream(size_t index) {return *streams_[index];}
+
+private:
+  std::vector<std::unique_ptr<TrackingStream>> streams_; /**< Streams hosted.*/
+  std::unique_ptr<util::StatsPublisher> stats_;  /**< Statistics publisher, if enabled.*/
+  std::unique_ptr<util::QualityListener> quality_;  /**< Quality level, if degrading.*/
 };
 }  // namespace tracker
 }  // namespace object_analytics_node
@@ -0,0 +1,90 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_SNAPSHOT_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_SNAPSHOT_HPP_
+
+#include <opencv2/core/types.hpp>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class TrackingSnapshot
+ * Compact file of the state of the trackings of a @ref TrackingManager, so a
+ * restarted node resumes them, see TrackingManager::snapshot() and
+ * TrackingManager::restore().
+ *
+ * A snapshot keeps for each tracking its ID, object, rois, lifecycle and
+ * history, not its tracker, which is re-seeded from the first frame after the
+ * restore. Rois are in camera pixels, whatever the working scale of the
+ * manager.
+ *
+ * A file is a header of @ref kMagic, @ref kVersion, the wall time of the
+ * snapshot and the count of trackings, followed by the trackings, in host
+ * byte order. It is written aside and renamed, so a crash while writing keeps
+ * the previous snapshot.
+ */
+class TrackingSnapshot
+{
+public:
+  /** State of one tracking.*/
+  struct Entry
+  {
+    int64_t id;             /**< ID of the tracking.*/
+    std::string name;       /**< Name of the tracked object.*/
+    float probability;      /**< Probability of the tracked object.*/
+    cv::Rect2d tracked;     /**< Roi tracked.*/
+    cv::Rect2d detected;    /**< Roi of the latest detection.*/
+    int32_t state;          /**< Stage of the lifecycle, see Tracking::State.*/
+    int32_t hits;           /**< Count of detections.*/
+    int32_t ageing;         /**< Frames since the latest detection.*/
+    int32_t misses;         /**< Count of detections missed, negative.*/
+    bool localized;         /**< Centroid valid.*/
+    cv::Point3d centroid;   /**< 3d centroid of the latest localization.*/
+    std::vector<std::pair<int64_t, cv::Rect2d>> history;  /**< Stamped rois tracked, oldest first.*/
+  };
+
+  static const uint32_t kMagic;    /**< Tag of a snapshot file.*/
+  static const uint32_t kVersion;  /**< Format of a snapshot file.*/
+  static const uint32_t kMaxEntries;  /**< Trackings, or history of one, read at most.*/
+
+  /**
+   * @brief Write a snapshot.
+   *
+   * @param[in] file Path of the snapshot, replaced once written.
+   * @param[in] stamp Wall time of the snapshot in nanoseconds.
+   * @param[in] entries State of the trackings.
+   * @return false if the file cannot be written.
+   */
+  static bool save(const std::string & file, int64_t stamp, const std::vector<Entry> & entries);
+
+  /**
+   * @brief Read a snapshot.
+   *
+   * @param[in] file Path of the snapshot.
+   * @param[out] stamp Wall time of the snapshot in nanoseconds.
+   * @param[out] entries State of the trackings.
+   * @return false if there is no snapshot, or it is truncated or of another
+   * format, entries are left empty.
+   */
+  static bool load(const std::string & file, int64_t & stamp, std::vector<Entry> & entries);
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_SNAPSHOT_HPP_
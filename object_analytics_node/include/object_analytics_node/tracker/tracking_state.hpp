@@ -0,0 +1,109 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_STATE_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_STATE_HPP_
+
+#include <opencv2/core/types.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class TrackingState
+ * Struct-of-arrays mirror of the state of a list of trackings.
+ *
+ * Each field is a contiguous array indexed like the list, so math over all
+ * trackings, e.g. scoring detections against every tracked roi, reads plain
+ * arrays instead of chasing a pointer and copying a string per tracking.
+ * Object names are mirrored as interned class IDs, compared as integers.
+ */
+struct TrackingState
+{
+  std::vector<double> x;          /**< Left of the tracked roi.*/
+  std::vector<double> y;          /**< Top of the tracked roi.*/
+  std::vector<double> width;      /**< Width of the tracked roi.*/
+  std::vector<double> height;     /**< Height of the tracked roi.*/
+  std::vector<int32_t> class_id;  /**< Interned object name.*/
+  std::vector<int32_t> ageing;    /**< Frames since the latest detection.*/
+  std::vector<uint8_t> detected;  /**< Detected in the latest detection.*/
+  std::vector<cv::Point3d> centroid;  /**< 3d centroid of the latest localization.*/
+  std::vector<uint8_t> localized;     /**< Centroid valid, localized in any detection.*/
+
+  /**
+   * @brief Get the number of trackings mirrored.
+   */
+  size_t size() const {return x.size();}
+
+  /**
+   * @brief Drop all trackings, storage is kept.
+   */
+  void clear()
+  {
+    x.clear();
+    y.clear();
+    width.clear();
+    height.clear();
+    class_id.clear();
+    ageing.clear();
+    detected.clear();
+    centroid.clear();
+    localized.clear();
+  }
+
+  /**
+   * @brief Reserve storage for a number of trackings.
+   */
+  void reserve(size_t n)
+  {
+    x.reserve(n);
+    y.reserve(n);
+    width.reserve(n);
+    height.reserve(n);
+    class_id.reserve(n);
+    ageing.reserve(n);
+    detected.reserve(n);
+    centroid.reserve(n);
+    localized.reserve(n);
+  }
+
+  /**
+   * @brief Append a tracking, with its 3d centroid if localized.
+   */
+  void push(
+    const cv::Rect2d & rect, int32_t cls, int32_t age, bool det,
+    const cv::Point3d * c = nullptr)
+  {
+    x.push_back(rect.x);
+    y.push_back(rect.y);
+    width.push_back(rect.width);
+    height.push_back(rect.height);
+    class_id.push_back(cls);
+    ageing.push_back(age);
+    detected.push_back(det);
+    centroid.push_back(c != nullptr ? *c : cv::Point3d());
+    localized.push_back(c != nullptr);
+  }
+
+  /**
+   * @brief Get the tracked roi of a tracking.
+   */
+  cv::Rect2d rect(size_t i) const {return cv::Rect2d(x[i], y[i], width[i], height[i]);}
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_STATE_HPP_
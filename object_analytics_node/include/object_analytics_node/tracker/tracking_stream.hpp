@@ -0,0 +1,650 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_STREAM_HPP_
+#define OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_STREAM_HPP_
+
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+#include <object_analytics_msgs/msg/tracked_objects.hpp>
+#include <object_msgs/msg/objects_in_boxes.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <std_msgs/msg/header.hpp>
+#include <rmw/types.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "object_analytics_node/tracker/frame_context.hpp"
+#include "object_analytics_node/tracker/motion_compensator.hpp"
+#include "object_analytics_node/tracker/overload_gate.hpp"
+#include "object_analytics_node/tracker/tracking.hpp"
+#include "object_analytics_node/tracker/tracking_capture.hpp"
+#include "object_analytics_node/tracker/tracking_manager.hpp"
+#include "object_analytics_node/tracker/tracking_snapshot.hpp"
+#include "object_analytics_node/util/detection_filter.hpp"
+#include "object_analytics_node/util/frame_tracer.hpp"
+#include "object_analytics_node/util/memory_account.hpp"
+#include "object_analytics_node/util/stamped_ring_buffer.hpp"
+#include "object_analytics_node/util/thread_policy.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+/** @class TrackingStream
+ * Multiple trackings of one camera, hosted by a @ref TrackingNode.
+ *
+ * - Subscribe topics
+ *   - [/name]/object_analytics/rgb. This class listen to "sensor_msgs::Image"
+ * published by an RGBD camera, see @ref rgb_cb().
+ *   - [/name]/object_analytics/detected_objects. This class also listen to
+ * "object_msgs::ObjectsInBoxes" published by object detection node, see @ref
+ * obj_cb().
+ * - Publish topic
+ *   - [/name]/object_analytics/tracking. This class publish
+ * "object_analytics_msgs::TrackedObjects", see @ref tracking_publish().
+ *
+ * Topics are prefixed with the name of the stream, except for an unnamed
+ * stream. Callbacks of a stream are serialized in a callback group of their
+ * own, so streams run in parallel with a multi-threaded executor.
+ *
+ * The tracking workflow is initiated by a detection frame. Roi of each detected
+ * object will be used to initialize a tracker for that object. Then the tracker
+ * will be kept updated with each successive frames arrived, we calling them
+ * tracking frames, till next detection frame arrives. So the rhythm of the
+ * workflow is to repeat this sequence:
+ *
+ * [detection, tracking, tracking, tracking, ..., tracking]
+ *
+ * It pending on the frequency of detection, several tracking frames are
+ * processed in between. The faster the tracker algorithm or the less objects to
+ * track, the more tracking frames being processed before the next detection
+ * frame arrives.
+ *
+ * TrackingStream simply buffers the RGB image in @ref rgb_cb(), and waiting for
+ * the arrival of the detection frame. Then in @ref obj_cb(), TrackingStream noted
+ * down this object frame and last object frame. The "last" object frame is used
+ * to initiate trackings, then TrackingStream will process all successive frames
+ * before "this" object frame.
+ *
+ * TrackingStream has a @ref TrackingManager to process tracking updates from
+ * both detection frames and tracking frames.
+ *
+ * With a depth gate, see Options::depth_gate, the stream also listens to
+ * [/name]/object_analytics/localization, see @ref loc_cb(). A detection frame
+ * waits for the localization of its stamp, and is processed without it once a
+ * later localization or detection arrives, see TrackingManager::setDepthGate().
+ *
+ * Detection frames delivered in a burst, e.g. after a stall of the detector,
+ * are coalesced, see Options::coalesce and @ref coalesce(). Only the latest
+ * one is rectified against, the others are counted, see @ref
+ * getCoalesced().
+ *
+ * With a capture file, see Options::capture_file, the frames and the calls
+ * of the manager are recorded in order, see @ref TrackingCapture.
+ *
+ * With a snapshot file, see Options::snapshot_file, the trackings are saved
+ * periodically, see @ref TrackingSnapshot, and a snapshot recent enough is
+ * restored at construction, so a restarted node keeps tracking the objects
+ * with their IDs from its first frame instead of waiting for detections.
+ *
+ * With asynchronous rectification, see Options::async_rectify, the tracking
+ * state is double-buffered: a worker thread of the stream takes the manager
+ * to rectify against the buffered detection frame and to replay the frames
+ * buffered since, while @ref rgb_cb() keeps publishing the objects published
+ * before the detection, extrapolated at their velocities. Once caught up with
+ * the latest frame, the worker publishes it and hands the manager back under
+ * the lock of the frame ring, so no frame is missed by either. A detection
+ * arriving meanwhile waits for the worker, only the latest one is kept, see
+ * @ref getRectifySuperseded().
+ *
+ * With motion compensation, see Options::motion_compensate, a detection older
+ * than the latest frame is carried over to it by the optical flow of its rois,
+ * see @ref MotionCompensator, and rectified against the latest frame at once,
+ * so no frame is replayed whatever the latency of the detector. Detections
+ * whose rois are not all carried over are rectified and replayed as before.
+ *
+ * The working width and the cap of the trackings may be changed at runtime,
+ * e.g. by the quality level of the governor, see @ref setWorkingWidth() and
+ * @ref setMaxTrackings(). Each frame keeps the scale it was made at, and the
+ * manager takes the scale and the cap of the frame it is given, so trackings
+ * are reseeded at the new scale from the first frame made at it.
+ */
+class TrackingStream
+{
+public:
+  /** Configuration of a stream, see the parameters of @ref TrackingNode.*/
+  struct Options
+  {
+    Options();
+
+    int32_t num_threads;      /**< Threads updating trackers in parallel.*/
+    size_t history_capacity;  /**< Frames of tracked rois kept by a tracking.*/
+    double rectify_threshold; /**< Overlap to keep a tracker when rectifying.*/
+    size_t tracker_pool_size; /**< Trackers created ahead per algorithm.*/
+    double budget_ms;         /**< Time budget of tracking a frame.*/
+    OverloadGate gate;        /**< Overload policy of tracking frames.*/
+    size_t queue_size;        /**< Number of rgb frames buffered.*/
+    bool catch_up;            /**< Replay buffered frames after a late detection.*/
+    bool motion_compensate;   /**< Carry a late detection over to the latest frame.*/
+    bool check_rectify;       /**< Skip rectify if tracked well, see @ref check_rectify().*/
+    bool frame_trace;         /**< Trace tracking frames, see util::FrameTracer.*/
+    size_t rgb_cache_bytes;   /**< Limit of bytes of buffered rgb frames, 0 if unlimited.*/
+    size_t model_bytes;       /**< Limit of bytes of trackings, 0 if unlimited.*/
+    size_t tracker_bytes;     /**< Model budget of each tracking, 0 if any.*/
+    double tracker_update_ms; /**< Mean update cost budget of each tracking, 0 if any.*/
+    double crop_margin;       /**< Margin of the window tracked around a roi, 0 if none.*/
+    int32_t crop_max_side;    /**< Largest roi side tracked at full resolution, 0 if any.*/
+    int32_t working_width;    /**< Width frames are tracked at, 0 for the camera width.*/
+    int32_t particles;        /**< Particles of algorithm "PARTICLE", 0 to scale with cores.*/
+    util::DetectionFilter filter;  /**< Filter of the detected objects tracked.*/
+    Tracking::Lifecycle lifecycle; /**< Lifecycle policy of the trackings.*/
+    rmw_qos_profile_t rgb_qos;       /**< QoS of the rgb subscription.*/
+    rmw_qos_profile_t detection_qos; /**< QoS of the detection subscription.*/
+    rmw_qos_profile_t tracking_qos;  /**< QoS of the tracking publisher.*/
+    double depth_gate;  /**< Distance in meters gating association, 0 if off.*/
+    double occlusion;   /**< Overlap freezing the farther tracking, 0 if off.*/
+    size_t reid_capacity;    /**< Trackings lost kept for re-identification, 0 if off.*/
+    double reid_max_age;     /**< Seconds a tracking lost is kept, 0 if till evicted.*/
+    double reid_similarity;  /**< Least appearance similarity re-identified.*/
+    rmw_qos_profile_t localization_qos;  /**< QoS of the localization subscription.*/
+    bool coalesce;      /**< Take only the latest of the detection frames queued.*/
+    bool warmup;        /**< Warm up the trackers at construction.*/
+    std::string capture_file;    /**< Log of the manager inputs, empty if none.*/
+    std::string capture_format;  /**< Image format of the captured frames.*/
+    bool async_rectify;          /**< Rectify on a worker, extrapolating meanwhile.*/
+    util::ThreadPolicy worker_policy;  /**< Affinity and priority of the tracker workers.*/
+    std::string goturn_batch_model;   /**< Network of "GOTURN_BATCH" without extension.*/
+    std::string goturn_batch_device;  /**< Device of "GOTURN_BATCH", see BatchGoturn.*/
+    std::string snapshot_file;   /**< Snapshot of the trackings, empty if none.*/
+    double snapshot_interval;    /**< Seconds between snapshots.*/
+    double snapshot_max_age;     /**< Seconds a snapshot is restored within, 0 if any.*/
+  };
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] node Node hosting the stream, which outlives the stream.
+   * @param[in] name Name of the stream, prefixing its topics, may be empty.
+   * @param[in] options Configuration of the stream.
+   */
+  TrackingStream(rclcpp::Node * node, const std::string & name, const Options & options);
+
+  /**
+   * @brief Destructor, stop the rectification worker if any.
+   */
+  ~TrackingStream();
+
+  /**
+   * @brief Configure a manager as the manager of a stream.
+   *
+   * @param[in,out] tm The manager.
+   * @param[in] options Configuration of the stream.
+   */
+  static void configure(TrackingManager & tm, const Options & options);
+
+  /**
+   * @brief Check if a detection frame needs the trackings rectified, see
+   * Options::check_rectify.
+   *
+   * No rectify is needed if each detected object has a tracked object of its
+   * name at the detection stamp overlapping its roi by an IoU above @ref
+   * kCheckOverlap. Each detected object is compared with the tracked object
+   * of its name overlapping it most, whatever the order of the lists.
+   *
+   * @param[in] objs Objects detected in a detection frame.
+   * @param[in] tracked Objects tracked at the stamp of the detection frame.
+   * @return true if an object is new or not tracked precisely enough.
+   */
+  static bool needsRectify(
+    const object_msgs::msg::ObjectsInBoxes & objs,
+    const object_analytics_msgs::msg::TrackedObjects & tracked);
+
+  static const double kCheckOverlap;  /**< IoU of a tracked object tracked well.*/
+
+  /**
+   * @brief Get the name of the stream.
+   */
+  const std::string & getName() const {return name_;}
+
+  /**
+   * @brief Get the TrackingManager of the stream.
+   */
+  TrackingManager & getManager() {return *tm_;}
+
+  /**
+   * @brief Set the tracker algorithm of the manager, deferred till the
+   * rectification in progress is done, if any.
+   *
+   * @param[in] algo Algorithm, see TrackingManager::setAlgo().
+   */
+  void setAlgo(const std::string & algo);
+
+  /**
+   * @brief Set the width frames are tracked at, from the next frame received.
+   *
+   * @param[in] width Working width, 0 for the camera width.
+   */
+  void setWorkingWidth(int32_t width) {working_width_ = width > 0 ? width : 0;}
+
+  /**
+   * @brief Set the cap of the trackings, taken by the manager with its next
+   * frame, see TrackingManager::setMaxTrackings().
+   *
+   * @param[in] max Most trackings, 0 if unlimited.
+   */
+  void setMaxTrackings(size_t max) {max_trackings_ = max;}
+
+  /**
+   * @brief Get the number of tracking frames not tracked under overload.
+   */
+  uint64_t getSkippedFrames() const {return gate_.getSkipped();}
+
+  /**
+   * @brief Get the number of rgb frames buffered, safe from any thread.
+   */
+  size_t getQueueDepth() const {return queue_depth_;}
+
+  /**
+   * @brief Get the number of trackings, safe from any thread.
+   */
+  size_t getTrackingCount() const {return trackings_;}
+
+  /**
+   * @brief Get the number of idle trackers in the tracker pool, safe from any
+   * thread.
+   */
+  size_t getPoolIdle() const {return pool_idle_;}
+
+  /**
+   * @brief Get the number of rgb frames evicted for the memory limit.
+   */
+  uint64_t getRgbEvicted() const {return rgb_evicted_;}
+
+  /**
+   * @brief Get the number of trackings evicted for the memory limit.
+   */
+  uint64_t getModelEvicted() const {return model_evicted_;}
+
+  /**
+   * @brief Get the number of trackers re-seeded for their model budget.
+   */
+  uint64_t getModelCompacted() const {return model_compacted_;}
+
+  /**
+   * @brief Get the number of detection frames processed without localization.
+   */
+  uint64_t getLocalizationMissed() const {return loc_missed_;}
+
+  /**
+   * @brief Get the number of detection-tracking pairs gated by depth.
+   */
+  uint64_t getDepthGated() const {return depth_gated_;}
+
+  /**
+   * @brief Get the number of tracker updates skipped for occlusion.
+   */
+  uint64_t getOccluded() const {return occluded_;}
+
+  /**
+   * @brief Get the number of detections given back the ID of a tracking lost.
+   */
+  uint64_t getReidentified() const {return reidentified_;}
+
+  /**
+   * @brief Get the number of detections and trackings dropped for the cap,
+   * see @ref setMaxTrackings().
+   */
+  uint64_t getCapped() const {return capped_;}
+
+  /**
+   * @brief Get the number of detection frames skipped for a later one queued.
+   */
+  uint64_t getCoalesced() const {return coalesced_;}
+
+  /**
+   * @brief Get the number of detection frames carried over to a later frame,
+   * see Options::motion_compensate.
+   */
+  uint64_t getCompensated() const {return compensated_;}
+
+  /**
+   * @brief Get the number of frames not captured, the capture falling behind.
+   */
+  uint64_t getCaptureDropped() const {return capture_ ? capture_->getDropped() : 0;}
+
+  /**
+   * @brief Get the number of snapshots not written.
+   */
+  uint64_t getSnapshotFailed() const {return snapshot_failed_;}
+
+  /**
+   * @brief Get the number of frames published extrapolated while rectifying.
+   */
+  uint64_t getRectifyingFrames() const {return rectifying_frames_;}
+
+  /**
+   * @brief Get the number of detection frames not rectified against, a later
+   * one coming while rectifying.
+   */
+  uint64_t getRectifySuperseded() const {return superseded_;}
+
+  /**
+   * @brief Get the memory account of the buffered rgb frames.
+   */
+  const util::MemoryAccount & getRgbMemory() const {return rgb_memory_;}
+
+  /**
+   * @brief Get the memory account of the trackings.
+   */
+  const util::MemoryAccount & getModelMemory() const {return model_memory_;}
+
+private:
+  /**
+   * @brief Get the topic of the stream.
+   *
+   * @param[in] topic Topic name of an unnamed stream, see @ref Const.
+   */
+  std::string getTopic(const std::string & topic) const;
+
+  /** A buffered rgb frame.*/
+  struct Frame
+  {
+    sensor_msgs::msg::Image::ConstSharedPtr img; /**< The message, owning the data.*/
+    std::shared_ptr<FrameContext> ctx;  /**< Preprocessed data of the frame.*/
+    size_t bytes;   /**< Bytes of the message, and of the conversion if any.*/
+    double scale;   /**< Working scale the frame was made at.*/
+    int64_t ingress_ns;  /**< Steady clock when the frame came in, see util::FrameTracer.*/
+  };
+
+  /** A detection frame to rectify against on the worker.*/
+  struct Rectify
+  {
+    object_msgs::msg::ObjectsInBoxes::ConstSharedPtr objs;  /**< Objects detected.*/
+    object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr loc;  /**< May be empty.*/
+    bool publish;  /**< Publish the result even if no frame is replayed.*/
+    bool check;    /**< Skip if tracked well, with check_rectify.*/
+  };
+
+  /**
+   * @brief Callback from the object detection.
+   *
+   * @param[in] objs List of objects detected in a detection frame.
+   */
+  void obj_cb(const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs);
+
+  /**
+   * @brief Take the detection frames queued behind one, keeping the latest.
+   *
+   * The latest frame is kept if its rgb frame is buffered or yet to come,
+   * otherwise the latest one with its rgb frame buffered. Only the messages
+   * queued in the middleware are taken, not those delivered intra-process.
+   *
+   * @param[in] objs Detection frame delivered to @ref obj_cb().
+   * @return Detection frame to process.
+   */
+  object_msgs::msg::ObjectsInBoxes::ConstSharedPtr coalesce(
+    const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs);
+
+  /**
+   * @brief Process a detection frame.
+   *
+   * @param[in] objs List of objects detected in a detection frame.
+   * @param[in] loc Localization of the objects, may be empty.
+   */
+  void detection(
+    const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+    const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc);
+
+  /**
+   * @brief Callback from the segmenter, releasing the detection waiting for it.
+   *
+   * @param[in] loc Localization of the objects of a detection frame.
+   */
+  void loc_cb(const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc);
+
+  /**
+   * @brief Callback from the rgb image.
+   *
+   * @param[in] img Image frame captured by camera.
+   */
+  void rgb_cb(const sensor_msgs::msg::Image::ConstSharedPtr & img);
+
+  /**
+   * @brief Wrap an rgb image for tracking, without copy if possible.
+   *
+   * Images in an encoding supported by @ref FrameContext share the message
+   * data, others are converted to BGR once. Frames wider than the working
+   * width are downscaled once here, for all trackings of the frame.
+   *
+   * @param[in] img Image frame captured by camera.
+   * @return The frame to buffer.
+   */
+  Frame make_frame(const sensor_msgs::msg::Image::ConstSharedPtr & img);
+
+  /**
+   * @brief Give the manager the working scale of a frame and the cap of the
+   * trackings, before a call of the manager on the frame by its owner.
+   *
+   * @param[in] frame Frame detected or tracked next.
+   */
+  void adopt(const Frame & frame);
+
+  /**
+   * @brief Collect tracked objects of a frame into @ref msg_.
+   *
+   * The message storage is reused across frames. A copy is kept in @ref
+   * tracks_ only if check_rectify is enabled.
+   *
+   * @param[in] header Message header of the tracked objects.
+   * @return Tracked objects collected, valid till the next call.
+   */
+  const object_analytics_msgs::msg::TrackedObjects & collect_tracked(
+    const std_msgs::msg::Header & header);
+
+  /**
+   * @brief Publish tracked objects.
+   *
+   * @param[in] frame Frame the objects were tracked on, its header is the
+   * header of the message and its ingress time the start of the traced latency.
+   */
+  void tracking_publish(const Frame & frame);
+
+  /**
+   * @brief Publish the objects published before the rectification in
+   * progress, extrapolated to a frame, see Options::async_rectify.
+   *
+   * @param[in] header Message header of the frame.
+   */
+  void interim_publish(const std_msgs::msg::Header & header);
+
+  /**
+   * @brief Rectify on the worker, or once the rectification in progress is
+   * done, the lock of @ref rgbs_ held.
+   *
+   * @param[in] job The detection frame, its rgb frame buffered.
+   */
+  void submit(const Rectify & job);
+
+  /**
+   * @brief Hand the manager to the worker for a rectification, by the owner
+   * of the manager, the lock of @ref rgbs_ held.
+   *
+   * @param[in] job The detection frame.
+   */
+  void start(const Rectify & job);
+
+  /**
+   * @brief Worker thread main loop of the asynchronous rectification.
+   */
+  void run();
+
+  /**
+   * @brief Rectify against a detection frame and replay the frames buffered
+   * since, till caught up with the latest one, on the worker.
+   *
+   * With motion compensation, the detection is carried over to the latest
+   * frame first, see @ref compensate(), and only the frames coming meanwhile
+   * are replayed.
+   *
+   * @param[in] detected The rgb frame of the detection.
+   * @param[in] job The detection frame.
+   * @param[in,out] lock Lock of @ref rgbs_, released on entry and held on
+   * return.
+   */
+  void fast_forward(
+    const Frame & detected, const Rectify & job,
+    std::unique_lock<std::mutex> & lock);
+
+  /**
+   * @brief Carry a detection frame over to a later frame, see @ref
+   * MotionCompensator.
+   *
+   * @param[in] rgb The rgb frame of the detection.
+   * @param[in] latest The later rgb frame.
+   * @param[in,out] objs Objects detected, replaced by those carried over and
+   * stamped with the later frame.
+   * @param[in,out] loc Localization of the detection, may be empty, replaced
+   * alike.
+   * @return false if untouched, the frames made at different scales or a roi
+   * not carried over.
+   */
+  bool compensate(
+    const Frame & rgb, const Frame & latest,
+    object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+    object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc);
+
+  /**
+   * @brief Check if the objects tracked well and no need rectify.
+   *
+   * @param[in] objs List of objects detected in a detection frame.
+   * @return true if new object apprear in detection or tracked result not
+   * precision enough, see @ref needsRectify().
+   */
+  bool check_rectify(
+    const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs);
+
+  /**
+   * @brief Update the memory accounts and the statistics mirrored for other
+   * threads.
+   *
+   * The oldest rgb frames are evicted while the buffer is over its limit, the
+   * latest frame is always kept. The lock of @ref rgbs_ shall be held.
+   *
+   * @param[in] manager Mirror the statistics of the manager too, only by its
+   * owner.
+   */
+  void account(bool manager = true);
+
+  /**
+   * @brief Restore the snapshot of the stream if recent enough, at
+   * construction.
+   *
+   * @param[in] max_age Seconds since the snapshot, 0 if any age.
+   */
+  void restore(double max_age);
+
+  /**
+   * @brief Save a snapshot if the interval passed, by the owner of the
+   * manager.
+   */
+  void snapshot();
+
+  static const size_t kRgbQueueSize;   /**< Default depth of the frame rings.*/
+  rclcpp::Node * node_;   /**< Node hosting the stream.*/
+  std::string name_;      /**< Name of the stream.*/
+  rclcpp::callback_group::CallbackGroup::SharedPtr
+    group_;   /**< Callback group of the stream.*/
+  rclcpp::Publisher<object_analytics_msgs::msg::TrackedObjects>::SharedPtr
+    pub_tracking_;   /**< Tracking publisher.*/
+  rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr
+    sub_rgb_;   /**< Rgb image subscriber.*/
+  rclcpp::Subscription<object_msgs::msg::ObjectsInBoxes>::SharedPtr
+    sub_obj_;                           /**< Object detection subscriber.*/
+  rclcpp::Subscription<object_analytics_msgs::msg::ObjectsInBoxes3D>::SharedPtr
+    sub_loc_;   /**< Localization subscriber, if gated by depth.*/
+  util::StampedRingBuffer<object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr>
+  locs_;     /**< Localizations not yet taken, keyed by stamp.*/
+  object_msgs::msg::ObjectsInBoxes::ConstSharedPtr
+    pending_obj_;   /**< Detection frame waiting for its localization.*/
+  object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr
+    this_loc_;   /**< Localization of this detection frame, if any.*/
+  std::atomic<uint64_t> loc_missed_{0};   /**< Detections processed without localization.*/
+  std::atomic<uint64_t> depth_gated_{0};  /**< Pairs gated by depth.*/
+  std::atomic<uint64_t> occluded_{0};     /**< Updates skipped for occlusion.*/
+  std::atomic<uint64_t> reidentified_{0}; /**< Detections re-identified.*/
+  std::atomic<uint64_t> capped_{0};       /**< Dropped for the cap of the trackings.*/
+  bool coalesce_;   /**< Coalesce detection frames queued.*/
+  std::atomic<uint64_t> coalesced_{0};    /**< Detection frames coalesced.*/
+  std::unique_ptr<TrackingManager> tm_; /**< TrackingManager*/
+  util::StampedRingBuffer<Frame>
+  rgbs_;     /**< Rgb image buffer, keyed by stamp.*/
+  std::atomic<size_t> queue_depth_{0};  /**< Size of @ref rgbs_ for statistics.*/
+  std::atomic<size_t> trackings_{0};    /**< Number of trackings for statistics.*/
+  std::atomic<size_t> pool_idle_{0};    /**< Idle trackers for statistics.*/
+  std::atomic<uint64_t> rgb_evicted_{0};    /**< Rgb frames evicted for the limit.*/
+  std::atomic<uint64_t> model_evicted_{0};  /**< Trackings evicted for the limit.*/
+  std::atomic<uint64_t> model_compacted_{0};  /**< Trackers re-seeded for the budget.*/
+  object_analytics_msgs::msg::TrackedObjects
+    msg_;   /**< Tracked objs of the latest frame, reused for publishing.*/
+  util::StampedRingBuffer<object_analytics_msgs::msg::TrackedObjects::SharedPtr>
+  tracks_;     /**< tracked objs records with check_rectify, keyed by stamp.*/
+  object_msgs::msg::ObjectsInBoxes::ConstSharedPtr last_obj_,
+    this_obj_;   /**< Last detection frame, and this detection frame.*/
+  builtin_interfaces::msg::Time last_detection_,
+    this_detection_;   /**< Timestamp of last and this detection frame.*/
+  OverloadGate gate_;   /**< Overload policy of tracking frames.*/
+  bool catch_up_;       /**< Replay buffered frames after a late detection.*/
+  bool motion_compensate_;  /**< Carry a late detection over to the latest frame.*/
+  std::atomic<uint64_t> compensated_{0};  /**< Detection frames carried over.*/
+  bool check_rectify_;  /**< Skip rectify if tracked well.*/
+  std::atomic<int32_t> working_width_;  /**< Width frames are tracked at, 0 for camera width.*/
+  std::atomic<size_t> max_trackings_{0};  /**< Cap of the trackings, 0 if unlimited.*/
+  std::unique_ptr<util::FrameTracer> tracer_;  /**< Frame tracer, if enabled.*/
+  std::unique_ptr<TrackingCapture> capture_;   /**< Capture of the manager inputs, if enabled.*/
+  util::MemoryAccount rgb_memory_;    /**< Bytes of @ref rgbs_.*/
+  util::MemoryAccount model_memory_;  /**< Bytes of the trackings.*/
+  std::string snapshot_file_;   /**< Snapshot of the trackings, empty if none.*/
+  std::chrono::steady_clock::duration snapshot_interval_;   /**< Time between snapshots.*/
+  std::chrono::steady_clock::time_point snapshot_last_;     /**< Time of the latest snapshot.*/
+  std::vector<TrackingSnapshot::Entry> snapshot_entries_;   /**< Scratch of the snapshots.*/
+  std::atomic<uint64_t> snapshot_failed_{0};  /**< Snapshots not written.*/
+  bool restored_ = false;   /**< Trackings restored, tracked before any detection.*/
+  std::mutex mutex_;   /**< Guard of @ref rgbs_ and of the handover of the manager.*/
+  std::condition_variable cond_;  /**< Wakeup of the worker.*/
+  bool async_;         /**< Rectify on the worker.*/
+  std::atomic<bool> rectifying_{false};  /**< The worker owns the manager.*/
+  bool stop_ = false;  /**< Worker shutting down.*/
+  std::unique_ptr<Rectify> job_;      /**< Detection frame handed to the worker.*/
+  std::unique_ptr<Rectify> pending_;  /**< Latest detection frame coming meanwhile.*/
+  std::string pending_algo_;          /**< Algorithm set meanwhile.*/
+  std::vector<cv::Point2d> velocities_;  /**< Velocities of the objects of @ref msg_.*/
+  object_analytics_msgs::msg::TrackedObjects
+    front_;   /**< Objects published before the rectification, extrapolated meanwhile.*/
+  std::vector<cv::Point2d> front_velocities_;  /**< Velocities of the objects of @ref front_.*/
+  object_analytics_msgs::msg::TrackedObjects
+    interim_;   /**< Extrapolated objects, reused for publishing.*/
+  std::atomic<uint64_t> rectifying_frames_{0};  /**< Frames published extrapolated.*/
+  std::atomic<uint64_t> superseded_{0};  /**< Detection frames superseded meanwhile.*/
+  std::thread rectifier_;  /**< Worker of the asynchronous rectification.*/
+};
+}  // namespace tracker
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__TRACKER__TRACKING_STREAM_HPP_
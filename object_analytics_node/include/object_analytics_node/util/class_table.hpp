@@ -0,0 +1,68 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__CLASS_TABLE_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__CLASS_TABLE_HPP_
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class ClassTable
+ * Process-wide table of object class names interned as small integers.
+ *
+ * Each distinct name (e.g. "person") is stored once and gets the next free ID,
+ * which stays valid for the lifetime of the process. Components compare and
+ * store the IDs, and turn them back into names only when filling messages.
+ * All methods are thread safe.
+ */
+class ClassTable
+{
+public:
+  /**
+   * @brief Get the ID of a class name, interned on first use.
+   *
+   * @param[in] name Class name of the object.
+   * @return ID of the name, starting from 0.
+   */
+  static int32_t intern(const std::string & name);
+
+  /**
+   * @brief Get the class name of an ID.
+   *
+   * @param[in] id ID returned by @ref intern().
+   * @return Name of the ID, an empty string if the ID is unknown. The reference
+   * stays valid for the lifetime of the process.
+   */
+  static const std::string & name(int32_t id);
+
+  /**
+   * @brief Get the number of interned names.
+   */
+  static size_t size();
+
+private:
+  static std::mutex mtx_;
+  static std::deque<std::string> names_;
+  static std::unordered_map<std::string, int32_t> ids_;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__CLASS_TABLE_HPP_
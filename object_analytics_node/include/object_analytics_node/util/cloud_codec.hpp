@@ -0,0 +1,63 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__CLOUD_CODEC_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__CLOUD_CODEC_HPP_
+
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <object_analytics_msgs/msg/compressed_point_cloud.hpp>
+#include <cstdint>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class CloudCodec
+ * Lossy compression of the x/y/z of a point cloud, for clouds sent over a slow link.
+ *
+ * Each coordinate is quantized to a 16 bit integer of kResolution meters, covering about
+ * +/-32m. The x, y and z planes are then compressed into one lz4 block, the smooth depth of an
+ * organized cloud compresses well. Points not finite or out of range are invalid.
+ */
+class CloudCodec
+{
+public:
+  /**
+   * @brief Compress the x/y/z of a point cloud.
+   *
+   * @param[in]  points     PointCloud2 with FLOAT32 x/y/z fields, e.g. XYZRGB.
+   * @param[out] compressed Compressed cloud, the capacity of its data is reused.
+   * @throw std::runtime_error if the cloud is not supported or compression fails.
+   */
+  static void encode(
+    const sensor_msgs::msg::PointCloud2 & points,
+    object_analytics_msgs::msg::CompressedPointCloud & compressed);
+
+  /**
+   * @brief Decompress a point cloud into a PointCloud2 w/ XYZ, invalid points are NaN.
+   *
+   * @param[in]  compressed Compressed cloud.
+   * @param[out] points     PointCloud2 w/ XYZ, the capacity of its data is reused.
+   * @throw std::runtime_error if the compressed data is corrupted.
+   */
+  static void decode(
+    const object_analytics_msgs::msg::CompressedPointCloud & compressed,
+    sensor_msgs::msg::PointCloud2 & points);
+
+  static const float kResolution; /**< Meters of a quantization step.*/
+  static const int16_t kInvalid;  /**< Quantized value of an invalid point.*/
+};
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__CLOUD_CODEC_HPP_
@@ -0,0 +1,67 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__COMPACT_OBJECTS_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__COMPACT_OBJECTS_HPP_
+
+#include <object_analytics_msgs/msg/class_names.hpp>
+#include <object_analytics_msgs/msg/compact_objects_in_boxes3_d.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class CompactObjects
+ * Conversion of ObjectsInBoxes3D to and from CompactObjectsInBoxes3D.
+ *
+ * Class names become the IDs of the process-wide ClassTable, and boxes, bounds and tracking ids
+ * are packed into arrays of primitives, which serialize without a per object string. Consumers
+ * look the IDs up in the latched ClassNames, see @ref getNames().
+ */
+class CompactObjects
+{
+public:
+  /**
+   * @brief Pack objects into the compact message, class names are interned.
+   *
+   * @param[in]  objs    Objects to pack.
+   * @param[out] compact Compact message, the capacity of its arrays is reused.
+   */
+  static void pack(
+    const object_analytics_msgs::msg::ObjectsInBoxes3D & objs,
+    object_analytics_msgs::msg::CompactObjectsInBoxes3D & compact);
+
+  /**
+   * @brief Unpack the compact message back into objects.
+   *
+   * @param[in]  compact Compact message.
+   * @param[in]  names   Class names the class IDs index into.
+   * @param[out] objs    Objects, named empty if the ID is not in names, do_rectify is false.
+   * @return false if the arrays of the compact message are of inconsistent sizes.
+   */
+  static bool unpack(
+    const object_analytics_msgs::msg::CompactObjectsInBoxes3D & compact,
+    const object_analytics_msgs::msg::ClassNames & names,
+    object_analytics_msgs::msg::ObjectsInBoxes3D & objs);
+
+  /**
+   * @brief Get all class names of the ClassTable.
+   *
+   * @param[out] names Class names, names[id] is the name of id.
+   */
+  static void getNames(object_analytics_msgs::msg::ClassNames & names);
+};
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__COMPACT_OBJECTS_HPP_
@@ -0,0 +1,88 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__COMPACT_PUBLISHER_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__COMPACT_PUBLISHER_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/class_names.hpp>
+#include <object_analytics_msgs/msg/compact_objects_in_boxes3_d.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+
+#include <string>
+
+#include "object_analytics_node/util/compact_objects.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class CompactPublisher
+ * Publish localization results as CompactObjectsInBoxes3D alongside ObjectsInBoxes3D.
+ *
+ * Objects are packed on topic/compact only while it has subscribers. The class names of the
+ * IDs are published latched on topic/classes whenever the table is extended, a consumer whose
+ * table is smaller than class_count of the objects waits for the next one.
+ */
+class CompactPublisher
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] node Node publishing the objects.
+   * @param[in] topic Topic of the ObjectsInBoxes3D, e.g. @ref Const::kTopicLocalization.
+   */
+  CompactPublisher(rclcpp::Node * node, const std::string & topic)
+  {
+    pub_ = node->create_publisher<object_analytics_msgs::msg::CompactObjectsInBoxes3D>(
+      topic + "/compact");
+    /* late subscribers get the table published before they joined*/
+    rmw_qos_profile_t latched = rmw_qos_profile_default;
+    latched.durability = RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL;
+    latched.depth = 1;
+    pub_names_ = node->create_publisher<object_analytics_msgs::msg::ClassNames>(
+      topic + "/classes", latched);
+  }
+
+  /**
+   * @brief Publish the objects in the compact message, and the class names if extended.
+   *
+   * @param[in] objs Objects published as ObjectsInBoxes3D.
+   */
+  void publish(const object_analytics_msgs::msg::ObjectsInBoxes3D & objs)
+  {
+    if (pub_->get_subscription_count() == 0) {
+      return;
+    }
+    CompactObjects::pack(objs, compact_);
+    if (compact_.class_count > published_classes_) {
+      object_analytics_msgs::msg::ClassNames names;
+      names.header = objs.header;
+      CompactObjects::getNames(names);
+      published_classes_ = names.names.size();
+      pub_names_->publish(names);
+    }
+    pub_->publish(compact_);
+  }
+
+private:
+  rclcpp::Publisher<object_analytics_msgs::msg::CompactObjectsInBoxes3D>::SharedPtr pub_;
+  rclcpp::Publisher<object_analytics_msgs::msg::ClassNames>::SharedPtr pub_names_;
+  object_analytics_msgs::msg::CompactObjectsInBoxes3D compact_;
+  size_t published_classes_ = 0;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__COMPACT_PUBLISHER_HPP_
@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__DETECTION_FILTER_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__DETECTION_FILTER_HPP_
+
+#include <object_msgs/msg/object_in_box.hpp>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class DetectionFilter
+ * Early rejection of detections not worth tracking or segmenting.
+ *
+ * A detection is accepted when its probability is not less than the minimum
+ * probability, its roi covers at least the minimum area, and its class is in
+ * the allow-list if one is set. The numeric checks run first, the class name
+ * is only looked up for the detections passing them, and the detection is
+ * read in place, never copied. The default filter accepts everything.
+ */
+class DetectionFilter
+{
+public:
+  /**
+   * @brief Constructor of a filter accepting every detection.
+   */
+  DetectionFilter();
+
+  /**
+   * @brief Set the minimum probability of accepted detections.
+   *
+   * @param[in] probability Minimum confidence, default 0.
+   */
+  void setMinProbability(float probability) {min_probability_ = probability;}
+
+  /**
+   * @brief Get the minimum probability of accepted detections.
+   */
+  float getMinProbability() const {return min_probability_;}
+
+  /**
+   * @brief Set the minimum roi area of accepted detections.
+   *
+   * @param[in] area Minimum width times height in pixels, default 0.
+   */
+  void setMinArea(uint64_t area) {min_area_ = area;}
+
+  /**
+   * @brief Set the classes accepted.
+   *
+   * @param[in] classes Object names accepted, empty to accept any class.
+   */
+  void setClasses(const std::vector<std::string> & classes);
+
+  /**
+   * @brief Check a detection against the filter.
+   *
+   * @param[in] obj Detection to check.
+   * @return true if the detection is accepted.
+   */
+  bool accept(const object_msgs::msg::ObjectInBox & obj) const;
+
+private:
+  float min_probability_;
+  uint64_t min_area_;
+  std::unordered_set<std::string> classes_;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__DETECTION_FILTER_HPP_
@@ -0,0 +1,90 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__FRAME_TRACER_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__FRAME_TRACER_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+#include <std_msgs/msg/header.hpp>
+#include <object_analytics_msgs/msg/frame_trace.hpp>
+
+#include <chrono>
+#include <string>
+
+#include "object_analytics_node/const.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class FrameTracer
+ * Trace the time each frame spends in a stage on @ref Const::kTopicFrameTrace.
+ *
+ * A stage takes @ref now() when an input comes in, and calls @ref trace() with the header of the
+ * output once it is published. Ingress and egress are on the steady clock, CLOCK_MONOTONIC on
+ * Linux, which is shared by the processes of a host, so traces of composed and standalone nodes
+ * compare. The publish time on the node clock is given as well, for the latency since capture
+ * by header.stamp.
+ */
+class FrameTracer
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] node Node hosting the stage.
+   * @param[in] stage Name of the stage.
+   */
+  FrameTracer(rclcpp::Node * node, const std::string & stage)
+  : node_(node), stage_(stage)
+  {
+    pub_ = node_->create_publisher<object_analytics_msgs::msg::FrameTrace>(
+      Const::kTopicFrameTrace);
+  }
+
+  /**
+   * @brief Get the steady clock in nanoseconds.
+   */
+  static int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /**
+   * @brief Trace a frame published by the stage.
+   *
+   * @param[in] header Header of the output, stamped with the capture time.
+   * @param[in] ingress_ns Steady clock when the input came in, see @ref now().
+   */
+  void trace(const std_msgs::msg::Header & header, int64_t ingress_ns)
+  {
+    object_analytics_msgs::msg::FrameTrace msg;
+    msg.header = header;
+    msg.stage = stage_;
+    msg.ingress_ns = ingress_ns;
+    msg.egress_ns = now();
+    msg.published = node_->now();
+    pub_->publish(msg);
+  }
+
+private:
+  rclcpp::Node * node_;
+  std::string stage_;
+  rclcpp::Publisher<object_analytics_msgs::msg::FrameTrace>::SharedPtr pub_;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__FRAME_TRACER_HPP_
@@ -0,0 +1,95 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__MEMORY_ACCOUNT_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__MEMORY_ACCOUNT_HPP_
+
+#include <object_analytics_msgs/msg/pipeline_stats.hpp>
+#include <atomic>
+#include <string>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class MemoryAccount
+ * Bytes held by one subsystem, with the high-water mark and the hard limit.
+ *
+ * The owner of the memory updates the account on its own thread, the account
+ * is collected by a @ref StatsPublisher from another. Keeping within the limit
+ * is up to the owner, usually by evicting the oldest data.
+ */
+class MemoryAccount
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] name Name of the account in PipelineStats.
+   * @param[in] limit Hard limit in bytes, 0 if unlimited.
+   */
+  explicit MemoryAccount(const std::string & name, uint64_t limit = 0)
+  : name_(name), limit_(limit) {}
+
+  /**
+   * @brief Set the bytes currently held, raising the high-water mark.
+   */
+  void update(uint64_t bytes)
+  {
+    bytes_.store(bytes, std::memory_order_relaxed);
+    uint64_t peak = peak_.load(std::memory_order_relaxed);
+    while (bytes > peak && !peak_.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief Check if bytes exceed the limit.
+   */
+  bool isOver(uint64_t bytes) const {return limit_ > 0 && bytes > limit_;}
+
+  /**
+   * @brief Get the hard limit in bytes, 0 if unlimited.
+   */
+  uint64_t getLimit() const {return limit_;}
+
+  /**
+   * @brief Get the bytes currently held.
+   */
+  uint64_t getBytes() const {return bytes_.load(std::memory_order_relaxed);}
+
+  /**
+   * @brief Get the high-water mark in bytes.
+   */
+  uint64_t getPeak() const {return peak_.load(std::memory_order_relaxed);}
+
+  /**
+   * @brief Append the account to the memory arrays of a PipelineStats.
+   */
+  void collect(object_analytics_msgs::msg::PipelineStats & msg) const
+  {
+    msg.memory_names.push_back(name_);
+    msg.memory_bytes.push_back(getBytes());
+    msg.memory_peaks.push_back(getPeak());
+    msg.memory_limits.push_back(limit_);
+  }
+
+private:
+  std::string name_;                /**< Name of the account.*/
+  uint64_t limit_;                  /**< Hard limit in bytes, 0 if unlimited.*/
+  std::atomic<uint64_t> bytes_{0};  /**< Bytes currently held.*/
+  std::atomic<uint64_t> peak_{0};   /**< High-water mark in bytes.*/
+};
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__MEMORY_ACCOUNT_HPP_
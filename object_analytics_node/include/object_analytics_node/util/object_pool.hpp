@@ -0,0 +1,128 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__OBJECT_POOL_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__OBJECT_POOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class ObjectPool
+ * Pool of reusable objects handed out by shared pointer.
+ *
+ * An object acquired from the pool goes back to the pool when its last
+ * pointer is released, instead of being deleted, so buffers such as point
+ * clouds keep their capacity across frames. Objects are returned as they were
+ * left, callers shall clear them. The pool only allocates when no idle object
+ * is left, which is counted by @ref getAllocations().
+ *
+ * Pointers may outlive the pool. Methods are thread safe.
+ *
+ * @tparam T Type of the objects, default constructible.
+ * @tparam PtrT Shared pointer type handed out, e.g. boost::shared_ptr<T> for PCL types.
+ */
+template<typename T, typename PtrT = std::shared_ptr<T>>
+class ObjectPool
+{
+public:
+  ObjectPool()
+  : state_(std::make_shared<State>()) {}
+
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool & operator=(const ObjectPool &) = delete;
+
+  /**
+   * @brief Get an idle object, or a new one if none is idle.
+   */
+  PtrT acquire()
+  {
+    T * obj = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (!state_->idle.empty()) {
+        obj = state_->idle.back();
+        state_->idle.pop_back();
+      }
+    }
+    if (obj == nullptr) {
+      obj = new T();
+      state_->allocations++;
+    }
+    state_->acquisitions++;
+    return PtrT(obj, Release{state_});
+  }
+
+  /**
+   * @brief Get the number of objects allocated by the pool.
+   */
+  size_t getAllocations() const {return state_->allocations;}
+
+  /**
+   * @brief Get the number of objects handed out by the pool.
+   */
+  size_t getAcquisitions() const {return state_->acquisitions;}
+
+  /**
+   * @brief Get the number of idle objects in the pool.
+   */
+  size_t getIdle() const
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->idle.size();
+  }
+
+private:
+  /** Idle objects and counters, shared with the pointers handed out.*/
+  struct State
+  {
+    State()
+    : allocations(0), acquisitions(0) {}
+    ~State()
+    {
+      for (auto obj : idle) {
+        delete obj;
+      }
+    }
+
+    std::mutex mutex;
+    std::vector<T *> idle;
+    std::atomic<size_t> allocations;
+    std::atomic<size_t> acquisitions;
+  };
+
+  /** Deleter of the pointers, giving the object back to the pool.*/
+  struct Release
+  {
+    std::shared_ptr<State> state;
+
+    void operator()(T * obj) const
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->idle.push_back(obj);
+    }
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__OBJECT_POOL_HPP_
@@ -0,0 +1,63 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__QOS_PROFILES_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__QOS_PROFILES_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+#include <rmw/types.h>
+
+#include <string>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class QosProfiles
+ * QoS of the topics of a node, configurable by parameters.
+ *
+ * Each topic has the parameter qos.<key>, e.g. qos.rgb, whose value is a preset optionally
+ * followed by the history depth, e.g. "sensor" or "reliable:5". Sensor inputs default to
+ * @ref kSensor, a stale frame is dropped rather than delivered late, and results default to
+ * @ref kReliable. A best effort subscription matches a reliable publisher, not the reverse.
+ */
+class QosProfiles
+{
+public:
+  static const char kSensor[];   /**< Best effort, keep last 1, for sensor inputs.*/
+  static const char kReliable[]; /**< Reliable, keep last 10, for results.*/
+
+  /**
+   * @brief Get the profile of a preset.
+   *
+   * @param[in]  value Preset, @ref kSensor or @ref kReliable, optionally followed by ":depth".
+   * @param[out] qos   Profile of the preset, unchanged if the value is invalid.
+   * @return false if the preset is unknown or the depth is not positive.
+   */
+  static bool parse(const std::string & value, rmw_qos_profile_t & qos);
+
+  /**
+   * @brief Declare the parameter qos.<key> of a topic and get its profile.
+   *
+   * @param[in] node Node of the topic.
+   * @param[in] key  Key of the topic, e.g. "rgb".
+   * @param[in] def  Preset if the parameter is not set, or invalid.
+   * @return Profile of the topic.
+   */
+  static rmw_qos_profile_t declare(
+    rclcpp::Node * node, const std::string & key,
+    const std::string & def);
+};
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__QOS_PROFILES_HPP_
@@ -0,0 +1,77 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__QUALITY_LISTENER_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__QUALITY_LISTENER_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/quality_level.hpp>
+
+#include <cstdint>
+#include <functional>
+
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class QualityListener
+ * Follow the quality level of the governor, see governor::GovernorNode.
+ *
+ * The level is taken from @ref Const::kTopicQualityLevel, and the apply
+ * callback is called on the executor thread of the node whenever it changes,
+ * for the node to degrade or restore its stage. The QoS of the topic is the
+ * parameter qos.quality_level of the node, default "reliable".
+ */
+class QualityListener
+{
+public:
+  using Apply = std::function<void (int32_t level)>;
+
+  /**
+   * @brief Constructor, start listening at full quality.
+   *
+   * @param[in] node Node of the stage.
+   * @param[in] apply Callback taking a new level.
+   */
+  QualityListener(rclcpp::Node * node, Apply apply)
+  : apply_(apply), level_(0)
+  {
+    sub_ = node->create_subscription<object_analytics_msgs::msg::QualityLevel>(
+      Const::kTopicQualityLevel,
+      [this](const object_analytics_msgs::msg::QualityLevel::SharedPtr msg) {
+        if (msg->level != level_) {
+          level_ = msg->level;
+          apply_(level_);
+        }
+      },
+      QosProfiles::declare(node, "quality_level", QosProfiles::kReliable));
+  }
+
+  /**
+   * @brief Get the latest level.
+   */
+  int32_t getLevel() const {return level_;}
+
+private:
+  Apply apply_;
+  int32_t level_;
+  rclcpp::Subscription<object_analytics_msgs::msg::QualityLevel>::SharedPtr sub_;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__QUALITY_LISTENER_HPP_
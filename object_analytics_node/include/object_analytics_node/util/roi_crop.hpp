@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__ROI_CROP_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__ROI_CROP_HPP_
+
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <sensor_msgs/msg/region_of_interest.hpp>
+#include <object_msgs/msg/objects_in_boxes.hpp>
+#include <object_analytics_msgs/msg/cropped_point_cloud.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class RoiCrop
+ * Cropping of an organized point cloud to the ROIs of its detections, for a segmenter which
+ * only reads the points inside the ROIs.
+ *
+ * Each ROI is expanded by a margin and clipped to the cloud, windows overlapping each other are
+ * merged into their bounding window, so every point is sent once. The points of the windows
+ * are packed into an unorganized XYZ cloud, and expanded back into an organized cloud of NaN
+ * outside the windows at the receiver.
+ */
+class RoiCrop
+{
+public:
+  using Window = sensor_msgs::msg::RegionOfInterest;
+
+  /**
+   * @brief Get the disjoint windows covering the margin-expanded ROIs of detections.
+   *
+   * @param[in]  objs    Detections of the cloud.
+   * @param[in]  width   Width of the cloud.
+   * @param[in]  height  Height of the cloud.
+   * @param[in]  margin  Pixels each ROI is expanded by on every side.
+   * @param[out] windows Windows inside the cloud, empty if no ROI overlaps it.
+   */
+  static void getWindows(
+    const object_msgs::msg::ObjectsInBoxes & objs, uint32_t width, uint32_t height,
+    uint32_t margin, std::vector<Window> & windows);
+
+  /**
+   * @brief Crop the x/y/z of an organized cloud to windows.
+   *
+   * @param[in]  points  Organized PointCloud2 with FLOAT32 x/y/z fields, e.g. XYZRGB.
+   * @param[in]  windows Disjoint windows inside the cloud, see getWindows().
+   * @param[out] cropped Cropped cloud, the capacity of its points is reused.
+   * @throw std::runtime_error if the cloud is not supported.
+   */
+  static void crop(
+    const sensor_msgs::msg::PointCloud2 & points, const std::vector<Window> & windows,
+    object_analytics_msgs::msg::CroppedPointCloud & cropped);
+
+  /**
+   * @brief Expand a cropped cloud into an organized PointCloud2 w/ XYZ, NaN outside windows.
+   *
+   * A pooled cloud expanded before in the same layout is only reset in the windows written
+   * then, rather than NaN-filled as a whole.
+   *
+   * @param[in]     cropped Cropped cloud.
+   * @param[out]    points  PointCloud2 w/ XYZ, the capacity of its data is reused.
+   * @param[in,out] written Windows written into points by its last expand, replaced by the
+   * windows of cropped. nullptr for a cloud not expanded before, to fill it all.
+   * @throw std::runtime_error if the windows do not match the points or the cloud.
+   */
+  static void expand(
+    const object_analytics_msgs::msg::CroppedPointCloud & cropped,
+    sensor_msgs::msg::PointCloud2 & points, std::vector<Window> * written = nullptr);
+};
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__ROI_CROP_HPP_
@@ -0,0 +1,80 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__SESSION_READER_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__SESSION_READER_HPP_
+
+#include <object_msgs/msg/objects_in_boxes.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class SessionReader
+ * Reader of the frames of a recorded session file, one frame at a time.
+ *
+ * A session file has one line per frame or detection,
+ * "stamp_ns,image,pcd[,name,probability,x,y,width,height]". Consecutive lines
+ * of a stamp are one frame, paths are relative to the file, the pcd may be
+ * empty, and empty lines and lines starting with '#' are skipped.
+ */
+class SessionReader
+{
+public:
+  /** @brief A frame of the session, the detections of its lines.*/
+  struct Frame
+  {
+    int64_t stamp = 0;   /**< Stamp in nanoseconds.*/
+    std::string image;   /**< Path of the image.*/
+    std::string pcd;     /**< Path of the point cloud, empty if none.*/
+    object_msgs::msg::ObjectsInBoxes::SharedPtr objs;  /**< Detections, stamped.*/
+  };
+
+  /**
+   * @brief Open a file.
+   *
+   * @param[in] file Path of a session file.
+   * @throw std::runtime_error if the file cannot be opened.
+   */
+  explicit SessionReader(const std::string & file);
+
+  /**
+   * @brief Read the next frame.
+   *
+   * @param[out] frame The frame read.
+   * @return false at the end of the file.
+   * @throw std::runtime_error at a malformed line, naming its line number. The
+   * frames before the line are read first.
+   */
+  bool next(Frame & frame);
+
+private:
+  bool read(std::vector<std::string> & fields);
+  std::string getPath(const std::string & path) const;
+  std::string describe(const std::string & what) const;
+  [[noreturn]] void fail(const std::string & what) const;
+
+  std::ifstream in_;
+  std::string dir_;
+  size_t line_;  /**< Number of the line read last.*/
+  std::vector<std::string> pending_;  /**< Line read ahead, of the next frame.*/
+  size_t pending_line_;               /**< Number of the line read ahead.*/
+  std::string error_;                 /**< Error of the line read ahead, if any.*/
+};
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__SESSION_READER_HPP_
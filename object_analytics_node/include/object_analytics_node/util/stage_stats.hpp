@@ -0,0 +1,137 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__STAGE_STATS_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__STAGE_STATS_HPP_
+
+#include <object_analytics_msgs/msg/stage_stats.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class StageStats
+ * Latency statistics of one pipeline stage.
+ *
+ * Each run is recorded into a count, a sum, a max and a histogram of fixed buckets, all atomics,
+ * so stages running on several threads record without locking. @ref collect() takes the
+ * statistics recorded since the previous collection.
+ */
+class StageStats
+{
+public:
+  static const size_t kBuckets = 12;          /**< Number of histogram buckets */
+  static const int64_t kBucketBoundsUs[];     /**< Upper bounds of buckets but the last one */
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] name Name of the stage.
+   */
+  explicit StageStats(const std::string & name);
+
+  /**
+   * @brief Record one run of the stage.
+   *
+   * @param[in] ns Latency of the run in nanoseconds.
+   */
+  void record(int64_t ns);
+
+  /**
+   * @brief Move the statistics recorded since the last call into a message.
+   *
+   * @param[out] msg Statistics of the stage, the histogram counts each bucket.
+   */
+  void collect(object_analytics_msgs::msg::StageStats & msg);
+
+  /**
+   * @brief Get the name of the stage.
+   */
+  const std::string & getName() const {return name_;}
+
+private:
+  std::string name_;
+  std::atomic<uint64_t> count_;
+  std::atomic<int64_t> sum_ns_;
+  std::atomic<int64_t> max_ns_;
+  std::atomic<uint64_t> histogram_[kBuckets];
+};
+
+/** @class ScopedStageTimer
+ * Steady clock timer recording its lifetime into a StageStats when destroyed.
+ */
+class ScopedStageTimer
+{
+public:
+  explicit ScopedStageTimer(StageStats & stats)
+  : stats_(stats), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedStageTimer()
+  {
+    stats_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+  }
+
+  ScopedStageTimer(const ScopedStageTimer &) = delete;
+  ScopedStageTimer & operator=(const ScopedStageTimer &) = delete;
+
+private:
+  StageStats & stats_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/** @class StageRegistry
+ * Process wide registry of the StageStats of all stages.
+ *
+ * Stages are looked up by name once, typically into a function local static reference, and
+ * stay registered for the lifetime of the process. Nodes composed into one process collect the
+ * stages of their own component by the name prefix, e.g. "segmenter.". Methods are thread safe.
+ */
+class StageRegistry
+{
+public:
+  /**
+   * @brief Get the stage of the name, registered on first use.
+   *
+   * @param[in] name Name of the stage, prefixed by its component.
+   * @return Statistics of the stage.
+   */
+  static StageStats & get(const std::string & name);
+
+  /**
+   * @brief Collect the stages whose names start with the prefix, see StageStats::collect().
+   *
+   * @param[in] prefix Prefix of the stage names.
+   * @param[out] stages Statistics of the stages, appended in order of name.
+   */
+  static void collect(
+    const std::string & prefix, std::vector<object_analytics_msgs::msg::StageStats> & stages);
+
+private:
+  static std::mutex mutex_;
+  static std::map<std::string, std::unique_ptr<StageStats>> stages_;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__STAGE_STATS_HPP_
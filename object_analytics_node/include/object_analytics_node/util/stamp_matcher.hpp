@@ -0,0 +1,205 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__STAMP_MATCHER_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__STAMP_MATCHER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "object_analytics_node/util/stamped_ring_buffer.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class StampMatcher
+ * Pairs the messages of two streams by time stamp, e.g. detections with the point clouds they
+ * were detected in.
+ *
+ * Messages of the second stream are buffered until the first stream gets to their stamp. The
+ * buffer is bounded by the bytes of the messages, the oldest ones are evicted first. Messages of
+ * the first stream are paired with the second one of the same stamp, or with the nearest one
+ * within the tolerance once the exact one is known to be missing, i.e. a newer one is buffered.
+ * A few messages of the first stream wait for a second one not arrived yet.
+ *
+ * Both streams are assumed to arrive in stamp order.
+ *
+ * @tparam FirstT Type of the first stream, e.g. a shared pointer of detections.
+ * @tparam SecondT Type of the second stream, e.g. a shared pointer of point clouds.
+ */
+template<typename FirstT, typename SecondT>
+class StampMatcher
+{
+public:
+  using Callback = std::function<void(const FirstT &, const SecondT &)>;
+
+  /** Default number of messages of the second stream buffered.*/
+  static const size_t kCapacity = 32;
+  /** Number of messages of the first stream waiting.*/
+  static const size_t kPending = 4;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] callback  Called with each pair matched.
+   * @param[in] max_bytes Bytes of the second stream buffered, at least one message is kept.
+   * @param[in] capacity  Messages of the second stream buffered.
+   */
+  StampMatcher(Callback callback, size_t max_bytes, size_t capacity = kCapacity)
+  : callback_(callback), max_bytes_(max_bytes), seconds_(capacity), firsts_(kPending) {}
+
+  /**
+   * @brief Set the largest stamp difference of a pair when the exact stamp is missing.
+   *
+   * @param[in] tolerance Stamp difference, default 0 for exact stamps only.
+   */
+  void setTolerance(int64_t tolerance) {tolerance_ = tolerance > 0 ? tolerance : 0;}
+
+  /**
+   * @brief Add a message of the first stream, paired at once if possible.
+   *
+   * @param[in] stamp Time stamp of the message.
+   * @param[in] first The message.
+   */
+  void addFirst(int64_t stamp, const FirstT & first)
+  {
+    const Second * second = seconds_.find(stamp);
+    if (second != nullptr) {
+      emit(stamp, first, *second);
+    } else if (!seconds_.empty() && seconds_.stampAt(seconds_.size() - 1) > stamp) {
+      matchNearest(stamp, first);
+    } else {
+      if (firsts_.size() == firsts_.capacity()) {
+        dropped_++;
+      }
+      firsts_.push(stamp, first);
+    }
+  }
+
+  /**
+   * @brief Add a message of the second stream, paired with the waiting ones if possible.
+   *
+   * @param[in] stamp Time stamp of the message.
+   * @param[in] second The message.
+   * @param[in] bytes Size of the message, accounted against the bytes buffered.
+   */
+  void addSecond(int64_t stamp, const SecondT & second, size_t bytes)
+  {
+    if (seconds_.size() == seconds_.capacity()) {
+      evictOldest();
+    }
+    seconds_.push(stamp, Second(second, bytes));
+    bytes_ = 0;
+    for (size_t i = 0; i < seconds_.size(); i++) {
+      bytes_ += seconds_.valueAt(i).second;
+    }
+    while (bytes_ > max_bytes_ && seconds_.size() > 1) {
+      evictOldest();
+    }
+
+    /* waiting messages up to this stamp get no other chance*/
+    size_t n = firsts_.lowerBound(stamp + 1);
+    for (size_t i = 0; i < n; i++) {
+      if (firsts_.stampAt(i) == stamp) {
+        emit(stamp, firsts_.valueAt(i), seconds_.valueAt(seconds_.size() - 1));
+      } else {
+        matchNearest(firsts_.stampAt(i), firsts_.valueAt(i));
+      }
+    }
+    firsts_.dropBefore(stamp + 1);
+  }
+
+  /**
+   * @brief Get the number of messages of the first stream never paired.
+   */
+  uint64_t getDropped() const {return dropped_;}
+
+  /**
+   * @brief Get the number of messages of the second stream evicted before their stamp came.
+   */
+  uint64_t getEvicted() const {return evicted_;}
+
+  /**
+   * @brief Get the bytes of the second stream buffered.
+   */
+  size_t getBytes() const {return bytes_;}
+
+  /**
+   * @brief Get the number of messages of the second stream buffered.
+   */
+  size_t getBuffered() const {return seconds_.size();}
+
+private:
+  typedef std::pair<SecondT, size_t> Second;
+
+  void emit(int64_t stamp, const FirstT & first, const Second & second)
+  {
+    /* a copy, the callback may add messages*/
+    SecondT matched = second.first;
+    /* older messages are of no use to later stamps*/
+    dropOlder(stamp);
+    callback_(first, matched);
+  }
+
+  void matchNearest(int64_t stamp, const FirstT & first)
+  {
+    size_t i = seconds_.lowerBound(stamp);
+    size_t best = seconds_.size();
+    int64_t best_diff = tolerance_;
+    if (i < seconds_.size() && seconds_.stampAt(i) - stamp <= best_diff) {
+      best = i;
+      best_diff = seconds_.stampAt(i) - stamp;
+    }
+    if (i > 0 && stamp - seconds_.stampAt(i - 1) <= best_diff) {
+      best = i - 1;
+    }
+    if (best == seconds_.size()) {
+      dropped_++;
+      return;
+    }
+    emit(seconds_.stampAt(best), first, seconds_.valueAt(best));
+  }
+
+  void dropOlder(int64_t stamp)
+  {
+    size_t n = seconds_.lowerBound(stamp);
+    for (size_t i = 0; i < n; i++) {
+      bytes_ -= seconds_.valueAt(i).second;
+    }
+    seconds_.dropBefore(stamp);
+  }
+
+  void evictOldest()
+  {
+    bytes_ -= seconds_.valueAt(0).second;
+    seconds_.dropBefore(seconds_.stampAt(0) + 1);
+    evicted_++;
+  }
+
+  Callback callback_;
+  size_t max_bytes_;
+  size_t bytes_ = 0;
+  int64_t tolerance_ = 0;
+  uint64_t dropped_ = 0;
+  uint64_t evicted_ = 0;
+  StampedRingBuffer<Second> seconds_;
+  StampedRingBuffer<FirstT> firsts_;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__STAMP_MATCHER_HPP_
@@ -0,0 +1,179 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__STAMPED_RING_BUFFER_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__STAMPED_RING_BUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class StampedRingBuffer
+ * Fixed capacity ring buffer of values ordered by time stamp.
+ *
+ * Storage is allocated once for the capacity, pushing into a full buffer
+ * overwrites the oldest entry. Entries are kept in ascending stamp order, so a
+ * stamp is looked up with a binary search in O(log n). Clearing only resets the
+ * cursors, which is O(1).
+ *
+ * Stamps are plain integers, e.g. nanoseconds from rclcpp::Time::nanoseconds().
+ */
+template<typename T>
+class StampedRingBuffer
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] capacity Maximum number of entries, at least one.
+   */
+  explicit StampedRingBuffer(size_t capacity)
+  : entries_(capacity > 0 ? capacity : 1), head_(0), size_(0) {}
+
+  /**
+   * @brief Get the maximum number of entries.
+   */
+  size_t capacity() const {return entries_.size();}
+
+  /**
+   * @brief Get the number of entries.
+   */
+  size_t size() const {return size_;}
+
+  /**
+   * @brief Check if the buffer is empty.
+   */
+  bool empty() const {return size_ == 0;}
+
+  /**
+   * @brief Change the capacity, existing entries are dropped.
+   *
+   * @param[in] capacity Maximum number of entries, at least one.
+   */
+  void setCapacity(size_t capacity)
+  {
+    entries_.assign(capacity > 0 ? capacity : 1, Entry());
+    clear();
+  }
+
+  /**
+   * @brief Drop all entries.
+   */
+  void clear()
+  {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  /**
+   * @brief Append an entry as the newest one.
+   *
+   * Entries with a stamp not older than the appended one are dropped first, so
+   * the buffer stays ordered and the latest write of a stamp wins.
+   *
+   * @param[in] stamp Time stamp of the entry.
+   * @param[in] value Value of the entry.
+   */
+  void push(int64_t stamp, const T & value)
+  {
+    while (size_ > 0 && at(size_ - 1).first >= stamp) {
+      size_--;
+    }
+    if (size_ == entries_.size()) {
+      head_ = (head_ + 1) % entries_.size();
+      size_--;
+    }
+    Entry & e = entries_[(head_ + size_) % entries_.size()];
+    e.first = stamp;
+    e.second = value;
+    size_++;
+  }
+
+  /**
+   * @brief Drop the oldest entries with a stamp older than the one given.
+   *
+   * @param[in] stamp Time stamp to keep from.
+   */
+  void dropBefore(int64_t stamp)
+  {
+    size_t n = lowerBound(stamp);
+    head_ = (head_ + n) % entries_.size();
+    size_ -= n;
+  }
+
+  /**
+   * @brief Find the value of a stamp.
+   *
+   * @param[in] stamp Time stamp to look for.
+   * @return Pointer to the value, nullptr if the stamp is not buffered.
+   */
+  const T * find(int64_t stamp) const
+  {
+    size_t i = lowerBound(stamp);
+    return i < size_ && at(i).first == stamp ? &at(i).second : nullptr;
+  }
+
+  /**
+   * @brief Get the position of the first entry not older than a stamp.
+   *
+   * @param[in] stamp Time stamp to look for.
+   * @return Position from the oldest entry, size() if all entries are older.
+   */
+  size_t lowerBound(int64_t stamp) const
+  {
+    size_t lo = 0, hi = size_;
+    while (lo < hi) {
+      size_t mid = lo + ((hi - lo) >> 1);
+      if (at(mid).first < stamp) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /**
+   * @brief Get the stamp of the entry at a position, 0 is the oldest.
+   */
+  int64_t stampAt(size_t i) const {return at(i).first;}
+
+  /**
+   * @brief Get the value of the entry at a position, 0 is the oldest.
+   */
+  const T & valueAt(size_t i) const {return at(i).second;}
+
+  /**
+   * @brief Get the value of the entry at a position, 0 is the oldest.
+   */
+  T & valueAt(size_t i) {return entries_[(head_ + i) % entries_.size()].second;}
+
+private:
+  typedef std::pair<int64_t, T> Entry;
+
+  const Entry & at(size_t i) const {return entries_[(head_ + i) % entries_.size()];}
+
+  std::vector<Entry> entries_; /**< Storage, allocated once for the capacity.*/
+  size_t head_;                /**< Position of the oldest entry.*/
+  size_t size_;                /**< Number of entries.*/
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__STAMPED_RING_BUFFER_HPP_
@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__STATS_PUBLISHER_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__STATS_PUBLISHER_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/pipeline_stats.hpp>
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/util/stage_stats.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class StatsPublisher
+ * Publish the statistics of the stages of one component periodically.
+ *
+ * Every period, the stages prefixed by the component are collected from the StageRegistry,
+ * the node adds its queue depths and drop counters by the fill callback, and the message is
+ * published on @ref Const::kTopicPipelineStats.
+ */
+class StatsPublisher
+{
+public:
+  using Fill = std::function<void (object_analytics_msgs::msg::PipelineStats &)>;
+
+  /**
+   * @brief Constructor, start publishing.
+   *
+   * @param[in] node Node publishing the statistics.
+   * @param[in] prefix Prefix of the stages of the component, e.g. "segmenter.".
+   * @param[in] fill Callback adding queue depths and drop counters, may be empty.
+   * @param[in] period Reporting period.
+   */
+  StatsPublisher(
+    rclcpp::Node * node, const std::string & prefix, Fill fill,
+    std::chrono::milliseconds period = std::chrono::milliseconds(1000))
+  : node_(node), prefix_(prefix), fill_(fill), period_(period)
+  {
+    pub_ = node_->create_publisher<object_analytics_msgs::msg::PipelineStats>(
+      Const::kTopicPipelineStats);
+    timer_ = node_->create_wall_timer(period_, [this]() {publish();});
+  }
+
+private:
+  void publish()
+  {
+    object_analytics_msgs::msg::PipelineStats msg;
+    msg.header.stamp = node_->now();
+    msg.header.frame_id = node_->get_name();
+    msg.period_s = period_.count() / 1e3;
+    StageRegistry::collect(prefix_, msg.stages);
+    if (fill_) {
+      fill_(msg);
+    }
+    pub_->publish(msg);
+  }
+
+  rclcpp::Node * node_;
+  std::string prefix_;
+  Fill fill_;
+  std::chrono::milliseconds period_;
+  rclcpp::Publisher<object_analytics_msgs::msg::PipelineStats>::SharedPtr pub_;
+  rclcpp::TimerBase::SharedPtr timer_;
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__STATS_PUBLISHER_HPP_
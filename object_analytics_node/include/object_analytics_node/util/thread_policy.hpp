@@ -0,0 +1,82 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__THREAD_POLICY_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__THREAD_POLICY_HPP_
+
+#include <pthread.h>
+#include <rclcpp/rclcpp.hpp>
+
+#include <string>
+#include <vector>
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class ThreadPolicy
+ * CPU affinity and real-time priority of a pipeline stage.
+ *
+ * A policy pins threads to a set of cores and, with a priority, schedules them
+ * SCHED_FIFO, which needs CAP_SYS_NICE or an rtprio limit. Failures are
+ * reported and leave the thread as it was, see @ref apply(), and @ref
+ * describe() reads back what a thread actually runs with, to report at startup.
+ */
+struct ThreadPolicy
+{
+  ThreadPolicy()
+  : priority(0) {}
+
+  std::vector<int> cores;  /**< Cores allowed, empty for any.*/
+  int priority;            /**< SCHED_FIFO priority, 0 for the default policy.*/
+
+  /**
+   * @brief Check if the policy changes nothing.
+   */
+  bool empty() const {return cores.empty() && priority <= 0;}
+
+  /**
+   * @brief Apply the policy to a thread.
+   *
+   * @param[in]  thread Thread to pin, e.g. pthread_self() or std::thread::native_handle().
+   * @param[out] error  Reason of a failure, unchanged on success.
+   * @return false if the affinity or the priority was not applied.
+   */
+  bool apply(pthread_t thread, std::string & error) const;
+
+  /**
+   * @brief Get the cores of a comma separated list, e.g. "0,2,3".
+   *
+   * @throw std::invalid_argument if an item is not a number, or out of range.
+   */
+  static std::vector<int> parseCores(const std::string & list);
+
+  /**
+   * @brief Describe the affinity and scheduling a thread runs with, e.g.
+   * "cores 2-3 SCHED_FIFO 80".
+   */
+  static std::string describe(pthread_t thread);
+
+  /**
+   * @brief Declare the parameters <key>_cores and <key>_priority of a stage
+   * and get its policy.
+   *
+   * @param[in] node Node of the stage.
+   * @param[in] key  Key of the stage, e.g. "tracking".
+   * @return Policy of the stage, empty if the parameters are not set.
+   */
+  static ThreadPolicy declare(rclcpp::Node * node, const std::string & key);
+};
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__THREAD_POLICY_HPP_
@@ -0,0 +1,126 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__THREAD_POOL_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "object_analytics_node/util/thread_policy.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+/** @class ThreadPool
+ * Persistent pool of worker threads with work stealing.
+ *
+ * Each worker owns a task queue. Tasks of one @ref parallelFor() call are
+ * distributed round-robin over the queues, a worker pops from the front of its
+ * own queue and steals from the back of the other queues once its own queue is
+ * drained. The calling thread takes part in the work as well, so a pool of
+ * N threads runs up to N + 1 tasks concurrently.
+ *
+ * Workers are created once and parked on a condition variable between calls,
+ * which avoids the cost of spawning threads per frame. They are pinned to
+ * the cores of the stage owning the pool by @ref setPolicy(), the calling
+ * thread keeps its own policy.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] num_threads Number of worker threads. With 0 every task is
+   * executed by the calling thread.
+   */
+  explicit ThreadPool(size_t num_threads);
+
+  /**
+   * @brief Destructor, wait for the queued tasks and join all workers.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Get the number of worker threads.
+   */
+  size_t getNumOfThread() const {return threads_.size();}
+
+  /**
+   * @brief Apply a policy to all worker threads.
+   *
+   * @param[in]  policy Affinity and priority of the workers.
+   * @param[out] error  Reason of a failure, unchanged on success.
+   * @return false if the policy was not applied to every worker.
+   */
+  bool setPolicy(const ThreadPolicy & policy, std::string & error);
+
+  /**
+   * @brief Describe the policy the workers run with, see ThreadPolicy::describe().
+   */
+  std::string getPolicy();
+
+  /**
+   * @brief Run func(0) ... func(count - 1) on the pool and wait for all.
+   *
+   * The order of execution is not specified, callers shall write results into
+   * slots indexed by the task index to keep a deterministic output. The first
+   * exception thrown by a task is rethrown to the caller after all tasks
+   * finished.
+   *
+   * @param[in] count Number of tasks.
+   * @param[in] func Task body, called with the task index.
+   */
+  void parallelFor(size_t count, const std::function<void(size_t)> & func);
+
+private:
+  struct TaskQueue
+  {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  /**
+   * @brief Pop a task from queue @p index, or steal one from the other queues.
+   */
+  bool popTask(size_t index, std::function<void()> & task);
+
+  /**
+   * @brief Worker thread main loop.
+   */
+  void run(size_t index);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_; /**< One queue per worker.*/
+  std::vector<std::thread> threads_;               /**< Worker threads.*/
+  std::mutex mutex_;                               /**< Guard of the parking.*/
+  std::condition_variable cond_;                   /**< Worker parking.*/
+  std::atomic<size_t> pending_;                    /**< Queued tasks.*/
+  std::atomic<size_t> next_queue_;                 /**< Round-robin cursor.*/
+  bool stop_;                                      /**< Pool shutting down.*/
+};
+
+}  // namespace util
+}  // namespace object_analytics_node
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__THREAD_POOL_HPP_
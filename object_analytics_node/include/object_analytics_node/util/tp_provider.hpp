@@ -0,0 +1,137 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* LTTng tracepoint provider, read more than once by design, see lttng-ust(3)*/
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER object_analytics
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "object_analytics_node/util/tp_provider.hpp"
+
+#if !defined(OBJECT_ANALYTICS_NODE__UTIL__TP_PROVIDER_HPP_) || \
+  defined(TRACEPOINT_HEADER_MULTI_READ)
+#define OBJECT_ANALYTICS_NODE__UTIL__TP_PROVIDER_HPP_
+
+#include <lttng/tracepoint.h>
+#include <stdint.h>
+
+/* a phase of segmentation starts, with the number of points going in*/
+TRACEPOINT_EVENT(
+  TRACEPOINT_PROVIDER,
+  segmenter_phase_begin,
+  TP_ARGS(
+    const char *, phase_arg,
+    uint64_t, points_arg),
+  TP_FIELDS(
+    ctf_string(phase, phase_arg)
+    ctf_integer(uint64_t, points, points_arg)))
+
+/* a phase of segmentation ends, with the number of points or clusters coming out*/
+TRACEPOINT_EVENT(
+  TRACEPOINT_PROVIDER,
+  segmenter_phase_end,
+  TP_ARGS(
+    const char *, phase_arg,
+    uint64_t, result_arg),
+  TP_FIELDS(
+    ctf_string(phase, phase_arg)
+    ctf_integer(uint64_t, result, result_arg)))
+
+/* a detection frame is rectifying the trackings*/
+TRACEPOINT_EVENT(
+  TRACEPOINT_PROVIDER,
+  tracker_detect,
+  TP_ARGS(
+    int64_t, stamp_arg,
+    uint64_t, objects_arg),
+  TP_FIELDS(
+    ctf_integer(int64_t, stamp, stamp_arg)
+    ctf_integer(uint64_t, objects, objects_arg)))
+
+/* a detected object is associated to a tracking, -1 for a new one*/
+TRACEPOINT_EVENT(
+  TRACEPOINT_PROVIDER,
+  tracker_associate,
+  TP_ARGS(
+    int64_t, id_arg,
+    const char *, name_arg,
+    int32_t, x_arg,
+    int32_t, y_arg,
+    int32_t, width_arg,
+    int32_t, height_arg),
+  TP_FIELDS(
+    ctf_integer(int64_t, id, id_arg)
+    ctf_string(name, name_arg)
+    ctf_integer(int32_t, x, x_arg)
+    ctf_integer(int32_t, y, y_arg)
+    ctf_integer(int32_t, width, width_arg)
+    ctf_integer(int32_t, height, height_arg)))
+
+/* the tracker of a tracking is updated with a frame*/
+TRACEPOINT_EVENT(
+  TRACEPOINT_PROVIDER,
+  tracker_update,
+  TP_ARGS(
+    int64_t, id_arg,
+    const char *, algo_arg,
+    double, cost_ms_arg,
+    int, updated_arg),
+  TP_FIELDS(
+    ctf_integer(int64_t, id, id_arg)
+    ctf_string(algo, algo_arg)
+    ctf_float(double, cost_ms, cost_ms_arg)
+    ctf_integer(int, updated, updated_arg)))
+
+/* the model of the tracker of a tracking after an update*/
+TRACEPOINT_EVENT(
+  TRACEPOINT_PROVIDER,
+  tracker_model,
+  TP_ARGS(
+    int64_t, id_arg,
+    const char *, algo_arg,
+    uint64_t, bytes_arg,
+    double, mean_cost_ms_arg,
+    uint32_t, updates_arg,
+    uint32_t, compactions_arg),
+  TP_FIELDS(
+    ctf_integer(int64_t, id, id_arg)
+    ctf_string(algo, algo_arg)
+    ctf_integer(uint64_t, bytes, bytes_arg)
+    ctf_float(double, mean_cost_ms, mean_cost_ms_arg)
+    ctf_integer(uint32_t, updates, updates_arg)
+    ctf_integer(uint32_t, compactions, compactions_arg)))
+
+/* the roi of a tracking is published*/
+TRACEPOINT_EVENT(
+  TRACEPOINT_PROVIDER,
+  tracker_publish,
+  TP_ARGS(
+    int64_t, id_arg,
+    int, detected_arg,
+    int32_t, x_arg,
+    int32_t, y_arg,
+    int32_t, width_arg,
+    int32_t, height_arg),
+  TP_FIELDS(
+    ctf_integer(int64_t, id, id_arg)
+    ctf_integer(int, detected, detected_arg)
+    ctf_integer(int32_t, x, x_arg)
+    ctf_integer(int32_t, y, y_arg)
+    ctf_integer(int32_t, width, width_arg)
+    ctf_integer(int32_t, height, height_arg)))
+
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__TP_PROVIDER_HPP_
+
+#include <lttng/tracepoint-event.h>
@@ -0,0 +1,35 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_ANALYTICS_NODE__UTIL__TRACEPOINTS_HPP_
+#define OBJECT_ANALYTICS_NODE__UTIL__TRACEPOINTS_HPP_
+
+/** @file
+ * Tracepoints of the segmenter and the tracker.
+ *
+ * With OBJECT_ANALYTICS_NODE_TRACING defined, i.e. built with -DTRACING=ON, each
+ * OA_TRACEPOINT() is an LTTng-UST tracepoint of the provider object_analytics, see
+ * tp_provider.hpp. It costs a predicted branch and evaluates its arguments only while a session
+ * enables it. Events are recorded along with the ros2_tracing events of rclcpp, e.g. by
+ * "ros2 trace -u 'object_analytics:*' 'ros2:*'". Otherwise tracepoints compile to nothing.
+ */
+
+#ifdef OBJECT_ANALYTICS_NODE_TRACING
+#include "object_analytics_node/util/tp_provider.hpp"
+#define OA_TRACEPOINT(event, ...) tracepoint(object_analytics, event, __VA_ARGS__)
+#else
+#define OA_TRACEPOINT(event, ...) do {} while (0)
+#endif
+
+#endif  // OBJECT_ANALYTICS_NODE__UTIL__TRACEPOINTS_HPP_
@@ -0,0 +1,100 @@
+# Copyright (c) 2018 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Replay a recorded bag into the composed object_analytics_node and report its performance.
+
+    ros2 launch object_analytics_node object_analytics_benchmark.launch.py bag:=/path/to/bag \
+        rate:=1.0 report:=/tmp/oa_benchmark.json transport:=shm
+
+The bag holds the rgb images, point clouds and detections on the topics of
+object_analytics_sample.launch.py. rate is the replay speed, 1.0 for real time, a large value
+such as 100.0 to replay as fast as the storage reads. ros2 bag play of Dashing and earlier has
+no --rate, the bag is replayed in real time there and rate is ignored. The run ends with the bag, or after
+duration seconds, and pipeline_benchmark writes stage latencies, queue depths, drop counters,
+CPU and RSS of object_analytics_node to report. transport is that of
+object_analytics_sample.launch.py, the bag player shares it, so runs of the default and the shm
+transport compare the CPU spent in copies of the received clouds and images.
+"""
+
+import os
+
+from ament_index_python.packages import get_package_share_directory
+
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, EmitEvent, ExecuteProcess, LogInfo
+from launch.actions import RegisterEventHandler, SetEnvironmentVariable
+from launch.conditions import IfCondition
+from launch.event_handlers import OnProcessExit
+from launch.events import Shutdown
+from launch.substitutions import LaunchConfiguration, PythonExpression
+import launch_ros.actions
+
+
+# distributions whose ros2 bag play takes no --rate
+NO_RATE_DISTROS = ('ardent', 'bouncy', 'crystal', 'dashing')
+
+
+def generate_launch_description():
+    launch_dir = os.path.join(get_package_share_directory('object_analytics_node'), 'launch')
+    shm = IfCondition(PythonExpression(["'", LaunchConfiguration('transport'), "' == 'shm'"]))
+    play = ['ros2', 'bag', 'play', LaunchConfiguration('bag')]
+    has_rate = os.environ.get('ROS_DISTRO', 'dashing') not in NO_RATE_DISTROS
+    if has_rate:
+        play += ['--rate', LaunchConfiguration('rate')]
+    bag = ExecuteProcess(cmd=play, output='screen')
+    benchmark = launch_ros.actions.Node(
+        package='object_analytics_node', node_executable='pipeline_benchmark',
+        arguments=['-p', 'object_analytics_node', '-d', LaunchConfiguration('duration'),
+                   '-o', LaunchConfiguration('report')],
+        output='screen')
+    return LaunchDescription([
+        DeclareLaunchArgument('bag', description='Path of the recorded bag'),
+        DeclareLaunchArgument('rate', default_value='1.0',
+                              description='Replay speed, 1.0 for real time'),
+        DeclareLaunchArgument('duration', default_value='0',
+                              description='Seconds to run, 0 till the bag ends'),
+        DeclareLaunchArgument('report', default_value='oa_benchmark.csv',
+                              description='Report file, .json for JSON else CSV'),
+        DeclareLaunchArgument('executor', default_value='single',
+                              description='Executor of the composed node, see composition'),
+        DeclareLaunchArgument('transport', default_value='default',
+                              description='default or shm, see object_analytics_sample.launch.py'),
+        SetEnvironmentVariable('RMW_IMPLEMENTATION', 'rmw_fastrtps_cpp', condition=shm),
+        SetEnvironmentVariable('RMW_FASTRTPS_USE_QOS_FROM_XML', '1', condition=shm),
+        SetEnvironmentVariable('FASTRTPS_DEFAULT_PROFILES_FILE',
+                               os.path.join(launch_dir, 'shm_transport.xml'), condition=shm),
+
+        # object_analytics_node, with the remappings of object_analytics_sample.launch.py
+        launch_ros.actions.Node(
+            package='object_analytics_node', node_executable='object_analytics_node',
+            arguments=['--tracking', '--localization',
+                       '--executor', LaunchConfiguration('executor')],
+            remappings=[
+                ('/object_analytics/detected_objects', '/openvino_toolkit/object/detected_objects'),
+                ('/object_analytics/rgb', '/camera/color/image_raw'),
+                ('/object_analytics/pointcloud', '/camera/pointcloud')],
+            output='screen'),
+
+        LogInfo(msg='ros2 bag play takes no --rate here, replaying in real time',
+                condition=IfCondition('false' if has_rate else 'true')),
+
+        # stage timings and drops from /object_analytics/pipeline_stats, CPU and RSS from /proc
+        benchmark,
+        bag,
+        # the report is written when the benchmark is shut down, or once duration is over
+        RegisterEventHandler(OnProcessExit(
+            target_action=bag, on_exit=[EmitEvent(event=Shutdown())])),
+        RegisterEventHandler(OnProcessExit(
+            target_action=benchmark, on_exit=[EmitEvent(event=Shutdown())])),
+    ])
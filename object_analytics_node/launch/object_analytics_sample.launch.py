@@ -16,13 +16,26 @@ import os
 
 from ament_index_python.packages import get_package_share_directory
 from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, SetEnvironmentVariable
+from launch.conditions import IfCondition
+from launch.substitutions import LaunchConfiguration, PythonExpression
 import launch_ros.actions
 
 
 def generate_launch_description():
-    default_rviz = os.path.join(get_package_share_directory('object_analytics_node'), 'launch',
-                                'rviz/default.rviz')
+    launch_dir = os.path.join(get_package_share_directory('object_analytics_node'), 'launch')
+    default_rviz = os.path.join(launch_dir, 'rviz/default.rviz')
+    # transport:=shm, the processes below go through Fast DDS shared memory on this host
+    shm = IfCondition(PythonExpression(["'", LaunchConfiguration('transport'), "' == 'shm'"]))
     return LaunchDescription([
+        DeclareLaunchArgument('transport', default_value='default',
+                              description='default for the RMW as configured, shm for Fast DDS '
+                                          'shared memory, see shm_transport.xml'),
+        SetEnvironmentVariable('RMW_IMPLEMENTATION', 'rmw_fastrtps_cpp', condition=shm),
+        SetEnvironmentVariable('RMW_FASTRTPS_USE_QOS_FROM_XML', '1', condition=shm),
+        SetEnvironmentVariable('FASTRTPS_DEFAULT_PROFILES_FILE',
+                               os.path.join(launch_dir, 'shm_transport.xml'), condition=shm),
+
         # object_analytics_node
         launch_ros.actions.Node(
             package='object_analytics_node', node_executable='object_analytics_node',
@@ -40,15 +40,76 @@ private:
 namespace fs = std::experimental::filesystem;
 #endif
 
+#include <pthread.h>
 #include <rcutils/cmdline_parser.h>
 #include <rclcpp_components/node_factory.hpp>
+#include <cstdint>
 #include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 #include <utility>
 
 #include "object_analytics_node/util/file_parser.hpp"
+#include "object_analytics_node/util/thread_policy.hpp"
+
+using object_analytics_node::util::ThreadPolicy;
+
+/* the whole value of an option as a number, std::invalid_argument naming the option if not*/
+static uint64_t parseOption(const std::string & option, const char * value, uint64_t max)
+{
+  std::string text(value);
+  size_t end = 0;
+  uint64_t number = 0;
+  try {
+    if (text.empty() || text[0] == '-') {
+      throw std::invalid_argument(text);
+    }
+    number = std::stoull(text, &end);
+  } catch (const std::logic_error &) {
+    end = 0;
+  }
+  if (end == 0 || end != text.size() || number > max) {
+    throw std::invalid_argument(option + " " + text);
+  }
+  return number;
+}
+
+/* policy of the options --affinity<suffix> and --priority<suffix>*/
+static ThreadPolicy getPolicy(char * argv[], int argc, const std::string & suffix)
+{
+  ThreadPolicy policy;
+  std::string affinity = "--affinity" + suffix;
+  std::string priority = "--priority" + suffix;
+  const char * cores = rcutils_cli_get_option(argv, argv + argc, affinity.c_str());
+  if (cores != nullptr) {
+    try {
+      policy.cores = ThreadPolicy::parseCores(cores);
+    } catch (const std::invalid_argument &) {
+      throw std::invalid_argument(affinity + " " + cores);
+    }
+  }
+  const char * prio = rcutils_cli_get_option(argv, argv + argc, priority.c_str());
+  if (prio != nullptr) {
+    policy.priority = static_cast<int>(parseOption(priority, prio, 99));
+  }
+  return policy;
+}
+
+/* apply the policy to the calling thread, threads it creates inherit it, and report the
+ * policy it actually runs with*/
+static void setThreadPolicy(
+  const rclcpp::Logger & logger, const std::string & name, const ThreadPolicy & policy)
+{
+  std::string error;
+  if (!policy.apply(pthread_self(), error)) {
+    RCLCPP_WARN(logger, "%s not pinned, %s", name.c_str(), error.c_str());
+  }
+  RCLCPP_INFO(logger, "%s runs on %s", name.c_str(),
+    ThreadPolicy::describe(pthread_self()).c_str());
+}
 
 int main(int argc, char * argv[])
 {
@@ -56,39 +117,142 @@ int main(int argc, char * argv[])
   setvbuf(stdout, NULL, _IONBF, BUFSIZ);
 
   rclcpp::init(argc, argv);
-  rclcpp::executors::SingleThreadedExecutor exec;
   rclcpp::NodeOptions options;
   std::vector<class_loader::ClassLoader *> loaders;
   std::vector<rclcpp_components::NodeInstanceWrapper> node_wrappers;
+  /* stage of each node, e.g. "tracking" of libtracking_component.so*/
+  std::vector<std::string> stages;
   rclcpp::Logger logger = rclcpp::get_logger("OA_Composition");
 
   std::vector<std::string> libraries;
 
+  /* components in this process hand messages off by pointer instead of serializing*/
+  if (rcutils_cli_option_exist(argv, argv + argc, "--intra-process")) {
+    RCLCPP_INFO(logger, "Intra-process communication enabled");
+    options.use_intra_process_comms(true);
+  }
+
+  /* split the registered cloud in process, the hops to segmenter and tracker stay in process*/
+  if (rcutils_cli_option_exist(argv, argv + argc, "--splitter")) {
+    libraries.push_back("libsplitter_component.so");
+  }
   if (rcutils_cli_option_exist(argv, argv + argc, "--localization")) {
     libraries.push_back("libsegmenter_component.so");
+  } else if (rcutils_cli_option_exist(argv, argv + argc, "--depth-localization")) {
+    /* localization from the depth image, no point cloud needed*/
+    libraries.push_back("libdepth_segmenter_component.so");
   }
   if (rcutils_cli_option_exist(argv, argv + argc, "--tracking")) {
     libraries.push_back("libtracking_component.so");
   }
+  /* join tracking and localization into moving objects in process*/
+  if (rcutils_cli_option_exist(argv, argv + argc, "--merger")) {
+    libraries.push_back("libmerger_component.so");
+  }
+  /* append the tracks to a columnar log off the hot path*/
+  if (rcutils_cli_option_exist(argv, argv + argc, "--track-logger")) {
+    libraries.push_back("libtrack_logger_component.so");
+  }
+  /* step the quality of the stages down and up against a latency target*/
+  if (rcutils_cli_option_exist(argv, argv + argc, "--governor")) {
+    libraries.push_back("libgovernor_component.so");
+  }
+
+  /* single: one thread for all components, the default
+   * multi: a pool of --threads threads, callback groups of the components run in parallel
+   * component: one thread per component, the k-th pinned to the k-th core of --affinity, or to
+   * the cores of --affinity-<stage> and --priority-<stage> of its stage, e.g. --affinity-tracking*/
+  const char * executor = rcutils_cli_get_option(argv, argv + argc, "--executor");
+  std::string mode = executor != nullptr ? executor : "single";
+  const char * threads = rcutils_cli_get_option(argv, argv + argc, "--threads");
+  size_t num_threads = std::thread::hardware_concurrency();
+  ThreadPolicy policy;
+  try {
+    if (threads != nullptr) {
+      num_threads = parseOption("--threads", threads, 1024);
+    }
+    policy = getPolicy(argv, argc, "");
+  } catch (const std::invalid_argument & e) {
+    RCLCPP_ERROR(logger, "Invalid option %s", e.what());
+    rclcpp::shutdown();
+    return 1;
+  }
 
   for (auto library : libraries) {
     RCLCPP_INFO(logger, "Load library %s", library.c_str());
     auto loader = new class_loader::ClassLoader(library);
     auto classes = loader->getAvailableClasses<rclcpp_components::NodeFactory>();
+    std::string stage = library.substr(3, library.find("_component") - 3);
     for (auto clazz : classes) {
       RCLCPP_INFO(logger, "Instantiate class %s", clazz.c_str());
       auto node_factory = loader->createInstance<rclcpp_components::NodeFactory>(clazz);
       auto wrapper = node_factory->create_node_instance(options);
-      auto node = wrapper.get_node_base_interface();
       node_wrappers.push_back(wrapper);
-      exec.add_node(node);
+      stages.push_back(stage);
     }
     loaders.push_back(loader);
   }
 
-  exec.spin();
-  for (auto wrapper : node_wrappers) {
-    exec.remove_node(wrapper.get_node_base_interface());
+  if (mode == "component") {
+    RCLCPP_INFO(logger, "Spin %zu components in threads of their own", node_wrappers.size());
+    std::vector<std::unique_ptr<rclcpp::executors::SingleThreadedExecutor>> execs;
+    std::vector<ThreadPolicy> stage_policies;
+    /* all executors and policies before any thread, no spinner sees the vectors grow*/
+    for (size_t k = 0; k < node_wrappers.size(); k++) {
+      ThreadPolicy stage_policy;
+      try {
+        stage_policy = getPolicy(argv, argc, "-" + stages[k]);
+      } catch (const std::invalid_argument & e) {
+        RCLCPP_ERROR(logger, "Invalid option %s", e.what());
+        node_wrappers.clear();
+        rclcpp::shutdown();
+        return 1;
+      }
+      if (stage_policy.cores.empty() && !policy.cores.empty()) {
+        stage_policy.cores.push_back(policy.cores[k % policy.cores.size()]);
+      }
+      if (stage_policy.priority <= 0) {
+        stage_policy.priority = policy.priority;
+      }
+      stage_policies.push_back(stage_policy);
+      execs.emplace_back(new rclcpp::executors::SingleThreadedExecutor());
+      execs[k]->add_node(node_wrappers[k].get_node_base_interface());
+    }
+    std::vector<std::thread> spinners;
+    for (size_t k = 0; k < execs.size(); k++) {
+      rclcpp::executors::SingleThreadedExecutor * exec = execs[k].get();
+      ThreadPolicy stage_policy = stage_policies[k];
+      std::string name = "executor of " + stages[k];
+      spinners.emplace_back([&logger, exec, stage_policy, name]() {
+          setThreadPolicy(logger, name, stage_policy);
+          exec->spin();
+        });
+    }
+    for (auto & spinner : spinners) {
+      spinner.join();
+    }
+    for (size_t k = 0; k < node_wrappers.size(); k++) {
+      execs[k]->remove_node(node_wrappers[k].get_node_base_interface());
+    }
+  } else {
+    std::unique_ptr<rclcpp::executor::Executor> exec;
+    if (mode == "multi") {
+      RCLCPP_INFO(logger, "Spin components in a pool of %zu threads", num_threads);
+      exec.reset(new rclcpp::executors::MultiThreadedExecutor(
+          rclcpp::executor::ExecutorArgs(), num_threads));
+    } else {
+      exec.reset(new rclcpp::executors::SingleThreadedExecutor());
+    }
+    /* stages share the threads of the executor, only their workers are pinned apart, see the
+     * parameters <stage>_cores and <stage>_priority of the nodes*/
+    setThreadPolicy(logger, "executor", policy);
+    for (auto wrapper : node_wrappers) {
+      exec->add_node(wrapper.get_node_base_interface());
+    }
+    exec->spin();
+    for (auto wrapper : node_wrappers) {
+      exec->remove_node(wrapper.get_node_base_interface());
+    }
   }
   node_wrappers.clear();
 
@@ -20,9 +20,19 @@ namespace object_analytics_node
 {
 const char Const::kTopicRegisteredPC2[] = "/object_analytics/registered_points";
 const char Const::kTopicPC2[] = "/object_analytics/pointcloud";
+const char Const::kTopicCompressedPC2[] = "/object_analytics/pointcloud/compressed";
+const char Const::kTopicCroppedPC2[] = "/object_analytics/pointcloud/cropped";
 const char Const::kTopicSegmentation[] = "/object_analytics/segmentation";
 const char Const::kTopicRgb[] = "/object_analytics/rgb";
+const char Const::kTopicDepth[] = "/object_analytics/depth";
+const char Const::kTopicCameraInfo[] = "/object_analytics/camera_info";
 const char Const::kTopicDetection[] = "/object_analytics/detected_objects";
 const char Const::kTopicLocalization[] = "/object_analytics/localization";
+const char Const::kTopicObjectPoints[] = "/object_analytics/localization/points";
+const char Const::kTopicOrientedLocalization[] = "/object_analytics/localization/oriented";
 const char Const::kTopicTracking[] = "/object_analytics/tracking";
+const char Const::kTopicMovingObjects[] = "/object_analytics/moving_objects";
+const char Const::kTopicPipelineStats[] = "/object_analytics/pipeline_stats";
+const char Const::kTopicFrameTrace[] = "/object_analytics/frame_trace";
+const char Const::kTopicQualityLevel[] = "/object_analytics/quality_level";
 }  // namespace object_analytics_node
@@ -0,0 +1,211 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "object_analytics_node/dataset/box_cache.hpp"
+
+namespace datasets
+{
+
+namespace
+{
+
+const char kMagic[8] = {'O', 'A', 'B', 'O', 'X', 'E', 'S', '\0'};
+const uint32_t kVersion = 1;
+const uint32_t kMaxSources = 4;
+
+struct SourceStamp
+{
+  int64_t size;
+  int64_t mtimeNs;
+};
+
+struct Header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t numSources;
+  SourceStamp sources[kMaxSources];
+  uint32_t gtFrames;
+  uint32_t detFrames;
+  uint64_t numBoxes;
+};
+
+struct Span
+{
+  uint32_t offset;
+  uint32_t count;
+};
+
+struct Box
+{
+  int32_t objIdx;
+  float confidence;
+  double x, y, width, height;
+};
+
+bool stampOf(const std::string & path, SourceStamp & stamp)
+{
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return false;
+  }
+  stamp.size = static_cast<int64_t>(st.st_size);
+  stamp.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+  return true;
+}
+
+bool stampSources(const std::vector<std::string> & sources, Header & header)
+{
+  if (sources.size() > kMaxSources) {
+    return false;
+  }
+  header.numSources = static_cast<uint32_t>(sources.size());
+  for (size_t i = 0; i < sources.size(); i++) {
+    if (!stampOf(sources[i], header.sources[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void appendFrames(
+  const std::vector<std::vector<Obj_>> & frames, std::vector<Span> & spans,
+  std::vector<Box> & boxes)
+{
+  for (auto & f : frames) {
+    spans.push_back({static_cast<uint32_t>(boxes.size()), static_cast<uint32_t>(f.size())});
+    for (auto & o : f) {
+      boxes.push_back({o.objIdx, o.confidence, o.bb.x, o.bb.y, o.bb.width, o.bb.height});
+    }
+  }
+}
+
+bool readFrames(
+  const Span * spans, uint32_t frames, const Box * boxes, uint64_t numBoxes,
+  std::vector<std::vector<Obj_>> & out)
+{
+  out.resize(frames);
+  for (uint32_t i = 0; i < frames; i++) {
+    if (static_cast<uint64_t>(spans[i].offset) + spans[i].count > numBoxes) {
+      return false;
+    }
+    out[i].resize(spans[i].count);
+    for (uint32_t j = 0; j < spans[i].count; j++) {
+      const Box & b = boxes[spans[i].offset + j];
+      out[i][j] = {b.objIdx, cv::Rect2d(b.x, b.y, b.width, b.height), b.confidence};
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool BoxCache::load(
+  const std::string & cachePath, const std::vector<std::string> & sources,
+  std::vector<std::vector<Obj_>> & gt, std::vector<std::vector<Obj_>> & det)
+{
+  Header expected;
+  memset(&expected, 0, sizeof(expected));
+  if (!stampSources(sources, expected)) {
+    return false;
+  }
+
+  int fd = open(cachePath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    close(fd);
+    return false;
+  }
+  size_t length = static_cast<size_t>(st.st_size);
+  void * addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+
+  const char * base = static_cast<const char *>(addr);
+  const Header * header = reinterpret_cast<const Header *>(base);
+  bool valid = memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+    header->version == kVersion && header->numSources == expected.numSources &&
+    memcmp(header->sources, expected.sources, sizeof(expected.sources)) == 0;
+  size_t spansBytes = sizeof(Span) * (static_cast<size_t>(header->gtFrames) + header->detFrames);
+  valid = valid && length == sizeof(Header) + spansBytes + sizeof(Box) * header->numBoxes;
+
+  std::vector<std::vector<Obj_>> gtOut, detOut;
+  if (valid) {
+    const Span * spans = reinterpret_cast<const Span *>(base + sizeof(Header));
+    const Box * boxes = reinterpret_cast<const Box *>(base + sizeof(Header) + spansBytes);
+    valid = readFrames(spans, header->gtFrames, boxes, header->numBoxes, gtOut) &&
+      readFrames(spans + header->gtFrames, header->detFrames, boxes, header->numBoxes, detOut);
+  }
+  munmap(addr, length);
+
+  if (valid) {
+    gt.swap(gtOut);
+    det.swap(detOut);
+  }
+  return valid;
+}
+
+bool BoxCache::save(
+  const std::string & cachePath, const std::vector<std::string> & sources,
+  const std::vector<std::vector<Obj_>> & gt,
+  const std::vector<std::vector<Obj_>> & det)
+{
+  Header header;
+  memset(&header, 0, sizeof(header));
+  if (!stampSources(sources, header)) {
+    return false;
+  }
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.gtFrames = static_cast<uint32_t>(gt.size());
+  header.detFrames = static_cast<uint32_t>(det.size());
+
+  std::vector<Span> spans;
+  std::vector<Box> boxes;
+  appendFrames(gt, spans, boxes);
+  appendFrames(det, spans, boxes);
+  header.numBoxes = boxes.size();
+
+  /* readers never see a partial file, the complete one is renamed over*/
+  std::string tmpPath = cachePath + ".tmp";
+  std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    return false;
+  }
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(spans.data()), sizeof(Span) * spans.size());
+  out.write(reinterpret_cast<const char *>(boxes.data()), sizeof(Box) * boxes.size());
+  out.close();
+  if (!out || rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+    remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace datasets
@@ -0,0 +1,129 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "object_analytics_node/dataset/frame_prefetcher.hpp"
+
+namespace datasets
+{
+
+FramePrefetcher::FramePrefetcher(size_t depth, size_t num_threads)
+: slots_(std::max<size_t>(depth, 1))
+{
+  for (size_t i = 0; i < std::max<size_t>(num_threads, 1); i++) {
+    threads_.emplace_back(&FramePrefetcher::work, this);
+  }
+}
+
+FramePrefetcher::~FramePrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cond_.notify_all();
+  for (auto & t : threads_) {
+    t.join();
+  }
+}
+
+void FramePrefetcher::start(const std::vector<std::string> & paths, size_t first)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  /* slots being decoded belong to the previous sequence*/
+  ready_cond_.wait(lock, [this] {return busy_ == 0;});
+  for (auto & slot : slots_) {
+    slot.ready = false;
+  }
+  paths_ = paths;
+  head_ = first;
+  issued_ = first;
+  lock.unlock();
+  work_cond_.notify_all();
+}
+
+bool FramePrefetcher::next(cv::Mat & frame)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (head_ >= paths_.size()) {
+    return false;
+  }
+  Slot & slot = slots_[head_ % slots_.size()];
+  size_t index = head_;
+  ready_cond_.wait(lock, [&slot, index] {return slot.ready && slot.index == index;});
+  bool ok = slot.ok;
+  cv::swap(frame, slot.image);
+  if (!ok) {
+    frame = cv::Mat();
+  }
+  slot.ready = false;
+  head_++;
+  lock.unlock();
+  work_cond_.notify_one();
+  return ok;
+}
+
+void FramePrefetcher::work()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_cond_.wait(lock, [this] {
+        return stop_ || (issued_ < paths_.size() && issued_ < head_ + slots_.size());
+      });
+    if (stop_) {
+      return;
+    }
+    size_t index = issued_++;
+    Slot & slot = slots_[index % slots_.size()];
+    std::string path = paths_[index];
+    busy_++;
+    lock.unlock();
+
+    bool ok = decode(path, slot);
+
+    lock.lock();
+    busy_--;
+    slot.index = index;
+    slot.ok = ok;
+    slot.ready = true;
+    ready_cond_.notify_all();
+  }
+}
+
+bool FramePrefetcher::decode(const std::string & path, Slot & slot)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return false;
+  }
+  slot.bytes.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  if (slot.bytes.empty() ||
+    !file.read(reinterpret_cast<char *>(slot.bytes.data()), slot.bytes.size()))
+  {
+    return false;
+  }
+  /* a frame still shared by the consumer is left to it*/
+  if (slot.image.u != nullptr && slot.image.u->refcount > 1) {
+    slot.image = cv::Mat();
+  }
+  cv::imdecode(slot.bytes, cv::IMREAD_COLOR, &slot.image);
+  return !slot.image.empty();
+}
+
+}  // namespace datasets
@@ -28,6 +28,10 @@ cv::Ptr<trDataset> trDataset::create(dsType type)
       return cv::Ptr<vidDataset>(new vidDataset);
     case dsImage:
       return cv::Ptr<imgDataset>(new imgDataset);
+    case dsMTImage:
+      return cv::Ptr<imgMTDataset>(new imgMTDataset);
+    case dsPacked:
+      return cv::Ptr<packDataset>(new packDataset);
     default:
       return nullp;
   }
@@ -35,4 +39,15 @@ cv::Ptr<trDataset> trDataset::create(dsType type)
 
 int trDataset::getFrameIdx() {return frameIdx;}
 
+cv::Rect2d trDataset::getIdxRoi(int idx)
+{
+  std::vector<Obj_> objs = getIdxGT(idx);
+  return objs.empty() ? cv::Rect2d() : objs[0].bb;
+}
+
+void trDataset::setPrefetch(size_t depth, size_t num_threads)
+{
+  prefetcher.reset(depth > 0 ? new FramePrefetcher(depth, num_threads) : nullptr);
+}
+
 }  // namespace datasets
@@ -0,0 +1,248 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <opencv2/imgcodecs.hpp>
+#include <omp.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "object_analytics_node/dataset/box_cache.hpp"
+#include "object_analytics_node/dataset/dataset_log.hpp"
+#include "object_analytics_node/dataset/track_dataset.hpp"
+
+namespace datasets
+{
+
+void imgMTDataset::load(const std::string & rootPath)
+{
+  std::string nameListPath = rootPath + "/list.txt";
+  std::ifstream namesList(nameListPath.c_str());
+  if (!namesList.is_open()) {
+    DATASET_LOG_DEBUG("Couldn't find a *list.txt* in folder!!!");
+    return;
+  }
+  std::vector<std::string> names;
+  for (std::string datasetName; getline(namesList, datasetName);) {
+    names.push_back(datasetName);
+  }
+  namesList.close();
+
+  DATASET_LOG_DEBUG("Dataset Initialization...\n");
+  /* sequences are independent, parsed in parallel and kept in list order*/
+  std::vector<cv::Ptr<trImgMTObj>> loaded(names.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < static_cast<int>(names.size()); i++) {
+    loaded[i] = loadSequence(rootPath, names[i]);
+  }
+  for (auto & obj : loaded) {
+    if (!obj.empty()) {
+      data.push_back(obj);
+    }
+  }
+}
+
+cv::Ptr<trImgMTObj> imgMTDataset::loadSequence(
+  const std::string & rootPath,
+  const std::string & datasetName)
+{
+  // Open dataset config file
+  std::string cfgFilePath = rootPath + "/" + datasetName + "/" + datasetName + ".yml";
+  cv::FileStorage cfgFile(cfgFilePath, cv::FileStorage::READ);
+  if (!cfgFile.isOpened()) {
+    DATASET_LOG_DEBUG("Error to open (%s)!!!\n", cfgFilePath.c_str());
+    return cv::Ptr<trImgMTObj>();
+  }
+
+  cv::Ptr<trImgMTObj> currObj(new trImgMTObj);
+
+  // Get configurations
+  currObj->attr.startFrame = static_cast<int>(cfgFile["start"]);
+  currObj->attr.countBytes = static_cast<int>(cfgFile["count_bytes"]);
+  currObj->attr.prefix = static_cast<std::string>(cfgFile["prefix"]);
+  currObj->attr.suffix = static_cast<std::string>(cfgFile["suffix"]);
+  currObj->gt_file = static_cast<std::string>(cfgFile["gt_file"]);
+  currObj->det_file = static_cast<std::string>(cfgFile["det_file"]);
+
+  std::string gtListPath = rootPath + "/" + datasetName + "/" + currObj->gt_file;
+  std::string detListPath = rootPath + "/" + datasetName + "/" + currObj->det_file;
+  std::string cachePath = rootPath + "/" + datasetName + "/" + datasetName + ".boxcache";
+  std::vector<std::string> sources = {cfgFilePath, gtListPath, detListPath};
+  if (!BoxCache::load(cachePath, sources, currObj->gtbb, currObj->detbb)) {
+    if (!parseBoxes(gtListPath, detListPath, *currObj)) {
+      return cv::Ptr<trImgMTObj>();
+    }
+    if (!BoxCache::save(cachePath, sources, currObj->gtbb, currObj->detbb)) {
+      DATASET_LOG_DEBUG("Error to write (%s)!!!\n", cachePath.c_str());
+    }
+  }
+
+  int currFrameID = currObj->attr.startFrame;
+  while (true) {
+    std::string fullPath = rootPath + "/" + datasetName + "/img/" + currObj->attr.prefix +
+      numberToString(currFrameID, currObj->attr.countBytes) + currObj->attr.suffix;
+    if (!fileExists(fullPath)) {break;}
+
+    // Make images Object
+    currObj->imagePath.push_back(fullPath);
+    currFrameID++;
+  }
+
+  currObj->dsName = datasetName;
+  currObj->attr.frameCount = currFrameID - currObj->attr.startFrame;
+  return currObj;
+}
+
+/* boxes of the frames of a PETS style list, centers converted to corners*/
+static void parseFrames(
+  const cv::FileNode & root, bool detections,
+  std::vector<std::vector<Obj_>> & frames)
+{
+  for (cv::FileNodeIterator it = root.begin(); it != root.end(); it++) {
+    cv::FileNode obj_node = (*it)["objectlist"]["object"];
+    std::vector<Obj_> obj_vec;
+    for (cv::FileNodeIterator obj_it = obj_node.begin(); obj_it != obj_node.end(); obj_it++) {
+      float h = static_cast<float>((*obj_it)["box"]["h"]);
+      float w = static_cast<float>((*obj_it)["box"]["w"]);
+      float x = static_cast<float>((*obj_it)["box"]["xc"]) - w / 2;
+      float y = static_cast<float>((*obj_it)["box"]["yc"]) - h / 2;
+      Obj_ obj = {0, cv::Rect2d(x, y, w, h), 1.0f};
+      if (detections) {
+        obj.confidence = static_cast<float>((*obj_it)["confidence"]);
+      } else {
+        obj.objIdx = static_cast<int>((*obj_it)["id"]);
+      }
+      obj_vec.push_back(obj);
+    }
+    frames.push_back(obj_vec);
+  }
+}
+
+bool imgMTDataset::parseBoxes(
+  const std::string & gtListPath, const std::string & detListPath,
+  trImgMTObj & seq)
+{
+  // Open dataset's ground truth file
+  cv::FileStorage gtList(gtListPath, cv::FileStorage::READ);
+  if (!gtList.isOpened()) {
+    DATASET_LOG_DEBUG("Error to open (%s)!!!\n", gtListPath.c_str());
+    return false;
+  }
+
+  // Open dataset's detection file
+  cv::FileStorage detList(detListPath, cv::FileStorage::READ);
+  if (!detList.isOpened()) {
+    DATASET_LOG_DEBUG("Error to open (%s)!!!\n", detListPath.c_str());
+    return false;
+  }
+
+  parseFrames(gtList["dataset"]["frame"], false, seq.gtbb);
+  parseFrames(detList["dataset"]["frame"], true, seq.detbb);
+  return true;
+}
+
+int imgMTDataset::getDatasetsNum() {return static_cast<int>(data.size());}
+
+std::string imgMTDataset::getDatasetName(int id)
+{
+  if (id > 0 && id <= static_cast<int>(data.size())) {
+    return data[id - 1]->dsName;
+  }
+  return "";
+}
+
+int imgMTDataset::getDatasetLength(int id)
+{
+  if (id > 0 && id <= static_cast<int>(data.size())) {
+    return static_cast<int>(data[id - 1]->attr.frameCount);
+  } else {
+    DATASET_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
+      static_cast<int>(data.size()));
+    return -1;
+  }
+}
+
+bool imgMTDataset::initDataset(std::string dsName)
+{
+  int id = 0;
+  frameIdx = 0;
+
+  for (auto t : data) {
+    id++;
+    if (t->dsName == dsName) {break;}
+  }
+
+  if (id > 0 && id <= static_cast<int>(data.size())) {
+    activeDatasetID = id;
+    if (prefetcher) {
+      prefetcher->start(data[id - 1]->imagePath);
+    }
+    return true;
+  } else {
+    DATASET_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
+      static_cast<int>(data.size()));
+    return false;
+  }
+}
+
+bool imgMTDataset::getNextFrame(cv::Mat & frame)
+{
+  if (frameIdx >= static_cast<int>(data[activeDatasetID - 1]->attr.frameCount)) {
+    return false;
+  }
+  if (prefetcher) {
+    frameIdx++;
+    return prefetcher->next(frame);
+  }
+  std::string imgPath = data[activeDatasetID - 1]->imagePath[frameIdx];
+  frame = cv::imread(imgPath);
+  frameIdx++;
+  return !frame.empty();
+}
+
+bool imgMTDataset::getIdxFrame(cv::Mat & frame, int idx)
+{
+  if (idx >= static_cast<int>(data[activeDatasetID - 1]->attr.frameCount)) {
+    return false;
+  }
+
+  std::string imgPath = data[activeDatasetID - 1]->imagePath[idx - 1];
+  frame = cv::imread(imgPath);
+  return !frame.empty();
+}
+
+std::vector<std::vector<Obj_>> imgMTDataset::getGT()
+{
+  return data[activeDatasetID - 1]->gtbb;
+}
+
+std::vector<Obj_> imgMTDataset::getIdxGT(int idx)
+{
+  cv::Ptr<trImgMTObj> currObj = data[activeDatasetID - 1];
+  if (idx < 1 || idx > static_cast<int>(currObj->gtbb.size())) {
+    return std::vector<Obj_>();
+  }
+  return currObj->gtbb[idx - 1];
+}
+
+std::vector<Obj_> imgMTDataset::getIdxDet(int idx)
+{
+  cv::Ptr<trImgMTObj> currObj = data[activeDatasetID - 1];
+  if (idx < 1 || idx > static_cast<int>(currObj->detbb.size())) {
+    return std::vector<Obj_>();
+  }
+  return currObj->detbb[idx - 1];
+}
+
+}  // namespace datasets
@@ -13,13 +13,12 @@
 // limitations under the License.
 
 #include <opencv2/highgui.hpp>
-#include <cv_bridge/cv_bridge.h>
 #include <omp.h>
 #include <fstream>
 #include <string>
 #include <vector>
 #include "object_analytics_node/dataset/track_dataset.hpp"
-#include "rcutils/logging_macros.h"
+#include "object_analytics_node/dataset/dataset_log.hpp"
 
 namespace datasets
 {
@@ -28,75 +27,97 @@ void imgDataset::load(const std::string & rootPath)
 {
   std::string nameListPath = rootPath + "/list.txt";
   std::ifstream namesList(nameListPath.c_str());
-  std::string datasetName;
-
-  if (namesList.is_open()) {
-    int currDatasetID = 0;
-
-    // All datasets/folders loop
-    while (getline(namesList, datasetName)) {
-      // Open dataset's ground truth file
-      std::string gtListPath =
-        rootPath + "/" + datasetName + "/groundtruth_rect.txt";
-      std::ifstream gtList(gtListPath.c_str());
-      if (!gtList.is_open()) {
-        RCUTILS_LOG_DEBUG("Error to open (%s)!!!\n", gtListPath.c_str());
-        continue;
-      }
-
-      cv::Ptr<trImgObj> currObj(new trImgObj);
-
-      int currFrameID = 0;
-      if (currDatasetID == 0) {RCUTILS_LOG_DEBUG("Dataset Initialization...\n");}
-      bool trFLG = true;
-      do {
-        currFrameID++;
-        std::string fullPath = rootPath + "/" + datasetName + "/img/" +
-          numberToString(currFrameID) + ".jpg";
-        if (!fileExists(fullPath)) {break;}
-
-        // Make images Object
-        currObj->imagePath.push_back(fullPath);
-
-        // Get Ground Truth data
-        cv::Rect2d gt(0, 0, 0, 0);
-        std::string tmp;
-        getline(gtList, tmp);
-        int ret =
-          sscanf(tmp.c_str(), "%lf%*[ \t,]%lf%*[ \t,]%lf%*[ \t,]%lf%*[ \t,]",
-            &gt.x, &gt.y, &gt.width, &gt.height);
-        if (ret > 0) {
-          currObj->gtbb.push_back(gt);
-        } else {
-          break;
-        }
-      } while (trFLG);
-
-      gtList.close();
-
-      currObj->dsName = datasetName;
-      // TBD: get attributions from YAML config file
-      currObj->attr.frameCount = currFrameID;
-      currObj->attr.startFrame = 1;
-
-      data.push_back(currObj);
-      currDatasetID++;
+  if (!namesList.is_open()) {
+    DATASET_LOG_DEBUG("Couldn't find a *list.txt* in folder!!!");
+    return;
+  }
+  std::vector<std::string> names;
+  for (std::string datasetName; getline(namesList, datasetName);) {
+    names.push_back(datasetName);
+  }
+  namesList.close();
+
+  DATASET_LOG_DEBUG("Dataset Initialization...\n");
+  /* sequences are independent, parsed in parallel and kept in list order*/
+  std::vector<cv::Ptr<trImgObj>> loaded(names.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < static_cast<int>(names.size()); i++) {
+    loaded[i] = loadSequence(rootPath, names[i]);
+  }
+  for (auto & obj : loaded) {
+    if (!obj.empty()) {
+      data.push_back(obj);
     }
-  } else {
-    RCUTILS_LOG_DEBUG("Couldn't find a *list.txt* in folder!!!");
   }
+}
 
-  namesList.close();
+cv::Ptr<trImgObj> imgDataset::loadSequence(
+  const std::string & rootPath,
+  const std::string & datasetName)
+{
+  // Open dataset's ground truth file
+  std::string gtListPath =
+    rootPath + "/" + datasetName + "/groundtruth_rect.txt";
+  std::ifstream gtList(gtListPath.c_str());
+  if (!gtList.is_open()) {
+    DATASET_LOG_DEBUG("Error to open (%s)!!!\n", gtListPath.c_str());
+    return cv::Ptr<trImgObj>();
+  }
+
+  cv::Ptr<trImgObj> currObj(new trImgObj);
+
+  int currFrameID = 0;
+  bool trFLG = true;
+  do {
+    currFrameID++;
+    std::string fullPath = rootPath + "/" + datasetName + "/img/" +
+      numberToString(currFrameID) + ".jpg";
+    if (!fileExists(fullPath)) {break;}
+
+    // Make images Object
+    currObj->imagePath.push_back(fullPath);
+
+    // Get Ground Truth data
+    Obj_ obj = {0, cv::Rect2d(0, 0, 0, 0), 1.0f};
+    std::string tmp;
+    getline(gtList, tmp);
+    int ret =
+      sscanf(tmp.c_str(), "%lf%*[ \t,]%lf%*[ \t,]%lf%*[ \t,]%lf%*[ \t,]",
+        &obj.bb.x, &obj.bb.y, &obj.bb.width, &obj.bb.height);
+    if (ret > 0) {
+      currObj->gtbb.push_back(std::vector<Obj_>(1, obj));
+    } else {
+      break;
+    }
+  } while (trFLG);
+
+  gtList.close();
+
+  currObj->dsName = datasetName;
+  // TBD: get attributions from YAML config file
+  currObj->attr.frameCount = currFrameID;
+  currObj->attr.startFrame = 1;
+  return currObj;
 }
 
 int imgDataset::getDatasetsNum() {return static_cast<int>(data.size());}
 
+std::string imgDataset::getDatasetName(int id)
+{
+  if (id > 0 && id <= static_cast<int>(data.size())) {
+    return data[id - 1]->dsName;
+  }
+  return "";
+}
+
 int imgDataset::getDatasetLength(int id)
 {
   if (id > 0 && id <= static_cast<int>(data.size())) {
     return static_cast<int>(data[id - 1]->attr.frameCount);
   } else {
-    RCUTILS_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
+    DATASET_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
       static_cast<int>(data.size()));
     return -1;
   }
@@ -114,9 +135,12 @@ bool imgDataset::initDataset(std::string dsName)
 
   if (id > 0 && id <= static_cast<int>(data.size())) {
     activeDatasetID = id;
+    if (prefetcher) {
+      prefetcher->start(data[id - 1]->imagePath);
+    }
     return true;
   } else {
-    RCUTILS_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
+    DATASET_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
       static_cast<int>(data.size()));
     return false;
   }
@@ -127,6 +151,10 @@ bool imgDataset::getNextFrame(cv::Mat & frame)
   if (frameIdx >= static_cast<int>(data[activeDatasetID - 1]->attr.frameCount)) {
     return false;
   }
+  if (prefetcher) {
+    frameIdx++;
+    return prefetcher->next(frame);
+  }
   std::string imgPath = data[activeDatasetID - 1]->imagePath[frameIdx];
   frame = cv::imread(imgPath);
   frameIdx++;
@@ -144,12 +172,12 @@ bool imgDataset::getIdxFrame(cv::Mat & frame, int idx)
   return !frame.empty();
 }
 
-std::vector<cv::Rect2d> imgDataset::getGT()
+std::vector<std::vector<Obj_>> imgDataset::getGT()
 {
   return data[activeDatasetID - 1]->gtbb;
 }
 
-cv::Rect2d imgDataset::getIdxGT(int idx)
+std::vector<Obj_> imgDataset::getIdxGT(int idx)
 {
   cv::Ptr<trImgObj> currObj = data[activeDatasetID - 1];
   return currObj->gtbb[idx - currObj->attr.startFrame];
@@ -0,0 +1,302 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "object_analytics_node/dataset/track_dataset.hpp"
+#include "object_analytics_node/dataset/dataset_log.hpp"
+
+namespace datasets
+{
+
+const uint32_t packDataset::kMagic = 0x4b50414f;  // "OAPK"
+const uint32_t packDataset::kVersion = 2;
+
+/* frames start on a page, so that each is mapped from an aligned offset*/
+static const uint64_t kPackAlign = 4096;
+
+/* header of a pack file, followed by the table of sequences*/
+struct PackHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t count;
+};
+
+/* boxes of a frame, a range of the boxes of the sequence*/
+struct PackSpan
+{
+  uint32_t offset;
+  uint32_t count;
+};
+
+struct PackBox
+{
+  int32_t objIdx;
+  float confidence;
+  double x, y, width, height;
+};
+
+static std::vector<Obj_> unpackBoxes(const uint8_t * map, const PackSpan & span, uint64_t offset)
+{
+  const PackBox * boxes = reinterpret_cast<const PackBox *>(map + offset) + span.offset;
+  std::vector<Obj_> objs(span.count);
+  for (uint32_t i = 0; i < span.count; i++) {
+    objs[i] = {boxes[i].objIdx, cv::Rect2d(boxes[i].x, boxes[i].y, boxes[i].width,
+        boxes[i].height), boxes[i].confidence};
+  }
+  return objs;
+}
+
+packDataset::~packDataset()
+{
+  unmap();
+}
+
+void packDataset::unmap()
+{
+  if (map_ != nullptr) {
+    munmap(map_, mapBytes_);
+    map_ = nullptr;
+    mapBytes_ = 0;
+  }
+  data.clear();
+}
+
+void packDataset::load(const std::string & rootPath)
+{
+  unmap();
+  activeDatasetID = 1;
+  frameIdx = 0;
+
+  int fd = open(rootPath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    DATASET_LOG_DEBUG("Couldn't open pack file (%s)!!!\n", rootPath.c_str());
+    return;
+  }
+  struct stat buffer;
+  if (fstat(fd, &buffer) != 0 || buffer.st_size < static_cast<off_t>(sizeof(PackHeader))) {
+    close(fd);
+    return;
+  }
+  /* private and writable, a frame modified by its consumer is copied*/
+  void * map = mmap(nullptr, buffer.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    DATASET_LOG_DEBUG("Couldn't map pack file (%s)!!!\n", rootPath.c_str());
+    return;
+  }
+  madvise(map, buffer.st_size, MADV_SEQUENTIAL);
+  map_ = static_cast<uint8_t *>(map);
+  mapBytes_ = buffer.st_size;
+
+  PackHeader header;
+  memcpy(&header, map_, sizeof(header));
+  size_t table = sizeof(header) + header.count * sizeof(Sequence);
+  if (header.magic != kMagic || header.version != kVersion || table > mapBytes_) {
+    DATASET_LOG_DEBUG("Invalid pack file (%s)!!!\n", rootPath.c_str());
+    unmap();
+    return;
+  }
+  data.resize(header.count);
+  memcpy(data.data(), map_ + sizeof(header), header.count * sizeof(Sequence));
+  for (auto & s : data) {
+    s.name[sizeof(s.name) - 1] = '\0';
+    if (s.frameOffset + s.frameCount * s.frameBytes > mapBytes_ ||
+      s.gtOffset + s.frameCount * sizeof(PackSpan) > mapBytes_ ||
+      s.boxOffset + s.boxCount * sizeof(PackBox) > mapBytes_)
+    {
+      DATASET_LOG_DEBUG("Truncated pack file (%s)!!!\n", rootPath.c_str());
+      unmap();
+      return;
+    }
+  }
+}
+
+int packDataset::getDatasetsNum() {return static_cast<int>(data.size());}
+
+std::string packDataset::getDatasetName(int id)
+{
+  if (id > 0 && id <= static_cast<int>(data.size())) {
+    return data[id - 1].name;
+  }
+  return "";
+}
+
+int packDataset::getDatasetLength(int id)
+{
+  if (id > 0 && id <= static_cast<int>(data.size())) {
+    return data[id - 1].frameCount;
+  } else {
+    DATASET_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
+      static_cast<int>(data.size()));
+    return -1;
+  }
+}
+
+bool packDataset::initDataset(std::string dsName)
+{
+  for (size_t i = 0; i < data.size(); i++) {
+    if (dsName == data[i].name) {
+      activeDatasetID = static_cast<int>(i) + 1;
+      frameIdx = data[i].startFrame;
+      return true;
+    }
+  }
+  DATASET_LOG_DEBUG("Dataset (%s) is not in the pack\n", dsName.c_str());
+  return false;
+}
+
+bool packDataset::frameAt(int idx, cv::Mat & frame)
+{
+  const Sequence & s = data[activeDatasetID - 1];
+  int pos = idx - s.startFrame;
+  if (pos < 0 || pos >= s.frameCount) {
+    return false;
+  }
+  frame = cv::Mat(s.rows, s.cols, s.type, map_ + s.frameOffset + pos * s.frameBytes);
+  return true;
+}
+
+bool packDataset::getNextFrame(cv::Mat & frame)
+{
+  if (data.empty() || !frameAt(frameIdx, frame)) {
+    return false;
+  }
+  frameIdx++;
+  return true;
+}
+
+bool packDataset::getIdxFrame(cv::Mat & frame, int idx)
+{
+  return !data.empty() && frameAt(idx, frame);
+}
+
+std::vector<std::vector<Obj_>> packDataset::getGT()
+{
+  const Sequence & s = data[activeDatasetID - 1];
+  const PackSpan * spans = reinterpret_cast<const PackSpan *>(map_ + s.gtOffset);
+  std::vector<std::vector<Obj_>> gtbb(s.frameCount);
+  for (int i = 0; i < s.frameCount; i++) {
+    gtbb[i] = unpackBoxes(map_, spans[i], s.boxOffset);
+  }
+  return gtbb;
+}
+
+std::vector<Obj_> packDataset::getIdxGT(int idx)
+{
+  const Sequence & s = data[activeDatasetID - 1];
+  int pos = idx - s.startFrame;
+  if (pos < 0 || pos >= s.frameCount) {
+    return std::vector<Obj_>();
+  }
+  const PackSpan * spans = reinterpret_cast<const PackSpan *>(map_ + s.gtOffset);
+  return unpackBoxes(map_, spans[pos], s.boxOffset);
+}
+
+bool packDataset::write(
+  trDataset & ds, const std::vector<std::string> & names,
+  const std::string & file)
+{
+  std::vector<std::string> seqs = names;
+  if (seqs.empty()) {
+    for (int i = 1; i <= ds.getDatasetsNum(); i++) {
+      seqs.push_back(ds.getDatasetName(i));
+    }
+  }
+
+  std::ofstream of(file, std::ios::binary | std::ios::trunc);
+  if (!of.is_open()) {
+    DATASET_LOG_ERROR("failed to open %s\n", file.c_str());
+    return false;
+  }
+
+  /* the table is written last, once the offsets are known*/
+  PackHeader header = {kMagic, kVersion, seqs.size()};
+  std::vector<Sequence> table(seqs.size());
+  uint64_t offset = sizeof(header) + table.size() * sizeof(Sequence);
+  std::vector<char> zeros(std::max<uint64_t>(offset, kPackAlign), 0);
+  of.write(zeros.data(), offset);
+
+  for (size_t i = 0; i < seqs.size(); i++) {
+    Sequence & s = table[i];
+    memset(&s, 0, sizeof(s));
+    if (seqs[i].size() >= sizeof(s.name) || !ds.initDataset(seqs[i])) {
+      DATASET_LOG_ERROR("failed to pack dataset %s\n", seqs[i].c_str());
+      return false;
+    }
+    strncpy(s.name, seqs[i].c_str(), sizeof(s.name) - 1);
+    s.startFrame = ds.getFrameIdx();
+
+    uint64_t pad = (kPackAlign - offset % kPackAlign) % kPackAlign;
+    of.write(zeros.data(), pad);
+    offset += pad;
+    s.frameOffset = offset;
+
+    std::vector<PackSpan> spans;
+    std::vector<PackBox> boxes;
+    cv::Mat frame;
+    while (ds.getNextFrame(frame)) {
+      if (s.frameCount == 0) {
+        s.rows = frame.rows;
+        s.cols = frame.cols;
+        s.type = frame.type();
+        s.frameBytes = frame.total() * frame.elemSize();
+      } else if (frame.rows != s.rows || frame.cols != s.cols || frame.type() != s.type) {
+        DATASET_LOG_ERROR("frames of dataset %s differ in size\n", seqs[i].c_str());
+        return false;
+      }
+      if (frame.isContinuous()) {
+        of.write(reinterpret_cast<const char *>(frame.data), s.frameBytes);
+      } else {
+        for (int r = 0; r < frame.rows; r++) {
+          of.write(reinterpret_cast<const char *>(frame.ptr(r)), frame.cols * frame.elemSize());
+        }
+      }
+      std::vector<Obj_> gt = ds.getIdxGT(ds.getFrameIdx() - 1);
+      spans.push_back({static_cast<uint32_t>(boxes.size()), static_cast<uint32_t>(gt.size())});
+      for (auto & o : gt) {
+        boxes.push_back({o.objIdx, o.confidence, o.bb.x, o.bb.y, o.bb.width, o.bb.height});
+      }
+      s.frameCount++;
+    }
+    offset += s.frameCount * s.frameBytes;
+
+    /* boxes hold doubles, aligned to them*/
+    pad = (sizeof(double) - offset % sizeof(double)) % sizeof(double);
+    of.write(zeros.data(), pad);
+    offset += pad;
+    s.gtOffset = offset;
+    of.write(reinterpret_cast<const char *>(spans.data()), spans.size() * sizeof(PackSpan));
+    offset += spans.size() * sizeof(PackSpan);
+    s.boxOffset = offset;
+    s.boxCount = boxes.size();
+    of.write(reinterpret_cast<const char *>(boxes.data()), boxes.size() * sizeof(PackBox));
+    offset += boxes.size() * sizeof(PackBox);
+    DATASET_LOG_INFO("packed %s, %d frames\n", s.name, s.frameCount);
+  }
+
+  of.seekp(0);
+  of.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  of.write(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(Sequence));
+  return of.good();
+}
+
+}  // namespace datasets
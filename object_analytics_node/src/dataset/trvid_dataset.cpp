@@ -12,13 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <cv_bridge/cv_bridge.h>
 #include <omp.h>
 #include <fstream>
 #include <string>
 #include <vector>
 #include "object_analytics_node/dataset/track_dataset.hpp"
-#include "rcutils/logging_macros.h"
+#include "object_analytics_node/dataset/dataset_log.hpp"
 
 namespace datasets
 {
@@ -44,18 +43,18 @@ void vidDataset::load(const std::string & rootPath)
       std::string gtListPath = rootPath + "/" + datasetName + "/gt.txt";
       std::ifstream gtList(gtListPath.c_str());
       if (!gtList.is_open()) {
-        RCUTILS_LOG_DEBUG("Error to open (%s)!!!\n", gtListPath.c_str());
+        DATASET_LOG_DEBUG("Error to open (%s)!!!\n", gtListPath.c_str());
         continue;
       }
 
       if (currDatasetID == 0) {
-        RCUTILS_LOG_DEBUG("Video Dataset Initialization...\n");
+        DATASET_LOG_DEBUG("Video Dataset Initialization...\n");
       }
 
       std::string fullPath =
         rootPath + "/" + datasetName + "/data/" + datasetName + ".webm";
       if (!fileExists(fullPath)) {
-        RCUTILS_LOG_DEBUG("vid(%s) file is not exist\n", fullPath.c_str());
+        DATASET_LOG_DEBUG("vid(%s) file is not exist\n", fullPath.c_str());
         continue;
       }
 
@@ -64,7 +63,7 @@ void vidDataset::load(const std::string & rootPath)
         rootPath + "/" + datasetName + "/" + datasetName + ".yml";
       cv::FileStorage cfgFile(cfgFilePath, cv::FileStorage::READ);
       if (!cfgFile.isOpened()) {
-        RCUTILS_LOG_DEBUG("Error to open (%s)!!!\n", cfgFilePath.c_str());
+        DATASET_LOG_DEBUG("Error to open (%s)!!!\n", cfgFilePath.c_str());
         continue;
       }
 
@@ -76,13 +75,13 @@ void vidDataset::load(const std::string & rootPath)
       bool trFLG = true;
       do {
         // Get Ground Truth data
-        cv::Rect2d gt(0, 0, 0, 0);
+        Obj_ obj = {0, cv::Rect2d(0, 0, 0, 0), 1.0f};
         std::string tmp;
         getline(gtList, tmp);
-        int ret = sscanf(tmp.c_str(), "%lf,%lf,%lf,%lf", &gt.x, &gt.y,
-            &gt.width, &gt.height);
+        int ret = sscanf(tmp.c_str(), "%lf,%lf,%lf,%lf", &obj.bb.x, &obj.bb.y,
+            &obj.bb.width, &obj.bb.height);
         if (ret > 0) {
-          currObj->gtbb.push_back(gt);
+          currObj->gtbb.push_back(std::vector<Obj_>(1, obj));
           currFrameID++;
         } else {
           break;
@@ -103,7 +102,7 @@ void vidDataset::load(const std::string & rootPath)
       currDatasetID++;
     }
   } else {
-    RCUTILS_LOG_DEBUG("Couldn't find a *list.txt* in video dataset!!!");
+    DATASET_LOG_DEBUG("Couldn't find a *list.txt* in video dataset!!!");
   }
 
   activeDatasetID = 1;
@@ -112,12 +111,20 @@ void vidDataset::load(const std::string & rootPath)
 
 int vidDataset::getDatasetsNum() {return static_cast<int>(data.size());}
 
+std::string vidDataset::getDatasetName(int id)
+{
+  if (id > 0 && id <= static_cast<int>(data.size())) {
+    return data[id - 1]->dsName;
+  }
+  return "";
+}
+
 int vidDataset::getDatasetLength(int id)
 {
   if (id > 0 && id <= static_cast<int>(data.size())) {
     return static_cast<int>(data[id - 1]->attr.frameCount);
   } else {
-    RCUTILS_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
+    DATASET_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
       static_cast<int>(data.size()));
     return -1;
   }
@@ -138,15 +145,23 @@ bool vidDataset::initDataset(std::string dsName)
 
     cap.open(trObj->vidPath);
     if (!cap.isOpened()) {
-      RCUTILS_LOG_DEBUG("Failed to open video filei\n");
+      DATASET_LOG_DEBUG("Failed to open video filei\n");
+      return false;
+    }
+    seekCap.release();
+    size_t pos = 0;
+    if (!index.open(trObj->vidPath)) {
+      DATASET_LOG_DEBUG("Failed to index video, seeking by frame\n");
+      cap.set(cv::CAP_PROP_POS_FRAMES, trObj->attr.startFrame);
+    } else if (!index.seek(cap, pos, trObj->attr.startFrame)) {
+      DATASET_LOG_DEBUG("Failed to seek video to frame %d\n", trObj->attr.startFrame);
       return false;
     }
-    cap.set(cv::CAP_PROP_POS_FRAMES, trObj->attr.startFrame);
 
     frameIdx = trObj->attr.startFrame;
     return true;
   } else {
-    RCUTILS_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
+    DATASET_LOG_DEBUG("Dataset ID is out of range...\nAllowed IDs are: 1~%d\n",
       static_cast<int>(data.size()));
     return false;
   }
@@ -165,19 +180,26 @@ bool vidDataset::getIdxFrame(cv::Mat & frame, int idx)
 {
   if (idx >= static_cast<int>(data[activeDatasetID - 1]->attr.frameCount)) {return false;}
 
-  cap.set(cv::CAP_PROP_POS_FRAMES, idx);
-  cap >> frame;
-  cap.set(cv::CAP_PROP_POS_FRAMES, frameIdx);
+  if (index.size() == 0) {
+    cap.set(cv::CAP_PROP_POS_FRAMES, idx);
+    cap >> frame;
+    cap.set(cv::CAP_PROP_POS_FRAMES, frameIdx);
+    return !frame.empty();
+  }
 
-  return !frame.empty();
+  if (!seekCap.isOpened()) {
+    seekCap.open(data[activeDatasetID - 1]->vidPath);
+    seekPos = 0;
+  }
+  return index.read(seekCap, seekPos, static_cast<size_t>(idx), frame);
 }
 
-std::vector<cv::Rect2d> vidDataset::getGT()
+std::vector<std::vector<Obj_>> vidDataset::getGT()
 {
   return data[activeDatasetID - 1]->gtbb;
 }
 
-cv::Rect2d vidDataset::getIdxGT(int idx)
+std::vector<Obj_> vidDataset::getIdxGT(int idx)
 {
   cv::Ptr<trVidObj> currObj = data[activeDatasetID - 1];
   return currObj->gtbb[idx - currObj->attr.startFrame];
@@ -0,0 +1,190 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <sys/stat.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "object_analytics_node/dataset/video_index.hpp"
+
+namespace datasets
+{
+
+const uint32_t VideoIndex::kMagic = 0x4956414f;  // "OAVI"
+const uint32_t VideoIndex::kVersion = 1;
+const size_t VideoIndex::kMaxForward = 64;
+
+bool VideoIndex::open(const std::string & video_path)
+{
+  msec_.clear();
+  std::string cache = getCachePath(video_path);
+  if (load(cache)) {
+    return true;
+  }
+
+  cv::VideoCapture cap(video_path);
+  if (!cap.isOpened() || !build(cap)) {
+    return false;
+  }
+  stat(video_path, bytes_, mtime_);
+  /* a read-only dataset is indexed again on the next open*/
+  save(cache);
+  return true;
+}
+
+bool VideoIndex::build(cv::VideoCapture & cap)
+{
+  msec_.clear();
+  /* grab() decodes without converting the frame*/
+  while (cap.grab()) {
+    msec_.push_back(cap.get(cv::CAP_PROP_POS_MSEC));
+  }
+  return !msec_.empty();
+}
+
+bool VideoIndex::save(const std::string & path) const
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+  uint64_t count = msec_.size();
+  file.write(reinterpret_cast<const char *>(&kMagic), sizeof(kMagic));
+  file.write(reinterpret_cast<const char *>(&kVersion), sizeof(kVersion));
+  file.write(reinterpret_cast<const char *>(&bytes_), sizeof(bytes_));
+  file.write(reinterpret_cast<const char *>(&mtime_), sizeof(mtime_));
+  file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  file.write(reinterpret_cast<const char *>(msec_.data()), count * sizeof(double));
+  return file.good();
+}
+
+bool VideoIndex::load(const std::string & path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t bytes = 0;
+  int64_t mtime = 0;
+  uint64_t count = 0;
+  file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char *>(&version), sizeof(version));
+  file.read(reinterpret_cast<char *>(&bytes), sizeof(bytes));
+  file.read(reinterpret_cast<char *>(&mtime), sizeof(mtime));
+  file.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (!file.good() || magic != kMagic || version != kVersion || count == 0) {
+    return false;
+  }
+
+  /* stale if the video changed since it was indexed*/
+  uint64_t video_bytes = 0;
+  int64_t video_mtime = 0;
+  std::string video_path = path.substr(0, path.size() - getCachePath("").size());
+  if (!stat(video_path, video_bytes, video_mtime) || video_bytes != bytes ||
+    video_mtime != mtime)
+  {
+    return false;
+  }
+
+  std::vector<double> msec(count);
+  if (!file.read(reinterpret_cast<char *>(msec.data()), count * sizeof(double))) {
+    return false;
+  }
+  bytes_ = bytes;
+  mtime_ = mtime;
+  msec_.swap(msec);
+  return true;
+}
+
+size_t VideoIndex::find(double msec) const
+{
+  auto it = std::lower_bound(msec_.begin(), msec_.end(), msec);
+  if (it == msec_.end()) {
+    return msec_.size() - 1;
+  }
+  if (it != msec_.begin() && msec - *(it - 1) < *it - msec) {
+    --it;
+  }
+  return static_cast<size_t>(it - msec_.begin());
+}
+
+bool VideoIndex::seek(cv::VideoCapture & cap, size_t & pos, size_t idx) const
+{
+  if (idx >= msec_.size()) {
+    return false;
+  }
+
+  /* seek to the frame before and grab it, its stamp tells where the seek went*/
+  size_t back = 1;
+  while (true) {
+    if (idx < back) {
+      cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+      pos = 0;
+      break;
+    }
+    cap.set(cv::CAP_PROP_POS_MSEC, msec_[idx - back]);
+    if (!cap.grab()) {
+      return false;
+    }
+    pos = find(cap.get(cv::CAP_PROP_POS_MSEC)) + 1;
+    if (pos <= idx) {
+      break;
+    }
+    /* landed past the frame, further back*/
+    back *= 2;
+  }
+
+  while (pos < idx) {
+    if (!cap.grab()) {
+      return false;
+    }
+    pos++;
+  }
+  return true;
+}
+
+bool VideoIndex::read(cv::VideoCapture & cap, size_t & pos, size_t idx, cv::Mat & frame) const
+{
+  if (idx < pos || idx > pos + kMaxForward) {
+    if (!seek(cap, pos, idx)) {
+      return false;
+    }
+  }
+  while (pos < idx) {
+    if (!cap.grab()) {
+      return false;
+    }
+    pos++;
+  }
+  if (!cap.read(frame)) {
+    return false;
+  }
+  pos++;
+  return !frame.empty();
+}
+
+bool VideoIndex::stat(const std::string & path, uint64_t & bytes, int64_t & mtime)
+{
+  struct ::stat buffer;
+  if (::stat(path.c_str(), &buffer) != 0) {
+    return false;
+  }
+  bytes = static_cast<uint64_t>(buffer.st_size);
+  mtime = static_cast<int64_t>(buffer.st_mtime);
+  return true;
+}
+
+}  // namespace datasets
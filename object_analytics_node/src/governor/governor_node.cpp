@@ -0,0 +1,119 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/governor/governor_node.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+
+namespace object_analytics_node
+{
+namespace governor
+{
+GovernorNode::GovernorNode(rclcpp::NodeOptions options)
+: Node("GovernorNode", options)
+{
+  using util::QosProfiles;
+  LoadGovernor::Options opts;
+  opts.target_ms = declare_parameter<double>("latency_target_ms", opts.target_ms);
+  opts.risk = declare_parameter<double>("risk_ratio", opts.risk);
+  opts.headroom = std::min(opts.risk, declare_parameter<double>("headroom_ratio", opts.headroom));
+  opts.max_level = std::max(0, declare_parameter<int32_t>("max_level", opts.max_level));
+  opts.up_periods = std::max(1, declare_parameter<int32_t>("up_periods", opts.up_periods));
+  opts.settle_periods = std::max(0,
+      declare_parameter<int32_t>("settle_periods", opts.settle_periods));
+  opts.queue_limit = static_cast<uint32_t>(std::max(0,
+      declare_parameter<int32_t>("queue_limit", 0)));
+  governor_ = LoadGovernor(opts);
+  latency_stages_ = declare_parameter<std::vector<std::string>>("latency_stages",
+      std::vector<std::string>({"splitter.split", "segmenter.segment", "tracker.track"}));
+  queues_ = declare_parameter<std::vector<std::string>>("queues", std::vector<std::string>());
+  int32_t period_ms = std::max(10, declare_parameter<int32_t>("period_ms", 1000));
+
+  pub_ = create_publisher<object_analytics_msgs::msg::QualityLevel>(Const::kTopicQualityLevel,
+      QosProfiles::declare(this, "quality_level", QosProfiles::kReliable));
+  sub_stats_ = create_subscription<object_analytics_msgs::msg::PipelineStats>(
+    Const::kTopicPipelineStats,
+    [this](const object_analytics_msgs::msg::PipelineStats::SharedPtr stats) {onStats(*stats);},
+    QosProfiles::declare(this, "pipeline_stats", QosProfiles::kReliable));
+  sub_trace_ = create_subscription<object_analytics_msgs::msg::FrameTrace>(
+    Const::kTopicFrameTrace,
+    [this](const object_analytics_msgs::msg::FrameTrace::SharedPtr trace) {onTrace(*trace);},
+    QosProfiles::declare(this, "frame_trace", QosProfiles::kReliable));
+  timer_ = create_wall_timer(std::chrono::milliseconds(period_ms), [this]() {decide();});
+}
+
+void GovernorNode::onStats(const object_analytics_msgs::msg::PipelineStats & stats)
+{
+  for (auto & s : stats.stages) {
+    if (std::find(latency_stages_.begin(), latency_stages_.end(), s.name) !=
+      latency_stages_.end())
+    {
+      /* a stage idle over the period reports no latency*/
+      stage_ms_[s.name] = s.count > 0 ? s.mean_ms : 0.;
+    }
+  }
+  for (size_t i = 0; i < stats.queue_names.size() && i < stats.queue_depths.size(); i++) {
+    if (std::find(queues_.begin(), queues_.end(), stats.queue_names[i]) != queues_.end()) {
+      queue_depths_[stats.queue_names[i]] = stats.queue_depths[i];
+    }
+  }
+}
+
+void GovernorNode::onTrace(const object_analytics_msgs::msg::FrameTrace & trace)
+{
+  double age_ms = (rclcpp::Time(trace.published) - rclcpp::Time(trace.header.stamp)).seconds() *
+    1e3;
+  trace_ms_ = std::max(trace_ms_, age_ms);
+}
+
+void GovernorNode::decide()
+{
+  double latency_ms = trace_ms_;
+  if (latency_ms <= 0) {
+    for (auto & s : stage_ms_) {
+      latency_ms += s.second;
+    }
+  }
+  uint32_t depth = 0;
+  for (auto & q : queue_depths_) {
+    depth = std::max(depth, q.second);
+  }
+  trace_ms_ = 0;
+
+  int32_t level = governor_.getLevel();
+  governor_.update(latency_ms, depth);
+  if (governor_.getLevel() != level) {
+    RCLCPP_INFO(get_logger(), "quality level %d -> %d, latency %.1fms of %.1fms, queue %u",
+      level, governor_.getLevel(), latency_ms, governor_.getOptions().target_ms, depth);
+  }
+  object_analytics_msgs::msg::QualityLevel msg;
+  msg.header.stamp = now();
+  msg.level = governor_.getLevel();
+  msg.max_level = governor_.getOptions().max_level;
+  msg.latency_ms = latency_ms;
+  msg.target_ms = governor_.getOptions().target_ms;
+  pub_->publish(msg);
+}
+
+}  // namespace governor
+}  // namespace object_analytics_node
+
+RCLCPP_COMPONENTS_REGISTER_NODE(object_analytics_node::governor::GovernorNode)
@@ -0,0 +1,64 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "object_analytics_node/governor/load_governor.hpp"
+
+namespace object_analytics_node
+{
+namespace governor
+{
+LoadGovernor::Options::Options()
+: target_ms(100.0), risk(0.9), headroom(0.6), max_level(4), up_periods(5), settle_periods(2),
+  queue_limit(0)
+{
+}
+
+LoadGovernor::LoadGovernor(const Options & options)
+: options_(options), level_(0), calm_(0), settle_(0), steps_(0)
+{
+}
+
+int32_t LoadGovernor::update(double latency_ms, uint32_t queue_depth)
+{
+  bool queued = options_.queue_limit > 0 && queue_depth >= options_.queue_limit;
+  if (latency_ms <= 0 && !queued) {
+    return level_;
+  }
+  /* the previous step takes a while to show in the latency*/
+  if (settle_ > 0) {
+    settle_--;
+    return level_;
+  }
+  if (queued || latency_ms > options_.target_ms * options_.risk) {
+    calm_ = 0;
+    if (level_ < options_.max_level) {
+      level_++;
+      settle_ = options_.settle_periods;
+      steps_++;
+    }
+  } else if (latency_ms < options_.target_ms * options_.headroom) {
+    if (++calm_ >= options_.up_periods && level_ > 0) {
+      level_--;
+      calm_ = 0;
+      settle_ = options_.settle_periods;
+      steps_++;
+    }
+  } else {
+    calm_ = 0;
+  }
+  return level_;
+}
+
+}  // namespace governor
+}  // namespace object_analytics_node
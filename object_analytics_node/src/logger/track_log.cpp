@@ -0,0 +1,381 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "object_analytics_node/logger/track_log.hpp"
+#include "object_analytics_node/util/class_table.hpp"
+
+namespace object_analytics_node
+{
+namespace logger
+{
+const uint32_t TrackLog::kMagic = 0x4c54414f;  // "OATL"
+const uint32_t TrackLog::kVersion = 1;
+const size_t TrackLog::kBlockRows = 4096;
+const size_t TrackLog::kMaxPendingBlocks = 16;
+
+namespace
+{
+/* header of a track log file*/
+struct FileHeader
+{
+  uint32_t magic;
+  uint32_t version;
+};
+
+/* header of a block, followed by its payload*/
+struct BlockHeader
+{
+  uint32_t type;
+  uint32_t rows;
+  uint32_t bytes;
+  uint32_t reserved;
+  int64_t first;
+  int64_t last;
+};
+
+template<typename T>
+void putColumn(std::vector<uint8_t> & out, const std::vector<T> & column)
+{
+  size_t at = out.size();
+  out.resize(at + column.size() * sizeof(T));
+  std::memcpy(out.data() + at, column.data(), column.size() * sizeof(T));
+}
+
+/* bounds checked reads of the columns of a payload*/
+class Cursor
+{
+public:
+  Cursor(const uint8_t * data, size_t bytes)
+  : data_(data), end_(data + bytes) {}
+
+  template<typename T>
+  T get()
+  {
+    T v;
+    take(&v, sizeof(T));
+    return v;
+  }
+
+  void take(void * v, size_t n)
+  {
+    if (static_cast<size_t>(end_ - data_) < n) {
+      throw std::runtime_error("truncated track log block");
+    }
+    std::memcpy(v, data_, n);
+    data_ += n;
+  }
+
+  template<typename T, typename M>
+  void getColumn(std::vector<TrackRow> & rows, M TrackRow::* member)
+  {
+    for (auto & row : rows) {
+      row.*member = get<T>();
+    }
+  }
+
+private:
+  const uint8_t * data_;
+  const uint8_t * end_;
+};
+
+uint16_t clip(uint32_t v)
+{
+  return static_cast<uint16_t>(std::min<uint32_t>(v, UINT16_MAX));
+}
+
+const std::string kUnknown;
+}  // namespace
+
+void TrackLog::Block::reserve(size_t rows)
+{
+  stamp.reserve(rows);
+  id.reserve(rows);
+  class_id.reserve(rows);
+  for (auto & column : roi) {
+    column.reserve(rows);
+  }
+  for (auto & column : bounds) {
+    column.reserve(rows);
+  }
+}
+
+TrackLog::TrackLog(const std::string & prefix, size_t block_rows, size_t rotate_bytes)
+: prefix_(prefix), block_rows_(block_rows > 1 ? block_rows : 1), rotate_bytes_(rotate_bytes)
+{
+  open();
+  current_.reserve(block_rows_);
+  writer_ = std::thread(&TrackLog::run, this);
+}
+
+TrackLog::~TrackLog()
+{
+  flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_one();
+  writer_.join();
+  out_.flush();
+}
+
+std::string TrackLog::getPath(const std::string & prefix, size_t index)
+{
+  return prefix + "." + std::to_string(index) + ".tracklog";
+}
+
+void TrackLog::open()
+{
+  std::string path = getPath(prefix_, files_);
+  out_.close();
+  out_.clear();
+  out_.open(path, std::ios::binary | std::ios::trunc);
+  if (!out_) {
+    throw std::runtime_error("cannot open track log " + path);
+  }
+  FileHeader header = {kMagic, kVersion};
+  out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  bytes_ = sizeof(header);
+  classes_.clear();
+  files_++;
+}
+
+void TrackLog::append(const object_analytics_msgs::msg::MovingObjects & moving)
+{
+  TrackRow row;
+  row.stamp = static_cast<int64_t>(moving.header.stamp.sec) * 1000000000 +
+    moving.header.stamp.nanosec;
+  for (auto & obj : moving.objects) {
+    row.id = obj.id;
+    row.class_id = util::ClassTable::intern(obj.type);
+    row.x = clip(obj.roi.x_offset);
+    row.y = clip(obj.roi.y_offset);
+    row.width = clip(obj.roi.width);
+    row.height = clip(obj.roi.height);
+    row.min[0] = obj.min.x;
+    row.min[1] = obj.min.y;
+    row.min[2] = obj.min.z;
+    row.max[0] = obj.max.x;
+    row.max[1] = obj.max.y;
+    row.max[2] = obj.max.z;
+    append(row);
+  }
+}
+
+void TrackLog::append(const TrackRow & row)
+{
+  current_.stamp.push_back(row.stamp);
+  current_.id.push_back(row.id);
+  current_.class_id.push_back(row.class_id);
+  current_.roi[0].push_back(row.x);
+  current_.roi[1].push_back(row.y);
+  current_.roi[2].push_back(row.width);
+  current_.roi[3].push_back(row.height);
+  for (size_t i = 0; i < 3; i++) {
+    current_.bounds[i].push_back(row.min[i]);
+    current_.bounds[3 + i].push_back(row.max[i]);
+  }
+  if (current_.size() >= block_rows_) {
+    push();
+  }
+}
+
+void TrackLog::flush()
+{
+  if (current_.size() > 0) {
+    push();
+  }
+}
+
+void TrackLog::push()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() >= kMaxPendingBlocks) {
+      /* dropped, the block is cleared and reused*/
+      dropped_ += current_.size();
+    } else {
+      queue_.push_back(std::move(current_));
+      current_ = Block();
+      if (!spare_.empty()) {
+        current_ = std::move(spare_.back());
+        spare_.pop_back();
+      }
+    }
+  }
+  cond_.notify_one();
+  current_.stamp.clear();
+  current_.id.clear();
+  current_.class_id.clear();
+  for (auto & column : current_.roi) {
+    column.clear();
+  }
+  for (auto & column : current_.bounds) {
+    column.clear();
+  }
+  current_.reserve(block_rows_);
+}
+
+void TrackLog::run()
+{
+  for (;; ) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] {return stop_ || !queue_.empty();});
+    if (queue_.empty()) {
+      return;
+    }
+    Block block = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    write(block);
+    lock.lock();
+    spare_.push_back(std::move(block));
+  }
+}
+
+void TrackLog::write(const Block & block)
+{
+  if (rotate_bytes_ > 0 && bytes_ >= rotate_bytes_) {
+    try {
+      open();
+    } catch (const std::runtime_error &) {
+      dropped_ += block.size();
+      return;
+    }
+  }
+  const int64_t first = *std::min_element(block.stamp.begin(), block.stamp.end());
+  const int64_t last = *std::max_element(block.stamp.begin(), block.stamp.end());
+
+  /* names of the classes new to this file go ahead of the block*/
+  payload_.clear();
+  uint32_t names = 0;
+  for (int32_t class_id : block.class_id) {
+    if (classes_.insert(class_id).second) {
+      const std::string & name = util::ClassTable::name(class_id);
+      uint16_t n = static_cast<uint16_t>(std::min<size_t>(name.size(), UINT16_MAX));
+      size_t at = payload_.size();
+      payload_.resize(at + sizeof(class_id) + sizeof(n) + n);
+      std::memcpy(payload_.data() + at, &class_id, sizeof(class_id));
+      std::memcpy(payload_.data() + at + sizeof(class_id), &n, sizeof(n));
+      std::memcpy(payload_.data() + at + sizeof(class_id) + sizeof(n), name.data(), n);
+      names++;
+    }
+  }
+  if (names > 0) {
+    writeBlock(kClasses, names, first, last);
+  }
+
+  payload_.clear();
+  putColumn(payload_, block.stamp);
+  putColumn(payload_, block.id);
+  putColumn(payload_, block.class_id);
+  for (auto & column : block.roi) {
+    putColumn(payload_, column);
+  }
+  for (auto & column : block.bounds) {
+    putColumn(payload_, column);
+  }
+  writeBlock(kTracks, static_cast<uint32_t>(block.size()), first, last);
+  /* whole blocks reach the disk, a crash loses at most the blocks queued*/
+  out_.flush();
+  written_ += block.size();
+}
+
+void TrackLog::writeBlock(uint32_t type, uint32_t rows, int64_t first, int64_t last)
+{
+  BlockHeader header = {type, rows, static_cast<uint32_t>(payload_.size()), 0, first, last};
+  out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out_.write(reinterpret_cast<const char *>(payload_.data()), payload_.size());
+  bytes_ += sizeof(header) + payload_.size();
+}
+
+TrackLogReader::TrackLogReader(const std::string & file)
+: in_(file, std::ios::binary)
+{
+  FileHeader header;
+  if (!in_.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+    header.magic != TrackLog::kMagic || header.version != TrackLog::kVersion)
+  {
+    throw std::runtime_error("not a track log " + file);
+  }
+}
+
+bool TrackLogReader::next(std::vector<TrackRow> & rows, int64_t from, int64_t to)
+{
+  for (;; ) {
+    BlockHeader header;
+    if (!in_.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+      return false;
+    }
+    bool wanted = header.type == TrackLog::kClasses ||
+      (header.type == TrackLog::kTracks && header.last >= from && header.first <= to);
+    if (!wanted) {
+      if (!in_.seekg(header.bytes, std::ios::cur)) {
+        return false;
+      }
+      continue;
+    }
+    payload_.resize(header.bytes);
+    if (!in_.read(reinterpret_cast<char *>(payload_.data()), header.bytes)) {
+      return false;
+    }
+    Cursor in(payload_.data(), payload_.size());
+    try {
+      if (header.type == TrackLog::kClasses) {
+        for (uint32_t i = 0; i < header.rows; i++) {
+          int32_t class_id = in.get<int32_t>();
+          std::string name(in.get<uint16_t>(), '\0');
+          in.take(&name[0], name.size());
+          classes_[class_id] = name;
+        }
+        continue;
+      }
+      rows.resize(header.rows);
+      in.getColumn<int64_t>(rows, &TrackRow::stamp);
+      in.getColumn<int64_t>(rows, &TrackRow::id);
+      in.getColumn<int32_t>(rows, &TrackRow::class_id);
+      in.getColumn<uint16_t>(rows, &TrackRow::x);
+      in.getColumn<uint16_t>(rows, &TrackRow::y);
+      in.getColumn<uint16_t>(rows, &TrackRow::width);
+      in.getColumn<uint16_t>(rows, &TrackRow::height);
+      for (size_t i = 0; i < 3; i++) {
+        for (auto & row : rows) {
+          row.min[i] = in.get<float>();
+        }
+      }
+      for (size_t i = 0; i < 3; i++) {
+        for (auto & row : rows) {
+          row.max[i] = in.get<float>();
+        }
+      }
+    } catch (std::runtime_error &) {
+      return false;
+    }
+    return true;
+  }
+}
+
+const std::string & TrackLogReader::getClassName(int32_t class_id) const
+{
+  auto it = classes_.find(class_id);
+  return it != classes_.end() ? it->second : kUnknown;
+}
+}  // namespace logger
+}  // namespace object_analytics_node
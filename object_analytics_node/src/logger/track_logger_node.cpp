@@ -0,0 +1,99 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/logger/track_logger_node.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+#include "object_analytics_node/util/stage_stats.hpp"
+
+namespace object_analytics_node
+{
+namespace logger
+{
+const size_t TrackLoggerNode::kCacheBytes = 1 << 20;
+
+TrackLoggerNode::TrackLoggerNode(rclcpp::NodeOptions options)
+: Node("TrackLoggerNode", options)
+{
+  using util::QosProfiles;
+  std::string prefix = declare_parameter<std::string>("log_prefix", "/tmp/oa_tracks");
+  int32_t block_rows = declare_parameter<int32_t>("block_rows",
+      static_cast<int32_t>(TrackLog::kBlockRows));
+  int32_t rotate_mb = declare_parameter<int32_t>("rotate_mb", 256);
+  log_.reset(new TrackLog(prefix, block_rows > 1 ? block_rows : 1,
+    static_cast<size_t>(rotate_mb > 0 ? rotate_mb : 0) << 20));
+  RCLCPP_INFO(get_logger(), "logging tracks to %s", TrackLog::getPath(prefix, 0).c_str());
+
+  int32_t flush_ms = declare_parameter<int32_t>("flush_period_ms", 1000);
+  flush_timer_ = create_wall_timer(std::chrono::milliseconds(flush_ms > 1 ? flush_ms : 1),
+      [this]() {log_->flush();});
+
+  double tolerance_ms = declare_parameter<double>("stamp_tolerance_ms", 0.0);
+  double min_iou = declare_parameter<double>("min_iou", merger::Merger::kMinIou);
+  merger_.setMinIou(min_iou > 0 && min_iou <= 1 ? min_iou : merger::Merger::kMinIou);
+  matcher_.reset(new Matcher(
+      std::bind(&TrackLoggerNode::callback, this, std::placeholders::_1, std::placeholders::_2),
+      kCacheBytes));
+  matcher_->setTolerance(static_cast<int64_t>(tolerance_ms * 1e6));
+
+  auto tracking_callback =
+    [this](const object_analytics_msgs::msg::TrackedObjects::SharedPtr tracks) {
+      matcher_->addFirst(rclcpp::Time(tracks->header.stamp).nanoseconds(), tracks);
+    };
+  sub_tracking_ = create_subscription<object_analytics_msgs::msg::TrackedObjects>(
+    Const::kTopicTracking, tracking_callback,
+    QosProfiles::declare(this, "tracking", QosProfiles::kReliable));
+  auto localization_callback =
+    [this](const object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr objs_3d) {
+      matcher_->addSecond(rclcpp::Time(objs_3d->header.stamp).nanoseconds(), objs_3d,
+        sizeof(*objs_3d) +
+        objs_3d->objects_in_boxes.size() * sizeof(object_analytics_msgs::msg::ObjectInBox3D));
+    };
+  sub_localization_ = create_subscription<object_analytics_msgs::msg::ObjectsInBoxes3D>(
+    Const::kTopicLocalization, localization_callback,
+    QosProfiles::declare(this, "localization", QosProfiles::kReliable));
+
+  if (declare_parameter<bool>("publish_stats", true)) {
+    auto fill = [this](object_analytics_msgs::msg::PipelineStats & msg) {
+        msg.queue_names.push_back("logger.localization_cache");
+        msg.queue_depths.push_back(matcher_->getBuffered());
+        msg.drop_names.push_back("logger.tracking_without_localization");
+        msg.drops.push_back(matcher_->getDropped());
+        msg.drop_names.push_back("logger.rows_dropped");
+        msg.drops.push_back(log_->getDropped());
+      };
+    stats_.reset(new util::StatsPublisher(this, "logger.", fill));
+  }
+}
+
+void TrackLoggerNode::callback(
+  const object_analytics_msgs::msg::TrackedObjects::ConstSharedPtr & tracks,
+  const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & objs_3d)
+{
+  static util::StageStats & append_stats = util::StageRegistry::get("logger.append");
+  util::ScopedStageTimer timer(append_stats);
+  merger_.merge(*tracks, *objs_3d, moving_);
+  log_->append(moving_);
+}
+}  // namespace logger
+}  // namespace object_analytics_node
+
+RCLCPP_COMPONENTS_REGISTER_NODE(object_analytics_node::logger::TrackLoggerNode)
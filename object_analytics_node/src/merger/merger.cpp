@@ -0,0 +1,111 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "object_analytics_node/merger/merger.hpp"
+
+namespace object_analytics_node
+{
+namespace merger
+{
+const double Merger::kMinIou = 0.5;
+
+/* intersection over union of two ROIs*/
+static double iou(
+  const sensor_msgs::msg::RegionOfInterest & a, const sensor_msgs::msg::RegionOfInterest & b)
+{
+  int64_t x0 = std::max(a.x_offset, b.x_offset);
+  int64_t y0 = std::max(a.y_offset, b.y_offset);
+  int64_t x1 = std::min<int64_t>(a.x_offset + a.width, b.x_offset + b.width);
+  int64_t y1 = std::min<int64_t>(a.y_offset + a.height, b.y_offset + b.height);
+  if (x1 <= x0 || y1 <= y0) {
+    return 0;
+  }
+  double inter = static_cast<double>((x1 - x0) * (y1 - y0));
+  double area_a = static_cast<double>(a.width) * a.height;
+  double area_b = static_cast<double>(b.width) * b.height;
+  return inter / (area_a + area_b - inter);
+}
+
+void Merger::merge(
+  const object_analytics_msgs::msg::TrackedObjects & tracks,
+  const object_analytics_msgs::msg::ObjectsInBoxes3D & objs_3d,
+  object_analytics_msgs::msg::MovingObjects & moving)
+{
+  moving.header = tracks.header;
+  moving.objects.clear();
+  moving.objects.reserve(tracks.tracked_objects.size());
+  int64_t stamp = rclcpp::Time(tracks.header.stamp).nanoseconds();
+
+  const auto & located = objs_3d.objects_in_boxes;
+  std::vector<bool> used(located.size(), false);
+  std::unordered_map<int64_t, size_t> by_id;
+  for (size_t i = 0; i < located.size(); i++) {
+    if (located[i].id >= 0) {
+      by_id[located[i].id] = i;
+    }
+  }
+
+  std::unordered_map<int64_t, Motion> motions;
+  for (const auto & track : tracks.tracked_objects) {
+    size_t best = located.size();
+    auto found = by_id.find(track.id);
+    if (found != by_id.end() && !used[found->second]) {
+      best = found->second;
+    } else {
+      double best_iou = min_iou_;
+      for (size_t i = 0; i < located.size(); i++) {
+        double overlap = used[i] ? 0 : iou(track.roi, located[i].roi);
+        if (overlap >= best_iou) {
+          best = i;
+          best_iou = overlap;
+        }
+      }
+    }
+    if (best == located.size()) {
+      unmatched_++;
+      continue;
+    }
+    used[best] = true;
+    const auto & obj = located[best];
+
+    object_analytics_msgs::msg::MovingObject mo;
+    mo.id = track.id;
+    mo.type = track.object.object_name;
+    mo.probability = track.object.probability;
+    mo.roi = track.roi;
+    mo.min = obj.min;
+    mo.max = obj.max;
+    Motion motion = {stamp, (obj.min.x + obj.max.x) / 2.0, (obj.min.y + obj.max.y) / 2.0,
+      (obj.min.z + obj.max.z) / 2.0};
+    auto last = motions_.find(track.id);
+    if (last != motions_.end() && stamp > last->second.stamp) {
+      double dt = (stamp - last->second.stamp) / 1e9;
+      mo.velocity.x = (motion.x - last->second.x) / dt;
+      mo.velocity.y = (motion.y - last->second.y) / dt;
+      mo.velocity.z = (motion.z - last->second.z) / dt;
+    }
+    motions[track.id] = motion;
+    moving.objects.push_back(mo);
+  }
+  /* objects not merged in this frame start over*/
+  motions_.swap(motions);
+}
+}  // namespace merger
+}  // namespace object_analytics_node
@@ -0,0 +1,94 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+
+#include <memory>
+#include <utility>
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/merger/merger_node.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+#include "object_analytics_node/util/stage_stats.hpp"
+
+namespace object_analytics_node
+{
+namespace merger
+{
+const size_t MergerNode::kCacheBytes = 1 << 20;
+
+MergerNode::MergerNode(rclcpp::NodeOptions options)
+: Node("MergerNode", options)
+{
+  using util::QosProfiles;
+  pub_ = create_publisher<object_analytics_msgs::msg::MovingObjects>(Const::kTopicMovingObjects,
+      QosProfiles::declare(this, "moving_objects", QosProfiles::kReliable));
+
+  double tolerance_ms = declare_parameter<double>("stamp_tolerance_ms", 0.0);
+  double min_iou = declare_parameter<double>("min_iou", Merger::kMinIou);
+  impl_.setMinIou(min_iou > 0 && min_iou <= 1 ? min_iou : Merger::kMinIou);
+  matcher_.reset(new Matcher(
+      std::bind(&MergerNode::callback, this, std::placeholders::_1, std::placeholders::_2),
+      kCacheBytes));
+  matcher_->setTolerance(static_cast<int64_t>(tolerance_ms * 1e6));
+
+  /* localization comes after tracking of the same frame, tracked objects wait for it*/
+  auto tracking_callback =
+    [this](const object_analytics_msgs::msg::TrackedObjects::SharedPtr tracks) {
+      matcher_->addFirst(rclcpp::Time(tracks->header.stamp).nanoseconds(), tracks);
+    };
+  sub_tracking_ = create_subscription<object_analytics_msgs::msg::TrackedObjects>(
+    Const::kTopicTracking, tracking_callback,
+    QosProfiles::declare(this, "tracking", QosProfiles::kReliable));
+  auto localization_callback =
+    [this](const object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr objs_3d) {
+      matcher_->addSecond(rclcpp::Time(objs_3d->header.stamp).nanoseconds(), objs_3d,
+        sizeof(*objs_3d) +
+        objs_3d->objects_in_boxes.size() * sizeof(object_analytics_msgs::msg::ObjectInBox3D));
+    };
+  sub_localization_ = create_subscription<object_analytics_msgs::msg::ObjectsInBoxes3D>(
+    Const::kTopicLocalization, localization_callback,
+    QosProfiles::declare(this, "localization", QosProfiles::kReliable));
+
+  if (declare_parameter<bool>("publish_stats", true)) {
+    auto fill = [this](object_analytics_msgs::msg::PipelineStats & msg) {
+        msg.queue_names.push_back("merger.localization_cache");
+        msg.queue_depths.push_back(matcher_->getBuffered());
+        msg.drop_names.push_back("merger.tracking_without_localization");
+        msg.drops.push_back(matcher_->getDropped());
+        msg.drop_names.push_back("merger.localization_evicted");
+        msg.drops.push_back(matcher_->getEvicted());
+        msg.drop_names.push_back("merger.objects_unmatched");
+        msg.drops.push_back(impl_.getUnmatched());
+      };
+    stats_.reset(new util::StatsPublisher(this, "merger.", fill));
+  }
+}
+
+void MergerNode::callback(
+  const object_analytics_msgs::msg::TrackedObjects::ConstSharedPtr & tracks,
+  const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & objs_3d)
+{
+  static util::StageStats & merge_stats = util::StageRegistry::get("merger.merge");
+  auto moving = std::make_unique<object_analytics_msgs::msg::MovingObjects>();
+  {
+    util::ScopedStageTimer timer(merge_stats);
+    impl_.merge(*tracks, *objs_3d, *moving);
+  }
+  pub_->publish(std::move(moving));
+}
+}  // namespace merger
+}  // namespace object_analytics_node
+
+RCLCPP_COMPONENTS_REGISTER_NODE(object_analytics_node::merger::MergerNode)
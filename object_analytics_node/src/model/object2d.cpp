@@ -24,9 +24,20 @@ Object2D::Object2D(const object_msgs::msg::ObjectInBox & oib)
 {
 }
 
+Object2D::Object2D(
+  const sensor_msgs::msg::RegionOfInterest & roi, const object_msgs::msg::Object * viewed)
+: roi_(roi), viewed_(viewed)
+{
+}
+
+Object2D Object2D::view(const object_msgs::msg::ObjectInBox & oib)
+{
+  return Object2D(oib.roi, &oib.object);
+}
+
 std::ostream & operator<<(std::ostream & os, const Object2D & obj)
 {
-  os << "Object2D[" << obj.object_.object_name;
+  os << "Object2D[" << obj.getObject().object_name;
   os << ", @(" << obj.roi_.x_offset << ", " << obj.roi_.y_offset << ")";
   os << ", width=" << obj.roi_.width << ", height=" << obj.roi_.height << "]";
   return os;
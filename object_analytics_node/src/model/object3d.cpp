@@ -21,32 +21,41 @@ namespace object_analytics_node
 {
 namespace model
 {
-Object3D::Object3D(const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices)
+Object3D::Object3D(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices, float trim,
+  bool oriented, const std::vector<uint32_t> * colors)
 {
-  pcl::PointCloud<PointXYZPixel>::Ptr seg(new pcl::PointCloud<PointXYZPixel>);
-  ObjectUtils::copyPointCloud(cloud, indices, seg);
-
-  PointXYZPixel x_min_point, x_max_point;
-  ObjectUtils::getMinMaxPointsInX(seg, x_min_point, x_max_point);
-  min_.x = x_min_point.x;
-  max_.x = x_max_point.x;
-
-  PointXYZPixel y_min_point, y_max_point;
-  ObjectUtils::getMinMaxPointsInY(seg, y_min_point, y_max_point);
-  min_.y = y_min_point.y;
-  max_.y = y_max_point.y;
+  if (trim > 0.0f) {
+    ObjectUtils::getTrimmedBounds(cloud, indices, trim, min_, max_, roi_, colors, &color_);
+    if (oriented) {
+      ObjectUtils::getOrientedBox(cloud, indices, pose_, size_);
+    }
+  } else if (oriented) {
+    ObjectUtils::getOrientedBounds(
+      cloud, indices, min_, max_, roi_, pose_, size_, colors, &color_);
+  } else {
+    ObjectUtils::getBounds(cloud, indices, min_, max_, roi_, colors, &color_);
+  }
+  oriented_ = oriented && !indices.empty();
+}
 
-  PointXYZPixel z_min_point, z_max_point;
-  ObjectUtils::getMinMaxPointsInZ(seg, z_min_point, z_max_point);
-  min_.z = z_min_point.z;
-  max_.z = z_max_point.z;
+Object3D::Object3D(const object_analytics_msgs::msg::ObjectInBox3D & object3d)
+: roi_(object3d.roi), min_(object3d.min), max_(object3d.max), color_(object3d.color),
+  object_(object3d.object)
+{
+}
 
-  ObjectUtils::getProjectedROI(seg, this->roi_);
+Object3D::Object3D(
+  const sensor_msgs::msg::RegionOfInterest & roi, const geometry_msgs::msg::Point32 & min,
+  const geometry_msgs::msg::Point32 & max, const std_msgs::msg::ColorRGBA & color,
+  const object_msgs::msg::Object * viewed)
+: roi_(roi), min_(min), max_(max), color_(color), viewed_(viewed)
+{
 }
 
-Object3D::Object3D(const object_analytics_msgs::msg::ObjectInBox3D & object3d)
-: roi_(object3d.roi), min_(object3d.min), max_(object3d.max), object_(object3d.object)
+Object3D Object3D::view(const object_analytics_msgs::msg::ObjectInBox3D & object3d)
 {
+  return Object3D(object3d.roi, object3d.min, object3d.max, object3d.color, &object3d.object);
 }
 
 std::ostream & operator<<(std::ostream & os, const Object3D & obj)
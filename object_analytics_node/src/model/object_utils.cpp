@@ -14,6 +14,16 @@
 
 #define PCL_NO_PRECOMPILE
 #include <pcl/common/io.h>
+#include <Eigen/Eigenvalues>
+#include <Eigen/Geometry>
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 #include "object_analytics_node/model/object_utils.hpp"
 
@@ -21,21 +31,188 @@ namespace object_analytics_node
 {
 namespace model
 {
+const double ObjectUtils::kMinDeviation = 1.0;
+
+namespace
+{
+/* a rect in integer pixels as converted by cv::Rect2i*/
+struct PixelRect
+{
+  double left, top, right, bottom, cx, cy, area;
+
+  explicit PixelRect(const cv::Rect2d & rect)
+  {
+    cv::Rect2i r(rect);
+    left = r.x;
+    top = r.y;
+    right = r.x + r.width;
+    bottom = r.y + r.height;
+    cx = r.x + (r.width >> 1);
+    cy = r.y + (r.height >> 1);
+    area = r.area();
+  }
+};
+
+/* rects in integer pixels, as arrays for the kernels*/
+struct PixelRects
+{
+  std::vector<double> left, top, right, bottom, cx, cy, area;
+
+  explicit PixelRects(const std::vector<cv::Rect2d> & rects)
+  : left(rects.size()), top(rects.size()), right(rects.size()), bottom(rects.size()),
+    cx(rects.size()), cy(rects.size()), area(rects.size())
+  {
+    for (size_t i = 0; i < rects.size(); i++) {
+      PixelRect r(rects[i]);
+      left[i] = r.left;
+      top[i] = r.top;
+      right[i] = r.right;
+      bottom[i] = r.bottom;
+      cx[i] = r.cx;
+      cy[i] = r.cy;
+      area[i] = r.area;
+    }
+  }
+};
+
+/* the match rate of two rects, the scalar reference of the kernels*/
+inline double matchPixels(
+  double l1, double t1, double r1, double b1, double cx1, double cy1, double a1,
+  double l2, double t2, double r2, double b2, double cx2, double cy2, double a2)
+{
+  double iw = std::min(r1, r2) - std::max(l1, l2);
+  double ih = std::min(b1, b2) - std::max(t1, t2);
+  double a0 = (iw > 0 && ih > 0) ? iw * ih : 0;
+  double u = a1 + a2 - a0;
+  /* calculate the overlap rate*/
+  double overlap = u > 0 ? a0 / u : 0;
+  /* calculate the deviation between centers, at least one pixel*/
+  double dx = cx1 - cx2, dy = cy1 - cy2;
+  double deviate = std::max(std::sqrt(dx * dx + dy * dy), ObjectUtils::kMinDeviation);
+  return overlap * 100 / deviate;
+}
+
+void matchRowsScalar(
+  const PixelRects & a, const PixelRects & b, size_t j0, double * scores)
+{
+  size_t m = b.area.size();
+  for (size_t i = 0; i < a.area.size(); i++) {
+    for (size_t j = j0; j < m; j++) {
+      scores[i * m + j] = matchPixels(
+        a.left[i], a.top[i], a.right[i], a.bottom[i], a.cx[i], a.cy[i], a.area[i],
+        b.left[j], b.top[j], b.right[j], b.bottom[j], b.cx[j], b.cy[j], b.area[j]);
+    }
+  }
+}
+
+#if defined(__aarch64__)
+/* 2 pairs a step, NEON is always available on aarch64*/
+size_t matchRowsSimd(const PixelRects & a, const PixelRects & b, double * scores)
+{
+  size_t m = b.area.size(), n = m & ~static_cast<size_t>(1);
+  float64x2_t zero = vdupq_n_f64(0), hundred = vdupq_n_f64(100);
+  float64x2_t min_dev = vdupq_n_f64(ObjectUtils::kMinDeviation);
+  for (size_t i = 0; i < a.area.size(); i++) {
+    float64x2_t al = vdupq_n_f64(a.left[i]), at = vdupq_n_f64(a.top[i]);
+    float64x2_t ar = vdupq_n_f64(a.right[i]), ab = vdupq_n_f64(a.bottom[i]);
+    float64x2_t acx = vdupq_n_f64(a.cx[i]), acy = vdupq_n_f64(a.cy[i]);
+    float64x2_t aa = vdupq_n_f64(a.area[i]);
+    for (size_t j = 0; j < n; j += 2) {
+      float64x2_t iw = vsubq_f64(vminq_f64(ar, vld1q_f64(&b.right[j])),
+          vmaxq_f64(al, vld1q_f64(&b.left[j])));
+      float64x2_t ih = vsubq_f64(vminq_f64(ab, vld1q_f64(&b.bottom[j])),
+          vmaxq_f64(at, vld1q_f64(&b.top[j])));
+      uint64x2_t hit = vandq_u64(vcgtq_f64(iw, zero), vcgtq_f64(ih, zero));
+      float64x2_t a0 = vbslq_f64(hit, vmulq_f64(iw, ih), zero);
+      float64x2_t u = vsubq_f64(vaddq_f64(aa, vld1q_f64(&b.area[j])), a0);
+      float64x2_t overlap = vbslq_f64(vcgtq_f64(u, zero), vdivq_f64(a0, u), zero);
+      float64x2_t dx = vsubq_f64(acx, vld1q_f64(&b.cx[j]));
+      float64x2_t dy = vsubq_f64(acy, vld1q_f64(&b.cy[j]));
+      float64x2_t deviate = vmaxq_f64(
+        vsqrtq_f64(vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy))), min_dev);
+      vst1q_f64(&scores[i * m + j], vdivq_f64(vmulq_f64(overlap, hundred), deviate));
+    }
+  }
+  return n;
+}
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/* 4 pairs a step, built for AVX2 whatever the compiler flags, see matchRows()*/
+__attribute__((target("avx2")))
+size_t matchRowsSimd(const PixelRects & a, const PixelRects & b, double * scores)
+{
+  size_t m = b.area.size(), n = m & ~static_cast<size_t>(3);
+  __m256d zero = _mm256_setzero_pd(), hundred = _mm256_set1_pd(100);
+  __m256d min_dev = _mm256_set1_pd(ObjectUtils::kMinDeviation);
+  for (size_t i = 0; i < a.area.size(); i++) {
+    __m256d al = _mm256_set1_pd(a.left[i]), at = _mm256_set1_pd(a.top[i]);
+    __m256d ar = _mm256_set1_pd(a.right[i]), ab = _mm256_set1_pd(a.bottom[i]);
+    __m256d acx = _mm256_set1_pd(a.cx[i]), acy = _mm256_set1_pd(a.cy[i]);
+    __m256d aa = _mm256_set1_pd(a.area[i]);
+    for (size_t j = 0; j < n; j += 4) {
+      __m256d iw = _mm256_sub_pd(_mm256_min_pd(ar, _mm256_loadu_pd(&b.right[j])),
+          _mm256_max_pd(al, _mm256_loadu_pd(&b.left[j])));
+      __m256d ih = _mm256_sub_pd(_mm256_min_pd(ab, _mm256_loadu_pd(&b.bottom[j])),
+          _mm256_max_pd(at, _mm256_loadu_pd(&b.top[j])));
+      __m256d hit = _mm256_and_pd(_mm256_cmp_pd(iw, zero, _CMP_GT_OQ),
+          _mm256_cmp_pd(ih, zero, _CMP_GT_OQ));
+      __m256d a0 = _mm256_and_pd(hit, _mm256_mul_pd(iw, ih));
+      __m256d u = _mm256_sub_pd(_mm256_add_pd(aa, _mm256_loadu_pd(&b.area[j])), a0);
+      __m256d overlap = _mm256_and_pd(_mm256_cmp_pd(u, zero, _CMP_GT_OQ),
+          _mm256_div_pd(a0, u));
+      __m256d dx = _mm256_sub_pd(acx, _mm256_loadu_pd(&b.cx[j]));
+      __m256d dy = _mm256_sub_pd(acy, _mm256_loadu_pd(&b.cy[j]));
+      __m256d deviate = _mm256_max_pd(
+        _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))), min_dev);
+      _mm256_storeu_pd(&scores[i * m + j],
+        _mm256_div_pd(_mm256_mul_pd(overlap, hundred), deviate));
+    }
+  }
+  return n;
+}
+#endif
+
+/* score all pairs, the simd kernel if any, then the remaining columns*/
+void matchRows(const PixelRects & a, const PixelRects & b, double * scores)
+{
+  size_t done = 0;
+#if defined(__aarch64__)
+  done = matchRowsSimd(a, b, scores);
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  if (__builtin_cpu_supports("avx2")) {
+    done = matchRowsSimd(a, b, scores);
+  }
+#endif
+  matchRowsScalar(a, b, done, scores);
+}
+}  // namespace
+
 void ObjectUtils::fill2DObjects(
   const ObjectsInBoxes::ConstSharedPtr & objects_in_boxes2d, Object2DVector & objects2d)
 {
-  for (auto item : objects_in_boxes2d->objects_vector) {
-    Object2D object2d(item);
-    objects2d.push_back(object2d);
+  objects2d.reserve(objects2d.size() + objects_in_boxes2d->objects_vector.size());
+  for (const auto & item : objects_in_boxes2d->objects_vector) {
+    objects2d.push_back(Object2D::view(item));
+  }
+}
+
+void ObjectUtils::fill2DObjects(
+  const ObjectsInBoxes::ConstSharedPtr & objects_in_boxes2d,
+  const util::DetectionFilter & filter, Object2DVector & objects2d)
+{
+  objects2d.reserve(objects2d.size() + objects_in_boxes2d->objects_vector.size());
+  for (const auto & item : objects_in_boxes2d->objects_vector) {
+    if (filter.accept(item)) {
+      objects2d.push_back(Object2D::view(item));
+    }
   }
 }
 
 void ObjectUtils::fill3DObjects(
   const ObjectsInBoxes3D::ConstSharedPtr & objects_in_boxes3d, Object3DVector & objects3d)
 {
-  for (auto item : objects_in_boxes3d->objects_in_boxes) {
-    Object3D object3d(item);
-    objects3d.push_back(object3d);
+  objects3d.reserve(objects3d.size() + objects_in_boxes3d->objects_in_boxes.size());
+  for (const auto & item : objects_in_boxes3d->objects_in_boxes) {
+    objects3d.push_back(Object3D::view(item));
   }
 }
 
@@ -45,8 +222,9 @@ void ObjectUtils::findMaxIntersectionRelationships(
   if (objects2d.size() != objects3d.size()) {
     return;
   } else {
+    relations.reserve(relations.size() + objects2d.size());
     for (size_t i = 0; i < objects2d.size(); i++) {
-      relations.push_back(Relation(objects2d[i], objects3d[i]));
+      relations.emplace_back(objects2d[i], objects3d[i]);
     }
   }
 }
@@ -98,22 +276,279 @@ void ObjectUtils::getProjectedROI(
   roi.height = max_y - roi.y_offset;
 }
 
-double ObjectUtils::getMatch(const cv::Rect2d & r1, const cv::Rect2d & r2)
+namespace
 {
-  cv::Rect2i ir1(r1), ir2(r2);
-  /* calculate center of rectangle #1*/
-  cv::Point2i c1(ir1.x + (ir1.width >> 1), ir1.y + (ir1.height >> 1));
-  /* calculate center of rectangle #2*/
-  cv::Point2i c2(ir2.x + (ir2.width >> 1), ir2.y + (ir2.height >> 1));
+/* sums of the points and their products, relative to the first point for precision*/
+struct Moments
+{
+  Eigen::Vector3d origin = Eigen::Vector3d::Zero();
+  Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+  Eigen::Matrix3d products = Eigen::Matrix3d::Zero();
 
-  double a1 = ir1.area(), a2 = ir2.area(), a0 = (ir1 & ir2).area();
-  /* calculate the overlap rate*/
-  double overlap = a0 / (a1 + a2 - a0);
-  /* calculate the deviation between centers #1 and #2*/
-  double deviate = sqrt(powf((c1.x - c2.x), 2) + powf((c1.y - c2.y), 2));
+  void add(const PointT & p)
+  {
+    Eigen::Vector3d d(p.x - origin.x(), p.y - origin.y(), p.z - origin.z());
+    sum += d;
+    products.noalias() += d * d.transpose();
+  }
+};
 
-  /* calculate the match rate. The more overlap, the more matching */
-  return overlap * 100 / deviate;
+/* sums of the channels of packed 0x00RRGGBB colors*/
+struct ColorSum
+{
+  const uint32_t * colors = nullptr;
+  uint64_t r = 0, g = 0, b = 0;
+
+  void add(int i)
+  {
+    uint32_t c = colors[i];
+    r += (c >> 16) & 0xff;
+    g += (c >> 8) & 0xff;
+    b += c & 0xff;
+  }
+
+  void getMean(size_t n, std_msgs::msg::ColorRGBA & color) const
+  {
+    double scale = 1.0 / (255.0 * n);
+    color.r = static_cast<float>(r * scale);
+    color.g = static_cast<float>(g * scale);
+    color.b = static_cast<float>(b * scale);
+    color.a = 1.0f;
+  }
+};
+
+/* colors are summed only if given for the cloud and asked for*/
+ColorSum * getColorSum(
+  const std::vector<uint32_t> * colors, const std_msgs::msg::ColorRGBA * color, ColorSum & sum)
+{
+  if (colors == nullptr || colors->empty() || color == nullptr) {
+    return nullptr;
+  }
+  sum.colors = colors->data();
+  return &sum;
+}
+
+/* one pass of bounds, and moments and colors if given*/
+void getBoundsPass(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+  geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max,
+  sensor_msgs::msg::RegionOfInterest & roi, Moments * moments, ColorSum * colors)
+{
+  const PointT * points = cloud->points.data();
+  const uint32_t width = cloud->width;
+  float min_x = std::numeric_limits<float>::max(), max_x = -min_x;
+  float min_y = min_x, max_y = max_x;
+  float min_z = min_x, max_z = max_x;
+  uint32_t min_px = std::numeric_limits<uint32_t>::max(), max_px = 0;
+  uint32_t min_idx = min_px, max_idx = 0;
+  /* branchless reductions over the indexed points, no copy of the points*/
+  for (int i : indices) {
+    const PointT & p = points[i];
+    uint32_t idx = static_cast<uint32_t>(i);
+    uint32_t px = idx % width;
+    min_x = std::min(min_x, p.x);
+    max_x = std::max(max_x, p.x);
+    min_y = std::min(min_y, p.y);
+    max_y = std::max(max_y, p.y);
+    min_z = std::min(min_z, p.z);
+    max_z = std::max(max_z, p.z);
+    min_px = std::min(min_px, px);
+    max_px = std::max(max_px, px);
+    min_idx = std::min(min_idx, idx);
+    max_idx = std::max(max_idx, idx);
+    if (moments != nullptr) {
+      moments->add(p);
+    }
+    if (colors != nullptr) {
+      colors->add(i);
+    }
+  }
+  min.x = min_x;
+  min.y = min_y;
+  min.z = min_z;
+  max.x = max_x;
+  max.y = max_y;
+  max.z = max_z;
+  /* rows grow with the index, so the row bounds are those of the index*/
+  roi.x_offset = min_px;
+  roi.width = max_px - min_px;
+  roi.y_offset = min_idx / width;
+  roi.height = max_idx / width - roi.y_offset;
+}
+
+/* box of the eigenvectors of the covariance, extents by projecting the points on them*/
+void fitOrientedBox(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices, const Moments & moments,
+  geometry_msgs::msg::Pose & pose, geometry_msgs::msg::Vector3 & size)
+{
+  double n = static_cast<double>(indices.size());
+  Eigen::Vector3d mean = moments.sum / n;
+  Eigen::Matrix3d covariance = moments.products / n - mean * mean.transpose();
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(covariance);
+  /* eigenvalues are increasing, the x axis takes the largest spread*/
+  Eigen::Matrix3d axes;
+  axes.col(0) = solver.eigenvectors().col(2);
+  axes.col(1) = solver.eigenvectors().col(1);
+  axes.col(2) = axes.col(0).cross(axes.col(1));
+
+  const PointT * points = cloud->points.data();
+  Eigen::Vector3d lo = Eigen::Vector3d::Constant(std::numeric_limits<double>::max());
+  Eigen::Vector3d hi = -lo;
+  for (int i : indices) {
+    const PointT & p = points[i];
+    Eigen::Vector3d d(p.x - moments.origin.x(), p.y - moments.origin.y(),
+      p.z - moments.origin.z());
+    Eigen::Vector3d q = axes.transpose() * d;
+    lo = lo.cwiseMin(q);
+    hi = hi.cwiseMax(q);
+  }
+  Eigen::Vector3d center = moments.origin + axes * ((lo + hi) / 2);
+  Eigen::Quaterniond orientation(axes);
+  pose.position.x = center.x();
+  pose.position.y = center.y();
+  pose.position.z = center.z();
+  pose.orientation.x = orientation.x();
+  pose.orientation.y = orientation.y();
+  pose.orientation.z = orientation.z();
+  pose.orientation.w = orientation.w();
+  size.x = hi.x() - lo.x();
+  size.y = hi.y() - lo.y();
+  size.z = hi.z() - lo.z();
+}
+}  // namespace
+
+void ObjectUtils::getBounds(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+  geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max,
+  sensor_msgs::msg::RegionOfInterest & roi, const std::vector<uint32_t> * colors,
+  std_msgs::msg::ColorRGBA * color)
+{
+  if (indices.empty()) {
+    return;
+  }
+  ColorSum sum;
+  ColorSum * color_sum = getColorSum(colors, color, sum);
+  getBoundsPass(cloud, indices, min, max, roi, nullptr, color_sum);
+  if (color_sum != nullptr) {
+    color_sum->getMean(indices.size(), *color);
+  }
+}
+
+void ObjectUtils::getOrientedBounds(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+  geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max,
+  sensor_msgs::msg::RegionOfInterest & roi, geometry_msgs::msg::Pose & pose,
+  geometry_msgs::msg::Vector3 & size, const std::vector<uint32_t> * colors,
+  std_msgs::msg::ColorRGBA * color)
+{
+  if (indices.empty()) {
+    return;
+  }
+  Moments moments;
+  const PointT & first = cloud->points[indices[0]];
+  moments.origin = Eigen::Vector3d(first.x, first.y, first.z);
+  ColorSum sum;
+  ColorSum * color_sum = getColorSum(colors, color, sum);
+  getBoundsPass(cloud, indices, min, max, roi, &moments, color_sum);
+  if (color_sum != nullptr) {
+    color_sum->getMean(indices.size(), *color);
+  }
+  fitOrientedBox(cloud, indices, moments, pose, size);
+}
+
+void ObjectUtils::getOrientedBox(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+  geometry_msgs::msg::Pose & pose, geometry_msgs::msg::Vector3 & size)
+{
+  if (indices.empty()) {
+    return;
+  }
+  Moments moments;
+  const PointT & first = cloud->points[indices[0]];
+  moments.origin = Eigen::Vector3d(first.x, first.y, first.z);
+  for (int i : indices) {
+    moments.add(cloud->points[i]);
+  }
+  fitOrientedBox(cloud, indices, moments, pose, size);
+}
+
+void ObjectUtils::getTrimmedBounds(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices, float trim,
+  geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max,
+  sensor_msgs::msg::RegionOfInterest & roi, const std::vector<uint32_t> * colors,
+  std_msgs::msg::ColorRGBA * color)
+{
+  if (indices.empty()) {
+    return;
+  }
+  ColorSum sum;
+  ColorSum * color_sum = getColorSum(colors, color, sum);
+  /* per-thread scratch, segmenter workers build objects concurrently*/
+  thread_local std::vector<float> xs, ys, zs;
+  const size_t n = indices.size();
+  xs.resize(n);
+  ys.resize(n);
+  zs.resize(n);
+  const PointT * points = cloud->points.data();
+  const uint32_t width = cloud->width;
+  uint32_t min_px = std::numeric_limits<uint32_t>::max(), max_px = 0;
+  uint32_t min_idx = min_px, max_idx = 0;
+  for (size_t k = 0; k < n; k++) {
+    const PointT & p = points[indices[k]];
+    uint32_t idx = static_cast<uint32_t>(indices[k]);
+    uint32_t px = idx % width;
+    xs[k] = p.x;
+    ys[k] = p.y;
+    zs[k] = p.z;
+    min_px = std::min(min_px, px);
+    max_px = std::max(max_px, px);
+    min_idx = std::min(min_idx, idx);
+    max_idx = std::max(max_idx, idx);
+    if (color_sum != nullptr) {
+      color_sum->add(indices[k]);
+    }
+  }
+  roi.x_offset = min_px;
+  roi.width = max_px - min_px;
+  roi.y_offset = min_idx / width;
+  roi.height = max_idx / width - roi.y_offset;
+  if (color_sum != nullptr) {
+    color_sum->getMean(n, *color);
+  }
+
+  size_t lo = static_cast<size_t>(std::min(std::max(trim, 0.0f), 0.5f) * (n - 1));
+  size_t hi = n - 1 - lo;
+  auto percentiles = [lo, hi](std::vector<float> & v, float & v_min, float & v_max) {
+      std::nth_element(v.begin(), v.begin() + lo, v.end());
+      v_min = v[lo];
+      if (hi > lo) {
+        std::nth_element(v.begin() + lo + 1, v.begin() + hi, v.end());
+      }
+      v_max = v[hi];
+    };
+  percentiles(xs, min.x, max.x);
+  percentiles(ys, min.y, max.y);
+  percentiles(zs, min.z, max.z);
+}
+
+double ObjectUtils::getMatch(const cv::Rect2d & r1, const cv::Rect2d & r2)
+{
+  PixelRect p1(r1), p2(r2);
+  return matchPixels(
+    p1.left, p1.top, p1.right, p1.bottom, p1.cx, p1.cy, p1.area,
+    p2.left, p2.top, p2.right, p2.bottom, p2.cx, p2.cy, p2.area);
+}
+
+void ObjectUtils::getMatchBatch(
+  const std::vector<cv::Rect2d> & rects_a, const std::vector<cv::Rect2d> & rects_b,
+  std::vector<double> & scores)
+{
+  scores.resize(rects_a.size() * rects_b.size());
+  if (scores.empty()) {
+    return;
+  }
+  PixelRects a(rects_a), b(rects_b);
+  matchRows(a, b, scores.data());
 }
 
 void ObjectUtils::copyPointCloud(
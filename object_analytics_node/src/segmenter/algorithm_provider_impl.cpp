@@ -12,10 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <rcutils/logging_macros.h>
 #include <string>
 #include <memory>
+#include <vector>
 #include "object_analytics_node/segmenter/algorithm_provider_impl.hpp"
 #include "object_analytics_node/segmenter/organized_multi_plane_segmenter.hpp"
+#ifdef OBJECT_ANALYTICS_NODE_OPENCL
+#include "object_analytics_node/segmenter/opencl_euclidean_segmenter.hpp"
+#endif
 
 using object_analytics_node::segmenter::OrganizedMultiPlaneSegmenter;
 
@@ -23,17 +28,62 @@ namespace object_analytics_node
 {
 namespace segmenter
 {
-AlgorithmProviderImpl::AlgorithmProviderImpl()
+const std::string AlgorithmProviderImpl::kMultiPlane = "OrganizedMultiPlaneSegmentation";
+const std::string AlgorithmProviderImpl::kConnectedComponent = "OrganizedConnectedComponent";
+const std::string AlgorithmProviderImpl::kOpenCLEuclidean = "OpenCLEuclideanClustering";
+
+AlgorithmProviderImpl::AlgorithmProviderImpl(
+  const std::string & name, const AlgorithmConfig & conf)
+: name_(name), conf_(conf)
 {
-  algorithms_["OrganizedMultiPlaneSegmentation"] =
-    std::static_pointer_cast<Algorithm>(std::make_shared<OrganizedMultiPlaneSegmenter>());
+  factories_[kMultiPlane] = [this]() {
+      return std::static_pointer_cast<Algorithm>(
+        std::make_shared<OrganizedMultiPlaneSegmenter>(false, conf_));
+    };
+  factories_[kConnectedComponent] = [this]() {
+      return std::static_pointer_cast<Algorithm>(
+        std::make_shared<OrganizedMultiPlaneSegmenter>(true, conf_));
+    };
+#ifdef OBJECT_ANALYTICS_NODE_OPENCL
+  factories_[kOpenCLEuclidean] = [this]() {
+      return std::static_pointer_cast<Algorithm>(
+        std::make_shared<OpenCLEuclideanSegmenter>(conf_));
+    };
+#endif
+  if (factories_.find(name_) == factories_.end()) {
+    RCUTILS_LOG_WARN("unknown segmentation algorithm %s, using %s", name_.c_str(),
+      kMultiPlane.c_str());
+    name_ = kMultiPlane;
+  }
 }
 
 std::shared_ptr<Algorithm> AlgorithmProviderImpl::get()
 {
-  std::shared_ptr<Algorithm> algo = algorithms_.at("OrganizedMultiPlaneSegmentation");
+  /* built on first use, so unselected algorithms never open a device*/
+  std::shared_ptr<Algorithm> & algo = algorithms_[name_];
+  if (!algo) {
+    algo = factories_.at(name_)();
+  }
   return algo;
 }
 
+std::shared_ptr<Algorithm> AlgorithmProviderImpl::create()
+{
+  return factories_.at(name_)();
+}
+
+void AlgorithmProviderImpl::setConfig(const AlgorithmConfig & conf)
+{
+  conf_ = conf;
+  for (auto & algorithm : algorithms_) {
+    algorithm.second->setConfig(conf_);
+  }
+}
+
+const std::vector<std::string> & AlgorithmProviderImpl::getConfigKeys()
+{
+  return OrganizedMultiPlaneSegmenter::kConfigKeys;
+}
+
 }  // namespace segmenter
 }  // namespace object_analytics_node
@@ -0,0 +1,221 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sensor_msgs/image_encodings.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "object_analytics_node/segmenter/depth_segmenter.hpp"
+
+namespace object_analytics_node
+{
+namespace segmenter
+{
+const size_t DepthSegmenter::kBinShift = 4;
+
+namespace
+{
+const uint16_t kOne = 1;
+}  // namespace
+
+DepthSegmenter::DepthSegmenter()
+{
+}
+
+void DepthSegmenter::setIntrinsics(const sensor_msgs::msg::CameraInfo & info)
+{
+  fx_ = info.k[0];
+  cx_ = info.k[2];
+  fy_ = info.k[4];
+  cy_ = info.k[5];
+}
+
+void DepthSegmenter::setSamplingStep(size_t step)
+{
+  sampling_step_ = std::max<size_t>(step, 1);
+}
+
+void DepthSegmenter::setDepthTolerance(uint16_t tolerance)
+{
+  depth_tolerance_ = tolerance;
+}
+
+void DepthSegmenter::setMinimumSamples(size_t samples)
+{
+  minimum_samples_ = std::max<size_t>(samples, 1);
+}
+
+bool DepthSegmenter::segment(
+  const object_msgs::msg::ObjectsInBoxes & objs_2d, const sensor_msgs::msg::Image & depth,
+  object_analytics_msgs::msg::ObjectsInBoxes3D & msg)
+{
+  namespace enc = sensor_msgs::image_encodings;
+  size_t pixel_size = 0;
+  if (depth.encoding == enc::TYPE_16UC1 || depth.encoding == enc::MONO16) {
+    pixel_size = sizeof(uint16_t);
+  } else if (depth.encoding == enc::TYPE_32FC1) {
+    pixel_size = sizeof(float);
+  }
+  const bool host_big_endian = *reinterpret_cast<const uint8_t *>(&kOne) == 0;
+  if (!hasIntrinsics() || pixel_size == 0 || depth.is_bigendian != host_big_endian ||
+    depth.step < depth.width * pixel_size || depth.data.size() < depth.step * depth.height)
+  {
+    return false;
+  }
+
+  msg.header = objs_2d.header;
+  for (auto & obj : objs_2d.objects_vector) {
+    object_analytics_msgs::msg::ObjectInBox3D obj3d;
+    if (segmentRoi(depth, obj.roi, obj3d.min, obj3d.max)) {
+      obj3d.object = obj.object;
+      obj3d.roi = obj.roi;
+      obj3d.id = -1;
+      msg.objects_in_boxes.push_back(obj3d);
+    }
+  }
+  return true;
+}
+
+uint16_t DepthSegmenter::getDepth(const sensor_msgs::msg::Image & depth, size_t u, size_t v) const
+{
+  const uint8_t * row = depth.data.data() + v * depth.step;
+  if (depth.encoding == sensor_msgs::image_encodings::TYPE_32FC1) {
+    float meters;
+    std::memcpy(&meters, row + u * sizeof(float), sizeof(float));
+    if (!std::isfinite(meters) || meters <= 0.0f) {
+      return 0;
+    }
+    return static_cast<uint16_t>(std::min(meters * 1000.0f + 0.5f, 65535.0f));
+  }
+  uint16_t millimeters;
+  std::memcpy(&millimeters, row + u * sizeof(uint16_t), sizeof(uint16_t));
+  return millimeters;
+}
+
+bool DepthSegmenter::segmentRoi(
+  const sensor_msgs::msg::Image & depth, const sensor_msgs::msg::RegionOfInterest & roi,
+  geometry_msgs::msg::Point32 & min, geometry_msgs::msg::Point32 & max)
+{
+  /* ROIs beyond the image are clipped*/
+  const size_t u0 = roi.x_offset, v0 = roi.y_offset;
+  const size_t u1 = std::min<size_t>(u0 + roi.width, depth.width);
+  const size_t v1 = std::min<size_t>(v0 + roi.height, depth.height);
+  if (u0 >= u1 || v0 >= v1) {
+    return false;
+  }
+  const size_t step = sampling_step_;
+  const size_t gw = (u1 - u0 + step - 1) / step, gh = (v1 - v0 + step - 1) / step;
+
+  samples_.resize(gw * gh);
+  histogram_.assign((1 << 16) >> kBinShift, 0);
+  for (size_t gy = 0; gy < gh; gy++) {
+    for (size_t gx = 0; gx < gw; gx++) {
+      uint16_t d = getDepth(depth, u0 + gx * step, v0 + gy * step);
+      samples_[gy * gw + gx] = d;
+      if (d != 0) {
+        histogram_[d >> kBinShift]++;
+      }
+    }
+  }
+
+  /* dominant depth, the peak of 3-bin sums*/
+  size_t peak = 0;
+  uint32_t peak_count = 0;
+  for (size_t b = 0; b < histogram_.size(); b++) {
+    uint32_t count = histogram_[b] + (b > 0 ? histogram_[b - 1] : 0) +
+      (b + 1 < histogram_.size() ? histogram_[b + 1] : 0);
+    if (count > peak_count) {
+      peak = b;
+      peak_count = count;
+    }
+  }
+  if (peak_count == 0) {
+    return false;
+  }
+
+  /* largest 4-connected component seeded in the peak bins*/
+  component_.assign(gw * gh, -1);
+  int32_t best = -1;
+  size_t best_size = 0;
+  int32_t id = 0;
+  for (size_t seed = 0; seed < samples_.size(); seed++) {
+    size_t bin = samples_[seed] >> kBinShift;
+    if (samples_[seed] == 0 || component_[seed] >= 0 || bin + 1 < peak || bin > peak + 1) {
+      continue;
+    }
+    queue_.clear();
+    queue_.push_back(seed);
+    component_[seed] = id;
+    for (size_t head = 0; head < queue_.size(); head++) {
+      size_t i = queue_[head];
+      size_t gx = i % gw, gy = i / gw;
+      size_t neighbors[4];
+      size_t n = 0;
+      if (gx > 0) {neighbors[n++] = i - 1;}
+      if (gx + 1 < gw) {neighbors[n++] = i + 1;}
+      if (gy > 0) {neighbors[n++] = i - gw;}
+      if (gy + 1 < gh) {neighbors[n++] = i + gw;}
+      for (size_t k = 0; k < n; k++) {
+        size_t j = neighbors[k];
+        if (samples_[j] != 0 && component_[j] < 0 &&
+          std::abs(static_cast<int>(samples_[j]) - static_cast<int>(samples_[i])) <=
+          depth_tolerance_)
+        {
+          component_[j] = id;
+          queue_.push_back(j);
+        }
+      }
+    }
+    if (queue_.size() > best_size) {
+      best = id;
+      best_size = queue_.size();
+    }
+    id++;
+  }
+  if (best_size < minimum_samples_) {
+    return false;
+  }
+
+  /* extremes of the component*/
+  size_t gx_min = gw, gx_max = 0, gy_min = gh, gy_max = 0;
+  uint16_t d_min = UINT16_MAX, d_max = 0;
+  for (size_t i = 0; i < component_.size(); i++) {
+    if (component_[i] != best) {
+      continue;
+    }
+    size_t gx = i % gw, gy = i / gw;
+    gx_min = std::min(gx_min, gx);
+    gx_max = std::max(gx_max, gx);
+    gy_min = std::min(gy_min, gy);
+    gy_max = std::max(gy_max, gy);
+    d_min = std::min(d_min, samples_[i]);
+    d_max = std::max(d_max, samples_[i]);
+  }
+
+  /* back-projected at the near and far depths, the bounds are taken at the corners*/
+  const double z_min = d_min / 1000.0, z_max = d_max / 1000.0;
+  const double x_lo = (u0 + gx_min * step - cx_) / fx_, x_hi = (u0 + gx_max * step - cx_) / fx_;
+  const double y_lo = (v0 + gy_min * step - cy_) / fy_, y_hi = (v0 + gy_max * step - cy_) / fy_;
+  min.x = std::min(x_lo * z_min, x_lo * z_max);
+  max.x = std::max(x_hi * z_min, x_hi * z_max);
+  min.y = std::min(y_lo * z_min, y_lo * z_max);
+  max.y = std::max(y_hi * z_min, y_hi * z_max);
+  min.z = z_min;
+  max.z = z_max;
+  return true;
+}
+}  // namespace segmenter
+}  // namespace object_analytics_node
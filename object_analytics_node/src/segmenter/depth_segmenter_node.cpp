@@ -0,0 +1,81 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+#include <algorithm>
+#include <memory>
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/segmenter/depth_segmenter_node.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+
+namespace object_analytics_node
+{
+namespace segmenter
+{
+const int DepthSegmenterNode::kMsgQueueSize = 100;
+
+DepthSegmenterNode::DepthSegmenterNode(rclcpp::NodeOptions options)
+: Node("DepthSegmenterNode", options)
+{
+  using util::QosProfiles;
+  pub_ = create_publisher<object_analytics_msgs::msg::ObjectsInBoxes3D>(Const::kTopicLocalization,
+      QosProfiles::declare(this, "localization", QosProfiles::kReliable));
+  if (declare_parameter<bool>("compact_localization", false)) {
+    compact_.reset(new util::CompactPublisher(this, Const::kTopicLocalization));
+  }
+
+  int32_t step = declare_parameter<int32_t>("sampling_step", 2);
+  impl_.setSamplingStep(step > 1 ? step : 1);
+  int32_t tolerance = declare_parameter<int32_t>("depth_tolerance", 30);
+  impl_.setDepthTolerance(static_cast<uint16_t>(std::min(std::max(tolerance, 0), 65535)));
+  int32_t samples = declare_parameter<int32_t>("minimum_samples", 10);
+  impl_.setMinimumSamples(samples > 1 ? samples : 1);
+
+  auto info_callback = [this](const sensor_msgs::msg::CameraInfo::SharedPtr info) {
+      impl_.setIntrinsics(*info);
+    };
+  sub_info_ = create_subscription<sensor_msgs::msg::CameraInfo>(Const::kTopicCameraInfo,
+      info_callback, QosProfiles::declare(this, "camera_info", QosProfiles::kSensor));
+
+  rclcpp::Node::SharedPtr node = std::shared_ptr<rclcpp::Node>(this);
+  depth_ = std::unique_ptr<Depth>(new Depth(node, Const::kTopicDepth,
+      QosProfiles::declare(this, "depth", QosProfiles::kSensor)));
+  objs_2d_ = std::unique_ptr<Objs_2d>(new Objs_2d(node, Const::kTopicDetection,
+      QosProfiles::declare(this, "detection", QosProfiles::kReliable)));
+  sub_sync_ = std::unique_ptr<ApproximateSynchronizer>(
+    new ApproximateSynchronizer(ApproximatePolicy(kMsgQueueSize), *objs_2d_, *depth_));
+  sub_sync_->registerCallback(
+    std::bind(&DepthSegmenterNode::callback, this, std::placeholders::_1, std::placeholders::_2));
+}
+
+void DepthSegmenterNode::callback(
+  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr objs_2d,
+  const sensor_msgs::msg::Image::ConstSharedPtr depth)
+{
+  object_analytics_msgs::msg::ObjectsInBoxes3D msg;
+  if (!impl_.segment(*objs_2d, *depth, msg)) {
+    RCLCPP_WARN(get_logger(), "skip depth image %s, %s", depth->encoding.c_str(),
+      impl_.hasIntrinsics() ? "encoding not supported" : "no camera info yet");
+    return;
+  }
+  pub_->publish(msg);
+  if (compact_) {
+    compact_->publish(msg);
+  }
+}
+}  // namespace segmenter
+}  // namespace object_analytics_node
+
+RCLCPP_COMPONENTS_REGISTER_NODE(object_analytics_node::segmenter::DepthSegmenterNode)
@@ -0,0 +1,307 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <pcl/common/time.h>
+#include <rcutils/logging_macros.h>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "object_analytics_node/segmenter/opencl_euclidean_segmenter.hpp"
+#include "object_analytics_node/segmenter/organized_multi_plane_segmenter.hpp"
+
+namespace object_analytics_node
+{
+namespace segmenter
+{
+using pcl::PointIndices;
+
+namespace
+{
+/* labels only decrease and are always indices of connected points, so races are benign*/
+const char * kKernelSource = R"CLC(
+__kernel void propagate(
+  __global const float4 * points, const int n, const float radius2,
+  __global int * labels, __global int * changed)
+{
+  int i = get_global_id(0);
+  if (i >= n) {
+    return;
+  }
+  float4 p = points[i];
+  int label = labels[i];
+  for (int j = 0; j < n; j++) {
+    float4 d = points[j] - p;
+    if (d.x * d.x + d.y * d.y + d.z * d.z <= radius2) {
+      label = min(label, labels[j]);
+    }
+  }
+  if (label < labels[i]) {
+    atomic_min(&labels[i], label);
+    changed[0] = 1;
+  }
+}
+
+__kernel void jump(__global int * labels, const int n)
+{
+  int i = get_global_id(0);
+  if (i >= n) {
+    return;
+  }
+  atomic_min(&labels[i], labels[labels[i]]);
+}
+)CLC";
+
+const size_t kWorkGroupSize = 64;
+}  // namespace
+
+static_assert(sizeof(pcl::PointXYZ) == 4 * sizeof(cl_float), "PointXYZ is not a float4");
+
+OpenCLEuclideanSegmenter::OpenCLEuclideanSegmenter(const AlgorithmConfig & conf)
+: conf_(conf), fallback_(new OrganizedMultiPlaneSegmenter(false, conf))
+{
+  applyConfig();
+  if (!init()) {
+    RCUTILS_LOG_WARN("no OpenCL device, Euclidean clustering runs on CPU");
+    release();
+  }
+}
+
+OpenCLEuclideanSegmenter::~OpenCLEuclideanSegmenter()
+{
+  release();
+}
+
+void OpenCLEuclideanSegmenter::setConfig(const AlgorithmConfig & conf)
+{
+  conf_ = conf;
+  applyConfig();
+  fallback_->setConfig(conf);
+}
+
+void OpenCLEuclideanSegmenter::segment(
+  const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud,
+  std::vector<PointIndices> & cluster_indices)
+{
+  if (!isAvailable() || cloud->empty()) {
+    fallback_->segment(cloud, cluster_indices);
+    return;
+  }
+
+  double start = pcl::getTime();
+  if (!label(cloud)) {
+    RCUTILS_LOG_WARN("OpenCL clustering failed, Euclidean clustering runs on CPU");
+    release();
+    fallback_->segment(cloud, cluster_indices);
+    return;
+  }
+
+  /* each label is the smallest index of its cluster, so clusters come in index order*/
+  std::unordered_map<cl_int, size_t> clusters;
+  std::vector<PointIndices> found;
+  for (size_t i = 0; i < cloud->size(); i++) {
+    auto c = clusters.find(labels_host_[i]);
+    if (c == clusters.end()) {
+      c = clusters.emplace(labels_host_[i], found.size()).first;
+      found.push_back(PointIndices());
+    }
+    found[c->second].indices.push_back(i);
+  }
+  for (auto & cluster : found) {
+    if (cluster.indices.size() >= object_minimum_points_ &&
+      cluster.indices.size() <= object_maximum_points_)
+    {
+      cluster_indices.push_back(cluster);
+    }
+  }
+  std::stable_sort(cluster_indices.begin(), cluster_indices.end(),
+    [](const PointIndices & a, const PointIndices & b) {
+      return a.indices.size() > b.indices.size();
+    });
+
+  double end = pcl::getTime();
+  RCUTILS_LOG_DEBUG("OpenCL cluster : %f", static_cast<double>(end - start));
+}
+
+bool OpenCLEuclideanSegmenter::init()
+{
+  cl_uint num_platforms = 0;
+  if (clGetPlatformIDs(0, nullptr, &num_platforms) != CL_SUCCESS || num_platforms == 0) {
+    return false;
+  }
+  std::vector<cl_platform_id> platforms(num_platforms);
+  clGetPlatformIDs(num_platforms, platforms.data(), nullptr);
+
+  /* a GPU of any platform first, then any device*/
+  cl_device_id device = nullptr;
+  const cl_device_type types[] = {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_ALL};
+  for (auto type : types) {
+    for (auto platform : platforms) {
+      if (clGetDeviceIDs(platform, type, 1, &device, nullptr) == CL_SUCCESS) {
+        break;
+      }
+      device = nullptr;
+    }
+    if (device != nullptr) {
+      break;
+    }
+  }
+  if (device == nullptr) {
+    return false;
+  }
+
+  cl_int err = CL_SUCCESS;
+  context_ = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  if (err != CL_SUCCESS) {
+    return false;
+  }
+  queue_ = clCreateCommandQueue(context_, device, 0, &err);
+  if (err != CL_SUCCESS) {
+    queue_ = nullptr;
+    return false;
+  }
+  program_ = clCreateProgramWithSource(context_, 1, &kKernelSource, nullptr, &err);
+  if (err != CL_SUCCESS || clBuildProgram(program_, 1, &device, "", nullptr, nullptr) !=
+    CL_SUCCESS)
+  {
+    return false;
+  }
+  propagate_ = clCreateKernel(program_, "propagate", &err);
+  if (err != CL_SUCCESS) {
+    return false;
+  }
+  jump_ = clCreateKernel(program_, "jump", &err);
+  if (err != CL_SUCCESS) {
+    return false;
+  }
+  changed_ = clCreateBuffer(context_, CL_MEM_READ_WRITE, sizeof(cl_int), nullptr, &err);
+  return err == CL_SUCCESS;
+}
+
+void OpenCLEuclideanSegmenter::release()
+{
+  if (points_ != nullptr) {
+    clReleaseMemObject(points_);
+  }
+  if (labels_ != nullptr) {
+    clReleaseMemObject(labels_);
+  }
+  if (changed_ != nullptr) {
+    clReleaseMemObject(changed_);
+  }
+  if (jump_ != nullptr) {
+    clReleaseKernel(jump_);
+  }
+  if (propagate_ != nullptr) {
+    clReleaseKernel(propagate_);
+  }
+  if (program_ != nullptr) {
+    clReleaseProgram(program_);
+  }
+  if (queue_ != nullptr) {
+    clReleaseCommandQueue(queue_);
+  }
+  if (context_ != nullptr) {
+    clReleaseContext(context_);
+  }
+  points_ = labels_ = changed_ = nullptr;
+  jump_ = propagate_ = nullptr;
+  program_ = nullptr;
+  queue_ = nullptr;
+  context_ = nullptr;
+  capacity_ = 0;
+}
+
+bool OpenCLEuclideanSegmenter::reserve(size_t size)
+{
+  if (size <= capacity_) {
+    return true;
+  }
+  /* grown by half at least, buffers are kept across ROIs and frames*/
+  size_t capacity = std::max(size, capacity_ + capacity_ / 2);
+  if (points_ != nullptr) {
+    clReleaseMemObject(points_);
+  }
+  if (labels_ != nullptr) {
+    clReleaseMemObject(labels_);
+  }
+  labels_ = nullptr;
+  capacity_ = 0;
+  cl_int err = CL_SUCCESS;
+  points_ = clCreateBuffer(context_, CL_MEM_READ_ONLY, capacity * sizeof(cl_float4), nullptr,
+      &err);
+  if (err != CL_SUCCESS) {
+    points_ = nullptr;
+    return false;
+  }
+  labels_ = clCreateBuffer(context_, CL_MEM_READ_WRITE, capacity * sizeof(cl_int), nullptr, &err);
+  if (err != CL_SUCCESS) {
+    labels_ = nullptr;
+    return false;
+  }
+  capacity_ = capacity;
+  return true;
+}
+
+bool OpenCLEuclideanSegmenter::label(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud)
+{
+  const cl_int n = static_cast<cl_int>(cloud->size());
+  if (!reserve(cloud->size())) {
+    return false;
+  }
+  labels_host_.resize(n);
+  for (cl_int i = 0; i < n; i++) {
+    labels_host_[i] = i;
+  }
+  const size_t global = (n + kWorkGroupSize - 1) / kWorkGroupSize * kWorkGroupSize;
+  const cl_float radius2 = object_distance_threshold_ * object_distance_threshold_;
+
+  bool ok = clEnqueueWriteBuffer(queue_, points_, CL_FALSE, 0, n * sizeof(cl_float4),
+      cloud->points.data(), 0, nullptr, nullptr) == CL_SUCCESS &&
+    clEnqueueWriteBuffer(queue_, labels_, CL_FALSE, 0, n * sizeof(cl_int),
+      labels_host_.data(), 0, nullptr, nullptr) == CL_SUCCESS;
+  ok = ok && clSetKernelArg(propagate_, 0, sizeof(cl_mem), &points_) == CL_SUCCESS &&
+    clSetKernelArg(propagate_, 1, sizeof(cl_int), &n) == CL_SUCCESS &&
+    clSetKernelArg(propagate_, 2, sizeof(cl_float), &radius2) == CL_SUCCESS &&
+    clSetKernelArg(propagate_, 3, sizeof(cl_mem), &labels_) == CL_SUCCESS &&
+    clSetKernelArg(propagate_, 4, sizeof(cl_mem), &changed_) == CL_SUCCESS &&
+    clSetKernelArg(jump_, 0, sizeof(cl_mem), &labels_) == CL_SUCCESS &&
+    clSetKernelArg(jump_, 1, sizeof(cl_int), &n) == CL_SUCCESS;
+
+  /* a label crosses at least one edge per round, so n rounds always converge*/
+  cl_int changed = 1;
+  for (cl_int round = 0; ok && changed != 0 && round < n; round++) {
+    changed = 0;
+    ok = clEnqueueWriteBuffer(queue_, changed_, CL_FALSE, 0, sizeof(cl_int), &changed, 0,
+        nullptr, nullptr) == CL_SUCCESS &&
+      clEnqueueNDRangeKernel(queue_, propagate_, 1, nullptr, &global, &kWorkGroupSize, 0,
+        nullptr, nullptr) == CL_SUCCESS &&
+      clEnqueueNDRangeKernel(queue_, jump_, 1, nullptr, &global, &kWorkGroupSize, 0,
+        nullptr, nullptr) == CL_SUCCESS &&
+      clEnqueueReadBuffer(queue_, changed_, CL_TRUE, 0, sizeof(cl_int), &changed, 0,
+        nullptr, nullptr) == CL_SUCCESS;
+  }
+  ok = ok && clEnqueueReadBuffer(queue_, labels_, CL_TRUE, 0, n * sizeof(cl_int),
+      labels_host_.data(), 0, nullptr, nullptr) == CL_SUCCESS;
+  return ok;
+}
+
+void OpenCLEuclideanSegmenter::applyConfig()
+{
+  object_minimum_points_ = conf_.get<size_t>("OBJECT_MINIMUM_POINTS", 60);
+  object_maximum_points_ = conf_.get<size_t>("OBJECT_MAXIMUM_POINTS", 150000);
+  object_distance_threshold_ = conf_.get<float>("OBJECT_DISTANCE_THRESHOLD", 0.07f);
+}
+}  // namespace segmenter
+}  // namespace object_analytics_node
@@ -12,16 +12,22 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <pcl/common/time.h>
 #include <pcl/filters/impl/conditional_removal.hpp>
 #include <pcl/filters/impl/filter.hpp>
+#include <pcl/sample_consensus/impl/ransac.hpp>
+#include <pcl/sample_consensus/impl/sac_model_plane.hpp>
 #include <pcl/search/impl/organized.hpp>
-#include <rcutils/logging_macros.h>
+#include <pcl/segmentation/impl/sac_segmentation.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <string>
 #include "object_analytics_node/const.hpp"
 #include "object_analytics_node/segmenter/organized_multi_plane_segmenter.hpp"
+#include "object_analytics_node/util/tracepoints.hpp"
 
 namespace object_analytics_node
 {
@@ -33,12 +39,26 @@ using pcl::PointCloud;
 using pcl::PointIndices;
 using pcl::PlanarRegion;
 
-OrganizedMultiPlaneSegmenter::OrganizedMultiPlaneSegmenter()
-: conf_(AlgorithmConfig()),
+const std::vector<std::string> OrganizedMultiPlaneSegmenter::kConfigKeys = {
+  "PLANE_MINIMUM_POINTS", "OBJECT_MINIMUM_POINTS", "OBJECT_MAXIMUM_POINTS",
+  "OBJECT_DISTANCE_THRESHOLD", "VOXEL_LEAF_SIZE", "PLANE_CACHE_FRAMES",
+  "PLANE_DISTANCE_THRESHOLD", "PLANE_MINIMUM_RATIO", "NORMAL_MAX_DEPTH_CHANGE",
+  "NORMAL_SMOOTH_SIZE", "EUCLIDEAN_DISTANCE_THRESHOLD", "MIN_PLANE_INLIERS",
+  "NORMAL_ANGLE_THRESHOLD", "NORMAL_DISTANCE_THRESHOLD", "COMPARATOR"
+};
+
+OrganizedMultiPlaneSegmenter::OrganizedMultiPlaneSegmenter(
+  bool organized, const AlgorithmConfig & conf)
+: organized_(organized),
+  conf_(conf),
   plane_comparator_(new pcl::PlaneCoefficientComparator<PointT, Normal>),
   euclidean_comparator_(new pcl::EuclideanPlaneCoefficientComparator<PointT, Normal>),
   edge_aware_comparator_(new pcl::EdgeAwarePlaneComparator<PointT, Normal>),
-  euclidean_cluster_comparator_(new pcl::EuclideanClusterComparator<PointT, Normal, Label>)
+  euclidean_cluster_comparator_(new pcl::EuclideanClusterComparator<PointT, Normal, Label>),
+  search_(new pcl::search::KdTree<PointT>),
+  input_labels_(new PointCloud<Label>),
+  voxel_cloud_(new PointCloudT),
+  plane_kept_(new std::vector<int>)
 {
   applyConfig();
 }
@@ -46,30 +66,140 @@ OrganizedMultiPlaneSegmenter::OrganizedMultiPlaneSegmenter()
 void OrganizedMultiPlaneSegmenter::segment(
   const PointCloudT::ConstPtr & cloud, std::vector<PointIndices> & cluster_indices)
 {
-  double start = pcl::getTime();
-  RCUTILS_LOG_DEBUG("Total original point size = %d", cloud->size());
-  segmentObjects_KdTree(cloud, cluster_indices);
-  double end = pcl::getTime();
-  RCUTILS_LOG_DEBUG("Segmentation : %f", static_cast<double>(end - start));
+  OA_TRACEPOINT(segmenter_phase_begin, "segment", cloud->size());
+  pcl::IndicesConstPtr kept = removePlane(cloud, nullptr);
+  if (voxel_leaf_size_ > 0.0f) {
+    segmentObjects_Voxel(cloud, kept, cluster_indices);
+  } else {
+    segmentObjects_KdTree(cloud, kept, cluster_indices);
+  }
+  OA_TRACEPOINT(segmenter_phase_end, "segment", cluster_indices.size());
+}
+
+void OrganizedMultiPlaneSegmenter::setSearchCloud(const PointCloudT::ConstPtr & cloud)
+{
+  search_cloud_ = cloud;
+  if (organized_ && cloud->isOrganized()) {
+    segmentObjects_ConnectComponent(cloud);
+    return;
+  }
+
+  OA_TRACEPOINT(segmenter_phase_begin, "search_tree", cloud->size());
+  search_->setInputCloud(cloud);
+  OA_TRACEPOINT(segmenter_phase_end, "search_tree", cloud->size());
+}
+
+void OrganizedMultiPlaneSegmenter::setConfig(const AlgorithmConfig & conf)
+{
+  conf_ = conf;
+  applyConfig();
+  /* a plane estimated with the former thresholds is refitted*/
+  plane_valid_ = false;
+}
+
+void OrganizedMultiPlaneSegmenter::segment(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+  std::vector<PointIndices> & cluster_indices)
+{
+  if (cloud != search_cloud_) {
+    Algorithm::segment(cloud, indices, cluster_indices);
+    return;
+  }
+
+  OA_TRACEPOINT(segmenter_phase_begin, "cluster_subset", indices.size());
+  if (organized_ && cloud->isOrganized()) {
+    segmentSubset_ConnectComponent(indices, cluster_indices);
+  } else {
+    pcl::IndicesConstPtr kept = removePlane(cloud, &indices);
+    segmentSubset_KdTree(cloud, kept ? *kept : indices, cluster_indices);
+  }
+
+  /* largest first, as pcl::EuclideanClusterExtraction*/
+  std::sort(cluster_indices.begin(), cluster_indices.end(),
+    [](const PointIndices & a, const PointIndices & b) {
+      return a.indices.size() > b.indices.size();
+    });
+
+  OA_TRACEPOINT(segmenter_phase_end, "cluster_subset", cluster_indices.size());
+}
+
+void OrganizedMultiPlaneSegmenter::segmentSubset_KdTree(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> & indices,
+  std::vector<PointIndices> & cluster_indices)
+{
+  /* 0 out of the subset, 1 not clustered yet, 2 clustered*/
+  search_state_.assign(cloud->size(), 0);
+  for (auto i : indices) {
+    search_state_[i] = 1;
+  }
+
+  std::vector<int> nn_indices;
+  std::vector<float> nn_distances;
+  for (auto seed : indices) {
+    if (search_state_[seed] != 1) {
+      continue;
+    }
+    PointIndices cluster;
+    cluster.indices.push_back(seed);
+    search_state_[seed] = 2;
+    for (size_t q = 0; q < cluster.indices.size(); q++) {
+      search_->radiusSearch(cloud->points[cluster.indices[q]], object_distance_threshold_,
+        nn_indices, nn_distances);
+      for (auto n : nn_indices) {
+        if (search_state_[n] == 1) {
+          search_state_[n] = 2;
+          cluster.indices.push_back(n);
+        }
+      }
+    }
+    if (cluster.indices.size() >= object_minimum_points_ &&
+      cluster.indices.size() <= object_maximum_points_)
+    {
+      std::sort(cluster.indices.begin(), cluster.indices.end());
+      cluster_indices.push_back(cluster);
+    }
+  }
+}
+
+void OrganizedMultiPlaneSegmenter::segmentSubset_ConnectComponent(
+  const std::vector<int> & indices, std::vector<PointIndices> & cluster_indices)
+{
+  /* the subset takes the part of each component inside it*/
+  std::unordered_map<uint32_t, size_t> clusters;
+  for (auto i : indices) {
+    uint32_t label = component_labels_.points[i].label;
+    if (label == std::numeric_limits<uint32_t>::max()) {
+      continue;
+    }
+    auto c = clusters.find(label);
+    if (c == clusters.end()) {
+      c = clusters.emplace(label, cluster_indices.size()).first;
+      cluster_indices.push_back(PointIndices());
+    }
+    cluster_indices[c->second].indices.push_back(i);
+  }
+
+  auto func = [this](const PointIndices & cluster) {
+      return cluster.indices.size() < this->object_minimum_points_ ||
+             cluster.indices.size() > this->object_maximum_points_;
+    };
+  cluster_indices.erase(
+    std::remove_if(cluster_indices.begin(), cluster_indices.end(), func), cluster_indices.end());
 }
 
 void OrganizedMultiPlaneSegmenter::estimateNormal(
   const PointCloudT::ConstPtr & cloud, PointCloud<Normal>::Ptr & normal_cloud)
 {
-  double start = pcl::getTime();
-
+  OA_TRACEPOINT(segmenter_phase_begin, "normal", cloud->size());
   pcl::copyPointCloud(*cloud, *normal_cloud);
-
-  double end = pcl::getTime();
-  RCUTILS_LOG_DEBUG("Calc normal : %f", static_cast<double>(end - start));
+  OA_TRACEPOINT(segmenter_phase_end, "normal", normal_cloud->size());
 }
 
 void OrganizedMultiPlaneSegmenter::segmentPlanes(
   const PointCloudT::ConstPtr & cloud, const pcl::PointCloud<Normal>::Ptr & normal_cloud,
   pcl::PointCloud<Label>::Ptr labels, std::vector<PointIndices> & label_indices)
 {
-  double start = pcl::getTime();
-
+  OA_TRACEPOINT(segmenter_phase_begin, "planes", cloud->size());
   std::vector<PlanarRegion<PointT>, Eigen::aligned_allocator<PlanarRegion<PointT>>> regions;
   std::vector<pcl::ModelCoefficients> model_coefficients;
   std::vector<PointIndices> inlier_indices;
@@ -79,50 +209,50 @@ void OrganizedMultiPlaneSegmenter::segmentPlanes(
   plane_segmentation_.segmentAndRefine(
     regions, model_coefficients, inlier_indices, labels, label_indices, boundary_indices);
 
-  double end = pcl::getTime();
-  RCUTILS_LOG_DEBUG("Plane detection : %f", static_cast<double>(end - start));
+  OA_TRACEPOINT(segmenter_phase_end, "planes", regions.size());
 }
 
 void OrganizedMultiPlaneSegmenter::segmentObjects_ConnectComponent(
-  const PointCloudT::ConstPtr & cloud, std::vector<PointIndices> & cluster_indices)
+  const PointCloudT::ConstPtr & cloud)
 {
-  double start = pcl::getTime();
-  PointCloud<Label>::Ptr labels(new PointCloud<Label>);
+  OA_TRACEPOINT(segmenter_phase_begin, "connected_components", cloud->size());
+  /* every point labeled by itself and none excluded, buffers are kept across frames*/
+  input_labels_->points.resize(cloud->size());
   for (size_t i = 0; i < cloud->size(); i++) {
-    Label label;
-    label.label = i;
-    labels->points.push_back(label);
+    input_labels_->points[i].label = i;
   }
-  std::vector<bool> plane_labels;
-  plane_labels.resize(cloud->size(), false);
+  input_labels_->width = cloud->width;
+  input_labels_->height = cloud->height;
+  exclude_labels_.assign(cloud->size(), false);
   euclidean_cluster_comparator_->setInputCloud(cloud);
-  euclidean_cluster_comparator_->setLabels(labels);
-  euclidean_cluster_comparator_->setExcludeLabels(plane_labels);
+  euclidean_cluster_comparator_->setLabels(input_labels_);
+  euclidean_cluster_comparator_->setExcludeLabels(exclude_labels_);
 
-  PointCloud<Label> euclidean_labels;
+  std::vector<PointIndices> components;
   pcl::OrganizedConnectedComponentSegmentation<PointT, Label> euclidean_segmentation(
     euclidean_cluster_comparator_);
   euclidean_segmentation.setInputCloud(cloud);
-  euclidean_segmentation.segment(euclidean_labels, cluster_indices);
+  euclidean_segmentation.segment(component_labels_, components);
 
-  auto func = [this](PointIndices indices) {
-      return indices.indices.size() < this->object_minimum_points_;
-    };
-  cluster_indices.erase(
-    std::remove_if(cluster_indices.begin(), cluster_indices.end(), func), cluster_indices.end());
-
-  double end = pcl::getTime();
-  RCUTILS_LOG_DEBUG("Cluster : %f", static_cast<double>(end - start));
+  OA_TRACEPOINT(segmenter_phase_end, "connected_components", components.size());
 }
 
 void OrganizedMultiPlaneSegmenter::segmentObjects_KdTree(
-  const PointCloudT::ConstPtr & cloud, std::vector<PointIndices> & cluster_indices)
+  const PointCloudT::ConstPtr & cloud, const pcl::IndicesConstPtr & indices,
+  std::vector<PointIndices> & cluster_indices)
 {
-  double start = pcl::getTime();
-
+  if (indices && indices->empty()) {
+    return;
+  }
+  OA_TRACEPOINT(segmenter_phase_begin, "cluster", indices ? indices->size() : cloud->size());
   pcl::search::KdTree<pcl::PointXYZ>::Ptr kdtree(new pcl::search::KdTree<pcl::PointXYZ>);
-  kdtree->setInputCloud(cloud);
   pcl::EuclideanClusterExtraction<pcl::PointXYZ> clustering;
+  if (indices) {
+    kdtree->setInputCloud(cloud, indices);
+    clustering.setIndices(indices);
+  } else {
+    kdtree->setInputCloud(cloud);
+  }
   clustering.setClusterTolerance(object_distance_threshold_);
   clustering.setMinClusterSize(object_minimum_points_);
   clustering.setMaxClusterSize(object_maximum_points_);
@@ -136,8 +266,194 @@ void OrganizedMultiPlaneSegmenter::segmentObjects_KdTree(
   cluster_indices.erase(
     std::remove_if(cluster_indices.begin(), cluster_indices.end(), func), cluster_indices.end());
 
-  double end = pcl::getTime();
-  RCUTILS_LOG_DEBUG("Cluster : %f", static_cast<double>(end - start));
+  OA_TRACEPOINT(segmenter_phase_end, "cluster", cluster_indices.size());
+}
+
+void OrganizedMultiPlaneSegmenter::segmentObjects_Voxel(
+  const PointCloudT::ConstPtr & cloud, const pcl::IndicesConstPtr & indices,
+  std::vector<PointIndices> & cluster_indices)
+{
+  OA_TRACEPOINT(segmenter_phase_begin, "voxels", indices ? indices->size() : cloud->size());
+  downsample(cloud, indices);
+  OA_TRACEPOINT(segmenter_phase_end, "voxels", voxel_cloud_->size());
+  if (voxel_cloud_->empty()) {
+    return;
+  }
+
+  OA_TRACEPOINT(segmenter_phase_begin, "cluster_voxels", voxel_cloud_->size());
+
+  /* cluster sizes are counted in source points once expanded*/
+  std::vector<PointIndices> voxel_clusters;
+  pcl::search::KdTree<pcl::PointXYZ>::Ptr kdtree(new pcl::search::KdTree<pcl::PointXYZ>);
+  kdtree->setInputCloud(voxel_cloud_);
+  pcl::EuclideanClusterExtraction<pcl::PointXYZ> clustering;
+  clustering.setClusterTolerance(object_distance_threshold_);
+  clustering.setMinClusterSize(1);
+  clustering.setMaxClusterSize(voxel_cloud_->size());
+  clustering.setSearchMethod(kdtree);
+  clustering.setInputCloud(voxel_cloud_);
+  clustering.extract(voxel_clusters);
+
+  for (auto & voxels : voxel_clusters) {
+    PointIndices cluster;
+    for (auto v : voxels.indices) {
+      cluster.indices.insert(cluster.indices.end(), voxel_points_.begin() + voxel_start_[v],
+        voxel_points_.begin() + voxel_start_[v + 1]);
+    }
+    if (cluster.indices.size() >= object_minimum_points_ &&
+      cluster.indices.size() <= object_maximum_points_)
+    {
+      std::sort(cluster.indices.begin(), cluster.indices.end());
+      cluster_indices.push_back(cluster);
+    }
+  }
+  std::sort(cluster_indices.begin(), cluster_indices.end(),
+    [](const PointIndices & a, const PointIndices & b) {
+      return a.indices.size() > b.indices.size();
+    });
+
+  OA_TRACEPOINT(segmenter_phase_end, "cluster_voxels", cluster_indices.size());
+}
+
+void OrganizedMultiPlaneSegmenter::downsample(
+  const PointCloudT::ConstPtr & cloud, const pcl::IndicesConstPtr & indices)
+{
+  /* voxel coordinates packed in 21 bits each, buffers are kept across calls*/
+  const float inverse_leaf = 1.0f / voxel_leaf_size_;
+  const int64_t offset = 1 << 20;
+  const uint64_t mask = (1 << 21) - 1;
+  voxel_ids_.clear();
+  voxel_cloud_->points.clear();
+  voxel_of_.assign(cloud->size(), -1);
+  const size_t size = indices ? indices->size() : cloud->size();
+  for (size_t k = 0; k < size; k++) {
+    size_t i = indices ? (*indices)[k] : k;
+    const PointT & p = cloud->points[i];
+    if (!pcl::isFinite(p)) {
+      continue;
+    }
+    uint64_t key =
+      ((static_cast<int64_t>(std::floor(p.x * inverse_leaf)) + offset) & mask) |
+      (((static_cast<int64_t>(std::floor(p.y * inverse_leaf)) + offset) & mask) << 21) |
+      (((static_cast<int64_t>(std::floor(p.z * inverse_leaf)) + offset) & mask) << 42);
+    auto voxel = voxel_ids_.emplace(key, static_cast<int>(voxel_cloud_->size()));
+    int v = voxel.first->second;
+    if (voxel.second) {
+      voxel_cloud_->points.push_back(PointT(0.0f, 0.0f, 0.0f));
+      voxel_start_.resize(voxel_cloud_->size());
+      voxel_start_[v] = 0;
+    }
+    voxel_cloud_->points[v].x += p.x;
+    voxel_cloud_->points[v].y += p.y;
+    voxel_cloud_->points[v].z += p.z;
+    voxel_start_[v]++;
+    voxel_of_[i] = v;
+  }
+  const size_t voxels = voxel_cloud_->size();
+  voxel_cloud_->width = voxels;
+  voxel_cloud_->height = 1;
+  voxel_cloud_->is_dense = true;
+
+  /* centroids, then counts turned into offsets of the source points of each voxel*/
+  voxel_start_.resize(voxels + 1);
+  int total = 0;
+  for (size_t v = 0; v < voxels; v++) {
+    int count = voxel_start_[v];
+    voxel_cloud_->points[v].x /= count;
+    voxel_cloud_->points[v].y /= count;
+    voxel_cloud_->points[v].z /= count;
+    voxel_start_[v] = total;
+    total += count;
+  }
+  voxel_start_[voxels] = total;
+  voxel_points_.resize(total);
+  voxel_fill_.assign(voxel_start_.begin(), voxel_start_.end() - 1);
+  for (size_t i = 0; i < cloud->size(); i++) {
+    if (voxel_of_[i] >= 0) {
+      voxel_points_[voxel_fill_[voxel_of_[i]]++] = i;
+    }
+  }
+}
+
+bool OrganizedMultiPlaneSegmenter::wantsScene(uint64_t stamp, const std::string & frame_id)
+{
+  if (plane_cache_frames_ == 0) {
+    return false;
+  }
+  if (plane_frame_seen_ && stamp == plane_stamp_ && frame_id == plane_frame_id_) {
+    return false;
+  }
+  if (frame_id != plane_frame_id_) {
+    plane_valid_ = false;
+  }
+  plane_frame_seen_ = true;
+  plane_stamp_ = stamp;
+  plane_frame_id_ = frame_id;
+  return !plane_valid_ || ++plane_age_ >= plane_cache_frames_;
+}
+
+void OrganizedMultiPlaneSegmenter::setScene(const PointCloudT::ConstPtr & scene)
+{
+  if (plane_cache_frames_ > 0) {
+    estimatePlane(scene);
+  }
+}
+
+void OrganizedMultiPlaneSegmenter::clearScene()
+{
+  plane_valid_ = false;
+  plane_age_ = 0;
+  plane_frame_seen_ = false;
+  plane_frame_id_.clear();
+}
+
+pcl::IndicesConstPtr OrganizedMultiPlaneSegmenter::removePlane(
+  const PointCloudT::ConstPtr & cloud, const std::vector<int> * indices)
+{
+  /* the plane is fitted on the scene only, see setScene()*/
+  if (plane_cache_frames_ == 0 || !plane_valid_) {
+    return pcl::IndicesConstPtr();
+  }
+
+  const size_t size = indices ? indices->size() : cloud->size();
+  OA_TRACEPOINT(segmenter_phase_begin, "plane_removal", size);
+  const float a = plane_[0], b = plane_[1], c = plane_[2], d = plane_[3];
+  plane_kept_->clear();
+  for (size_t k = 0; k < size; k++) {
+    int i = indices ? (*indices)[k] : static_cast<int>(k);
+    const PointT & p = cloud->points[i];
+    if (std::fabs(a * p.x + b * p.y + c * p.z + d) > plane_distance_threshold_) {
+      plane_kept_->push_back(i);
+    }
+  }
+  OA_TRACEPOINT(segmenter_phase_end, "plane_removal", plane_kept_->size());
+  return plane_kept_;
+}
+
+void OrganizedMultiPlaneSegmenter::estimatePlane(const PointCloudT::ConstPtr & cloud)
+{
+  const size_t size = cloud->size();
+  OA_TRACEPOINT(segmenter_phase_begin, "plane_estimation", size);
+  pcl::SACSegmentation<PointT> sac;
+  sac.setOptimizeCoefficients(true);
+  sac.setModelType(pcl::SACMODEL_PLANE);
+  sac.setMethodType(pcl::SAC_RANSAC);
+  sac.setMaxIterations(100);
+  sac.setDistanceThreshold(plane_distance_threshold_);
+  sac.setInputCloud(cloud);
+  pcl::ModelCoefficients coefficients;
+  PointIndices inliers;
+  if (size > 0) {
+    sac.segment(inliers, coefficients);
+  }
+
+  plane_valid_ = coefficients.values.size() == 4 && size > 0 &&
+    inliers.indices.size() >= plane_minimum_ratio_ * size;
+  if (plane_valid_) {
+    std::copy(coefficients.values.begin(), coefficients.values.end(), plane_);
+  }
+  plane_age_ = 0;
+  OA_TRACEPOINT(segmenter_phase_end, "plane_estimation", inliers.indices.size());
 }
 
 void OrganizedMultiPlaneSegmenter::applyConfig()
@@ -146,6 +462,10 @@ void OrganizedMultiPlaneSegmenter::applyConfig()
   object_minimum_points_ = conf_.get<size_t>("OBJECT_MINIMUM_POINTS", 60);
   object_maximum_points_ = conf_.get<size_t>("OBJECT_MAXIMUM_POINTS", 150000);
   object_distance_threshold_ = conf_.get<float>("OBJECT_DISTANCE_THRESHOLD", 0.07f);
+  voxel_leaf_size_ = conf_.get<float>("VOXEL_LEAF_SIZE", 0.0f);
+  plane_cache_frames_ = conf_.get<size_t>("PLANE_CACHE_FRAMES", 0);
+  plane_distance_threshold_ = conf_.get<float>("PLANE_DISTANCE_THRESHOLD", 0.02f);
+  plane_minimum_ratio_ = conf_.get<float>("PLANE_MINIMUM_RATIO", 0.3f);
 
   normal_estimation_.setNormalEstimationMethod(normal_estimation_.SIMPLE_3D_GRADIENT);
   normal_estimation_.setNormalEstimationMethod(normal_estimation_.COVARIANCE_MATRIX);
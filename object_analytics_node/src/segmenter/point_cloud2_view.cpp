@@ -0,0 +1,105 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define PCL_NO_PRECOMPILE
+#include <pcl_conversions/pcl_conversions.h>
+#include <string>
+#include <vector>
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
+
+namespace object_analytics_node
+{
+namespace segmenter
+{
+namespace
+{
+const uint16_t kOne = 1;
+
+const sensor_msgs::msg::PointField * findField(
+  const sensor_msgs::msg::PointCloud2 & points, const std::string & name)
+{
+  for (auto & f : points.fields) {
+    if (f.name == name && f.datatype == sensor_msgs::msg::PointField::FLOAT32 && f.count > 0 &&
+      f.offset + sizeof(float) <= points.point_step)
+    {
+      return &f;
+    }
+  }
+  return nullptr;
+}
+
+/* the 4 bytes of a packed rgb, as pcl writes it float or as uint*/
+const sensor_msgs::msg::PointField * findColorField(const sensor_msgs::msg::PointCloud2 & points)
+{
+  for (auto & f : points.fields) {
+    if ((f.name == "rgb" || f.name == "rgba") &&
+      (f.datatype == sensor_msgs::msg::PointField::FLOAT32 ||
+      f.datatype == sensor_msgs::msg::PointField::UINT32) && f.count > 0 &&
+      f.offset + sizeof(uint32_t) <= points.point_step)
+    {
+      return &f;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+PointCloud2View::PointCloud2View(const sensor_msgs::msg::PointCloud2 & points)
+: msg_(points), data_(points.data.data()), width_(points.width), height_(points.height),
+  point_step_(points.point_step), row_step_(points.row_step),
+  x_(findField(points, "x")->offset), y_(findField(points, "y")->offset),
+  z_(findField(points, "z")->offset), rgb_(0), has_rgb_(false)
+{
+  const sensor_msgs::msg::PointField * rgb = findColorField(points);
+  if (rgb != nullptr) {
+    rgb_ = rgb->offset;
+    has_rgb_ = true;
+  }
+}
+
+bool PointCloud2View::isSupported(const sensor_msgs::msg::PointCloud2 & points)
+{
+  const bool host_big_endian = *reinterpret_cast<const uint8_t *>(&kOne) == 0;
+  return findField(points, "x") != nullptr && findField(points, "y") != nullptr &&
+         findField(points, "z") != nullptr && points.is_bigendian == host_big_endian &&
+         points.data.size() >= static_cast<size_t>(points.row_step) * points.height &&
+         points.row_step >= static_cast<size_t>(points.point_step) * points.width;
+}
+
+void PointCloud2View::copy(
+  const std::vector<int> & indices, PointCloudT & out, std::vector<uint32_t> * colors) const
+{
+  out.points.resize(indices.size());
+  if (colors != nullptr && has_rgb_) {
+    colors->resize(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+      out.points[i] = at(indices[i]);
+      (*colors)[i] = color(indices[i]);
+    }
+  } else {
+    if (colors != nullptr) {
+      colors->clear();
+    }
+    for (size_t i = 0; i < indices.size(); i++) {
+      out.points[i] = at(indices[i]);
+    }
+  }
+  pcl_conversions::toPCL(msg_.header, out.header);
+  out.width = indices.size();
+  out.height = 1;
+  out.is_dense = msg_.is_dense;
+}
+
+}  // namespace segmenter
+}  // namespace object_analytics_node
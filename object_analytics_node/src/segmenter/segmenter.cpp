@@ -17,12 +17,20 @@
 #include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
 #include <object_analytics_msgs/msg/object_in_box3_d.hpp>
 #include <object_msgs/msg/object_in_box.hpp>
+#include <rcutils/logging_macros.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
 #include <memory>
+#include <string>
 #include <vector>
 #include <utility>
 #include "object_analytics_node/segmenter/organized_multi_plane_segmenter.hpp"
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
 #include "object_analytics_node/segmenter/segmenter.hpp"
 #include "object_analytics_node/model/object_utils.hpp"
+#include "object_analytics_node/util/stage_stats.hpp"
 namespace object_analytics_node
 {
 namespace segmenter
@@ -36,9 +44,33 @@ using object_analytics_node::model::Object3D;
 using object_analytics_node::model::ObjectUtils;
 using object_msgs::msg::ObjectsInBoxes;
 
+const float Segmenter::kTrackOverlap = 0.5f;
+const size_t Segmenter::kScenePoints = 20000;
+
+namespace
+{
+/* intersection over union of two ROIs*/
+float getOverlap(
+  const sensor_msgs::msg::RegionOfInterest & a, const sensor_msgs::msg::RegionOfInterest & b)
+{
+  int64_t width = std::min<int64_t>(a.x_offset + a.width, b.x_offset + b.width) -
+    std::max<int64_t>(a.x_offset, b.x_offset);
+  int64_t height = std::min<int64_t>(a.y_offset + a.height, b.y_offset + b.height) -
+    std::max<int64_t>(a.y_offset, b.y_offset);
+  if (width <= 0 || height <= 0) {
+    return 0.0f;
+  }
+  int64_t inter = width * height;
+  int64_t area = static_cast<int64_t>(a.width) * a.height +
+    static_cast<int64_t>(b.width) * b.height - inter;
+  return static_cast<float>(inter) / area;
+}
+}  // namespace
+
 Segmenter::Segmenter(std::unique_ptr<AlgorithmProvider> provider)
 : provider_(std::move(provider))
 {
+  setNumThreads(1);
 }
 
 void Segmenter::segment(
@@ -46,53 +78,549 @@ void Segmenter::segment(
   const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
   ObjectsInBoxes3D::SharedPtr & msg)
 {
+  segment(objs_2d, points, msg, nullptr, nullptr);
+}
+
+void Segmenter::segment(
+  const ObjectsInBoxes::ConstSharedPtr objs_2d,
+  const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
+  ObjectsInBoxes3D::SharedPtr & msg, ObjectPointIndices & indices)
+{
+  segment(objs_2d, points, msg, &indices, nullptr);
+}
+
+void Segmenter::segment(
+  const ObjectsInBoxes::ConstSharedPtr objs_2d,
+  const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
+  ObjectsInBoxes3D::SharedPtr & msg, ObjectPointIndices * indices,
+  OrientedObjectsInBoxes3D * oriented)
+{
+  static util::StageStats & stats = util::StageRegistry::get("segmenter.total");
+  util::ScopedStageTimer timer(stats);
   msg->header = objs_2d->header;
-  PointCloudT::Ptr pointcloud(new PointCloudT);
-  getPclPointCloud(points, *pointcloud);
   RelationVector relations;
-  doSegment(objs_2d, pointcloud, relations);
+  collect_points_ = indices != nullptr;
+  fit_oriented_ = oriented != nullptr;
+  doSegment(objs_2d, points, relations);
   composeResult(relations, msg);
+  if (indices != nullptr) {
+    indices->header = msg->header;
+    composePoints(relations, *indices);
+  }
+  if (oriented != nullptr) {
+    oriented->header = msg->header;
+    composeOriented(relations, *oriented);
+  }
+  updateTracks(relations);
 }
 
-
 void Segmenter::setSamplingStep(size_t step)
 {
   sampling_step_ = step;
 }
 
+void Segmenter::setTargetPoints(size_t target_points, size_t frame_budget)
+{
+  target_points_ = target_points;
+  frame_budget_ = frame_budget;
+}
+
+void Segmenter::setSharedSearch(bool shared)
+{
+  shared_search_ = shared;
+}
+
+void Segmenter::setNumThreads(size_t num_threads)
+{
+  std::vector<Worker> workers(std::max<size_t>(num_threads, 1));
+  for (size_t w = 0; w < workers.size(); w++) {
+    workers[w].algo = w == 0 ? provider_->get() : provider_->create();
+    if (workers[w].algo == nullptr) {
+      RCUTILS_LOG_WARN("algorithm not able to run in parallel, segment with 1 thread");
+      workers.resize(1);
+      break;
+    }
+    workers[w].roi_cloud = cloud_pool_.acquire();
+  }
+  workers_.swap(workers);
+  /* the calling thread works as well*/
+  pool_.reset(workers_.size() > 1 ? new util::ThreadPool(workers_.size() - 1) : nullptr);
+  if (!policy_.empty()) {
+    setThreadPolicy(policy_);
+  }
+}
+
+bool Segmenter::setThreadPolicy(const util::ThreadPolicy & policy)
+{
+  policy_ = policy;
+  std::string error;
+  if (pool_ && !pool_->setPolicy(policy, error)) {
+    RCUTILS_LOG_WARN("segmenter workers not pinned, %s", error.c_str());
+    return false;
+  }
+  return true;
+}
+
+size_t Segmenter::getBufferAllocations() const
+{
+  return cloud_pool_.getAllocations();
+}
+
+void Segmenter::setBoundsTrim(float trim)
+{
+  bounds_trim_ = std::min(std::max(trim, 0.0f), 0.5f);
+}
+
+void Segmenter::setConfig(const AlgorithmConfig & conf)
+{
+  provider_->setConfig(conf);
+  for (auto & worker : workers_) {
+    worker.algo->setConfig(conf);
+  }
+}
+
+void Segmenter::setTrackedObjects(const TrackedObjects & tracks)
+{
+  tracks_ = tracks;
+  for (auto it = track_bounds_.begin(); it != track_bounds_.end(); ) {
+    bool tracked = std::any_of(tracks_.tracked_objects.begin(), tracks_.tracked_objects.end(),
+        [&it](const object_analytics_msgs::msg::TrackedObject & t) {return t.id == it->first;});
+    it = tracked ? std::next(it) : track_bounds_.erase(it);
+  }
+}
+
+void Segmenter::setTemporalReuse(size_t still_shift, float depth_margin, size_t max_reuse)
+{
+  still_shift_ = still_shift;
+  depth_margin_ = std::max(depth_margin, 0.0f);
+  max_reuse_ = max_reuse;
+}
+
+void Segmenter::warmup(uint32_t width, uint32_t height)
+{
+  /* a plane at 2m, with a box at 1.5m in the middle third*/
+  PointCloudT cloud;
+  cloud.width = width;
+  cloud.height = height;
+  cloud.is_dense = true;
+  cloud.points.resize(static_cast<size_t>(width) * height);
+  const float focal = static_cast<float>(width);
+  for (uint32_t y = 0; y < height; y++) {
+    for (uint32_t x = 0; x < width; x++) {
+      bool inside = x >= width / 3 && x < 2 * width / 3 && y >= height / 3 && y < 2 * height / 3;
+      float z = inside ? 1.5f : 2.0f;
+      PointT & p = cloud.points[x + y * width];
+      p.x = (x - width / 2.0f) * z / focal;
+      p.y = (y - height / 2.0f) * z / focal;
+      p.z = z;
+    }
+  }
+  sensor_msgs::msg::PointCloud2::SharedPtr points =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(cloud, *points);
+
+  object_msgs::msg::ObjectInBox obj;
+  obj.object.probability = 1.0f;
+  obj.roi.x_offset = width / 4;
+  obj.roi.y_offset = height / 4;
+  obj.roi.width = width / 2;
+  obj.roi.height = height / 2;
+  ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  objs->header = points->header;
+  objs->objects_vector.assign(workers_.size(), obj);
+
+  util::DetectionFilter filter;
+  std::swap(filter, filter_);
+  ObjectsInBoxes3D::SharedPtr msg = std::make_shared<ObjectsInBoxes3D>();
+  segment(objs, points, msg);
+  std::swap(filter, filter_);
+  /* the synthetic plane is no floor of the real frames*/
+  for (auto & worker : workers_) {
+    worker.algo->clearScene();
+  }
+
+  std::vector<object_analytics_msgs::msg::StageStats> dropped;
+  util::StageRegistry::collect("segmenter.", dropped);
+}
+
+void Segmenter::matchTracks(const Object2DVector & objects2d)
+{
+  track_ids_.assign(objects2d.size(), -1);
+  prior_.assign(objects2d.size(), nullptr);
+  reuse_.assign(objects2d.size(), false);
+  relation_of_.clear();
+  /* each tracked object goes to the detection of the first best overlap*/
+  std::vector<bool> taken(tracks_.tracked_objects.size(), false);
+  for (size_t k = 0; k < objects2d.size(); k++) {
+    auto roi = objects2d[k].getRoi();
+    float best = 0.0f;
+    int matched = -1;
+    for (size_t t = 0; t < tracks_.tracked_objects.size(); t++) {
+      float overlap = getOverlap(roi, tracks_.tracked_objects[t].roi);
+      if (!taken[t] && overlap >= kTrackOverlap && overlap > best) {
+        best = overlap;
+        matched = static_cast<int>(t);
+      }
+    }
+    if (matched < 0) {
+      continue;
+    }
+    taken[matched] = true;
+    track_ids_[k] = tracks_.tracked_objects[matched].id;
+    auto it = track_bounds_.find(track_ids_[k]);
+    if (it != track_bounds_.end()) {
+      prior_[k] = &it->second;
+      reuse_[k] = it->second.reused < max_reuse_ && isStill(objects2d[k], it->second);
+    }
+  }
+}
+
+bool Segmenter::isStill(const Object2D & obj2d, const Track & track) const
+{
+  if (still_shift_ == 0) {
+    return false;
+  }
+  auto roi = obj2d.getRoi();
+  auto & last = track.bounds.roi;
+  int64_t shift = static_cast<int64_t>(still_shift_);
+  return std::abs(static_cast<int64_t>(roi.x_offset) - last.x_offset) <= shift &&
+         std::abs(static_cast<int64_t>(roi.y_offset) - last.y_offset) <= shift &&
+         std::abs(static_cast<int64_t>(roi.width) - last.width) <= shift &&
+         std::abs(static_cast<int64_t>(roi.height) - last.height) <= shift;
+}
+
+void Segmenter::gateRoiCloud(
+  const Track & track, PointCloudT & cloud, std::vector<int> & indices,
+  std::vector<uint32_t> & colors) const
+{
+  float z_near = track.bounds.min.z - depth_margin_;
+  float z_far = track.bounds.max.z + depth_margin_;
+  /* the indices of the kept points into the source cloud stay in step*/
+  size_t kept = 0;
+  for (size_t i = 0; i < cloud.points.size(); i++) {
+    if (cloud.points[i].z < z_near || cloud.points[i].z > z_far) {
+      continue;
+    }
+    cloud.points[kept] = cloud.points[i];
+    indices[kept] = indices[i];
+    if (!colors.empty()) {
+      colors[kept] = colors[i];
+    }
+    kept++;
+  }
+  cloud.points.resize(kept);
+  indices.resize(kept);
+  if (!colors.empty()) {
+    colors.resize(kept);
+  }
+  cloud.width = cloud.points.size();
+  cloud.height = 1;
+}
+
+void Segmenter::gateDepth(
+  const Track & track, const PointCloudT & cloud, std::vector<int> & indices) const
+{
+  float z_near = track.bounds.min.z - depth_margin_;
+  float z_far = track.bounds.max.z + depth_margin_;
+  auto end = std::remove_if(indices.begin(), indices.end(),
+      [&cloud, z_near, z_far](int idx) {
+        return cloud.points[idx].z < z_near || cloud.points[idx].z > z_far;
+      });
+  indices.erase(end, indices.end());
+}
+
+void Segmenter::updateTracks(const RelationVector & relations)
+{
+  for (size_t i = 0; i < relations.size(); i++) {
+    size_t k = relation_of_[i];
+    if (track_ids_[k] < 0) {
+      continue;
+    }
+    Track & track = track_bounds_[track_ids_[k]];
+    if (reuse_[k]) {
+      track.reused++;
+      continue;
+    }
+    track.bounds.roi = relations[i].first.getRoi();
+    track.bounds.min = relations[i].second.getMin();
+    track.bounds.max = relations[i].second.getMax();
+    track.bounds.color = relations[i].second.getColor();
+    track.reused = 0;
+    track.oriented = relations[i].second.hasOrientedBox();
+    if (track.oriented) {
+      track.pose = relations[i].second.getPose();
+      track.size = relations[i].second.getSize();
+    }
+  }
+}
+
+Segmenter::Object3D Segmenter::getReused(const Object2D & obj2d, const Track & track) const
+{
+  Object3D object3d(track.bounds);
+  object3d.setRoi(obj2d.getRoi());
+  if (track.oriented) {
+    object3d.setOrientedBox(track.pose, track.size);
+  }
+  return object3d;
+}
+
 void Segmenter::getPclPointCloud(
   const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points, PointCloudT & pcl_cloud)
 {
+  static util::StageStats & stats = util::StageRegistry::get("segmenter.getPclPointCloud");
+  util::ScopedStageTimer timer(stats);
   fromROSMsg<PointT>(*points, pcl_cloud);
 }
 
 void Segmenter::doSegment(
   const ObjectsInBoxes::ConstSharedPtr objs_2d,
-  const PointCloudT::ConstPtr & cloud, RelationVector & relations)
+  const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points, RelationVector & relations)
 {
-  std::vector<PointIndices> cluster_indices_roi;
-  PointCloudT::Ptr roi_cloud(new PointCloudT);
-  std::vector<int> obj_points_indices;
-  std::shared_ptr<Algorithm> seg = provider_->get();
+  /* views of the detections, objs_2d outlives the relations composed into the result*/
   Object2DVector objects2d_vec;
-  ObjectUtils::fill2DObjects(objs_2d, objects2d_vec);
+  ObjectUtils::fill2DObjects(objs_2d, filter_, objects2d_vec);
+  relations.reserve(objects2d_vec.size());
+  relation_of_.reserve(objects2d_vec.size());
+
+  /* only the ROI pixels are read from the message, other layouts are converted once*/
+  sensor_msgs::msg::PointCloud2::ConstSharedPtr source = points;
+  if (!PointCloud2View::isSupported(*points)) {
+    PointCloudT converted;
+    getPclPointCloud(points, converted);
+    sensor_msgs::msg::PointCloud2::SharedPtr xyz = std::make_shared<sensor_msgs::msg::PointCloud2>();
+    pcl::toROSMsg(converted, *xyz);
+    source = xyz;
+  }
+  PointCloud2View cloud(*source);
+  prepareScene(cloud, source->header);
+  getSamplingSteps(objects2d_vec, cloud);
+  matchTracks(objects2d_vec);
+  if (collect_points_) {
+    points_of_.resize(objects2d_vec.size());
+    for (auto & p : points_of_) {
+      p.clear();
+    }
+  }
+
+  if (workers_[0].algo->isOrganized() && cloud.getHeight() > 1) {
+    /* organized algorithms search the full cloud*/
+    PointCloudT::Ptr full_cloud = cloud_pool_.acquire();
+    getPclPointCloud(source, *full_cloud);
+    doOrganizedSegment(objects2d_vec, cloud, full_cloud, relations);
+    return;
+  }
+  if (shared_search_) {
+    doSharedSegment(objects2d_vec, cloud, relations);
+    return;
+  }
+
+  /* each worker takes the next ROI, results are slotted by detection*/
+  std::vector<std::shared_ptr<Object3D>> objects3d(objects2d_vec.size());
+  std::atomic<size_t> next(0);
+  auto work = [this, &cloud, &objects2d_vec, &objects3d, &next](size_t w) {
+      size_t k;
+      while ((k = next.fetch_add(1)) < objects2d_vec.size()) {
+        if (reuse_[k]) {
+          objects3d[k] = std::make_shared<Object3D>(getReused(objects2d_vec[k], *prior_[k]));
+          continue;
+        }
+        segmentRoi(cloud, objects2d_vec[k], steps_[k], prior_[k], workers_[w], objects3d[k],
+          collect_points_ ? &points_of_[k] : nullptr);
+      }
+    };
+  if (pool_) {
+    pool_->parallelFor(workers_.size(), work);
+  } else {
+    work(0);
+  }
+
+  for (size_t k = 0; k < objects2d_vec.size(); k++) {
+    if (objects3d[k]) {
+      relations.emplace_back(objects2d_vec[k], *objects3d[k]);
+      relation_of_.push_back(k);
+    }
+  }
+}
+
+void Segmenter::prepareScene(const PointCloud2View & cloud, const std_msgs::msg::Header & header)
+{
+  uint64_t stamp = static_cast<uint64_t>(header.stamp.sec) * 1000000000ULL + header.stamp.nanosec;
+  scene_algos_.clear();
+  for (auto & worker : workers_) {
+    if (worker.algo->wantsScene(stamp, header.frame_id)) {
+      scene_algos_.push_back(worker.algo.get());
+    }
+  }
+  if (scene_algos_.empty()) {
+    return;
+  }
+
+  /* a regular grid over the frame, rows and columns of organized clouds taken alike*/
+  size_t step = std::max<size_t>(
+    static_cast<size_t>(std::sqrt(static_cast<double>(cloud.size()) / kScenePoints)), 1);
+  size_t row_step = cloud.getHeight() > 1 ? step : 1;
+  size_t col_step = cloud.getHeight() > 1 ? step : step * step;
+  scene_indices_.clear();
+  for (size_t y = 0; y < cloud.getHeight(); y += row_step) {
+    for (size_t x = 0; x < cloud.getWidth(); x += col_step) {
+      size_t idx = y * cloud.getWidth() + x;
+      if (cloud.isFinite(idx)) {
+        scene_indices_.push_back(static_cast<int>(idx));
+      }
+    }
+  }
+  PointCloudT::Ptr scene(new PointCloudT);
+  cloud.copy(scene_indices_, *scene);
+  for (auto algo : scene_algos_) {
+    algo->setScene(scene);
+  }
+}
+
+void Segmenter::segmentRoi(
+  const PointCloud2View & cloud, const Object2D & obj2d, size_t step, const Track * track,
+  Worker & worker, std::shared_ptr<Object3D> & object3d, std::vector<uint32_t> * points)
+{
+  try {
+    worker.cluster_indices.clear();
+    getRoiPointCloud(cloud, worker.roi_cloud, worker.roi_indices, worker.roi_colors, obj2d, step);
+    if (track != nullptr && depth_margin_ > 0.0f) {
+      gateRoiCloud(*track, *worker.roi_cloud, worker.roi_indices, worker.roi_colors);
+      /* the object left its depth range, segment the whole ROI*/
+      if (worker.roi_cloud->empty()) {
+        getRoiPointCloud(
+          cloud, worker.roi_cloud, worker.roi_indices, worker.roi_colors, obj2d, step);
+      }
+    }
+    {
+      static util::StageStats & stats = util::StageRegistry::get("segmenter.segment");
+      util::ScopedStageTimer timer(stats);
+      worker.algo->segment(worker.roi_cloud, worker.cluster_indices);
+    }
+    const std::vector<int> * obj_points_indices = nullptr;
+    for (auto & indices : worker.cluster_indices) {
+      if (obj_points_indices == nullptr ||
+        indices.indices.size() > obj_points_indices->size())
+      {
+        obj_points_indices = &indices.indices;
+      }
+    }
+    if (obj_points_indices != nullptr && obj_points_indices->size() > 0) {
+      object3d = std::make_shared<Object3D>(
+        worker.roi_cloud, *obj_points_indices, bounds_trim_, fit_oriented_, &worker.roi_colors);
+      object3d->setRoi(obj2d.getRoi());
+      if (points != nullptr) {
+        /* the ROI cloud was copied from the source by roi_indices*/
+        points->reserve(obj_points_indices->size());
+        for (auto idx : *obj_points_indices) {
+          points->push_back(static_cast<uint32_t>(worker.roi_indices[idx]));
+        }
+      }
+    }
+  } catch (std::exception & e) {
+    std::cout << "std::exception: " << e.what() << std::endl;
+  }
+}
+
+void Segmenter::doSharedSegment(
+  const Object2DVector & objects2d, const PointCloud2View & cloud,
+  RelationVector & relations)
+{
+  /* gather the sampled points of all ROIs once, overlapped ROIs share points*/
+  std::vector<int> & roi_indices = workers_[0].roi_indices;
+  rois_.resize(objects2d.size());
+  shared_of_.assign(cloud.size(), -1);
+  shared_indices_.clear();
+  for (size_t k = 0; k < objects2d.size(); k++) {
+    roi_indices.clear();
+    getRoiIndices(cloud, objects2d[k], steps_[k], roi_indices);
+    rois_[k].clear();
+    for (auto idx : roi_indices) {
+      if (shared_of_[idx] < 0) {
+        shared_of_[idx] = shared_indices_.size();
+        shared_indices_.push_back(idx);
+      }
+      rois_[k].push_back(shared_of_[idx]);
+    }
+  }
+  PointCloudT::Ptr shared_cloud = cloud_pool_.acquire();
+  cloud.copy(shared_indices_, *shared_cloud, &colors_);
+
+  segmentSubsets(objects2d, shared_cloud, rois_, &shared_indices_, colors_, relations);
+}
+
+void Segmenter::doOrganizedSegment(
+  const Object2DVector & objects2d, const PointCloud2View & cloud,
+  const PointCloudT::ConstPtr & full_cloud, RelationVector & relations)
+{
+  /* ROIs are views into the organized cloud by indices, nothing copied*/
+  rois_.resize(objects2d.size());
+  colors_.clear();
+  if (cloud.hasColor()) {
+    colors_.resize(cloud.size());
+  }
+  for (size_t k = 0; k < objects2d.size(); k++) {
+    rois_[k].clear();
+    getRoiIndices(cloud, objects2d[k], steps_[k], rois_[k]);
+    /* only the colors of the ROI pixels are read, the only indices segmented*/
+    if (cloud.hasColor()) {
+      for (auto idx : rois_[k]) {
+        colors_[idx] = cloud.color(idx);
+      }
+    }
+  }
+
+  segmentSubsets(objects2d, full_cloud, rois_, nullptr, colors_, relations);
+}
 
+void Segmenter::segmentSubsets(
+  const Object2DVector & objects2d, const PointCloudT::ConstPtr & cloud,
+  const std::vector<std::vector<int>> & rois, const std::vector<int> * cloud_of,
+  const std::vector<uint32_t> & colors, RelationVector & relations)
+{
+  std::shared_ptr<Algorithm> seg = workers_[0].algo;
+  std::vector<PointIndices> cluster_indices_roi;
   try {
-    for (auto obj2d : objects2d_vec) {
-      roi_cloud->clear();
+    seg->setSearchCloud(cloud);
+    for (size_t k = 0; k < objects2d.size(); k++) {
+      if (reuse_[k]) {
+        relations.emplace_back(objects2d[k], getReused(objects2d[k], *prior_[k]));
+        relation_of_.push_back(k);
+        continue;
+      }
+      const std::vector<int> * roi = &rois[k];
+      if (prior_[k] != nullptr && depth_margin_ > 0.0f) {
+        gated_indices_ = rois[k];
+        gateDepth(*prior_[k], *cloud, gated_indices_);
+        roi = gated_indices_.empty() ? roi : &gated_indices_;
+      }
       cluster_indices_roi.clear();
-      obj_points_indices.clear();
-      getRoiPointCloud(cloud, roi_cloud, obj2d);
-      seg->segment(roi_cloud, cluster_indices_roi);
+      {
+        static util::StageStats & stats = util::StageRegistry::get("segmenter.segment");
+        util::ScopedStageTimer timer(stats);
+        seg->segment(cloud, *roi, cluster_indices_roi);
+      }
+      const std::vector<int> * obj_points_indices = nullptr;
       for (auto & indices : cluster_indices_roi) {
-        if (indices.indices.size() > obj_points_indices.size()) {
-          obj_points_indices = indices.indices;
+        if (obj_points_indices == nullptr ||
+          indices.indices.size() > obj_points_indices->size())
+        {
+          obj_points_indices = &indices.indices;
         }
       }
-      if (obj_points_indices.size() > 0) {
-        Object3D object3d_seg(roi_cloud, obj_points_indices);
-        object3d_seg.setRoi(obj2d.getRoi());
-        relations.push_back(Relation(obj2d, object3d_seg));
+      if (obj_points_indices != nullptr && obj_points_indices->size() > 0) {
+        Object3D object3d_seg(
+          cloud, *obj_points_indices, bounds_trim_, fit_oriented_, &colors);
+        object3d_seg.setRoi(objects2d[k].getRoi());
+        relations.emplace_back(objects2d[k], object3d_seg);
+        relation_of_.push_back(k);
+        if (collect_points_) {
+          /* the organized cloud is the source, the shared one is mapped back by cloud_of*/
+          points_of_[k].reserve(obj_points_indices->size());
+          for (auto idx : *obj_points_indices) {
+            points_of_[k].push_back(static_cast<uint32_t>(
+                cloud_of != nullptr ? (*cloud_of)[idx] : idx));
+          }
+        }
       }
     }
   } catch (std::exception & e) {
@@ -103,73 +631,125 @@ void Segmenter::doSegment(
 void Segmenter::composeResult(
   const RelationVector & relations, ObjectsInBoxes3D::SharedPtr & msgs)
 {
-  for (auto item : relations) {
-    object_analytics_msgs::msg::ObjectInBox3D obj3d;
+  static util::StageStats & stats = util::StageRegistry::get("segmenter.composeResult");
+  util::ScopedStageTimer timer(stats);
+  /* filled in place, the object strings are the only copies*/
+  msgs->objects_in_boxes.reserve(msgs->objects_in_boxes.size() + relations.size());
+  for (size_t i = 0; i < relations.size(); i++) {
+    const auto & item = relations[i];
+    msgs->objects_in_boxes.emplace_back();
+    object_analytics_msgs::msg::ObjectInBox3D & obj3d = msgs->objects_in_boxes.back();
     obj3d.object = item.first.getObject();
     obj3d.roi = item.first.getRoi();
     obj3d.min = item.second.getMin();
     obj3d.max = item.second.getMax();
-    msgs->objects_in_boxes.push_back(obj3d);
+    obj3d.color = item.second.getColor();
+    obj3d.id = track_ids_[relation_of_[i]];
   }
 }
 
-void Segmenter::getRoiPointCloud(
-  const PointCloudT::ConstPtr & cloud, PointCloudT::Ptr & roi_cloud, const Object2D & obj2d)
+void Segmenter::composePoints(
+  const RelationVector & relations, ObjectPointIndices & indices) const
 {
-  auto obj2d_roi = obj2d.getRoi();
-  std::vector<int> roi_indices;
-
-  size_t x = obj2d_roi.x_offset;
-  size_t y = obj2d_roi.y_offset;
-  size_t x_end = x + obj2d_roi.width;
-  size_t y_end = y + obj2d_roi.height;
+  indices.offsets.resize(relations.size() + 1);
+  indices.indices.clear();
+  indices.offsets[0] = 0;
+  for (size_t i = 0; i < relations.size(); i++) {
+    const std::vector<uint32_t> & points = points_of_[relation_of_[i]];
+    indices.indices.insert(indices.indices.end(), points.begin(), points.end());
+    indices.offsets[i + 1] = static_cast<uint32_t>(indices.indices.size());
+  }
+}
 
-  for (size_t idx_x = x; idx_x < x_end; idx_x += sampling_step_) {
-    for (size_t idx_y = y; idx_y < y_end; idx_y += sampling_step_) {
-      size_t idx = idx_x + idx_y * cloud->width;
-      if (std::isfinite(cloud->points[idx].x)) {
-        roi_indices.push_back(idx);
-      }
+void Segmenter::composeOriented(
+  const RelationVector & relations, OrientedObjectsInBoxes3D & oriented) const
+{
+  oriented.objects_in_boxes.resize(relations.size());
+  for (size_t i = 0; i < relations.size(); i++) {
+    const Object3D & object3d = relations[i].second;
+    auto & obj = oriented.objects_in_boxes[i];
+    obj.object_in_box.object = relations[i].first.getObject();
+    obj.object_in_box.roi = relations[i].first.getRoi();
+    obj.object_in_box.min = object3d.getMin();
+    obj.object_in_box.max = object3d.getMax();
+    obj.object_in_box.color = object3d.getColor();
+    obj.object_in_box.id = track_ids_[relation_of_[i]];
+    if (object3d.hasOrientedBox()) {
+      obj.pose = object3d.getPose();
+      obj.size = object3d.getSize();
+      continue;
     }
+    /* reused bounds never fitted, the axis aligned box*/
+    const auto & min = object3d.getMin();
+    const auto & max = object3d.getMax();
+    obj.pose = geometry_msgs::msg::Pose();
+    obj.pose.position.x = (min.x + max.x) / 2.0;
+    obj.pose.position.y = (min.y + max.y) / 2.0;
+    obj.pose.position.z = (min.z + max.z) / 2.0;
+    obj.size.x = max.x - min.x;
+    obj.size.y = max.y - min.y;
+    obj.size.z = max.z - min.z;
   }
-
-  pcl::copyPointCloud(*cloud, roi_indices, *roi_cloud);
-  roi_cloud->width = roi_indices.size();
-  roi_cloud->height = 1;
 }
 
 void Segmenter::getRoiPointCloud(
-  const PointCloudT::ConstPtr & cloud, const pcl::PointCloud<PointXYZPixel>::Ptr & pixel_pcl,
-  PointCloudT::Ptr & roi_cloud, const Object2D & obj2d)
+  const PointCloud2View & cloud, PointCloudT::Ptr & roi_cloud, std::vector<int> & roi_indices,
+  std::vector<uint32_t> & roi_colors, const Object2D & obj2d, size_t step)
 {
-  auto obj2d_roi = obj2d.getRoi();
-  std::vector<int> roi_indices;
-  size_t x = obj2d_roi.x_offset;
-  size_t y = obj2d_roi.y_offset;
-  size_t x_ed = x + obj2d_roi.width;
-  size_t y_ed = y + obj2d_roi.height;
-  for (size_t i = 0; i < pixel_pcl->points.size(); i++) {
-    if ((pixel_pcl->points[i].pixel_x >= x) && (pixel_pcl->points[i].pixel_x < x_ed) &&
-      (pixel_pcl->points[i].pixel_y >= y) && (pixel_pcl->points[i].pixel_y < y_ed))
-    {
-      roi_indices.push_back(i);
+  static util::StageStats & stats = util::StageRegistry::get("segmenter.getRoiPointCloud");
+  util::ScopedStageTimer timer(stats);
+  roi_indices.clear();
+  getRoiIndices(cloud, obj2d, step, roi_indices);
+
+  cloud.copy(roi_indices, *roi_cloud, &roi_colors);
+}
+
+void Segmenter::getSamplingSteps(const Object2DVector & objects2d, const PointCloud2View & cloud)
+{
+  steps_.assign(objects2d.size(), std::max<size_t>(sampling_step_, 1));
+  if (target_points_ == 0 || objects2d.empty()) {
+    return;
+  }
+  size_t target = target_points_;
+  if (frame_budget_ > 0) {
+    target = std::min(target, std::max<size_t>(frame_budget_ / objects2d.size(), 1));
+  }
+  for (size_t k = 0; k < objects2d.size(); k++) {
+    auto roi = objects2d[k].getRoi();
+    size_t width = std::min<size_t>(roi.x_offset + roi.width, cloud.getWidth());
+    size_t height = std::min<size_t>(roi.y_offset + roi.height, cloud.getHeight());
+    width = width > roi.x_offset ? width - roi.x_offset : 0;
+    height = height > roi.y_offset ? height - roi.y_offset : 0;
+    /* a step samples ceil(width / step) * ceil(height / step) pixels*/
+    size_t step = std::max<size_t>(
+      static_cast<size_t>(std::sqrt(static_cast<double>(width * height) / target)), 1);
+    while (((width + step - 1) / step) * ((height + step - 1) / step) > target) {
+      step++;
     }
+    steps_[k] = step;
   }
-  pcl::copyPointCloud(*cloud, roi_indices, *roi_cloud);
-  roi_cloud->width = obj2d_roi.width;
-  roi_cloud->height = obj2d_roi.height;
 }
 
-void Segmenter::getPixelPointCloud(
-  const PointCloudT::ConstPtr & cloud, pcl::PointCloud<PointXYZPixel>::Ptr & pixel_pcl)
+void Segmenter::getRoiIndices(
+  const PointCloud2View & cloud, const Object2D & obj2d, size_t step,
+  std::vector<int> & roi_indices)
 {
-  std::vector<int> indices;
-  for (size_t i = 0; i < cloud->points.size(); i++) {
-    indices.push_back(i);
+  auto obj2d_roi = obj2d.getRoi();
+
+  /* ROIs beyond the cloud are clipped*/
+  size_t x = obj2d_roi.x_offset;
+  size_t y = obj2d_roi.y_offset;
+  size_t x_end = std::min<size_t>(x + obj2d_roi.width, cloud.getWidth());
+  size_t y_end = std::min<size_t>(y + obj2d_roi.height, cloud.getHeight());
+
+  for (size_t idx_x = x; idx_x < x_end; idx_x += step) {
+    for (size_t idx_y = y; idx_y < y_end; idx_y += step) {
+      size_t idx = idx_x + idx_y * cloud.getWidth();
+      if (cloud.isFinite(idx)) {
+        roi_indices.push_back(idx);
+      }
+    }
   }
-  ObjectUtils::copyPointCloud(cloud, indices, pixel_pcl);
-  pixel_pcl->height = cloud->height;
-  pixel_pcl->width = cloud->width;
 }
 
 }  // namespace segmenter
@@ -14,44 +14,313 @@
 
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
+#include <chrono>
+#include <cinttypes>
 #include <memory>
+#include <string>
+#include <vector>
 #include "object_analytics_node/const.hpp"
 #include "object_analytics_node/segmenter/segmenter_node.hpp"
 #include "object_analytics_node/segmenter/algorithm_provider_impl.hpp"
+#include "object_analytics_node/util/cloud_codec.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+#include "object_analytics_node/util/roi_crop.hpp"
+#include "object_analytics_node/util/thread_policy.hpp"
 
 namespace object_analytics_node
 {
 namespace segmenter
 {
 #define DEFAULT_SAMPLING  10
-const int SegmenterNode::kMsgQueueSize = 100;
+const std::string SegmenterNode::kConfigPrefix = "algorithm.";
 using object_analytics_node::segmenter::AlgorithmProvider;
 using object_analytics_node::segmenter::AlgorithmProviderImpl;
+using object_analytics_node::segmenter::AlgorithmConfig;
 
 SegmenterNode::SegmenterNode(rclcpp::NodeOptions options)
 : Node("SegmenterNode", options)
 {
-  pub_ = create_publisher<object_analytics_msgs::msg::ObjectsInBoxes3D>(Const::kTopicLocalization);
+  using util::QosProfiles;
+  pub_ = create_publisher<object_analytics_msgs::msg::ObjectsInBoxes3D>(Const::kTopicLocalization,
+      QosProfiles::declare(this, "localization", QosProfiles::kReliable));
+  if (declare_parameter<bool>("object_points", false)) {
+    pub_points_ = create_publisher<ObjectPointIndices>(Const::kTopicObjectPoints,
+        QosProfiles::declare(this, "object_points", QosProfiles::kReliable));
+  }
+  if (declare_parameter<bool>("oriented_boxes", false)) {
+    pub_oriented_ = create_publisher<OrientedObjectsInBoxes3D>(Const::kTopicOrientedLocalization,
+        QosProfiles::declare(this, "oriented_localization", QosProfiles::kReliable));
+  }
+  if (declare_parameter<bool>("compact_localization", false)) {
+    compact_.reset(new util::CompactPublisher(this, Const::kTopicLocalization));
+  }
 
-  rclcpp::Node::SharedPtr node = std::shared_ptr<rclcpp::Node>(this);
-  pcls = std::unique_ptr<Pcls>(new Pcls(node, Const::kTopicPC2));
-  objs_2d = std::unique_ptr<Objs_2d>(new Objs_2d(node, Const::kTopicDetection));
+  /* the detector echoes the stamp of the camera, clouds wait for their detections*/
+  int32_t cache_mb = declare_parameter<int32_t>("cloud_cache_mb", 64);
+  double tolerance_ms = declare_parameter<double>("stamp_tolerance_ms", 0.0);
+  matcher_.reset(new Matcher(
+      std::bind(&SegmenterNode::callback, this, std::placeholders::_1, std::placeholders::_2),
+      static_cast<size_t>(cache_mb > 1 ? cache_mb : 1) << 20));
+  matcher_->setTolerance(static_cast<int64_t>(tolerance_ms * 1e6));
+  cloud_memory_.reset(new util::MemoryAccount("segmenter.cloud_cache",
+    static_cast<size_t>(cache_mb > 1 ? cache_mb : 1) << 20));
+  auto objs_callback = [this](const ObjectsInBoxes::SharedPtr objs) {
+      matcher_->addFirst(rclcpp::Time(objs->header.stamp).nanoseconds(), objs);
+      logDrops();
+    };
+  sub_objs_ = create_subscription<ObjectsInBoxes>(Const::kTopicDetection, objs_callback,
+      QosProfiles::declare(this, "detection", QosProfiles::kReliable));
+  bool compressed = declare_parameter<bool>("compressed_points", false);
+  if (declare_parameter<bool>("cropped_points", false)) {
+    /* expanded into pooled clouds, only the windows of the detections hold points and only
+     * the windows of the last use of a cloud are reset*/
+    auto cropped_callback =
+      [this](const object_analytics_msgs::msg::CroppedPointCloud::SharedPtr cropped) {
+        std::shared_ptr<sensor_msgs::msg::PointCloud2> pcls = decoded_pool_.acquire();
+        try {
+          auto written = expanded_windows_.find(pcls.get());
+          if (written != expanded_windows_.end()) {
+            util::RoiCrop::expand(*cropped, *pcls, &written->second);
+          } else {
+            util::RoiCrop::expand(*cropped, *pcls);
+            expanded_windows_[pcls.get()] = cropped->windows;
+          }
+        } catch (const std::runtime_error & e) {
+          RCLCPP_ERROR(get_logger(), "caught exception %s while expanding, skip this message",
+            e.what());
+          return;
+        }
+        matcher_->addSecond(rclcpp::Time(pcls->header.stamp).nanoseconds(), pcls,
+          pcls->data.size());
+        logDrops();
+      };
+    sub_cropped_ = create_subscription<object_analytics_msgs::msg::CroppedPointCloud>(
+      Const::kTopicCroppedPC2, cropped_callback,
+      QosProfiles::declare(this, "cropped_points", QosProfiles::kReliable));
+  } else if (compressed) {
+    /* decompressed into pooled clouds, released once segmented or evicted*/
+    auto compressed_callback =
+      [this](const object_analytics_msgs::msg::CompressedPointCloud::SharedPtr compressed) {
+        std::shared_ptr<sensor_msgs::msg::PointCloud2> pcls = decoded_pool_.acquire();
+        try {
+          util::CloudCodec::decode(*compressed, *pcls);
+        } catch (const std::runtime_error & e) {
+          RCLCPP_ERROR(get_logger(), "caught exception %s while decoding, skip this message",
+            e.what());
+          return;
+        }
+        matcher_->addSecond(rclcpp::Time(pcls->header.stamp).nanoseconds(), pcls,
+          pcls->data.size());
+        logDrops();
+      };
+    sub_compressed_ = create_subscription<object_analytics_msgs::msg::CompressedPointCloud>(
+      Const::kTopicCompressedPC2, compressed_callback,
+      QosProfiles::declare(this, "compressed_points", QosProfiles::kSensor));
+  } else {
+    auto pcls_callback = [this](const sensor_msgs::msg::PointCloud2::SharedPtr pcls) {
+        matcher_->addSecond(rclcpp::Time(pcls->header.stamp).nanoseconds(), pcls,
+          pcls->data.size());
+        logDrops();
+      };
+    /* x/y/z are read in place from the registered cloud, the splitter need not repack them*/
+    bool registered = declare_parameter<bool>("registered_points", false);
+    sub_pcls_ = create_subscription<sensor_msgs::msg::PointCloud2>(
+      registered ? Const::kTopicRegisteredPC2 : Const::kTopicPC2, pcls_callback,
+      QosProfiles::declare(this, "pointcloud", QosProfiles::kSensor));
+  }
+  std::string algorithm = declare_parameter<std::string>("segmentation_algorithm",
+      AlgorithmProviderImpl::kMultiPlane);
+  /* algorithm items left unset keep their defaults*/
+  for (auto & key : AlgorithmProviderImpl::getConfigKeys()) {
+    rclcpp::Parameter param(kConfigPrefix + key, declare_parameter(kConfigPrefix + key));
+    setConfig(param);
+  }
+  impl_.reset(new Segmenter(std::unique_ptr<AlgorithmProvider>(
+      new AlgorithmProviderImpl(algorithm, conf_))));
+  int32_t step = declare_parameter<int32_t>("sampling_step", DEFAULT_SAMPLING);
+  step = step > 1 ? step : 1;
+  impl_->setSamplingStep(step);
+  int32_t degrade_level = declare_parameter<int32_t>("degrade_level", 1);
+  int32_t degraded_step = declare_parameter<int32_t>("degraded_sampling_step", 2 * step);
+  if (degrade_level > 0) {
+    degraded_step = degraded_step > 1 ? degraded_step : 1;
+    quality_.reset(new util::QualityListener(this,
+      [this, degrade_level, step, degraded_step](int32_t level) {
+        impl_->setSamplingStep(level >= degrade_level ? degraded_step : step);
+      }));
+  }
+  int32_t target_points = declare_parameter<int32_t>("roi_target_points", 0);
+  int32_t frame_budget = declare_parameter<int32_t>("frame_point_budget", 0);
+  impl_->setTargetPoints(target_points > 0 ? target_points : 0,
+    frame_budget > 0 ? frame_budget : 0);
+  impl_->setSharedSearch(declare_parameter<bool>("shared_search", false));
+  int32_t num_threads = declare_parameter<int32_t>("segmenter_threads", 1);
+  impl_->setNumThreads(num_threads > 1 ? num_threads : 1);
+  /* the executor thread segmenting is pinned by the process, see composition*/
+  util::ThreadPolicy policy = util::ThreadPolicy::declare(this, "segmenter");
+  if (!policy.empty()) {
+    impl_->setThreadPolicy(policy);
+  }
+  RCLCPP_INFO(get_logger(), "segmenter workers: %s", impl_->getThreadPolicy().c_str());
+  impl_->setBoundsTrim(declare_parameter<double>("bounds_trim", 0.0));
+  util::DetectionFilter filter;
+  filter.setMinProbability(declare_parameter<double>("min_probability", 0.0));
+  int32_t min_area = declare_parameter<int32_t>("min_roi_area", 0);
+  filter.setMinArea(min_area > 0 ? min_area : 0);
+  filter.setClasses(declare_parameter<std::vector<std::string>>("object_classes",
+    std::vector<std::string>()));
+  impl_->setFilter(filter);
 
-  sub_sync_seg = std::unique_ptr<ApproximateSynchronizer>(
-    new ApproximateSynchronizer(ApproximatePolicy(kMsgQueueSize), *objs_2d, *pcls));
-  sub_sync_seg->registerCallback(
-    std::bind(&SegmenterNode::callback, this, std::placeholders::_1, std::placeholders::_2));
-  impl_.reset(new Segmenter(std::unique_ptr<AlgorithmProvider>(new AlgorithmProviderImpl())));
-  impl_->setSamplingStep(DEFAULT_SAMPLING);
+  /* cold caches, models and first-touch allocations are paid before the first frame*/
+  if (declare_parameter<bool>("warmup", true)) {
+    int32_t width = declare_parameter<int32_t>("warmup_width", 640);
+    int32_t height = declare_parameter<int32_t>("warmup_height", 480);
+    auto start = std::chrono::steady_clock::now();
+    impl_->warmup(width > 1 ? width : 1, height > 1 ? height : 1);
+    double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+    RCLCPP_INFO(get_logger(), "segmenter warm-up %.1fms, %zu buffers allocated", ms,
+      impl_->getBufferAllocations());
+  }
+
+  if (declare_parameter<bool>("tracking_reuse", false)) {
+    int32_t still_shift = declare_parameter<int32_t>("reuse_still_shift", 2);
+    double depth_margin = declare_parameter<double>("reuse_depth_margin", 0.1);
+    int32_t max_reuse = declare_parameter<int32_t>("reuse_max_frames", 5);
+    impl_->setTemporalReuse(still_shift > 0 ? still_shift : 0, depth_margin,
+      max_reuse > 0 ? max_reuse : 0);
+    auto tracking_callback =
+      [this](const object_analytics_msgs::msg::TrackedObjects::SharedPtr tracks) {
+        impl_->setTrackedObjects(*tracks);
+      };
+    sub_tracking_ = create_subscription<object_analytics_msgs::msg::TrackedObjects>(
+      Const::kTopicTracking, tracking_callback,
+      QosProfiles::declare(this, "tracking", QosProfiles::kReliable));
+  }
+
+  if (declare_parameter<bool>("frame_trace", false)) {
+    tracer_.reset(new util::FrameTracer(this, "segmenter"));
+  }
+
+  if (declare_parameter<bool>("publish_stats", true)) {
+    auto fill = [this](object_analytics_msgs::msg::PipelineStats & msg) {
+        msg.queue_names.push_back("segmenter.cloud_cache");
+        msg.queue_depths.push_back(matcher_->getBuffered());
+        msg.drop_names.push_back("segmenter.detections_without_cloud");
+        msg.drops.push_back(matcher_->getDropped());
+        msg.drop_names.push_back("segmenter.clouds_evicted");
+        msg.drops.push_back(matcher_->getEvicted());
+        cloud_memory_->update(matcher_->getBytes());
+        cloud_memory_->collect(msg);
+      };
+    stats_.reset(new util::StatsPublisher(this, "segmenter.", fill));
+  }
+
+  set_on_parameters_set_callback(
+    std::bind(&SegmenterNode::onParametersSet, this, std::placeholders::_1));
+}
+
+bool SegmenterNode::checkConfig(const rclcpp::Parameter & param)
+{
+  const std::string & name = param.get_name();
+  if (name.compare(0, kConfigPrefix.size(), kConfigPrefix) != 0) {
+    return true;
+  }
+  /* COMPARATOR names a comparator, other items are counts and thresholds*/
+  switch (param.get_type()) {
+    case rclcpp::ParameterType::PARAMETER_NOT_SET:
+      return true;
+    case rclcpp::ParameterType::PARAMETER_STRING:
+      return name == kConfigPrefix + "COMPARATOR";
+    case rclcpp::ParameterType::PARAMETER_INTEGER:
+      return name != kConfigPrefix + "COMPARATOR" && param.as_int() >= 0;
+    case rclcpp::ParameterType::PARAMETER_DOUBLE:
+      return name != kConfigPrefix + "COMPARATOR" && param.as_double() >= 0.0;
+    default:
+      return false;
+  }
+}
+
+bool SegmenterNode::setConfig(const rclcpp::Parameter & param)
+{
+  const std::string & name = param.get_name();
+  if (name.compare(0, kConfigPrefix.size(), kConfigPrefix) != 0 ||
+    param.get_type() == rclcpp::ParameterType::PARAMETER_NOT_SET)
+  {
+    return false;
+  }
+  conf_.set(name.substr(kConfigPrefix.size()), param.value_to_string());
+  return true;
+}
+
+rcl_interfaces::msg::SetParametersResult SegmenterNode::onParametersSet(
+  const std::vector<rclcpp::Parameter> & params)
+{
+  rcl_interfaces::msg::SetParametersResult result;
+  result.successful = true;
+  /* all or nothing, a bad item leaves the algorithm as it is*/
+  for (auto & param : params) {
+    if (!checkConfig(param)) {
+      result.successful = false;
+      result.reason = param.get_name() + " rejected: " + param.value_to_string();
+      RCLCPP_WARN(get_logger(), "%s", result.reason.c_str());
+      return result;
+    }
+  }
+
+  bool changed = false;
+  for (auto & param : params) {
+    changed = setConfig(param) || changed;
+  }
+  if (changed) {
+    RCLCPP_INFO(get_logger(), "segmentation algorithm reconfigured");
+    impl_->setConfig(conf_);
+  }
+  return result;
+}
+
+void SegmenterNode::logDrops()
+{
+  if (matcher_->getDropped() == dropped_ && matcher_->getEvicted() == evicted_) {
+    return;
+  }
+  dropped_ = matcher_->getDropped();
+  evicted_ = matcher_->getEvicted();
+  RCLCPP_DEBUG(get_logger(), "detections without point cloud: %" PRIu64
+    ", point clouds evicted: %" PRIu64 ", cached %zu (%zu bytes)", dropped_, evicted_,
+    matcher_->getBuffered(), matcher_->getBytes());
 }
 
 void SegmenterNode::callback(
   const ObjectsInBoxes::ConstSharedPtr objs_2d,
   const sensor_msgs::msg::PointCloud2::ConstSharedPtr pcls)
 {
+  int64_t ingress_ns = util::FrameTracer::now();
   ObjectsInBoxes3D::SharedPtr msgs = std::make_shared<ObjectsInBoxes3D>();
-  impl_->segment(objs_2d, pcls, msgs);
+  /* the clusters are kept as indices and boxes fitted only while somebody takes them*/
+  ObjectPointIndices::SharedPtr points;
+  if (pub_points_ && pub_points_->get_subscription_count() > 0) {
+    points = std::make_shared<ObjectPointIndices>();
+  }
+  OrientedObjectsInBoxes3D::SharedPtr oriented;
+  if (pub_oriented_ && pub_oriented_->get_subscription_count() > 0) {
+    oriented = std::make_shared<OrientedObjectsInBoxes3D>();
+  }
+  impl_->segment(objs_2d, pcls, msgs, points.get(), oriented.get());
+  if (points) {
+    pub_points_->publish(points);
+  }
+  if (oriented) {
+    pub_oriented_->publish(oriented);
+  }
+  RCLCPP_DEBUG(get_logger(), "segmenter buffers allocated: %zu", impl_->getBufferAllocations());
   pub_->publish(msgs);
+  if (compact_) {
+    compact_->publish(*msgs);
+  }
+  if (tracer_) {
+    tracer_->trace(msgs->header, ingress_ns);
+  }
 }
 }  // namespace segmenter
 }  // namespace object_analytics_node
@@ -15,6 +15,9 @@
 #define PCL_NO_PRECOMPILE
 #include <pcl_conversions/pcl_conversions.h>
 #include <sensor_msgs/point_cloud2_iterator.hpp>
+#include <sensor_msgs/image_encodings.hpp>
+#include <cstring>
+#include <stdexcept>
 #include <string>
 #include "object_analytics_node/model/object3d.hpp"
 #include "object_analytics_node/splitter/splitter.hpp"
@@ -29,9 +32,14 @@ void Splitter::split(
   const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points,
   sensor_msgs::msg::Image::SharedPtr & image)
 {
-  std_msgs::msg::Header header = points->header;
-  pcl::toROSMsg(*points, *image);
-  image->header = header;
+  split(*points, *image);
+}
+
+void Splitter::split(const sensor_msgs::msg::PointCloud2 & points, sensor_msgs::msg::Image & image)
+{
+  std_msgs::msg::Header header = points.header;
+  pcl::toROSMsg(points, image);
+  image.header = header;
 }
 
 void
@@ -39,25 +47,33 @@ Splitter::splitPointsToXYZ(
   const sensor_msgs::msg::PointCloud2::ConstSharedPtr & pointsXYZRGB,
   sensor_msgs::msg::PointCloud2::SharedPtr & pointsXYZ)
 {
-  pointsXYZ->header.stamp = pointsXYZRGB->header.stamp;
-  pointsXYZ->header.frame_id = pointsXYZRGB->header.frame_id;
-  pointsXYZ->width = pointsXYZRGB->width;
-  pointsXYZ->height = pointsXYZRGB->height;
-  pointsXYZ->is_dense = false;
+  splitPointsToXYZ(*pointsXYZRGB, *pointsXYZ);
+}
 
-  sensor_msgs::PointCloud2Modifier modifier(*pointsXYZ);
+void
+Splitter::splitPointsToXYZ(
+  const sensor_msgs::msg::PointCloud2 & pointsXYZRGB,
+  sensor_msgs::msg::PointCloud2 & pointsXYZ)
+{
+  pointsXYZ.header.stamp = pointsXYZRGB.header.stamp;
+  pointsXYZ.header.frame_id = pointsXYZRGB.header.frame_id;
+  pointsXYZ.width = pointsXYZRGB.width;
+  pointsXYZ.height = pointsXYZRGB.height;
+  pointsXYZ.is_dense = false;
+
+  sensor_msgs::PointCloud2Modifier modifier(pointsXYZ);
 
   modifier.setPointCloud2FieldsByString(1, "xyz");
 
-  sensor_msgs::PointCloud2Iterator<float> out_x(*pointsXYZ, "x");
-  sensor_msgs::PointCloud2Iterator<float> out_y(*pointsXYZ, "y");
-  sensor_msgs::PointCloud2Iterator<float> out_z(*pointsXYZ, "z");
+  sensor_msgs::PointCloud2Iterator<float> out_x(pointsXYZ, "x");
+  sensor_msgs::PointCloud2Iterator<float> out_y(pointsXYZ, "y");
+  sensor_msgs::PointCloud2Iterator<float> out_z(pointsXYZ, "z");
 
-  sensor_msgs::PointCloud2ConstIterator<float> in_x(*pointsXYZRGB, "x");
-  sensor_msgs::PointCloud2ConstIterator<float> in_y(*pointsXYZRGB, "y");
-  sensor_msgs::PointCloud2ConstIterator<float> in_z(*pointsXYZRGB, "z");
+  sensor_msgs::PointCloud2ConstIterator<float> in_x(pointsXYZRGB, "x");
+  sensor_msgs::PointCloud2ConstIterator<float> in_y(pointsXYZRGB, "y");
+  sensor_msgs::PointCloud2ConstIterator<float> in_z(pointsXYZRGB, "z");
 
-  for (size_t i = 0; i < pointsXYZ->height * pointsXYZ->width; ++i,
+  for (size_t i = 0; i < pointsXYZ.height * pointsXYZ.width; ++i,
     ++out_x, ++out_y, ++out_z, ++in_x, ++in_y, ++in_z)
   {
     *out_x = *in_x;
@@ -66,5 +82,69 @@ Splitter::splitPointsToXYZ(
   }
 }
 
+void Splitter::split(
+  const sensor_msgs::msg::PointCloud2 & points, sensor_msgs::msg::Image & image,
+  sensor_msgs::msg::PointCloud2 & points_xyz)
+{
+  const sensor_msgs::msg::PointField * field_x = nullptr, * field_rgb = nullptr;
+  bool xyz_packed = true;
+  const char * names[] = {"x", "y", "z"};
+  for (size_t i = 0; i < 3; i++) {
+    const sensor_msgs::msg::PointField * field = nullptr;
+    for (auto & f : points.fields) {
+      field = f.name == names[i] ? &f : field;
+    }
+    /* x, y and z as consecutive floats are copied together*/
+    if (field == nullptr || field->datatype != sensor_msgs::msg::PointField::FLOAT32 ||
+      (field_x != nullptr && field->offset != field_x->offset + i * sizeof(float)))
+    {
+      xyz_packed = false;
+      break;
+    }
+    field_x = i == 0 ? field : field_x;
+  }
+  for (auto & f : points.fields) {
+    field_rgb = f.name == "rgb" ? &f : field_rgb;
+  }
+  size_t row_bytes = static_cast<size_t>(points.width) * points.point_step;
+  if (!xyz_packed || field_rgb == nullptr || points.row_step < row_bytes ||
+    points.data.size() < static_cast<size_t>(points.row_step) * points.height)
+  {
+    split(points, image);
+    splitPointsToXYZ(points, points_xyz);
+    return;
+  }
+
+  image.header = points.header;
+  image.width = points.width;
+  image.height = points.height;
+  image.is_bigendian = points.is_bigendian;
+  image.encoding = sensor_msgs::image_encodings::BGR8;
+  image.step = image.width * 3;
+  image.data.resize(static_cast<size_t>(image.step) * image.height);
+
+  points_xyz.header = points.header;
+  points_xyz.width = points.width;
+  points_xyz.height = points.height;
+  points_xyz.is_dense = false;
+  sensor_msgs::PointCloud2Modifier modifier(points_xyz);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+
+  /* rows may be padded, points are read at their stride*/
+  const size_t in_step = points.point_step;
+  const size_t out_step = points_xyz.point_step;
+  const size_t xyz_offset = field_x->offset;
+  const size_t rgb_offset = field_rgb->offset;
+  uint8_t * pixel = image.data.data();
+  uint8_t * out = points_xyz.data.data();
+  for (size_t y = 0; y < points.height; y++) {
+    const uint8_t * in = points.data.data() + y * points.row_step;
+    for (size_t x = 0; x < points.width; x++, in += in_step, out += out_step, pixel += 3) {
+      std::memcpy(out, in + xyz_offset, 3 * sizeof(float));
+      std::memcpy(pixel, in + rgb_offset, 3);
+    }
+  }
+}
+
 }  // namespace splitter
 }  // namespace object_analytics_node
@@ -15,9 +15,17 @@
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
 
+#include <functional>
 #include <memory>
+#include <stdexcept>
+#include <utility>
 #include "object_analytics_node/const.hpp"
 #include "object_analytics_node/splitter/splitter_node.hpp"
+#include "object_analytics_node/util/cloud_codec.hpp"
+#include "object_analytics_node/util/frame_tracer.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+#include "object_analytics_node/util/roi_crop.hpp"
+#include "object_analytics_node/util/stage_stats.hpp"
 
 namespace object_analytics_node
 {
@@ -26,26 +34,146 @@ namespace splitter
 SplitterNode::SplitterNode(rclcpp::NodeOptions options)
 : Node("SplitterNode", options)
 {
-  pub_2d_ = create_publisher<sensor_msgs::msg::Image>(Const::kTopicRgb);
-  pub_3d_ = create_publisher<sensor_msgs::msg::PointCloud2>(Const::kTopicPC2);
+  /* reliable publishers match best effort subscribers as well*/
+  pub_2d_ = create_publisher<sensor_msgs::msg::Image>(Const::kTopicRgb,
+      util::QosProfiles::declare(this, "rgb", util::QosProfiles::kReliable));
+  pub_3d_ = create_publisher<sensor_msgs::msg::PointCloud2>(Const::kTopicPC2,
+      util::QosProfiles::declare(this, "pointcloud", util::QosProfiles::kReliable));
+  pub_compressed_ = create_publisher<object_analytics_msgs::msg::CompressedPointCloud>(
+    Const::kTopicCompressedPC2,
+    util::QosProfiles::declare(this, "compressed_points", util::QosProfiles::kReliable));
+
+  if (declare_parameter<bool>("roi_crop", false)) {
+    pub_cropped_ = create_publisher<object_analytics_msgs::msg::CroppedPointCloud>(
+      Const::kTopicCroppedPC2,
+      util::QosProfiles::declare(this, "cropped_points", util::QosProfiles::kReliable));
+    int32_t margin = declare_parameter<int32_t>("roi_margin", 16);
+    roi_margin_ = margin > 0 ? margin : 0;
+    int32_t cache_mb = declare_parameter<int32_t>("cloud_cache_mb", 64);
+    matcher_.reset(new Matcher(
+        std::bind(&SplitterNode::crop, this, std::placeholders::_1, std::placeholders::_2),
+        static_cast<size_t>(cache_mb > 1 ? cache_mb : 1) << 20));
+    auto objs_callback = [this](const object_msgs::msg::ObjectsInBoxes::SharedPtr objs) {
+        matcher_->addFirst(rclcpp::Time(objs->header.stamp).nanoseconds(), objs);
+      };
+    sub_objs_ = create_subscription<object_msgs::msg::ObjectsInBoxes>(Const::kTopicDetection,
+        objs_callback,
+        util::QosProfiles::declare(this, "detection", util::QosProfiles::kReliable));
+  }
+
+  int32_t decimation = declare_parameter<int32_t>("xyz_decimation", 1);
+  xyz_decimation_ = decimation > 1 ? decimation : 1;
+  full_decimation_ = xyz_decimation_;
+  int32_t degrade_level = declare_parameter<int32_t>("degrade_level", 4);
+  int32_t degraded = declare_parameter<int32_t>("degraded_xyz_decimation",
+      static_cast<int32_t>(2 * full_decimation_));
+  if (degrade_level > 0) {
+    uint64_t degraded_decimation = degraded > 1 ? degraded : 1;
+    quality_.reset(new util::QualityListener(this,
+      [this, degrade_level, degraded_decimation](int32_t level) {
+        xyz_decimation_ = level >= degrade_level ? degraded_decimation : full_decimation_;
+      }));
+  }
+
+  if (declare_parameter<bool>("frame_trace", false)) {
+    tracer_.reset(new util::FrameTracer(this, "splitter"));
+  }
 
   auto callback = [this](const typename sensor_msgs::msg::PointCloud2::SharedPtr points) -> void {
+      int64_t ingress_ns = util::FrameTracer::now();
+      /* cropped once the detections of the same stamp arrive*/
+      if (matcher_) {
+        matcher_->addSecond(rclcpp::Time(points->header.stamp).nanoseconds(), points,
+          points->data.size());
+      }
+      /* outputs nobody listens to are not computed*/
+      bool want_2d = pub_2d_->get_subscription_count() > 0;
+      bool xyz_frame = frames_ % xyz_decimation_ == 0;
+      bool want_3d = pub_3d_->get_subscription_count() > 0 && xyz_frame;
+      bool want_compressed = pub_compressed_->get_subscription_count() > 0 && xyz_frame;
+      frames_++;
+      static util::StageStats & split_stats = util::StageRegistry::get("splitter.split");
+      static util::StageStats & encode_stats = util::StageRegistry::get("splitter.encode");
       try {
-        sensor_msgs::msg::Image::SharedPtr image = std::make_shared<sensor_msgs::msg::Image>();
-        Splitter::split(points, image);
-        pub_2d_->publish(image);
-
-        sensor_msgs::msg::PointCloud2::SharedPtr pointsXYZ =
-          std::make_shared<sensor_msgs::msg::PointCloud2>();
-        Splitter::splitPointsToXYZ(points, pointsXYZ);
-        pub_3d_->publish(pointsXYZ);
+        /* moved to the subscribers without copy with intra-process comms*/
+        sensor_msgs::msg::Image::UniquePtr image;
+        sensor_msgs::msg::PointCloud2::UniquePtr pointsXYZ;
+        std::unique_ptr<util::ScopedStageTimer> timer;
+        if (want_2d || want_3d) {
+          timer.reset(new util::ScopedStageTimer(split_stats));
+        }
+        if (want_2d && want_3d) {
+          image = std::make_unique<sensor_msgs::msg::Image>();
+          pointsXYZ = std::make_unique<sensor_msgs::msg::PointCloud2>();
+          Splitter::split(*points, *image, *pointsXYZ);
+        } else if (want_2d) {
+          image = std::make_unique<sensor_msgs::msg::Image>();
+          Splitter::split(*points, *image);
+        } else if (want_3d) {
+          pointsXYZ = std::make_unique<sensor_msgs::msg::PointCloud2>();
+          Splitter::splitPointsToXYZ(*points, *pointsXYZ);
+        }
+        timer.reset();
+        if (image) {
+          pub_2d_->publish(std::move(image));
+        }
+        if (pointsXYZ) {
+          pub_3d_->publish(std::move(pointsXYZ));
+        }
+        if (want_compressed) {
+          auto compressed = std::make_unique<object_analytics_msgs::msg::CompressedPointCloud>();
+          {
+            util::ScopedStageTimer encode_timer(encode_stats);
+            util::CloudCodec::encode(*points, *compressed);
+          }
+          pub_compressed_->publish(std::move(compressed));
+        }
+        if (tracer_ && (want_2d || want_3d || want_compressed)) {
+          tracer_->trace(points->header, ingress_ns);
+        }
       } catch (const std::runtime_error & e) {
         RCLCPP_ERROR(this->get_logger(),
           "caught exception %s while splitting, skip this message", e.what());
+        errors_++;
       }
     };
-  sub_pc2_ =
-    create_subscription<sensor_msgs::msg::PointCloud2>(Const::kTopicRegisteredPC2, callback);
+  sub_pc2_ = create_subscription<sensor_msgs::msg::PointCloud2>(Const::kTopicRegisteredPC2,
+      callback, util::QosProfiles::declare(this, "registered_points", util::QosProfiles::kSensor));
+
+  if (declare_parameter<bool>("publish_stats", true)) {
+    auto fill = [this](object_analytics_msgs::msg::PipelineStats & msg) {
+        msg.drop_names.push_back("splitter.errors");
+        msg.drops.push_back(errors_);
+        if (matcher_) {
+          msg.queue_names.push_back("splitter.cloud_cache");
+          msg.queue_depths.push_back(matcher_->getBuffered());
+          msg.drop_names.push_back("splitter.detections_without_cloud");
+          msg.drops.push_back(matcher_->getDropped());
+        }
+      };
+    stats_.reset(new util::StatsPublisher(this, "splitter.", fill));
+  }
+}
+
+void SplitterNode::crop(
+  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+  const sensor_msgs::msg::PointCloud2::ConstSharedPtr & points)
+{
+  static util::StageStats & crop_stats = util::StageRegistry::get("splitter.crop");
+  util::RoiCrop::getWindows(*objs, points->width, points->height, roi_margin_, windows_);
+  if (windows_.empty()) {
+    return;
+  }
+  auto cropped = std::make_unique<object_analytics_msgs::msg::CroppedPointCloud>();
+  try {
+    util::ScopedStageTimer timer(crop_stats);
+    util::RoiCrop::crop(*points, windows_, *cropped);
+  } catch (const std::runtime_error & e) {
+    RCLCPP_ERROR(get_logger(), "caught exception %s while cropping, skip this message", e.what());
+    errors_++;
+    return;
+  }
+  pub_cropped_->publish(std::move(cropped));
 }
 }  // namespace splitter
 }  // namespace object_analytics_node
@@ -0,0 +1,132 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/frame_trace.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "object_analytics_node/const.hpp"
+#include "rcutils/cmdline_parser.h"
+
+void show_usage()
+{
+  RCUTILS_LOG_INFO("Usage for frame_trace_report:\n");
+  RCUTILS_LOG_INFO("frame_trace_report [-d seconds] [-o report_file] [-h]\n");
+  RCUTILS_LOG_INFO("options:\n");
+  RCUTILS_LOG_INFO("-h : Print this help function.\n");
+  RCUTILS_LOG_INFO("-d seconds : Stop collecting after the seconds, default till Ctrl-C.\n");
+  RCUTILS_LOG_INFO("-o report_file : Write the report as CSV, default to stdout.\n");
+}
+
+/** @brief Latencies of the frames traced by one stage, in milliseconds.*/
+struct StageLatency
+{
+  std::vector<double> residence;  /**< Egress minus ingress in the stage.*/
+  std::vector<double> since_capture;  /**< Publish time minus the capture stamp.*/
+};
+
+/** @brief Nearest rank percentile, the samples are sorted.*/
+static double percentile(std::vector<double> & samples, double p)
+{
+  if (samples.empty()) {return 0.;}
+  std::sort(samples.begin(), samples.end());
+  size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+  return samples[rank > 0 ? rank - 1 : 0];
+}
+
+class FrameTraceReport : public rclcpp::Node
+{
+public:
+  FrameTraceReport()
+  : Node("frame_trace_report")
+  {
+    auto callback = [this](const object_analytics_msgs::msg::FrameTrace::SharedPtr trace) {
+        StageLatency & stage = stages_[trace->stage];
+        stage.residence.push_back((trace->egress_ns - trace->ingress_ns) / 1e6);
+        rclcpp::Duration since = rclcpp::Time(trace->published) - rclcpp::Time(trace->header.stamp);
+        stage.since_capture.push_back(since.nanoseconds() / 1e6);
+      };
+    sub_ = create_subscription<object_analytics_msgs::msg::FrameTrace>(
+      object_analytics_node::Const::kTopicFrameTrace, callback);
+  }
+
+  void report(std::ostream & os)
+  {
+    os << std::fixed << std::setprecision(3);
+    os << "stage,frames,p50_ms,p95_ms,p99_ms,max_ms,"
+      "capture_p50_ms,capture_p95_ms,capture_p99_ms,capture_max_ms\n";
+    for (auto & s : stages_) {
+      StageLatency & l = s.second;
+      os << s.first << "," << l.residence.size() << "," << percentile(l.residence, 0.50) <<
+        "," << percentile(l.residence, 0.95) << "," << percentile(l.residence, 0.99) << "," <<
+        percentile(l.residence, 1.0) << "," << percentile(l.since_capture, 0.50) << "," <<
+        percentile(l.since_capture, 0.95) << "," << percentile(l.since_capture, 0.99) << "," <<
+        percentile(l.since_capture, 1.0) << "\n";
+    }
+  }
+
+private:
+  rclcpp::Subscription<object_analytics_msgs::msg::FrameTrace>::SharedPtr sub_;
+  std::map<std::string, StageLatency> stages_;
+};
+
+int main(int argc, char * argv[])
+{
+  if (rcutils_cli_option_exist(argv, argv + argc, "-h")) {
+    show_usage();
+    return 0;
+  }
+  double duration = 0.;
+  std::string file;
+  if (rcutils_cli_option_exist(argv, argv + argc, "-d")) {
+    duration = std::stod(rcutils_cli_get_option(argv, argv + argc, "-d"));
+  }
+  if (rcutils_cli_option_exist(argv, argv + argc, "-o")) {
+    file = rcutils_cli_get_option(argv, argv + argc, "-o");
+  }
+
+  rclcpp::init(argc, argv);
+  auto node = std::make_shared<FrameTraceReport>();
+  rclcpp::executors::SingleThreadedExecutor exec;
+  exec.add_node(node);
+  /* the executor returns with Ctrl-C, the report is written thereafter*/
+  if (duration > 0.) {
+    auto end = std::chrono::steady_clock::now() +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(duration));
+    while (rclcpp::ok() && std::chrono::steady_clock::now() < end) {
+      exec.spin_once(std::chrono::milliseconds(100));
+    }
+  } else {
+    exec.spin();
+  }
+
+  if (file.empty()) {
+    node->report(std::cout);
+  } else {
+    std::ofstream of(file);
+    node->report(of);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
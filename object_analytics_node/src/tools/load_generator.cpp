@@ -0,0 +1,351 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/pipeline_stats.hpp>
+#include <object_msgs/msg/objects_in_boxes.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+
+using object_analytics_node::Const;
+using object_analytics_node::util::QosProfiles;
+
+/** @brief A box of the synthetic scene, fronto-parallel at a fixed depth.*/
+struct Box
+{
+  double x, y;        /**< Top left in pixels.*/
+  double vx, vy;      /**< Velocity in pixels per frame.*/
+  int width, height;  /**< Size in pixels.*/
+  float z;            /**< Depth in meters.*/
+  uint8_t rgb[3];     /**< Color.*/
+  std::string name;   /**< Class detected.*/
+};
+
+/** @brief Stage statistics merged over one step of the ramp.*/
+struct StepTotal
+{
+  uint64_t count = 0;
+  double sum_ms = 0.;
+  double max_ms = 0.;
+};
+
+/**
+ * Publisher of synthetic organized point clouds with box shaped objects, their detections and
+ * the rgb frames, at a configurable resolution, rate and object count, to drive SegmenterNode
+ * and TrackingNode under controlled load.
+ *
+ * Parameters:
+ *   - width, height. Resolution of the clouds and frames, default 640 x 480, e.g. 3840 x 2160.
+ *   - rate_hz. Frames published per second, default 30.
+ *   - objects. Objects of the first step, default 10.
+ *   - object_step, step_seconds, max_objects. Objects added every step_seconds up to
+ *     max_objects, default 0 for a constant count, 10s and 200.
+ *   - detection_interval. Detections published for one of every this many frames, default 1.
+ *   - registered. Publish XYZRGB clouds on the input of the splitter instead of XYZ clouds and
+ *     rgb frames on the inputs of the segmenter and the tracker, default false.
+ *   - report. CSV of the stage latencies and drops of each step, taken from the pipeline stats,
+ *     default empty for stdout.
+ *   - seed. Seed of the scene, default 1.
+ */
+class LoadGenerator : public rclcpp::Node
+{
+public:
+  LoadGenerator()
+  : Node("load_generator"), frames_(0)
+  {
+    width_ = std::max(16, static_cast<int>(declare_parameter<int32_t>("width", 640)));
+    height_ = std::max(16, static_cast<int>(declare_parameter<int32_t>("height", 480)));
+    double rate = declare_parameter<double>("rate_hz", 30.0);
+    objects_ = std::max(0, static_cast<int>(declare_parameter<int32_t>("objects", 10)));
+    object_step_ = std::max(0, static_cast<int>(declare_parameter<int32_t>("object_step", 0)));
+    step_seconds_ = declare_parameter<double>("step_seconds", 10.0);
+    max_objects_ = std::max(objects_,
+        static_cast<int>(declare_parameter<int32_t>("max_objects", 200)));
+    detection_interval_ = std::max(1,
+        static_cast<int>(declare_parameter<int32_t>("detection_interval", 1)));
+    registered_ = declare_parameter<bool>("registered", false);
+    frame_id_ = declare_parameter<std::string>("frame_id", "camera_color_optical_frame");
+    std::string report = declare_parameter<std::string>("report", "");
+    rng_.seed(static_cast<uint32_t>(declare_parameter<int32_t>("seed", 1)));
+    if (!report.empty()) {
+      file_.open(report);
+    }
+    out_ = file_.is_open() ? &file_ : &std::cout;
+    *out_ << "objects,width,height,rate_hz,metric,name,count,mean_ms,max_ms" << std::endl;
+
+    if (registered_) {
+      pub_registered_ = create_publisher<sensor_msgs::msg::PointCloud2>(
+        Const::kTopicRegisteredPC2, QosProfiles::declare(this, "pointcloud", QosProfiles::kSensor));
+    } else {
+      pub_points_ = create_publisher<sensor_msgs::msg::PointCloud2>(Const::kTopicPC2,
+          QosProfiles::declare(this, "pointcloud", QosProfiles::kSensor));
+      pub_rgb_ = create_publisher<sensor_msgs::msg::Image>(Const::kTopicRgb,
+          QosProfiles::declare(this, "rgb", QosProfiles::kSensor));
+    }
+    pub_objs_ = create_publisher<object_msgs::msg::ObjectsInBoxes>(Const::kTopicDetection,
+        QosProfiles::declare(this, "detection", QosProfiles::kReliable));
+    sub_stats_ = create_subscription<object_analytics_msgs::msg::PipelineStats>(
+      Const::kTopicPipelineStats,
+      [this](const object_analytics_msgs::msg::PipelineStats::SharedPtr stats) {collect(*stats);},
+      QosProfiles::declare(this, "pipeline_stats", QosProfiles::kReliable));
+
+    addBoxes(objects_);
+    step_start_ = std::chrono::steady_clock::now();
+    rate_hz_ = rate > 0 ? rate : 30.0;
+    timer_ = create_wall_timer(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(1.0 / rate_hz_)),
+      std::bind(&LoadGenerator::publish, this));
+  }
+
+  ~LoadGenerator()
+  {
+    report();
+  }
+
+private:
+  void addBoxes(int count)
+  {
+    static const char * kNames[] = {"person", "chair", "car", "dog", "bottle"};
+    std::uniform_real_distribution<double> unit(0., 1.);
+    int min_side = std::max(8, width_ / 40);
+    int max_side = std::max(min_side + 1, width_ / 8);
+    while (static_cast<int>(boxes_.size()) < count) {
+      Box b;
+      b.width = min_side + static_cast<int>(unit(rng_) * (max_side - min_side));
+      b.height = min_side + static_cast<int>(unit(rng_) * (max_side - min_side));
+      b.x = unit(rng_) * (width_ - b.width);
+      b.y = unit(rng_) * (height_ - b.height);
+      b.vx = (unit(rng_) - 0.5) * 6.;
+      b.vy = (unit(rng_) - 0.5) * 2.;
+      b.z = static_cast<float>(1.0 + unit(rng_) * 3.0);
+      for (auto & c : b.rgb) {
+        c = static_cast<uint8_t>(64 + unit(rng_) * 191);
+      }
+      b.name = kNames[boxes_.size() % (sizeof(kNames) / sizeof(kNames[0]))];
+      boxes_.push_back(b);
+    }
+    /* painted far to near, the nearer box occludes*/
+    std::stable_sort(boxes_.begin(), boxes_.end(),
+      [](const Box & a, const Box & b) {return a.z > b.z;});
+  }
+
+  void move()
+  {
+    for (auto & b : boxes_) {
+      b.x += b.vx;
+      b.y += b.vy;
+      if (b.x < 0 || b.x + b.width > width_) {
+        b.vx = -b.vx;
+        b.x = std::min(std::max(b.x, 0.), static_cast<double>(width_ - b.width));
+      }
+      if (b.y < 0 || b.y + b.height > height_) {
+        b.vy = -b.vy;
+        b.y = std::min(std::max(b.y, 0.), static_cast<double>(height_ - b.height));
+      }
+    }
+  }
+
+  void publish()
+  {
+    if (object_step_ > 0 && static_cast<int>(boxes_.size()) < max_objects_ &&
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - step_start_).count() >=
+      step_seconds_)
+    {
+      report();
+      addBoxes(std::min(max_objects_, static_cast<int>(boxes_.size()) + object_step_));
+    }
+    move();
+
+    std_msgs::msg::Header header;
+    header.stamp = now();
+    header.frame_id = frame_id_;
+    render();
+    auto cloud = std::make_shared<sensor_msgs::msg::PointCloud2>();
+    fillCloud(header, *cloud);
+    if (registered_) {
+      pub_registered_->publish(cloud);
+    } else {
+      pub_points_->publish(cloud);
+      auto image = std::make_shared<sensor_msgs::msg::Image>();
+      image->header = header;
+      image->width = width_;
+      image->height = height_;
+      image->encoding = "rgb8";
+      image->step = width_ * 3;
+      image->data = rgb_;
+      pub_rgb_->publish(image);
+    }
+
+    if (frames_++ % detection_interval_ == 0) {
+      auto objs = std::make_shared<object_msgs::msg::ObjectsInBoxes>();
+      objs->header = header;
+      objs->objects_vector.resize(boxes_.size());
+      for (size_t i = 0; i < boxes_.size(); i++) {
+        object_msgs::msg::ObjectInBox & obj = objs->objects_vector[i];
+        obj.object.object_name = boxes_[i].name;
+        obj.object.probability = 0.9f;
+        obj.roi.x_offset = static_cast<uint32_t>(boxes_[i].x);
+        obj.roi.y_offset = static_cast<uint32_t>(boxes_[i].y);
+        obj.roi.width = boxes_[i].width;
+        obj.roi.height = boxes_[i].height;
+      }
+      pub_objs_->publish(objs);
+    }
+  }
+
+  /** @brief Paint the depth and the colors of the scene, a wall at 5m behind the boxes.*/
+  void render()
+  {
+    size_t pixels = static_cast<size_t>(width_) * height_;
+    depth_.assign(pixels, 5.0f);
+    rgb_.assign(pixels * 3, 96);
+    for (auto & b : boxes_) {
+      int x0 = static_cast<int>(b.x), y0 = static_cast<int>(b.y);
+      for (int y = y0; y < std::min(height_, y0 + b.height); y++) {
+        std::fill(depth_.begin() + y * width_ + x0,
+          depth_.begin() + y * width_ + std::min(width_, x0 + b.width), b.z);
+        uint8_t * p = &rgb_[(static_cast<size_t>(y) * width_ + x0) * 3];
+        for (int x = x0; x < std::min(width_, x0 + b.width); x++, p += 3) {
+          std::memcpy(p, b.rgb, 3);
+        }
+      }
+    }
+  }
+
+  /** @brief Organized cloud of the depth, laid out as pcl::PointXYZ or pcl::PointXYZRGB.*/
+  void fillCloud(const std_msgs::msg::Header & header, sensor_msgs::msg::PointCloud2 & cloud)
+  {
+    cloud.header = header;
+    cloud.width = width_;
+    cloud.height = height_;
+    cloud.is_bigendian = false;
+    cloud.is_dense = true;
+    const char * names[] = {"x", "y", "z", "rgb"};
+    cloud.fields.resize(registered_ ? 4 : 3);
+    for (size_t i = 0; i < cloud.fields.size(); i++) {
+      cloud.fields[i].name = names[i];
+      cloud.fields[i].offset = static_cast<uint32_t>(i < 3 ? i * 4 : 16);
+      cloud.fields[i].datatype = sensor_msgs::msg::PointField::FLOAT32;
+      cloud.fields[i].count = 1;
+    }
+    cloud.point_step = registered_ ? 32 : 16;
+    cloud.row_step = cloud.point_step * width_;
+    cloud.data.assign(static_cast<size_t>(cloud.row_step) * height_, 0);
+
+    const float focal = static_cast<float>(width_);
+    for (int y = 0; y < height_; y++) {
+      uint8_t * p = &cloud.data[static_cast<size_t>(y) * cloud.row_step];
+      for (int x = 0; x < width_; x++, p += cloud.point_step) {
+        size_t i = static_cast<size_t>(y) * width_ + x;
+        float z = depth_[i];
+        float xyz[3] = {(x - width_ / 2.0f) * z / focal, (y - height_ / 2.0f) * z / focal, z};
+        std::memcpy(p, xyz, sizeof(xyz));
+        if (registered_) {
+          /* packed as pcl, b in the lowest byte*/
+          uint32_t rgb = (static_cast<uint32_t>(rgb_[i * 3]) << 16) |
+            (static_cast<uint32_t>(rgb_[i * 3 + 1]) << 8) | rgb_[i * 3 + 2];
+          std::memcpy(p + 16, &rgb, sizeof(rgb));
+        }
+      }
+    }
+  }
+
+  /** @brief Merge the stats of every component published during the step.*/
+  void collect(const object_analytics_msgs::msg::PipelineStats & stats)
+  {
+    for (auto & s : stats.stages) {
+      StepTotal & total = stages_[s.name];
+      total.count += s.count;
+      total.sum_ms += s.mean_ms * s.count;
+      total.max_ms = std::max(total.max_ms, s.max_ms);
+    }
+    for (size_t i = 0; i < stats.drop_names.size() && i < stats.drops.size(); i++) {
+      drops_[stats.drop_names[i]] = stats.drops[i];
+    }
+  }
+
+  /** @brief Write the row of each stage and drop counter of the step, and start the next.*/
+  void report()
+  {
+    std::string key = std::to_string(boxes_.size()) + "," + std::to_string(width_) + "," +
+      std::to_string(height_) + ",";
+    *out_ << std::fixed << std::setprecision(3);
+    for (auto & s : stages_) {
+      const StepTotal & t = s.second;
+      *out_ << key << rate_hz_ << ",stage_ms," << s.first << "," << t.count << "," <<
+        (t.count > 0 ? t.sum_ms / t.count : 0.) << "," << t.max_ms << "\n";
+    }
+    /* counters accumulate since start, the step takes the difference*/
+    for (auto & d : drops_) {
+      *out_ << key << rate_hz_ << ",drops," << d.first << "," <<
+        d.second - step_drops_[d.first] << ",,\n";
+    }
+    out_->flush();
+    step_drops_ = drops_;
+    stages_.clear();
+    step_start_ = std::chrono::steady_clock::now();
+  }
+
+  int width_, height_;
+  double rate_hz_;
+  int objects_, object_step_, max_objects_;
+  double step_seconds_;
+  int detection_interval_;
+  bool registered_;
+  std::string frame_id_;
+  uint64_t frames_;
+  std::mt19937 rng_;
+  std::vector<Box> boxes_;
+  std::vector<float> depth_;
+  std::vector<uint8_t> rgb_;
+  std::ofstream file_;
+  std::ostream * out_;
+  std::chrono::steady_clock::time_point step_start_;
+  std::map<std::string, StepTotal> stages_;
+  std::map<std::string, uint64_t> drops_;
+  std::map<std::string, uint64_t> step_drops_;
+  rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr pub_points_;
+  rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr pub_registered_;
+  rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr pub_rgb_;
+  rclcpp::Publisher<object_msgs::msg::ObjectsInBoxes>::SharedPtr pub_objs_;
+  rclcpp::Subscription<object_analytics_msgs::msg::PipelineStats>::SharedPtr sub_stats_;
+  rclcpp::TimerBase::SharedPtr timer_;
+};
+
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+  {
+    auto node = std::make_shared<LoadGenerator>();
+    rclcpp::spin(node);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,395 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define PCL_NO_PRECOMPILE
+#include <rclcpp/rclcpp.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <pcl/io/pcd_io.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "object_analytics_node/segmenter/algorithm_provider_impl.hpp"
+#include "object_analytics_node/segmenter/segmenter.hpp"
+#include "object_analytics_node/tracker/frame_context.hpp"
+#include "object_analytics_node/tracker/tracking_manager.hpp"
+#include "object_analytics_node/tracker/tracking_node.hpp"
+#include "object_analytics_node/tracker/tracking_stream.hpp"
+#include "object_analytics_node/util/session_reader.hpp"
+#include "object_analytics_node/util/thread_pool.hpp"
+#include "rcutils/cmdline_parser.h"
+
+using object_analytics_node::segmenter::AlgorithmConfig;
+using object_analytics_node::segmenter::AlgorithmProvider;
+using object_analytics_node::segmenter::AlgorithmProviderImpl;
+using object_analytics_node::segmenter::Segmenter;
+using object_analytics_node::tracker::FrameContext;
+using object_analytics_node::tracker::TrackingManager;
+using object_analytics_node::tracker::TrackingNode;
+using object_analytics_node::tracker::TrackingStream;
+using object_analytics_node::util::SessionReader;
+
+void show_usage()
+{
+  RCUTILS_LOG_INFO("Usage for offline_pipeline:\n");
+  RCUTILS_LOG_INFO(
+    "offline_pipeline -f session.csv [-o prefix] [-j threads] [-h]"
+    " [--ros-args --params-file params.yaml]\n");
+  RCUTILS_LOG_INFO("options:\n");
+  RCUTILS_LOG_INFO("-h : Print this help function.\n");
+  RCUTILS_LOG_INFO(
+    "-f session.csv : One line per frame or detection, stamp_ns,image,pcd followed by\n"
+    "   name,probability,x,y,width,height for a detection. Consecutive lines of a stamp are one\n"
+    "   frame, paths are relative to the csv, the pcd may be empty.\n");
+  RCUTILS_LOG_INFO(
+    "-o prefix : Output files prefix.localization.csv and prefix.tracking.csv, default"
+    " offline.\n");
+  RCUTILS_LOG_INFO("-j threads : Frames loaded and segmented in parallel, default all cores.\n");
+  RCUTILS_LOG_INFO(
+    "The segmenter and the tracker are configured by the parameters of the nodes SegmenterNode\n"
+    "and TrackingNode, the parameter file of the online pipeline applies.\n");
+}
+
+/** @brief A recorded frame, loaded and segmented by the frame workers.*/
+struct Frame
+{
+  int64_t stamp = 0;
+  std::string image;
+  std::string pcd;
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs;
+  cv::Mat bgr;
+  object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr loc;
+  bool ok = false;
+};
+
+/** @brief Parameters of SegmenterNode taken by the frame workers.*/
+struct SegmenterOptions
+{
+  std::string algorithm;
+  AlgorithmConfig conf;
+  size_t step;
+  size_t target_points;
+  size_t frame_budget;
+  bool shared_search;
+  double bounds_trim;
+  object_analytics_node::util::DetectionFilter filter;
+
+  explicit SegmenterOptions(rclcpp::Node * node)
+  {
+    algorithm = node->declare_parameter<std::string>("segmentation_algorithm",
+        AlgorithmProviderImpl::kMultiPlane);
+    for (auto & key : AlgorithmProviderImpl::getConfigKeys()) {
+      rclcpp::Parameter param("algorithm." + key, node->declare_parameter("algorithm." + key));
+      if (param.get_type() != rclcpp::ParameterType::PARAMETER_NOT_SET) {
+        conf.set(key, param.value_to_string());
+      }
+    }
+    step = std::max<int32_t>(node->declare_parameter<int32_t>("sampling_step", 10), 1);
+    target_points = std::max<int32_t>(node->declare_parameter<int32_t>("roi_target_points", 0), 0);
+    frame_budget = std::max<int32_t>(node->declare_parameter<int32_t>("frame_point_budget", 0), 0);
+    shared_search = node->declare_parameter<bool>("shared_search", false);
+    bounds_trim = node->declare_parameter<double>("bounds_trim", 0.0);
+    filter.setMinProbability(node->declare_parameter<double>("min_probability", 0.0));
+    filter.setMinArea(std::max<int32_t>(node->declare_parameter<int32_t>("min_roi_area", 0), 0));
+    filter.setClasses(node->declare_parameter<std::vector<std::string>>("object_classes",
+      std::vector<std::string>()));
+  }
+
+  std::unique_ptr<Segmenter> create() const
+  {
+    std::unique_ptr<Segmenter> segmenter(new Segmenter(std::unique_ptr<AlgorithmProvider>(
+        new AlgorithmProviderImpl(algorithm, conf))));
+    segmenter->setSamplingStep(step);
+    segmenter->setTargetPoints(target_points, frame_budget);
+    segmenter->setSharedSearch(shared_search);
+    segmenter->setBoundsTrim(bounds_trim);
+    segmenter->setFilter(filter);
+    return segmenter;
+  }
+};
+
+/** @brief Segmenters of the frame workers, each used by one frame at a time.*/
+class SegmenterPool
+{
+public:
+  explicit SegmenterPool(const SegmenterOptions & options)
+  : options_(options) {}
+
+  std::unique_ptr<Segmenter> take()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.empty()) {
+      return options_.create();
+    }
+    std::unique_ptr<Segmenter> segmenter = std::move(idle_.back());
+    idle_.pop_back();
+    return segmenter;
+  }
+
+  void give(std::unique_ptr<Segmenter> segmenter)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(std::move(segmenter));
+  }
+
+private:
+  const SegmenterOptions & options_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Segmenter>> idle_;
+};
+
+/* load a frame and localize its detections, frames are independent of each other*/
+void process(Frame & frame, SegmenterPool & segmenters)
+{
+  frame.bgr = cv::imread(frame.image, cv::IMREAD_COLOR);
+  if (frame.bgr.empty()) {
+    RCUTILS_LOG_WARN("cannot read %s, frame skipped\n", frame.image.c_str());
+    return;
+  }
+  frame.ok = true;
+  if (frame.objs->objects_vector.empty() || frame.pcd.empty()) {
+    return;
+  }
+  pcl::PCLPointCloud2 blob;
+  if (pcl::io::loadPCDFile(frame.pcd, blob) == -1) {
+    RCUTILS_LOG_WARN("cannot read %s, frame not localized\n", frame.pcd.c_str());
+    return;
+  }
+  auto cloud = std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl_conversions::fromPCL(blob, *cloud);
+  cloud->header = frame.objs->header;
+  frame.loc = std::make_shared<object_analytics_msgs::msg::ObjectsInBoxes3D>();
+  std::unique_ptr<Segmenter> segmenter = segmenters.take();
+  segmenter->segment(frame.objs, cloud, frame.loc);
+  segmenters.give(std::move(segmenter));
+  frame.loc->header = frame.objs->header;
+}
+
+/** @brief Ordered tracking stage, fed with batches of processed frames.*/
+class TrackingStage
+{
+public:
+  TrackingStage(
+    TrackingManager & tm, const TrackingStream::Options & opts, std::ostream & loc_out,
+    std::ostream & track_out)
+  : tm_(tm), opts_(opts), loc_out_(loc_out), track_out_(track_out),
+    thread_(&TrackingStage::run, this) {}
+
+  ~TrackingStage()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    cond_.notify_all();
+    thread_.join();
+  }
+
+  /* waits while two batches are queued, so memory stays bounded*/
+  void push(std::vector<Frame> && batch)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] {return batches_.size() < 2;});
+    batches_.push_back(std::move(batch));
+    cond_.notify_all();
+  }
+
+  size_t getFrames() const {return frames_;}
+
+private:
+  void run()
+  {
+    for (;; ) {
+      std::vector<Frame> batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] {return done_ || !batches_.empty();});
+        if (batches_.empty()) {
+          return;
+        }
+        batch = std::move(batches_.front());
+        batches_.pop_front();
+        cond_.notify_all();
+      }
+      for (auto & frame : batch) {
+        if (frame.ok) {
+          track(frame);
+        }
+      }
+    }
+  }
+
+  /* the calls of TrackingStream for a detection coming with its frame*/
+  void track(Frame & frame)
+  {
+    cv::Mat mat = frame.bgr;
+    double scale = 1.0;
+    if (opts_.working_width > 0 && mat.cols > opts_.working_width) {
+      scale = static_cast<double>(opts_.working_width) / mat.cols;
+      cv::resize(frame.bgr, mat, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+    if (frames_++ == 0 && opts_.warmup) {
+      tm_.warmup(mat.size());
+    }
+    tm_.setWorkingScale(scale);
+    FrameContext ctx(mat);
+    builtin_interfaces::msg::Time stamp = frame.objs->header.stamp;
+    if (!frame.objs->objects_vector.empty()) {
+      /* localization is taken by the tracker only with a depth gate*/
+      tm_.detect(ctx, frame.objs, opts_.depth_gate > 0 ? frame.loc : nullptr);
+      detected_ = true;
+    } else if (detected_) {
+      tm_.track(ctx, stamp);
+    } else {
+      return;
+    }
+
+    for (size_t i = 0; frame.loc && i < frame.loc->objects_in_boxes.size(); i++) {
+      const object_analytics_msgs::msg::ObjectInBox3D & obj = frame.loc->objects_in_boxes[i];
+      loc_out_ << frame.stamp << "," << obj.object.object_name << "," <<
+        obj.object.probability << "," << obj.roi.x_offset << "," << obj.roi.y_offset << "," <<
+        obj.roi.width << "," << obj.roi.height << "," << obj.min.x << "," << obj.min.y << "," <<
+        obj.min.z << "," << obj.max.x << "," << obj.max.y << "," << obj.max.z << "\n";
+    }
+    tracked_.tracked_objects.clear();
+    tm_.getTrackedObjs(tracked_);
+    for (auto & obj : tracked_.tracked_objects) {
+      track_out_ << frame.stamp << "," << obj.id << "," << obj.object.object_name << "," <<
+        obj.object.probability << "," << obj.roi.x_offset << "," << obj.roi.y_offset << "," <<
+        obj.roi.width << "," << obj.roi.height << "\n";
+    }
+    tm_.replenish();
+  }
+
+  TrackingManager & tm_;
+  const TrackingStream::Options & opts_;
+  std::ostream & loc_out_;
+  std::ostream & track_out_;
+  object_analytics_msgs::msg::TrackedObjects tracked_;
+  bool detected_ = false;
+  size_t frames_ = 0;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::vector<Frame>> batches_;
+  bool done_ = false;
+  std::thread thread_;
+};
+
+int main(int argc, char * argv[])
+{
+  if (rcutils_cli_option_exist(argv, argv + argc, "-h") ||
+    !rcutils_cli_option_exist(argv, argv + argc, "-f"))
+  {
+    show_usage();
+    return 0;
+  }
+  std::string file = rcutils_cli_get_option(argv, argv + argc, "-f");
+  std::string prefix = "offline";
+  size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  if (rcutils_cli_option_exist(argv, argv + argc, "-o")) {
+    prefix = rcutils_cli_get_option(argv, argv + argc, "-o");
+  }
+  if (rcutils_cli_option_exist(argv, argv + argc, "-j")) {
+    const char * j = rcutils_cli_get_option(argv, argv + argc, "-j");
+    int n = j != nullptr ? std::atoi(j) : 0;
+    if (n < 1) {
+      RCUTILS_LOG_ERROR("-j needs a number of threads above 0\n");
+      return 1;
+    }
+    threads = static_cast<size_t>(n);
+  }
+
+  std::unique_ptr<SessionReader> reader;
+  try {
+    reader.reset(new SessionReader(file));
+  } catch (const std::runtime_error & e) {
+    RCUTILS_LOG_ERROR("%s\n", e.what());
+    return 1;
+  }
+  std::ofstream loc_out(prefix + ".localization.csv");
+  std::ofstream track_out(prefix + ".tracking.csv");
+  if (!loc_out || !track_out) {
+    RCUTILS_LOG_ERROR("cannot write %s.*.csv\n", prefix.c_str());
+    return 1;
+  }
+  loc_out << "stamp_ns,name,probability,x,y,width,height,min_x,min_y,min_z,max_x,max_y,max_z\n" <<
+    std::setprecision(6);
+  track_out << "stamp_ns,id,name,probability,x,y,width,height\n" << std::setprecision(6);
+
+  rclcpp::init(argc, argv);
+  /* named as the online nodes, their parameter file applies, and the parameters both declare,
+   * e.g. min_probability, are set apart*/
+  auto seg_node = std::make_shared<rclcpp::Node>("SegmenterNode");
+  auto track_node = std::make_shared<rclcpp::Node>("TrackingNode");
+  SegmenterOptions seg_opts(seg_node.get());
+  SegmenterPool segmenters(seg_opts);
+  TrackingStream::Options opts = TrackingNode::declareOptions(track_node.get());
+  TrackingManager tm(track_node.get(), opts.num_threads);
+  TrackingStream::configure(tm, opts);
+
+  /* frames are segmented in parallel by batches, and tracked in order meanwhile*/
+  object_analytics_node::util::ThreadPool pool(threads - 1);
+  const size_t batch_size = 4 * threads;
+  size_t frames = 0;
+  bool more = true;
+  bool failed = false;
+  auto start = std::chrono::steady_clock::now();
+  {
+    TrackingStage stage(tm, opts, loc_out, track_out);
+    while (more) {
+      std::vector<Frame> batch;
+      SessionReader::Frame read;
+      try {
+        while (batch.size() < batch_size && (more = reader->next(read))) {
+          Frame frame;
+          frame.stamp = read.stamp;
+          frame.image = read.image;
+          frame.pcd = read.pcd;
+          frame.objs = read.objs;
+          batch.push_back(frame);
+        }
+      } catch (const std::runtime_error & e) {
+        /* the frames before the line are still processed*/
+        RCUTILS_LOG_ERROR("%s: %s\n", file.c_str(), e.what());
+        more = false;
+        failed = true;
+      }
+      if (batch.empty()) {
+        break;
+      }
+      pool.parallelFor(batch.size(), [&batch, &segmenters](size_t i) {
+          process(batch[i], segmenters);
+        });
+      frames += batch.size();
+      stage.push(std::move(batch));
+    }
+  }
+  double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  RCUTILS_LOG_INFO("processed %zu frames in %.1fs, %.1f fps on %zu threads\n", frames, wall_s,
+    wall_s > 0 ? frames / wall_s : 0., threads);
+  rclcpp::shutdown();
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,308 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+#include <object_analytics_msgs/msg/pipeline_stats.hpp>
+#include <dirent.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "object_analytics_node/const.hpp"
+#include "rcutils/cmdline_parser.h"
+
+void show_usage()
+{
+  RCUTILS_LOG_INFO("Usage for pipeline_benchmark:\n");
+  RCUTILS_LOG_INFO(
+    "pipeline_benchmark [-p process_name] [-d seconds] [-o report_file] [-h]\n");
+  RCUTILS_LOG_INFO("options:\n");
+  RCUTILS_LOG_INFO("-h : Print this help function.\n");
+  RCUTILS_LOG_INFO(
+    "-p process_name : Process sampled for CPU and RSS, default object_analytics_node.\n");
+  RCUTILS_LOG_INFO("-d seconds : Stop collecting after the seconds, default till Ctrl-C.\n");
+  RCUTILS_LOG_INFO(
+    "-o report_file : Write the report, .json for JSON else CSV, default CSV to stdout.\n");
+}
+
+/** @brief Statistics of one stage merged over the run.*/
+struct StageTotal
+{
+  uint64_t count = 0;
+  double sum_ms = 0.;
+  double max_ms = 0.;
+  std::vector<double> bounds_ms;
+  std::vector<uint64_t> histogram;
+
+  /** @brief Upper bound of the bucket holding the percentile, max for the last bucket.*/
+  double percentile(double p) const
+  {
+    uint64_t rank = static_cast<uint64_t>(p * count + 0.5);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < histogram.size(); i++) {
+      seen += histogram[i];
+      if (seen >= rank && seen > 0) {
+        return i < bounds_ms.size() ? std::min(bounds_ms[i], max_ms) : max_ms;
+      }
+    }
+    return max_ms;
+  }
+};
+
+/** @brief CPU and RSS of a process, sampled from /proc.*/
+class ProcessSampler
+{
+public:
+  explicit ProcessSampler(const std::string & name)
+  : name_(name), pid_(-1), ticks_(0), clk_tck_(sysconf(_SC_CLK_TCK)) {}
+
+  /** @brief Take a sample, looking the process up until found.*/
+  void sample()
+  {
+    if (pid_ < 0 && !find()) {
+      return;
+    }
+    std::ifstream stat("/proc/" + std::to_string(pid_) + "/stat");
+    std::string line;
+    if (!std::getline(stat, line)) {
+      /* exited, it may be restarted*/
+      pid_ = -1;
+      return;
+    }
+    /* fields after the command, which may hold spaces, utime and stime are the 12th and 13th*/
+    std::istringstream fields(line.substr(line.rfind(')') + 2));
+    std::string field;
+    uint64_t utime = 0, stime = 0;
+    for (int i = 0; i < 13 && fields >> field; i++) {
+      if (i == 11) {utime = std::stoull(field);}
+      if (i == 12) {stime = std::stoull(field);}
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (ticks_ > 0) {
+      double wall = std::chrono::duration<double>(now - last_).count();
+      double cpu = (utime + stime - ticks_) * 100. / clk_tck_ / wall;
+      cpu_.push_back(cpu);
+    }
+    ticks_ = utime + stime;
+    last_ = now;
+
+    std::ifstream status("/proc/" + std::to_string(pid_) + "/status");
+    while (std::getline(status, line)) {
+      if (line.compare(0, 6, "VmRSS:") == 0) {
+        rss_mb_.push_back(std::stod(line.substr(6)) / 1024.);
+      }
+    }
+  }
+
+  const std::vector<double> & getCpu() const {return cpu_;}
+  const std::vector<double> & getRssMb() const {return rss_mb_;}
+
+private:
+  /** @brief Find the process by the name of its executable.*/
+  bool find()
+  {
+    DIR * proc = opendir("/proc");
+    if (proc == nullptr) {
+      return false;
+    }
+    for (struct dirent * entry = readdir(proc); entry != nullptr; entry = readdir(proc)) {
+      std::string pid = entry->d_name;
+      if (pid.find_first_not_of("0123456789") != std::string::npos) {
+        continue;
+      }
+      std::ifstream cmdline("/proc/" + pid + "/cmdline");
+      std::string argv0;
+      std::getline(cmdline, argv0, '\0');
+      if (argv0.substr(argv0.rfind('/') + 1) == name_) {
+        pid_ = std::stoi(pid);
+        ticks_ = 0;
+        break;
+      }
+    }
+    closedir(proc);
+    return pid_ >= 0;
+  }
+
+  std::string name_;
+  int pid_;
+  uint64_t ticks_;
+  double clk_tck_;
+  std::chrono::steady_clock::time_point last_;
+  std::vector<double> cpu_;
+  std::vector<double> rss_mb_;
+};
+
+class PipelineBenchmark : public rclcpp::Node
+{
+public:
+  explicit PipelineBenchmark(const std::string & process)
+  : Node("pipeline_benchmark"), sampler_(process), start_(std::chrono::steady_clock::now())
+  {
+    auto callback = [this](const object_analytics_msgs::msg::PipelineStats::SharedPtr stats) {
+        for (auto & s : stats->stages) {
+          StageTotal & total = stages_[s.name];
+          total.count += s.count;
+          total.sum_ms += s.mean_ms * s.count;
+          total.max_ms = std::max(total.max_ms, s.max_ms);
+          total.bounds_ms = s.bucket_bounds_ms;
+          total.histogram.resize(s.histogram.size());
+          for (size_t i = 0; i < s.histogram.size(); i++) {
+            total.histogram[i] += s.histogram[i];
+          }
+        }
+        for (size_t i = 0; i < stats->queue_names.size() && i < stats->queue_depths.size(); i++) {
+          uint32_t & depth = queues_[stats->queue_names[i]];
+          depth = std::max(depth, stats->queue_depths[i]);
+        }
+        /* counters accumulate since start, the latest is the total*/
+        for (size_t i = 0; i < stats->drop_names.size() && i < stats->drops.size(); i++) {
+          drops_[stats->drop_names[i]] = stats->drops[i];
+        }
+        for (size_t i = 0; i < stats->memory_names.size() && i < stats->memory_peaks.size(); i++) {
+          memory_[stats->memory_names[i]] = stats->memory_peaks[i];
+        }
+      };
+    sub_ = create_subscription<object_analytics_msgs::msg::PipelineStats>(
+      object_analytics_node::Const::kTopicPipelineStats, callback);
+    timer_ = create_wall_timer(std::chrono::seconds(1), [this]() {sampler_.sample();});
+  }
+
+  void report(std::ostream & os, bool json)
+  {
+    double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start_).count();
+    const std::vector<double> & cpu = sampler_.getCpu();
+    const std::vector<double> & rss = sampler_.getRssMb();
+    double cpu_mean = cpu.empty() ? 0. : std::accumulate(cpu.begin(), cpu.end(), 0.) / cpu.size();
+    double cpu_max = cpu.empty() ? 0. : *std::max_element(cpu.begin(), cpu.end());
+    double rss_max = rss.empty() ? 0. : *std::max_element(rss.begin(), rss.end());
+
+    os << std::fixed << std::setprecision(3);
+    if (json) {
+      os << "{\n  \"seconds\": " << seconds << ",\n  \"cpu_mean_percent\": " << cpu_mean <<
+        ",\n  \"cpu_max_percent\": " << cpu_max << ",\n  \"rss_max_mb\": " << rss_max <<
+        ",\n  \"stages\": [";
+      const char * sep = "\n";
+      for (auto & s : stages_) {
+        const StageTotal & t = s.second;
+        os << sep << "    {\"name\": \"" << s.first << "\", \"count\": " << t.count <<
+          ", \"rate_hz\": " << t.count / seconds << ", \"mean_ms\": " <<
+          (t.count > 0 ? t.sum_ms / t.count : 0.) << ", \"p50_ms\": " << t.percentile(0.5) <<
+          ", \"p95_ms\": " << t.percentile(0.95) << ", \"p99_ms\": " << t.percentile(0.99) <<
+          ", \"max_ms\": " << t.max_ms << "}";
+        sep = ",\n";
+      }
+      os << "\n  ],\n  \"queues_max\": {";
+      sep = "";
+      for (auto & q : queues_) {
+        os << sep << "\"" << q.first << "\": " << q.second;
+        sep = ", ";
+      }
+      os << "},\n  \"drops\": {";
+      sep = "";
+      for (auto & d : drops_) {
+        os << sep << "\"" << d.first << "\": " << d.second;
+        sep = ", ";
+      }
+      os << "},\n  \"memory_peak_mb\": {";
+      sep = "";
+      for (auto & m : memory_) {
+        os << sep << "\"" << m.first << "\": " << m.second / 1048576.;
+        sep = ", ";
+      }
+      os << "}\n}\n";
+      return;
+    }
+    os << "metric,name,count,rate_hz,mean,p50,p95,p99,max\n";
+    for (auto & s : stages_) {
+      const StageTotal & t = s.second;
+      os << "stage_ms," << s.first << "," << t.count << "," << t.count / seconds << "," <<
+        (t.count > 0 ? t.sum_ms / t.count : 0.) << "," << t.percentile(0.5) << "," <<
+        t.percentile(0.95) << "," << t.percentile(0.99) << "," << t.max_ms << "\n";
+    }
+    for (auto & q : queues_) {
+      os << "queue_depth," << q.first << ",,,,,,," << q.second << "\n";
+    }
+    for (auto & d : drops_) {
+      os << "drops," << d.first << "," << d.second << ",,,,,,\n";
+    }
+    for (auto & m : memory_) {
+      os << "memory_peak_mb," << m.first << ",,,,,,," << m.second / 1048576. << "\n";
+    }
+    os << "cpu_percent,process," << cpu.size() << ",," << cpu_mean << ",,,," << cpu_max << "\n";
+    os << "rss_mb,process," << rss.size() << ",,,,,," << rss_max << "\n";
+  }
+
+private:
+  ProcessSampler sampler_;
+  std::chrono::steady_clock::time_point start_;
+  std::map<std::string, StageTotal> stages_;
+  std::map<std::string, uint32_t> queues_;
+  std::map<std::string, uint64_t> drops_;
+  std::map<std::string, uint64_t> memory_;
+  rclcpp::Subscription<object_analytics_msgs::msg::PipelineStats>::SharedPtr sub_;
+  rclcpp::TimerBase::SharedPtr timer_;
+};
+
+int main(int argc, char * argv[])
+{
+  if (rcutils_cli_option_exist(argv, argv + argc, "-h")) {
+    show_usage();
+    return 0;
+  }
+  std::string process = "object_analytics_node";
+  double duration = 0.;
+  std::string file;
+  if (rcutils_cli_option_exist(argv, argv + argc, "-p")) {
+    process = rcutils_cli_get_option(argv, argv + argc, "-p");
+  }
+  if (rcutils_cli_option_exist(argv, argv + argc, "-d")) {
+    duration = std::stod(rcutils_cli_get_option(argv, argv + argc, "-d"));
+  }
+  if (rcutils_cli_option_exist(argv, argv + argc, "-o")) {
+    file = rcutils_cli_get_option(argv, argv + argc, "-o");
+  }
+
+  rclcpp::init(argc, argv);
+  auto node = std::make_shared<PipelineBenchmark>(process);
+  rclcpp::executors::SingleThreadedExecutor exec;
+  exec.add_node(node);
+  /* the executor returns with Ctrl-C or the launch shutting down, the report is written then*/
+  auto end = std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(duration));
+  while (rclcpp::ok() && (duration <= 0. || std::chrono::steady_clock::now() < end)) {
+    exec.spin_once(std::chrono::milliseconds(100));
+  }
+
+  bool json = file.size() > 5 && file.compare(file.size() - 5, 5, ".json") == 0;
+  if (file.empty()) {
+    node->report(std::cout, json);
+  } else {
+    std::ofstream of(file);
+    node->report(of, json);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
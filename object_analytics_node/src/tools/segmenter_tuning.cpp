@@ -0,0 +1,334 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define PCL_NO_PRECOMPILE
+#include <rclcpp/rclcpp.hpp>
+#include <pcl/io/pcd_io.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "object_analytics_node/segmenter/algorithm_provider_impl.hpp"
+#include "object_analytics_node/segmenter/segmenter.hpp"
+#include "object_analytics_node/util/stage_stats.hpp"
+#include "rcutils/cmdline_parser.h"
+
+using object_analytics_node::model::PointCloudT;
+using object_analytics_node::model::PointT;
+using object_analytics_node::segmenter::AlgorithmConfig;
+using object_analytics_node::segmenter::AlgorithmProvider;
+using object_analytics_node::segmenter::AlgorithmProviderImpl;
+using object_analytics_node::segmenter::Segmenter;
+
+void show_usage()
+{
+  RCUTILS_LOG_INFO("Usage for segmenter_tuning:\n");
+  RCUTILS_LOG_INFO(
+    "segmenter_tuning -f frames.csv [-b budget_ms] [-a algorithm] [-r repeats] [-o file] [-h]"
+    "\n");
+  RCUTILS_LOG_INFO("options:\n");
+  RCUTILS_LOG_INFO("-h : Print this help function.\n");
+  RCUTILS_LOG_INFO(
+    "-f frames.csv : One detection per line, pcd,name,x,y,width,height followed by the\n"
+    "   ground truth min_x,min_y,min_z,max_x,max_y,max_z if known. Consecutive lines of a pcd,\n"
+    "   relative to the csv, are one frame.\n");
+  RCUTILS_LOG_INFO("-b budget_ms : 95th percentile of the frame latency allowed, default 30.\n");
+  RCUTILS_LOG_INFO("-a algorithm : segmentation_algorithm of SegmenterNode, default %s.\n",
+    AlgorithmProviderImpl::kMultiPlane.c_str());
+  RCUTILS_LOG_INFO("-r repeats : Runs of the frames per candidate, default 1.\n");
+  RCUTILS_LOG_INFO(
+    "-o file : Parameter file of the best candidate, default segmenter_tuned.yaml.\n");
+  RCUTILS_LOG_INFO(
+    "--steps, --distances, --min-points, --voxels : Comma separated values searched of\n"
+    "   sampling_step, OBJECT_DISTANCE_THRESHOLD, OBJECT_MINIMUM_POINTS and VOXEL_LEAF_SIZE.\n");
+}
+
+/** @brief A detection of a recorded frame, and its ground truth bounds if any.*/
+struct Detection
+{
+  object_msgs::msg::ObjectInBox obj;
+  bool has_truth = false;
+  double min[3];
+  double max[3];
+};
+
+/** @brief A recorded frame.*/
+struct Frame
+{
+  std::string pcd;
+  sensor_msgs::msg::PointCloud2::SharedPtr cloud;
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs;
+  std::vector<Detection> detections;
+};
+
+/** @brief A point of the search space.*/
+struct Candidate
+{
+  size_t step;
+  double distance;
+  size_t min_points;
+  double voxel;
+  double quality;
+  double p95_ms;
+  double mean_ms;
+  double cluster_ms;
+};
+
+std::vector<double> parseList(char ** argv, int argc, const char * option, const char * values)
+{
+  if (rcutils_cli_option_exist(argv, argv + argc, option)) {
+    values = rcutils_cli_get_option(argv, argv + argc, option);
+  }
+  std::vector<double> list;
+  std::istringstream in(values);
+  std::string value;
+  while (std::getline(in, value, ',')) {
+    list.push_back(std::stod(value));
+  }
+  return list;
+}
+
+bool loadFrames(const std::string & file, std::vector<Frame> & frames)
+{
+  std::ifstream in(file);
+  if (!in) {
+    RCUTILS_LOG_ERROR("cannot open %s\n", file.c_str());
+    return false;
+  }
+  std::string dir = file.find('/') == std::string::npos ? "" :
+    file.substr(0, file.rfind('/') + 1);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::vector<std::string> f;
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+      f.push_back(field);
+    }
+    if (f.size() != 6 && f.size() != 12) {
+      RCUTILS_LOG_ERROR("malformed line: %s\n", line.c_str());
+      return false;
+    }
+    if (frames.empty() || frames.back().pcd != f[0]) {
+      Frame frame;
+      frame.pcd = f[0];
+      PointCloudT cloud;
+      std::string path = f[0][0] == '/' ? f[0] : dir + f[0];
+      if (pcl::io::loadPCDFile<PointT>(path, cloud) == -1) {
+        RCUTILS_LOG_ERROR("cannot read %s\n", path.c_str());
+        return false;
+      }
+      frame.cloud = std::make_shared<sensor_msgs::msg::PointCloud2>();
+      pcl::toROSMsg(cloud, *frame.cloud);
+      frame.objs = std::make_shared<object_msgs::msg::ObjectsInBoxes>();
+      frames.push_back(frame);
+    }
+    Detection d;
+    d.obj.object.object_name = f[1];
+    d.obj.object.probability = 1.0f;
+    d.obj.roi.x_offset = std::stoul(f[2]);
+    d.obj.roi.y_offset = std::stoul(f[3]);
+    d.obj.roi.width = std::stoul(f[4]);
+    d.obj.roi.height = std::stoul(f[5]);
+    d.has_truth = f.size() == 12;
+    for (size_t i = 0; d.has_truth && i < 3; i++) {
+      d.min[i] = std::stod(f[6 + i]);
+      d.max[i] = std::stod(f[9 + i]);
+    }
+    frames.back().objs->objects_vector.push_back(d.obj);
+    frames.back().detections.push_back(d);
+  }
+  return !frames.empty();
+}
+
+/** @brief Intersection over union of the 3d bounds against the ground truth.*/
+double getIou(const Detection & d, const object_analytics_msgs::msg::ObjectInBox3D & obj)
+{
+  double lo[3] = {obj.min.x, obj.min.y, obj.min.z};
+  double hi[3] = {obj.max.x, obj.max.y, obj.max.z};
+  double inter = 1., got = 1., truth = 1.;
+  for (int i = 0; i < 3; i++) {
+    inter *= std::max(0., std::min(hi[i], d.max[i]) - std::max(lo[i], d.min[i]));
+    got *= std::max(0., hi[i] - lo[i]);
+    truth *= std::max(0., d.max[i] - d.min[i]);
+  }
+  double uni = got + truth - inter;
+  return uni > 0 ? inter / uni : 0.;
+}
+
+/**
+ * @brief Score the localization of a frame.
+ *
+ * Each detection scores the IoU of its bounds against its ground truth, or 1 if localized when
+ * it has none, and 0 if not localized.
+ */
+double getQuality(const Frame & frame, const object_analytics_msgs::msg::ObjectsInBoxes3D & loc)
+{
+  double sum = 0.;
+  for (auto & d : frame.detections) {
+    for (auto & obj : loc.objects_in_boxes) {
+      if (obj.roi == d.obj.roi && obj.object.object_name == d.obj.object.object_name) {
+        sum += d.has_truth ? getIou(d, obj) : (obj.max.z > obj.min.z ? 1. : 0.);
+        break;
+      }
+    }
+  }
+  return sum;
+}
+
+void evaluate(
+  const std::vector<Frame> & frames, const std::string & algorithm, int repeats,
+  Candidate & c)
+{
+  AlgorithmConfig conf;
+  conf.set("OBJECT_DISTANCE_THRESHOLD", std::to_string(c.distance));
+  conf.set("OBJECT_MINIMUM_POINTS", std::to_string(c.min_points));
+  conf.set("VOXEL_LEAF_SIZE", std::to_string(c.voxel));
+  Segmenter segmenter(std::unique_ptr<AlgorithmProvider>(
+      new AlgorithmProviderImpl(algorithm, conf)));
+  segmenter.setSamplingStep(c.step);
+  segmenter.warmup(frames[0].cloud->width, frames[0].cloud->height);
+
+  /* the stages of the warm-up are dropped, those of the runs kept*/
+  std::vector<object_analytics_msgs::msg::StageStats> stages;
+  object_analytics_node::util::StageRegistry::collect("segmenter.", stages);
+  std::vector<double> latencies;
+  double quality = 0.;
+  size_t objects = 0;
+  for (int r = 0; r < repeats; r++) {
+    for (auto & frame : frames) {
+      auto msg = std::make_shared<object_analytics_msgs::msg::ObjectsInBoxes3D>();
+      auto start = std::chrono::steady_clock::now();
+      segmenter.segment(frame.objs, frame.cloud, msg);
+      latencies.push_back(std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - start).count());
+      quality += getQuality(frame, *msg);
+      objects += frame.detections.size();
+    }
+  }
+  stages.clear();
+  object_analytics_node::util::StageRegistry::collect("segmenter.", stages);
+  c.cluster_ms = 0.;
+  for (auto & s : stages) {
+    if (s.name == "segmenter.segment") {
+      c.cluster_ms = s.mean_ms;
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  c.p95_ms = latencies[std::min(latencies.size() - 1,
+      static_cast<size_t>(0.95 * latencies.size()))];
+  c.mean_ms = 0.;
+  for (double l : latencies) {
+    c.mean_ms += l / latencies.size();
+  }
+  c.quality = objects > 0 ? quality / objects : 0.;
+}
+
+int main(int argc, char * argv[])
+{
+  if (rcutils_cli_option_exist(argv, argv + argc, "-h") ||
+    !rcutils_cli_option_exist(argv, argv + argc, "-f"))
+  {
+    show_usage();
+    return 0;
+  }
+  std::string file = rcutils_cli_get_option(argv, argv + argc, "-f");
+  double budget_ms = 30.;
+  std::string algorithm = AlgorithmProviderImpl::kMultiPlane;
+  int repeats = 1;
+  std::string output = "segmenter_tuned.yaml";
+  if (rcutils_cli_option_exist(argv, argv + argc, "-b")) {
+    budget_ms = std::stod(rcutils_cli_get_option(argv, argv + argc, "-b"));
+  }
+  if (rcutils_cli_option_exist(argv, argv + argc, "-a")) {
+    algorithm = rcutils_cli_get_option(argv, argv + argc, "-a");
+  }
+  if (rcutils_cli_option_exist(argv, argv + argc, "-r")) {
+    repeats = std::max(1, std::stoi(rcutils_cli_get_option(argv, argv + argc, "-r")));
+  }
+  if (rcutils_cli_option_exist(argv, argv + argc, "-o")) {
+    output = rcutils_cli_get_option(argv, argv + argc, "-o");
+  }
+  std::vector<double> steps = parseList(argv, argc, "--steps", "1,2,4,6,10");
+  std::vector<double> distances = parseList(argv, argc, "--distances", "0.03,0.05,0.07,0.1");
+  std::vector<double> min_points = parseList(argv, argc, "--min-points", "20,40,60,100");
+  std::vector<double> voxels = parseList(argv, argc, "--voxels", "0,0.01,0.02");
+
+  std::vector<Frame> frames;
+  if (!loadFrames(file, frames)) {
+    return 1;
+  }
+
+  /* exhaustive, the space is small and every candidate is reported*/
+  std::cout << "sampling_step,distance,min_points,voxel,quality,p95_ms,mean_ms,segment_ms" <<
+    std::endl;
+  std::vector<Candidate> candidates;
+  for (double step : steps) {
+    for (double distance : distances) {
+      for (double points : min_points) {
+        for (double voxel : voxels) {
+          Candidate c = {static_cast<size_t>(std::max(step, 1.)), distance,
+            static_cast<size_t>(std::max(points, 1.)), voxel, 0., 0., 0., 0.};
+          evaluate(frames, algorithm, repeats, c);
+          std::cout << c.step << "," << c.distance << "," << c.min_points << "," << c.voxel <<
+            "," << std::fixed << std::setprecision(3) << c.quality << "," << c.p95_ms << "," <<
+            c.mean_ms << "," << c.cluster_ms << std::defaultfloat << std::endl;
+          candidates.push_back(c);
+        }
+      }
+    }
+  }
+
+  /* the best quality within budget, the fastest of equal quality*/
+  const Candidate * best = nullptr;
+  for (auto & c : candidates) {
+    if (c.p95_ms <= budget_ms && (best == nullptr || c.quality > best->quality + 1e-6 ||
+      (c.quality > best->quality - 1e-6 && c.p95_ms < best->p95_ms)))
+    {
+      best = &c;
+    }
+  }
+  if (best == nullptr) {
+    RCUTILS_LOG_ERROR("no candidate within %.1fms, the fastest takes %.1fms\n", budget_ms,
+      std::min_element(candidates.begin(), candidates.end(),
+      [](const Candidate & a, const Candidate & b) {return a.p95_ms < b.p95_ms;})->p95_ms);
+    return 1;
+  }
+
+  std::ofstream yaml(output);
+  yaml << "# segmenter_tuning of " << file << ", " << frames.size() << " frames, quality " <<
+    best->quality << ", p95 " << best->p95_ms << "ms of budget " << budget_ms << "ms\n" <<
+    "SegmenterNode:\n" <<
+    "  ros__parameters:\n" <<
+    "    segmentation_algorithm: \"" << algorithm << "\"\n" <<
+    "    sampling_step: " << best->step << "\n" <<
+    "    algorithm:\n" <<
+    "      OBJECT_DISTANCE_THRESHOLD: " << best->distance << "\n" <<
+    "      OBJECT_MINIMUM_POINTS: " << best->min_points << "\n" <<
+    "      VOXEL_LEAF_SIZE: " << best->voxel << "\n";
+  RCUTILS_LOG_INFO("wrote %s, quality %.3f at p95 %.1fms\n", output.c_str(), best->quality,
+    best->p95_ms);
+  return 0;
+}
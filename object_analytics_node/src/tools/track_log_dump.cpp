@@ -0,0 +1,153 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "object_analytics_node/logger/track_log.hpp"
+#include "rcutils/cmdline_parser.h"
+#include "rcutils/logging_macros.h"
+
+using object_analytics_node::logger::TrackLog;
+using object_analytics_node::logger::TrackLogReader;
+using object_analytics_node::logger::TrackRow;
+
+void show_usage()
+{
+  RCUTILS_LOG_INFO("Usage for track_log_dump:\n");
+  RCUTILS_LOG_INFO(
+    "track_log_dump -f log [-b begin] [-e end] [-i id] [-c class] [-s] [-o file] [-h]\n");
+  RCUTILS_LOG_INFO("options:\n");
+  RCUTILS_LOG_INFO("-h : Print this help function.\n");
+  RCUTILS_LOG_INFO(
+    "-f log : A .tracklog file, or the log_prefix of TrackLoggerNode for all its files.\n");
+  RCUTILS_LOG_INFO("-b begin, -e end : Range of the stamps in seconds, default all.\n");
+  RCUTILS_LOG_INFO("-i id, -c class : Rows of a tracking id or a class name only.\n");
+  RCUTILS_LOG_INFO("-s : One row per tracking id, its class, rows and first and last stamps.\n");
+  RCUTILS_LOG_INFO("-o file : Write CSV to the file, default to stdout.\n");
+}
+
+/** @brief Rows of one tracking id.*/
+struct TrackSummary
+{
+  std::string name;
+  uint64_t rows = 0;
+  int64_t first = INT64_MAX;
+  int64_t last = INT64_MIN;
+};
+
+static const char * getOption(char * argv[], int argc, const char * option)
+{
+  return rcutils_cli_option_exist(argv, argv + argc, option) ?
+         rcutils_cli_get_option(argv, argv + argc, option) : nullptr;
+}
+
+int main(int argc, char * argv[])
+{
+  const char * log = getOption(argv, argc, "-f");
+  if (rcutils_cli_option_exist(argv, argv + argc, "-h") || log == nullptr) {
+    show_usage();
+    return 0;
+  }
+  const char * begin = getOption(argv, argc, "-b");
+  const char * end = getOption(argv, argc, "-e");
+  const char * id = getOption(argv, argc, "-i");
+  const char * name = getOption(argv, argc, "-c");
+  const char * out_file = getOption(argv, argc, "-o");
+  bool summary = rcutils_cli_option_exist(argv, argv + argc, "-s");
+  int64_t track_id = id != nullptr ? std::stoll(id) : 0;
+  int64_t from = begin != nullptr ? static_cast<int64_t>(std::stod(begin) * 1e9) : INT64_MIN;
+  int64_t to = end != nullptr ? static_cast<int64_t>(std::stod(end) * 1e9) : INT64_MAX;
+
+  /* a prefix stands for its files in order, till the first missing*/
+  std::vector<std::string> files;
+  std::string path = log;
+  const std::string suffix = ".tracklog";
+  if (path.size() > suffix.size() &&
+    path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0)
+  {
+    files.push_back(path);
+  } else {
+    for (size_t n = 0; std::ifstream(TrackLog::getPath(path, n)).good(); n++) {
+      files.push_back(TrackLog::getPath(path, n));
+    }
+  }
+  if (files.empty()) {
+    RCUTILS_LOG_ERROR("no track log %s", log);
+    return 1;
+  }
+
+  std::ofstream of;
+  if (out_file != nullptr) {
+    of.open(out_file);
+  }
+  std::ostream & os = out_file != nullptr ? of : std::cout;
+  os << std::fixed;
+  if (!summary) {
+    os << "stamp,id,class,x,y,width,height,min_x,min_y,min_z,max_x,max_y,max_z\n";
+  }
+  std::map<int64_t, TrackSummary> tracks;
+  std::vector<TrackRow> rows;
+  for (auto & file : files) {
+    try {
+      TrackLogReader reader(file);
+      while (reader.next(rows, from, to)) {
+        for (auto & row : rows) {
+          const std::string & class_name = reader.getClassName(row.class_id);
+          if (row.stamp < from || row.stamp > to || (id != nullptr && row.id != track_id) ||
+            (name != nullptr && class_name != name))
+          {
+            continue;
+          }
+          if (summary) {
+            TrackSummary & track = tracks[row.id];
+            track.name = class_name;
+            track.rows++;
+            track.first = std::min(track.first, row.stamp);
+            track.last = std::max(track.last, row.stamp);
+            continue;
+          }
+          os << std::setprecision(9) << row.stamp / 1e9 << "," << row.id << "," << class_name <<
+            "," << row.x << "," << row.y << "," << row.width << "," << row.height <<
+            std::setprecision(3);
+          for (float v : row.min) {
+            os << "," << v;
+          }
+          for (float v : row.max) {
+            os << "," << v;
+          }
+          os << "\n";
+        }
+      }
+    } catch (const std::runtime_error & e) {
+      RCUTILS_LOG_ERROR("%s", e.what());
+      return 1;
+    }
+  }
+  if (summary) {
+    os << "id,class,rows,first,last\n" << std::setprecision(9);
+    for (auto & t : tracks) {
+      os << t.first << "," << t.second.name << "," << t.second.rows << "," <<
+        t.second.first / 1e9 << "," << t.second.last / 1e9 << "\n";
+    }
+  }
+  return 0;
+}
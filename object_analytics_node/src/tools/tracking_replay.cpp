@@ -0,0 +1,177 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/rclcpp.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "object_analytics_node/tracker/frame_context.hpp"
+#include "object_analytics_node/tracker/tracking_capture.hpp"
+#include "object_analytics_node/tracker/tracking_manager.hpp"
+#include "object_analytics_node/tracker/tracking_node.hpp"
+#include "object_analytics_node/tracker/tracking_stream.hpp"
+#include "object_analytics_node/util/stamped_ring_buffer.hpp"
+#include "rcutils/cmdline_parser.h"
+
+using object_analytics_node::tracker::CaptureReader;
+using object_analytics_node::tracker::FrameContext;
+using object_analytics_node::tracker::TrackingCapture;
+using object_analytics_node::tracker::TrackingManager;
+using object_analytics_node::tracker::TrackingNode;
+using object_analytics_node::tracker::TrackingStream;
+
+void show_usage()
+{
+  RCUTILS_LOG_INFO("Usage for tracking_replay:\n");
+  RCUTILS_LOG_INFO(
+    "tracking_replay -f capture_file [-h] [--ros-args --params-file tracking.yaml]\n");
+  RCUTILS_LOG_INFO("options:\n");
+  RCUTILS_LOG_INFO("-h : Print this help function.\n");
+  RCUTILS_LOG_INFO(
+    "-f capture_file : Log written by TrackingNode with the parameter capture_file.\n");
+  RCUTILS_LOG_INFO(
+    "The manager is configured by the parameters of TrackingNode, give the same ones.\n");
+}
+
+/** @brief Time spent in one kind of call of the manager.*/
+struct CallTotal
+{
+  uint64_t count = 0;
+  double sum_ms = 0.;
+  double max_ms = 0.;
+
+  void add(double ms)
+  {
+    count++;
+    sum_ms += ms;
+    max_ms = std::max(max_ms, ms);
+  }
+};
+
+int main(int argc, char * argv[])
+{
+  if (rcutils_cli_option_exist(argv, argv + argc, "-h") ||
+    !rcutils_cli_option_exist(argv, argv + argc, "-f"))
+  {
+    show_usage();
+    return 0;
+  }
+  std::string file = rcutils_cli_get_option(argv, argv + argc, "-f");
+
+  rclcpp::init(argc, argv);
+  auto node = std::make_shared<rclcpp::Node>("tracking_replay");
+  TrackingStream::Options opts = TrackingNode::declareOptions(node.get());
+  TrackingManager tm(node.get(), opts.num_threads);
+  TrackingStream::configure(tm, opts);
+
+  std::unique_ptr<CaptureReader> reader;
+  try {
+    reader.reset(new CaptureReader(file));
+  } catch (std::runtime_error & e) {
+    RCUTILS_LOG_ERROR("%s\n", e.what());
+    rclcpp::shutdown();
+    return 1;
+  }
+
+  /* frames are kept as long as the stream buffers them*/
+  object_analytics_node::util::StampedRingBuffer<std::shared_ptr<FrameContext>> frames(
+    opts.queue_size);
+  object_analytics_msgs::msg::TrackedObjects tracked;
+  CallTotal detect, track, extrapolate, replenish;
+  uint64_t missing = 0;
+  bool warm = !opts.warmup;
+  CaptureReader::Record record;
+  auto start = std::chrono::steady_clock::now();
+  while (reader->next(record)) {
+    if (record.type == TrackingCapture::kFrame) {
+      if (record.image.empty()) {
+        continue;
+      }
+      if (!warm) {
+        tm.warmup(record.image.size());
+        warm = true;
+        start = std::chrono::steady_clock::now();
+      }
+      tm.setWorkingScale(record.scale);
+      frames.push(record.stamp, FrameContext::isSupported(record.encoding) ?
+        std::make_shared<FrameContext>(record.image, record.encoding) :
+        std::make_shared<FrameContext>(record.image));
+      continue;
+    }
+    if (record.type == TrackingCapture::kAlgo) {
+      tm.setAlgo(record.algo);
+      continue;
+    }
+    const std::shared_ptr<FrameContext> * ctx = frames.find(record.stamp);
+    auto begin = std::chrono::steady_clock::now();
+    CallTotal * total = nullptr;
+    switch (record.type) {
+      case TrackingCapture::kDetect:
+      case TrackingCapture::kTrack:
+        /* the capture fell behind and dropped the frame*/
+        if (ctx == nullptr) {
+          missing++;
+          continue;
+        }
+        if (record.type == TrackingCapture::kDetect) {
+          tm.detect(**ctx, record.objs, record.loc);
+          total = &detect;
+        } else {
+          tm.track(**ctx, rclcpp::Time(record.stamp));
+          total = &track;
+        }
+        break;
+      case TrackingCapture::kExtrapolate:
+        tm.extrapolate(rclcpp::Time(record.stamp));
+        total = &extrapolate;
+        break;
+      case TrackingCapture::kReplenish:
+        tm.replenish();
+        total = &replenish;
+        break;
+      default:
+        continue;
+    }
+    /* the stream collects the tracked objects of each frame*/
+    if (record.type != TrackingCapture::kReplenish) {
+      tracked.tracked_objects.clear();
+      tm.getTrackedObjs(tracked);
+    }
+    total->add(std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - begin).count());
+  }
+  double wall_ms = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "call,count,mean_ms,max_ms,total_ms" << std::endl;
+  auto report = [](const char * name, const CallTotal & t) {
+      std::cout << name << "," << t.count << "," << std::fixed << std::setprecision(3) <<
+        (t.count > 0 ? t.sum_ms / t.count : 0.) << "," << t.max_ms << "," << t.sum_ms <<
+        std::endl;
+    };
+  report("detect", detect);
+  report("track", track);
+  report("extrapolate", extrapolate);
+  report("replenish", replenish);
+  std::cout << "replayed in " << wall_ms << "ms, " << missing <<
+    " calls skipped for frames not captured" << std::endl;
+  rclcpp::shutdown();
+  return 0;
+}
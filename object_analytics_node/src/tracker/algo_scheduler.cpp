@@ -0,0 +1,124 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "object_analytics_node/tracker/algo_scheduler.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const double AlgoScheduler::kSmoothing = 0.1;
+
+AlgoScheduler::AlgoScheduler()
+: budget_ms_(0), num_threads_(1), large_area_(96 * 96)
+{
+  levels_[0] = "KCF";
+  levels_[1] = "MEDIAN_FLOW";
+  levels_[2] = "KALMAN";
+
+  /* rough priors on a desktop CPU, replaced as costs are observed*/
+  cost_["KCF"] = 3.0;
+  cost_["TLD"] = 10.0;
+  cost_["BOOSTING"] = 10.0;
+  cost_["MEDIAN_FLOW"] = 1.0;
+  cost_["MIL"] = 20.0;
+  cost_["GOTURN"] = 30.0;
+  cost_["GOTURN_BATCH"] = 5.0;
+  cost_["KALMAN"] = 0.01;
+}
+
+void AlgoScheduler::setBudget(double budget_ms, int32_t num_threads)
+{
+  budget_ms_ = budget_ms;
+  num_threads_ = num_threads > 0 ? num_threads : 1;
+}
+
+void AlgoScheduler::setAlgos(
+  const std::string & large, const std::string & small,
+  const std::string & fallback)
+{
+  levels_[0] = large;
+  levels_[1] = small;
+  levels_[2] = fallback;
+}
+
+std::vector<std::string> AlgoScheduler::getAlgos() const
+{
+  std::vector<std::string> algos;
+  for (auto & level : levels_) {
+    if (!level.empty() && std::find(algos.begin(), algos.end(), level) == algos.end()) {
+      algos.push_back(level);
+    }
+  }
+  return algos;
+}
+
+void AlgoScheduler::observe(const std::string & algo, double cost_ms)
+{
+  std::map<std::string, double>::iterator c = cost_.find(algo);
+  if (c == cost_.end()) {
+    cost_[algo] = cost_ms;
+  } else {
+    c->second += kSmoothing * (cost_ms - c->second);
+  }
+}
+
+double AlgoScheduler::getCost(const std::string & algo) const
+{
+  std::map<std::string, double>::const_iterator c = cost_.find(algo);
+  return c == cost_.end() ? 1.0 : c->second;
+}
+
+std::vector<std::string> AlgoScheduler::schedule(const std::vector<cv::Rect2d> & rects) const
+{
+  /* preferred level by object size*/
+  std::vector<int> level(rects.size());
+  double total = 0;
+  for (size_t i = 0; i < rects.size(); i++) {
+    level[i] = rects[i].area() >= large_area_ ? 0 : 1;
+    total += getCost(levels_[level[i]]);
+  }
+
+  /* degrade the smallest objects first until the frame fits*/
+  double capacity = budget_ms_ * num_threads_;
+  if (isEnabled() && total > capacity) {
+    std::vector<size_t> order(rects.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+      [&rects](size_t a, size_t b) {return rects[a].area() < rects[b].area();});
+    for (int pass = 0; pass < 2 && total > capacity; pass++) {
+      for (size_t k = 0; k < order.size() && total > capacity; k++) {
+        int & l = level[order[k]];
+        if (l < 2) {
+          total += getCost(levels_[l + 1]) - getCost(levels_[l]);
+          l++;
+        }
+      }
+    }
+  }
+
+  std::vector<std::string> algos(rects.size());
+  for (size_t i = 0; i < rects.size(); i++) {
+    algos[i] = levels_[level[i]];
+  }
+  return algos;
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
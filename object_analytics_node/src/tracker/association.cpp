@@ -0,0 +1,177 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "object_analytics_node/tracker/association.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const double Association::kInfeasible = -std::numeric_limits<double>::infinity();
+const double Association::kMaxScore = 1e6;
+
+std::vector<int> Association::solve(
+  const std::vector<std::vector<double>> & scores,
+  double min_score)
+{
+  const size_t rows = scores.size();
+  const size_t cols = rows > 0 ? scores[0].size() : 0;
+  std::vector<int> assignment(rows, -1);
+  if (rows == 0 || cols == 0) {
+    return assignment;
+  }
+
+  /* the solver below requires n <= m, work on the transposed matrix if not*/
+  const bool transposed = rows > cols;
+  const size_t n = transposed ? cols : rows;
+  const size_t m = transposed ? rows : cols;
+  auto score = [&scores, transposed](size_t i, size_t j) -> double {
+      return transposed ? scores[j][i] : scores[i][j];
+    };
+  /* maximizing scores is minimizing negated scores, a gated pair costs
+   * nothing so that it never displaces a feasible one*/
+  auto cost = [&score, min_score](size_t i, size_t j) -> double {
+      double s = score(i, j);
+      return s > min_score ? -std::min(s, kMaxScore) : 0.0;
+    };
+
+  /* Kuhn-Munkres with row/column potentials, O(n^2 * m)*/
+  const double inf = std::numeric_limits<double>::infinity();
+  std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0);
+  std::vector<size_t> p(m + 1, 0), way(m + 1, 0);
+  for (size_t i = 1; i <= n; i++) {
+    p[0] = i;
+    size_t j0 = 0;
+    std::vector<double> minv(m + 1, inf);
+    std::vector<char> used(m + 1, false);
+    do {
+      used[j0] = true;
+      size_t i0 = p[j0], j1 = 0;
+      double delta = inf;
+      for (size_t j = 1; j <= m; j++) {
+        if (used[j]) {
+          continue;
+        }
+        double cur = cost(i0 - 1, j - 1) - u[i0] - v[j];
+        if (cur < minv[j]) {
+          minv[j] = cur;
+          way[j] = j0;
+        }
+        if (minv[j] < delta) {
+          delta = minv[j];
+          j1 = j;
+        }
+      }
+      for (size_t j = 0; j <= m; j++) {
+        if (used[j]) {
+          u[p[j]] += delta;
+          v[j] -= delta;
+        } else {
+          minv[j] -= delta;
+        }
+      }
+      j0 = j1;
+    } while (p[j0] != 0);
+    do {
+      size_t j1 = way[j0];
+      p[j0] = p[j1];
+      j0 = j1;
+    } while (j0 != 0);
+  }
+
+  for (size_t j = 1; j <= m; j++) {
+    if (p[j] == 0 || !(score(p[j] - 1, j - 1) > min_score)) {
+      continue;
+    }
+    size_t row = transposed ? j - 1 : p[j] - 1;
+    size_t col = transposed ? p[j] - 1 : j - 1;
+    assignment[row] = static_cast<int>(col);
+  }
+
+  return assignment;
+}
+
+std::vector<int> Association::solve(
+  size_t rows, size_t cols,
+  const std::vector<Edge> & edges,
+  double min_score)
+{
+  std::vector<int> assignment(rows, -1);
+
+  /* union-find over rows [0, rows) and columns [rows, rows + cols)*/
+  std::vector<size_t> parent(rows + cols);
+  for (size_t i = 0; i < parent.size(); i++) {
+    parent[i] = i;
+  }
+  auto find = [&parent](size_t i) -> size_t {
+      while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+      }
+      return i;
+    };
+  for (auto & e : edges) {
+    if (e.score > min_score) {
+      size_t a = find(e.row), b = find(rows + e.col);
+      if (a != b) {
+        parent[std::max(a, b)] = std::min(a, b);
+      }
+    }
+  }
+
+  /* group feasible pairs by connected component*/
+  std::unordered_map<size_t, std::vector<const Edge *>> groups;
+  for (auto & e : edges) {
+    if (e.score > min_score) {
+      groups[find(e.row)].push_back(&e);
+    }
+  }
+
+  for (auto & g : groups) {
+    std::vector<size_t> grows, gcols;
+    for (auto e : g.second) {
+      grows.push_back(e->row);
+      gcols.push_back(e->col);
+    }
+    std::sort(grows.begin(), grows.end());
+    grows.erase(std::unique(grows.begin(), grows.end()), grows.end());
+    std::sort(gcols.begin(), gcols.end());
+    gcols.erase(std::unique(gcols.begin(), gcols.end()), gcols.end());
+
+    std::vector<std::vector<double>> scores(grows.size(),
+      std::vector<double>(gcols.size(), kInfeasible));
+    for (auto e : g.second) {
+      size_t r = std::lower_bound(grows.begin(), grows.end(), e->row) - grows.begin();
+      size_t c = std::lower_bound(gcols.begin(), gcols.end(), e->col) - gcols.begin();
+      scores[r][c] = e->score;
+    }
+
+    std::vector<int> local = solve(scores, min_score);
+    for (size_t r = 0; r < local.size(); r++) {
+      if (local[r] >= 0) {
+        assignment[grows[r]] = static_cast<int>(gcols[local[r]]);
+      }
+    }
+  }
+
+  return assignment;
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -0,0 +1,223 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <opencv2/imgproc.hpp>
+#include <rcutils/logging_macros.h>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "object_analytics_node/tracker/batch_goturn.hpp"
+
+/* cv::dnn runs on the OpenVINO inference engine and its targets since 3.4*/
+#if CV_VERSION_MAJOR > 3 || CV_VERSION_MINOR >= 4
+#include <opencv2/dnn.hpp>
+#define OA_BATCH_GOTURN 1
+#endif
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const int BatchGoturn::kInputSize = 227;
+const double BatchGoturn::kPadding = 2.0;
+
+#ifdef OA_BATCH_GOTURN
+struct BatchGoturn::Network
+{
+  cv::dnn::Net net;
+};
+#else
+struct BatchGoturn::Network
+{
+};
+#endif
+
+BatchGoturn::BatchGoturn()
+: net_(new Network()), loaded_(false)
+{
+}
+
+BatchGoturn::~BatchGoturn()
+{
+}
+
+bool BatchGoturn::parseDevice(const std::string & device, int & backend, int & target)
+{
+#ifdef OA_BATCH_GOTURN
+  backend = cv::dnn::DNN_BACKEND_INFERENCE_ENGINE;
+  if (device == "CPU") {
+    target = cv::dnn::DNN_TARGET_CPU;
+  } else if (device == "GPU") {
+    target = cv::dnn::DNN_TARGET_OPENCL;
+  } else if (device == "GPU_FP16") {
+    target = cv::dnn::DNN_TARGET_OPENCL_FP16;
+  } else if (device == "MYRIAD") {
+    target = cv::dnn::DNN_TARGET_MYRIAD;
+  } else if (device == "OPENCV") {
+    backend = cv::dnn::DNN_BACKEND_OPENCV;
+    target = cv::dnn::DNN_TARGET_CPU;
+  } else {
+    return false;
+  }
+  return true;
+#else
+  (void)device;
+  (void)backend;
+  (void)target;
+  return false;
+#endif
+}
+
+bool BatchGoturn::load(
+  const std::string & prototxt, const std::string & weights,
+  const std::string & device, std::string & error)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  loaded_ = false;
+#ifdef OA_BATCH_GOTURN
+  int backend, target;
+  if (!parseDevice(device, backend, target)) {
+    error = "unknown device " + device;
+    return false;
+  }
+  try {
+    net_->net = cv::dnn::readNetFromCaffe(prototxt, weights);
+    if (net_->net.empty()) {
+      error = "cannot read " + prototxt + " and " + weights;
+      return false;
+    }
+    net_->net.setPreferableBackend(backend);
+    net_->net.setPreferableTarget(target);
+  } catch (cv::Exception & e) {
+    error = e.what();
+    return false;
+  }
+  loaded_ = true;
+  return true;
+#else
+  (void)prototxt;
+  (void)weights;
+  (void)device;
+  error = "cv::dnn targets need OpenCV 3.4 or later";
+  return false;
+#endif
+}
+
+cv::Rect2d BatchGoturn::getRegion(const cv::Rect2d & rect)
+{
+  double w = rect.width * kPadding, h = rect.height * kPadding;
+  return cv::Rect2d(rect.x + rect.width / 2 - w / 2, rect.y + rect.height / 2 - h / 2, w, h);
+}
+
+void BatchGoturn::crop(const cv::Mat & bgr, const cv::Rect2d & region, cv::Mat & patch)
+{
+  /* crop and scale in one pass, no copy of the padded frame*/
+  double sx = kInputSize / region.width, sy = kInputSize / region.height;
+  cv::Matx23d m(sx, 0, -region.x * sx, 0, sy, -region.y * sy);
+  cv::warpAffine(bgr, patch, m, cv::Size(kInputSize, kInputSize), cv::INTER_LINEAR,
+    cv::BORDER_REPLICATE);
+}
+
+void BatchGoturn::seed(const cv::Mat & bgr, const cv::Rect2d & rect, Target & target)
+{
+  target.rect = rect;
+  crop(bgr, getRegion(rect), target.patch);
+}
+
+bool BatchGoturn::update(
+  const cv::Mat & bgr, const std::vector<Target *> & targets,
+  std::vector<char> & tracked, util::ThreadPool * pool)
+{
+  tracked.assign(targets.size(), false);
+  if (targets.empty()) {
+    return true;
+  }
+#ifdef OA_BATCH_GOTURN
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!loaded_) {
+    return false;
+  }
+  size_t n = targets.size();
+  previous_.resize(n);
+  current_.resize(n);
+  regions_.resize(n);
+  auto cropTarget = [this, &bgr, &targets](size_t i) {
+      regions_[i] = getRegion(targets[i]->rect);
+      previous_[i] = targets[i]->patch;
+      crop(bgr, regions_[i], current_[i]);
+    };
+  if (pool != nullptr) {
+    pool->parallelFor(n, cropTarget);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      cropTarget(i);
+    }
+  }
+
+  cv::Mat rois;
+  try {
+    /* mean subtracted in float, as cv::TrackerGOTURN feeds the network*/
+    cv::Scalar mean(128, 128, 128);
+    net_->net.setInput(cv::dnn::blobFromImages(previous_, 1.0, cv::Size(), mean, false, false),
+      "data1");
+    net_->net.setInput(cv::dnn::blobFromImages(current_, 1.0, cv::Size(), mean, false, false),
+      "data2");
+    rois = net_->net.forward("scale").reshape(1, static_cast<int>(n));
+  } catch (cv::Exception & e) {
+    RCUTILS_LOG_WARN("GOTURN_BATCH forward of %zu objects failed: %s", n, e.what());
+    return false;
+  }
+  forwards_++;
+
+  /* corners regressed in the coordinates of the patch of each region*/
+  for (size_t i = 0; i < n; i++) {
+    const float * r = rois.ptr<float>(static_cast<int>(i));
+    const cv::Rect2d & region = regions_[i];
+    double sx = region.width / kInputSize, sy = region.height / kInputSize;
+    cv::Rect2d rect(region.x + r[0] * sx, region.y + r[1] * sy, (r[2] - r[0]) * sx,
+      (r[3] - r[1]) * sy);
+    if (!std::isfinite(rect.x) || !std::isfinite(rect.y) || !(rect.width > 0) ||
+      !(rect.height > 0))
+    {
+      continue;
+    }
+    targets[i]->rect = rect;
+    tracked[i] = true;
+  }
+  tracked_ += n;
+
+  /* patches of the next frame, at the rois just tracked*/
+  auto reseed = [this, &bgr, &targets, &tracked](size_t i) {
+      if (tracked[i]) {
+        crop(bgr, getRegion(targets[i]->rect), targets[i]->patch);
+      }
+    };
+  if (pool != nullptr) {
+    pool->parallelFor(n, reseed);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      reseed(i);
+    }
+  }
+  previous_.assign(n, cv::Mat());
+  return true;
+#else
+  (void)bgr;
+  (void)pool;
+  return false;
+#endif
+}
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -0,0 +1,133 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "object_analytics_node/tracker/frame_context.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const int FrameContext::kPyramidLevels = 3;
+const int FrameContext::kInputLevels = 3;
+
+FrameContext::FrameContext(const cv::Mat & bgr)
+: image_(bgr), encoding_("bgr8"), bgr_levels_(kInputLevels - 1),
+  gray_levels_(kInputLevels - 1) {}
+
+FrameContext::FrameContext(const cv::Mat & image, const std::string & encoding)
+: image_(image), encoding_(encoding), bgr_levels_(kInputLevels - 1),
+  gray_levels_(kInputLevels - 1) {}
+
+const cv::Mat & FrameContext::getBgr()
+{
+  std::call_once(bgr_once_, [this]() {
+      if (encoding_ == "rgb8") {
+        cv::cvtColor(image_, bgr_, cv::COLOR_RGB2BGR);
+      } else if (encoding_ == "mono8") {
+        cv::cvtColor(image_, bgr_, cv::COLOR_GRAY2BGR);
+      } else {
+        bgr_ = image_;
+      }
+      addBytes(bgr_);
+    });
+  return bgr_;
+}
+
+const cv::Mat & FrameContext::getGray()
+{
+  std::call_once(gray_once_, [this]() {
+      if (image_.channels() == 1) {
+        gray_ = image_;
+      } else if (encoding_ == "rgb8") {
+        cv::cvtColor(image_, gray_, cv::COLOR_RGB2GRAY);
+      } else {
+        cv::cvtColor(image_, gray_, cv::COLOR_BGR2GRAY);
+      }
+      addBytes(gray_);
+    });
+  return gray_;
+}
+
+const std::vector<cv::Mat> & FrameContext::getPyramid()
+{
+  const cv::Mat & gray = getGray();
+  std::call_once(pyramid_once_, [this, &gray]() {
+      cv::buildOpticalFlowPyramid(gray, pyramid_, cv::Size(21, 21), kPyramidLevels);
+      /* levels built with a border are views, counted by their visible size*/
+      for (auto & level : pyramid_) {
+        addBytes(level);
+      }
+    });
+  return pyramid_;
+}
+
+const cv::Mat & FrameContext::getInput(const std::string & algo)
+{
+  return isGrayInput(algo) ? getGray() : getBgr();
+}
+
+const cv::Mat & FrameContext::getInput(const std::string & algo, int level)
+{
+  const cv::Mat & input = getInput(algo);
+  level = std::min(std::max(level, 0), kInputLevels - 1);
+  if (level == 0) {
+    return input;
+  }
+  std::vector<cv::Mat> & levels = isGrayInput(algo) ? gray_levels_ : bgr_levels_;
+  std::lock_guard<std::mutex> lock(levels_mutex_);
+  for (int l = 1; l <= level; l++) {
+    if (levels[l - 1].empty()) {
+      cv::pyrDown(l == 1 ? input : levels[l - 2], levels[l - 1]);
+      addBytes(levels[l - 1]);
+    }
+  }
+  return levels[level - 1];
+}
+
+void FrameContext::prepare(const std::vector<std::string> & algos)
+{
+  for (auto & algo : algos) {
+    getInput(algo);
+  }
+}
+
+void FrameContext::addBytes(const cv::Mat & mat)
+{
+  if (mat.data != image_.data) {
+    bytes_ += mat.total() * mat.elemSize();
+  }
+}
+
+bool FrameContext::isGrayInput(const std::string & algo)
+{
+/* MEDIAN_FLOW of OpenCV 3.2 converts its input without checking channels*/
+#if CV_VERSION_MAJOR > 3 || CV_VERSION_MINOR > 2
+  return algo == "MEDIAN_FLOW" || algo == "TLD" || algo == "PARTICLE";
+#else
+  return algo == "TLD" || algo == "PARTICLE";
+#endif
+}
+
+bool FrameContext::isSupported(const std::string & encoding)
+{
+  return encoding == "bgr8" || encoding == "rgb8" || encoding == "mono8";
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
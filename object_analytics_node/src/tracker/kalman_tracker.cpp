@@ -0,0 +1,111 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include "object_analytics_node/tracker/kalman_tracker.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const float KalmanTracker::kMeasurementNoise = 10.0f;
+const float KalmanTracker::kPositionNoise = 10.0f;
+const float KalmanTracker::kVelocityNoise = 100.0f;
+
+KalmanTracker::KalmanTracker()
+: kf_(8, 4, 0, CV_32F), stamp_(0), initialized_(false)
+{
+  kf_.measurementMatrix = cv::Mat::zeros(4, 8, CV_32F);
+  for (int i = 0; i < 4; i++) {
+    kf_.measurementMatrix.at<float>(i, i) = 1.0f;
+  }
+  cv::setIdentity(kf_.measurementNoiseCov, cv::Scalar::all(kMeasurementNoise));
+}
+
+void KalmanTracker::init(const cv::Rect2d & rect, int64_t stamp)
+{
+  kf_.statePost = cv::Mat::zeros(8, 1, CV_32F);
+  kf_.statePost.at<float>(0) = static_cast<float>(rect.x + rect.width / 2);
+  kf_.statePost.at<float>(1) = static_cast<float>(rect.y + rect.height / 2);
+  kf_.statePost.at<float>(2) = static_cast<float>(rect.width);
+  kf_.statePost.at<float>(3) = static_cast<float>(rect.height);
+  /* position is known as well as measured, velocity is unknown*/
+  cv::setIdentity(kf_.errorCovPost, cv::Scalar::all(kMeasurementNoise));
+  for (int i = 4; i < 8; i++) {
+    kf_.errorCovPost.at<float>(i, i) = kVelocityNoise * 10;
+  }
+  stamp_ = stamp;
+  initialized_ = true;
+}
+
+cv::Rect2d KalmanTracker::predict(int64_t stamp)
+{
+  if (stamp != stamp_) {
+    setTimeStep((stamp - stamp_) / 1e9);
+    kf_.predict();
+    stamp_ = stamp;
+  }
+  return toRect(kf_.statePost);
+}
+
+cv::Rect2d KalmanTracker::correct(const cv::Rect2d & rect, int64_t stamp)
+{
+  if (!initialized_) {
+    init(rect, stamp);
+    return rect;
+  }
+
+  predict(stamp);
+  cv::Mat measurement(4, 1, CV_32F);
+  measurement.at<float>(0) = static_cast<float>(rect.x + rect.width / 2);
+  measurement.at<float>(1) = static_cast<float>(rect.y + rect.height / 2);
+  measurement.at<float>(2) = static_cast<float>(rect.width);
+  measurement.at<float>(3) = static_cast<float>(rect.height);
+  kf_.correct(measurement);
+  return toRect(kf_.statePost);
+}
+
+cv::Point2d KalmanTracker::getVelocity() const
+{
+  if (!initialized_) {
+    return cv::Point2d(0, 0);
+  }
+  return cv::Point2d(kf_.statePost.at<float>(4), kf_.statePost.at<float>(5));
+}
+
+void KalmanTracker::setTimeStep(double dt)
+{
+  kf_.transitionMatrix = cv::Mat::eye(8, 8, CV_32F);
+  for (int i = 0; i < 4; i++) {
+    kf_.transitionMatrix.at<float>(i, i + 4) = static_cast<float>(dt);
+  }
+  /* extrapolating back in time is as uncertain as forward*/
+  float step = static_cast<float>(std::fabs(dt));
+  kf_.processNoiseCov = cv::Mat::zeros(8, 8, CV_32F);
+  for (int i = 0; i < 4; i++) {
+    kf_.processNoiseCov.at<float>(i, i) = kPositionNoise * step;
+    kf_.processNoiseCov.at<float>(i + 4, i + 4) = kVelocityNoise * step;
+  }
+}
+
+cv::Rect2d KalmanTracker::toRect(const cv::Mat & state)
+{
+  double w = std::max(1.0f, state.at<float>(2));
+  double h = std::max(1.0f, state.at<float>(3));
+  return cv::Rect2d(state.at<float>(0) - w / 2, state.at<float>(1) - h / 2, w, h);
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -0,0 +1,133 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <map>
+#include <utility>
+#include <vector>
+#include "object_analytics_node/tracker/association.hpp"
+#include "object_analytics_node/tracker/mot_evaluator.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+
+const double MotEvaluator::kDefaultIou = 0.5;
+
+static double iou(const cv::Rect2d & a, const cv::Rect2d & b)
+{
+  double inter = (a & b).area();
+  double uni = a.area() + b.area() - inter;
+  return uni > 0. ? inter / uni : 0.;
+}
+
+MotEvaluator::MotEvaluator(double min_iou)
+: min_iou_(min_iou)
+{
+}
+
+void MotEvaluator::addFrame(const std::vector<Box> & targets, const std::vector<Box> & hypotheses)
+{
+  counts_.frames++;
+  counts_.targets += targets.size();
+  counts_.hypotheses += hypotheses.size();
+
+  std::vector<int> matched(targets.size(), -1);
+  std::vector<bool> taken(hypotheses.size(), false);
+  std::vector<Association::Edge> edges;
+  for (size_t t = 0; t < targets.size(); t++) {
+    auto last = last_match_.find(targets[t].id);
+    for (size_t h = 0; h < hypotheses.size(); h++) {
+      double score = iou(targets[t].roi, hypotheses[h].roi);
+      if (score < min_iou_) {
+        continue;
+      }
+      overlaps_[std::make_pair(targets[t].id, hypotheses[h].id)]++;
+      /* a correspondence still valid is kept*/
+      if (last != last_match_.end() && last->second == hypotheses[h].id && !taken[h]) {
+        matched[t] = static_cast<int>(h);
+        taken[h] = true;
+      }
+    }
+  }
+  for (size_t t = 0; t < targets.size(); t++) {
+    if (matched[t] >= 0) {
+      continue;
+    }
+    for (size_t h = 0; h < hypotheses.size(); h++) {
+      double score = iou(targets[t].roi, hypotheses[h].roi);
+      if (!taken[h] && score >= min_iou_) {
+        edges.push_back({t, h, score});
+      }
+    }
+  }
+  std::vector<int> assigned = Association::solve(targets.size(), hypotheses.size(), edges, 0.);
+  for (size_t t = 0; t < targets.size(); t++) {
+    if (matched[t] < 0 && assigned[t] >= 0) {
+      matched[t] = assigned[t];
+      taken[assigned[t]] = true;
+    }
+  }
+
+  uint64_t frame_matches = 0;
+  for (size_t t = 0; t < targets.size(); t++) {
+    if (matched[t] < 0) {
+      counts_.misses++;
+      continue;
+    }
+    const Box & h = hypotheses[matched[t]];
+    frame_matches++;
+    iou_sum_ += iou(targets[t].roi, h.roi);
+    auto last = last_match_.find(targets[t].id);
+    if (last != last_match_.end() && last->second != h.id) {
+      counts_.id_switches++;
+    }
+    last_match_[targets[t].id] = h.id;
+  }
+  counts_.matches += frame_matches;
+  counts_.false_positives += hypotheses.size() - frame_matches;
+}
+
+MotEvaluator::Summary MotEvaluator::getSummary() const
+{
+  Summary s = counts_;
+  if (s.targets > 0) {
+    s.mota = 1. - static_cast<double>(s.misses + s.false_positives + s.id_switches) / s.targets;
+  }
+  if (s.matches > 0) {
+    s.motp = iou_sum_ / s.matches;
+  }
+
+  /* targets assigned to trackings for the whole sequence*/
+  std::map<int64_t, size_t> rows, cols;
+  std::vector<Association::Edge> edges;
+  for (auto & o : overlaps_) {
+    size_t r = rows.emplace(o.first.first, rows.size()).first->second;
+    size_t c = cols.emplace(o.first.second, cols.size()).first->second;
+    edges.push_back({r, c, static_cast<double>(o.second)});
+  }
+  std::vector<int> assigned = Association::solve(rows.size(), cols.size(), edges, 0.);
+  double idtp = 0.;
+  for (auto & e : edges) {
+    if (assigned[e.row] == static_cast<int>(e.col)) {
+      idtp += e.score;
+    }
+  }
+  if (s.targets + s.hypotheses > 0) {
+    s.idf1 = 2. * idtp / (s.targets + s.hypotheses);
+  }
+  return s;
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
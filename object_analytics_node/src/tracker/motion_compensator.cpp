@@ -0,0 +1,96 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <opencv2/video/tracking.hpp>
+#include <algorithm>
+#include <vector>
+#include "object_analytics_node/tracker/motion_compensator.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const int MotionCompensator::kGridSide = 10;
+
+namespace
+{
+/* distance in pixels a point may come back off its start*/
+const float kMaxBackError = 1.0f;
+/* least share of the grid of a roi tracked back for its shift*/
+const double kMinTracked = 0.3;
+
+double median(std::vector<double> & values)
+{
+  auto mid = values.begin() + values.size() / 2;
+  std::nth_element(values.begin(), mid, values.end());
+  return *mid;
+}
+}  // namespace
+
+size_t MotionCompensator::estimate(
+  FrameContext & from, FrameContext & to, const std::vector<cv::Rect2d> & rois,
+  std::vector<cv::Point2d> & shifts)
+{
+  shifts.assign(rois.size(), cv::Point2d(0, 0));
+  if (rois.empty() || from.getSize() != to.getSize()) {
+    return 0;
+  }
+
+  /* a grid inside each roi, a margin off its edges where the background shows*/
+  const int per_roi = kGridSide * kGridSide;
+  cv::Rect2d frame(0, 0, from.getSize().width, from.getSize().height);
+  std::vector<cv::Point2f> points;
+  points.reserve(rois.size() * per_roi);
+  for (auto & roi : rois) {
+    cv::Rect2d r = roi & frame;
+    for (int y = 0; y < kGridSide; y++) {
+      for (int x = 0; x < kGridSide; x++) {
+        points.push_back(cv::Point2f(
+            static_cast<float>(r.x + r.width * (x + 1) / (kGridSide + 1)),
+            static_cast<float>(r.y + r.height * (y + 1) / (kGridSide + 1))));
+      }
+    }
+  }
+
+  /* all rois in one call each way, on the pyramids shared with the trackers*/
+  const cv::Size window(21, 21);
+  std::vector<cv::Point2f> forward, back;
+  std::vector<uchar> status_forward, status_back;
+  std::vector<float> err;
+  cv::calcOpticalFlowPyrLK(from.getPyramid(), to.getPyramid(), points, forward,
+    status_forward, err, window, FrameContext::kPyramidLevels);
+  cv::calcOpticalFlowPyrLK(to.getPyramid(), from.getPyramid(), forward, back,
+    status_back, err, window, FrameContext::kPyramidLevels);
+
+  size_t found = 0;
+  std::vector<double> dx, dy;
+  for (size_t k = 0; k < rois.size(); k++) {
+    dx.clear();
+    dy.clear();
+    for (int i = k * per_roi; i < static_cast<int>((k + 1) * per_roi); i++) {
+      if (status_forward[i] && status_back[i] && cv::norm(back[i] - points[i]) < kMaxBackError) {
+        dx.push_back(forward[i].x - points[i].x);
+        dy.push_back(forward[i].y - points[i].y);
+      }
+    }
+    if (dx.size() < static_cast<size_t>(per_roi * kMinTracked)) {
+      continue;
+    }
+    shifts[k] = cv::Point2d(median(dx), median(dy));
+    found++;
+  }
+  return found;
+}
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include "object_analytics_node/tracker/overload_gate.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+OverloadGate::OverloadGate(
+  Policy policy, double latency_target_ms, uint32_t interval,
+  uint32_t max_skip)
+: policy_(policy), latency_target_ms_(latency_target_ms),
+  interval_(interval > 0 ? interval : 1), max_skip_(max_skip > 0 ? max_skip : 1),
+  since_track_(0), overloaded_(false), late_(0),
+  skipped_(0), skipped_in_overload_(0)
+{
+}
+
+bool OverloadGate::parse(const std::string & name, Policy & policy)
+{
+  if (name == "none") {
+    policy = kNone;
+  } else if (name == "latest") {
+    policy = kLatest;
+  } else if (name == "every_k") {
+    policy = kEveryK;
+  } else if (name == "interpolate") {
+    policy = kInterpolate;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+OverloadGate::Action OverloadGate::admit(double latency_ms)
+{
+  if (policy_ == kNone || latency_ms <= latency_target_ms_) {
+    overloaded_ = false;
+    late_ = 0;
+    skipped_in_overload_ = 0;
+    since_track_ = 0;
+    return kTrack;
+  }
+
+  overloaded_ = true;
+  Action action;
+  switch (policy_) {
+    case kLatest:
+      action = kSkip;
+      break;
+    case kEveryK:
+      action = (late_ % interval_ == interval_ - 1) ? kTrack : kSkip;
+      break;
+    default:
+      action = kExtrapolate;
+      break;
+  }
+  if (action != kTrack && since_track_ >= max_skip_) {
+    action = kTrack;
+  }
+  late_++;
+  if (action != kTrack) {
+    skipped_++;
+    skipped_in_overload_++;
+    since_track_++;
+  } else {
+    since_track_ = 0;
+  }
+  return action;
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
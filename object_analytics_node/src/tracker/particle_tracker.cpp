@@ -0,0 +1,239 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "object_analytics_node/tracker/particle_tracker.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const int ParticleTracker::kBins = 16;
+const int ParticleTracker::kParticlesPerCore = 32;
+const double ParticleTracker::kPositionStd = 0.1;
+const double ParticleTracker::kScaleStd = 0.02;
+const double ParticleTracker::kLambda = 20.0;
+const double ParticleTracker::kMinSimilarity = 0.5;
+
+namespace
+{
+/* normalized histogram of a roi of the integral images, false if empty*/
+bool histogram(const std::vector<cv::Mat> & integrals, const cv::Rect & rect, float * hist)
+{
+  if (rect.area() <= 0) {
+    return false;
+  }
+  int x0 = rect.x, y0 = rect.y, x1 = rect.x + rect.width, y1 = rect.y + rect.height;
+  double sum = 0;
+  for (size_t b = 0; b < integrals.size(); b++) {
+    const cv::Mat & s = integrals[b];
+    int v = s.at<int>(y1, x1) - s.at<int>(y0, x1) - s.at<int>(y1, x0) + s.at<int>(y0, x0);
+    hist[b] = static_cast<float>(v);
+    sum += v;
+  }
+  if (sum <= 0) {
+    return false;
+  }
+  for (size_t b = 0; b < integrals.size(); b++) {
+    hist[b] = static_cast<float>(hist[b] / sum);
+  }
+  return true;
+}
+
+/* weights a range of particles by the similarity of their histogram*/
+class WeightBody : public cv::ParallelLoopBody
+{
+public:
+  WeightBody(
+    const cv::Mat & particles, const std::vector<cv::Mat> & integrals,
+    const cv::Rect & region, const std::vector<float> & reference, double lambda,
+    cv::Mat & weights, cv::Mat & similarities)
+  : particles_(particles), integrals_(integrals), region_(region), reference_(reference),
+    lambda_(lambda), weights_(weights), similarities_(similarities) {}
+
+  void operator()(const cv::Range & range) const override
+  {
+    std::vector<float> hist(reference_.size());
+    cv::Rect bounds(0, 0, region_.width, region_.height);
+    for (int i = range.start; i < range.end; i++) {
+      const double * p = particles_.ptr<double>(i);
+      cv::Rect r(cvRound(p[0] - p[2] / 2) - region_.x, cvRound(p[1] - p[3] / 2) - region_.y,
+        cvRound(p[2]), cvRound(p[3]));
+      double bc = 0;
+      if (histogram(integrals_, r & bounds, hist.data())) {
+        for (size_t b = 0; b < hist.size(); b++) {
+          bc += std::sqrt(reference_[b] * hist[b]);
+        }
+      }
+      similarities_.at<double>(i) = bc;
+      weights_.at<double>(i) = std::exp(-lambda_ * (1 - bc));
+    }
+  }
+
+private:
+  const cv::Mat & particles_;
+  const std::vector<cv::Mat> & integrals_;
+  cv::Rect region_;
+  const std::vector<float> & reference_;
+  double lambda_;
+  cv::Mat & weights_;
+  cv::Mat & similarities_;
+};
+}  // namespace
+
+ParticleTracker::ParticleTracker(int particles, uint64_t seed)
+: particles_count_(particles > 0 ? particles : 0), rng_(seed), similarity_(0) {}
+
+void ParticleTracker::setParticles(int particles)
+{
+  particles_count_ = particles > 0 ? particles : 0;
+}
+
+int ParticleTracker::getParticles() const
+{
+  return particles_count_ > 0 ? particles_count_ :
+         kParticlesPerCore * std::max(1, cv::getNumberOfCPUs());
+}
+
+void ParticleTracker::init(const cv::Mat & gray, const cv::Rect2d & rect)
+{
+  cv::Rect r = cv::Rect(rect) & cv::Rect(0, 0, gray.cols, gray.rows);
+  reference_.assign(kBins, 0);
+  if (r.area() > 0) {
+    integrate(gray, r);
+    histogram(integrals_, cv::Rect(0, 0, r.width, r.height), reference_.data());
+  }
+
+  int n = getParticles();
+  particles_.create(n, 4, CV_64F);
+  for (int i = 0; i < n; i++) {
+    double * p = particles_.ptr<double>(i);
+    p[0] = rect.x + rect.width / 2;
+    p[1] = rect.y + rect.height / 2;
+    p[2] = rect.width;
+    p[3] = rect.height;
+  }
+  weights_ = cv::Mat(n, 1, CV_64F, cv::Scalar(1.0 / n));
+  similarities_ = cv::Mat::ones(n, 1, CV_64F);
+  similarity_ = 1;
+}
+
+void ParticleTracker::reset()
+{
+  particles_.release();
+  integrals_.clear();
+  similarity_ = 0;
+}
+
+bool ParticleTracker::update(const cv::Mat & gray, cv::Rect2d & rect)
+{
+  if (!isInitialized()) {
+    return false;
+  }
+
+  /* diffuse, and find the region covering all particles*/
+  int n = particles_.rows;
+  noise_.create(n, 3, CV_64F);
+  rng_.fill(noise_, cv::RNG::NORMAL, 0, 1);
+  double x0 = gray.cols, y0 = gray.rows, x1 = 0, y1 = 0;
+  for (int i = 0; i < n; i++) {
+    double * p = particles_.ptr<double>(i);
+    const double * z = noise_.ptr<double>(i);
+    p[0] += z[0] * kPositionStd * p[2];
+    p[1] += z[1] * kPositionStd * p[3];
+    double s = std::exp(z[2] * kScaleStd);
+    p[2] = std::max(1.0, p[2] * s);
+    p[3] = std::max(1.0, p[3] * s);
+    x0 = std::min(x0, p[0] - p[2] / 2);
+    y0 = std::min(y0, p[1] - p[3] / 2);
+    x1 = std::max(x1, p[0] + p[2] / 2);
+    y1 = std::max(y1, p[1] + p[3] / 2);
+  }
+  cv::Rect region(cv::Point(cvFloor(x0), cvFloor(y0)), cv::Point(cvCeil(x1), cvCeil(y1)));
+  region &= cv::Rect(0, 0, gray.cols, gray.rows);
+  if (region.area() <= 0) {
+    similarity_ = 0;
+    return false;
+  }
+
+  integrate(gray, region);
+  cv::parallel_for_(cv::Range(0, n),
+    WeightBody(particles_, integrals_, region_, reference_, kLambda, weights_, similarities_));
+
+  cv::minMaxLoc(similarities_, nullptr, &similarity_);
+  double sum = cv::sum(weights_)[0];
+  if (sum <= 0) {
+    return false;
+  }
+  weights_ /= sum;
+
+  /* the roi tracked is the weighted mean of the particles*/
+  cv::Mat mean = weights_.t() * particles_;
+  const double * m = mean.ptr<double>(0);
+  rect = cv::Rect2d(m[0] - m[2] / 2, m[1] - m[3] / 2, m[2], m[3]);
+
+  /* systematic resampling, particles are drawn in proportion to their weights*/
+  resampled_.create(n, 4, CV_64F);
+  double step = 1.0 / n;
+  double target = rng_.uniform(0.0, step);
+  double cumulated = weights_.at<double>(0);
+  int j = 0;
+  for (int i = 0; i < n; i++, target += step) {
+    while (target > cumulated && j < n - 1) {
+      cumulated += weights_.at<double>(++j);
+    }
+    particles_.row(j).copyTo(resampled_.row(i));
+  }
+  cv::swap(particles_, resampled_);
+  weights_.setTo(cv::Scalar(step));
+
+  return similarity_ >= kMinSimilarity;
+}
+
+size_t ParticleTracker::getBytes() const
+{
+  size_t bytes = reference_.size() * sizeof(float);
+  bytes += (particles_.total() + noise_.total() + weights_.total() + similarities_.total() +
+    resampled_.total()) * sizeof(double);
+  for (auto & integral : integrals_) {
+    bytes += integral.total() * integral.elemSize();
+  }
+  return bytes;
+}
+
+void ParticleTracker::integrate(const cv::Mat & gray, const cv::Rect & region)
+{
+  /* intensity to bin*/
+  static const cv::Mat lut = [] {
+      cv::Mat m(1, 256, CV_8U);
+      for (int v = 0; v < 256; v++) {
+        m.at<uchar>(v) = static_cast<uchar>(v * kBins / 256);
+      }
+      return m;
+    }();
+  region_ = region;
+  cv::Mat bins, mask;
+  cv::LUT(gray(region), lut, bins);
+  integrals_.resize(kBins);
+  for (int b = 0; b < kBins; b++) {
+    cv::compare(bins, b, mask, cv::CMP_EQ);
+    cv::integral(mask, integrals_[b], CV_32S);
+  }
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -0,0 +1,269 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "object_analytics_node/tracker/reid_index.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const int ReidIndex::kDims = 64;
+const int ReidIndex::kTables = 4;
+const int ReidIndex::kBits = 10;
+
+namespace
+{
+const int kHueBins = 8;
+const int kSatBins = 3;
+const int kGrayBins = 8;
+/* bins of a half of the roi, chromatic pixels by hue and saturation, others by value*/
+const int kHalfBins = kHueBins * kSatBins + kGrayBins;
+const int kSamples = 32;
+const float kMinSaturation = 0.2f;
+const float kMinValue = 40.f;
+
+int getBin(const uint8_t * bgr)
+{
+  float b = bgr[0], g = bgr[1], r = bgr[2];
+  float v = std::max(r, std::max(g, b));
+  float c = v - std::min(r, std::min(g, b));
+  if (v < kMinValue || c < kMinSaturation * v) {
+    return kHueBins * kSatBins + std::min(kGrayBins - 1, static_cast<int>(v * kGrayBins / 256));
+  }
+  float h;
+  if (v == r) {
+    h = (g - b) / c + (g < b ? 6.f : 0.f);
+  } else if (v == g) {
+    h = (b - r) / c + 2.f;
+  } else {
+    h = (r - g) / c + 4.f;
+  }
+  int hue = std::min(kHueBins - 1, static_cast<int>(h * kHueBins / 6.f));
+  float s = (c / v - kMinSaturation) / (1.f - kMinSaturation);
+  int sat = std::min(kSatBins - 1, static_cast<int>(s * kSatBins));
+  return hue * kSatBins + sat;
+}
+
+void normalize(std::vector<float> & desc)
+{
+  double norm = 0;
+  for (float v : desc) {
+    norm += v * v;
+  }
+  norm = std::sqrt(norm);
+  for (float & v : desc) {
+    v = norm > 0 ? static_cast<float>(v / norm) : 0.f;
+  }
+}
+
+float dot(const std::vector<float> & a, const std::vector<float> & b)
+{
+  float sum = 0;
+  for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+}  // namespace
+
+ReidIndex::ReidIndex(size_t capacity, int64_t max_age, double min_similarity)
+: capacity_(capacity > 1 ? capacity : 1), max_age_(max_age > 0 ? max_age : 0),
+  min_similarity_(min_similarity), planes_(kTables * kBits, kDims, CV_32F), tables_(kTables)
+{
+  /* fixed planes, the same descriptors hash the same in every run*/
+  cv::RNG rng(0x5eed);
+  rng.fill(planes_, cv::RNG::NORMAL, 0., 1.);
+}
+
+void ReidIndex::describe(const cv::Mat & bgr, const cv::Rect2d & rect, std::vector<float> & desc)
+{
+  desc.clear();
+  cv::Rect roi = cv::Rect(rect) & cv::Rect(0, 0, bgr.cols, bgr.rows);
+  if (roi.area() <= 0 || bgr.type() != CV_8UC3) {
+    return;
+  }
+  desc.assign(kDims, 0.f);
+  int cols = std::min(roi.width, kSamples);
+  int rows = std::min(roi.height, kSamples);
+  for (int y = 0; y < rows; y++) {
+    int py = roi.y + (y * roi.height + roi.height / 2) / rows;
+    const uint8_t * line = bgr.ptr<uint8_t>(py);
+    int half = y * 2 < rows ? 0 : kHalfBins;
+    for (int x = 0; x < cols; x++) {
+      int px = roi.x + (x * roi.width + roi.width / 2) / cols;
+      desc[half + getBin(line + 3 * px)] += 1.f;
+    }
+  }
+  /* the square root of the frequencies, so dominant bins do not swamp the rest*/
+  for (float & v : desc) {
+    v = std::sqrt(v);
+  }
+  normalize(desc);
+}
+
+void ReidIndex::blend(std::vector<float> & running, const std::vector<float> & desc, float weight)
+{
+  if (running.size() != desc.size()) {
+    running = desc;
+    return;
+  }
+  for (size_t i = 0; i < running.size(); i++) {
+    running[i] = (1.f - weight) * running[i] + weight * desc[i];
+  }
+  normalize(running);
+}
+
+void ReidIndex::hash(
+  int32_t class_id, const std::vector<float> & desc, std::vector<uint32_t> & keys) const
+{
+  /* descriptors are positive, signs are taken about the uniform descriptor to split them*/
+  const float center = 1.f / std::sqrt(static_cast<float>(kDims));
+  keys.resize(kTables);
+  for (int t = 0; t < kTables; t++) {
+    uint32_t sig = 0;
+    for (int b = 0; b < kBits; b++) {
+      const float * plane = planes_.ptr<float>(t * kBits + b);
+      float side = 0;
+      for (int i = 0; i < kDims; i++) {
+        side += plane[i] * (desc[i] - center);
+      }
+      sig = (sig << 1) | (side > 0 ? 1 : 0);
+    }
+    keys[t] = (static_cast<uint32_t>(class_id) << kBits) | sig;
+  }
+}
+
+void ReidIndex::insert(
+  int64_t id, int32_t class_id, const std::vector<float> & desc, int64_t stamp)
+{
+  if (desc.size() != static_cast<size_t>(kDims)) {
+    return;
+  }
+  expire(stamp);
+  while (size_ >= capacity_) {
+    remove(order_.front().first);
+  }
+  size_t slot = entries_.size();
+  if (!free_.empty()) {
+    slot = free_.back();
+    free_.pop_back();
+  } else {
+    entries_.emplace_back();
+  }
+  Entry & e = entries_[slot];
+  e.id = id;
+  e.class_id = class_id;
+  e.stamp = stamp;
+  e.desc = desc;
+  e.seq = seq_++;
+  e.alive = true;
+  e.visited = 0;
+  hash(class_id, desc, e.keys);
+  for (int t = 0; t < kTables; t++) {
+    tables_[t][e.keys[t]].push_back(slot);
+  }
+  order_.emplace_back(slot, e.seq);
+  size_++;
+  /* entries taken from the middle leave stale places, which only the front sheds*/
+  if (order_.size() > 2 * capacity_) {
+    compact();
+  }
+}
+
+int64_t ReidIndex::take(int32_t class_id, const std::vector<float> & desc, int64_t stamp)
+{
+  expire(stamp);
+  if (size_ == 0 || desc.size() != static_cast<size_t>(kDims)) {
+    return -1;
+  }
+  std::vector<uint32_t> keys;
+  hash(class_id, desc, keys);
+  queries_++;
+  size_t best = entries_.size();
+  float best_score = static_cast<float>(min_similarity_);
+  for (int t = 0; t < kTables; t++) {
+    /* the bucket of the key, then those one plane apart*/
+    for (int b = -1; b < kBits; b++) {
+      uint32_t key = b < 0 ? keys[t] : keys[t] ^ (1u << b);
+      auto bucket = tables_[t].find(key);
+      if (bucket == tables_[t].end()) {
+        continue;
+      }
+      for (size_t slot : bucket->second) {
+        Entry & e = entries_[slot];
+        if (e.visited == queries_) {
+          continue;
+        }
+        e.visited = queries_;
+        float score = dot(e.desc, desc);
+        if (score >= best_score) {
+          best_score = score;
+          best = slot;
+        }
+      }
+    }
+  }
+  if (best == entries_.size()) {
+    return -1;
+  }
+  int64_t id = entries_[best].id;
+  remove(best);
+  return id;
+}
+
+void ReidIndex::remove(size_t slot)
+{
+  Entry & e = entries_[slot];
+  for (int t = 0; t < kTables; t++) {
+    auto bucket = tables_[t].find(e.keys[t]);
+    std::vector<size_t> & slots = bucket->second;
+    slots.erase(std::find(slots.begin(), slots.end(), slot));
+    if (slots.empty()) {
+      tables_[t].erase(bucket);
+    }
+  }
+  e.alive = false;
+  e.desc.clear();
+  free_.push_back(slot);
+  size_--;
+  /* entries taken leave their place in the order, skipped here*/
+  while (!order_.empty() && (!entries_[order_.front().first].alive ||
+    entries_[order_.front().first].seq != order_.front().second))
+  {
+    order_.pop_front();
+  }
+}
+
+void ReidIndex::compact()
+{
+  order_.erase(
+    std::remove_if(
+      order_.begin(), order_.end(), [this](const std::pair<size_t, uint64_t> & place) {
+        const Entry & e = entries_[place.first];
+        return !e.alive || e.seq != place.second;
+      }), order_.end());
+}
+
+void ReidIndex::expire(int64_t stamp)
+{
+  while (max_age_ > 0 && size_ > 0 && stamp - entries_[order_.front().first].stamp > max_age_) {
+    remove(order_.front().first);
+  }
+}
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -0,0 +1,93 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "object_analytics_node/tracker/spatial_grid.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+SpatialGrid::SpatialGrid(double cell_size)
+: cell_size_(cell_size), cell_(cell_size > 0 ? cell_size : 1), count_(0) {}
+
+void SpatialGrid::build(const std::vector<cv::Rect2d> & rects)
+{
+  /* cells of the former frame are dropped, the storage is kept*/
+  entries_.clear();
+  count_ = rects.size();
+
+  if (cell_size_ > 0) {
+    cell_ = cell_size_;
+  } else if (!rects.empty()) {
+    /* a cell about the size of a roi keeps both the number of cells per roi
+     * and the number of rois per cell small*/
+    double sum = 0;
+    for (auto & r : rects) {
+      sum += std::max(r.width, r.height);
+    }
+    cell_ = std::max(sum / rects.size(), 1.0);
+  }
+
+  for (size_t i = 0; i < rects.size(); i++) {
+    int64_t x0, y0, x1, y1;
+    getCells(rects[i], x0, y0, x1, y1);
+    for (int64_t y = y0; y <= y1; y++) {
+      for (int64_t x = x0; x <= x1; x++) {
+        entries_.push_back(std::make_pair(getKey(x, y), i));
+      }
+    }
+  }
+  std::sort(entries_.begin(), entries_.end());
+}
+
+void SpatialGrid::query(const cv::Rect2d & rect, std::vector<size_t> & indices) const
+{
+  indices.clear();
+  if (count_ == 0) {
+    return;
+  }
+
+  int64_t x0, y0, x1, y1;
+  getCells(rect, x0, y0, x1, y1);
+  for (int64_t y = y0; y <= y1; y++) {
+    for (int64_t x = x0; x <= x1; x++) {
+      uint64_t key = getKey(x, y);
+      auto e = std::lower_bound(entries_.begin(), entries_.end(), std::make_pair(key,
+          static_cast<size_t>(0)));
+      for (; e != entries_.end() && e->first == key; ++e) {
+        indices.push_back(e->second);
+      }
+    }
+  }
+
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+void SpatialGrid::getCells(
+  const cv::Rect2d & rect, int64_t & x0, int64_t & y0,
+  int64_t & x1, int64_t & y1) const
+{
+  x0 = static_cast<int64_t>(std::floor(rect.x / cell_));
+  y0 = static_cast<int64_t>(std::floor(rect.y / cell_));
+  x1 = static_cast<int64_t>(std::floor((rect.x + std::max(rect.width, 0.0)) / cell_));
+  y1 = static_cast<int64_t>(std::floor((rect.y + std::max(rect.height, 0.0)) / cell_));
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -0,0 +1,177 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "object_analytics_node/tracker/tracker_pool.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const size_t TrackerPool::kMinRetired = 16;
+
+TrackerPool::TrackerPool(size_t stock)
+: stock_(stock), acquired_(0), hits_(0) {}
+
+void TrackerPool::prewarm(const std::string & algo)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<cv::Ptr<cv::Tracker>> & ready = ready_[algo];
+  while (ready.size() < stock_) {
+    cv::Ptr<cv::Tracker> tracker = create(algo);
+    if (!tracker.get()) {
+      break;
+    }
+    ready.push_back(tracker);
+  }
+}
+
+cv::Ptr<cv::Tracker> TrackerPool::acquire(const std::string & algo)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    acquired_++;
+    std::vector<cv::Ptr<cv::Tracker>> & ready = ready_[algo];
+    if (!ready.empty()) {
+      hits_++;
+      cv::Ptr<cv::Tracker> tracker = ready.back();
+      ready.pop_back();
+      return tracker;
+    }
+  }
+
+  return create(algo);
+}
+
+void TrackerPool::release(const std::string & algo, const cv::Ptr<cv::Tracker> & tracker)
+{
+  if (!tracker.get()) {
+    return;
+  }
+
+  /* an initialized tracker refuses another init, retire it, or let it go with the
+   * caller's reference if replenish() is not called often enough*/
+  (void)algo;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (retired_.size() < std::max(stock_, kMinRetired)) {
+    retired_.push_back(tracker);
+  }
+}
+
+void TrackerPool::replenish()
+{
+  std::vector<cv::Ptr<cv::Tracker>> retired;
+  std::vector<std::string> algos;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    retired.swap(retired_);
+    for (auto & r : ready_) {
+      if (r.second.size() < stock_) {
+        algos.push_back(r.first);
+      }
+    }
+  }
+
+  /* destroy and create out of the lock, acquire() is not blocked meanwhile*/
+  retired.clear();
+  for (auto & algo : algos) {
+    std::vector<cv::Ptr<cv::Tracker>> created;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      created.resize(stock_ > ready_[algo].size() ? stock_ - ready_[algo].size() : 0);
+    }
+    for (auto & t : created) {
+      t = create(algo);
+    }
+    created.erase(std::remove_if(created.begin(), created.end(),
+      [](const cv::Ptr<cv::Tracker> & t) {return t.empty();}), created.end());
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<cv::Ptr<cv::Tracker>> & ready = ready_[algo];
+    ready.insert(ready.end(), created.begin(), created.end());
+  }
+}
+
+void TrackerPool::setStock(size_t stock)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  stock_ = stock;
+}
+
+double TrackerPool::getHitRate()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return acquired_ > 0 ? static_cast<double>(hits_) / acquired_ : 0;
+}
+
+uint64_t TrackerPool::getAcquired()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return acquired_;
+}
+
+size_t TrackerPool::getRetired()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return retired_.size();
+}
+
+size_t TrackerPool::getIdle()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t idle = 0;
+  for (auto & r : ready_) {
+    idle += r.second.size();
+  }
+  return idle;
+}
+
+#if CV_VERSION_MINOR == 2
+cv::Ptr<cv::Tracker> TrackerPool::create(const std::string & name)
+{
+  if (name == "KALMAN" || name == "PARTICLE" || name == "GOTURN_BATCH") {
+    return cv::Ptr<cv::Tracker>();
+  }
+  return cv::Tracker::create(name);
+}
+#else
+cv::Ptr<cv::Tracker> TrackerPool::create(const std::string & name)
+{
+  cv::Ptr<cv::Tracker> tracker;
+
+  if (name == "KCF") {
+    tracker = cv::TrackerKCF::create();
+  } else if (name == "TLD") {
+    tracker = cv::TrackerTLD::create();
+  } else if (name == "BOOSTING") {
+    tracker = cv::TrackerBoosting::create();
+  } else if (name == "MEDIAN_FLOW") {
+    tracker = cv::TrackerMedianFlow::create();
+  } else if (name == "MIL") {
+    tracker = cv::TrackerMIL::create();
+  } else if (name == "GOTURN") {
+    tracker = cv::TrackerGOTURN::create();
+  } else if (name == "KALMAN" || name == "PARTICLE" || name == "GOTURN_BATCH") {
+    /* own trackers of Tracking, see KalmanTracker, ParticleTracker and BatchGoturn*/
+  } else {
+    CV_Error(cv::Error::StsBadArg, "Invalid tracking algorithm name\n");
+  }
+
+  return tracker;
+}
+#endif
+
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -12,101 +12,494 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
 #include <vector>
 #include <utility>
 #include <string>
 #include "object_analytics_node/tracker/tracking.hpp"
+#include "object_analytics_node/tracker/reid_index.hpp"
 
 namespace object_analytics_node
 {
 namespace tracker
 {
 const int32_t Tracking::kAgeingThreshold = 60;
+const int32_t Tracking::kMaxMisses = 30;
+const size_t Tracking::kHistoryCapacity = 30;
+/* a pair of 15x15 examples of the nearest neighbour classifier*/
+const size_t Tracking::kTldLearnedBytes = 2 * 15 * 15;
+const uint32_t Tracking::kMinBudgetUpdates = 10;
+
+Tracking::Lifecycle::Lifecycle()
+: confirm_hits(1), max_age(kAgeingThreshold), max_misses(kMaxMisses)
+{
+}
 
 Tracking::Tracking(
-  int32_t tracking_id, const std::string & name,
+  int64_t tracking_id, const std::string & name,
   const float & probability, const cv::Rect2d & rect)
 : tracker_(cv::Ptr<cv::Tracker>()),
   tracked_rect_(rect),
-  obj_name_(name),
+  class_id_(util::ClassTable::intern(name)),
   probability_(probability),
   tracking_id_(tracking_id),
+  ageing_(0),
   detected_(false),
   detect_mis_(0),
-  algo_("MEDIAN_FLOW") {}
+  hits_(0),
+  state_(kTentative),
+  algo_("MEDIAN_FLOW"),
+  rectify_threshold_(0),
+  update_cost_(0),
+  crop_margin_(0),
+  crop_max_side_(0),
+  level_(0),
+  budget_bytes_(0),
+  budget_cost_(0),
+  model_updates_(0),
+  mean_cost_(0),
+  compactions_(0),
+  has_centroid_(false),
+  restored_(false),
+  hisCor_(kHistoryCapacity) {}
 
 Tracking::~Tracking()
+{
+  releaseTracker();
+
+  clearHistory();
+}
+
+void Tracking::releaseTracker()
 {
   if (tracker_.get()) {
+    if (tracker_pool_) {
+      tracker_pool_->release(active_algo_, tracker_);
+    }
     tracker_.release();
   }
-
-  clearHistory();
+  particle_.reset();
+  batch_target_.patch.release();
 }
 
-void Tracking::rectifyTracker(
+bool Tracking::rectifyTracker(
   const cv::Mat & mat, const cv::Rect2d & t_rect,
   const cv::Rect2d & d_rect,
   builtin_interfaces::msg::Time stamp)
 {
-  if (tracker_.get()) {
-    tracker_.release();
+  FrameContext ctx(mat);
+  return rectifyTracker(ctx, t_rect, d_rect, stamp);
+}
+
+bool Tracking::rectifyTracker(
+  FrameContext & ctx, const cv::Rect2d & t_rect,
+  const cv::Rect2d & d_rect,
+  builtin_interfaces::msg::Time stamp)
+{
+  if (algo_ == "KALMAN") {
+    bool seeded = active_algo_ != algo_;
+    if (seeded) {
+      releaseTracker();
+      kalman_.init(t_rect, rclcpp::Time(stamp).nanoseconds());
+      tracked_rect_ = t_rect;
+      active_algo_ = algo_;
+    } else {
+      tracked_rect_ = kalman_.correct(t_rect, rclcpp::Time(stamp).nanoseconds());
+    }
+    detected_rect_ = d_rect;
+    collectHistory(stamp, tracked_rect_);
+    return seeded;
   }
 
+  cv::Rect2d h_rect;
+  if ((tracker_.get() || particle_.isInitialized() || isBatched()) && active_algo_ == algo_ &&
+    rectify_threshold_ > 0 &&
+    getHisTrackedRect(stamp, h_rect))
+  {
+    double a0 = (h_rect & t_rect).area();
+    double overlap = a0 / (h_rect.area() + t_rect.area() - a0);
+    if (overlap >= rectify_threshold_ && !isOverBudget()) {
+      RCUTILS_LOG_DEBUG("Tracking[%" PRId64 "] agrees with detection(%.2f), keep tracker",
+        tracking_id_, overlap);
+      detected_rect_ = d_rect;
+      return false;
+    }
+    if (overlap >= rectify_threshold_) {
+      /* agrees, but re-seeded from the detection to drop what it learned*/
+      RCUTILS_LOG_DEBUG("Tracking[%" PRId64 "][%s] over its model budget(%zu bytes, %.2fms)",
+        tracking_id_, active_algo_.c_str(), getModelBytes(), mean_cost_);
+      compactions_++;
+    }
+  }
+
+  releaseTracker();
+
   clearHistory();
 
-  tracker_ = createTrackerByAlgo(algo_);
-  tracker_->init(mat, t_rect);
+  seed(ctx, t_rect);
   tracked_rect_ = t_rect;
   detected_rect_ = d_rect;
 
   collectHistory(stamp, t_rect);
+  return true;
+}
+
+void Tracking::seed(FrameContext & ctx, const cv::Rect2d & rect)
+{
+  active_algo_ = algo_;
+  if (algo_ == "PARTICLE") {
+    particle_.init(ctx.getGray(), rect);
+  } else if (algo_ == "GOTURN_BATCH" && batch_ && batch_->isLoaded()) {
+    BatchGoturn::seed(ctx.getBgr(), rect, batch_target_);
+  } else {
+    /* without the network, the network of one object per forward*/
+    active_algo_ = algo_ == "GOTURN_BATCH" ? "GOTURN" : algo_;
+    tracker_ = createTrackerByAlgo(active_algo_);
+    initTracker(ctx, active_algo_, rect);
+  }
+}
+
+TrackingSnapshot::Entry Tracking::getSnapshot(double scale)
+{
+  /* not resumed yet, still in camera pixels*/
+  if (restored_) {
+    scale = 1.0;
+  }
+  auto unscale = [scale](const cv::Rect2d & r) {
+      return cv::Rect2d(r.x / scale, r.y / scale, r.width / scale, r.height / scale);
+    };
+  TrackingSnapshot::Entry e;
+  e.id = tracking_id_;
+  e.name = getObjName();
+  e.probability = probability_;
+  e.tracked = unscale(tracked_rect_);
+  e.detected = unscale(detected_rect_);
+  e.state = state_;
+  e.hits = hits_;
+  e.ageing = ageing_;
+  e.misses = detect_mis_;
+  e.localized = has_centroid_;
+  e.centroid = centroid_;
+  e.history.reserve(hisCor_.size());
+  for (size_t i = 0; i < hisCor_.size(); i++) {
+    e.history.emplace_back(hisCor_.stampAt(i), unscale(hisCor_.valueAt(i)));
+  }
+  return e;
+}
+
+void Tracking::restore(const TrackingSnapshot::Entry & entry)
+{
+  releaseTracker();
+  active_algo_.clear();
+  tracked_rect_ = entry.tracked;
+  detected_rect_ = entry.detected;
+  state_ = static_cast<State>(entry.state);
+  hits_ = entry.hits;
+  ageing_ = entry.ageing;
+  detect_mis_ = entry.misses;
+  has_centroid_ = entry.localized;
+  centroid_ = entry.centroid;
+  clearHistory();
+  for (auto & h : entry.history) {
+    hisCor_.push(h.first, h.second);
+  }
+  restored_ = true;
+}
+
+void Tracking::resume(FrameContext & ctx, builtin_interfaces::msg::Time stamp, double scale)
+{
+  restored_ = false;
+  int64_t ns = rclcpp::Time(stamp).nanoseconds();
+  auto rescale = [scale](const cv::Rect2d & r) {
+      return cv::Rect2d(r.x * scale, r.y * scale, r.width * scale, r.height * scale);
+    };
+  tracked_rect_ = rescale(tracked_rect_);
+  detected_rect_ = rescale(detected_rect_);
+  /* the motion before the restart, shifted to end at this frame*/
+  std::vector<std::pair<int64_t, cv::Rect2d>> history;
+  for (size_t i = 0; i < hisCor_.size(); i++) {
+    history.emplace_back(hisCor_.stampAt(i), rescale(hisCor_.valueAt(i)));
+  }
+  clearHistory();
+  int64_t shift = history.empty() ? 0 : ns - history.back().first;
+  for (auto & h : history) {
+    hisCor_.push(h.first + shift, h.second);
+  }
+  if (hisCor_.empty()) {
+    collectHistory(stamp, tracked_rect_);
+  }
+  if (state_ != kTentative && state_ != kConfirmed) {
+    return;
+  }
+  /* the camera may have changed with the restart*/
+  tracked_rect_ &= cv::Rect2d(cv::Point2d(0, 0), ctx.getSize());
+  if (tracked_rect_.area() <= 0) {
+    lose();
+    return;
+  }
+  if (algo_ == "KALMAN") {
+    kalman_.init(tracked_rect_, ns);
+    active_algo_ = algo_;
+  } else {
+    seed(ctx, tracked_rect_);
+  }
 }
 
 bool Tracking::updateTracker(
   const cv::Mat & mat,
   builtin_interfaces::msg::Time stamp)
 {
-  bool ret = tracker_->update(mat, tracked_rect_);
+  FrameContext ctx(mat);
+  return updateTracker(ctx, stamp);
+}
 
-  if (ret) {collectHistory(stamp, tracked_rect_);}
+bool Tracking::updateTracker(
+  FrameContext & ctx,
+  builtin_interfaces::msg::Time stamp)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  bool ret = true;
+  bool reseeded = false;
+  if (active_algo_ == "KALMAN") {
+    tracked_rect_ = kalman_.predict(rclcpp::Time(stamp).nanoseconds());
+  } else if (particle_.isInitialized()) {
+    ret = particle_.update(ctx.getGray(), tracked_rect_);
+  } else if (isBatched()) {
+    /* a batch of one, TrackingManager::track() batches all objects*/
+    std::vector<char> tracked;
+    ret = batch_->update(ctx.getBgr(), {&batch_target_}, tracked) && tracked[0];
+    if (ret) {
+      tracked_rect_ = batch_target_.rect;
+    }
+  } else if (tracker_.get()) {
+    cv::Rect2d local = toWindow(tracked_rect_);
+    ret = tracker_->update(getWindow(ctx, active_algo_), local);
+    tracked_rect_ = fromWindow(local);
+    /* the part of the roi in the frame left the window, move the window*/
+    cv::Rect2d in_frame = tracked_rect_ & cv::Rect2d(cv::Point2d(0, 0), ctx.getSize());
+    if (ret && window_.area() > 0 && (in_frame & cv::Rect2d(window_)) != in_frame) {
+      releaseTracker();
+      tracker_ = createTrackerByAlgo(active_algo_);
+      initTracker(ctx, active_algo_, tracked_rect_);
+      reseeded = true;
+    }
+  } else {
+    ret = false;
+  }
+  update_cost_ = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+
+  if (ret && !reseeded && tracker_.get()) {
+    model_updates_++;
+    mean_cost_ += (update_cost_ - mean_cost_) / std::min(model_updates_, 10u);
+    if (isOverBudget()) {
+      /* the roi just tracked seeds a tracker without the learned model*/
+      RCUTILS_LOG_DEBUG("Tracking[%" PRId64 "][%s] over its model budget(%zu bytes, %.2fms)",
+        tracking_id_, active_algo_.c_str(), getModelBytes(), mean_cost_);
+      compactions_++;
+      releaseTracker();
+      tracker_ = createTrackerByAlgo(active_algo_);
+      initTracker(ctx, active_algo_, tracked_rect_);
+    }
+  }
 
-  ageing_++;
+  if (ret) {collectHistory(stamp, tracked_rect_);} else {lose();}
+
+  age();
   return ret;
 }
 
+bool Tracking::finishBatch(builtin_interfaces::msg::Time stamp, bool tracked, double cost)
+{
+  update_cost_ = cost;
+  if (tracked) {
+    tracked_rect_ = batch_target_.rect;
+    collectHistory(stamp, tracked_rect_);
+  } else {
+    lose();
+  }
+  age();
+  return tracked;
+}
+
+void Tracking::extrapolate(builtin_interfaces::msg::Time stamp)
+{
+  int64_t ns = rclcpp::Time(stamp).nanoseconds();
+  if (active_algo_ == "KALMAN") {
+    tracked_rect_ = kalman_.predict(ns);
+  } else if (!hisCor_.empty()) {
+    size_t n = hisCor_.size();
+    double dt = (ns - hisCor_.stampAt(n - 1)) / 1e9;
+    cv::Point2d v = getVelocity();
+    tracked_rect_ = hisCor_.valueAt(n - 1);
+    tracked_rect_.x += v.x * dt;
+    tracked_rect_.y += v.y * dt;
+  }
+  collectHistory(stamp, tracked_rect_);
+  age();
+}
+
+void Tracking::age()
+{
+  ageing_++;
+  if (state_ != kLost && lifecycle_.max_age > 0 && ageing_ >= lifecycle_.max_age) {
+    lose();
+  }
+}
+
+void Tracking::lose()
+{
+  if (state_ == kDeleted || state_ == kLost) {
+    return;
+  }
+  state_ = state_ == kTentative ? kDeleted : kLost;
+  /* no image update any more, the tracker is re-seeded if detected again*/
+  releaseTracker();
+}
+
 cv::Rect2d Tracking::getTrackedRect() {return tracked_rect_;}
 
+size_t Tracking::getModelBytes()
+{
+  size_t bytes = sizeof(*this) + hisCor_.capacity() * sizeof(cv::Rect2d);
+  if (!tracker_.empty()) {
+    bytes += static_cast<size_t>(tracked_rect_.area()) * 3 >> (2 * level_);
+    if (active_algo_ == "TLD") {
+      bytes += model_updates_ * kTldLearnedBytes;
+    }
+  }
+  bytes += batch_target_.patch.total() * batch_target_.patch.elemSize();
+  return bytes + particle_.getBytes();
+}
+
+void Tracking::setCropping(double margin, int max_side)
+{
+  crop_margin_ = margin > 0 ? margin : 0;
+  crop_max_side_ = max_side > 0 ? max_side : 0;
+}
+
+void Tracking::setModelBudget(size_t bytes, double update_ms)
+{
+  budget_bytes_ = bytes;
+  budget_cost_ = update_ms > 0 ? update_ms : 0;
+}
+
+bool Tracking::isLearning() const
+{
+  return active_algo_ == "TLD" || active_algo_ == "MIL" || active_algo_ == "BOOSTING";
+}
+
+bool Tracking::isOverBudget()
+{
+  if (tracker_.empty() || !isLearning() || model_updates_ < kMinBudgetUpdates) {
+    return false;
+  }
+  return (budget_bytes_ > 0 && getModelBytes() > budget_bytes_) ||
+         (budget_cost_ > 0 && mean_cost_ > budget_cost_);
+}
+
+void Tracking::initTracker(FrameContext & ctx, const std::string & algo, const cv::Rect2d & rect)
+{
+  model_updates_ = 0;
+  mean_cost_ = 0;
+  level_ = 0;
+  double side = std::max(rect.width, rect.height);
+  while (crop_max_side_ > 0 && level_ + 1 < FrameContext::kInputLevels &&
+    side / (1 << level_) > crop_max_side_)
+  {
+    level_++;
+  }
+  window_ = cv::Rect();
+  if (crop_margin_ > 0) {
+    /* aligned to the pixels of the level*/
+    int scale = 1 << level_;
+    double mx = rect.width * crop_margin_;
+    double my = rect.height * crop_margin_;
+    int x0 = static_cast<int>(std::floor((rect.x - mx) / scale)) * scale;
+    int y0 = static_cast<int>(std::floor((rect.y - my) / scale)) * scale;
+    int x1 = static_cast<int>(std::ceil((rect.x + rect.width + mx) / scale)) * scale;
+    int y1 = static_cast<int>(std::ceil((rect.y + rect.height + my) / scale)) * scale;
+    window_ = cv::Rect(x0, y0, x1 - x0, y1 - y0) & cv::Rect(cv::Point(0, 0), ctx.getSize());
+  }
+  tracker_->init(getWindow(ctx, algo), toWindow(rect));
+}
+
+cv::Mat Tracking::getWindow(FrameContext & ctx, const std::string & algo)
+{
+  const cv::Mat & input = ctx.getInput(algo, level_);
+  if (window_.area() == 0) {
+    return input;
+  }
+  int scale = 1 << level_;
+  cv::Rect r(window_.x / scale, window_.y / scale,
+    (window_.width + scale - 1) / scale, (window_.height + scale - 1) / scale);
+  /* a view of the frame, no copy*/
+  return input(r & cv::Rect(0, 0, input.cols, input.rows));
+}
+
+cv::Rect2d Tracking::toWindow(const cv::Rect2d & rect)
+{
+  double scale = 1 << level_;
+  return cv::Rect2d((rect.x - window_.x) / scale, (rect.y - window_.y) / scale,
+           rect.width / scale, rect.height / scale);
+}
+
+cv::Rect2d Tracking::fromWindow(const cv::Rect2d & rect)
+{
+  double scale = 1 << level_;
+  return cv::Rect2d(rect.x * scale + window_.x, rect.y * scale + window_.y,
+           rect.width * scale, rect.height * scale);
+}
+
 bool Tracking::getHisTrackedRect(
   builtin_interfaces::msg::Time stamp,
   cv::Rect2d & t_rect)
 {
-  std::vector<std::pair<builtin_interfaces::msg::Time, cv::Rect2d>>::iterator
-    iter = hisCor_.begin();
-  while (iter != hisCor_.end()) {
-    if (iter->first == stamp) {
-      t_rect = iter->second;
-      return true;
-    }
-    iter++;
+  const cv::Rect2d * r = hisCor_.find(rclcpp::Time(stamp).nanoseconds());
+  if (r != nullptr) {
+    t_rect = *r;
+    return true;
   }
 
   RCUTILS_LOG_DEBUG("Fail to get trect(%ld)", hisCor_.size());
   return false;
 }
 
-std::string Tracking::getObjName() {return obj_name_;}
+cv::Point2d Tracking::getVelocity()
+{
+  if (active_algo_ == "KALMAN") {
+    return kalman_.getVelocity();
+  }
+
+  size_t n = hisCor_.size();
+  if (n < 2) {
+    return cv::Point2d(0, 0);
+  }
+  double dt = (hisCor_.stampAt(n - 1) - hisCor_.stampAt(n - 2)) / 1e9;
+  const cv::Rect2d & r0 = hisCor_.valueAt(n - 2);
+  const cv::Rect2d & r1 = hisCor_.valueAt(n - 1);
+  return cv::Point2d(
+    ((r1.x + r1.width / 2) - (r0.x + r0.width / 2)) / dt,
+    ((r1.y + r1.height / 2) - (r0.y + r0.height / 2)) / dt);
+}
+
+void Tracking::updateAppearance(const std::vector<float> & desc)
+{
+  /* recent detections weigh more, a pose change fades in over a few frames*/
+  const float kAppearanceWeight = 0.3f;
+  if (!desc.empty()) {
+    ReidIndex::blend(appearance_, desc, kAppearanceWeight);
+  }
+}
 
 float Tracking::getObjProbability() {return probability_;}
 
 cv::Rect2d Tracking::getDetectedRect() {return detected_rect_;}
 
-int32_t Tracking::getTrackingId() {return tracking_id_;}
-
-bool Tracking::isActive()
-{
-  return (ageing_ < kAgeingThreshold) || (detect_mis_ > -30);
-}
+int64_t Tracking::getTrackingId() {return tracking_id_;}
 
 bool Tracking::isDetected() {return detected_;}
 
@@ -121,30 +514,43 @@ void Tracking::setDetected()
   ageing_ = 0;
   detected_ = true;
   detect_mis_ = 0;
+  hits_++;
+  if ((state_ == kTentative && hits_ >= lifecycle_.confirm_hits) || state_ == kLost) {
+    state_ = kConfirmed;
+  }
+}
+
+void Tracking::updateState()
+{
+  if (detected_ || state_ == kDeleted) {
+    return;
+  }
+  if (state_ == kTentative ||
+    (lifecycle_.max_misses > 0 && -detect_mis_ >= lifecycle_.max_misses))
+  {
+    state_ = kDeleted;
+    releaseTracker();
+  }
 }
 
 void Tracking::collectHistory(
   builtin_interfaces::msg::Time stamp,
   cv::Rect2d t_rect)
 {
-  hisCor_.push_back(std::make_pair(stamp, t_rect));
-  if (hisCor_.size() > 30) {hisCor_.erase(hisCor_.begin());}
+  hisCor_.push(rclcpp::Time(stamp).nanoseconds(), t_rect);
 }
 
-void Tracking::clearHistory()
-{
-  std::vector<std::pair<builtin_interfaces::msg::Time, cv::Rect2d>>::iterator
-    iter = hisCor_.begin();
+void Tracking::clearHistory() {hisCor_.clear();}
 
-  while (hisCor_.size() > 0) {iter = hisCor_.erase(iter);}
-}
+void Tracking::setHistoryCapacity(size_t capacity) {hisCor_.setCapacity(capacity);}
 
 std::string Tracking::getAlgo() {return algo_;}
 
 bool Tracking::setAlgo(std::string algo)
 {
   if (algo == "KCF" || algo == "TLD" || algo == "BOOSTING" ||
-    algo == "MEDIAN_FLOW" || algo == "MIL" || algo == "GOTURN")
+    algo == "MEDIAN_FLOW" || algo == "MIL" || algo == "GOTURN" ||
+    algo == "KALMAN" || algo == "PARTICLE" || algo == "GOTURN_BATCH")
   {
     algo_ = algo;
     return true;
@@ -155,53 +561,14 @@ bool Tracking::setAlgo(std::string algo)
 
 bool Tracking::checkTimeZone(builtin_interfaces::msg::Time stamp)
 {
-  std::vector<std::pair<builtin_interfaces::msg::Time, cv::Rect2d>>::iterator
-    iter = hisCor_.begin();
-  while (iter != hisCor_.end()) {
-    if (iter->first == stamp) {return true;}
-
-    if (iter->first.sec < stamp.sec) {
-      return true;
-    } else if (iter->first.sec == stamp.sec) {
-      if (iter->first.nanosec < stamp.nanosec) {
-        return true;
-      }
-    }
-    iter++;
-  }
-
-  return false;
+  /* history is ordered, the oldest entry tells*/
+  return !hisCor_.empty() && hisCor_.stampAt(0) <= rclcpp::Time(stamp).nanoseconds();
 }
 
-#if CV_VERSION_MINOR == 2
 cv::Ptr<cv::Tracker> Tracking::createTrackerByAlgo(std::string name)
 {
-  return cv::Tracker::create(name);
-}
-#else
-cv::Ptr<cv::Tracker> Tracking::createTrackerByAlgo(std::string name)
-{
-  cv::Ptr<cv::Tracker> tracker;
-
-  if (name == "KCF") {
-    tracker = cv::TrackerKCF::create();
-  } else if (name == "TLD") {
-    tracker = cv::TrackerTLD::create();
-  } else if (name == "BOOSTING") {
-    tracker = cv::TrackerBoosting::create();
-  } else if (name == "MEDIAN_FLOW") {
-    tracker = cv::TrackerMedianFlow::create();
-  } else if (name == "MIL") {
-    tracker = cv::TrackerMIL::create();
-  } else if (name == "GOTURN") {
-    tracker = cv::TrackerGOTURN::create();
-  } else {
-    CV_Error(cv::Error::StsBadArg, "Invalid tracking algorithm name\n");
-  }
-
-  return tracker;
+  return tracker_pool_ ? tracker_pool_->acquire(name) : TrackerPool::create(name);
 }
-#endif
 
 }  // namespace tracker
 }  // namespace object_analytics_node
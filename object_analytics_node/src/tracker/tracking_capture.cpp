@@ -0,0 +1,343 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <opencv2/imgcodecs.hpp>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "object_analytics_node/tracker/tracking_capture.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const uint32_t TrackingCapture::kMagic = 0x4354414f;  // "OATC"
+const uint32_t TrackingCapture::kVersion = 1;
+const size_t TrackingCapture::kMaxPendingFrames = 30;
+
+namespace
+{
+/* header of a capture file*/
+struct CaptureHeader
+{
+  uint32_t magic;
+  uint32_t version;
+};
+
+/* header of a record, followed by its payload*/
+struct RecordHeader
+{
+  uint32_t type;
+  uint32_t bytes;
+  int64_t stamp;
+};
+
+template<typename T>
+void put(std::vector<uint8_t> & out, const T & v)
+{
+  size_t at = out.size();
+  out.resize(at + sizeof(T));
+  std::memcpy(out.data() + at, &v, sizeof(T));
+}
+
+void putString(std::vector<uint8_t> & out, const std::string & s)
+{
+  put<uint16_t>(out, static_cast<uint16_t>(s.size()));
+  out.insert(out.end(), s.begin(), s.begin() + static_cast<uint16_t>(s.size()));
+}
+
+/* bounds checked reads of a payload*/
+class Cursor
+{
+public:
+  Cursor(const uint8_t * data, size_t bytes)
+  : data_(data), end_(data + bytes) {}
+
+  template<typename T>
+  T get()
+  {
+    T v;
+    take(&v, sizeof(T));
+    return v;
+  }
+
+  std::string getString()
+  {
+    uint16_t n = get<uint16_t>();
+    std::string s(n, '\0');
+    take(&s[0], n);
+    return s;
+  }
+
+  const uint8_t * data() const {return data_;}
+  size_t left() const {return end_ - data_;}
+
+private:
+  void take(void * v, size_t n)
+  {
+    if (left() < n) {
+      throw std::runtime_error("truncated capture record");
+    }
+    std::memcpy(v, data_, n);
+    data_ += n;
+  }
+
+  const uint8_t * data_;
+  const uint8_t * end_;
+};
+
+void putRoi(std::vector<uint8_t> & out, const sensor_msgs::msg::RegionOfInterest & roi)
+{
+  put<uint32_t>(out, roi.x_offset);
+  put<uint32_t>(out, roi.y_offset);
+  put<uint32_t>(out, roi.width);
+  put<uint32_t>(out, roi.height);
+}
+
+void getRoi(Cursor & in, sensor_msgs::msg::RegionOfInterest & roi)
+{
+  roi.x_offset = in.get<uint32_t>();
+  roi.y_offset = in.get<uint32_t>();
+  roi.width = in.get<uint32_t>();
+  roi.height = in.get<uint32_t>();
+}
+
+builtin_interfaces::msg::Time toTime(int64_t stamp)
+{
+  builtin_interfaces::msg::Time t;
+  t.sec = static_cast<int32_t>(stamp / 1000000000);
+  t.nanosec = static_cast<uint32_t>(stamp % 1000000000);
+  return t;
+}
+}  // namespace
+
+TrackingCapture::TrackingCapture(const std::string & file, const std::string & format)
+: out_(file, std::ios::binary | std::ios::trunc), format_(format)
+{
+  if (!out_) {
+    throw std::runtime_error("cannot open capture file " + file);
+  }
+  CaptureHeader header = {kMagic, kVersion};
+  out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writer_ = std::thread(&TrackingCapture::run, this);
+}
+
+TrackingCapture::~TrackingCapture()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_one();
+  writer_.join();
+  out_.flush();
+}
+
+void TrackingCapture::frame(
+  int64_t stamp, const cv::Mat & image, const std::string & encoding, double scale,
+  const std::shared_ptr<const void> & owner)
+{
+  Pending pending(kFrame, stamp);
+  pending.image = image;
+  pending.text = encoding;
+  pending.scale = scale;
+  pending.owner = owner;
+  push(std::move(pending));
+}
+
+void TrackingCapture::detect(
+  int64_t stamp, const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+  const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc)
+{
+  Pending pending(kDetect, stamp);
+  pending.objs = objs;
+  pending.loc = loc;
+  push(std::move(pending));
+}
+
+void TrackingCapture::algo(const std::string & algo)
+{
+  if (algo == algo_) {
+    return;
+  }
+  algo_ = algo;
+  Pending pending(kAlgo, 0);
+  pending.text = algo;
+  push(std::move(pending));
+}
+
+void TrackingCapture::push(Pending && pending)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending.type == kFrame) {
+      if (queued_frames_ >= kMaxPendingFrames) {
+        dropped_++;
+        return;
+      }
+      queued_frames_++;
+    }
+    queue_.push_back(std::move(pending));
+  }
+  cond_.notify_one();
+}
+
+void TrackingCapture::run()
+{
+  for (;; ) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] {return stop_ || !queue_.empty();});
+    if (queue_.empty()) {
+      return;
+    }
+    Pending pending = std::move(queue_.front());
+    queue_.pop_front();
+    if (pending.type == kFrame) {
+      queued_frames_--;
+    }
+    lock.unlock();
+    write(pending);
+  }
+}
+
+void TrackingCapture::write(const Pending & pending)
+{
+  payload_.clear();
+  switch (pending.type) {
+    case kFrame:
+      if (!cv::imencode(format_, pending.image, encoded_)) {
+        dropped_++;
+        return;
+      }
+      put<double>(payload_, pending.scale);
+      putString(payload_, pending.text);
+      payload_.insert(payload_.end(), encoded_.begin(), encoded_.end());
+      break;
+    case kDetect:
+      put<uint32_t>(payload_, static_cast<uint32_t>(pending.objs->objects_vector.size()));
+      for (auto & obj : pending.objs->objects_vector) {
+        putString(payload_, obj.object.object_name);
+        put<float>(payload_, obj.object.probability);
+        putRoi(payload_, obj.roi);
+      }
+      put<uint8_t>(payload_, pending.loc ? 1 : 0);
+      if (pending.loc) {
+        put<uint32_t>(payload_, static_cast<uint32_t>(pending.loc->objects_in_boxes.size()));
+        for (auto & obj : pending.loc->objects_in_boxes) {
+          putString(payload_, obj.object.object_name);
+          put<float>(payload_, obj.object.probability);
+          putRoi(payload_, obj.roi);
+          put<float>(payload_, obj.min.x);
+          put<float>(payload_, obj.min.y);
+          put<float>(payload_, obj.min.z);
+          put<float>(payload_, obj.max.x);
+          put<float>(payload_, obj.max.y);
+          put<float>(payload_, obj.max.z);
+          put<int64_t>(payload_, obj.id);
+        }
+      }
+      break;
+    case kAlgo:
+      putString(payload_, pending.text);
+      break;
+    default:
+      break;
+  }
+  RecordHeader header = {pending.type, static_cast<uint32_t>(payload_.size()), pending.stamp};
+  out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out_.write(reinterpret_cast<const char *>(payload_.data()), payload_.size());
+  written_++;
+}
+
+CaptureReader::CaptureReader(const std::string & file)
+: in_(file, std::ios::binary)
+{
+  CaptureHeader header;
+  if (!in_.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+    header.magic != TrackingCapture::kMagic || header.version != TrackingCapture::kVersion)
+  {
+    throw std::runtime_error("not a capture file " + file);
+  }
+}
+
+bool CaptureReader::next(Record & record)
+{
+  RecordHeader header;
+  if (!in_.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    return false;
+  }
+  payload_.resize(header.bytes);
+  if (!in_.read(reinterpret_cast<char *>(payload_.data()), header.bytes)) {
+    return false;
+  }
+  record.type = static_cast<TrackingCapture::Type>(header.type);
+  record.stamp = header.stamp;
+  Cursor in(payload_.data(), payload_.size());
+  try {
+    switch (record.type) {
+      case TrackingCapture::kFrame:
+        {
+          record.scale = in.get<double>();
+          record.encoding = in.getString();
+          std::vector<uint8_t> encoded(in.data(), in.data() + in.left());
+          record.image = cv::imdecode(encoded, cv::IMREAD_UNCHANGED);
+          break;
+        }
+      case TrackingCapture::kDetect:
+        {
+          record.objs = std::make_shared<object_msgs::msg::ObjectsInBoxes>();
+          record.objs->header.stamp = toTime(record.stamp);
+          record.objs->objects_vector.resize(in.get<uint32_t>());
+          for (auto & obj : record.objs->objects_vector) {
+            obj.object.object_name = in.getString();
+            obj.object.probability = in.get<float>();
+            getRoi(in, obj.roi);
+          }
+          record.loc.reset();
+          if (in.get<uint8_t>()) {
+            record.loc = std::make_shared<object_analytics_msgs::msg::ObjectsInBoxes3D>();
+            record.loc->header.stamp = record.objs->header.stamp;
+            record.loc->objects_in_boxes.resize(in.get<uint32_t>());
+            for (auto & obj : record.loc->objects_in_boxes) {
+              obj.object.object_name = in.getString();
+              obj.object.probability = in.get<float>();
+              getRoi(in, obj.roi);
+              obj.min.x = in.get<float>();
+              obj.min.y = in.get<float>();
+              obj.min.z = in.get<float>();
+              obj.max.x = in.get<float>();
+              obj.max.y = in.get<float>();
+              obj.max.z = in.get<float>();
+              obj.id = in.get<int64_t>();
+            }
+          }
+          break;
+        }
+      case TrackingCapture::kAlgo:
+        record.algo = in.getString();
+        break;
+      default:
+        break;
+    }
+  } catch (std::runtime_error &) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
@@ -14,11 +14,17 @@
 
 #include "object_analytics_node/tracker/tracking_manager.hpp"
 #include <cv_bridge/cv_bridge.h>
-#include <omp.h>
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
 #include <memory>
 #include <string>
 #include <vector>
 #include "object_analytics_node/model/object_utils.hpp"
+#include "object_analytics_node/tracker/association.hpp"
+#include "object_analytics_node/util/class_table.hpp"
+#include "object_analytics_node/util/stage_stats.hpp"
+#include "object_analytics_node/util/tracepoints.hpp"
 
 using object_analytics_node::model::ObjectUtils;
 
@@ -29,115 +35,405 @@ namespace tracker
 // TrackingManager class implementation
 const float TrackingManager::kMatchThreshold = 0.3;
 const float TrackingManager::kProbabilityThreshold = 0.8;
-int32_t TrackingManager::tracking_cnt = 0;
+std::atomic<int64_t> TrackingManager::tracking_cnt(0);
 const int32_t TrackingManager::kNumOfThread = 4;
 
-TrackingManager::TrackingManager(const rclcpp::Node * node)
-: node_(node)
+TrackingManager::TrackingManager(const rclcpp::Node * node, int32_t num_threads)
+: node_(node),
+  pool_(new util::ThreadPool(num_threads > 1 ? num_threads - 1 : 0)),
+  history_capacity_(Tracking::kHistoryCapacity),
+  rectify_threshold_(0),
+  crop_margin_(0),
+  crop_max_side_(0),
+  particles_(0),
+  scale_(1.0),
+  tracker_pool_(std::make_shared<TrackerPool>()),
+  batch_goturn_(std::make_shared<BatchGoturn>()),
+  model_limit_(0),
+  model_evicted_(0),
+  budget_bytes_(0),
+  budget_ms_(0),
+  model_compacted_(0),
+  depth_gate_(0),
+  depth_gated_(0),
+  occlusion_(0),
+  occluded_(0),
+  reidentified_(0),
+  restored_(false),
+  max_trackings_(0),
+  capped_(0)
 {
   algo_ = "MEDIAN_FLOW";
+  filter_.setMinProbability(kProbabilityThreshold);
 }
 
 void TrackingManager::track(
   const cv::Mat & mat,
   builtin_interfaces::msg::Time stamp)
 {
-  std::vector<std::shared_ptr<Tracking>>::iterator t = trackings_.begin();
+  FrameContext ctx(mat);
+  track(ctx, stamp);
+}
 
-  while (t != trackings_.end()) {
-    if (!(*t)->updateTracker(mat, stamp)) {
-      RCLCPP_WARN(node_->get_logger(), "Tracking[%d][%s] failed, may need remove!",
-        (*t)->getTrackingId(), (*t)->getObjName().c_str());
-      // TBD: Add mechanism to check whether need erase the object.
-      //     t = trackings_.erase(t);
-      ++t;
-    } else {
-      RCLCPP_DEBUG(node_->get_logger(), "Tracking[%d][%s] updated",
-        (*t)->getTrackingId(), (*t)->getObjName().c_str());
-      ++t;
+void TrackingManager::track(
+  FrameContext & ctx,
+  builtin_interfaces::msg::Time stamp)
+{
+  static util::StageStats & stats = util::StageRegistry::get("tracker.track");
+  util::ScopedStageTimer timer(stats);
+  /* the first frame after a restore seeds the trackers restored*/
+  if (resume(ctx, stamp)) {
+    return;
+  }
+  /* preprocess the frame once for all trackings*/
+  prepareContext(ctx);
+
+  /* the calling thread is one of the workers, see util::ThreadPool*/
+  std::vector<char> updated(trackings_.size(), false);
+  std::vector<char> tracked(trackings_.size(), false);
+  std::vector<char> occluded;
+  findOccluded(occluded);
+  pool_->parallelFor(trackings_.size(),
+    [this, &ctx, &stamp, &updated, &tracked, &occluded](size_t i) {
+      Tracking & t = *trackings_[i];
+      /* only live trackings in sight cost an image update*/
+      if (t.getState() == Tracking::kLost || occluded[i]) {
+        t.extrapolate(stamp);
+      } else if (t.isActive()) {
+        tracked[i] = true;
+        if (!t.isBatched()) {
+          updated[i] = t.updateTracker(ctx, stamp);
+        }
+      }
+    });
+
+  /* one forward for all trackings of "GOTURN_BATCH", its cost shared*/
+  std::vector<size_t> batched;
+  std::vector<BatchGoturn::Target *> targets;
+  for (size_t i = 0; i < trackings_.size(); i++) {
+    if (tracked[i] && trackings_[i]->isBatched()) {
+      batched.push_back(i);
+      targets.push_back(trackings_[i]->getBatchTarget());
+    }
+  }
+  if (!batched.empty()) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<char> ok;
+    bool ran = batch_goturn_->update(ctx.getBgr(), targets, ok, pool_.get());
+    double cost = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count() / batched.size();
+    for (size_t k = 0; k < batched.size(); k++) {
+      size_t i = batched[k];
+      updated[i] = trackings_[i]->finishBatch(stamp, ran && ok[k], cost);
+    }
+  }
+
+  /* report in list order, whichever worker finished first*/
+  for (size_t i = 0; i < trackings_.size(); i++) {
+    if (!tracked[i]) {
+      continue;
+    }
+    std::shared_ptr<Tracking> & t = trackings_[i];
+    OA_TRACEPOINT(tracker_update, t->getTrackingId(), t->getActiveAlgo().c_str(),
+      t->getUpdateCost(), updated[i]);
+    OA_TRACEPOINT(tracker_model, t->getTrackingId(), t->getActiveAlgo().c_str(),
+      t->getModelBytes(), t->getMeanUpdateCost(), t->getModelUpdates(), t->getCompactions());
+    if (!updated[i]) {
+      RCLCPP_DEBUG(node_->get_logger(), "Tracking[%" PRId64 "][%s] failed, %s",
+        t->getTrackingId(), t->getObjName().c_str(), t->isActive() ? "lost" : "deleted");
+    }
+    if (scheduler_.isEnabled() && !t->getActiveAlgo().empty()) {
+      scheduler_.observe(t->getActiveAlgo(), t->getUpdateCost());
     }
   }
 }
 
+void TrackingManager::findOccluded(std::vector<char> & occluded)
+{
+  occluded.assign(trackings_.size(), false);
+  if (occlusion_ <= 0 || trackings_.size() < 2) {
+    return;
+  }
+  /* rois of the trackings not live never overlap anything*/
+  std::vector<cv::Rect2d> rects(trackings_.size());
+  for (size_t i = 0; i < trackings_.size(); i++) {
+    Tracking & t = *trackings_[i];
+    if (t.isActive() && t.getState() != Tracking::kLost) {
+      rects[i] = t.getTrackedRect();
+    }
+  }
+  grid_.build(rects);
+
+  std::vector<size_t> nearby;
+  for (size_t i = 0; i < rects.size(); i++) {
+    if (rects[i].area() <= 0) {
+      continue;
+    }
+    grid_.query(rects[i], nearby);
+    for (size_t j : nearby) {
+      if (j <= i || rects[j].area() <= 0) {
+        continue;
+      }
+      double covered = (rects[i] & rects[j]).area() /
+        std::min(rects[i].area(), rects[j].area());
+      if (covered < occlusion_) {
+        continue;
+      }
+      Tracking & a = *trackings_[i];
+      Tracking & b = *trackings_[j];
+      bool a_behind;
+      if (a.hasCentroid() && b.hasCentroid()) {
+        a_behind = cv::norm(a.getCentroid()) > cv::norm(b.getCentroid());
+      } else {
+        a_behind = rects[i].y + rects[i].height < rects[j].y + rects[j].height;
+      }
+      occluded[a_behind ? i : j] = true;
+    }
+  }
+  for (char o : occluded) {
+    occluded_ += o;
+  }
+}
+
+void TrackingManager::extrapolate(builtin_interfaces::msg::Time stamp)
+{
+  for (auto & t : trackings_) {
+    /* left for a frame to resume with*/
+    if (!t->isRestored()) {
+      t->extrapolate(stamp);
+    }
+  }
+}
+
+bool TrackingManager::resume(FrameContext & ctx, builtin_interfaces::msg::Time stamp)
+{
+  if (!restored_) {
+    return false;
+  }
+  restored_ = false;
+  prepareContext(ctx);
+  pool_->parallelFor(trackings_.size(), [this, &ctx, &stamp](size_t i) {
+      if (trackings_[i]->isRestored()) {
+        trackings_[i]->resume(ctx, stamp, scale_);
+      }
+    });
+  RCLCPP_DEBUG(node_->get_logger(), "resumed %zu trackings restored", trackings_.size());
+  return true;
+}
+
+void TrackingManager::setWorkingScale(double scale)
+{
+  scale = scale > 0 ? scale : 1.0;
+  if (scale == scale_) {
+    return;
+  }
+  /* trackers seeded at the former scale are reseeded by resume()*/
+  for (auto & t : trackings_) {
+    if (!t->isRestored()) {
+      t->restore(t->getSnapshot(scale_));
+    }
+  }
+  restored_ = restored_ || !trackings_.empty();
+  scale_ = scale;
+}
+
+void TrackingManager::snapshot(std::vector<TrackingSnapshot::Entry> & entries)
+{
+  entries.clear();
+  entries.reserve(trackings_.size());
+  for (auto & t : trackings_) {
+    if (t->isActive()) {
+      entries.push_back(t->getSnapshot(scale_));
+    }
+  }
+}
+
+size_t TrackingManager::restore(const std::vector<TrackingSnapshot::Entry> & entries)
+{
+  size_t restored = 0;
+  for (auto & e : entries) {
+    if (e.state == Tracking::kDeleted || e.id < 0) {
+      continue;
+    }
+    addTracking(e.name, e.probability, e.tracked, e.id)->restore(e);
+    /* IDs given later never collide with the ones restored*/
+    int64_t next = tracking_cnt.load(std::memory_order_relaxed);
+    while (next <= e.id &&
+      !tracking_cnt.compare_exchange_weak(next, e.id + 1, std::memory_order_relaxed))
+    {
+    }
+    restored++;
+  }
+  restored_ = restored_ || restored > 0;
+  return restored;
+}
+
 void TrackingManager::detect(
   const cv::Mat & mat,
   const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs)
 {
-  uint32_t i;
+  FrameContext ctx(mat);
+  detect(ctx, objs);
+}
+
+void TrackingManager::detect(
+  FrameContext & ctx,
+  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+  const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc)
+{
+  static util::StageStats & stats = util::StageRegistry::get("tracker.detect");
+  util::ScopedStageTimer timer(stats);
+  cv::Size size = ctx.getSize();
   builtin_interfaces::msg::Time stamp = objs->header.stamp;
+  resume(ctx, stamp);
 
   for (auto t : trackings_) {
     t->clearDetected();
   }
 
-  RCLCPP_DEBUG(node_->get_logger(), "****detected objects: %zu",
-    objs->objects_vector.size());
-/* rectify tracking ROIs with detected ROIs*/
-#pragma omp parallel for num_threads(kNumOfThread)
-  for (i = 0; i < objs->objects_vector.size(); i++) {
-    object_msgs::msg::Object dobj = objs->objects_vector[i].object;
-    if (dobj.probability < kProbabilityThreshold) {
+  OA_TRACEPOINT(tracker_detect, rclcpp::Time(stamp).nanoseconds(), objs->objects_vector.size());
+
+  /* collect valid detections*/
+  std::vector<const object_msgs::msg::Object *> dobjs;
+  std::vector<cv::Rect2d> detected_rects, tracked_rects;
+  dobjs.reserve(objs->objects_vector.size());
+  detected_rects.reserve(objs->objects_vector.size());
+  tracked_rects.reserve(objs->objects_vector.size());
+  /* centers of the localized objects, in the order of detections*/
+  std::vector<cv::Point3d> loc_centroids;
+  std::vector<const cv::Point3d *> centroids;
+  if (loc) {
+    loc_centroids.reserve(loc->objects_in_boxes.size());
+  }
+  size_t next_loc = 0;
+  for (auto & obj : objs->objects_vector) {
+    if (!filter_.accept(obj)) {
       continue;
     }
-    std::string n = dobj.object_name;
-    float probability = dobj.probability;
-    sensor_msgs::msg::RegionOfInterest droi = objs->objects_vector[i].roi;
+    /* the segmenter keeps the detected roi and the order of detections*/
+    const cv::Point3d * centroid = nullptr;
+    for (size_t l = next_loc; loc && l < loc->objects_in_boxes.size(); l++) {
+      const object_analytics_msgs::msg::ObjectInBox3D & lobj = loc->objects_in_boxes[l];
+      if (lobj.roi == obj.roi && lobj.object.object_name == obj.object.object_name) {
+        loc_centroids.push_back(cv::Point3d((lobj.min.x + lobj.max.x) / 2.0,
+          (lobj.min.y + lobj.max.y) / 2.0, (lobj.min.z + lobj.max.z) / 2.0));
+        centroid = &loc_centroids.back();
+        next_loc = l + 1;
+        break;
+      }
+    }
+    centroids.push_back(centroid);
+    const object_msgs::msg::Object & dobj = obj.object;
+    sensor_msgs::msg::RegionOfInterest droi = obj.roi;
+    if (scale_ != 1.0) {
+      droi.x_offset = static_cast<uint32_t>(droi.x_offset * scale_);
+      droi.y_offset = static_cast<uint32_t>(droi.y_offset * scale_);
+      droi.width = static_cast<uint32_t>(droi.width * scale_ + 0.5);
+      droi.height = static_cast<uint32_t>(droi.height * scale_ + 0.5);
+    }
     cv::Rect2d detected_rect =
       cv::Rect2d(droi.x_offset, droi.y_offset, droi.width, droi.height);
     /* some trackers do not accept an ROI beyond the size of a Mat*/
-    if (!validateROI(mat, droi)) {
+    if (!validateROI(size, droi)) {
       RCLCPP_WARN(node_->get_logger(),
         "unexptected ROI [%d %d %d %d] against mat size [%d %d]",
         droi.x_offset, droi.y_offset, droi.width, droi.height,
-        mat.cols, mat.rows);
-      droi.x_offset = droi.x_offset >= static_cast<uint32_t>(mat.cols) ?
-        (mat.cols - 1) :
+        size.width, size.height);
+      droi.x_offset = droi.x_offset >= static_cast<uint32_t>(size.width) ?
+        (size.width - 1) :
         droi.x_offset;
-      droi.y_offset = droi.y_offset >= static_cast<uint32_t>(mat.rows) ?
-        (mat.rows - 1) :
+      droi.y_offset = droi.y_offset >= static_cast<uint32_t>(size.height) ?
+        (size.height - 1) :
         droi.y_offset;
-      droi.width = droi.x_offset + droi.width > static_cast<uint32_t>(mat.cols) ?
-        (mat.cols - droi.x_offset) :
+      droi.width = droi.x_offset + droi.width > static_cast<uint32_t>(size.width) ?
+        (size.width - droi.x_offset) :
         droi.width;
       droi.height =
-        droi.y_offset + droi.height > static_cast<uint32_t>(mat.rows) ?
-        (mat.rows - droi.y_offset) :
+        droi.y_offset + droi.height > static_cast<uint32_t>(size.height) ?
+        (size.height - droi.y_offset) :
         droi.height;
     }
-    cv::Rect2d tracked_rect =
-      cv::Rect2d(droi.x_offset, droi.y_offset, droi.width, droi.height);
-    RCLCPP_DEBUG(node_->get_logger(), "detected %s [%d %d %d %d] %.0f%%",
-      n.c_str(), droi.x_offset, droi.y_offset, droi.width,
-      droi.height, dobj.probability * 100);
-    std::shared_ptr<Tracking> t;
-#pragma omp critical
-    {
-      /* get matched tracking with the detected object name (class) and its
-       * ROI*/
-      t = getTracking(n, tracked_rect, probability, stamp);
-      if (t != nullptr) {
-        t->setDetected();
-        /* rectify tracking ROI with detected ROI*/
-        t->rectifyTracker(mat, tracked_rect, detected_rect, stamp);
-      }
+    dobjs.push_back(&dobj);
+    detected_rects.push_back(detected_rect);
+    tracked_rects.push_back(
+      cv::Rect2d(droi.x_offset, droi.y_offset, droi.width, droi.height));
+  }
+
+  /* the most probable detections within the cap*/
+  if (max_trackings_ > 0 && dobjs.size() > max_trackings_) {
+    std::vector<size_t> order(dobjs.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&dobjs](size_t a, size_t b) {
+        return dobjs[a]->probability > dobjs[b]->probability;
+      });
+    order.resize(max_trackings_);
+    std::sort(order.begin(), order.end());
+    for (size_t i = 0; i < order.size(); i++) {
+      dobjs[i] = dobjs[order[i]];
+      detected_rects[i] = detected_rects[order[i]];
+      tracked_rects[i] = tracked_rects[order[i]];
+      centroids[i] = centroids[order[i]];
     }
+    capped_ += dobjs.size() - max_trackings_;
+    dobjs.resize(max_trackings_);
+    detected_rects.resize(max_trackings_);
+    tracked_rects.resize(max_trackings_);
+    centroids.resize(max_trackings_);
   }
 
+  /* associate detections to trackings as a whole*/
+  std::vector<std::shared_ptr<Tracking>> matched =
+    associate(ctx, dobjs, tracked_rects, centroids, stamp);
+
+  /* rectify tracking ROIs with detected ROIs*/
+  for (auto & t : matched) {
+    if (t != nullptr) {
+      t->setDetected();
+    }
+  }
+  scheduleAlgos();
+  prepareContext(ctx);
+  /* converted ahead, the appearances are described by the workers*/
+  const cv::Mat * bgr = reid_ ? &ctx.getBgr() : nullptr;
+  pool_->parallelFor(matched.size(),
+    [&ctx, &matched, &tracked_rects, &detected_rects, &stamp, bgr](size_t i) {
+      if (matched[i] != nullptr) {
+        matched[i]->rectifyTracker(ctx, tracked_rects[i], detected_rects[i], stamp);
+        if (bgr != nullptr) {
+          std::vector<float> desc;
+          ReidIndex::describe(*bgr, tracked_rects[i], desc);
+          matched[i]->updateAppearance(desc);
+        }
+      }
+    });
+
   /* clean up inactive trackings*/
-  cleanTrackings();
+  cleanTrackings(stamp);
 }
 
 int32_t TrackingManager::getTrackedObjs(
   const object_analytics_msgs::msg::TrackedObjects::SharedPtr & objs)
 {
-  for (auto t : trackings_) {
+  return getTrackedObjs(*objs);
+}
+
+int32_t TrackingManager::getTrackedObjs(
+  object_analytics_msgs::msg::TrackedObjects & objs,
+  std::vector<cv::Point2d> * velocities)
+{
+  objs.tracked_objects.reserve(objs.tracked_objects.size() + trackings_.size());
+  for (auto & t : trackings_) {
+    if (t->getState() != Tracking::kConfirmed) {
+      continue;
+    }
     cv::Rect2d r = t->getTrackedRect();
-    if (!t->isDetected()) {
-      RCLCPP_DEBUG(node_->get_logger(), "Not detected %s [%f %f %f %f] %.0f%%",
-        t->getObjName().c_str(), r.x, r.y, r.width, r.height,
-        t->getObjProbability() * 100);
+    if (scale_ != 1.0) {
+      r = cv::Rect2d(r.x / scale_, r.y / scale_, r.width / scale_, r.height / scale_);
     }
-    object_analytics_msgs::msg::TrackedObject tobj;
+    objs.tracked_objects.emplace_back();
+    object_analytics_msgs::msg::TrackedObject & tobj = objs.tracked_objects.back();
     tobj.id = t->getTrackingId();
     tobj.object.object_name = t->getObjName();
     tobj.object.probability = t->getObjProbability();
@@ -145,105 +441,378 @@ int32_t TrackingManager::getTrackedObjs(
     tobj.roi.y_offset = static_cast<int>(r.y);
     tobj.roi.width = static_cast<int>(r.width);
     tobj.roi.height = static_cast<int>(r.height);
-    objs->tracked_objects.push_back(tobj);
-    RCLCPP_DEBUG(node_->get_logger(),
-      "Tracking publish %s [%f %f %f %f] %.0f%%",
-      t->getObjName().c_str(), r.x, r.y, r.width, r.height,
-      t->getObjProbability() * 100);
+    if (velocities != nullptr) {
+      velocities->push_back(t->getVelocity() / scale_);
+    }
+    OA_TRACEPOINT(tracker_publish, tobj.id, t->isDetected(), tobj.roi.x_offset,
+      tobj.roi.y_offset, tobj.roi.width, tobj.roi.height);
   }
 
-  return objs->tracked_objects.size();
+  return objs.tracked_objects.size();
 }
 
 std::shared_ptr<Tracking> TrackingManager::addTracking(
   const std::string & name,
   const float & probability,
-  const cv::Rect2d & rect)
+  const cv::Rect2d & rect,
+  int64_t id)
 {
-  std::shared_ptr<Tracking> t =
-    std::make_shared<Tracking>(tracking_cnt++, name, probability, rect);
-  if (tracking_cnt == -1) {
-    RCLCPP_WARN(node_->get_logger(), "tracking count overflow");
+  /* lock free, only the uniqueness of IDs matters*/
+  if (id < 0) {
+    id = tracking_cnt.fetch_add(1, std::memory_order_relaxed);
   }
-  RCLCPP_DEBUG(node_->get_logger(), "addTracking[%d] +++", t->getTrackingId());
+  std::shared_ptr<Tracking> t =
+    std::make_shared<Tracking>(id, name, probability, rect);
+  RCLCPP_DEBUG(node_->get_logger(), "addTracking[%" PRId64 "] +++", t->getTrackingId());
   t->setAlgo(algo_);
+  t->setHistoryCapacity(history_capacity_);
+  t->setRectifyThreshold(rectify_threshold_);
+  t->setCropping(crop_margin_, crop_max_side_);
+  t->setParticles(particles_);
+  t->setModelBudget(budget_bytes_, budget_ms_);
+  t->setLifecycle(lifecycle_);
+  t->setTrackerPool(tracker_pool_);
+  t->setBatchGoturn(batch_goturn_);
   trackings_.push_back(t);
   return t;
 }
 
-void TrackingManager::cleanTrackings()
+void TrackingManager::cleanTrackings(builtin_interfaces::msg::Time stamp)
 {
-  std::vector<std::shared_ptr<Tracking>>::iterator t = trackings_.begin();
-  while (t != trackings_.end()) {
-    if (!(*t)->isActive()) {
-      RCLCPP_DEBUG(node_->get_logger(), "removeTracking[%d] ---",
-        (*t)->getTrackingId());
-      t = trackings_.erase(t);
+  /* swap and pop, no shifting of the list*/
+  size_t i = 0;
+  while (i < trackings_.size()) {
+    trackings_[i]->updateState();
+    if (!trackings_[i]->isActive()) {
+      RCLCPP_DEBUG(node_->get_logger(), "removeTracking[%" PRId64 "] ---",
+        trackings_[i]->getTrackingId());
+      /* tentative trackings are mostly false detections, not worth keeping*/
+      if (reid_ && trackings_[i]->wasConfirmed() && !trackings_[i]->getAppearance().empty()) {
+        reid_->insert(trackings_[i]->getTrackingId(), trackings_[i]->getClassId(),
+          trackings_[i]->getAppearance(), rclcpp::Time(stamp).nanoseconds());
+      }
+      model_compacted_ += trackings_[i]->getCompactions();
+      std::swap(trackings_[i], trackings_.back());
+      trackings_.pop_back();
     } else {
-      ++t;
+      i++;
     }
   }
+
+  /* the least probable undetected go first, then the least probable*/
+  while (max_trackings_ > 0 && trackings_.size() > max_trackings_) {
+    auto least = std::min_element(trackings_.begin(), trackings_.end(),
+        [](const std::shared_ptr<Tracking> & a, const std::shared_ptr<Tracking> & b) {
+          if (a->isDetected() != b->isDetected()) {
+            return !a->isDetected();
+          }
+          return a->getObjProbability() < b->getObjProbability();
+        });
+    RCLCPP_DEBUG(node_->get_logger(), "capTracking[%" PRId64 "] ---",
+      (*least)->getTrackingId());
+    model_compacted_ += (*least)->getCompactions();
+    std::swap(*least, trackings_.back());
+    trackings_.pop_back();
+    capped_++;
+  }
+
+  if (model_limit_ == 0) {
+    return;
+  }
+  /* the longest undetected goes first, detected ones are kept if possible*/
+  size_t bytes = getModelBytes();
+  while (bytes > model_limit_ && !trackings_.empty()) {
+    auto oldest = std::max_element(trackings_.begin(), trackings_.end(),
+        [](const std::shared_ptr<Tracking> & a, const std::shared_ptr<Tracking> & b) {
+          return a->getAgeing() < b->getAgeing();
+        });
+    RCLCPP_DEBUG(node_->get_logger(), "evictTracking[%" PRId64 "] ---",
+      (*oldest)->getTrackingId());
+    bytes -= (*oldest)->getModelBytes();
+    model_compacted_ += (*oldest)->getCompactions();
+    std::swap(*oldest, trackings_.back());
+    trackings_.pop_back();
+    model_evicted_++;
+  }
 }
 
-/* get matched tracking for each detected object,
+void TrackingManager::setReid(size_t capacity, double max_age, double min_similarity)
+{
+  if (capacity == 0) {
+    reid_.reset();
+    return;
+  }
+  reid_.reset(new ReidIndex(capacity, static_cast<int64_t>(max_age * 1e9), min_similarity));
+}
+
+size_t TrackingManager::getModelBytes()
+{
+  size_t bytes = 0;
+  for (auto & t : trackings_) {
+    bytes += t->getModelBytes();
+  }
+  return bytes;
+}
+
+uint64_t TrackingManager::getModelCompacted()
+{
+  uint64_t compacted = model_compacted_;
+  for (auto & t : trackings_) {
+    compacted += t->getCompactions();
+  }
+  return compacted;
+}
+
+/* associate each detected object with a tracking,
  * with the same object name,
- * and the most matching ROI
+ * and the assignment maximizing the ROI matching over the whole frame
  */
-std::shared_ptr<Tracking> TrackingManager::getTracking(
-  const std::string & obj_name, const cv::Rect2d & rect, float probability,
+std::vector<std::shared_ptr<Tracking>> TrackingManager::associate(
+  FrameContext & ctx,
+  const std::vector<const object_msgs::msg::Object *> & dobjs,
+  const std::vector<cv::Rect2d> & rects,
+  const std::vector<const cv::Point3d *> & centroids,
   builtin_interfaces::msg::Time stamp)
 {
-  double match = 0;
-  int in_timezone = 0;
-  std::shared_ptr<Tracking> tracking = std::shared_ptr<Tracking>();
-
-  /* searching over all trackings*/
-  for (auto t : trackings_) {
-    cv::Rect2d trect;
-    if (!t->checkTimeZone(stamp)) {
+  /* mirror the list into arrays,
+   * trackings with history reaching the detection stamp are candidates*/
+  state_.clear();
+  state_.reserve(trackings_.size());
+  std::vector<size_t> candidates;
+  std::vector<cv::Rect2d> candidate_rects;
+  for (size_t i = 0; i < trackings_.size(); i++) {
+    std::shared_ptr<Tracking> & t = trackings_[i];
+    state_.push(t->getTrackedRect(), t->getClassId(), t->getAgeing(), t->isDetected(),
+      t->hasCentroid() ? &t->getCentroid() : nullptr);
+    if (!t->isActive() || !t->checkTimeZone(stamp)) {
       RCLCPP_DEBUG(node_->get_logger(), "Not match tracker(%s)",
         t->getObjName().c_str());
       continue;
     }
+    candidates.push_back(i);
+    candidate_rects.push_back(state_.rect(i));
+  }
+  bool allow_new = trackings_.empty() || !candidates.empty();
 
-    in_timezone = 1;
-
-    /* seek for the one with the same object name (class), and not yet
-     * rectified*/
-    if (!t->isDetected() && 0 == obj_name.compare(t->getObjName())) {
-      cv::Rect2d trect = t->getTrackedRect();
-      double m = ObjectUtils::getMatch(trect, rect);
-      RCLCPP_DEBUG(node_->get_logger(), "tr[%d] %s [%d %d %d %d]%.2f",
-        t->getTrackingId(), t->getObjName().c_str(), (int)trect.x,
-        (int)trect.y, (int)trect.width, (int)trect.height, m);
-      m = ObjectUtils::getMatch(trect, rect);
-
-      /* seek for the one with the most matching ROI*/
-      if (m > match) {
-        RCLCPP_DEBUG(node_->get_logger(), "Found right tracking(%s)",
-          t->getObjName().c_str());
-        tracking = t;
-        match = m;
+  /* index candidates once per frame, so only nearby trackings are scored*/
+  grid_.build(candidate_rects);
+
+  /* intern names ahead of the parallel scoring, so the workers do not contend
+   * on the lock of the process-wide table*/
+  std::vector<int32_t> classes(dobjs.size());
+  for (size_t d = 0; d < dobjs.size(); d++) {
+    classes[d] = util::ClassTable::intern(dobjs[d]->object_name);
+  }
+
+  /* score nearby pairs, gated by class ID and by depth if both localized*/
+  std::vector<std::vector<Association::Edge>> edges(dobjs.size());
+  std::vector<uint64_t> gated(dobjs.size(), 0);
+  pool_->parallelFor(dobjs.size(),
+    [this, &classes, &rects, &centroids, &candidates, &edges, &gated](size_t d) {
+      std::vector<size_t> nearby;
+      grid_.query(rects[d], nearby);
+      std::vector<cv::Rect2d> tracked;
+      for (auto c : nearby) {
+        size_t i = candidates[c];
+        if (classes[d] != state_.class_id[i]) {
+          continue;
+        }
+        if (depth_gate_ > 0 && centroids[d] != nullptr && state_.localized[i] &&
+          cv::norm(*centroids[d] - state_.centroid[i]) > depth_gate_)
+        {
+          gated[d]++;
+          continue;
+        }
+        Association::Edge e;
+        e.row = d;
+        e.col = c;
+        edges[d].push_back(e);
+        tracked.push_back(state_.rect(i));
+      }
+      /* score the row in one batch*/
+      std::vector<double> scores;
+      ObjectUtils::getMatchBatch(std::vector<cv::Rect2d>(1, rects[d]), tracked, scores);
+      for (size_t k = 0; k < scores.size(); k++) {
+        edges[d][k].score = scores[k];
+      }
+    });
+  std::vector<Association::Edge> all_edges;
+  for (size_t d = 0; d < edges.size(); d++) {
+    all_edges.insert(all_edges.end(), edges[d].begin(), edges[d].end());
+    depth_gated_ += gated[d];
+  }
+  std::vector<int> assignment =
+    Association::solve(dobjs.size(), candidates.size(), all_edges, kMatchThreshold);
+
+  /* matched trackings, or new ones in the order of detections,
+   * re-identified if the appearance of a tracking lost is similar*/
+  std::vector<std::shared_ptr<Tracking>> matched(dobjs.size());
+  for (size_t d = 0; d < dobjs.size(); d++) {
+    if (assignment[d] >= 0) {
+      matched[d] = trackings_[candidates[assignment[d]]];
+    } else if (allow_new) {
+      int64_t id = -1;
+      if (reid_ && reid_->size() > 0) {
+        std::vector<float> desc;
+        ReidIndex::describe(ctx.getBgr(), rects[d], desc);
+        id = reid_->take(classes[d], desc, rclcpp::Time(stamp).nanoseconds());
+        if (id >= 0) {
+          RCLCPP_DEBUG(node_->get_logger(), "reidentifyTracking[%" PRId64 "]", id);
+          reidentified_++;
+        }
       }
+      matched[d] = addTracking(dobjs[d]->object_name, dobjs[d]->probability, rects[d], id);
+    }
+    if (matched[d] != nullptr && centroids[d] != nullptr) {
+      matched[d]->setCentroid(*centroids[d]);
     }
+    OA_TRACEPOINT(tracker_associate, matched[d] ? matched[d]->getTrackingId() : -1,
+      dobjs[d]->object_name.c_str(), static_cast<int32_t>(rects[d].x),
+      static_cast<int32_t>(rects[d].y), static_cast<int32_t>(rects[d].width),
+      static_cast<int32_t>(rects[d].height));
   }
-  /* if matching above the threshold, return the tracking*/
-  if (match > TrackingManager::kMatchThreshold) {
-    return tracking;
-  } else if (trackings_.size() == 0 || in_timezone > 0) {
-    return addTracking(obj_name, probability, rect);
-  } else {
-    return std::shared_ptr<Tracking>();
+  return matched;
+}
+
+void TrackingManager::prepareContext(FrameContext & ctx)
+{
+  std::vector<std::string> algos(1, algo_);
+  for (auto & t : trackings_) {
+    /* the scheduled algorithm takes over at the next re-seed*/
+    std::string names[] = {t->getAlgo(), t->getActiveAlgo()};
+    for (auto & name : names) {
+      if (!name.empty() && std::find(algos.begin(), algos.end(), name) == algos.end()) {
+        algos.push_back(name);
+      }
+    }
+  }
+  ctx.prepare(algos);
+}
+
+bool TrackingManager::setThreadPolicy(const util::ThreadPolicy & policy)
+{
+  std::string error;
+  if (!pool_->setPolicy(policy, error)) {
+    RCLCPP_WARN(node_->get_logger(), "tracker workers not pinned, %s", error.c_str());
+    return false;
+  }
+  return true;
+}
+
+void TrackingManager::warmup(const cv::Size & size)
+{
+  /* textured, so that trackers find features to follow*/
+  cv::Mat mat(size, CV_8UC3);
+  cv::randu(mat, cv::Scalar::all(0), cv::Scalar::all(255));
+  FrameContext ctx(mat);
+  std::vector<std::string> algos(1, algo_);
+  if (scheduler_.isEnabled()) {
+    for (auto & algo : scheduler_.getAlgos()) {
+      if (std::find(algos.begin(), algos.end(), algo) == algos.end()) {
+        algos.push_back(algo);
+      }
+    }
+  }
+  ctx.prepare(algos);
+
+  cv::Rect2d rect(size.width / 4.0, size.height / 4.0, size.width / 4.0, size.height / 4.0);
+  for (auto & algo : algos) {
+    /* one per worker, each thread touches its own buffers*/
+    std::vector<std::shared_ptr<Tracking>> warm(pool_->getNumOfThread() + 1);
+    for (auto & t : warm) {
+      t = std::make_shared<Tracking>(-1, "", 1.0f, rect);
+      t->setAlgo(algo);
+      t->setCropping(crop_margin_, crop_max_side_);
+      t->setParticles(particles_);
+      t->setTrackerPool(tracker_pool_);
+      t->setBatchGoturn(batch_goturn_);
+    }
+    builtin_interfaces::msg::Time stamp;
+    pool_->parallelFor(warm.size(), [&warm, &ctx, &rect, &stamp](size_t i) {
+        warm[i]->rectifyTracker(ctx, rect, rect, stamp);
+      });
+    /* the second update runs at steady state*/
+    for (uint32_t k = 1; k <= 2; k++) {
+      stamp.nanosec = k * 33000000;
+      pool_->parallelFor(warm.size(), [&warm, &ctx, &stamp](size_t i) {
+          warm[i]->updateTracker(ctx, stamp);
+        });
+    }
+    RCLCPP_DEBUG(node_->get_logger(), "warm-up %s update %.2fms", algo.c_str(),
+      warm[0]->getUpdateCost());
+    if (scheduler_.isEnabled()) {
+      scheduler_.observe(algo, warm[0]->getUpdateCost());
+    }
+  }
+
+  /* the warm-up trackers are retired, fresh ones take their place*/
+  tracker_pool_->replenish();
+  for (auto & algo : algos) {
+    tracker_pool_->prewarm(algo);
+  }
+}
+
+bool TrackingManager::setBatchModel(
+  const std::string & prototxt, const std::string & weights,
+  const std::string & device)
+{
+  std::string error;
+  if (!batch_goturn_->load(prototxt, weights, device, error)) {
+    RCLCPP_WARN(node_->get_logger(), "GOTURN_BATCH not loaded, tracked as GOTURN: %s",
+      error.c_str());
+    return false;
+  }
+  RCLCPP_INFO(node_->get_logger(), "GOTURN_BATCH loaded %s on %s", weights.c_str(),
+    device.c_str());
+  return true;
+}
+
+void TrackingManager::setTrackerPoolSize(size_t size)
+{
+  tracker_pool_->setStock(size);
+  tracker_pool_->prewarm(algo_);
+}
+
+void TrackingManager::replenish()
+{
+  tracker_pool_->replenish();
+  RCLCPP_DEBUG(node_->get_logger(), "tracker pool hit rate %.0f%% of %" PRIu64,
+    tracker_pool_->getHitRate() * 100, tracker_pool_->getAcquired());
+}
+
+void TrackingManager::setTrackingBudget(double budget_ms)
+{
+  /* the calling thread updates trackers as well*/
+  scheduler_.setBudget(budget_ms, static_cast<int32_t>(pool_->getNumOfThread() + 1));
+}
+
+void TrackingManager::scheduleAlgos()
+{
+  if (!scheduler_.isEnabled()) {
+    return;
+  }
+  std::vector<cv::Rect2d> rects;
+  rects.reserve(trackings_.size());
+  for (auto & t : trackings_) {
+    rects.push_back(t->getTrackedRect());
+  }
+  std::vector<std::string> algos = scheduler_.schedule(rects);
+  for (size_t i = 0; i < trackings_.size(); i++) {
+    if (algos[i] != trackings_[i]->getAlgo()) {
+      RCLCPP_DEBUG(node_->get_logger(), "Tracking[%" PRId64 "] scheduled %s -> %s",
+        trackings_[i]->getTrackingId(), trackings_[i]->getAlgo().c_str(), algos[i].c_str());
+      trackings_[i]->setAlgo(algos[i]);
+    }
   }
 }
 
 bool TrackingManager::validateROI(
-  const cv::Mat & mat, const sensor_msgs::msg::RegionOfInterest & droi)
+  const cv::Size & size, const sensor_msgs::msg::RegionOfInterest & droi)
 {
-  return droi.x_offset < static_cast<uint32_t>(mat.cols) &&
-         droi.y_offset < static_cast<uint32_t>(mat.rows) &&
-         (droi.x_offset + droi.width) <= static_cast<uint32_t>(mat.cols) &&
-         (droi.y_offset + droi.height) <= static_cast<uint32_t>(mat.rows);
+  return droi.x_offset < static_cast<uint32_t>(size.width) &&
+         droi.y_offset < static_cast<uint32_t>(size.height) &&
+         (droi.x_offset + droi.width) <= static_cast<uint32_t>(size.width) &&
+         (droi.y_offset + droi.height) <= static_cast<uint32_t>(size.height);
 }
 
 }  // namespace tracker
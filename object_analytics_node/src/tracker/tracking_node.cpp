@@ -14,209 +14,235 @@
 
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
-#include <std_msgs/msg/header.hpp>
-#include <cv_bridge/cv_bridge.h>
 #include <memory>
 #include <string>
 #include <vector>
-#include "object_analytics_node/const.hpp"
 #include "object_analytics_node/tracker/tracking_node.hpp"
+#include "object_analytics_node/util/qos_profiles.hpp"
+#include "object_analytics_node/util/thread_policy.hpp"
 
 namespace object_analytics_node
 {
 namespace tracker
 {
 // TrackingNode class implementation
-using SubscribeImg = message_filters::Subscriber<sensor_msgs::msg::Image>;
-using SubscribeObjs =
-  message_filters::Subscriber<object_msgs::msg::ObjectsInBoxes>;
-using Synchronizer =
-  message_filters::TimeSynchronizer<object_msgs::msg::ObjectsInBoxes,
-    sensor_msgs::msg::Image>;
-
-TrackingNode::TrackingNode(rclcpp::NodeOptions options)
-: Node("TrackingNode", options)
-{
-  auto rgb_callback =
-    [this](const typename sensor_msgs::msg::Image::SharedPtr image) -> void {
-      this->rgb_cb(image);
-    };
-  sub_rgb_ = create_subscription<sensor_msgs::msg::Image>(Const::kTopicRgb,
-      rgb_callback);
-
-  auto obj_callback =
-    [this](const typename object_msgs::msg::ObjectsInBoxes::SharedPtr objs)
-    -> void {this->obj_cb(objs);};
-  sub_obj_ = create_subscription<object_msgs::msg::ObjectsInBoxes>(
-    Const::kTopicDetection, obj_callback);
-
-  pub_tracking_ = create_publisher<object_analytics_msgs::msg::TrackedObjects>(
-    Const::kTopicTracking);
-  tm_ = std::make_unique<TrackingManager>(this);
-  last_detection_ = builtin_interfaces::msg::Time();
-  this_detection_ = builtin_interfaces::msg::Time();
-  last_obj_ = nullptr;
-  this_obj_ = nullptr;
-
-  kRgbQueueSize = 20;
-  rgbs_.reserve(kRgbQueueSize);
-  tracks_.reserve(kRgbQueueSize);
-}
-
-void TrackingNode::rgb_cb(const sensor_msgs::msg::Image::ConstSharedPtr & img)
+TrackingStream::Options TrackingNode::declareOptions(rclcpp::Node * node)
 {
-  RCUTILS_LOG_DEBUG(
-    "received rgb frame frame_id(%s), stamp(sec(%ld),nsec(%ld)), "
-    "q_size(%d)!\n",
-    img->header.frame_id.c_str(), img->header.stamp.sec,
-    img->header.stamp.nanosec, rgbs_.size());
-
-  if (this_detection_ != last_detection_) {
-    cv::Mat mat_cv = cv_bridge::toCvShare(img, "bgr8")->image;
-    if (this_detection_ == img->header.stamp) {
-      RCLCPP_DEBUG(get_logger(), "rectify in rgb_cb!");
-      tm_->detect(mat_cv, this_obj_);
-    } else {
-      tm_->track(mat_cv, img->header.stamp);
-    }
-    tracking_publish(img->header);
+  TrackingStream::Options opts;
+  opts.num_threads = node->declare_parameter<int32_t>("tracking_threads", opts.num_threads);
+  int32_t history = node->declare_parameter<int32_t>("tracking_history",
+      static_cast<int32_t>(opts.history_capacity));
+  if (history < 1) {
+    RCLCPP_WARN(node->get_logger(), "tracking_history %d less than 1, using 1", history);
+    history = 1;
   }
-
-  rgbs_.push_back(img);
-
-  if (kRgbQueueSize < rgbs_.size()) {rgbs_.erase(rgbs_.begin());}
+  opts.history_capacity = static_cast<size_t>(history);
+  opts.rectify_threshold = node->declare_parameter<double>("rectify_threshold",
+      opts.rectify_threshold);
+  opts.tracker_pool_size = node->declare_parameter<int32_t>("tracker_pool_size",
+      static_cast<int32_t>(opts.tracker_pool_size));
+  opts.budget_ms = node->declare_parameter<double>("tracking_budget_ms", opts.budget_ms);
+  opts.crop_margin = node->declare_parameter<double>("crop_margin", opts.crop_margin);
+  opts.crop_max_side = node->declare_parameter<int32_t>("crop_max_side", opts.crop_max_side);
+  opts.working_width = node->declare_parameter<int32_t>("working_width", opts.working_width);
+  opts.particles = node->declare_parameter<int32_t>("particles", opts.particles);
+  opts.filter.setMinProbability(node->declare_parameter<double>("min_probability",
+    opts.filter.getMinProbability()));
+  int32_t min_area = node->declare_parameter<int32_t>("min_roi_area", 0);
+  opts.filter.setMinArea(min_area > 0 ? min_area : 0);
+  opts.lifecycle.confirm_hits = node->declare_parameter<int32_t>("confirm_hits",
+      opts.lifecycle.confirm_hits);
+  opts.lifecycle.max_age = node->declare_parameter<int32_t>("max_age", opts.lifecycle.max_age);
+  opts.lifecycle.max_misses = node->declare_parameter<int32_t>("max_misses",
+      opts.lifecycle.max_misses);
+  opts.filter.setClasses(node->declare_parameter<std::vector<std::string>>("object_classes",
+    std::vector<std::string>()));
+
+  std::string policy_name = node->declare_parameter<std::string>("overload_policy", "none");
+  OverloadGate::Policy policy;
+  if (!OverloadGate::parse(policy_name, policy)) {
+    RCLCPP_WARN(node->get_logger(), "unknown overload_policy %s, using none",
+      policy_name.c_str());
+    policy = OverloadGate::kNone;
+  }
+  double latency_target_ms = node->declare_parameter<double>("latency_target_ms", 100.0);
+  int32_t interval = node->declare_parameter<int32_t>("overload_interval", 2);
+  if (interval < 1) {
+    RCLCPP_WARN(node->get_logger(), "overload_interval %d less than 1, using 2", interval);
+    interval = 2;
+  }
+  int32_t max_skip = node->declare_parameter<int32_t>("overload_max_skip", 5);
+  if (max_skip < 1) {
+    RCLCPP_WARN(node->get_logger(), "overload_max_skip %d less than 1, using 5", max_skip);
+    max_skip = 5;
+  }
+  opts.gate = OverloadGate(policy, latency_target_ms, static_cast<uint32_t>(interval),
+      static_cast<uint32_t>(max_skip));
+
+  /* deep enough to cover the latency of detection*/
+  int32_t queue_size = node->declare_parameter<int32_t>("rgb_queue_size",
+      static_cast<int32_t>(opts.queue_size));
+  if (queue_size > 0) {
+    opts.queue_size = queue_size;
+  }
+  opts.catch_up = node->declare_parameter<bool>("catch_up", opts.catch_up);
+  opts.motion_compensate = node->declare_parameter<bool>("motion_compensate",
+      opts.motion_compensate);
+  opts.check_rectify = node->declare_parameter<bool>("check_rectify", opts.check_rectify);
+  opts.frame_trace = node->declare_parameter<bool>("frame_trace", opts.frame_trace);
+  /* hard limits evict the oldest data instead of growing without bound*/
+  int32_t rgb_cache_mb = node->declare_parameter<int32_t>("rgb_cache_mb", 0);
+  opts.rgb_cache_bytes = static_cast<size_t>(rgb_cache_mb > 0 ? rgb_cache_mb : 0) << 20;
+  int32_t model_mb = node->declare_parameter<int32_t>("tracker_model_mb", 0);
+  opts.model_bytes = static_cast<size_t>(model_mb > 0 ? model_mb : 0) << 20;
+  /* online-learning trackers are re-seeded instead of growing with their age*/
+  int32_t tracker_kb = node->declare_parameter<int32_t>("tracker_budget_kb", 0);
+  opts.tracker_bytes = static_cast<size_t>(tracker_kb > 0 ? tracker_kb : 0) << 10;
+  opts.tracker_update_ms = node->declare_parameter<double>("tracker_budget_ms",
+      opts.tracker_update_ms);
+
+  /* frames are buffered by the stream, one late frame need not queue in the middleware*/
+  opts.rgb_qos = util::QosProfiles::declare(node, "rgb", util::QosProfiles::kSensor);
+  opts.detection_qos = util::QosProfiles::declare(node, "detection",
+      util::QosProfiles::kReliable);
+  opts.tracking_qos = util::QosProfiles::declare(node, "tracking", util::QosProfiles::kReliable);
+  opts.depth_gate = node->declare_parameter<double>("depth_gate_m", opts.depth_gate);
+  opts.occlusion = node->declare_parameter<double>("occlusion_overlap", opts.occlusion);
+  opts.reid_capacity = node->declare_parameter<int32_t>("reid_capacity",
+      static_cast<int32_t>(opts.reid_capacity));
+  opts.reid_max_age = node->declare_parameter<double>("reid_max_age_s", opts.reid_max_age);
+  opts.reid_similarity = node->declare_parameter<double>("reid_min_similarity",
+      opts.reid_similarity);
+  opts.coalesce = node->declare_parameter<bool>("coalesce_detections", opts.coalesce);
+  opts.warmup = node->declare_parameter<bool>("warmup", opts.warmup);
+  opts.localization_qos = util::QosProfiles::declare(node, "localization",
+      util::QosProfiles::kReliable);
+  opts.capture_file = node->declare_parameter<std::string>("capture_file", opts.capture_file);
+  opts.capture_format = node->declare_parameter<std::string>("capture_format",
+      opts.capture_format);
+  /* the executor thread calling the manager is pinned by the process, see composition*/
+  opts.worker_policy = util::ThreadPolicy::declare(node, "tracking");
+  opts.async_rectify = node->declare_parameter<bool>("async_rectify", opts.async_rectify);
+  opts.goturn_batch_model = node->declare_parameter<std::string>("goturn_batch_model",
+      opts.goturn_batch_model);
+  opts.goturn_batch_device = node->declare_parameter<std::string>("goturn_batch_device",
+      opts.goturn_batch_device);
+  opts.snapshot_file = node->declare_parameter<std::string>("snapshot_file", opts.snapshot_file);
+  opts.snapshot_interval = node->declare_parameter<double>("snapshot_interval",
+      opts.snapshot_interval);
+  opts.snapshot_max_age = node->declare_parameter<double>("snapshot_max_age",
+      opts.snapshot_max_age);
+  return opts;
 }
 
-bool operator<(
-  const builtin_interfaces::msg::Time & left,
-  const builtin_interfaces::msg::Time & right)
+int32_t TrackingNode::getStreamThreads(int32_t threads, size_t streams, size_t index)
 {
-  if (left.sec < right.sec) {
-    return true;
-  }
-  if (left.sec == right.sec && left.nanosec < right.nanosec) {
-    return true;
+  int32_t count = static_cast<int32_t>(streams);
+  if (threads <= count) {
+    return 1;
   }
-  return false;
+  /* the remainder goes to the first streams*/
+  return threads / count + (static_cast<int32_t>(index) < threads % count ? 1 : 0);
 }
 
-void TrackingNode::obj_cb(
-  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs)
+TrackingNode::TrackingNode(rclcpp::NodeOptions options)
+: Node("TrackingNode", options)
 {
-  last_detection_ = this_detection_;
-  this_detection_ = objs->header.stamp;
-  last_obj_ = this_obj_;
-  this_obj_ = objs;
+  TrackingStream::Options opts = declareOptions(this);
 
-  if (objs->objects_vector.size() == 0) {return;}
-
-  RCUTILS_LOG_DEBUG(
-    "received obj detection frame_id(%s), stamp(sec(%ld),nsec(%ld)), "
-    "img_buff_count(%d)!\n",
-    objs->header.frame_id.c_str(), objs->header.stamp.sec,
-    objs->header.stamp.nanosec, rgbs_.size());
-  std::vector<sensor_msgs::msg::Image::ConstSharedPtr>::iterator rgb =
-    rgbs_.begin();
-  while (rgb != rgbs_.end()) {
-    RCUTILS_LOG_DEBUG("iterate queue buffer stamp(sec(%ld),nsec(%ld))!\n",
-      (*rgb)->header.stamp.sec, (*rgb)->header.stamp.nanosec);
-    if ((*rgb)->header.stamp < this_detection_) {
-      RCLCPP_DEBUG(get_logger(), "slower, dropped");
-      rgb = rgbs_.erase(rgb);
-      continue;
-    }
-    cv::Mat mat_cv = cv_bridge::toCvShare(*rgb, "bgr8")->image;
-    if ((*rgb)->header.stamp == this_detection_) {
-      // TBD: Need consider to check whether worth to perform rectify.
+  std::vector<std::string> names =
+    declare_parameter<std::vector<std::string>>("streams", std::vector<std::string>());
+  if (names.empty()) {
+    names.push_back("");
+  }
+  /* the streams run in parallel, their workers add up to tracking_threads*/
+  for (size_t i = 0; i < names.size(); i++) {
+    TrackingStream::Options stream_opts = opts;
+    stream_opts.num_threads = getStreamThreads(opts.num_threads, names.size(), i);
+    RCLCPP_INFO(get_logger(), "tracking stream [%s], %d threads", names[i].c_str(),
+      stream_opts.num_threads);
+    streams_.push_back(std::make_unique<TrackingStream>(this, names[i], stream_opts));
+  }
 
-      RCUTILS_LOG_DEBUG("rectify frame_id(%s), stamp(sec(%ld),nsec(%ld))\n",
-        objs->header.frame_id.c_str(), objs->header.stamp.sec,
-        objs->header.stamp.nanosec);
-      tm_->detect(mat_cv, this_obj_);
-      break;
-    }
+  int32_t width_level = declare_parameter<int32_t>("degrade_width_level", 2);
+  int32_t degraded_width = declare_parameter<int32_t>("degraded_working_width", 320);
+  int32_t cap_level = declare_parameter<int32_t>("degrade_cap_level", 3);
+  int32_t degraded_max = declare_parameter<int32_t>("degraded_max_trackings", 10);
+  if (width_level > 0 || cap_level > 0) {
+    int32_t full_width = opts.working_width;
+    quality_.reset(new util::QualityListener(this,
+      [this, width_level, degraded_width, cap_level, degraded_max, full_width](int32_t level) {
+        bool narrow = width_level > 0 && level >= width_level;
+        bool capped = cap_level > 0 && level >= cap_level && degraded_max > 0;
+        for (auto & s : streams_) {
+          s->setWorkingWidth(narrow ? degraded_width : full_width);
+          s->setMaxTrackings(capped ? degraded_max : 0);
+        }
+      }));
+  }
 
-    rgb++;
+  if (declare_parameter<bool>("publish_stats", true)) {
+    auto fill = [this](object_analytics_msgs::msg::PipelineStats & msg) {
+        for (auto & s : streams_) {
+          std::string prefix = "tracker." + (s->getName().empty() ? "" : s->getName() + ".");
+          msg.queue_names.push_back(prefix + "rgb_queue");
+          msg.queue_depths.push_back(s->getQueueDepth());
+          msg.queue_names.push_back(prefix + "trackings");
+          msg.queue_depths.push_back(s->getTrackingCount());
+          msg.queue_names.push_back(prefix + "tracker_pool");
+          msg.queue_depths.push_back(s->getPoolIdle());
+          msg.drop_names.push_back(prefix + "frames_skipped");
+          msg.drops.push_back(s->getSkippedFrames());
+          msg.drop_names.push_back(prefix + "rgb_evicted");
+          msg.drops.push_back(s->getRgbEvicted());
+          msg.drop_names.push_back(prefix + "trackings_evicted");
+          msg.drops.push_back(s->getModelEvicted());
+          msg.drop_names.push_back(prefix + "trackers_compacted");
+          msg.drops.push_back(s->getModelCompacted());
+          msg.drop_names.push_back(prefix + "localization_missed");
+          msg.drops.push_back(s->getLocalizationMissed());
+          msg.drop_names.push_back(prefix + "depth_gated");
+          msg.drops.push_back(s->getDepthGated());
+          msg.drop_names.push_back(prefix + "updates_occluded");
+          msg.drops.push_back(s->getOccluded());
+          msg.drop_names.push_back(prefix + "trackings_reidentified");
+          msg.drops.push_back(s->getReidentified());
+          msg.drop_names.push_back(prefix + "detections_capped");
+          msg.drops.push_back(s->getCapped());
+          msg.drop_names.push_back(prefix + "detections_coalesced");
+          msg.drops.push_back(s->getCoalesced());
+          msg.drop_names.push_back(prefix + "detections_compensated");
+          msg.drops.push_back(s->getCompensated());
+          msg.drop_names.push_back(prefix + "capture_dropped");
+          msg.drops.push_back(s->getCaptureDropped());
+          msg.drop_names.push_back(prefix + "frames_rectifying");
+          msg.drops.push_back(s->getRectifyingFrames());
+          msg.drop_names.push_back(prefix + "rectify_superseded");
+          msg.drops.push_back(s->getRectifySuperseded());
+          msg.drop_names.push_back(prefix + "snapshot_failed");
+          msg.drops.push_back(s->getSnapshotFailed());
+          s->getRgbMemory().collect(msg);
+          s->getModelMemory().collect(msg);
+        }
+      };
+    stats_.reset(new util::StatsPublisher(this, "tracker.", fill));
   }
 }
 
-void TrackingNode::tracking_publish(const std_msgs::msg::Header & header)
+void TrackingNode::setAlgo(std::string algo)
 {
-  object_analytics_msgs::msg::TrackedObjects::SharedPtr msg =
-    std::make_shared<object_analytics_msgs::msg::TrackedObjects>();
-  msg->header = header;
-
-  tracks_.push_back(msg);
-  if (kRgbQueueSize < tracks_.size()) {tracks_.erase(tracks_.begin());}
-
-  if (tm_->getTrackedObjs(msg) > 0) {
-    pub_tracking_->publish(msg);
-  } else {
-    RCUTILS_LOG_WARN("No objects to publish!");
+  for (auto & s : streams_) {
+    s->setAlgo(algo);
   }
 }
 
-bool TrackingNode::check_rectify(
-  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs)
+uint64_t TrackingNode::getSkippedFrames()
 {
-  builtin_interfaces::msg::Time detect_frame = objs->header.stamp;
-  bool res = true;
-
-  std::vector<object_analytics_msgs::msg::TrackedObjects::SharedPtr>::iterator
-    track = tracks_.begin();
-  while (track != tracks_.end()) {
-    if ((*track)->header.stamp < detect_frame) {
-      track = tracks_.erase(track);
-      continue;
-    }
-    if ((*track)->header.stamp == detect_frame) {
-      // Compare each objects box in tracking and detection,
-      // 1. if new object appear, break to rectify,
-      // 2. if object in track not overlay 70% area with detection, break to
-      // rectify,
-      // 3. other cases escape from rectify.
-      for (uint32_t i = 0; i < objs->objects_vector.size(); i++) {
-        object_msgs::msg::Object dobj = objs->objects_vector[i].object;
-
-        // TBD: Need check object probability
-        float probability = dobj.probability;
-
-        std::string n = dobj.object_name;
-        sensor_msgs::msg::RegionOfInterest droi = objs->objects_vector[i].roi;
-        cv::Rect2d detected_rect =
-          cv::Rect2d(droi.x_offset, droi.y_offset, droi.width, droi.height);
-        auto tobj = (*track)->tracked_objects.begin();
-
-        for (; tobj != (*track)->tracked_objects.end(); tobj++) {
-          if (n == tobj->object.object_name) {
-            cv::Rect2d tracked_rect =
-              cv::Rect2d(tobj->roi.x_offset, tobj->roi.y_offset,
-                tobj->roi.width, tobj->roi.height);
-            double intersectArea = (tracked_rect & detected_rect).area();
-            double unionArea = (tracked_rect | detected_rect).area();
-            double precision = unionArea / intersectArea;
-            if (precision > 0.7 && probability < 0.8) {
-              RCUTILS_LOG_DEBUG("Tracked correct, no need to rectify!!!!\n");
-            } else {
-              return res;
-            }
-            break;
-          }
-        }
-
-        if (tobj == (*track)->tracked_objects.end()) {return res;}
-      }
-      break;
-    }
-
-    track++;
-  }
-
-  if (track != tracks_.end()) {
-    res = false;
+  uint64_t skipped = 0;
+  for (auto & s : streams_) {
+    skipped += s->getSkippedFrames();
   }
-
-  return res;
+  return skipped;
 }
 
 }  // namespace tracker
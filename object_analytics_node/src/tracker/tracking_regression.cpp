@@ -16,15 +16,25 @@
 #include <std_msgs/msg/header.hpp>
 #include <cv_bridge/cv_bridge.h>
 #include <class_loader/class_loader.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "object_analytics_node/const.hpp"
 #include "object_analytics_node/dataset/track_dataset.hpp"
+#include "object_analytics_node/tracker/mot_evaluator.hpp"
+#include "object_analytics_node/tracker/tracking_manager.hpp"
 #include "object_analytics_node/tracker/tracking_node.hpp"
 
 #include "rcutils/cmdline_parser.h"
@@ -76,8 +86,46 @@ void show_usage()
   RCUTILS_LOG_INFO(
     "-p dataset_path : Specify the tracking datasets location.\n");
   RCUTILS_LOG_INFO(
-    "-t dataset_type : Specify the dataset type: video,image.\n");
+    "-t dataset_type : Specify the dataset type: video,image,mt_image,packed.\n");
+  RCUTILS_LOG_INFO(
+    "   mt_image is multi target, evaluated by MOTA/MOTP/IDF1, --headless only.\n");
+  RCUTILS_LOG_INFO(
+    "   packed reads a file written by --pack, given as the dataset_path.\n");
   RCUTILS_LOG_INFO("-n dataset_name : Specify the dataset name.\n");
+  RCUTILS_LOG_INFO(
+    "--headless : Feed frames to the tracker directly as fast as possible,\n");
+  RCUTILS_LOG_INFO(
+    "   -a accepts a comma separated list of algorithms then.\n");
+  RCUTILS_LOG_INFO(
+    "   -n accepts a comma separated list of datasets, or all, then.\n");
+  RCUTILS_LOG_INFO(
+    "-j jobs : Number of headless runs in parallel, default 1.\n");
+  RCUTILS_LOG_INFO(
+    "-k frames : Number of image frames decoded ahead, default 0 to decode on demand.\n");
+  RCUTILS_LOG_INFO(
+    "-o report_file : Write the headless report, .json for JSON else CSV.\n");
+  RCUTILS_LOG_INFO(
+    "--pack pack_file : Convert the datasets of -n, or all, into a packed file and exit.\n");
+  RCUTILS_LOG_INFO(
+    "--intervals list : Headless detection intervals in frames, comma separated, default 4.\n");
+  RCUTILS_LOG_INFO(
+    "--delays list : Headless detection delays in frames, comma separated, default 0.\n");
+}
+
+/** @brief Positive integers of a comma separated list, or the default if none.*/
+static std::vector<int> parse_ints(const std::string & list, int min, int def)
+{
+  std::vector<int> ints;
+  std::stringstream ss(list);
+  for (std::string v; std::getline(ss, v, ',');) {
+    if (!v.empty()) {
+      ints.push_back(std::max(min, std::atoi(v.c_str())));
+    }
+  }
+  if (ints.empty()) {
+    ints.push_back(def);
+  }
+  return ints;
 }
 
 class Streamer_node : public rclcpp::Node
@@ -143,7 +191,7 @@ public:
           obj.object.object_name = "test_traj";
           obj.object.probability = 95;
 
-          cv::Rect2d roi = ds_->getIdxGT(frameId);
+          cv::Rect2d roi = ds_->getIdxRoi(frameId);
           obj.roi.x_offset = roi.x;
           obj.roi.y_offset = roi.y;
           obj.roi.width = roi.width;
@@ -194,9 +242,10 @@ public:
 
   void initialDataset(
     std::string path, datasets::dsType type,
-    std::string dsName)
+    std::string dsName, size_t prefetch)
   {
     ds_ = ds_->create(type);
+    ds_->setPrefetch(prefetch);
     ds_->load(path);
     ds_->initDataset(dsName);
     cv::namedWindow(window, cv::WINDOW_AUTOSIZE);
@@ -207,7 +256,7 @@ public:
   void draw(cv::Mat frame)
   {
     frame.copyTo(image_);
-    rectangle(image_, ds_->getIdxGT(ds_->getFrameIdx()), gtColor, 2,
+    rectangle(image_, ds_->getIdxRoi(ds_->getFrameIdx()), gtColor, 2,
       cv::LINE_8);
     imshow(window, image_);
     cv::waitKey(1);
@@ -268,7 +317,7 @@ void Streamer_node::track_cb(
   }
 
   for (auto t : objs->tracked_objects) {
-    cv::Rect2d gt_roi = ds_->getIdxGT(frame_id);
+    cv::Rect2d gt_roi = ds_->getIdxRoi(frame_id);
     cv::Rect2d obj_roi(t.roi.x_offset, t.roi.y_offset, t.roi.width,
       t.roi.height);
 
@@ -297,6 +346,252 @@ void Streamer_node::track_cb(
   }
 }
 
+/** @brief Cost and accuracy of one algorithm run headless over a dataset.*/
+struct HeadlessReport
+{
+  std::string algo;
+  std::string dataset;
+  int interval = 4;
+  int delay = 0;
+  int frames = 0;
+  int responses = 0;
+  int corr = 0;
+  int corr_thd = 0;
+  double total_ms = 0.;
+  double cpu_ms = 0.;
+  double p50_ms = 0.;
+  double p95_ms = 0.;
+  double p99_ms = 0.;
+  /* multi target accuracy, of mt_image datasets only*/
+  bool multi = false;
+  object_analytics_node::tracker::MotEvaluator::Summary mot;
+};
+
+/** @brief Nearest rank percentile of the sorted latencies.*/
+static double percentile(const std::vector<double> & sorted, double p)
+{
+  if (sorted.empty()) {return 0.;}
+  size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/** @brief Detections simulated by a headless run.*/
+struct Cadence
+{
+  int interval = 4;  /**< A detection every interval frames.*/
+  int delay = 0;     /**< Frames a detection arrives after its frame.*/
+};
+
+/** @brief CPU time of a clock in milliseconds.*/
+static double cpu_ms(clockid_t clock)
+{
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/** @brief Detections of a frame, its ground truth or the detections of multi target datasets.*/
+static object_msgs::msg::ObjectsInBoxes::SharedPtr simulate_detection(
+  const cv::Ptr<datasets::trDataset> & ds, datasets::imgMTDataset * mt, int frame_id)
+{
+  auto boxes = std::make_shared<object_msgs::msg::ObjectsInBoxes>();
+  object_msgs::msg::ObjectInBox obj;
+  obj.object.object_name = "test_traj";
+  obj.object.probability = 95;
+  if (mt != nullptr) {
+    /* boxes of the frames of the sequence are 1 based*/
+    for (auto & d : mt->getIdxDet(frame_id + 1)) {
+      obj.object.probability = d.confidence;
+      obj.roi.x_offset = std::max(0., d.bb.x);
+      obj.roi.y_offset = std::max(0., d.bb.y);
+      obj.roi.width = d.bb.width;
+      obj.roi.height = d.bb.height;
+      boxes->objects_vector.push_back(obj);
+    }
+  } else {
+    cv::Rect2d gt_roi = ds->getIdxRoi(frame_id);
+    obj.roi.x_offset = gt_roi.x;
+    obj.roi.y_offset = gt_roi.y;
+    obj.roi.width = gt_roi.width;
+    obj.roi.height = gt_roi.height;
+    boxes->objects_vector.push_back(obj);
+  }
+  builtin_interfaces::msg::Time stamp;
+  stamp.nanosec = frame_id;
+  boxes->header.frame_id = std::to_string(frame_id);
+  boxes->header.stamp = stamp;
+  return boxes;
+}
+
+/**
+ * @brief Feed all frames of a dataset to a TrackingManager, no ROS transport.
+ *
+ * A frame every cadence.interval is rectified with its ground truth as the
+ * detection, like the detections simulated by Streamer_node, the others are
+ * tracked. A detection delayed arrives cadence.delay frames later, it is
+ * rectified on its buffered frame and the frames since are tracked again,
+ * as TrackingStream catches up with a late detection. Latency of each frame
+ * is the wall time spent in the manager, replays included.
+ *
+ * The dataset is loaded already, and is owned by the run till it returns. Runs
+ * on different datasets objects are independent, each with its own manager.
+ *
+ * Multi target datasets feed their own detections instead, and all targets of
+ * the ground truth are evaluated by @ref MotEvaluator.
+ */
+static HeadlessReport run_headless(
+  const rclcpp::Node * node, const std::string & algo,
+  const cv::Ptr<datasets::trDataset> & ds, const std::string & name,
+  int32_t num_threads, const Cadence & cadence, clockid_t cpu_clock)
+{
+  HeadlessReport report;
+  report.algo = algo;
+  report.dataset = name;
+  report.interval = cadence.interval;
+  report.delay = cadence.delay;
+
+  if (!ds->initDataset(name)) {
+    RCUTILS_LOG_ERROR("failed to init dataset %s\n", name.c_str());
+    return report;
+  }
+
+  object_analytics_node::tracker::TrackingManager tm(node, num_threads);
+  tm.setAlgo(algo);
+  datasets::imgMTDataset * mt = dynamic_cast<datasets::imgMTDataset *>(ds.get());
+  object_analytics_node::tracker::MotEvaluator mot;
+  report.multi = mt != nullptr;
+
+  std::vector<double> latencies;
+  /* frames since the oldest detection not arrived yet, shared, not copied*/
+  std::deque<cv::Mat> recent;
+  double cpu_start = cpu_ms(cpu_clock);
+  object_analytics_msgs::msg::TrackedObjects objs;
+  while (true) {
+    /* a new image each frame, the buffered ones are not overwritten*/
+    cv::Mat frame;
+    if (!ds->getNextFrame(frame)) {
+      break;
+    }
+    int frame_id = ds->getFrameIdx() - 1;
+    recent.push_back(frame);
+    if (static_cast<int>(recent.size()) > cadence.delay + 1) {
+      recent.pop_front();
+    }
+    cv::Rect2d gt_roi = ds->getIdxRoi(frame_id);
+
+    auto start = std::chrono::steady_clock::now();
+    int detected = frame_id - cadence.delay;
+    if (detected >= 0 && (detected % cadence.interval) == 0) {
+      tm.detect(recent.front(), simulate_detection(ds, mt, detected));
+      for (size_t i = 1; i < recent.size(); i++) {
+        builtin_interfaces::msg::Time stamp;
+        stamp.nanosec = detected + i;
+        tm.track(recent[i], stamp);
+      }
+    } else {
+      builtin_interfaces::msg::Time stamp;
+      stamp.nanosec = frame_id;
+      tm.track(frame, stamp);
+    }
+    objs.tracked_objects.clear();
+    tm.getTrackedObjs(objs);
+    std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+    latencies.push_back(elapsed.count());
+    report.total_ms += elapsed.count();
+    report.frames++;
+
+    if (objs.tracked_objects.size() > 0) {
+      report.responses++;
+    }
+    if (mt != nullptr) {
+      std::vector<object_analytics_node::tracker::MotEvaluator::Box> targets, hypotheses;
+      for (auto & g : mt->getIdxGT(frame_id + 1)) {
+        targets.push_back({g.objIdx, g.bb});
+      }
+      for (auto & t : objs.tracked_objects) {
+        hypotheses.push_back({t.id, cv::Rect2d(t.roi.x_offset, t.roi.y_offset, t.roi.width,
+          t.roi.height)});
+      }
+      mot.addFrame(targets, hypotheses);
+      continue;
+    }
+    for (auto & t : objs.tracked_objects) {
+      cv::Rect2d obj_roi(t.roi.x_offset, t.roi.y_offset, t.roi.width,
+        t.roi.height);
+      double intersectArea = (gt_roi & obj_roi).area();
+      double unionArea = (gt_roi | obj_roi).area();
+      double overlap = unionArea > 0. ? intersectArea / unionArea : 0.;
+      report.corr += overlap > 0. ? 1 : 0;
+      report.corr_thd += overlap > 0.7 ? 1 : 0;
+    }
+  }
+  report.cpu_ms = cpu_ms(cpu_clock) - cpu_start;
+
+  report.mot = mot.getSummary();
+  std::sort(latencies.begin(), latencies.end());
+  report.p50_ms = percentile(latencies, 0.50);
+  report.p95_ms = percentile(latencies, 0.95);
+  report.p99_ms = percentile(latencies, 0.99);
+  return report;
+}
+
+/** @brief Write the reports as CSV, or as JSON if the file ends with .json.*/
+static void write_reports(
+  const std::vector<HeadlessReport> & reports, const std::string & file)
+{
+  std::ofstream of;
+  bool to_file = !file.empty();
+  if (to_file) {
+    of.open(file);
+    if (!of.is_open()) {
+      RCUTILS_LOG_ERROR("failed to open %s\n", file.c_str());
+      to_file = false;
+    }
+  }
+  std::ostream & os = to_file ? of : std::cout;
+  bool json = file.size() > 5 && file.compare(file.size() - 5, 5, ".json") == 0;
+
+  os << std::fixed << std::setprecision(3);
+  if (json) {
+    os << "[\n";
+  } else {
+    os << "algo,dataset,interval,delay,frames,fps,cpu_ms,p50_ms,p95_ms,p99_ms,overlap_count,"
+      "overlap_thd_count,precision,recall,mota,motp,idf1,id_switches\n";
+  }
+  for (size_t i = 0; i < reports.size(); i++) {
+    const HeadlessReport & r = reports[i];
+    double fps = r.total_ms > 0. ? r.frames * 1000. / r.total_ms : 0.;
+    double precision = r.responses > 0 ?
+      static_cast<double>(r.corr_thd) / r.responses : 0.;
+    double recall = r.frames > 0 ? static_cast<double>(r.corr_thd) / r.frames : 0.;
+    if (json) {
+      os << "  {\"algo\": \"" << r.algo << "\", \"dataset\": \"" << r.dataset <<
+        "\", \"interval\": " << r.interval << ", \"delay\": " << r.delay <<
+        ", \"frames\": " << r.frames <<
+        ", \"fps\": " << fps << ", \"cpu_ms\": " << r.cpu_ms << ", \"p50_ms\": " << r.p50_ms <<
+        ", \"p95_ms\": " << r.p95_ms << ", \"p99_ms\": " << r.p99_ms <<
+        ", \"overlap_count\": " << r.corr << ", \"overlap_thd_count\": " <<
+        r.corr_thd << ", \"precision\": " << precision << ", \"recall\": " <<
+        recall;
+      if (r.multi) {
+        os << ", \"mota\": " << r.mot.mota << ", \"motp\": " << r.mot.motp <<
+          ", \"idf1\": " << r.mot.idf1 << ", \"id_switches\": " << r.mot.id_switches;
+      }
+      os << "}" << (i + 1 < reports.size() ? "," : "") << "\n";
+    } else {
+      os << r.algo << "," << r.dataset << "," << r.interval << "," << r.delay << "," <<
+        r.frames << "," << fps << "," << r.cpu_ms << "," << r.p50_ms << "," <<
+        r.p95_ms << "," << r.p99_ms << "," << r.corr << "," << r.corr_thd <<
+        "," << precision << "," << recall << "," << r.mot.mota << "," << r.mot.motp << "," <<
+        r.mot.idf1 << "," << r.mot.id_switches << "\n";
+    }
+  }
+  if (json) {
+    os << "]\n";
+  }
+}
+
 int main(int argc, char * argv[])
 {
   // Force flush of the stdout buffer.
@@ -307,7 +602,7 @@ int main(int argc, char * argv[])
   // Parse the command line options.
   std::string dsPath, dsName, dType;
   datasets::dsType dsTpy = datasets::dsInvalid;
-  std::string algo;
+  std::string algo, report;
 
   if (rcutils_cli_option_exist(argv, argv + argc, "-h")) {
     show_usage();
@@ -328,6 +623,10 @@ int main(int argc, char * argv[])
       dsTpy = datasets::dsImage;
     } else if (dType == "video") {
       dsTpy = datasets::dsVideo;
+    } else if (dType == "mt_image") {
+      dsTpy = datasets::dsMTImage;
+    } else if (dType == "packed") {
+      dsTpy = datasets::dsPacked;
     } else {
       return 0;
     }
@@ -337,6 +636,38 @@ int main(int argc, char * argv[])
     dsName = rcutils_cli_get_option(argv, argv + argc, "-n");
   }
 
+  if (rcutils_cli_option_exist(argv, argv + argc, "-o")) {
+    report = rcutils_cli_get_option(argv, argv + argc, "-o");
+  }
+
+  int jobs = 1;
+  if (rcutils_cli_option_exist(argv, argv + argc, "-j")) {
+    jobs = std::max(1, std::atoi(rcutils_cli_get_option(argv, argv + argc, "-j")));
+  }
+
+  size_t prefetch = 0;
+  if (rcutils_cli_option_exist(argv, argv + argc, "-k")) {
+    prefetch = std::max(0, std::atoi(rcutils_cli_get_option(argv, argv + argc, "-k")));
+  }
+
+  if (rcutils_cli_option_exist(argv, argv + argc, "--pack")) {
+    /* packed once, regressed many times without decoding*/
+    std::string pack = rcutils_cli_get_option(argv, argv + argc, "--pack");
+    cv::Ptr<datasets::trDataset> ds;
+    ds = ds->create(dsTpy);
+    if (ds.empty() || dsPath == "" || pack == "") {
+      show_usage();
+      return 0;
+    }
+    ds->load(dsPath);
+    std::vector<std::string> names;
+    std::stringstream ns(dsName == "all" ? "" : dsName);
+    for (std::string n; std::getline(ns, n, ',');) {
+      names.push_back(n);
+    }
+    return datasets::packDataset::write(*ds, names, pack) ? 0 : 1;
+  }
+
   if (dsPath == "" || dsName == "" || dType == "") {
     RCUTILS_LOG_DEBUG("Please specfic below options:\n");
     show_usage();
@@ -346,10 +677,101 @@ int main(int argc, char * argv[])
   // library.
   rclcpp::init(argc, argv);
 
+  if (rcutils_cli_option_exist(argv, argv + argc, "--headless")) {
+    /* the node is only needed for logging of the managers*/
+    auto node = std::make_shared<rclcpp::Node>("tracker_regression");
+    std::vector<std::string> algos;
+    std::stringstream ss(algo.empty() ? "MEDIAN_FLOW" : algo);
+    for (std::string a; std::getline(ss, a, ',');) {
+      algos.push_back(a);
+    }
+    /* the list is parsed once per job, a job runs one dataset at a time*/
+    std::vector<cv::Ptr<datasets::trDataset>> loaded(jobs);
+    loaded[0] = loaded[0]->create(dsTpy);
+    loaded[0]->setPrefetch(prefetch);
+    loaded[0]->load(dsPath);
+    std::vector<std::string> names;
+    if (dsName == "all") {
+      for (int i = 1; i <= loaded[0]->getDatasetsNum(); i++) {
+        names.push_back(loaded[0]->getDatasetName(i));
+      }
+    } else {
+      std::stringstream ns(dsName);
+      for (std::string n; std::getline(ns, n, ',');) {
+        names.push_back(n);
+      }
+    }
+    std::vector<int> intervals = parse_ints(
+      rcutils_cli_option_exist(argv, argv + argc, "--intervals") ?
+      rcutils_cli_get_option(argv, argv + argc, "--intervals") : "", 1, 4);
+    std::vector<int> delays = parse_ints(
+      rcutils_cli_option_exist(argv, argv + argc, "--delays") ?
+      rcutils_cli_get_option(argv, argv + argc, "--delays") : "", 0, 0);
+    /* every algorithm on every dataset at every detection cadence*/
+    struct Run
+    {
+      std::string algo;
+      std::string name;
+      Cadence cadence;
+    };
+    std::vector<Run> runs;
+    for (auto & a : algos) {
+      for (auto & n : names) {
+        for (auto k : intervals) {
+          for (auto d : delays) {
+            Cadence c;
+            c.interval = k;
+            c.delay = d;
+            runs.push_back({a, n, c});
+          }
+        }
+      }
+    }
+
+    /* parallel runs share the cores, each manager updates its trackers inline*/
+    int32_t num_threads = jobs > 1 ? 1 :
+      object_analytics_node::tracker::TrackingStream::Options().num_threads;
+    if (jobs > 1) {
+      cv::setNumThreads(1);
+    }
+    /* a serial run owns the process, parallel ones are only charged their own thread*/
+    clockid_t cpu_clock = jobs > 1 ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID;
+    std::vector<HeadlessReport> reports(runs.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(jobs)
+#endif
+    for (int i = 0; i < static_cast<int>(runs.size()); i++) {
+#ifdef _OPENMP
+      cv::Ptr<datasets::trDataset> & ds = loaded[omp_get_thread_num()];
+#else
+      cv::Ptr<datasets::trDataset> & ds = loaded[0];
+#endif
+      if (ds.empty()) {
+        ds = ds->create(dsTpy);
+        ds->setPrefetch(prefetch);
+        ds->load(dsPath);
+      }
+      RCUTILS_LOG_INFO("headless run of %s on %s, interval %d delay %d\n",
+        runs[i].algo.c_str(), runs[i].name.c_str(), runs[i].cadence.interval,
+        runs[i].cadence.delay);
+      reports[i] = run_headless(node.get(), runs[i].algo, ds, runs[i].name, num_threads,
+        runs[i].cadence, cpu_clock);
+    }
+    write_reports(reports, report);
+    rclcpp::shutdown();
+    return 0;
+  }
+
+  if (dsTpy == datasets::dsMTImage) {
+    RCUTILS_LOG_ERROR("mt_image datasets are evaluated with --headless only\n");
+    rclcpp::shutdown();
+    return 0;
+  }
+
   rclcpp::executors::SingleThreadedExecutor exec;
 
   auto t_node = std::make_shared<Streamer_node>();
-  t_node->initialDataset(dsPath, dsTpy, dsName);
+  t_node->initialDataset(dsPath, dsTpy, dsName, prefetch);
 
   exec.add_node(t_node);
 
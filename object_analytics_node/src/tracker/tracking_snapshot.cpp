@@ -0,0 +1,153 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "object_analytics_node/tracker/tracking_snapshot.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const uint32_t TrackingSnapshot::kMagic = 0x5354414f;  // "OATS"
+const uint32_t TrackingSnapshot::kVersion = 1;
+const uint32_t TrackingSnapshot::kMaxEntries = 65536;
+
+namespace
+{
+/* header of a snapshot file*/
+struct SnapshotHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  int64_t stamp;
+  uint32_t count;
+};
+
+template<typename T>
+void put(std::ofstream & out, const T & v)
+{
+  out.write(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+template<typename T>
+bool get(std::ifstream & in, T & v)
+{
+  return static_cast<bool>(in.read(reinterpret_cast<char *>(&v), sizeof(T)));
+}
+
+void putRect(std::ofstream & out, const cv::Rect2d & r)
+{
+  double v[4] = {r.x, r.y, r.width, r.height};
+  put(out, v);
+}
+
+bool getRect(std::ifstream & in, cv::Rect2d & r)
+{
+  double v[4];
+  if (!get(in, v)) {
+    return false;
+  }
+  r = cv::Rect2d(v[0], v[1], v[2], v[3]);
+  return true;
+}
+}  // namespace
+
+bool TrackingSnapshot::save(
+  const std::string & file, int64_t stamp,
+  const std::vector<Entry> & entries)
+{
+  std::string tmp = file + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      return false;
+    }
+    SnapshotHeader header = {kMagic, kVersion, stamp, static_cast<uint32_t>(entries.size())};
+    put(out, header);
+    for (auto & e : entries) {
+      put<int64_t>(out, e.id);
+      put<uint16_t>(out, static_cast<uint16_t>(e.name.size()));
+      out.write(e.name.data(), static_cast<uint16_t>(e.name.size()));
+      put<float>(out, e.probability);
+      putRect(out, e.tracked);
+      putRect(out, e.detected);
+      int32_t counts[4] = {e.state, e.hits, e.ageing, e.misses};
+      put(out, counts);
+      put<uint8_t>(out, e.localized ? 1 : 0);
+      double c[3] = {e.centroid.x, e.centroid.y, e.centroid.z};
+      put(out, c);
+      put<uint32_t>(out, static_cast<uint32_t>(e.history.size()));
+      for (auto & h : e.history) {
+        put<int64_t>(out, h.first);
+        putRect(out, h.second);
+      }
+    }
+    if (!out.flush()) {
+      return false;
+    }
+  }
+  return std::rename(tmp.c_str(), file.c_str()) == 0;
+}
+
+bool TrackingSnapshot::load(
+  const std::string & file, int64_t & stamp,
+  std::vector<Entry> & entries)
+{
+  entries.clear();
+  std::ifstream in(file, std::ios::binary);
+  SnapshotHeader header;
+  if (!get(in, header) || header.magic != kMagic || header.version != kVersion ||
+    header.count > kMaxEntries)
+  {
+    return false;
+  }
+  stamp = header.stamp;
+  entries.resize(header.count);
+  for (auto & e : entries) {
+    uint16_t n;
+    int32_t counts[4];
+    uint8_t localized;
+    double c[3];
+    uint32_t history;
+    bool ok = get(in, e.id) && get(in, n);
+    e.name.assign(ok ? n : 0, '\0');
+    ok = ok && in.read(&e.name[0], n) && get(in, e.probability) &&
+      getRect(in, e.tracked) && getRect(in, e.detected) && get(in, counts) &&
+      get(in, localized) && get(in, c) && get(in, history);
+    if (!ok || history > kMaxEntries) {
+      entries.clear();
+      return false;
+    }
+    e.state = counts[0];
+    e.hits = counts[1];
+    e.ageing = counts[2];
+    e.misses = counts[3];
+    e.localized = localized != 0;
+    e.centroid = cv::Point3d(c[0], c[1], c[2]);
+    e.history.resize(history);
+    for (auto & h : e.history) {
+      if (!get(in, h.first) || !getRect(in, h.second)) {
+        entries.clear();
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
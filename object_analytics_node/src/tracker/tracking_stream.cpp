@@ -0,0 +1,805 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <std_msgs/msg/header.hpp>
+#include <cv_bridge/cv_bridge.h>
+#include <opencv2/imgproc.hpp>
+#include <rcl/subscription.h>
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/tracker/tracking_stream.hpp"
+#include "object_analytics_node/util/stage_stats.hpp"
+
+namespace object_analytics_node
+{
+namespace tracker
+{
+const double TrackingStream::kCheckOverlap = 0.7;
+const size_t TrackingStream::kRgbQueueSize = 20;
+
+TrackingStream::Options::Options()
+: num_threads(4), history_capacity(Tracking::kHistoryCapacity), rectify_threshold(0),
+  tracker_pool_size(8), budget_ms(0), queue_size(kRgbQueueSize), catch_up(true),
+  motion_compensate(false),
+  check_rectify(false), frame_trace(false), rgb_cache_bytes(0), model_bytes(0),
+  tracker_bytes(0), tracker_update_ms(0),
+  crop_margin(0), crop_max_side(0), working_width(0), particles(0),
+  rgb_qos(rmw_qos_profile_default), detection_qos(rmw_qos_profile_default),
+  tracking_qos(rmw_qos_profile_default), depth_gate(0), occlusion(0),
+  reid_capacity(0), reid_max_age(30.0), reid_similarity(0.8),
+  localization_qos(rmw_qos_profile_default), coalesce(true), warmup(true),
+  capture_format(".jpg"), async_rectify(false), goturn_batch_device("CPU"),
+  snapshot_interval(1.0), snapshot_max_age(10.0)
+{
+  filter.setMinProbability(TrackingManager::kProbabilityThreshold);
+}
+
+TrackingStream::TrackingStream(
+  rclcpp::Node * node, const std::string & name,
+  const Options & options)
+: node_(node), name_(name), locs_(options.queue_size), coalesce_(options.coalesce),
+  rgbs_(options.queue_size),
+  tracks_(options.check_rectify ? options.queue_size : 1),
+  gate_(options.gate), catch_up_(options.catch_up), motion_compensate_(options.motion_compensate),
+  check_rectify_(options.check_rectify),
+  working_width_(options.working_width),
+  rgb_memory_(name.empty() ? "tracker.rgb_frames" : "tracker." + name + ".rgb_frames",
+    options.rgb_cache_bytes),
+  model_memory_(name.empty() ? "tracker.models" : "tracker." + name + ".models",
+    options.model_bytes),
+  snapshot_file_(options.snapshot_file.empty() || name.empty() ? options.snapshot_file :
+    options.snapshot_file + "." + name),
+  snapshot_interval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(options.snapshot_interval))),
+  async_(options.async_rectify)
+{
+  /* a stream runs apart from the others*/
+  group_ = node_->create_callback_group(
+    rclcpp::callback_group::CallbackGroupType::MutuallyExclusive);
+
+  auto rgb_callback =
+    [this](const typename sensor_msgs::msg::Image::SharedPtr image) -> void {
+      this->rgb_cb(image);
+    };
+  sub_rgb_ = node_->create_subscription<sensor_msgs::msg::Image>(
+    getTopic(Const::kTopicRgb), rgb_callback, options.rgb_qos, group_);
+
+  auto obj_callback =
+    [this](const typename object_msgs::msg::ObjectsInBoxes::SharedPtr objs)
+    -> void {this->obj_cb(objs);};
+  sub_obj_ = node_->create_subscription<object_msgs::msg::ObjectsInBoxes>(
+    getTopic(Const::kTopicDetection), obj_callback, options.detection_qos, group_);
+
+  if (options.depth_gate > 0) {
+    auto loc_callback =
+      [this](const typename object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr loc)
+      -> void {this->loc_cb(loc);};
+    sub_loc_ = node_->create_subscription<object_analytics_msgs::msg::ObjectsInBoxes3D>(
+      getTopic(Const::kTopicLocalization), loc_callback, options.localization_qos, group_);
+  }
+
+  pub_tracking_ = node_->create_publisher<object_analytics_msgs::msg::TrackedObjects>(
+    getTopic(Const::kTopicTracking), options.tracking_qos);
+
+  tm_ = std::make_unique<TrackingManager>(node_, options.num_threads);
+  configure(*tm_, options);
+  RCLCPP_INFO(node_->get_logger(), "tracker workers [%s]: %s", name_.c_str(),
+    tm_->getThreadPolicy().c_str());
+  if (options.warmup) {
+    /* frames are assumed 4:3 at the working width, the camera size is not known yet*/
+    int32_t width = options.working_width > 0 ? options.working_width : 640;
+    auto start = std::chrono::steady_clock::now();
+    tm_->warmup(cv::Size(width, width * 3 / 4));
+    double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+    RCLCPP_INFO(node_->get_logger(), "tracker warm-up [%s] %.1fms, %zu trackers ready",
+      name_.c_str(), ms, tm_->getTrackerPoolIdle());
+  }
+  if (!options.capture_file.empty()) {
+    std::string file = name_.empty() ? options.capture_file : options.capture_file + "." + name_;
+    try {
+      capture_.reset(new TrackingCapture(file, options.capture_format));
+      RCLCPP_INFO(node_->get_logger(), "capturing tracker inputs [%s] to %s", name_.c_str(),
+        file.c_str());
+    } catch (std::runtime_error & e) {
+      RCLCPP_ERROR(node_->get_logger(), "capture disabled: %s", e.what());
+    }
+  }
+  if (!snapshot_file_.empty()) {
+    restore(options.snapshot_max_age);
+  }
+  if (options.frame_trace) {
+    tracer_.reset(new util::FrameTracer(node_, name_.empty() ? "tracker" : "tracker." + name_));
+  }
+  last_detection_ = builtin_interfaces::msg::Time();
+  this_detection_ = builtin_interfaces::msg::Time();
+  last_obj_ = nullptr;
+  this_obj_ = nullptr;
+  if (async_) {
+    rectifier_ = std::thread(&TrackingStream::run, this);
+  }
+}
+
+TrackingStream::~TrackingStream()
+{
+  if (rectifier_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cond_.notify_one();
+    rectifier_.join();
+  }
+}
+
+void TrackingStream::setAlgo(const std::string & algo)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (rectifying_) {
+    pending_algo_ = algo;
+  } else {
+    tm_->setAlgo(algo);
+  }
+}
+
+void TrackingStream::configure(TrackingManager & tm, const Options & options)
+{
+  tm.setHistoryCapacity(options.history_capacity);
+  tm.setRectifyThreshold(options.rectify_threshold);
+  tm.setCropping(options.crop_margin, options.crop_max_side);
+  tm.setParticles(options.particles);
+  if (!options.goturn_batch_model.empty()) {
+    tm.setBatchModel(options.goturn_batch_model + ".prototxt",
+      options.goturn_batch_model + ".caffemodel", options.goturn_batch_device);
+  }
+  tm.setFilter(options.filter);
+  tm.setLifecycle(options.lifecycle);
+  tm.setTrackerPoolSize(options.tracker_pool_size);
+  tm.setTrackingBudget(options.budget_ms);
+  tm.setModelLimit(options.model_bytes);
+  tm.setModelBudget(options.tracker_bytes, options.tracker_update_ms);
+  tm.setDepthGate(options.depth_gate);
+  tm.setOcclusionThreshold(options.occlusion);
+  tm.setReid(options.reid_capacity, options.reid_max_age, options.reid_similarity);
+  if (!options.worker_policy.empty()) {
+    tm.setThreadPolicy(options.worker_policy);
+  }
+}
+
+std::string TrackingStream::getTopic(const std::string & topic) const
+{
+  return name_.empty() ? topic : "/" + name_ + topic;
+}
+
+void TrackingStream::rgb_cb(const sensor_msgs::msg::Image::ConstSharedPtr & img)
+{
+  RCUTILS_LOG_DEBUG(
+    "received rgb frame frame_id(%s), stamp(sec(%ld),nsec(%ld)), "
+    "q_size(%zu)!\n",
+    img->header.frame_id.c_str(), img->header.stamp.sec,
+    img->header.stamp.nanosec, rgbs_.size());
+
+  /* convert once, the frame is buffered along with its preprocessed data*/
+  Frame frame = make_frame(img);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  /* the oldest frame is evicted when the ring is full*/
+  rgbs_.push(rclcpp::Time(img->header.stamp).nanoseconds(), frame);
+  if (this_detection_ != last_detection_ || restored_) {
+    if (this_detection_ == img->header.stamp && async_) {
+      Rectify job = {this_obj_, this_loc_, true, false};
+      submit(job);
+    } else if (rectifying_) {
+      /* the worker owns the manager, replays this frame before handing it back*/
+      interim_publish(img->header);
+    } else if (this_detection_ == img->header.stamp) {
+      RCLCPP_DEBUG(node_->get_logger(), "rectify in rgb_cb!");
+      if (capture_) {
+        capture_->algo(tm_->getAlgo());
+        capture_->detect(rclcpp::Time(img->header.stamp).nanoseconds(), this_obj_, this_loc_);
+      }
+      adopt(frame);
+      tm_->detect(*frame.ctx, this_obj_, this_loc_);
+      tracking_publish(frame);
+    } else {
+      /* age of the frame when taken from the queue*/
+      rclcpp::Time frame_time(img->header.stamp, node_->get_clock()->get_clock_type());
+      double latency_ms = (node_->now() - frame_time).nanoseconds() / 1e6;
+      bool overloaded = gate_.isOverloaded();
+      uint64_t skipped = gate_.getSkippedInOverload();
+      OverloadGate::Action action = gate_.admit(latency_ms);
+      if (overloaded && !gate_.isOverloaded()) {
+        RCLCPP_INFO(node_->get_logger(), "overload over, %" PRIu64 " frames not tracked, %"
+          PRIu64 " in total", skipped, gate_.getSkipped());
+      }
+      if (action == OverloadGate::kTrack) {
+        if (capture_) {
+          capture_->track(rclcpp::Time(img->header.stamp).nanoseconds());
+        }
+        adopt(frame);
+        tm_->track(*frame.ctx, img->header.stamp);
+        tracking_publish(frame);
+      } else if (action == OverloadGate::kExtrapolate) {
+        if (capture_) {
+          capture_->extrapolate(rclcpp::Time(img->header.stamp).nanoseconds());
+        }
+        tm_->extrapolate(img->header.stamp);
+        tracking_publish(frame);
+      } else {
+        RCLCPP_DEBUG(node_->get_logger(), "latency %.1fms, frame skipped", latency_ms);
+      }
+    }
+  }
+  account(!rectifying_);
+}
+
+TrackingStream::Frame TrackingStream::make_frame(
+  const sensor_msgs::msg::Image::ConstSharedPtr & img)
+{
+  Frame frame;
+  frame.ingress_ns = util::FrameTracer::now();
+  frame.img = img;
+  frame.bytes = img->data.size();
+  /* share the message data if the encoding is accepted as is*/
+  bool supported = FrameContext::isSupported(img->encoding);
+  cv::Mat mat = supported ? cv_bridge::toCvShare(img)->image :
+    cv_bridge::toCvShare(img, "bgr8")->image;
+  double scale = 1.0;
+  int32_t width = working_width_;
+  if (width > 0 && mat.cols > width) {
+    scale = static_cast<double>(width) / mat.cols;
+    cv::Mat scaled;
+    cv::resize(mat, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
+    mat = scaled;
+  }
+  /* the manager takes the scale with the frame, see adopt()*/
+  frame.scale = scale;
+  if (capture_) {
+    /* encoded by the capture thread, the message keeps a shared mat alive*/
+    capture_->frame(rclcpp::Time(img->header.stamp).nanoseconds(), mat,
+      supported ? img->encoding : "bgr8", scale, img);
+  }
+  if (!supported || mat.data != img->data.data()) {
+    frame.bytes += mat.total() * mat.elemSize();
+  }
+  frame.ctx = supported ? std::make_shared<FrameContext>(mat, img->encoding) :
+    std::make_shared<FrameContext>(mat);
+  return frame;
+}
+
+void TrackingStream::adopt(const Frame & frame)
+{
+  tm_->setWorkingScale(frame.scale);
+  tm_->setMaxTrackings(max_trackings_);
+}
+
+void TrackingStream::obj_cb(
+  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & msg)
+{
+  object_msgs::msg::ObjectsInBoxes::ConstSharedPtr objs = coalesce_ ? coalesce(msg) : msg;
+  if (!sub_loc_ || objs->objects_vector.empty()) {
+    detection(objs, nullptr);
+    return;
+  }
+  /* the localization of a later detection is never coming*/
+  if (pending_obj_) {
+    loc_missed_++;
+    detection(pending_obj_, nullptr);
+    pending_obj_.reset();
+  }
+  int64_t stamp = rclcpp::Time(objs->header.stamp).nanoseconds();
+  locs_.dropBefore(stamp);
+  const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr * loc = locs_.find(stamp);
+  if (loc != nullptr) {
+    detection(objs, *loc);
+  } else {
+    pending_obj_ = objs;
+  }
+}
+
+object_msgs::msg::ObjectsInBoxes::ConstSharedPtr TrackingStream::coalesce(
+  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs)
+{
+  /* drain the queue of the subscription, delivered in order*/
+  std::vector<object_msgs::msg::ObjectsInBoxes::ConstSharedPtr> burst(1, objs);
+  for (;; ) {
+    object_msgs::msg::ObjectsInBoxes::SharedPtr next =
+      std::make_shared<object_msgs::msg::ObjectsInBoxes>();
+    rmw_message_info_t info;
+    if (rcl_take(sub_obj_->get_subscription_handle().get(), next.get(), &info,
+      nullptr) != RCL_RET_OK)
+    {
+      break;
+    }
+    burst.push_back(next);
+  }
+  if (burst.size() == 1) {
+    return objs;
+  }
+
+  /* the latest, unless its rgb frame was missed*/
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t newest_rgb = rgbs_.empty() ? std::numeric_limits<int64_t>::min() :
+    rgbs_.stampAt(rgbs_.size() - 1);
+  size_t chosen = burst.size() - 1;
+  for (size_t i = burst.size(); i-- > 0; ) {
+    int64_t stamp = rclcpp::Time(burst[i]->header.stamp).nanoseconds();
+    if (stamp > newest_rgb || rgbs_.find(stamp) != nullptr) {
+      chosen = i;
+      break;
+    }
+  }
+  coalesced_ += burst.size() - 1;
+  RCLCPP_DEBUG(node_->get_logger(), "coalesced %zu detection frames", burst.size() - 1);
+  return burst[chosen];
+}
+
+void TrackingStream::loc_cb(
+  const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc)
+{
+  int64_t stamp = rclcpp::Time(loc->header.stamp).nanoseconds();
+  if (!pending_obj_) {
+    locs_.push(stamp, loc);
+    return;
+  }
+  int64_t pending = rclcpp::Time(pending_obj_->header.stamp).nanoseconds();
+  if (stamp < pending) {
+    return;
+  }
+  object_msgs::msg::ObjectsInBoxes::ConstSharedPtr objs = pending_obj_;
+  pending_obj_.reset();
+  if (stamp == pending) {
+    detection(objs, loc);
+  } else {
+    /* the localization of the detection was dropped*/
+    loc_missed_++;
+    detection(objs, nullptr);
+    locs_.push(stamp, loc);
+  }
+}
+
+void TrackingStream::detection(
+  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+  const object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc)
+{
+  last_detection_ = this_detection_;
+  this_detection_ = objs->header.stamp;
+  last_obj_ = this_obj_;
+  this_obj_ = objs;
+  this_loc_ = loc;
+
+  if (objs->objects_vector.size() == 0) {return;}
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  RCUTILS_LOG_DEBUG(
+    "received obj detection frame_id(%s), stamp(sec(%ld),nsec(%ld)), "
+    "img_buff_count(%zu)!\n",
+    objs->header.frame_id.c_str(), objs->header.stamp.sec,
+    objs->header.stamp.nanosec, rgbs_.size());
+  /* frames older than the detection are no longer needed*/
+  int64_t stamp = rclcpp::Time(this_detection_).nanoseconds();
+  rgbs_.dropBefore(stamp);
+  queue_depth_ = rgbs_.size();
+  const Frame * rgb = rgbs_.find(stamp);
+  if (rgb != nullptr && async_) {
+    Rectify job = {this_obj_, loc, false, true};
+    submit(job);
+  } else if (rgb != nullptr) {
+    if (check_rectify_ && !check_rectify(objs)) {
+      RCLCPP_DEBUG(node_->get_logger(), "tracked well, rectify skipped");
+      return;
+    }
+
+    RCUTILS_LOG_DEBUG("rectify frame_id(%s), stamp(sec(%ld),nsec(%ld))\n",
+      objs->header.frame_id.c_str(), objs->header.stamp.sec,
+      objs->header.stamp.nanosec);
+    /* rectify against the latest frame at once if carried over to it*/
+    object_msgs::msg::ObjectsInBoxes::ConstSharedPtr rect_objs = this_obj_;
+    object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr rect_loc = loc;
+    if (motion_compensate_ && rgbs_.size() > 1 &&
+      compensate(*rgb, rgbs_.valueAt(rgbs_.size() - 1), rect_objs, rect_loc))
+    {
+      rgb = &rgbs_.valueAt(rgbs_.size() - 1);
+      stamp = rgbs_.stampAt(rgbs_.size() - 1);
+    }
+    if (capture_) {
+      capture_->algo(tm_->getAlgo());
+      capture_->detect(stamp, rect_objs, rect_loc);
+    }
+    adopt(*rgb);
+    tm_->detect(*rgb->ctx, rect_objs, rect_loc);
+
+    if (rect_objs != this_obj_) {
+      RCLCPP_DEBUG(node_->get_logger(), "rectified on the latest frame, %zu frames skipped",
+        rgbs_.size() - 1);
+      tracking_publish(*rgb);
+    } else if (catch_up_ && rgbs_.size() > 1) {
+      /* replay the frames tracked with the stale trackers meanwhile*/
+      collect_tracked(rgb->img->header);
+      for (size_t i = 1; i < rgbs_.size(); i++) {
+        const Frame & frame = rgbs_.valueAt(i);
+        if (capture_) {
+          capture_->track(rgbs_.stampAt(i));
+        }
+        adopt(frame);
+        tm_->track(*frame.ctx, frame.img->header.stamp);
+        collect_tracked(frame.img->header);
+      }
+      RCLCPP_DEBUG(node_->get_logger(), "caught up %zu frames after detection", rgbs_.size() - 1);
+      if (msg_.tracked_objects.size() > 0) {
+        pub_tracking_->publish(msg_);
+        if (tracer_) {
+          /* the latency of the latest frame replayed, since it came in*/
+          tracer_->trace(msg_.header, rgbs_.valueAt(rgbs_.size() - 1).ingress_ns);
+        }
+      }
+      if (capture_) {
+        capture_->replenish();
+      }
+      tm_->replenish();
+    }
+    /* the detection frame may be evicted only once processed*/
+    account();
+  }
+}
+
+const object_analytics_msgs::msg::TrackedObjects & TrackingStream::collect_tracked(
+  const std_msgs::msg::Header & header)
+{
+  /* clear keeps the capacity of the previous frames*/
+  msg_.header = header;
+  msg_.tracked_objects.clear();
+  velocities_.clear();
+  tm_->getTrackedObjs(msg_, async_ ? &velocities_ : nullptr);
+
+  if (check_rectify_) {
+    tracks_.push(rclcpp::Time(header.stamp).nanoseconds(),
+      std::make_shared<object_analytics_msgs::msg::TrackedObjects>(msg_));
+  }
+  return msg_;
+}
+
+void TrackingStream::tracking_publish(const Frame & frame)
+{
+  const object_analytics_msgs::msg::TrackedObjects & msg = collect_tracked(frame.img->header);
+
+  if (msg.tracked_objects.size() > 0) {
+    /* published by reference, the message is not copied for inter-process*/
+    pub_tracking_->publish(msg);
+    if (tracer_) {
+      tracer_->trace(msg.header, frame.ingress_ns);
+    }
+  } else {
+    RCUTILS_LOG_WARN("No objects to publish!");
+  }
+
+  /* create the trackers for coming rectify after the results are out*/
+  if (capture_) {
+    capture_->replenish();
+  }
+  tm_->replenish();
+}
+
+void TrackingStream::interim_publish(const std_msgs::msg::Header & header)
+{
+  double dt = (rclcpp::Time(header.stamp) - rclcpp::Time(front_.header.stamp)).seconds();
+  interim_.header = header;
+  interim_.tracked_objects = front_.tracked_objects;
+  for (size_t i = 0; i < interim_.tracked_objects.size(); i++) {
+    sensor_msgs::msg::RegionOfInterest & roi = interim_.tracked_objects[i].roi;
+    cv::Point2d shift = front_velocities_[i] * dt;
+    roi.x_offset = static_cast<uint32_t>(std::max(0., roi.x_offset + shift.x));
+    roi.y_offset = static_cast<uint32_t>(std::max(0., roi.y_offset + shift.y));
+  }
+  rectifying_frames_++;
+  if (interim_.tracked_objects.size() > 0) {
+    pub_tracking_->publish(interim_);
+  }
+}
+
+void TrackingStream::submit(const Rectify & job)
+{
+  if (!rectifying_) {
+    start(job);
+    return;
+  }
+  if (pending_) {
+    superseded_++;
+  }
+  pending_.reset(new Rectify(job));
+}
+
+void TrackingStream::start(const Rectify & job)
+{
+  /* the front buffer, extrapolated till the worker is done*/
+  front_ = msg_;
+  front_velocities_ = velocities_;
+  job_.reset(new Rectify(job));
+  rectifying_ = true;
+  cond_.notify_one();
+}
+
+void TrackingStream::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;; ) {
+    cond_.wait(lock, [this] {return stop_ || job_;});
+    if (stop_) {
+      return;
+    }
+    Rectify job = *job_;
+    job_.reset();
+    /* the rgb frame may be evicted meanwhile*/
+    const Frame * rgb = rgbs_.find(rclcpp::Time(job.objs->header.stamp).nanoseconds());
+    if (rgb == nullptr) {
+      RCLCPP_DEBUG(node_->get_logger(), "rgb frame of the detection evicted, rectify skipped");
+    } else if (job.check && check_rectify_ && !check_rectify(job.objs)) {
+      RCLCPP_DEBUG(node_->get_logger(), "tracked well, rectify skipped");
+    } else {
+      Frame frame = *rgb;
+      fast_forward(frame, job, lock);
+    }
+    if (!pending_algo_.empty()) {
+      tm_->setAlgo(pending_algo_);
+      pending_algo_.clear();
+    }
+    account();
+    /* the manager is handed back, or kept for the detection coming meanwhile*/
+    if (pending_) {
+      std::unique_ptr<Rectify> next = std::move(pending_);
+      start(*next);
+    } else {
+      rectifying_ = false;
+    }
+  }
+}
+
+void TrackingStream::fast_forward(
+  const Frame & detected, const Rectify & job,
+  std::unique_lock<std::mutex> & lock)
+{
+  /* the latest frame, the detection is carried over to it if possible*/
+  Frame latest = rgbs_.valueAt(rgbs_.size() - 1);
+  lock.unlock();
+  object_msgs::msg::ObjectsInBoxes::ConstSharedPtr objs = job.objs;
+  object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr loc = job.loc;
+  bool compensated = motion_compensate_ && latest.img != detected.img &&
+    compensate(detected, latest, objs, loc);
+  const Frame & rgb = compensated ? latest : detected;
+  int64_t last = rclcpp::Time(rgb.img->header.stamp).nanoseconds();
+  if (capture_) {
+    capture_->algo(tm_->getAlgo());
+    capture_->detect(last, objs, loc);
+  }
+  adopt(rgb);
+  tm_->detect(*rgb.ctx, objs, loc);
+  collect_tracked(rgb.img->header);
+
+  bool publish = job.publish;
+  std::vector<Frame> frames;
+  for (;; ) {
+    lock.lock();
+    frames.clear();
+    for (size_t i = 0; catch_up_ && i < rgbs_.size(); i++) {
+      if (rgbs_.stampAt(i) > last) {
+        frames.push_back(rgbs_.valueAt(i));
+      }
+    }
+    if (frames.empty() && !publish) {
+      return;
+    }
+    lock.unlock();
+
+    if (frames.empty()) {
+      /* caught up, the latest frame is out before the manager is handed back*/
+      if (msg_.tracked_objects.size() > 0) {
+        pub_tracking_->publish(msg_);
+      }
+      if (capture_) {
+        capture_->replenish();
+      }
+      tm_->replenish();
+      publish = false;
+      continue;
+    }
+    for (auto & frame : frames) {
+      last = rclcpp::Time(frame.img->header.stamp).nanoseconds();
+      if (capture_) {
+        capture_->track(last);
+      }
+      adopt(frame);
+      tm_->track(*frame.ctx, frame.img->header.stamp);
+      collect_tracked(frame.img->header);
+    }
+    RCLCPP_DEBUG(node_->get_logger(), "fast-forwarded %zu frames after detection", frames.size());
+    publish = true;
+  }
+}
+
+bool TrackingStream::compensate(
+  const Frame & rgb, const Frame & latest,
+  object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs,
+  object_analytics_msgs::msg::ObjectsInBoxes3D::ConstSharedPtr & loc)
+{
+  static util::StageStats & stats = util::StageRegistry::get("tracker.compensate");
+  util::ScopedStageTimer timer(stats);
+  /* the flow is found in the pixels of the frames, at their working scale*/
+  if (rgb.scale != latest.scale || objs->objects_vector.empty()) {
+    return false;
+  }
+  double scale = rgb.scale;
+  std::vector<cv::Rect2d> rois;
+  rois.reserve(objs->objects_vector.size());
+  for (auto & obj : objs->objects_vector) {
+    rois.push_back(cv::Rect2d(obj.roi.x_offset * scale, obj.roi.y_offset * scale,
+      obj.roi.width * scale, obj.roi.height * scale));
+  }
+  std::vector<cv::Point2d> shifts;
+  if (MotionCompensator::estimate(*rgb.ctx, *latest.ctx, rois, shifts) < rois.size()) {
+    return false;
+  }
+
+  auto shifted = std::make_shared<object_msgs::msg::ObjectsInBoxes>(*objs);
+  shifted->header.stamp = latest.img->header.stamp;
+  for (size_t k = 0; k < shifted->objects_vector.size(); k++) {
+    sensor_msgs::msg::RegionOfInterest & roi = shifted->objects_vector[k].roi;
+    roi.x_offset = static_cast<uint32_t>(std::max(0., roi.x_offset + shifts[k].x / scale + 0.5));
+    roi.y_offset = static_cast<uint32_t>(std::max(0., roi.y_offset + shifts[k].y / scale + 0.5));
+  }
+  if (loc) {
+    /* localized objects keep the roi and the order of the detections, see the manager*/
+    auto moved = std::make_shared<object_analytics_msgs::msg::ObjectsInBoxes3D>(*loc);
+    moved->header.stamp = latest.img->header.stamp;
+    size_t next = 0;
+    for (auto & lobj : moved->objects_in_boxes) {
+      for (size_t k = next; k < objs->objects_vector.size(); k++) {
+        const object_msgs::msg::ObjectInBox & obj = objs->objects_vector[k];
+        if (lobj.roi == obj.roi && lobj.object.object_name == obj.object.object_name) {
+          lobj.roi = shifted->objects_vector[k].roi;
+          next = k + 1;
+          break;
+        }
+      }
+    }
+    loc = moved;
+  }
+  objs = shifted;
+  compensated_++;
+  return true;
+}
+
+void TrackingStream::account(bool manager)
+{
+  size_t bytes = 0;
+  for (size_t i = 0; i < rgbs_.size(); i++) {
+    const Frame & frame = rgbs_.valueAt(i);
+    bytes += frame.bytes + frame.ctx->getBytes();
+  }
+  while (rgb_memory_.isOver(bytes) && rgbs_.size() > 1) {
+    const Frame & oldest = rgbs_.valueAt(0);
+    bytes -= oldest.bytes + oldest.ctx->getBytes();
+    rgbs_.dropBefore(rgbs_.stampAt(1));
+    rgb_evicted_++;
+  }
+  rgb_memory_.update(bytes);
+  queue_depth_ = rgbs_.size();
+  if (!manager) {
+    return;
+  }
+  model_memory_.update(tm_->getModelBytes());
+  trackings_ = tm_->getTrackingCount();
+  pool_idle_ = tm_->getTrackerPoolIdle();
+  model_evicted_ = tm_->getModelEvicted();
+  model_compacted_ = tm_->getModelCompacted();
+  depth_gated_ = tm_->getDepthGated();
+  occluded_ = tm_->getOccluded();
+  reidentified_ = tm_->getReidentified();
+  capped_ = tm_->getCapped();
+  snapshot();
+}
+
+void TrackingStream::restore(double max_age)
+{
+  int64_t stamp;
+  std::vector<TrackingSnapshot::Entry> entries;
+  if (!TrackingSnapshot::load(snapshot_file_, stamp, entries)) {
+    RCLCPP_INFO(node_->get_logger(), "no tracking snapshot [%s] in %s", name_.c_str(),
+      snapshot_file_.c_str());
+    return;
+  }
+  double age = (std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count() - stamp) / 1e9;
+  if (max_age > 0 && age > max_age) {
+    RCLCPP_INFO(node_->get_logger(), "tracking snapshot [%s] %.1fs old, not restored",
+      name_.c_str(), age);
+    return;
+  }
+  size_t restored = tm_->restore(entries);
+  restored_ = restored > 0;
+  RCLCPP_INFO(node_->get_logger(), "restored %zu trackings [%s] of %.1fs ago", restored,
+    name_.c_str(), age);
+}
+
+void TrackingStream::snapshot()
+{
+  if (snapshot_file_.empty()) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (now - snapshot_last_ < snapshot_interval_) {
+    return;
+  }
+  snapshot_last_ = now;
+  tm_->snapshot(snapshot_entries_);
+  int64_t stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+  if (!TrackingSnapshot::save(snapshot_file_, stamp, snapshot_entries_)) {
+    snapshot_failed_++;
+    RCLCPP_DEBUG(node_->get_logger(), "tracking snapshot not written to %s",
+      snapshot_file_.c_str());
+  }
+}
+
+bool TrackingStream::check_rectify(
+  const object_msgs::msg::ObjectsInBoxes::ConstSharedPtr & objs)
+{
+  int64_t detect_frame = rclcpp::Time(objs->header.stamp).nanoseconds();
+  bool res = true;
+
+  tracks_.dropBefore(detect_frame);
+  const object_analytics_msgs::msg::TrackedObjects::SharedPtr * track =
+    tracks_.find(detect_frame);
+  if (track == nullptr) {
+    return res;
+  }
+  return needsRectify(*objs, **track);
+}
+
+bool TrackingStream::needsRectify(
+  const object_msgs::msg::ObjectsInBoxes & objs,
+  const object_analytics_msgs::msg::TrackedObjects & tracked)
+{
+  /* each detected object against the tracked object of its name overlapping it
+   * most, rectify if new or none overlaps by kCheckOverlap*/
+  for (auto & detected : objs.objects_vector) {
+    const sensor_msgs::msg::RegionOfInterest & droi = detected.roi;
+    cv::Rect2d detected_rect(droi.x_offset, droi.y_offset, droi.width, droi.height);
+    double best = -1;
+    for (auto & tobj : tracked.tracked_objects) {
+      if (detected.object.object_name != tobj.object.object_name) {
+        continue;
+      }
+      cv::Rect2d tracked_rect(tobj.roi.x_offset, tobj.roi.y_offset,
+        tobj.roi.width, tobj.roi.height);
+      double intersect = (tracked_rect & detected_rect).area();
+      double area = tracked_rect.area() + detected_rect.area() - intersect;
+      best = std::max(best, area > 0 ? intersect / area : 0);
+    }
+    if (best <= kCheckOverlap) {
+      return true;
+    }
+  }
+  RCUTILS_LOG_DEBUG("Tracked correct, no need to rectify!!!!\n");
+  return false;
+}
+
+}  // namespace tracker
+}  // namespace object_analytics_node
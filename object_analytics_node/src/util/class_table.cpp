@@ -0,0 +1,56 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "object_analytics_node/util/class_table.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+std::mutex ClassTable::mtx_;
+std::deque<std::string> ClassTable::names_;
+std::unordered_map<std::string, int32_t> ClassTable::ids_;
+
+int32_t ClassTable::intern(const std::string & name)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  std::unordered_map<std::string, int32_t>::iterator c = ids_.find(name);
+  if (c == ids_.end()) {
+    c = ids_.emplace(name, static_cast<int32_t>(names_.size())).first;
+    names_.push_back(name);
+  }
+  return c->second;
+}
+
+const std::string & ClassTable::name(int32_t id)
+{
+  static const std::string kUnknown;
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (id < 0 || static_cast<size_t>(id) >= names_.size()) {
+    return kUnknown;
+  }
+  return names_[id];
+}
+
+size_t ClassTable::size()
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return names_.size();
+}
+}  // namespace util
+}  // namespace object_analytics_node
@@ -0,0 +1,127 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <lz4.h>
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
+#include "object_analytics_node/util/cloud_codec.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+const float CloudCodec::kResolution = 0.001f;
+const int16_t CloudCodec::kInvalid = std::numeric_limits<int16_t>::min();
+
+namespace
+{
+const uint16_t kOne = 1;
+
+/* quantized planes of the thread, capacity kept across clouds*/
+std::vector<int16_t> & getPlanes(size_t size)
+{
+  thread_local std::vector<int16_t> planes;
+  planes.resize(size);
+  return planes;
+}
+
+bool quantize(float v, int16_t & q)
+{
+  float steps = v / CloudCodec::kResolution;
+  if (!(std::fabs(steps) <= std::numeric_limits<int16_t>::max())) {
+    return false;
+  }
+  q = static_cast<int16_t>(std::lround(steps));
+  return true;
+}
+}  // namespace
+
+void CloudCodec::encode(
+  const sensor_msgs::msg::PointCloud2 & points,
+  object_analytics_msgs::msg::CompressedPointCloud & compressed)
+{
+  if (!segmenter::PointCloud2View::isSupported(points)) {
+    throw std::runtime_error("point cloud without FLOAT32 x/y/z in host byte order");
+  }
+  segmenter::PointCloud2View view(points);
+  const size_t n = view.size();
+  std::vector<int16_t> & planes = getPlanes(3 * n);
+  for (size_t i = 0; i < n; i++) {
+    segmenter::PointT p = view.at(i);
+    if (!quantize(p.x, planes[i]) || !quantize(p.y, planes[n + i]) ||
+      !quantize(p.z, planes[2 * n + i]))
+    {
+      planes[i] = planes[n + i] = planes[2 * n + i] = kInvalid;
+    }
+  }
+
+  const int raw_size = static_cast<int>(planes.size() * sizeof(int16_t));
+  compressed.data.resize(LZ4_compressBound(raw_size));
+  int size = LZ4_compress_default(reinterpret_cast<const char *>(planes.data()),
+      reinterpret_cast<char *>(compressed.data.data()), raw_size,
+      static_cast<int>(compressed.data.size()));
+  if (raw_size > 0 && size <= 0) {
+    throw std::runtime_error("lz4 compression failed");
+  }
+  compressed.data.resize(size);
+  compressed.header = points.header;
+  compressed.height = points.height;
+  compressed.width = points.width;
+  compressed.is_dense = points.is_dense;
+  compressed.raw_size = raw_size;
+}
+
+void CloudCodec::decode(
+  const object_analytics_msgs::msg::CompressedPointCloud & compressed,
+  sensor_msgs::msg::PointCloud2 & points)
+{
+  const size_t n = static_cast<size_t>(compressed.width) * compressed.height;
+  if (compressed.raw_size != 3 * n * sizeof(int16_t)) {
+    throw std::runtime_error("compressed point cloud of a wrong size");
+  }
+  std::vector<int16_t> & planes = getPlanes(3 * n);
+  int size = LZ4_decompress_safe(reinterpret_cast<const char *>(compressed.data.data()),
+      reinterpret_cast<char *>(planes.data()), static_cast<int>(compressed.data.size()),
+      static_cast<int>(compressed.raw_size));
+  if (size != static_cast<int>(compressed.raw_size)) {
+    throw std::runtime_error("corrupted compressed point cloud");
+  }
+
+  points.header = compressed.header;
+  points.height = compressed.height;
+  points.width = compressed.width;
+  points.is_dense = compressed.is_dense;
+  points.is_bigendian = *reinterpret_cast<const uint8_t *>(&kOne) == 0;
+  sensor_msgs::PointCloud2Modifier modifier(points);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  uint8_t * out = points.data.data();
+  for (size_t i = 0; i < n; i++, out += points.point_step) {
+    float xyz[3] = {nan, nan, nan};
+    if (planes[i] != kInvalid) {
+      xyz[0] = planes[i] * kResolution;
+      xyz[1] = planes[n + i] * kResolution;
+      xyz[2] = planes[2 * n + i] * kResolution;
+    }
+    std::memcpy(out, xyz, sizeof(xyz));
+  }
+}
+}  // namespace util
+}  // namespace object_analytics_node
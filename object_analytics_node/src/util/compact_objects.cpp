@@ -0,0 +1,104 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <string>
+#include "object_analytics_node/util/class_table.hpp"
+#include "object_analytics_node/util/compact_objects.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+void CompactObjects::pack(
+  const object_analytics_msgs::msg::ObjectsInBoxes3D & objs,
+  object_analytics_msgs::msg::CompactObjectsInBoxes3D & compact)
+{
+  size_t n = objs.objects_in_boxes.size();
+  compact.header = objs.header;
+  compact.class_ids.resize(n);
+  compact.probabilities.resize(n);
+  compact.rois.resize(n * 4);
+  compact.bounds.resize(n * 6);
+  compact.ids.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    const object_analytics_msgs::msg::ObjectInBox3D & o = objs.objects_in_boxes[i];
+    compact.class_ids[i] = ClassTable::intern(o.object.object_name);
+    compact.probabilities[i] = o.object.probability;
+    uint32_t * roi = &compact.rois[i * 4];
+    roi[0] = o.roi.x_offset;
+    roi[1] = o.roi.y_offset;
+    roi[2] = o.roi.width;
+    roi[3] = o.roi.height;
+    float * bounds = &compact.bounds[i * 6];
+    bounds[0] = o.min.x;
+    bounds[1] = o.min.y;
+    bounds[2] = o.min.z;
+    bounds[3] = o.max.x;
+    bounds[4] = o.max.y;
+    bounds[5] = o.max.z;
+    compact.ids[i] = o.id;
+  }
+  /* the table only grows, every ID above is below its size*/
+  compact.class_count = static_cast<uint32_t>(ClassTable::size());
+}
+
+bool CompactObjects::unpack(
+  const object_analytics_msgs::msg::CompactObjectsInBoxes3D & compact,
+  const object_analytics_msgs::msg::ClassNames & names,
+  object_analytics_msgs::msg::ObjectsInBoxes3D & objs)
+{
+  size_t n = compact.class_ids.size();
+  if (compact.probabilities.size() != n || compact.rois.size() != n * 4 ||
+    compact.bounds.size() != n * 6 || compact.ids.size() != n)
+  {
+    return false;
+  }
+  objs.header = compact.header;
+  objs.objects_in_boxes.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    object_analytics_msgs::msg::ObjectInBox3D & o = objs.objects_in_boxes[i];
+    int32_t c = compact.class_ids[i];
+    if (c >= 0 && static_cast<size_t>(c) < names.names.size()) {
+      o.object.object_name = names.names[c];
+    } else {
+      o.object.object_name.clear();
+    }
+    o.object.probability = compact.probabilities[i];
+    const uint32_t * roi = &compact.rois[i * 4];
+    o.roi.x_offset = roi[0];
+    o.roi.y_offset = roi[1];
+    o.roi.width = roi[2];
+    o.roi.height = roi[3];
+    o.roi.do_rectify = false;
+    const float * bounds = &compact.bounds[i * 6];
+    o.min.x = bounds[0];
+    o.min.y = bounds[1];
+    o.min.z = bounds[2];
+    o.max.x = bounds[3];
+    o.max.y = bounds[4];
+    o.max.z = bounds[5];
+    o.id = compact.ids[i];
+  }
+  return true;
+}
+
+void CompactObjects::getNames(object_analytics_msgs::msg::ClassNames & names)
+{
+  size_t n = ClassTable::size();
+  names.names.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    names.names[i] = ClassTable::name(static_cast<int32_t>(i));
+  }
+}
+}  // namespace util
+}  // namespace object_analytics_node
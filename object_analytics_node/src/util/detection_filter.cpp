@@ -0,0 +1,50 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/detection_filter.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+DetectionFilter::DetectionFilter()
+: min_probability_(0), min_area_(0)
+{
+}
+
+void DetectionFilter::setClasses(const std::vector<std::string> & classes)
+{
+  classes_.clear();
+  for (const auto & c : classes) {
+    if (!c.empty()) {
+      classes_.insert(c);
+    }
+  }
+}
+
+bool DetectionFilter::accept(const object_msgs::msg::ObjectInBox & obj) const
+{
+  if (obj.object.probability < min_probability_) {
+    return false;
+  }
+  if (static_cast<uint64_t>(obj.roi.width) * obj.roi.height < min_area_) {
+    return false;
+  }
+  return classes_.empty() || classes_.count(obj.object.object_name) > 0;
+}
+
+}  // namespace util
+}  // namespace object_analytics_node
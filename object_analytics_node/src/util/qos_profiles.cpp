@@ -0,0 +1,65 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <cstdlib>
+#include <string>
+#include "object_analytics_node/util/qos_profiles.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+const char QosProfiles::kSensor[] = "sensor";
+const char QosProfiles::kReliable[] = "reliable";
+
+bool QosProfiles::parse(const std::string & value, rmw_qos_profile_t & qos)
+{
+  size_t colon = value.find(':');
+  std::string preset = value.substr(0, colon);
+  rmw_qos_profile_t profile;
+  if (preset == kSensor) {
+    profile = rmw_qos_profile_sensor_data;
+    profile.depth = 1;
+  } else if (preset == kReliable) {
+    profile = rmw_qos_profile_default;
+  } else {
+    return false;
+  }
+  profile.history = RMW_QOS_POLICY_HISTORY_KEEP_LAST;
+  if (colon != std::string::npos) {
+    char * end = nullptr;
+    long depth = std::strtol(value.c_str() + colon + 1, &end, 10);  // NOLINT
+    if (depth <= 0 || end == value.c_str() + colon + 1 || *end != '\0') {
+      return false;
+    }
+    profile.depth = static_cast<size_t>(depth);
+  }
+  qos = profile;
+  return true;
+}
+
+rmw_qos_profile_t QosProfiles::declare(
+  rclcpp::Node * node, const std::string & key,
+  const std::string & def)
+{
+  rmw_qos_profile_t qos = rmw_qos_profile_default;
+  parse(def, qos);
+  std::string value = node->declare_parameter<std::string>("qos." + key, def);
+  if (!parse(value, qos)) {
+    RCLCPP_WARN(node->get_logger(), "unknown qos.%s %s, use %s", key.c_str(), value.c_str(),
+      def.c_str());
+  }
+  return qos;
+}
+}  // namespace util
+}  // namespace object_analytics_node
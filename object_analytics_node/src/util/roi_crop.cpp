@@ -0,0 +1,213 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
+#include "object_analytics_node/util/roi_crop.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+namespace
+{
+const uint16_t kOne = 1;
+
+bool overlaps(const RoiCrop::Window & a, const RoiCrop::Window & b)
+{
+  return a.x_offset < b.x_offset + b.width && b.x_offset < a.x_offset + a.width &&
+         a.y_offset < b.y_offset + b.height && b.y_offset < a.y_offset + a.height;
+}
+
+void merge(RoiCrop::Window & a, const RoiCrop::Window & b)
+{
+  uint32_t right = std::max(a.x_offset + a.width, b.x_offset + b.width);
+  uint32_t bottom = std::max(a.y_offset + a.height, b.y_offset + b.height);
+  a.x_offset = std::min(a.x_offset, b.x_offset);
+  a.y_offset = std::min(a.y_offset, b.y_offset);
+  a.width = right - a.x_offset;
+  a.height = bottom - a.y_offset;
+}
+
+bool inside(const RoiCrop::Window & w, uint32_t width, uint32_t height)
+{
+  return w.x_offset + w.width <= width && w.y_offset + w.height <= height;
+}
+
+void fillWindow(
+  uint8_t * data, uint32_t width, size_t step, const RoiCrop::Window & w, const float * xyz)
+{
+  for (uint32_t y = w.y_offset; y < w.y_offset + w.height; y++) {
+    uint8_t * row = data + (static_cast<size_t>(y) * width + w.x_offset) * step;
+    for (uint32_t x = 0; x < w.width; x++, row += step) {
+      std::memcpy(row, xyz, 3 * sizeof(float));
+    }
+  }
+}
+
+void setXYZ(sensor_msgs::msg::PointCloud2 & points, uint32_t width, uint32_t height)
+{
+  points.height = height;
+  points.width = width;
+  points.is_dense = false;
+  points.is_bigendian = *reinterpret_cast<const uint8_t *>(&kOne) == 0;
+  sensor_msgs::PointCloud2Modifier modifier(points);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+}
+}  // namespace
+
+void RoiCrop::getWindows(
+  const object_msgs::msg::ObjectsInBoxes & objs, uint32_t width, uint32_t height,
+  uint32_t margin, std::vector<Window> & windows)
+{
+  windows.clear();
+  for (auto & obj : objs.objects_vector) {
+    const Window & roi = obj.roi;
+    int64_t left = std::max<int64_t>(0, static_cast<int64_t>(roi.x_offset) - margin);
+    int64_t top = std::max<int64_t>(0, static_cast<int64_t>(roi.y_offset) - margin);
+    int64_t right = std::min<int64_t>(width,
+        static_cast<int64_t>(roi.x_offset) + roi.width + margin);
+    int64_t bottom = std::min<int64_t>(height,
+        static_cast<int64_t>(roi.y_offset) + roi.height + margin);
+    if (left >= right || top >= bottom) {
+      continue;
+    }
+    Window window;
+    window.x_offset = static_cast<uint32_t>(left);
+    window.y_offset = static_cast<uint32_t>(top);
+    window.width = static_cast<uint32_t>(right - left);
+    window.height = static_cast<uint32_t>(bottom - top);
+    /* a merged window may overlap windows it did not before, merged again till disjoint*/
+    for (size_t i = 0; i < windows.size(); ) {
+      if (overlaps(windows[i], window)) {
+        merge(window, windows[i]);
+        windows.erase(windows.begin() + i);
+        i = 0;
+      } else {
+        i++;
+      }
+    }
+    windows.push_back(window);
+  }
+}
+
+void RoiCrop::crop(
+  const sensor_msgs::msg::PointCloud2 & points, const std::vector<Window> & windows,
+  object_analytics_msgs::msg::CroppedPointCloud & cropped)
+{
+  if (!segmenter::PointCloud2View::isSupported(points)) {
+    throw std::runtime_error("point cloud without FLOAT32 x/y/z in host byte order");
+  }
+  segmenter::PointCloud2View view(points);
+  size_t n = 0;
+  for (auto & w : windows) {
+    if (w.x_offset + w.width > view.getWidth() || w.y_offset + w.height > view.getHeight()) {
+      throw std::runtime_error("crop window out of the point cloud");
+    }
+    n += static_cast<size_t>(w.width) * w.height;
+  }
+
+  cropped.header = points.header;
+  cropped.height = points.height;
+  cropped.width = points.width;
+  cropped.windows = windows;
+  cropped.points.header = points.header;
+  setXYZ(cropped.points, static_cast<uint32_t>(n), 1);
+
+  /* only the rows and columns of the windows are touched*/
+  uint8_t * out = cropped.points.data.data();
+  const size_t out_step = cropped.points.point_step;
+  for (auto & w : windows) {
+    for (uint32_t y = w.y_offset; y < w.y_offset + w.height; y++) {
+      size_t idx = static_cast<size_t>(y) * view.getWidth() + w.x_offset;
+      for (uint32_t x = 0; x < w.width; x++, idx++, out += out_step) {
+        segmenter::PointT p = view.at(idx);
+        float xyz[3] = {p.x, p.y, p.z};
+        std::memcpy(out, xyz, sizeof(xyz));
+      }
+    }
+  }
+}
+
+void RoiCrop::expand(
+  const object_analytics_msgs::msg::CroppedPointCloud & cropped,
+  sensor_msgs::msg::PointCloud2 & points, std::vector<Window> * written)
+{
+  size_t n = 0;
+  for (auto & w : cropped.windows) {
+    if (!inside(w, cropped.width, cropped.height)) {
+      throw std::runtime_error("crop window out of the point cloud");
+    }
+    n += static_cast<size_t>(w.width) * w.height;
+  }
+  if (n != static_cast<size_t>(cropped.points.width) * cropped.points.height ||
+    (n > 0 && !segmenter::PointCloud2View::isSupported(cropped.points)))
+  {
+    throw std::runtime_error("cropped points do not match the windows");
+  }
+
+  /* a cloud expanded before in the same layout is NaN but in the windows written then*/
+  bool reuse = written != nullptr && points.width == cropped.width &&
+    points.height == cropped.height;
+  for (size_t i = 0; reuse && i < written->size(); i++) {
+    reuse = inside((*written)[i], cropped.width, cropped.height);
+  }
+  const uint32_t old_step = points.point_step;
+  const size_t old_size = points.data.size();
+  const size_t old_fields = points.fields.size();
+  points.header = cropped.header;
+  setXYZ(points, cropped.width, cropped.height);
+  reuse = reuse && old_step == points.point_step && old_size == points.data.size() &&
+    old_fields == points.fields.size();
+
+  const size_t step = points.point_step;
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float invalid[3] = {nan, nan, nan};
+  uint8_t * out = points.data.data();
+  if (reuse) {
+    for (auto & w : *written) {
+      fillWindow(out, cropped.width, step, w, invalid);
+    }
+  } else {
+    for (size_t i = 0; i < points.data.size(); i += step) {
+      std::memcpy(out + i, invalid, sizeof(invalid));
+    }
+  }
+  if (written != nullptr) {
+    *written = cropped.windows;
+  }
+  if (n == 0) {
+    return;
+  }
+
+  segmenter::PointCloud2View view(cropped.points);
+  size_t idx = 0;
+  for (auto & w : cropped.windows) {
+    for (uint32_t y = w.y_offset; y < w.y_offset + w.height; y++) {
+      uint8_t * row = out + (static_cast<size_t>(y) * cropped.width + w.x_offset) * step;
+      for (uint32_t x = 0; x < w.width; x++, idx++, row += step) {
+        segmenter::PointT p = view.at(idx);
+        float xyz[3] = {p.x, p.y, p.z};
+        std::memcpy(row, xyz, sizeof(xyz));
+      }
+    }
+  }
+}
+}  // namespace util
+}  // namespace object_analytics_node
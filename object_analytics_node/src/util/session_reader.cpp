@@ -0,0 +1,153 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rclcpp/time.hpp>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/session_reader.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+SessionReader::SessionReader(const std::string & file)
+: in_(file), line_(0), pending_line_(0)
+{
+  if (!in_.is_open()) {
+    throw std::runtime_error("cannot open " + file);
+  }
+  dir_ = file.find('/') == std::string::npos ? "" : file.substr(0, file.rfind('/') + 1);
+}
+
+/* the whole field as a number, anything else is malformed*/
+template<typename T>
+static bool parse(const std::string & field, T & value)
+{
+  std::istringstream in(field);
+  in >> value;
+  return !in.fail() && in.eof();
+}
+
+bool SessionReader::next(Frame & frame)
+{
+  if (!error_.empty()) {
+    std::string error;
+    error.swap(error_);
+    throw std::runtime_error(error);
+  }
+  frame = Frame();
+  std::vector<std::string> f;
+  while (read(f)) {
+    int64_t stamp;
+    if (!parse(f[0], stamp)) {
+      /* a line of no stamp ends the frame read so far, the error comes with the next call*/
+      if (frame.objs) {
+        error_ = describe("bad stamp " + f[0]);
+        return true;
+      }
+      fail("bad stamp " + f[0]);
+    }
+    if (frame.objs && stamp != frame.stamp) {
+      pending_.swap(f);
+      pending_line_ = line_;
+      return true;
+    }
+    if (f.size() != 3 && f.size() != 9) {
+      fail("3 or 9 fields expected, " + std::to_string(f.size()) + " read");
+    }
+    if (f[1].empty()) {
+      fail("no image");
+    }
+    if (!frame.objs) {
+      frame.stamp = stamp;
+      frame.image = getPath(f[1]);
+      frame.pcd = f[2].empty() ? f[2] : getPath(f[2]);
+      frame.objs = std::make_shared<object_msgs::msg::ObjectsInBoxes>();
+      frame.objs->header.stamp = rclcpp::Time(stamp);
+      frame.objs->header.frame_id = "offline";
+    }
+    if (f.size() == 9) {
+      object_msgs::msg::ObjectInBox obj;
+      obj.object.object_name = f[3];
+      uint32_t roi[4];
+      if (!parse(f[4], obj.object.probability)) {
+        fail("bad probability " + f[4]);
+      }
+      for (size_t i = 0; i < 4; i++) {
+        /* read wide, no negative value wraps around*/
+        int64_t v;
+        if (!parse(f[5 + i], v) || v < 0 || v > std::numeric_limits<uint32_t>::max()) {
+          fail("bad roi " + f[5 + i]);
+        }
+        roi[i] = static_cast<uint32_t>(v);
+      }
+      obj.roi.x_offset = roi[0];
+      obj.roi.y_offset = roi[1];
+      obj.roi.width = roi[2];
+      obj.roi.height = roi[3];
+      frame.objs->objects_vector.push_back(obj);
+    }
+  }
+  return static_cast<bool>(frame.objs);
+}
+
+bool SessionReader::read(std::vector<std::string> & f)
+{
+  if (!pending_.empty()) {
+    f.swap(pending_);
+    pending_.clear();
+    line_ = pending_line_;
+    return true;
+  }
+  std::string line;
+  while (std::getline(in_, line)) {
+    line_++;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    f.clear();
+    std::istringstream fields(line);
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+      f.push_back(field);
+    }
+    /* an empty pcd at the end of the line*/
+    if (line.back() == ',') {
+      f.push_back("");
+    }
+    return true;
+  }
+  return false;
+}
+
+std::string SessionReader::getPath(const std::string & path) const
+{
+  return path[0] == '/' ? path : dir_ + path;
+}
+
+std::string SessionReader::describe(const std::string & what) const
+{
+  return "line " + std::to_string(line_) + ": " + what;
+}
+
+void SessionReader::fail(const std::string & what) const
+{
+  throw std::runtime_error(describe(what));
+}
+}  // namespace util
+}  // namespace object_analytics_node
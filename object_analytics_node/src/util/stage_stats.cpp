@@ -0,0 +1,96 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/stage_stats.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+const size_t StageStats::kBuckets;
+const int64_t StageStats::kBucketBoundsUs[] = {
+  50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000};
+
+std::mutex StageRegistry::mutex_;
+std::map<std::string, std::unique_ptr<StageStats>> StageRegistry::stages_;
+
+StageStats::StageStats(const std::string & name)
+: name_(name), count_(0), sum_ns_(0), max_ns_(0)
+{
+  for (auto & bucket : histogram_) {
+    bucket = 0;
+  }
+}
+
+void StageStats::record(int64_t ns)
+{
+  size_t bucket = 0;
+  while (bucket < kBuckets - 1 && ns > kBucketBoundsUs[bucket] * 1000) {
+    bucket++;
+  }
+  histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+  int64_t max = max_ns_.load(std::memory_order_relaxed);
+  while (ns > max && !max_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+  }
+}
+
+void StageStats::collect(object_analytics_msgs::msg::StageStats & msg)
+{
+  /* runs recorded meanwhile go to this or the next period, never lost*/
+  msg.name = name_;
+  msg.count = count_.exchange(0, std::memory_order_relaxed);
+  int64_t sum_ns = sum_ns_.exchange(0, std::memory_order_relaxed);
+  msg.max_ms = max_ns_.exchange(0, std::memory_order_relaxed) / 1e6;
+  msg.mean_ms = msg.count > 0 ? sum_ns / 1e6 / msg.count : 0.0;
+  msg.bucket_bounds_ms.resize(kBuckets - 1);
+  msg.histogram.resize(kBuckets);
+  for (size_t i = 0; i < kBuckets; i++) {
+    if (i < kBuckets - 1) {
+      msg.bucket_bounds_ms[i] = kBucketBoundsUs[i] / 1e3;
+    }
+    msg.histogram[i] = histogram_[i].exchange(0, std::memory_order_relaxed);
+  }
+}
+
+StageStats & StageRegistry::get(const std::string & name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<StageStats> & stats = stages_[name];
+  if (!stats) {
+    stats.reset(new StageStats(name));
+  }
+  return *stats;
+}
+
+void StageRegistry::collect(
+  const std::string & prefix, std::vector<object_analytics_msgs::msg::StageStats> & stages)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = stages_.lower_bound(prefix);
+    it != stages_.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+  {
+    stages.emplace_back();
+    it->second->collect(stages.back());
+  }
+}
+
+}  // namespace util
+}  // namespace object_analytics_node
@@ -0,0 +1,135 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <sched.h>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/thread_policy.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+bool ThreadPolicy::apply(pthread_t thread, std::string & error) const
+{
+  bool applied = true;
+  if (!cores.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto core : cores) {
+      if (core >= 0 && core < CPU_SETSIZE) {
+        CPU_SET(core, &set);
+      }
+    }
+    int err = pthread_setaffinity_np(thread, sizeof(set), &set);
+    if (err != 0) {
+      error = std::string("affinity: ") + std::strerror(err);
+      applied = false;
+    }
+  }
+  if (priority > 0) {
+    sched_param param;
+    param.sched_priority = priority;
+    int err = pthread_setschedparam(thread, SCHED_FIFO, &param);
+    if (err != 0) {
+      /* EPERM without CAP_SYS_NICE or an rtprio limit*/
+      error = (applied ? "" : error + ", ") + "SCHED_FIFO " + std::to_string(priority) + ": " +
+        std::strerror(err);
+      applied = false;
+    }
+  }
+  return applied;
+}
+
+std::vector<int> ThreadPolicy::parseCores(const std::string & list)
+{
+  std::vector<int> cores;
+  std::stringstream ss(list);
+  std::string core;
+  while (std::getline(ss, core, ',')) {
+    if (core.empty()) {
+      continue;
+    }
+    size_t end = 0;
+    int value;
+    try {
+      value = std::stoi(core, &end);
+    } catch (const std::out_of_range &) {
+      throw std::invalid_argument("core out of range: " + core);
+    }
+    if (end != core.size()) {
+      throw std::invalid_argument("core not a number: " + core);
+    }
+    cores.push_back(value);
+  }
+  return cores;
+}
+
+std::string ThreadPolicy::describe(pthread_t thread)
+{
+  std::stringstream ss;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  ss << "cores ";
+  if (pthread_getaffinity_np(thread, sizeof(set), &set) != 0) {
+    ss << "unknown";
+  } else {
+    /* ranges of consecutive cores, e.g. "0-3,6"*/
+    bool first = true;
+    for (int core = 0; core < CPU_SETSIZE; core++) {
+      if (!CPU_ISSET(core, &set)) {
+        continue;
+      }
+      int last = core;
+      while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set)) {
+        last++;
+      }
+      ss << (first ? "" : ",") << core;
+      if (last > core) {
+        ss << "-" << last;
+      }
+      first = false;
+      core = last;
+    }
+  }
+  int policy = SCHED_OTHER;
+  sched_param param;
+  param.sched_priority = 0;
+  pthread_getschedparam(thread, &policy, &param);
+  if (policy == SCHED_FIFO) {
+    ss << " SCHED_FIFO " << param.sched_priority;
+  } else if (policy == SCHED_RR) {
+    ss << " SCHED_RR " << param.sched_priority;
+  } else {
+    ss << " SCHED_OTHER";
+  }
+  return ss.str();
+}
+
+ThreadPolicy ThreadPolicy::declare(rclcpp::Node * node, const std::string & key)
+{
+  ThreadPolicy policy;
+  for (auto core : node->declare_parameter<std::vector<int64_t>>(key + "_cores",
+    std::vector<int64_t>()))
+  {
+    policy.cores.push_back(static_cast<int>(core));
+  }
+  policy.priority = node->declare_parameter<int32_t>(key + "_priority", 0);
+  return policy;
+}
+}  // namespace util
+}  // namespace object_analytics_node
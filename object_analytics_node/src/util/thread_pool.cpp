@@ -0,0 +1,174 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/thread_pool.hpp"
+
+namespace object_analytics_node
+{
+namespace util
+{
+ThreadPool::ThreadPool(size_t num_threads)
+: pending_(0), next_queue_(0), stop_(false)
+{
+  for (size_t i = 0; i < num_threads; i++) {
+    queues_.emplace_back(new TaskQueue());
+  }
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back(&ThreadPool::run, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  for (auto & t : threads_) {
+    t.join();
+  }
+}
+
+bool ThreadPool::setPolicy(const ThreadPolicy & policy, std::string & error)
+{
+  bool applied = true;
+  for (auto & t : threads_) {
+    if (!policy.apply(t.native_handle(), error)) {
+      applied = false;
+    }
+  }
+  return applied;
+}
+
+std::string ThreadPool::getPolicy()
+{
+  /* the workers share one policy, the first stands for all*/
+  return threads_.empty() ? "no workers" : ThreadPolicy::describe(threads_[0].native_handle());
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> & func)
+{
+  if (count == 0) {
+    return;
+  }
+
+  if (threads_.empty() || count == 1) {
+    for (size_t i = 0; i < count; i++) {
+      func(i);
+    }
+    return;
+  }
+
+  struct Batch
+  {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining;
+    std::exception_ptr error;
+  };
+  std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+  batch->remaining = count;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ += count;
+  }
+  for (size_t i = 0; i < count; i++) {
+    TaskQueue & q = *queues_[next_queue_++ % queues_.size()];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.tasks.emplace_back(
+      [batch, &func, i]() {
+        try {
+          func(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(batch->mutex);
+          if (!batch->error) {
+            batch->error = std::current_exception();
+          }
+        }
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        if (--batch->remaining == 0) {
+          batch->done.notify_all();
+        }
+      });
+  }
+  cond_.notify_all();
+
+  /* the caller helps draining the queues instead of idling*/
+  std::function<void()> task;
+  while (popTask(next_queue_ % queues_.size(), task)) {
+    task();
+  }
+
+  std::unique_lock<std::mutex> lock(batch->mutex);
+  batch->done.wait(lock, [&batch]() {return batch->remaining == 0;});
+  if (batch->error) {
+    std::rethrow_exception(batch->error);
+  }
+}
+
+bool ThreadPool::popTask(size_t index, std::function<void()> & task)
+{
+  {
+    TaskQueue & own = *queues_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.front());
+      own.tasks.pop_front();
+      pending_--;
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i < queues_.size(); i++) {
+    TaskQueue & victim = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      pending_--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::run(size_t index)
+{
+  std::function<void()> task;
+  while (true) {
+    if (popTask(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() {return stop_ || pending_ > 0;});
+    if (stop_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+}  // namespace util
+}  // namespace object_analytics_node
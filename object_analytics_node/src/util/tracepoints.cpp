@@ -12,32 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <string>
-#include <vector>
-
-#include "track_dataset.hpp"
-
-namespace datasets
-{
-cv::Ptr<trDataset> trDataset::create(dsType type)
-{
-  cv::Ptr<trDataset> nullp;
-  switch (type)
-  {
-    case dsSTVideo:
-      return cv::Ptr<vidDataset>(new vidDataset);
-    case dsSTImage:
-      return cv::Ptr<imgDataset>(new imgDataset);
-    case dsMTImage:
-      return cv::Ptr<imgMTDataset>(new imgMTDataset);
-    default:
-      return nullp;
-  }
-}
-
-int trDataset::getFrameIdx()
-{
-  return frameIdx;
-}
-
-}  // namespace datasets
+/* probes of the tracepoints, built into object_analytics_common with -DTRACING=ON*/
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+#include "object_analytics_node/util/tp_provider.hpp"
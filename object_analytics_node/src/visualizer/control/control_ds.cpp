@@ -18,6 +18,8 @@
 #include "render_ellipse.hpp"
 #include "render_image.hpp"
 
+const size_t ControlDS::kQueueSize = 4;
+
 ControlDS::ControlDS()
 {
   TRACE_INFO();
@@ -55,6 +57,33 @@ bool ControlDS::CreateContext()
     return ret;
   }
 
+  /*samplers are kept across frames*/
+  DataProc__ = std::make_shared<MathSample>();
+  ret = DataProc__->Initial(std::string("Gaussian"), std::string("RandomWalker"));
+  if (!ret)
+  {
+    TRACE_ERR("Data Proc initialize failed!!!");
+    return ret;
+  }
+
+  if (!ExportFile_.empty())
+  {
+    Export_ = std::make_shared<VideoExport>();
+    ret = Export_->Open(ExportFile_, im->frame.cols, im->frame.rows, ExportFps_);
+    if (!ret)
+    {
+      TRACE_ERR("Video export initialize failed!!!");
+      return ret;
+    }
+  }
+
+  /*headless runs through the stream as fast as it can*/
+  if (DataView_->IsHeadless())
+  {
+    PauseMode_ = false;
+    return ret;
+  }
+
   pangolin::RegisterKeyPressCallback(' ', [this]() { PlayMode(); });
   pangolin::RegisterKeyPressCallback('s', [this]() { StepIn(); });
   pangolin::RegisterKeyPressCallback('l', [this]() { DataView_->ChangeLayout(); });
@@ -75,77 +104,201 @@ void ControlDS::PlayMode()
   PauseMode_ = !PauseMode_;
 }
 
-void ControlDS::Run()
+void ControlDS::SetFrameRate(double fps)
 {
   TRACE_INFO();
 
-  while (!pangolin::ShouldQuit())
-  {
-    DataView_->Reset();
+  FramePeriodMSec_ = fps > 0 ? 1000.0 / fps : 0;
+}
+
+void ControlDS::SetExport(const std::string& file, double fps)
+{
+  TRACE_INFO();
 
-    if (!PauseMode_ || InitialScreen_)
+  ExportFile_ = file;
+  ExportFps_ = fps;
+}
+
+void ControlDS::CaptureStage()
+{
+  TRACE_INFO();
+
+  while (!Quit_)
+  {
+    std::shared_ptr<sFrame> im;
+    bool ret = StreamDev_->read(im);
+    if (!ret || im->frame.empty())
     {
-      InitialScreen_ = false;
+      TRACE_ERR("Can not get frame!!!");
+      break;
+    }
+    TRACE_INFO("frames queued %zu, dropped %llu", StreamDev_->get_queued(),
+               static_cast<unsigned long long>(StreamDev_->get_dropped()));
 
-      if (StepMode_)
-      {
-        StepMode_ = false;
-        PauseMode_ = true;
-      }
+    cv::cvtColor(im->frame, im->frame, CV_RGB2BGR);
 
-      std::shared_ptr<sFrame> im;
-      bool ret = StreamDev_->read(im);
-      if (!ret || im->frame.empty())
-      {
-        TRACE_ERR("Can not get frame!!!");
-        break;
-      }
+    if (!Frames_->Push(im))
+      break;
+  }
 
-      std::shared_ptr<FrameObjs> objs = std::dynamic_pointer_cast<FrameObjs>(im);
+  Frames_->Close();
+}
+
+void ControlDS::SceneStage()
+{
+  TRACE_INFO();
 
-      cv::cvtColor(im->frame, im->frame, CV_RGB2BGR);
+  std::shared_ptr<sFrame> im;
+  while (!Quit_ && Frames_->Pop(im))
+  {
+    RenderObject::Ptr img = BuildScene(im);
+    im = nullptr;
+    if (!Scenes_->Push(img))
+      break;
+  }
 
-      std::shared_ptr<RenderObject> img = std::make_shared<RenderImage>(im->frame.cols, im->frame.rows);
-      img->SetTexture(im->frame, std::to_string(objs->frame_idx));
+  Scenes_->Close();
+}
 
-      for (auto t : objs->dets)
+RenderObject::Ptr ControlDS::BuildScene(std::shared_ptr<sFrame>& im)
+{
+  TRACE_INFO();
+
+  std::shared_ptr<FrameObjs> objs = std::dynamic_pointer_cast<FrameObjs>(im);
+
+  /*render objects and textures are reused from the frames leaving the view*/
+  int cols = im->frame.cols;
+  int rows = im->frame.rows;
+  RenderObject::Ptr img = nullptr;
+  Recycled_->TryPop(img);
+  if (std::dynamic_pointer_cast<RenderImage>(img) == nullptr)
+  {
+    img = std::make_shared<RenderImage>(cols, rows);
+  }
+  img->Set2DDim(cols, rows);
+  img->SetTexture(im->frame, std::to_string(objs->frame_idx));
+  img->ClearSubObjs();
+
+  /*all objects of the frame are sampled in one batch*/
+  std::vector<cv::Mat> means, covariances, samples;
+  std::vector<cv::RotatedRect> ellipses;
+  for (auto& t : objs->dets)
+  {
+    means.push_back((cv::Mat_<double>(2, 1) << t.BoundBox_.tl().x, t.BoundBox_.tl().y));
+    covariances.push_back(
+        (cv::Mat_<double>(2, 2) << t.BoundBox_.width / 2, 10, 10, t.BoundBox_.height / 2));
+  }
+  DataProc__->GenBatchSamples(means, covariances, 50, samples, ellipses);
+
+  for (size_t i = 0; i < objs->dets.size(); i++)
+  {
+    auto& t = objs->dets[i];
+    std::shared_ptr<RenderRect> rect = img->AcquireSubObj<RenderRect>(cols, rows);
+    rect->SetRect(t.BoundBox_);
+    rect->SetID(std::to_string(t.ObjectIdx_));
+
+    std::shared_ptr<RenderLines> lines = img->AcquireSubObj<RenderLines>(cols, rows);
+    lines->SetVertices(samples[i]);
+    lines->SetID(std::to_string(t.ObjectIdx_));
+
+    std::shared_ptr<RenderEllipse> ellipse = img->AcquireSubObj<RenderEllipse>(cols, rows);
+    ellipse->SetID(std::to_string(t.ObjectIdx_));
+    ellipse->SetEllipse(ellipses[i]);
+    ellipse->SetStipple(true);
+  }
+
+  return img;
+}
+
+void ControlDS::Run()
+{
+  TRACE_INFO();
+
+  /*capture and scene building run on their own threads, the GL context
+   *stays with this one*/
+  Quit_ = false;
+  Frames_.reset(new StageQueue<std::shared_ptr<sFrame>>(kQueueSize));
+  Scenes_.reset(new StageQueue<RenderObject::Ptr>(kQueueSize));
+  Recycled_.reset(new StageQueue<RenderObject::Ptr>(kQueueSize));
+  std::thread capture(&ControlDS::CaptureStage, this);
+  std::thread scene(&ControlDS::SceneStage, this);
+
+  bool headless = DataView_->IsHeadless();
+  std::chrono::steady_clock::time_point due = std::chrono::steady_clock::now();
+  while (headless || !pangolin::ShouldQuit())
+  {
+    bool shown = false;
+    if (headless)
+    {
+      /*every scene is rendered, with no pacing*/
+      RenderObject::Ptr img = nullptr;
+      if (!Scenes_->Pop(img))
+        break;
+
+      RenderObject::Ptr old = DataView_->Recycle_Obj();
+      if (old != nullptr)
+        Recycled_->TryPush(old);
+      DataView_->Add_Obj(img);
+      shown = true;
+    }
+    else if (!PauseMode_ || InitialScreen_)
+    {
+      /*one scene at most per frame period, the display keeps refreshing in between*/
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      RenderObject::Ptr img = nullptr;
+      if (now >= due && Scenes_->TryPop(img))
       {
-        std::shared_ptr<RenderRect> rect = std::make_shared<RenderRect>(im->frame.cols, im->frame.rows);
-        rect->SetRect(t.BoundBox_);
-        rect->SetID(std::to_string(t.ObjectIdx_));
-        img->AddSubObj(rect);
-
-        double mean[] = { t.BoundBox_.tl().x, t.BoundBox_.tl().y };
-        double covariance[] = { t.BoundBox_.width / 2, 10, 10, t.BoundBox_.height / 2 };
-        cv::Mat Mean(2, 1, CV_64FC1, &mean);
-        cv::Mat Covariance(2, 2, CV_64FC1, &covariance);
-
-        MathSample sample_math;
-        cv::Mat Sample;
-        if (sample_math.Initial(std::string("Gaussian"), std::string("RandomWalker")))
+        InitialScreen_ = false;
+
+        if (StepMode_)
         {
-          sample_math.SetMeanAndCovariance(Mean, Covariance, 50);
-          sample_math.GenSamples();
-          sample_math.FetchSamples(Sample);
+          StepMode_ = false;
+          PauseMode_ = true;
         }
 
-        std::shared_ptr<RenderObject> lines = std::make_shared<RenderLines>(im->frame.cols, im->frame.rows);
-        lines->SetVertices(Sample);
-        lines->SetID(std::to_string(t.ObjectIdx_));
-        img->AddSubObj(lines);
+        RenderObject::Ptr old = DataView_->Recycle_Obj();
+        if (old != nullptr)
+          Recycled_->TryPush(old);
+        DataView_->Add_Obj(img);
+        shown = true;
 
-        std::shared_ptr<RenderEllipse> ellipse = std::make_shared<RenderEllipse>(im->frame.cols, im->frame.rows);
-        ellipse->SetID(std::to_string(t.ObjectIdx_));
-        ellipse->SetEllipse(sample_math.GetCovEllipse());
-        ellipse->SetStipple(true);
-        img->AddSubObj(ellipse);
+        std::chrono::duration<double, std::milli> period(FramePeriodMSec_);
+        due += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+        /*no burst to catch up after a stall*/
+        if (due < now)
+          due = now;
+      }
+      else if (Scenes_->Drained())
+      {
+        break;
       }
-
-      DataView_->Add_Obj(img);
     }
 
+    /*only frames showing a new scene are exported*/
+    bool exported = shown && Export_ != nullptr;
+    if (exported)
+      Export_->Begin();
+
+    DataView_->Reset();
     DataView_->Render();
 
-    pangolin::FinishFrame();
+    if (exported)
+      Export_->End(!headless);
+
+    if (!headless)
+      pangolin::FinishFrame();
   }
+
+  if (Export_ != nullptr)
+  {
+    Export_->Close();
+    TRACE_INFO("Exported %ld frames", (long)Export_->GetWritten());
+  }
+
+  Quit_ = true;
+  Scenes_->Close();
+  Frames_->Close();
+  StreamDev_->release_stream();
+  capture.join();
+  scene.join();
 }
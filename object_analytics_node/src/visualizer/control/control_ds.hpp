@@ -16,9 +16,11 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/opencv.hpp>
@@ -29,6 +31,9 @@
 
 #include "control.hpp"
 #include "frame_obj.hpp"
+#include "render_object.hpp"
+#include "stage_queue.hpp"
+#include "video_export.hpp"
 
 class ControlDS : public Control{
  public:
@@ -52,9 +57,22 @@ class ControlDS : public Control{
 
   /**
    * @brief Run the pipeline as data->process->display
+   *
+   * Capture and color conversion, then sampling and scene building, run on
+   * threads of their own, connected by bounded queues. This thread renders.
    */
   virtual void Run();
 
+  /**
+   * @brief Show new frames at most at this rate, 0 for every display refresh
+   */
+  void SetFrameRate(double fps);
+
+  /**
+   * @brief Encode the frames shown into a video file, opened in CreateContext()
+   */
+  void SetExport(const std::string& file, double fps);
+
   /**
    * @brief Step into next new frame 
    */
@@ -70,4 +88,31 @@ class ControlDS : public Control{
   bool PauseMode_ = true;
   bool InitialScreen_ = true;
 
+ private:
+  /**
+   * @brief Read frames and convert their colors, the first stage
+   */
+  void CaptureStage();
+
+  /**
+   * @brief Sample the objects and build the scenes, the second stage
+   */
+  void SceneStage();
+
+  /**
+   * @brief Build the render object of a frame, reusing a recycled one
+   */
+  RenderObject::Ptr BuildScene(std::shared_ptr<sFrame>& im);
+
+  static const size_t kQueueSize;
+
+  double FramePeriodMSec_ = 0;
+  std::string ExportFile_;
+  double ExportFps_ = 0;
+  VideoExport::Ptr Export_ = nullptr;
+  std::atomic_bool Quit_ = {false};
+  std::unique_ptr<StageQueue<std::shared_ptr<sFrame>>> Frames_;
+  std::unique_ptr<StageQueue<RenderObject::Ptr>> Scenes_;
+  /*render objects leaving the view, back to the scene stage*/
+  std::unique_ptr<StageQueue<RenderObject::Ptr>> Recycled_;
 };
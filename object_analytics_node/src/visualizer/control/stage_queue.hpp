@@ -0,0 +1,128 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "frame_ring.hpp"
+
+/**
+ * @brief Bounded queue between two stages of the viewer pipeline.
+ *
+ * Items are swapped through a frame_ring, a producer blocks while the queue
+ * is full and a consumer while it is empty. Once closed, pushes fail and pops
+ * drain what is left, so a stage ends after its upstream did.
+ */
+template <typename T>
+class StageQueue {
+ public:
+  explicit StageQueue(size_t depth) : Ring_(depth) {}
+
+  /**
+   * @brief Push an item, waiting while full, false once closed
+   */
+  bool Push(T& item)
+  {
+    while (!Ring_.push(item))
+    {
+      std::unique_lock<std::mutex> lock(Mutex_);
+      if (Closed_)
+        return false;
+      /*notified without the lock, the timeout covers a missed wakeup*/
+      NotFull_.wait_for(lock, std::chrono::milliseconds(kWaitTimeMSec),
+                        [&]() { return Ring_.size() < Ring_.depth() || Closed_; });
+    }
+    NotEmpty_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Push an item if there is room, without waiting
+   */
+  bool TryPush(T& item)
+  {
+    if (!Ring_.push(item))
+      return false;
+    NotEmpty_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Pop the oldest item, waiting while empty, false once closed and drained
+   */
+  bool Pop(T& item)
+  {
+    while (!Ring_.pop(item))
+    {
+      std::unique_lock<std::mutex> lock(Mutex_);
+      if (Closed_)
+        return Ring_.pop(item);
+      NotEmpty_.wait_for(lock, std::chrono::milliseconds(kWaitTimeMSec),
+                         [&]() { return Ring_.size() > 0 || Closed_; });
+    }
+    NotFull_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Pop the oldest item if any, without waiting
+   */
+  bool TryPop(T& item)
+  {
+    if (!Ring_.pop(item))
+      return false;
+    NotFull_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Close the queue, waking up the stages waiting on it
+   */
+  void Close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(Mutex_);
+      Closed_ = true;
+    }
+    NotFull_.notify_all();
+    NotEmpty_.notify_all();
+  }
+
+  /**
+   * @brief Closed and nothing left to pop
+   */
+  bool Drained()
+  {
+    std::lock_guard<std::mutex> lock(Mutex_);
+    return Closed_ && Ring_.size() == 0;
+  }
+
+  size_t Size() const { return Ring_.size(); }
+
+ private:
+  static const int kWaitTimeMSec = 10;
+
+  frame_ring<T> Ring_;
+  std::mutex Mutex_;
+  std::condition_variable NotFull_;
+  std::condition_variable NotEmpty_;
+  bool Closed_ = false;
+};
+
+template <typename T>
+const int StageQueue<T>::kWaitTimeMSec;
@@ -0,0 +1,138 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free ring of preallocated slots.
+ *
+ * Positions are claimed with a CAS and each slot carries a sequence number,
+ * so a slot is never written while being read. Items are swapped in and out
+ * of the slots instead of copied: push() hands back the previous content of
+ * the slot and pop() hands back the item the caller gave, so buffers are
+ * recycled between the producer and the consumer. One producer and one
+ * consumer are expected, the producer may also pop to drop the oldest item.
+ */
+template <typename T>
+class frame_ring {
+ public:
+  /**
+   * @brief Create a ring of depth slots, depth shall be at least 1
+   */
+  explicit frame_ring(size_t depth)
+      : cells_(depth > 0 ? depth : 1), push_pos_(0), pop_pos_(0)
+  {
+    for (size_t i = 0; i < cells_.size(); i++)
+    {
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Swap an item into the ring, false if full
+   */
+  bool push(T& item)
+  {
+    size_t pos = push_pos_.load(std::memory_order_relaxed);
+    cell* c = nullptr;
+    for (;;)
+    {
+      c = &cells_[pos % cells_.size()];
+      size_t seq = c->seq.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (push_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = push_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    std::swap(c->item, item);
+    c->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Swap the oldest item out of the ring, false if empty
+   */
+  bool pop(T& item)
+  {
+    size_t pos = pop_pos_.load(std::memory_order_relaxed);
+    cell* c = nullptr;
+    for (;;)
+    {
+      c = &cells_[pos % cells_.size()];
+      size_t seq = c->seq.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0)
+      {
+        if (pop_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = pop_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    std::swap(c->item, item);
+    c->seq.store(pos + cells_.size(), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Number of items in the ring, approximate while being updated
+   */
+  size_t size() const
+  {
+    size_t push = push_pos_.load(std::memory_order_acquire);
+    size_t pop = pop_pos_.load(std::memory_order_acquire);
+    return push > pop ? push - pop : 0;
+  }
+
+  /**
+   * @brief Number of slots of the ring
+   */
+  size_t depth() const { return cells_.size(); }
+
+ private:
+  struct cell {
+    std::atomic<size_t> seq;
+    T item;
+  };
+
+  std::vector<cell> cells_;
+  std::atomic<size_t> push_pos_;
+  std::atomic<size_t> pop_pos_;
+};
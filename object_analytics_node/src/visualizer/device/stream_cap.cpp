@@ -17,6 +17,9 @@
 stream_cap::stream_cap()
 {
   TRACE_INFO();
+
+  /*a live camera keeps the latest frames rather than lagging behind*/
+  policy_ = drop_oldest;
 }
 
 stream_cap::~stream_cap()
@@ -28,7 +31,7 @@ bool stream_cap::init_stream(int stream_name)
 {
   TRACE_INFO();
 
-  //	stream_name_ =  stream_name;
+  camera_ = stream_name;
   cap_ = std::make_shared<cv::VideoCapture>(stream_name);
 
   if (cap_->isOpened())
@@ -41,8 +44,9 @@ bool stream_cap::init_stream(std::string& stream_name)
 {
   TRACE_INFO();
 
-  //	stream_name_ =  stream_name;
-  cap_ = std::make_shared<cv::VideoCapture>(stream_name, cv::CAP_FFMPEG);
+  camera_ = -1;
+  stream_name_ = stream_name;
+  cap_ = open_capture(stream_name, cv::CAP_FFMPEG);
 
   if (cap_->isOpened())
     return true;
@@ -53,7 +57,6 @@ bool stream_cap::init_stream(std::string& stream_name)
 bool stream_cap::reset_stream()
 {
   TRACE_INFO();
-  return true;
 
   if (cap_ != nullptr)
   {
@@ -63,9 +66,12 @@ bool stream_cap::reset_stream()
     }
     cap_.reset();
   }
-  init_stream(stream_name_);
 
-  return true;
+  if (camera_ >= 0)
+  {
+    return init_stream(camera_);
+  }
+  return init_stream(stream_name_);
 }
 
 bool stream_cap::fetch_frame(std::shared_ptr<sFrame>& frame)
@@ -80,8 +86,12 @@ bool stream_cap::fetch_frame(std::shared_ptr<sFrame>& frame)
 
   cv::Mat frame_cap;
   ret = cap_->read(frame_cap);
+  /*reuse the recycled frame unless the viewer still holds it*/
+  if (frame == nullptr || frame.use_count() > 1)
+  {
+    frame = std::make_shared<sFrame>();
+  }
 
-  frame = std::make_shared<sFrame>();
   frame->genFrame(frame_cap);
 
   return ret;
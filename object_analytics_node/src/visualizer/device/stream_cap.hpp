@@ -50,6 +50,13 @@ class stream_cap : public stream_device {
    */
   virtual bool fetch_frame(std::shared_ptr<sFrame> &frame);
 
+  /**
+   * @brief Cameras are live, reconnected after a failure
+   */
+  virtual bool is_live() const { return true; }
+
  protected:
  private:
+  /*index of a USB camera, -1 for a named stream*/
+  int camera_ = -1;
 };
@@ -16,6 +16,9 @@
 #include "stream_cap.hpp"
 #include "stream_ds.hpp"
 #include "stream_vid.hpp"
+#ifdef OA_VIEWER_ROS
+#include "stream_ros.hpp"
+#endif
 
 stream_device::stream_device()
 {
@@ -59,6 +62,7 @@ stream_device::Ptr stream_device::create(std::string& stream_name)
 
   stream_device::Ptr stream_dev = nullptr;
 
+  decode_backend decode = parse_decode(stream_name);
   std::size_t found = stream_name.find("rtsp://");
   if (found != std::string::npos)
   {
@@ -74,6 +78,13 @@ stream_device::Ptr stream_device::create(std::string& stream_name)
       /*create stream device for dataset*/
       stream_dev = std::make_shared<stream_ds>();
     }
+#ifdef OA_VIEWER_ROS
+    else if (stream_name.find("ros://") == 0)
+    {
+      /*create stream device for the live object analytics topics*/
+      stream_dev = std::make_shared<stream_ros>();
+    }
+#endif
     else
     {
       /*create stream device for video file*/
@@ -83,6 +94,7 @@ stream_device::Ptr stream_device::create(std::string& stream_name)
 
   if (stream_dev != nullptr)
   {
+    stream_dev->decode_ = decode;
     if (!stream_dev->init_stream(stream_name))
     {
       stream_dev.reset();
@@ -96,6 +108,89 @@ stream_device::Ptr stream_device::create(std::string& stream_name)
   return stream_dev;
 }
 
+stream_device::decode_backend stream_device::parse_decode(std::string& stream_name)
+{
+  decode_backend decode = decode_sw;
+  std::size_t query = stream_name.find('?');
+  if (query == std::string::npos)
+  {
+    return decode;
+  }
+
+  /*keep the other parameters of the query*/
+  std::string kept;
+  std::size_t begin = query + 1;
+  while (begin <= stream_name.size())
+  {
+    std::size_t end = stream_name.find('&', begin);
+    if (end == std::string::npos)
+    {
+      end = stream_name.size();
+    }
+    std::string param = stream_name.substr(begin, end - begin);
+    if (param.compare(0, 3, "hw=") == 0)
+    {
+      std::string value = param.substr(3);
+      if (value == "vaapi")
+      {
+        decode = decode_vaapi;
+      }
+      else if (value != "0" && !value.empty())
+      {
+        decode = decode_auto;
+      }
+    }
+    else if (!param.empty())
+    {
+      kept += (kept.empty() ? "?" : "&") + param;
+    }
+    begin = end + 1;
+  }
+  stream_name = stream_name.substr(0, query) + kept;
+
+  return decode;
+}
+
+std::shared_ptr<cv::VideoCapture> stream_device::open_capture(const std::string& name, int api)
+{
+  TRACE_INFO();
+
+  std::shared_ptr<cv::VideoCapture> cap;
+  if (decode_ != decode_sw)
+  {
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR > 5) || \
+    (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 2)
+    /*VA-API/oneVPL decode of the FFmpeg backend*/
+    if (decode_ == decode_auto)
+    {
+      cap = std::make_shared<cv::VideoCapture>(
+          name, cv::CAP_FFMPEG,
+          std::vector<int>{ cv::CAP_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY });
+      if (cap->isOpened())
+      {
+        return cap;
+      }
+    }
+#endif
+    /*decodebin prefers the VA-API decoders when installed, surfaces are
+     *mapped to system memory once by vaapipostproc*/
+    std::string source = name.find("://") != std::string::npos ?
+                             "rtspsrc location=" + name + " latency=0" :
+                             "filesrc location=" + name;
+    std::string pipeline = source +
+                           " ! decodebin ! vaapipostproc ! video/x-raw,format=BGRx"
+                           " ! videoconvert ! video/x-raw,format=BGR ! appsink sync=false";
+    cap = std::make_shared<cv::VideoCapture>(pipeline, cv::CAP_GSTREAMER);
+    if (cap->isOpened())
+    {
+      return cap;
+    }
+    TRACE_ERR("hardware decode not available, decode %s by software", name.c_str());
+  }
+
+  return std::make_shared<cv::VideoCapture>(name, api);
+}
+
 void stream_device::release_stream()
 {
   TRACE_INFO();
@@ -104,6 +199,7 @@ void stream_device::release_stream()
   {
     terminate = true;
     condVar.notify_one();
+    hasFrame.notify_one();
     if (workThread.joinable())
     {
       workThread.join();
@@ -114,6 +210,120 @@ void stream_device::release_stream()
   }
 }
 
+void stream_device::set_queue(size_t depth, drop_policy policy)
+{
+  TRACE_INFO();
+
+  queueSize = depth > 0 ? depth : 1;
+  policy_ = policy;
+}
+
+void stream_device::set_reconnect(size_t min_msec, size_t max_msec, size_t max_retries)
+{
+  TRACE_INFO();
+
+  backoffMinMSec = min_msec > 0 ? min_msec : 1;
+  backoffMaxMSec = std::max(max_msec, backoffMinMSec);
+  maxRetries = max_retries;
+}
+
+stream_device::stream_health stream_device::get_health() const
+{
+  stream_health health;
+  health.failures = failures_;
+  health.reconnects = reconnects_;
+  health.reconnect_failures = reconnect_failures_;
+  return health;
+}
+
+bool stream_device::recover(frame_slot& slot)
+{
+  /*a video file or dataset fails at its end, only live streams come back*/
+  if (!is_live())
+  {
+    TRACE_INFO("\t stream ended");
+    return false;
+  }
+
+  size_t backoff = backoffMinMSec;
+  size_t retries = 0;
+  while (!terminate)
+  {
+    failures_++;
+    if (maxRetries > 0 && retries >= maxRetries)
+    {
+      TRACE_ERR("\t fetch frame failed, gave up after %ld reconnects!", retries);
+      return false;
+    }
+
+    /*reconnected on the fetch thread, the reader keeps the queued frames*/
+    retries++;
+    if (reset_stream())
+    {
+      reconnects_++;
+    }
+    else
+    {
+      reconnect_failures_++;
+    }
+    if (fetch_frame(slot.frame))
+    {
+      return true;
+    }
+
+    TRACE_ERR("\t fetch frame failed, retry in %ld ms", backoff);
+    std::unique_lock<std::mutex> lock(mutex);
+    condVar.wait_for(lock, std::chrono::milliseconds(backoff), [&]() { return terminate.load(); });
+    backoff = std::min(backoff * 2, backoffMaxMSec);
+  }
+  return false;
+}
+
+bool stream_device::enqueue(frame_slot& slot)
+{
+  while (!ring_->push(slot))
+  {
+    if (policy_ == drop_oldest)
+    {
+      frame_slot oldest;
+      if (ring_->pop(oldest))
+      {
+        dropped_++;
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (terminate)
+    {
+      return false;
+    }
+    /*the reader notifies without the lock, the timeout covers a missed wakeup*/
+    condVar.wait_for(lock, std::chrono::milliseconds(waitTimeMSec),
+                     [&]() { return ring_->size() < ring_->depth() || terminate; });
+  }
+  TRACE_INFO("Stream PUSH, QUEUE SIZE(%ld)", ring_->size());
+  hasFrame.notify_one();
+  return true;
+}
+
+bool stream_device::dequeue(frame_slot& slot)
+{
+  while (!ring_->pop(slot))
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (terminate)
+    {
+      return false;
+    }
+    hasFrame.wait_for(lock, std::chrono::milliseconds(waitTimeMSec),
+                      [&]() { return ring_->size() > 0 || terminate; });
+  }
+  TRACE_INFO("Stream POP, QUEUE SIZE(%ld)", ring_->size());
+  condVar.notify_one();
+  return true;
+}
+
 bool stream_device::process()
 {
   TRACE_INFO();
@@ -122,42 +332,26 @@ bool stream_device::process()
   if (initialized_ && isAsync)
   {
     terminate = false;
+    ring_.reset(new frame_ring<frame_slot>(queueSize));
     workThread = std::thread([&]() {
+      /*swapped with a queued slot on each push, frames are recycled*/
+      frame_slot next;
       while (!terminate)
       {
+        if (!fetch_frame(next.frame) && !recover(next))
         {
-          std::shared_ptr<sFrame> frame;
-          bool result = false;
-          while (!((result = fetch_frame(frame)) || terminate))
+          if (!terminate)
           {
-            TRACE_ERR("\t fetch frame failed!");
-
-            std::unique_lock<std::mutex> lock(mutex);
-            if (queue.empty() || queue.back().first)
-            {
-              queue.push({ false, frame });
-              lock.unlock();
-              hasFrame.notify_one();
-              reset_stream();
-              lock.lock();
-            }
-
-            std::chrono::milliseconds timeout(pollingTimeMSec);
-            condVar.wait_for(lock, timeout, [&]() {
-              terminate.store(true);
-              return terminate.load();
-            });
+            /*tell the reader the stream is gone*/
+            frame_slot failed;
+            failed.frame = next.frame;
+            enqueue(failed);
           }
-
-          std::unique_lock<std::mutex> lock(mutex);
-          condVar.wait(lock, [&]() { return queue.size() < queueSize || terminate; });
-
-          if (queue.size() == queueSize)
-            queue.pop();
-          queue.push({ result, frame });
-          TRACE_INFO("Stream PUSH, QUEUE SIZE(%ld)", queue.size());
+          break;
         }
-        hasFrame.notify_one();
+
+        next.ok = true;
+        enqueue(next);
       }
     });
     ret = true;
@@ -171,23 +365,13 @@ bool stream_device::read(std::shared_ptr<sFrame>& frame)
   TRACE_INFO();
   if (isAsync)
   {
-    size_t count = 0;
-    bool res = false;
+    if (!has_pending_ && !dequeue(pending_))
     {
-      std::unique_lock<std::mutex> lock(mutex);
-      hasFrame.wait(lock, [&]() { return !queue.empty() || terminate; });
-      res = queue.front().first;
-      frame = queue.front().second;
-      if (queue.size() > 0)
-      {
-        queue.pop();
-      }
-      count = queue.size();
-      TRACE_INFO("Stream POP, QUEUE SIZE(%ld)", count);
-      (void)count;
+      return false;
     }
-    condVar.notify_one();
-    return res;
+    has_pending_ = false;
+    frame = pending_.frame;
+    return pending_.ok;
   }
   else
   {
@@ -200,18 +384,17 @@ bool stream_device::query(std::shared_ptr<sFrame>& frame)
   TRACE_INFO();
   if (isAsync)
   {
-    size_t count = 0;
-    bool res = false;
+    /*kept aside, the next read() returns the same frame*/
+    if (!has_pending_)
     {
-      std::unique_lock<std::mutex> lock(mutex);
-      hasFrame.wait(lock, [&]() { return !queue.empty() || terminate; });
-      res = queue.front().first;
-      frame = queue.front().second;
-      count = queue.size();
-      TRACE_INFO("Stream POP, QUEUE SIZE(%ld)", count);
-      (void)count;
+      if (!dequeue(pending_))
+      {
+        return false;
+      }
+      has_pending_ = true;
     }
-    return res;
+    frame = pending_.frame;
+    return pending_.ok;
   }
   else
   {
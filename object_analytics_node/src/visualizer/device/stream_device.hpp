@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -22,7 +23,6 @@
 #include <iterator>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <random>
 #include <string>
 #include <thread>
@@ -31,6 +31,7 @@
 #include <opencv2/opencv.hpp>
 
 #include "frame.hpp"
+#include "frame_ring.hpp"
 #include "utility.hpp"
 
 class stream_device {
@@ -50,6 +51,10 @@ class stream_device {
 
   /**
    * @brief Create stream device
+   *
+   * Videos and RTSP streams take a decode option in the query of the name,
+   * e.g. "rtsp://host/stream?hw=1", see decode_backend. The option is
+   * removed from the name before it is opened.
    */
   stream_device::Ptr create(std::string &stream_name);
 
@@ -84,6 +89,11 @@ class stream_device {
    */
   virtual bool fetch_frame(std::shared_ptr<sFrame> &frame) = 0;
 
+  /**
+   * @brief If the stream is live, reconnected until it comes back
+   */
+  virtual bool is_live() const { return false; }
+
   /**
    * @brief Start fetch frames to queue in async mode
    */
@@ -99,27 +109,130 @@ class stream_device {
    */
   bool query(std::shared_ptr<sFrame>& frame);
 
+  /**
+   * @brief Decoder of videos and RTSP streams, option "hw" of the name
+   */
+  enum decode_backend {
+    decode_sw,     /**< "hw=0" or none, software decode of the default backend*/
+    decode_auto,   /**< "hw=1", any hardware decode available*/
+    decode_vaapi   /**< "hw=vaapi", VA-API decode through GStreamer*/
+  };
+
+  /**
+   * @brief Take the decode option out of a stream name
+   */
+  static decode_backend parse_decode(std::string &stream_name);
+
+  /**
+   * @brief What the fetch thread does when the queue is full
+   */
+  enum drop_policy {
+    block,       /**< wait for the reader, no frame is dropped*/
+    drop_oldest  /**< drop the oldest queued frame, for live streams*/
+  };
+
+  /**
+   * @brief Set the depth and policy of the frame queue, before process()
+   */
+  void set_queue(size_t depth, drop_policy policy);
+
+  /**
+   * @brief Number of frames dropped for a full queue
+   */
+  uint64_t get_dropped() const { return dropped_; }
+
+  /**
+   * @brief Number of frames decoded ahead in the queue
+   */
+  size_t get_queued() const { return ring_ ? ring_->size() : 0; }
+
+  /**
+   * @brief Set the backoff between reconnects after a failed fetch
+   *
+   * Only live streams reconnect, a video file or dataset ends at its first
+   * failed fetch. The wait starts at min_msec and doubles up to max_msec,
+   * until a frame is fetched again, and the stream gives up after max_retries
+   * reconnects, 0 to retry forever.
+   */
+  void set_reconnect(size_t min_msec, size_t max_msec, size_t max_retries);
+
+  /**
+   * @brief Health counters of the fetch thread
+   */
+  struct stream_health {
+    uint64_t failures;            /**< fetches failed*/
+    uint64_t reconnects;          /**< reconnects succeeded*/
+    uint64_t reconnect_failures;  /**< reconnects failed*/
+  };
+
+  /**
+   * @brief Get the health counters, safe from any thread
+   */
+  stream_health get_health() const;
+
  protected:
   /*TBD: consolidate to stream_params*/
   std::string stream_name_;
   const bool isAsync = true;
 
   std::shared_ptr<cv::VideoCapture> cap_;
+  decode_backend decode_ = decode_sw;
+
+  /**
+   * @brief Open a video or stream with the decode backend, software if unavailable
+   */
+  std::shared_ptr<cv::VideoCapture> open_capture(const std::string &name, int api);
 
   std::thread workThread;
   std::atomic_bool terminate = {false};
   std::string videoName;
 
+  /*a queued frame, and if it was fetched successfully*/
+  struct frame_slot {
+    bool ok = false;
+    std::shared_ptr<sFrame> frame;
+  };
+
+  /*mutex and conditions only for sleeping, frames go through the ring*/
   std::mutex mutex;
   std::condition_variable condVar;
   std::condition_variable hasFrame;
-  std::queue<std::pair<bool, std::shared_ptr<sFrame>>> queue;
+  std::unique_ptr<frame_ring<frame_slot>> ring_;
+  std::atomic<uint64_t> dropped_ = {0};
 
   bool realFps = false;
 
-  const size_t queueSize = 1;
-  const size_t pollingTimeMSec = 1000;
+  size_t queueSize = 4;
+  drop_policy policy_ = block;
+  size_t backoffMinMSec = 50;
+  size_t backoffMaxMSec = 5000;
+  size_t maxRetries = 0;
+  const size_t waitTimeMSec = 10;
 
- private:
+  std::atomic<uint64_t> failures_ = {0};
+  std::atomic<uint64_t> reconnects_ = {0};
+  std::atomic<uint64_t> reconnect_failures_ = {0};
+
+  /*set by create() once init_stream() succeeded, process() needs it*/
   bool initialized_ = false;
+
+ private:
+  /**
+   * @brief Queue a slot as the policy says, the slot is recycled
+   */
+  bool enqueue(frame_slot& slot);
+
+  /**
+   * @brief Wait for a queued slot, false on terminate
+   */
+  bool dequeue(frame_slot& slot);
+
+  /**
+   * @brief Retry a failed fetch with backoff, false if given up or terminated
+   */
+  bool recover(frame_slot& slot);
+
+  /*slot taken by query() and not read yet*/
+  frame_slot pending_;
+  bool has_pending_ = false;
 };
@@ -16,6 +16,8 @@
 #include "object.hpp"
 #include "frame_obj.hpp"
 
+const size_t stream_ds::kPrefetchFrames = 8;
+
 stream_ds::stream_ds()
 {
   TRACE_INFO();
@@ -47,6 +49,8 @@ bool stream_ds::init_stream(std::string& stream_name)
   TRACE_INFO("dataset name(%s)", dsName.c_str());
 
   ds_ = ds_->create(datasets::dsMTImage);
+  // Decode ahead, the display is paced by tracking rather than by the disk
+  ds_->setPrefetch(kPrefetchFrames);
   ds_->load(path);
 
   if (ds_->initDataset(dsName))
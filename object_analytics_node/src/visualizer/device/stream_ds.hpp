@@ -25,7 +25,7 @@
 #include <opencv2/opencv.hpp>
 
 #include "stream_device.hpp"
-#include "track_dataset.hpp"
+#include "object_analytics_node/dataset/track_dataset.hpp"
 
 class stream_ds : public stream_device {
  public:
@@ -58,6 +58,7 @@ class stream_ds : public stream_device {
   virtual bool fetch_frame(std::shared_ptr<sFrame> &frame);
 
  protected:
+  static const size_t kPrefetchFrames;
   cv::Ptr<datasets::trDataset> ds_;
 
  private:
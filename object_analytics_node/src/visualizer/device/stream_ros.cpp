@@ -0,0 +1,251 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cv_bridge/cv_bridge.h>
+
+#include "stream_ros.hpp"
+#include "frame_obj.hpp"
+
+const size_t stream_ros::kMatchedFrames = 4;
+const size_t stream_ros::kImageBytes = 64 * 1024 * 1024;
+const size_t stream_ros::kWaitMSec = 100;
+
+namespace
+{
+/*a frame holding the message its image is shared with*/
+class ros_frame : public FrameObjs {
+ public:
+  cv_bridge::CvImageConstPtr image;
+};
+
+Object to_object(int64_t id, float probability, const sensor_msgs::msg::RegionOfInterest& roi)
+{
+  Object obj;
+  obj.ObjectIdx_ = static_cast<int>(id);
+  obj.Confidence = probability;
+  obj.BoundBox_ = cv::Rect2d(roi.x_offset, roi.y_offset, roi.width, roi.height);
+  return obj;
+}
+
+int64_t to_nsec(const builtin_interfaces::msg::Time& stamp)
+{
+  return rclcpp::Time(stamp).nanoseconds();
+}
+}  // namespace
+
+stream_ros::stream_ros()
+{
+  TRACE_INFO();
+}
+
+stream_ros::~stream_ros()
+{
+  TRACE_INFO();
+
+  release_stream();
+}
+
+bool stream_ros::init_stream(int stream_name)
+{
+  TRACE_INFO();
+
+  return false;
+}
+
+bool stream_ros::init_stream(std::string& stream_name)
+{
+  TRACE_INFO();
+
+  stream_name_ = stream_name;
+
+  /*"ros://<name>?objects=localization"*/
+  std::string name = stream_name.substr(strlen("ros://"));
+  bool localization = false;
+  std::size_t query = name.find('?');
+  if (query != std::string::npos)
+  {
+    localization = name.find("objects=localization", query) != std::string::npos;
+    name = name.substr(0, query);
+  }
+  while (!name.empty() && name.back() == '/')
+  {
+    name.pop_back();
+  }
+  prefix_ = name.empty() ? "" : "/" + name;
+
+  if (!rclcpp::ok())
+  {
+    rclcpp::init(0, nullptr);
+    own_context_ = true;
+  }
+
+  node_ = rclcpp::Node::make_shared("oa_viewer");
+  matcher_.reset(new matcher(
+    [this](const objects_ptr& objs, const image_ptr& img) { on_matched(objs, img); },
+    kImageBytes));
+
+  sub_rgb_ = node_->create_subscription<sensor_msgs::msg::Image>(
+    topic("/object_analytics/rgb"),
+    [this](const image_ptr img) { on_image(img); });
+  if (localization)
+  {
+    sub_localization_ = node_->create_subscription<object_analytics_msgs::msg::ObjectsInBoxes3D>(
+      topic("/object_analytics/localization"),
+      [this](const object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr objs)
+      { on_localization(objs); });
+  }
+  else
+  {
+    sub_tracking_ = node_->create_subscription<object_analytics_msgs::msg::TrackedObjects>(
+      topic("/object_analytics/tracking"),
+      [this](const object_analytics_msgs::msg::TrackedObjects::SharedPtr objs)
+      { on_tracking(objs); });
+  }
+  TRACE_INFO("subscribed to %s", topic("/object_analytics/rgb").c_str());
+
+  executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  executor_->add_node(node_);
+  spin_thread_ = std::thread([this]() { executor_->spin(); });
+
+  return true;
+}
+
+void stream_ros::release_stream()
+{
+  TRACE_INFO();
+
+  /*the fetch thread first, it may be waiting for a frame*/
+  stream_device::release_stream();
+
+  if (executor_ != nullptr)
+  {
+    executor_->cancel();
+  }
+  if (spin_thread_.joinable())
+  {
+    spin_thread_.join();
+  }
+  executor_.reset();
+  sub_rgb_.reset();
+  sub_tracking_.reset();
+  sub_localization_.reset();
+  node_.reset();
+
+  if (own_context_)
+  {
+    rclcpp::shutdown();
+    own_context_ = false;
+  }
+}
+
+bool stream_ros::reset_stream()
+{
+  TRACE_INFO();
+
+  std::lock_guard<std::mutex> lock(matched_mutex_);
+  matched_.clear();
+
+  return node_ != nullptr;
+}
+
+bool stream_ros::fetch_frame(std::shared_ptr<sFrame>& frame)
+{
+  TRACE_INFO();
+
+  std::pair<objects_ptr, image_ptr> matched;
+  {
+    std::unique_lock<std::mutex> lock(matched_mutex_);
+    /*a quiet topic is waited for, and given up only on release*/
+    while (matched_.empty())
+    {
+      if (terminate || !rclcpp::ok())
+      {
+        return false;
+      }
+      matched_cond_.wait_for(lock, std::chrono::milliseconds(kWaitMSec));
+    }
+    matched = std::move(matched_.front());
+    matched_.pop_front();
+  }
+
+  std::shared_ptr<ros_frame> frameobj = std::make_shared<ros_frame>();
+  try
+  {
+    frameobj->image = cv_bridge::toCvShare(matched.second, "bgr8");
+  }
+  catch (cv_bridge::Exception& e)
+  {
+    TRACE_ERR("stream_ros convert image failed: %s", e.what());
+    return false;
+  }
+
+  /*the Mat refers to the message kept by the frame*/
+  cv::Mat frame_img = frameobj->image->image;
+  frameobj->genFrame(frame_img, static_cast<int>(frame_idx_++));
+  for (auto& obj : *matched.first)
+  {
+    frameobj->AddDetection(obj);
+  }
+
+  frame = frameobj;
+
+  return true;
+}
+
+void stream_ros::on_matched(const objects_ptr& objs, const image_ptr& img)
+{
+  {
+    std::lock_guard<std::mutex> lock(matched_mutex_);
+    if (matched_.size() >= kMatchedFrames)
+    {
+      matched_.pop_front();
+      dropped_++;
+    }
+    matched_.emplace_back(objs, img);
+  }
+  matched_cond_.notify_one();
+}
+
+void stream_ros::on_image(const image_ptr& img)
+{
+  matcher_->addSecond(to_nsec(img->header.stamp), img, img->data.size());
+}
+
+void stream_ros::on_tracking(const object_analytics_msgs::msg::TrackedObjects::SharedPtr objs)
+{
+  objects_ptr objects = std::make_shared<std::vector<Object>>();
+  objects->reserve(objs->tracked_objects.size());
+  for (auto& t : objs->tracked_objects)
+  {
+    objects->push_back(to_object(t.id, t.object.probability, t.roi));
+  }
+  matcher_->addFirst(to_nsec(objs->header.stamp), objects);
+}
+
+void stream_ros::on_localization(
+  const object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr objs)
+{
+  objects_ptr objects = std::make_shared<std::vector<Object>>();
+  objects->reserve(objs->objects_in_boxes.size());
+  for (auto& t : objs->objects_in_boxes)
+  {
+    objects->push_back(to_object(t.id, t.object.probability, t.roi));
+  }
+  matcher_->addFirst(to_nsec(objs->header.stamp), objects);
+}
+
+std::string stream_ros::topic(const std::string& suffix) const
+{
+  return prefix_ + suffix;
+}
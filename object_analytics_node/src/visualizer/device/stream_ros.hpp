@@ -0,0 +1,125 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <object_analytics_msgs/msg/tracked_objects.hpp>
+#include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
+
+#include "object_analytics_node/util/stamp_matcher.hpp"
+
+#include "stream_device.hpp"
+#include "object.hpp"
+
+/**
+ * @brief Stream of the live object analytics topics
+ *
+ * "ros://" subscribes to /object_analytics/rgb with the objects of
+ * /object_analytics/tracking, "ros://<name>" to the topics of the tracking
+ * stream <name>, e.g. /<name>/object_analytics/rgb. The option
+ * "objects=localization" takes the objects of /object_analytics/localization
+ * instead. Images are paired with the objects of the same stamp and shared
+ * with the message, not copied.
+ */
+class stream_ros : public stream_device {
+ public:
+  stream_ros();
+  ~stream_ros();
+
+  /**
+   * @brief Init stream from the topics named by "ros://"
+   */
+  virtual bool init_stream(std::string &stream_name);
+
+  /**
+   * @brief Streams of topics have no index
+   */
+  virtual bool init_stream(int stream_name);
+
+  /**
+   * @brief release subscriptions and the spin thread
+   */
+  virtual void release_stream();
+
+  /**
+   * @brief Drop the frames matched and not fetched yet
+   */
+  virtual bool reset_stream();
+
+  /**
+   * @brief Wait for the next image matched with its objects
+   */
+  virtual bool fetch_frame(std::shared_ptr<sFrame> &frame);
+
+  /**
+   * @brief Topics are live, a quiet publisher is waited for
+   */
+  virtual bool is_live() const { return true; }
+
+ protected:
+  typedef std::shared_ptr<std::vector<Object>> objects_ptr;
+  typedef sensor_msgs::msg::Image::ConstSharedPtr image_ptr;
+  typedef object_analytics_node::util::StampMatcher<objects_ptr, image_ptr> matcher;
+
+  static const size_t kMatchedFrames;
+  static const size_t kImageBytes;
+  static const size_t kWaitMSec;
+
+  /**
+   * @brief Queue a matched frame, the oldest one dropped if full
+   */
+  void on_matched(const objects_ptr &objs, const image_ptr &img);
+
+  void on_image(const image_ptr &img);
+  void on_tracking(const object_analytics_msgs::msg::TrackedObjects::SharedPtr objs);
+  void on_localization(const object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr objs);
+
+  std::string topic(const std::string &suffix) const;
+
+  /*rclcpp is shut down on release if initialized here*/
+  bool own_context_ = false;
+  std::string prefix_;
+  uint64_t frame_idx_ = 0;
+
+  rclcpp::Node::SharedPtr node_;
+  rclcpp::executors::SingleThreadedExecutor::SharedPtr executor_;
+  std::thread spin_thread_;
+
+  rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr sub_rgb_;
+  rclcpp::Subscription<object_analytics_msgs::msg::TrackedObjects>::SharedPtr sub_tracking_;
+  rclcpp::Subscription<object_analytics_msgs::msg::ObjectsInBoxes3D>::SharedPtr
+    sub_localization_;
+
+  /*touched by the spin thread only*/
+  std::unique_ptr<matcher> matcher_;
+
+  std::mutex matched_mutex_;
+  std::condition_variable matched_cond_;
+  std::deque<std::pair<objects_ptr, image_ptr>> matched_;
+
+ private:
+};
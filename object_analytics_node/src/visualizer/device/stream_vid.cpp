@@ -35,7 +35,7 @@ bool stream_vid::init_stream(std::string& stream_name)
 {
   TRACE_INFO();
 
-  cap_ = std::make_shared<cv::VideoCapture>(stream_name);
+  cap_ = open_capture(stream_name, cv::CAP_ANY);
 
   if (cap_->isOpened())
   {
@@ -85,7 +85,11 @@ bool stream_vid::fetch_frame(std::shared_ptr<sFrame>& frame)
 
   cv::Mat frame_cap;
   ret = cap_->read(frame_cap);
-  frame = std::make_shared<sFrame>();
+  /*reuse the recycled frame unless the viewer still holds it*/
+  if (frame == nullptr || frame.use_count() > 1)
+  {
+    frame = std::make_shared<sFrame>();
+  }
   frame->genFrame(frame_cap);
 
   return ret;
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <thread>
@@ -35,34 +37,135 @@
 
 using namespace std;
 
-int main(int /*argc*/, char** /*argv*/)
+static void Usage(const char* name)
+{
+  printf("usage: %s [-i uri] [-l horizontal|vertical] [-o video.mp4] [-r fps] [-H]"
+         " [-q depth[:drop]] [-R min:max:retries]\n", name);
+  printf("  -i  input stream, camera index, video file, rtsp url, ds://dataset or ros://\n");
+  printf("  -l  layout of the frames shown, default horizontal\n");
+  printf("  -o  encode the frames shown into a video file\n");
+  printf("  -r  frame rate of the video file, default 25\n");
+  printf("  -H  headless, render offscreen as fast as possible, needs -o\n");
+  printf("  -q  frames decoded ahead, default 4, \":drop\" drops the oldest when full\n");
+  printf("  -R  reconnect backoff of live streams in ms and retries, 0 forever, default 50:5000:0\n");
+}
+
+int main(int argc, char** argv)
 {
   /* stream device support camera/video and some image dataset format
   ** give some example of input to initialize input camera as below:
     1. Default camera
-       int CAM = 0;
+       -i 0
     2. Video files
-      std::string vid_file = "/data/dataset/crossroad/TownCentreXVID.avi";
+       -i /data/dataset/crossroad/TownCentreXVID.avi
+      append "?hw=1" to the name of a video or RTSP stream for hardware decode
     3. Multi-tracking dataset
-      std::string ds_file = "ds:///data/dataset/PETS2009/Crowd_PETS09/S2/L1/Time_12-34/View_001";
+       -i ds:///data/dataset/PETS2009/Crowd_PETS09/S2/L1/Time_12-34/View_001
+    4. Live object analytics topics, if built with ROS2
+       -i ros://
+      "ros://<name>" for a named tracking stream, "?objects=localization" for 3d objects
   */
-  std::string ds_file = "ds:///data/dataset/PETS2009/Crowd_PETS09/S2/L1/Time_12-34/View_001";
+  std::string uri = "ds:///data/dataset/PETS2009/Crowd_PETS09/S2/L1/Time_12-34/View_001";
+  std::string output;
+  double fps = 25;
+  bool headless = false;
+  size_t backoffMin = 50, backoffMax = 5000, retries = 0;
+  size_t queueDepth = 4;
+  stream_device::drop_policy policy = stream_device::block;
+  View::Layout layout = View::LayoutHorizontal;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "i:l:o:r:q:R:Hh")) != -1)
+  {
+    switch (opt)
+    {
+      case 'i':
+        uri = optarg;
+        break;
+      case 'l':
+        if (std::string(optarg) == "vertical")
+          layout = View::LayoutVertical;
+        else if (std::string(optarg) != "horizontal")
+        {
+          Usage(argv[0]);
+          return 1;
+        }
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'r':
+        fps = atof(optarg);
+        break;
+      case 'H':
+        headless = true;
+        break;
+      case 'q':
+      {
+        char drop[8] = "";
+        int fields = sscanf(optarg, "%zu:%7s", &queueDepth, drop);
+        if (fields < 1 || queueDepth == 0 || (fields == 2 && std::string(drop) != "drop"))
+        {
+          Usage(argv[0]);
+          return 1;
+        }
+        policy = fields == 2 ? stream_device::drop_oldest : stream_device::block;
+        break;
+      }
+      case 'R':
+        if (sscanf(optarg, "%zu:%zu:%zu", &backoffMin, &backoffMax, &retries) != 3)
+        {
+          Usage(argv[0]);
+          return 1;
+        }
+        break;
+      default:
+        Usage(argv[0]);
+        return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (headless && output.empty())
+  {
+    TRACE_ERR("headless mode needs an output video");
+    Usage(argv[0]);
+    return 1;
+  }
+
   stream_device::Ptr inputCapture;
-  inputCapture = inputCapture->create(ds_file);
-  // inputCapture = inputCapture->create(CAM);
+  /*a number is a camera index*/
+  if (!uri.empty() && std::all_of(uri.begin(), uri.end(), ::isdigit))
+    inputCapture = inputCapture->create(std::stoi(uri));
+  else
+    inputCapture = inputCapture->create(uri);
   if (inputCapture == nullptr)
   {
     TRACE_ERR("camera can not initialize");
     return 1;
   }
+  inputCapture->set_queue(queueDepth, policy);
+  inputCapture->set_reconnect(backoffMin, backoffMax, retries);
 
   View::Ptr scene = std::make_shared<View>();
+  scene->SetHeadless(headless);
+  scene->SetLayout(layout);
 
-  Control::Ptr control = std::make_shared<ControlDS>();
+  ControlDS::Ptr control = std::make_shared<ControlDS>();
+  if (!output.empty())
+    control->SetExport(output, fps);
 
   control->Initial(scene, inputCapture);
-  control->CreateContext();
+  if (!control->CreateContext())
+    return 1;
   control->Run();
 
+  stream_device::stream_health health = inputCapture->get_health();
+  printf("stream: %llu fetches failed, %llu reconnects, %llu reconnects failed\n",
+         static_cast<unsigned long long>(health.failures),
+         static_cast<unsigned long long>(health.reconnects),
+         static_cast<unsigned long long>(health.reconnect_failures));
+  printf("stream: %llu frames dropped for a full queue\n",
+         static_cast<unsigned long long>(inputCapture->get_dropped()));
+
   return 0;
 }
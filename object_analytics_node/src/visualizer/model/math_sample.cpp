@@ -14,6 +14,8 @@
 
 #include "math_sample.hpp"
 
+const uint64_t MathSample::kBatchSeed = 0x5eed;
+
 MathSample::MathSample()
 {
   TRACE_INFO();
@@ -52,6 +54,9 @@ bool MathSample::Initial(std::string model, std::string sampler)
     return false;
   }
 
+  Model_ = model;
+  Sampler_ = sampler;
+
   return true;
 }
 
@@ -76,8 +81,11 @@ bool MathSample::SetMeanAndCovariance(cv::Mat& mean, cv::Mat& covariance, uint32
 
   Counts_ = counts;
 
-  // Setup sampler
-  SampleModel_->RegisterEvaluator(std::bind(&StatModel::Evaluate, MathModel_.get(), std::placeholders::_1));
+  // Setup sampler, the model is kept so the evaluator is registered once
+  if (SampleModel_->Evaluator_Proc_ == nullptr)
+  {
+    SampleModel_->RegisterEvaluator(std::bind(&StatModel::Evaluate, MathModel_.get(), std::placeholders::_1));
+  }
   ret = SampleModel_->SetRanges(M_Range, M_Interval);
 
   return ret;
@@ -123,3 +131,48 @@ cv::RotatedRect MathSample::GetCovEllipse()
 
   return MathModel_->GetCovEllipse();
 }
+
+bool MathSample::GenBatchSamples(std::vector<cv::Mat>& means, std::vector<cv::Mat>& covariances,
+                                 uint32_t counts, std::vector<cv::Mat>& samples,
+                                 std::vector<cv::RotatedRect>& ellipses)
+{
+  TRACE_INFO();
+
+  if (means.size() != covariances.size())
+  {
+    TRACE_ERR("means and covariances not match!!!");
+    return false;
+  }
+
+  while (BatchSamplers_.size() < means.size())
+  {
+    Ptr sampler = std::make_shared<MathSample>();
+    if (!sampler->Initial(Model_, Sampler_))
+      return false;
+
+    sampler->SampleModel_->SetSeed(kBatchSeed + BatchSamplers_.size());
+    BatchSamplers_.push_back(sampler);
+  }
+
+  samples.resize(means.size());
+  ellipses.resize(means.size());
+  bool ret = true;
+
+  /*objects are independent, each one has its own sampler*/
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < static_cast<int>(means.size()); i++)
+  {
+    Ptr sampler = BatchSamplers_[i];
+    bool done = sampler->SetMeanAndCovariance(means[i], covariances[i], counts) && sampler->GenSamples() &&
+                sampler->FetchSamples(samples[i]);
+    ellipses[i] = sampler->GetCovEllipse();
+    if (!done)
+    {
+      samples[i] = cv::Mat();
+#pragma omp atomic write
+      ret = false;
+    }
+  }
+
+  return ret;
+}
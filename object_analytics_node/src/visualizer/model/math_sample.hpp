@@ -19,6 +19,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/opencv.hpp>
@@ -79,10 +80,25 @@ class MathSample {
    */
   virtual cv::RotatedRect GetCovEllipse();
 
+  /**
+   * @brief Generate samples for a batch of objects in one call
+   *
+   * Each object gets a sampler of its own, kept for the next batch with its
+   * model, random generator and buffers, and the objects are sampled in parallel.
+   */
+  virtual bool GenBatchSamples(std::vector<cv::Mat>& means, std::vector<cv::Mat>& covariances,
+                               uint32_t counts, std::vector<cv::Mat>& samples,
+                               std::vector<cv::RotatedRect>& ellipses);
+
  public:
   StatModel::Ptr MathModel_ = nullptr;
   SampleModel::Ptr SampleModel_ = nullptr;
 
   uint32_t Counts_ = 0;
 
+  /*model and sampler names of Initial(), used for the batch samplers*/
+  std::string Model_;
+  std::string Sampler_;
+  std::vector<Ptr> BatchSamplers_;
+  static const uint64_t kBatchSeed;
 };
@@ -45,23 +45,30 @@ bool RWSample::GenSamples()
   cv::Mat low = Ranges_.col(0).clone();
   cv::Mat high = Ranges_.col(1).clone();
 
-  cv::RNG rng;
   cv::Mat seed = (low + high) / 2;
-  double res = Evaluator_Proc_(seed);
   uint64_t count = 1;
   for (int i = 0; i < Counts_.rows; i++)
   {
     count *= Counts_.at<uint16_t>(i);
   }
 
-  while (count > 1)
+  /*every round steps once along each dimension until count is used up,
+   *the rows are written into one buffer instead of being pushed back*/
+  int dims = seed.rows;
+  uint64_t rounds = count > 1 ? (count - 1 + dims - 1) / dims : 0;
+  Samples_ = cv::Mat(rounds * dims, dims + 1, CV_64FC1);
+
+  cv::Mat seed_inc(dims, 1, CV_64FC1);
+  cv::Mat seed_dec(dims, 1, CV_64FC1);
+  int row = 0;
+  for (uint64_t r = 0; r < rounds; r++)
   {
-    for (int i = 0; i < seed.rows; i++)
+    for (int i = 0; i < dims; i++)
     {
       double res_inc = .0f;
       double res_dec = .0f;
-      cv::Mat seed_inc = seed.clone();
-      cv::Mat seed_dec = seed.clone();
+      seed.copyTo(seed_inc);
+      seed.copyTo(seed_dec);
 
       double dim_val = seed.at<double>(i);
       if (dim_val < high.at<double>(i))
@@ -76,23 +83,17 @@ bool RWSample::GenSamples()
         res_dec = Evaluator_Proc_(seed_dec);
       }
 
-      double uni_rand = rng.uniform((double)0, res_inc + res_dec);
-      if (uni_rand <= (res_inc))
-      {
-        seed = seed_inc.clone();
-        res = res_inc;
-        seed_inc.resize(seed_inc.rows + 1, res_inc);
-        Samples_.push_back(seed_inc.t());
-        count--;
-      }
-      else
+      double uni_rand = Rng_.uniform((double)0, res_inc + res_dec);
+      bool inc = (uni_rand <= (res_inc));
+      cv::Mat& next = inc ? seed_inc : seed_dec;
+
+      double* sample = Samples_.ptr<double>(row++);
+      for (int k = 0; k < dims; k++)
       {
-        seed = seed_dec.clone();
-        res = res_dec;
-        seed_dec.resize(seed_dec.rows + 1, res_dec);
-        Samples_.push_back(seed_dec.t());
-        count--;
+        sample[k] = next.at<double>(k);
       }
+      sample[dims] = inc ? res_inc : res_dec;
+      next.copyTo(seed);
     }
   }
 
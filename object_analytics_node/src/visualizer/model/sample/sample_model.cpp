@@ -45,6 +45,13 @@ bool SampleModel::RegisterEvaluator(CBPtr evaluator)
   return ret;
 }
 
+void SampleModel::SetSeed(uint64_t seed)
+{
+  TRACE_INFO();
+
+  Rng_ = cv::RNG(seed);
+}
+
 bool SampleModel::SetRanges(cv::Mat ranges, cv::Mat intervals)
 {
   TRACE_INFO();
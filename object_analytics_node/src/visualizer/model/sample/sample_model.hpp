@@ -56,6 +56,11 @@ class SampleModel {
    */
 	virtual bool RegisterEvaluator(CBPtr evaluator);
 
+  /**
+   * @brief Seed the random generator kept across GenSamples() calls
+   */
+  virtual void SetSeed(uint64_t seed);
+
   /**
    * @brief Generate samples 
    */
@@ -99,4 +104,9 @@ class SampleModel {
    */
   CBPtr Evaluator_Proc_ = nullptr;
 
+  /**
+   * @brief Random generator of the sampler
+   */
+  cv::RNG Rng_;
+
 };
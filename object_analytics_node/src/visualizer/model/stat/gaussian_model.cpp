@@ -46,9 +46,18 @@ double GaussianModel::Evaluate(cv::Mat& coordinate)
     return ret;
   }
 
-  double m_dist = cv::Mahalanobis(coordinate, Mean_, InvCovariance_);
-  ret = 1.0f / sqrt(cv::determinant(2 * CV_PI * Covariance_));
-  ret *= exp(-std::pow(m_dist, 2) / 2.0f);
+  /*squared mahalanobis distance, without temporaries as it runs for every sample*/
+  double m_dist2 = .0f;
+  for (int i = 0; i < Mean_.rows; i++)
+  {
+    double di = coordinate.at<double>(i) - Mean_.at<double>(i);
+    const double* inv = InvCovariance_.ptr<double>(i);
+    for (int j = 0; j < Mean_.rows; j++)
+    {
+      m_dist2 += di * inv[j] * (coordinate.at<double>(j) - Mean_.at<double>(j));
+    }
+  }
+  ret = Norm_ * exp(-m_dist2 / 2.0f);
 
   return ret;
 }
@@ -31,6 +31,7 @@ void StatModel::SetMeanAndCovariance(cv::Mat& mean, cv::Mat& covariance)
   Mean_ = mean.clone();
   Covariance_ = covariance.clone();
   InvCovariance_ = covariance.inv();
+  Norm_ = 1.0f / sqrt(cv::determinant(2 * CV_PI * Covariance_));
 }
 
 void StatModel::GetMeanAndCovariance(cv::Mat& mean, cv::Mat& covariance)
@@ -68,6 +68,8 @@ class StatModel : public MathModel {
   cv::Mat Mean_;
   cv::Mat Covariance_;
   cv::Mat InvCovariance_;
+  /*1/sqrt(det(2*pi*Covariance_)), computed once per covariance*/
+  double Norm_ = .0f;
   int Dimension_ = 2;
 
 };
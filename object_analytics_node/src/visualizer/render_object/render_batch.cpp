@@ -0,0 +1,128 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "render_batch.hpp"
+
+void RenderBatch::Clear()
+{
+  TRACE_INFO();
+
+  std::map<Key, std::vector<Vertex>>::iterator it;
+  for (it = Buckets_.begin(); it != Buckets_.end(); it++)
+  {
+    it->second.clear();
+  }
+}
+
+void RenderBatch::AddVertex(std::vector<Vertex> &bucket, float x, float y, float z,
+                            const float color[4])
+{
+  Vertex v = {{x, y, z}, {color[0], color[1], color[2], color[3]}};
+  bucket.push_back(v);
+}
+
+void RenderBatch::AddLine(float x0, float y0, float z0, float x1, float y1, float z1,
+                          const float color[4], bool stipple)
+{
+  std::vector<Vertex> &bucket = Buckets_[Key(GL_LINES, stipple)];
+
+  AddVertex(bucket, x0, y0, z0, color);
+  AddVertex(bucket, x1, y1, z1, color);
+}
+
+void RenderBatch::AddLineLoop(const std::vector<cv::Point2f> &points, const float color[4],
+                              bool stipple)
+{
+  if (points.size() < 2)
+    return;
+
+  /*a loop is flattened to separate segments, so loops of different
+   *objects can share one draw call*/
+  std::vector<Vertex> &bucket = Buckets_[Key(GL_LINES, stipple)];
+  for (size_t i = 0; i < points.size(); i++)
+  {
+    const cv::Point2f &next = points[(i + 1) % points.size()];
+    AddVertex(bucket, points[i].x, points[i].y, 0, color);
+    AddVertex(bucket, next.x, next.y, 0, color);
+  }
+}
+
+void RenderBatch::AddQuad(const cv::Point2f points[4], const float color[4], bool stipple)
+{
+  std::vector<Vertex> &bucket = Buckets_[Key(GL_TRIANGLES, stipple)];
+
+  const int order[6] = {0, 1, 2, 0, 2, 3};
+  for (int i = 0; i < 6; i++)
+  {
+    AddVertex(bucket, points[order[i]].x, points[order[i]].y, 0, color);
+  }
+}
+
+bool RenderBatch::Empty()
+{
+  std::map<Key, std::vector<Vertex>>::iterator it;
+  for (it = Buckets_.begin(); it != Buckets_.end(); it++)
+  {
+    if (!it->second.empty())
+      return false;
+  }
+
+  return true;
+}
+
+void RenderBatch::Draw()
+{
+  TRACE_INFO();
+
+  if (Empty())
+    return;
+
+  glEnable(GL_LINE_SMOOTH);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glDisable(GL_DEPTH_TEST);
+  glLineWidth(3);
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+
+  std::map<Key, std::vector<Vertex>>::iterator it;
+  for (it = Buckets_.begin(); it != Buckets_.end(); it++)
+  {
+    std::vector<Vertex> &bucket = it->second;
+    if (bucket.empty())
+      continue;
+
+    bool stipple = it->first.second;
+    if (stipple)
+    {
+      glEnable(GL_LINE_STIPPLE);
+      glLineStipple(2, 0x7777);
+    }
+    else
+    {
+      glDisable(GL_LINE_STIPPLE);
+    }
+
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), bucket[0].pos);
+    glColorPointer(4, GL_FLOAT, sizeof(Vertex), bucket[0].color);
+    glDrawArrays(it->first.first, 0, bucket.size());
+  }
+
+  glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisable(GL_LINE_STIPPLE);
+
+  glEnable(GL_DEPTH_TEST);
+}
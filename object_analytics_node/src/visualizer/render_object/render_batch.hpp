@@ -0,0 +1,63 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <pangolin/pangolin.h>
+
+#include "utility.hpp"
+
+/*Collects the primitives of one frame and draws them with one call per
+ *primitive type and stipple state*/
+class RenderBatch {
+ public:
+  RenderBatch(){};
+  ~RenderBatch(){};
+
+  using Ptr = std::shared_ptr<RenderBatch>;
+  using CPtr = std::shared_ptr<const RenderBatch>;
+
+  /*drop the primitives but keep the storage for the next frame*/
+  virtual void Clear();
+
+  virtual void AddLine(float x0, float y0, float z0, float x1, float y1, float z1,
+                       const float color[4], bool stipple);
+  virtual void AddLineLoop(const std::vector<cv::Point2f> &points, const float color[4],
+                           bool stipple);
+  virtual void AddQuad(const cv::Point2f points[4], const float color[4], bool stipple);
+
+  virtual bool Empty();
+  virtual void Draw();
+
+ private:
+  struct Vertex
+  {
+    float pos[3];
+    float color[4];
+  };
+
+  /*primitive mode and stipple state*/
+  using Key = std::pair<GLenum, bool>;
+
+  virtual void AddVertex(std::vector<Vertex> &bucket, float x, float y, float z,
+                         const float color[4]);
+
+  std::map<Key, std::vector<Vertex>> Buckets_;
+};
@@ -113,7 +113,33 @@ void RenderEllipse::DrawID(float size)
   txt.Draw(Rect_.boundingRect().tl().x + 10, Rect_.boundingRect().tl().y + 10, 0);
 }
 
-void RenderEllipse::DrawEllipse(cv::RotatedRect& rect, double confident_scale)
+bool RenderEllipse::Batch(RenderBatch& batch)
+{
+  TRACE_INFO();
+
+  if (!Validate())
+    return false;
+
+  const float color[4] = {ObjColor_[0], ObjColor_[1], ObjColor_[2], 0.6f};
+  /*99%, 95% and 70% confidence*/
+  const double scales[3] = {9.21f, 5.99f, 2.41f};
+  std::vector<cv::Point2f> outline;
+  cv::Point2f axes[2];
+  for (int i = 0; i < 3; i++)
+  {
+    SampleEllipse(Rect_, scales[i], outline, axes);
+    batch.AddLineLoop(outline, color, Stipple_);
+    for (int j = 0; j < 2; j++)
+    {
+      batch.AddLine(Rect_.center.x, Rect_.center.y, 0, axes[j].x, axes[j].y, 0, color, Stipple_);
+    }
+  }
+
+  return true;
+}
+
+void RenderEllipse::SampleEllipse(cv::RotatedRect& rect, double confident_scale,
+                                  std::vector<cv::Point2f>& outline, cv::Point2f axes[2])
 {
   const int SAMPLE_POINTS = 40;
   double xc = rect.center.x;
@@ -126,7 +152,7 @@ void RenderEllipse::DrawEllipse(cv::RotatedRect& rect, double confident_scale)
   double ca = cos(angle);
   double sa = sin(angle);
 
-  glBegin(GL_LINE_LOOP);
+  outline.clear();
   while (t <= 2 * M_PI)
   {
     cr = cos(t);
@@ -134,20 +160,33 @@ void RenderEllipse::DrawEllipse(cv::RotatedRect& rect, double confident_scale)
     xi = a * cr * ca - b * sr * sa;
     yi = a * cr * sa + b * sr * ca;
     t += delta;
-    glVertex2d(xc + xi, yc + yi);
+    outline.push_back(cv::Point2f(xc + xi, yc + yi));
   }
-  glEnd();
 
-  glBegin(GL_LINES);
   // long direction
-  glVertex2d(xc, yc);
-  xi = a * ca;
-  yi = a * sa;
-  glVertex2d(xc + xi, yc + yi);
+  axes[0] = cv::Point2f(xc + a * ca, yc + a * sa);
   // short direction
-  glVertex2d(xc, yc);
-  xi = -b * sa;
-  yi = b * ca;
-  glVertex2d(xc + xi, yc + yi);
+  axes[1] = cv::Point2f(xc - b * sa, yc + b * ca);
+}
+
+void RenderEllipse::DrawEllipse(cv::RotatedRect& rect, double confident_scale)
+{
+  std::vector<cv::Point2f> outline;
+  cv::Point2f axes[2];
+  SampleEllipse(rect, confident_scale, outline, axes);
+
+  glBegin(GL_LINE_LOOP);
+  for (size_t i = 0; i < outline.size(); i++)
+  {
+    glVertex2d(outline[i].x, outline[i].y);
+  }
+  glEnd();
+
+  glBegin(GL_LINES);
+  for (int i = 0; i < 2; i++)
+  {
+    glVertex2d(rect.center.x, rect.center.y);
+    glVertex2d(axes[i].x, axes[i].y);
+  }
   glEnd();
 }
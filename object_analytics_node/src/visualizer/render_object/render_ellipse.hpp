@@ -38,6 +38,7 @@ class RenderEllipse : public RenderObject {
   virtual bool Load();
   virtual void DrawObject();
   virtual bool Validate();
+  virtual bool Batch(RenderBatch &batch);
 
   virtual void DrawID(float size);
 
@@ -47,8 +48,11 @@ class RenderEllipse : public RenderObject {
   //70%-iso-probability ==> 2.41
   void DrawEllipse(cv::RotatedRect& rect, double confident_scale = 9.21);
 
+ private:
+  /*outline points and the long/short axis ends of an iso-probability ellipse*/
+  void SampleEllipse(cv::RotatedRect& rect, double confident_scale,
+                     std::vector<cv::Point2f>& outline, cv::Point2f axes[2]);
+
  public:
   cv::RotatedRect Rect_;
-
- private:
 };
@@ -24,15 +24,66 @@ RenderImage::RenderImage(float width, float height) : RenderObject(width, height
 RenderImage::~RenderImage()
 {
   TRACE_INFO();
+
+  if (Pbo_[0] != 0)
+  {
+    glDeleteBuffers(2, Pbo_);
+  }
 }
 
 void RenderImage::SetTexture(cv::Mat& tex)
 {
   TRACE_INFO();
 
+  /*no GL call, scenes may be built out of the render thread*/
   Tex_ = tex;
+  Dirty_ = true;
+}
 
-  RenderImageTex_ = pangolin::GlTexture(Tex_.cols, Tex_.rows, GL_RGB, false, 0, GL_RGB, GL_UNSIGNED_BYTE);
+void RenderImage::Upload()
+{
+  TRACE_INFO();
+
+  /*the texture is kept across frames of the same size*/
+  if (!RenderImageTex_.IsValid() || RenderImageTex_.width != Tex_.cols ||
+      RenderImageTex_.height != Tex_.rows)
+  {
+    RenderImageTex_.Reinitialise(Tex_.cols, Tex_.rows, GL_RGB, false, 0, GL_RGB, GL_UNSIGNED_BYTE);
+  }
+
+  size_t bytes = Tex_.total() * Tex_.elemSize();
+  void* dst = nullptr;
+  if (Tex_.isContinuous())
+  {
+    if (Pbo_[0] == 0)
+    {
+      glGenBuffers(2, Pbo_);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, Pbo_[PboIdx_]);
+    PboIdx_ = 1 - PboIdx_;
+    /*orphan the storage, mapping does not wait for a transfer in flight*/
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    dst = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+  }
+
+  RenderImageTex_.Bind();
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  if (dst != nullptr)
+  {
+    memcpy(dst, Tex_.data, bytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    /*copied from the buffer object asynchronously*/
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, Tex_.cols, Tex_.rows, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+  else
+  {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    cv::Mat continuous = Tex_.isContinuous() ? Tex_ : Tex_.clone();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, Tex_.cols, Tex_.rows, GL_RGB, GL_UNSIGNED_BYTE,
+                    continuous.data);
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
 void RenderImage::SetTexture(cv::Mat& tex, std::string id)
@@ -56,7 +107,13 @@ bool RenderImage::Load()
 
   if (ret)
   {
-    RenderImageTex_.Upload(Tex_.data, GL_RGB, GL_UNSIGNED_BYTE);
+    /*uploaded once per frame, bound for every render*/
+    if (Dirty_)
+    {
+      Upload();
+      Dirty_ = false;
+    }
+    RenderImageTex_.Bind();
     ret = RenderObject::Load();
   }
 
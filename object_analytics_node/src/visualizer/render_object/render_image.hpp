@@ -41,4 +41,15 @@ class RenderImage : public RenderObject {
   pangolin::GlTexture RenderImageTex_;
 
  private:
+  /**
+   * @brief Stream Tex_ into the texture through a pixel buffer object
+   */
+  void Upload();
+
+  /*pixel buffer objects used in turn, so a new frame does not wait for the
+   *transfer of the previous one*/
+  GLuint Pbo_[2] = {0, 0};
+  int PboIdx_ = 0;
+  /*Tex_ changed since the last upload*/
+  bool Dirty_ = false;
 };
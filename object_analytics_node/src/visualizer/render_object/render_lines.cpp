@@ -94,3 +94,24 @@ void RenderLines::DrawObject()
 
   glEnable(GL_DEPTH_TEST);
 }
+
+bool RenderLines::Batch(RenderBatch& batch)
+{
+  TRACE_INFO();
+
+  if (!Validate())
+    return false;
+
+  VisibleID_ = false;
+  const float color[4] = {ObjColor_[0], ObjColor_[1], ObjColor_[2], 0.6f};
+  /*the strip is flattened to separate segments*/
+  for (int i = 1; i < Vertices_.rows; i++)
+  {
+    const double* p0 = Vertices_.ptr<double>(i - 1);
+    const double* p1 = Vertices_.ptr<double>(i);
+    batch.AddLine(p0[0], p0[1], p0[2] * (Height_ * 10), p1[0], p1[1], p1[2] * (Height_ * 10), color,
+                  Stipple_);
+  }
+
+  return true;
+}
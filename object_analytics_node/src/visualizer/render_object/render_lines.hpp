@@ -35,6 +35,7 @@ class RenderLines : public RenderObject {
   virtual bool Load();
   virtual void DrawObject();
   virtual bool Validate();
+  virtual bool Batch(RenderBatch &batch);
 
  public:
   cv::Mat Vertices_;
@@ -61,6 +61,19 @@ void RenderObject::SetID(std::string id)
   ObjColor_[2] = float(i_dec % 7) / (7.0f);
 }
 
+bool RenderObject::Batch(RenderBatch& batch)
+{
+  return false;
+}
+
+void RenderObject::ClearSubObjs()
+{
+  TRACE_INFO();
+
+  SpareObjs_.insert(SpareObjs_.end(), SubObjs_.begin(), SubObjs_.end());
+  SubObjs_.clear();
+}
+
 std::string RenderObject::GetID()
 {
   return Id_;
@@ -248,10 +261,24 @@ void RenderObject::Render()
     if (VisibleGrid_)
       DrawGrid(50);
 
+    /*sub objects share the pose of the object, their primitives are
+     *collected and drawn with a few calls*/
+    SubBatch_.Clear();
+    BatchedObjs_.clear();
     std::vector<Ptr>::iterator it;
     for (it = SubObjs_.begin(); it != SubObjs_.end(); it++)
     {
-      (*it)->Render();
+      if ((*it)->Batch(SubBatch_))
+        BatchedObjs_.push_back(*it);
+      else
+        (*it)->Render();
+    }
+    SubBatch_.Draw();
+
+    for (it = BatchedObjs_.begin(); it != BatchedObjs_.end(); it++)
+    {
+      if ((*it)->VisibleID_)
+        (*it)->DrawID(10);
     }
 
     Finish();
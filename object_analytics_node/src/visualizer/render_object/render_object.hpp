@@ -28,6 +28,7 @@
 #include <pangolin/gl/gltext.h>
 
 #include "utility.hpp"
+#include "render_batch.hpp"
 
 class RenderObject {
  public:
@@ -65,6 +66,40 @@ class RenderObject {
 
   virtual void AddSubObj(Ptr obj);
 
+  /**
+   * @brief Append the primitives of the object to a batch instead of drawing them
+   * @return false if the object has to be rendered on its own
+   */
+  virtual bool Batch(RenderBatch &batch);
+
+  /**
+   * @brief Move the sub objects aside, to be reused by AcquireSubObj()
+   */
+  virtual void ClearSubObjs();
+
+  /**
+   * @brief Get a sub object of type T, reused from the cleared ones if any
+   */
+  template <typename T>
+  std::shared_ptr<T> AcquireSubObj(int width, int height)
+  {
+    for (std::vector<Ptr>::iterator it = SpareObjs_.begin(); it != SpareObjs_.end(); it++)
+    {
+      std::shared_ptr<T> obj = std::dynamic_pointer_cast<T>(*it);
+      if (obj != nullptr)
+      {
+        SpareObjs_.erase(it);
+        obj->Set2DDim(width, height);
+        SubObjs_.push_back(obj);
+        return obj;
+      }
+    }
+
+    std::shared_ptr<T> obj = std::make_shared<T>(width, height);
+    SubObjs_.push_back(obj);
+    return obj;
+  }
+
   virtual void SetID(std::string id);
   virtual std::string GetID();
   virtual void SetStipple(bool stipple);
@@ -88,6 +123,11 @@ class RenderObject {
   float ObjColor_[3]  = {0.3f, 0.3f, 0.3f};
 
   std::vector<Ptr> SubObjs_;
+  /*sub objects of the previous use, kept for reuse*/
+  std::vector<Ptr> SpareObjs_;
+  /*primitives of the sub objects, drawn together after the object*/
+  RenderBatch SubBatch_;
+  std::vector<Ptr> BatchedObjs_;
 
  private:
 };
@@ -99,6 +99,25 @@ void RenderRect::DrawObject()
   glEnable(GL_DEPTH_TEST);
 }
 
+bool RenderRect::Batch(RenderBatch& batch)
+{
+  TRACE_INFO();
+
+  if (!Validate())
+    return false;
+
+  const float color[4] = {ObjColor_[0], ObjColor_[1], ObjColor_[2], 0.6f};
+  cv::Point2f tl = Rect_.tl();
+  cv::Point2f br = Rect_.br();
+  cv::Point2f points[4] = {tl, cv::Point2f(br.x, tl.y), br, cv::Point2f(tl.x, br.y)};
+  if (Stipple_)
+    batch.AddLineLoop(std::vector<cv::Point2f>(points, points + 4), color, true);
+  else
+    batch.AddQuad(points, color, false);
+
+  return true;
+}
+
 void RenderRect::DrawID(float size)
 {
   glColor4f(0.0f, 0.0f, 1.0f, 1.0f);
@@ -38,6 +38,7 @@ class RenderRect : public RenderObject {
   virtual bool Load();
   virtual void DrawObject();
   virtual bool Validate();
+  virtual bool Batch(RenderBatch &batch);
 
   virtual void DrawID(float size);
 
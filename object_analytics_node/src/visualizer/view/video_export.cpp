@@ -0,0 +1,165 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "video_export.hpp"
+
+const size_t VideoExport::kQueueSize = 8;
+
+VideoExport::VideoExport()
+{
+  TRACE_INFO();
+}
+
+VideoExport::~VideoExport()
+{
+  TRACE_INFO();
+
+  Close();
+}
+
+bool VideoExport::Open(const std::string& file, int width, int height, double fps)
+{
+  TRACE_INFO();
+
+  if (width <= 0 || height <= 0 || fps <= 0)
+  {
+    TRACE_ERR("Video export params got issue!!!");
+    return false;
+  }
+
+  if (!Writer_.open(file, cv::VideoWriter::fourcc('m', 'p', '4', 'v'), fps, cv::Size(width, height)))
+  {
+    TRACE_ERR("Can not open video file(%s)!!!", file.c_str());
+    return false;
+  }
+
+  Width_ = width;
+  Height_ = height;
+
+  Color_.reset(new pangolin::GlTexture(Width_, Height_, GL_RGBA8, false, 0, GL_RGBA, GL_UNSIGNED_BYTE));
+  Depth_.reset(new pangolin::GlRenderBuffer(Width_, Height_, GL_DEPTH_COMPONENT24));
+  Fbo_.reset(new pangolin::GlFramebuffer(*Color_, *Depth_));
+
+  size_t bytes = Width_ * Height_ * 3;
+  glGenBuffers(2, Pbo_);
+  for (int i = 0; i < 2; i++)
+  {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, Pbo_[i]);
+    glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  Frames_.reset(new StageQueue<cv::Mat>(kQueueSize));
+  Encoder_ = std::thread(&VideoExport::EncodeStage, this);
+
+  return true;
+}
+
+void VideoExport::Begin()
+{
+  TRACE_INFO();
+
+  if (Fbo_ == nullptr)
+    return;
+
+  Fbo_->Bind();
+  glViewport(0, 0, Width_, Height_);
+}
+
+void VideoExport::End(bool present)
+{
+  TRACE_INFO();
+
+  if (Fbo_ == nullptr)
+    return;
+
+  /*asynchronous, the pixels land in the buffer object*/
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, Pbo_[PboIdx_]);
+  glReadPixels(0, 0, Width_, Height_, GL_BGR, GL_UNSIGNED_BYTE, 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+  if (present)
+  {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, Fbo_->fbid);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, Width_, Height_, 0, 0, Width_, Height_, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  }
+  Fbo_->Unbind();
+
+  /*the other buffer was read a frame ago, its transfer is done by now*/
+  int prev = 1 - PboIdx_;
+  if (Pending_)
+    Collect(prev);
+  Pending_ = true;
+  PboIdx_ = prev;
+}
+
+void VideoExport::Close()
+{
+  TRACE_INFO();
+
+  if (Fbo_ == nullptr)
+    return;
+
+  if (Pending_)
+  {
+    Collect(1 - PboIdx_);
+    Pending_ = false;
+  }
+
+  Frames_->Close();
+  if (Encoder_.joinable())
+    Encoder_.join();
+  Writer_.release();
+
+  glDeleteBuffers(2, Pbo_);
+  Fbo_.reset();
+  Depth_.reset();
+  Color_.reset();
+
+  TRACE_INFO("Video export done, %ld frames", (long)Written_.load());
+}
+
+void VideoExport::Collect(int idx)
+{
+  TRACE_INFO();
+
+  cv::Mat frame(Height_, Width_, CV_8UC3);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, Pbo_[idx]);
+  void* src = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  if (src != nullptr)
+  {
+    /*GL rows start at the bottom*/
+    cv::flip(cv::Mat(Height_, Width_, CV_8UC3, src), frame, 0);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if (src != nullptr)
+    Frames_->Push(frame);
+}
+
+void VideoExport::EncodeStage()
+{
+  TRACE_INFO();
+
+  cv::Mat frame;
+  while (Frames_->Pop(frame))
+  {
+    Writer_.write(frame);
+    Written_++;
+  }
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdio.h>
+#include <unistd.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <pangolin/pangolin.h>
+
+#include "stage_queue.hpp"
+#include "utility.hpp"
+
+/*
+ * Renders frames offscreen and encodes them into a video file.
+ *
+ * Rendering is redirected into a framebuffer object between Begin() and
+ * End(). The pixels are read back into one of two pixel buffer objects, so
+ * the read of a frame completes while the next one renders, and handed to an
+ * encoder thread one frame later. Begin(), End() and Close() shall be called
+ * in the GL thread.
+ */
+class VideoExport {
+ public:
+  VideoExport();
+  ~VideoExport();
+
+  using Ptr = std::shared_ptr<VideoExport>;
+  using CPtr = std::shared_ptr<const VideoExport>;
+
+  // open the video file and the offscreen target of width x height
+  bool Open(const std::string& file, int width, int height, double fps);
+
+  // redirect rendering to the offscreen target
+  void Begin();
+
+  // read the rendered frame back, and show it on the window if present
+  void End(bool present);
+
+  // encode the frames left and close the file
+  void Close();
+
+  // number of frames written to the file
+  uint64_t GetWritten() { return Written_; }
+
+ private:
+  // hand the frame of a pixel buffer to the encoder
+  void Collect(int idx);
+
+  void EncodeStage();
+
+  static const size_t kQueueSize;
+
+  int Width_ = 0;
+  int Height_ = 0;
+
+  std::unique_ptr<pangolin::GlTexture> Color_;
+  std::unique_ptr<pangolin::GlRenderBuffer> Depth_;
+  std::unique_ptr<pangolin::GlFramebuffer> Fbo_;
+
+  GLuint Pbo_[2] = {0, 0};
+  int PboIdx_ = 0;
+  // the other pixel buffer holds a frame not collected yet
+  bool Pending_ = false;
+
+  cv::VideoWriter Writer_;
+  std::unique_ptr<StageQueue<cv::Mat>> Frames_;
+  std::thread Encoder_;
+  std::atomic<uint64_t> Written_ = {0};
+};
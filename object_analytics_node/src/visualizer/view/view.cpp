@@ -45,6 +45,20 @@ bool View::Add_Obj(RenderObject::Ptr& obj)
   return true;
 }
 
+RenderObject::Ptr View::Recycle_Obj()
+{
+  TRACE_INFO();
+
+  RenderObject::Ptr obj = nullptr;
+  if (Obj_Vec_.size() == Obj_Max_Size_)
+  {
+    obj = Obj_Vec_.front();
+    Obj_Vec_.erase(Obj_Vec_.begin());
+  }
+
+  return obj;
+}
+
 bool View::Remove_Obj(RenderObject::Ptr& obj)
 {
   TRACE_INFO();
@@ -82,8 +96,12 @@ bool View::InitDisplay(float width, float height, float border_ratio)
     Border_Ratio_ = border_ratio;
   }
 
-  // 2. Init OpenGL window
-  pangolin::CreateWindowAndBind("RenderObject Analytics Visuializer", Width_, Height_);
+  // 2. Init OpenGL window, a headless one needs Pangolin built with EGL
+  if (Headless_)
+    pangolin::CreateWindowAndBind("RenderObject Analytics Visuializer", Width_, Height_,
+                                  pangolin::Params({{"scheme", "headless"}}));
+  else
+    pangolin::CreateWindowAndBind("RenderObject Analytics Visuializer", Width_, Height_);
   glEnable(GL_DEPTH_TEST);
 
   // 3. Init render engine (with MVP models)
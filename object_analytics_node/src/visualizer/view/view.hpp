@@ -41,6 +41,10 @@ class View {
   bool InitDisplay(float width = 640.0f, float height = 480.0f,
                    float border_ratio = 0.2f);
 
+  // render without a visible window, to be set before InitDisplay
+  void SetHeadless(bool headless) { Headless_ = headless; }
+  bool IsHeadless() { return Headless_; }
+
   // reset OpenGL to initial state
   void Reset();
 
@@ -50,6 +54,9 @@ class View {
   // remove object from view
   bool Remove_Obj(RenderObject::Ptr& obj);
 
+  // take the oldest object out of a full view, to be reused for a new one
+  RenderObject::Ptr Recycle_Obj();
+
   // render view with all child objects
   void Render();
 
@@ -86,4 +93,7 @@ class View {
   std::uint32_t Obj_Max_Size_;
 
   Layout Layout_;
+
+  // no visible window, rendering goes offscreen
+  bool Headless_ = false;
 };
@@ -0,0 +1,216 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define PCL_NO_PRECOMPILE
+#include <benchmark/benchmark.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "object_analytics_node/model/object3d.hpp"
+#include "object_analytics_node/model/object_utils.hpp"
+#include "object_analytics_node/segmenter/algorithm_provider_impl.hpp"
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
+#include "object_analytics_node/segmenter/segmenter.hpp"
+#include "object_analytics_node/splitter/splitter.hpp"
+#include "unittest_util.hpp"
+
+using object_analytics_node::segmenter::AlgorithmProvider;
+using object_analytics_node::segmenter::AlgorithmProviderImpl;
+using object_analytics_node::segmenter::PointCloud2View;
+using object_analytics_node::segmenter::Segmenter;
+using object_analytics_node::splitter::Splitter;
+
+namespace
+{
+const float kFocal = 525.0f;
+
+/* organized cloud of a wall 2m away, with objects 0.5m before it laid out in a grid*/
+void makeScene(
+  int width, int height, int objects, sensor_msgs::msg::PointCloud2 & msg,
+  ObjectsInBoxes & detections)
+{
+  pcl::PointCloud<pcl::PointXYZRGB> cloud(width, height);
+  std::vector<RegionOfInterest> rois;
+  int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(objects))));
+  int rows = cols > 0 ? (objects + cols - 1) / cols : 0;
+  for (int k = 0; k < objects; k++) {
+    int cell_w = width / cols, cell_h = height / rows;
+    rois.push_back(getRoi((k % cols) * cell_w + cell_w / 4, (k / cols) * cell_h + cell_h / 4,
+      cell_w / 2, cell_h / 2));
+    detections.objects_vector.push_back(getObjectInBox(rois.back().x_offset,
+      rois.back().y_offset, rois.back().width, rois.back().height, "person", 0.9f));
+  }
+  for (int v = 0; v < height; v++) {
+    for (int u = 0; u < width; u++) {
+      float z = 2.0f;
+      for (auto & roi : rois) {
+        if (u >= static_cast<int>(roi.x_offset) && u < static_cast<int>(roi.x_offset + roi.width) &&
+          v >= static_cast<int>(roi.y_offset) && v < static_cast<int>(roi.y_offset + roi.height))
+        {
+          z = 1.5f;
+        }
+      }
+      pcl::PointXYZRGB & p = cloud.at(u, v);
+      p.x = (u - width / 2) * z / kFocal;
+      p.y = (v - height / 2) * z / kFocal;
+      p.z = z;
+      p.r = u;
+      p.g = v;
+      p.b = 128;
+    }
+  }
+  pcl::toROSMsg(cloud, msg);
+}
+
+PointCloudT::Ptr makeCloud(size_t size)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  for (size_t i = 0; i < size; i++) {
+    cloud->points.push_back(getPointT(i % 97 * 0.01f, i % 89 * 0.01f, 1.0f + i % 83 * 0.01f));
+  }
+  cloud->width = size;
+  cloud->height = 1;
+  return cloud;
+}
+
+std::vector<int> makeIndices(size_t size)
+{
+  std::vector<int> indices(size);
+  for (size_t i = 0; i < size; i++) {
+    indices[i] = i;
+  }
+  return indices;
+}
+}  // namespace
+
+static void BM_GetMatch(benchmark::State & state)
+{
+  std::vector<cv::Rect2d> rects;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    rects.push_back(cv::Rect2d(i * 7 % 600, i * 13 % 440, 40 + i % 30, 40 + i % 20));
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (auto & a : rects) {
+      for (auto & b : rects) {
+        sum += ObjectUtils::getMatch(a, b);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_GetMatch)->Arg(8)->Arg(64);
+
+static void BM_CopyPointCloud(benchmark::State & state)
+{
+  PointCloudT::Ptr cloud = makeCloud(state.range(0));
+  std::vector<int> indices = makeIndices(state.range(0));
+  pcl::PointCloud<PointXYZPixel>::Ptr dest(new pcl::PointCloud<PointXYZPixel>);
+  for (auto _ : state) {
+    ObjectUtils::copyPointCloud(cloud, indices, dest);
+    benchmark::DoNotOptimize(dest->points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CopyPointCloud)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_Object3D(benchmark::State & state)
+{
+  PointCloudT::Ptr cloud = makeCloud(state.range(0));
+  std::vector<int> indices = makeIndices(state.range(0));
+  for (auto _ : state) {
+    Object3D object(cloud, indices);
+    benchmark::DoNotOptimize(object);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Object3D)->Arg(1 << 10)->Arg(1 << 16);
+
+/* the copy of Segmenter::getRoiPointCloud(), reading the ROI pixels of the message*/
+static void BM_RoiPointCloud(benchmark::State & state)
+{
+  sensor_msgs::msg::PointCloud2 msg;
+  ObjectsInBoxes detections;
+  makeScene(640, 480, 1, msg, detections);
+  PointCloud2View view(msg);
+  const RegionOfInterest & roi = detections.objects_vector[0].roi;
+  const size_t step = state.range(0);
+  std::vector<int> indices;
+  PointCloudT cloud;
+  for (auto _ : state) {
+    indices.clear();
+    for (size_t u = roi.x_offset; u < roi.x_offset + roi.width; u += step) {
+      for (size_t v = roi.y_offset; v < roi.y_offset + roi.height; v += step) {
+        size_t idx = u + v * view.getWidth();
+        if (view.isFinite(idx)) {
+          indices.push_back(idx);
+        }
+      }
+    }
+    view.copy(indices, cloud);
+    benchmark::DoNotOptimize(cloud.points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(BM_RoiPointCloud)->Arg(1)->Arg(4);
+
+static void BM_Segment(benchmark::State & state)
+{
+  sensor_msgs::msg::PointCloud2::SharedPtr msg = std::make_shared<sensor_msgs::msg::PointCloud2>();
+  ObjectsInBoxes::SharedPtr detections = std::make_shared<ObjectsInBoxes>();
+  makeScene(state.range(0), state.range(0) * 3 / 4, state.range(1), *msg, *detections);
+  Segmenter segmenter(std::unique_ptr<AlgorithmProvider>(new AlgorithmProviderImpl()));
+  segmenter.setSamplingStep(state.range(2));
+  for (auto _ : state) {
+    ObjectsInBoxes3D::SharedPtr objects = std::make_shared<ObjectsInBoxes3D>();
+    segmenter.segment(detections, msg, objects);
+    benchmark::DoNotOptimize(objects->objects_in_boxes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_Segment)->Args({320, 1, 1})->Args({640, 1, 4})->Args({640, 4, 4})
+  ->Args({640, 16, 4})->Unit(benchmark::kMillisecond);
+
+static void BM_SplitPointsToXYZ(benchmark::State & state)
+{
+  sensor_msgs::msg::PointCloud2 msg, xyz;
+  ObjectsInBoxes detections;
+  makeScene(state.range(0), state.range(0) * 3 / 4, 1, msg, detections);
+  for (auto _ : state) {
+    Splitter::splitPointsToXYZ(msg, xyz);
+    benchmark::DoNotOptimize(xyz.data.data());
+  }
+  state.SetBytesProcessed(state.iterations() * msg.data.size());
+}
+BENCHMARK(BM_SplitPointsToXYZ)->Arg(320)->Arg(640);
+
+static void BM_SplitFused(benchmark::State & state)
+{
+  sensor_msgs::msg::PointCloud2 msg, xyz;
+  sensor_msgs::msg::Image image;
+  ObjectsInBoxes detections;
+  makeScene(state.range(0), state.range(0) * 3 / 4, 1, msg, detections);
+  for (auto _ : state) {
+    Splitter::split(msg, image, xyz);
+    benchmark::DoNotOptimize(xyz.data.data());
+  }
+  state.SetBytesProcessed(state.iterations() * msg.data.size());
+}
+BENCHMARK(BM_SplitFused)->Arg(320)->Arg(640);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define PCL_NO_PRECOMPILE
+#include <benchmark/benchmark.h>
+#include <opencv2/imgproc.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <memory>
+#include <vector>
+
+#include "object_analytics_node/tracker/tracking_manager.hpp"
+#include "unittest_util.hpp"
+
+using object_analytics_node::tracker::TrackingManager;
+
+namespace
+{
+/* frame of filled boxes on a gradient, moved by shift pixels to the right*/
+cv::Mat makeFrame(int width, int height, const ObjectsInBoxes & objs, int shift)
+{
+  cv::Mat mat(height, width, CV_8UC3);
+  for (int v = 0; v < height; v++) {
+    mat.row(v).setTo(cv::Scalar(v % 256, 64, 255 - v % 256));
+  }
+  for (auto & obj : objs.objects_vector) {
+    cv::Rect box(obj.roi.x_offset + shift, obj.roi.y_offset, obj.roi.width, obj.roi.height);
+    cv::rectangle(mat, box, cv::Scalar(20, 200, 20), cv::FILLED);
+    cv::circle(mat, (box.tl() + box.br()) / 2, box.width / 4, cv::Scalar(200, 20, 20), cv::FILLED);
+  }
+  return mat;
+}
+
+ObjectsInBoxes::SharedPtr makeObjects(int width, int height, int objects)
+{
+  ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  for (int k = 0; k < objects; k++) {
+    objs->objects_vector.push_back(getObjectInBox((k * 97) % (width - 80), (k * 61) % (height - 80),
+      60, 60, "person", 0.9f));
+  }
+  return objs;
+}
+}  // namespace
+
+static void BM_Detect(benchmark::State & state)
+{
+  rclcpp::Node node("benchmark_detect");
+  ObjectsInBoxes::SharedPtr objs = makeObjects(640, 480, state.range(0));
+  cv::Mat mat = makeFrame(640, 480, *objs, 0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    TrackingManager tm(&node);
+    state.ResumeTiming();
+    tm.detect(mat, objs);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Detect)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_Track(benchmark::State & state)
+{
+  rclcpp::Node node("benchmark_track");
+  ObjectsInBoxes::SharedPtr objs = makeObjects(640, 480, state.range(0));
+  std::vector<cv::Mat> frames;
+  for (int shift = 0; shift < 8; shift++) {
+    frames.push_back(makeFrame(640, 480, *objs, shift));
+  }
+  TrackingManager tm(&node);
+  tm.detect(frames[0], objs);
+  builtin_interfaces::msg::Time stamp;
+  size_t frame = 0;
+  for (auto _ : state) {
+    stamp.nanosec += 33000000;
+    if (stamp.nanosec >= 1000000000) {
+      stamp.sec++;
+      stamp.nanosec -= 1000000000;
+    }
+    tm.track(frames[++frame % frames.size()], stamp);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Track)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
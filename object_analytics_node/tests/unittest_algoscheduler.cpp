@@ -0,0 +1,88 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "object_analytics_node/tracker/algo_scheduler.hpp"
+
+using object_analytics_node::tracker::AlgoScheduler;
+
+TEST(UnitTestAlgoScheduler, schedule_BySize)
+{
+  AlgoScheduler s;
+  s.setLargeArea(100 * 100);
+  std::vector<cv::Rect2d> rects;
+  rects.push_back(cv::Rect2d(0, 0, 200, 200));
+  rects.push_back(cv::Rect2d(0, 0, 20, 20));
+
+  /* disabled, no degrading whatever the cost*/
+  std::vector<std::string> algos = s.schedule(rects);
+  ASSERT_EQ(algos.size(), static_cast<size_t>(2));
+  EXPECT_EQ(algos[0], "KCF");
+  EXPECT_EQ(algos[1], "MEDIAN_FLOW");
+}
+
+TEST(UnitTestAlgoScheduler, schedule_OverBudget)
+{
+  AlgoScheduler s;
+  s.setLargeArea(100 * 100);
+  s.observe("KCF", 3.0);
+  s.observe("MEDIAN_FLOW", 1.0);
+  s.observe("KALMAN", 0.01);
+  std::vector<cv::Rect2d> rects;
+  rects.push_back(cv::Rect2d(0, 0, 200, 200));
+  rects.push_back(cv::Rect2d(0, 0, 20, 20));
+  rects.push_back(cv::Rect2d(0, 0, 30, 30));
+  rects.push_back(cv::Rect2d(0, 0, 150, 150));
+
+  /* 8ms wanted, smallest objects degraded first*/
+  s.setBudget(5, 1);
+  std::vector<std::string> algos = s.schedule(rects);
+  EXPECT_EQ(algos[0], "KCF");
+  EXPECT_EQ(algos[1], "KALMAN");
+  EXPECT_EQ(algos[2], "KALMAN");
+  EXPECT_EQ(algos[3], "MEDIAN_FLOW");
+
+  /* threads share the load*/
+  s.setBudget(5, 2);
+  algos = s.schedule(rects);
+  EXPECT_EQ(algos[0], "KCF");
+  EXPECT_EQ(algos[1], "MEDIAN_FLOW");
+  EXPECT_EQ(algos[2], "MEDIAN_FLOW");
+  EXPECT_EQ(algos[3], "KCF");
+
+  /* all fallback when nothing else fits*/
+  s.setBudget(0.5, 1);
+  algos = s.schedule(rects);
+  for (auto & a : algos) {
+    EXPECT_EQ(a, "KALMAN");
+  }
+}
+
+TEST(UnitTestAlgoScheduler, observe_Smoothing)
+{
+  AlgoScheduler s;
+  s.observe("FOO", 10.0);
+  EXPECT_DOUBLE_EQ(s.getCost("FOO"), 10.0);
+  s.observe("FOO", 20.0);
+  EXPECT_GT(s.getCost("FOO"), 10.0);
+  EXPECT_LT(s.getCost("FOO"), 20.0);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+#include "object_analytics_node/tracker/association.hpp"
+
+using object_analytics_node::tracker::Association;
+
+TEST(UnitTestAssociation, solve_Empty)
+{
+  std::vector<std::vector<double>> scores;
+  EXPECT_TRUE(Association::solve(scores, 0.3).empty());
+
+  scores.resize(2);
+  std::vector<int> assignment = Association::solve(scores, 0.3);
+  ASSERT_EQ(assignment.size(), static_cast<size_t>(2));
+  EXPECT_EQ(assignment[0], -1);
+  EXPECT_EQ(assignment[1], -1);
+}
+
+TEST(UnitTestAssociation, solve_GlobalBetterThanGreedy)
+{
+  // greedy would give row 0 to col 0, leaving row 1 with nothing above 0.3
+  std::vector<std::vector<double>> scores = {{10.0, 9.0}, {8.0, 0.1}};
+  std::vector<int> assignment = Association::solve(scores, 0.3);
+  EXPECT_EQ(assignment[0], 1);
+  EXPECT_EQ(assignment[1], 0);
+}
+
+TEST(UnitTestAssociation, solve_Gated)
+{
+  double x = Association::kInfeasible;
+  std::vector<std::vector<double>> scores = {{x, 5.0}, {x, x}, {2.0, 3.0}};
+  std::vector<int> assignment = Association::solve(scores, 0.3);
+  ASSERT_EQ(assignment.size(), static_cast<size_t>(3));
+  EXPECT_EQ(assignment[0], 1);
+  EXPECT_EQ(assignment[1], -1);
+  EXPECT_EQ(assignment[2], 0);
+}
+
+TEST(UnitTestAssociation, solve_BelowThreshold)
+{
+  std::vector<std::vector<double>> scores = {{0.2, 0.1, 0.3}};
+  std::vector<int> assignment = Association::solve(scores, 0.3);
+  EXPECT_EQ(assignment[0], -1);
+}
+
+TEST(UnitTestAssociation, solve_InfiniteScore)
+{
+  double inf = std::numeric_limits<double>::infinity();
+  double x = Association::kInfeasible;
+  std::vector<std::vector<double>> scores = {{inf, x}, {inf, 0.5}};
+  std::vector<int> assignment = Association::solve(scores, 0.3);
+  EXPECT_EQ(assignment[0], 0);
+  EXPECT_EQ(assignment[1], 1);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+#include "object_analytics_node/tracker/batch_goturn.hpp"
+
+using object_analytics_node::tracker::BatchGoturn;
+
+TEST(UnitTestBatchGoturn, Region)
+{
+  cv::Rect2d region = BatchGoturn::getRegion(cv::Rect2d(100, 100, 40, 20));
+  EXPECT_DOUBLE_EQ(region.x, 80);
+  EXPECT_DOUBLE_EQ(region.y, 90);
+  EXPECT_DOUBLE_EQ(region.width, 80);
+  EXPECT_DOUBLE_EQ(region.height, 40);
+}
+
+TEST(UnitTestBatchGoturn, CropReplicatesBorder)
+{
+  cv::Mat bgr(100, 100, CV_8UC3, cv::Scalar(10, 20, 30));
+  cv::Mat patch;
+  BatchGoturn::crop(bgr, cv::Rect2d(-50, -50, 200, 200), patch);
+  EXPECT_EQ(patch.cols, BatchGoturn::kInputSize);
+  EXPECT_EQ(patch.rows, BatchGoturn::kInputSize);
+  EXPECT_EQ(patch.type(), CV_8UC3);
+  /* the frame is uniform, so is its padding*/
+  cv::Mat expected(patch.size(), CV_8UC3, cv::Scalar(10, 20, 30));
+  EXPECT_EQ(cv::norm(patch, expected, cv::NORM_INF), 0);
+}
+
+TEST(UnitTestBatchGoturn, Seed)
+{
+  cv::Mat bgr(240, 320, CV_8UC3, cv::Scalar::all(0));
+  BatchGoturn::Target target;
+  BatchGoturn::seed(bgr, cv::Rect2d(10, 20, 30, 40), target);
+  EXPECT_EQ(target.rect, cv::Rect2d(10, 20, 30, 40));
+  EXPECT_EQ(target.patch.size(), cv::Size(BatchGoturn::kInputSize, BatchGoturn::kInputSize));
+}
+
+TEST(UnitTestBatchGoturn, Device)
+{
+  int backend = 0, target = 0;
+  EXPECT_FALSE(BatchGoturn::parseDevice("TPU", backend, target));
+#if CV_VERSION_MAJOR > 3 || CV_VERSION_MINOR >= 4
+  EXPECT_TRUE(BatchGoturn::parseDevice("CPU", backend, target));
+  EXPECT_TRUE(BatchGoturn::parseDevice("MYRIAD", backend, target));
+  EXPECT_TRUE(BatchGoturn::parseDevice("OPENCV", backend, target));
+#endif
+}
+
+TEST(UnitTestBatchGoturn, NotLoaded)
+{
+  BatchGoturn batch;
+  std::string error;
+  EXPECT_FALSE(batch.load("/nonexistent/goturn.prototxt", "/nonexistent/goturn.caffemodel",
+    "OPENCV", error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(batch.isLoaded());
+
+  cv::Mat bgr(240, 320, CV_8UC3, cv::Scalar::all(0));
+  BatchGoturn::Target target;
+  BatchGoturn::seed(bgr, cv::Rect2d(10, 20, 30, 40), target);
+  std::vector<char> tracked;
+  EXPECT_FALSE(batch.update(bgr, {&target}, tracked));
+  ASSERT_EQ(tracked.size(), 1u);
+  EXPECT_FALSE(tracked[0]);
+  EXPECT_EQ(batch.getForwards(), 0u);
+  /* nothing to track is no failure*/
+  EXPECT_TRUE(batch.update(bgr, {}, tracked));
+  EXPECT_TRUE(tracked.empty());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "object_analytics_node/dataset/box_cache.hpp"
+
+using datasets::BoxCache;
+using datasets::Obj_;
+
+static std::string tmpPath(const std::string & name)
+{
+  return "/tmp/unittest_boxcache_" + std::to_string(getpid()) + "_" + name;
+}
+
+static void writeFile(const std::string & path, const std::string & content)
+{
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << content;
+}
+
+static std::vector<std::vector<Obj_>> getFrames(size_t frames, int seed)
+{
+  std::vector<std::vector<Obj_>> out(frames);
+  for (size_t i = 0; i < frames; i++) {
+    for (size_t k = 0; k < i % 3; k++) {
+      out[i].push_back({static_cast<int>(k), cv::Rect2d(seed + i + 0.5, k + 0.25, 10.0, 20.0),
+          0.5f + 0.1f * k});
+    }
+  }
+  return out;
+}
+
+static void expectSame(
+  const std::vector<std::vector<Obj_>> & expected, const std::vector<std::vector<Obj_>> & frames)
+{
+  ASSERT_EQ(expected.size(), frames.size());
+  for (size_t i = 0; i < frames.size(); i++) {
+    ASSERT_EQ(expected[i].size(), frames[i].size());
+    for (size_t k = 0; k < frames[i].size(); k++) {
+      EXPECT_EQ(expected[i][k].objIdx, frames[i][k].objIdx);
+      EXPECT_EQ(expected[i][k].bb, frames[i][k].bb);
+      EXPECT_EQ(expected[i][k].confidence, frames[i][k].confidence);
+    }
+  }
+}
+
+/* sources and cache of one test, removed at its end*/
+struct CacheFiles
+{
+  CacheFiles()
+  : gtFile(tmpPath("gt.txt")), detFile(tmpPath("det.txt")), cache(tmpPath("boxes.cache")),
+    sources({gtFile, detFile})
+  {
+    writeFile(gtFile, "ground truth");
+    writeFile(detFile, "detections");
+  }
+
+  ~CacheFiles()
+  {
+    std::remove(gtFile.c_str());
+    std::remove(detFile.c_str());
+    std::remove(cache.c_str());
+  }
+
+  std::string gtFile, detFile, cache;
+  std::vector<std::string> sources;
+};
+
+TEST(UnitTestBoxCache, load_Hit)
+{
+  CacheFiles f;
+  std::vector<std::vector<Obj_>> gt = getFrames(7, 0), det = getFrames(5, 100);
+  ASSERT_TRUE(BoxCache::save(f.cache, f.sources, gt, det));
+  EXPECT_FALSE(std::ifstream(f.cache + ".tmp").good());
+
+  std::vector<std::vector<Obj_>> gtOut, detOut;
+  ASSERT_TRUE(BoxCache::load(f.cache, f.sources, gtOut, detOut));
+  expectSame(gt, gtOut);
+  expectSame(det, detOut);
+
+  /* no frames at all is cached too*/
+  ASSERT_TRUE(BoxCache::save(f.cache, f.sources, {}, {}));
+  ASSERT_TRUE(BoxCache::load(f.cache, f.sources, gtOut, detOut));
+  EXPECT_TRUE(gtOut.empty());
+  EXPECT_TRUE(detOut.empty());
+}
+
+TEST(UnitTestBoxCache, load_Miss)
+{
+  CacheFiles f;
+  std::vector<std::vector<Obj_>> gtOut = getFrames(2, 0), detOut;
+
+  /* no cache yet*/
+  EXPECT_FALSE(BoxCache::load(f.cache, f.sources, gtOut, detOut));
+  ASSERT_TRUE(BoxCache::save(f.cache, f.sources, getFrames(4, 0), getFrames(4, 0)));
+
+  /* other sources, or a source gone*/
+  EXPECT_FALSE(BoxCache::load(f.cache, {f.gtFile}, gtOut, detOut));
+  EXPECT_FALSE(BoxCache::load(f.cache, {f.detFile, f.gtFile}, gtOut, detOut));
+  EXPECT_FALSE(BoxCache::load(f.cache, {f.gtFile, tmpPath("missing")}, gtOut, detOut));
+  EXPECT_FALSE(BoxCache::save(f.cache, {f.gtFile, tmpPath("missing")}, gtOut, detOut));
+  std::vector<std::string> many(5, f.gtFile);
+  EXPECT_FALSE(BoxCache::save(f.cache, many, gtOut, detOut));
+
+  /* truncated or not a cache*/
+  std::ifstream in(f.cache, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  writeFile(f.cache, bytes.substr(0, bytes.size() - 1));
+  EXPECT_FALSE(BoxCache::load(f.cache, f.sources, gtOut, detOut));
+  writeFile(f.cache, std::string(bytes.size(), 'x'));
+  EXPECT_FALSE(BoxCache::load(f.cache, f.sources, gtOut, detOut));
+
+  /* outputs untouched on a miss*/
+  expectSame(getFrames(2, 0), gtOut);
+  EXPECT_TRUE(detOut.empty());
+}
+
+TEST(UnitTestBoxCache, load_StaleEvicted)
+{
+  CacheFiles f;
+  ASSERT_TRUE(BoxCache::save(f.cache, f.sources, getFrames(3, 0), getFrames(3, 0)));
+
+  /* the source changes, the cache is stale till written again*/
+  writeFile(f.detFile, "detections, updated");
+  std::vector<std::vector<Obj_>> gtOut, detOut;
+  EXPECT_FALSE(BoxCache::load(f.cache, f.sources, gtOut, detOut));
+  EXPECT_TRUE(gtOut.empty());
+
+  std::vector<std::vector<Obj_>> gt = getFrames(6, 10), det = getFrames(2, 20);
+  ASSERT_TRUE(BoxCache::save(f.cache, f.sources, gt, det));
+  ASSERT_TRUE(BoxCache::load(f.cache, f.sources, gtOut, detOut));
+  expectSame(gt, gtOut);
+  expectSame(det, detOut);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
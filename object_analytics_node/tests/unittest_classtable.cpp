@@ -0,0 +1,59 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "object_analytics_node/util/class_table.hpp"
+
+using object_analytics_node::util::ClassTable;
+
+TEST(UnitTestClassTable, intern_SameNameSameId)
+{
+  int32_t person = ClassTable::intern("person");
+  int32_t dog = ClassTable::intern("dog");
+  EXPECT_NE(person, dog);
+  EXPECT_EQ(ClassTable::intern("person"), person);
+  EXPECT_EQ(ClassTable::name(person), std::string("person"));
+  EXPECT_EQ(ClassTable::name(dog), std::string("dog"));
+}
+
+TEST(UnitTestClassTable, name_UnknownIdIsEmpty)
+{
+  EXPECT_EQ(ClassTable::name(-1), std::string(""));
+  EXPECT_EQ(ClassTable::name(static_cast<int32_t>(ClassTable::size())), std::string(""));
+}
+
+TEST(UnitTestClassTable, intern_Concurrent)
+{
+  std::vector<int32_t> ids(8, -1);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < ids.size(); i++) {
+    threads.emplace_back([&ids, i]() {ids[i] = ClassTable::intern("bicycle");});
+  }
+  for (auto & t : threads) {
+    t.join();
+  }
+  for (auto id : ids) {
+    EXPECT_EQ(id, ids[0]);
+  }
+  EXPECT_EQ(ClassTable::name(ids[0]), std::string("bicycle"));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define PCL_NO_PRECOMPILE
+#include <gtest/gtest.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
+#include "object_analytics_node/util/cloud_codec.hpp"
+#include "unittest_util.hpp"
+
+using object_analytics_node::segmenter::PointCloud2View;
+using object_analytics_node::util::CloudCodec;
+using object_analytics_msgs::msg::CompressedPointCloud;
+
+static void getCloud(sensor_msgs::msg::PointCloud2 & msg)
+{
+  pcl::PointCloud<pcl::PointXYZRGB> cloud(64, 48);
+  for (size_t i = 0; i < cloud.size(); i++) {
+    cloud.points[i].x = (static_cast<float>(i % 64) - 32) * 0.01f;
+    cloud.points[i].y = (static_cast<float>(i / 64) - 24) * 0.01f;
+    cloud.points[i].z = 1.5f + 0.0001f * i;
+  }
+  cloud.points[10].z = std::numeric_limits<float>::quiet_NaN();
+  cloud.points[20].z = 40.0f;
+  cloud.is_dense = false;
+  pcl::toROSMsg(cloud, msg);
+}
+
+TEST(UnitTestCloudCodec, decode_SameAsEncodedInResolution)
+{
+  sensor_msgs::msg::PointCloud2 msg, decoded;
+  getCloud(msg);
+  CompressedPointCloud compressed;
+  CloudCodec::encode(msg, compressed);
+  EXPECT_EQ(compressed.raw_size, msg.width * msg.height * 3 * sizeof(int16_t));
+  EXPECT_LT(compressed.data.size(), compressed.raw_size / 2);
+
+  CloudCodec::decode(compressed, decoded);
+  EXPECT_EQ(decoded.header, msg.header);
+  EXPECT_EQ(decoded.width, msg.width);
+  EXPECT_EQ(decoded.height, msg.height);
+  ASSERT_TRUE(PointCloud2View::isSupported(decoded));
+  PointCloud2View in(msg), out(decoded);
+  for (size_t i = 0; i < in.size(); i++) {
+    if (i == 10 || i == 20) {
+      /* not finite or out of range*/
+      EXPECT_FALSE(out.isFinite(i));
+      continue;
+    }
+    EXPECT_NEAR(in.at(i).x, out.at(i).x, CloudCodec::kResolution / 2 + 1e-6);
+    EXPECT_NEAR(in.at(i).y, out.at(i).y, CloudCodec::kResolution / 2 + 1e-6);
+    EXPECT_NEAR(in.at(i).z, out.at(i).z, CloudCodec::kResolution / 2 + 1e-6);
+  }
+}
+
+TEST(UnitTestCloudCodec, decode_ThrowsOnCorruptedData)
+{
+  sensor_msgs::msg::PointCloud2 msg, decoded;
+  getCloud(msg);
+  CompressedPointCloud compressed;
+  CloudCodec::encode(msg, compressed);
+  compressed.data.resize(compressed.data.size() / 2);
+  EXPECT_THROW(CloudCodec::decode(compressed, decoded), std::runtime_error);
+
+  CloudCodec::encode(msg, compressed);
+  compressed.width = 10;
+  EXPECT_THROW(CloudCodec::decode(compressed, decoded), std::runtime_error);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <string>
+#include "object_analytics_node/util/class_table.hpp"
+#include "object_analytics_node/util/compact_objects.hpp"
+
+using object_analytics_node::util::ClassTable;
+using object_analytics_node::util::CompactObjects;
+using object_analytics_msgs::msg::ClassNames;
+using object_analytics_msgs::msg::CompactObjectsInBoxes3D;
+using object_analytics_msgs::msg::ObjectInBox3D;
+using object_analytics_msgs::msg::ObjectsInBoxes3D;
+
+static ObjectInBox3D getObject(const std::string & name, int i)
+{
+  ObjectInBox3D o;
+  o.object.object_name = name;
+  o.object.probability = 0.5f + 0.01f * i;
+  o.roi.x_offset = 10 * i;
+  o.roi.y_offset = 20 * i;
+  o.roi.width = 30 + i;
+  o.roi.height = 40 + i;
+  o.min.x = -0.1f * i;
+  o.min.y = -0.2f * i;
+  o.min.z = 1.0f + i;
+  o.max.x = 0.1f * i;
+  o.max.y = 0.2f * i;
+  o.max.z = 1.5f + i;
+  o.id = i % 2 ? i : -1;
+  return o;
+}
+
+TEST(UnitTestCompactObjects, unpack_SameAsPacked)
+{
+  ObjectsInBoxes3D objs, unpacked;
+  objs.header.frame_id = "camera";
+  objs.header.stamp.sec = 7;
+  for (int i = 0; i < 100; i++) {
+    objs.objects_in_boxes.push_back(getObject(i % 3 ? "person" : "car", i));
+  }
+  CompactObjectsInBoxes3D compact;
+  CompactObjects::pack(objs, compact);
+  EXPECT_EQ(compact.class_ids.size(), 100u);
+  EXPECT_EQ(compact.rois.size(), 400u);
+  EXPECT_EQ(compact.bounds.size(), 600u);
+  EXPECT_EQ(compact.class_ids[1], ClassTable::intern("person"));
+  EXPECT_EQ(compact.class_ids[0], ClassTable::intern("car"));
+  EXPECT_LE(static_cast<size_t>(compact.class_count), ClassTable::size());
+
+  ClassNames names;
+  CompactObjects::getNames(names);
+  EXPECT_EQ(names.names.size(), ClassTable::size());
+  ASSERT_TRUE(CompactObjects::unpack(compact, names, unpacked));
+  EXPECT_EQ(unpacked.header, objs.header);
+  EXPECT_EQ(unpacked.objects_in_boxes, objs.objects_in_boxes);
+}
+
+TEST(UnitTestCompactObjects, unpack_UnknownClassEmpty)
+{
+  ObjectsInBoxes3D objs, unpacked;
+  objs.objects_in_boxes.push_back(getObject("bicycle", 1));
+  CompactObjectsInBoxes3D compact;
+  CompactObjects::pack(objs, compact);
+  ASSERT_TRUE(CompactObjects::unpack(compact, ClassNames(), unpacked));
+  ASSERT_EQ(unpacked.objects_in_boxes.size(), 1u);
+  EXPECT_EQ(unpacked.objects_in_boxes[0].object.object_name, std::string(""));
+  EXPECT_EQ(unpacked.objects_in_boxes[0].id, 1);
+}
+
+TEST(UnitTestCompactObjects, unpack_InconsistentSizesFail)
+{
+  ObjectsInBoxes3D objs, unpacked;
+  objs.objects_in_boxes.push_back(getObject("person", 2));
+  CompactObjectsInBoxes3D compact;
+  CompactObjects::pack(objs, compact);
+  compact.bounds.pop_back();
+  ClassNames names;
+  CompactObjects::getNames(names);
+  EXPECT_FALSE(CompactObjects::unpack(compact, names, unpacked));
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sensor_msgs/image_encodings.hpp>
+#include <cstring>
+#include <vector>
+#include "object_analytics_node/segmenter/depth_segmenter.hpp"
+
+using object_analytics_node::segmenter::DepthSegmenter;
+
+namespace
+{
+/* a 40 x 30 depth image, the background at 3m and a 10 x 10 box at 1m from (10, 5)*/
+sensor_msgs::msg::Image getDepthImage(const std::string & encoding)
+{
+  sensor_msgs::msg::Image image;
+  image.width = 40;
+  image.height = 30;
+  image.encoding = encoding;
+  size_t pixel_size = encoding == sensor_msgs::image_encodings::TYPE_32FC1 ? 4 : 2;
+  image.step = image.width * pixel_size;
+  image.data.resize(image.step * image.height);
+  for (uint32_t v = 0; v < image.height; v++) {
+    for (uint32_t u = 0; u < image.width; u++) {
+      bool box = u >= 10 && u < 20 && v >= 5 && v < 15;
+      uint16_t millimeters = box ? 1000 + u - 10 : 3000;
+      uint8_t * pixel = &image.data[v * image.step + u * pixel_size];
+      if (pixel_size == 4) {
+        float meters = millimeters / 1000.0f;
+        std::memcpy(pixel, &meters, sizeof(meters));
+      } else {
+        std::memcpy(pixel, &millimeters, sizeof(millimeters));
+      }
+    }
+  }
+  return image;
+}
+
+object_msgs::msg::ObjectsInBoxes getObjects()
+{
+  object_msgs::msg::ObjectsInBoxes objs;
+  object_msgs::msg::ObjectInBox obj;
+  obj.object.object_name = "box";
+  obj.roi.x_offset = 8;
+  obj.roi.y_offset = 3;
+  obj.roi.width = 14;
+  obj.roi.height = 14;
+  objs.objects_vector.push_back(obj);
+  /* only background within*/
+  obj.roi.x_offset = 25;
+  obj.roi.y_offset = 20;
+  obj.roi.width = 10;
+  obj.roi.height = 10;
+  objs.objects_vector.push_back(obj);
+  return objs;
+}
+
+sensor_msgs::msg::CameraInfo getCameraInfo()
+{
+  sensor_msgs::msg::CameraInfo info;
+  info.k = {100.0, 0.0, 20.0, 0.0, 100.0, 15.0, 0.0, 0.0, 1.0};
+  return info;
+}
+}  // namespace
+
+TEST(UnitTestDepthSegmenter, segment_BoxBounds)
+{
+  for (auto encoding : {sensor_msgs::image_encodings::TYPE_16UC1,
+      sensor_msgs::image_encodings::TYPE_32FC1})
+  {
+    DepthSegmenter segmenter;
+    segmenter.setIntrinsics(getCameraInfo());
+    object_analytics_msgs::msg::ObjectsInBoxes3D msg;
+    ASSERT_TRUE(segmenter.segment(getObjects(), getDepthImage(encoding), msg));
+    ASSERT_EQ(msg.objects_in_boxes.size(), 2u);
+
+    auto & box = msg.objects_in_boxes[0];
+    EXPECT_EQ(box.object.object_name, "box");
+    EXPECT_EQ(box.roi.x_offset, 8u);
+    EXPECT_NEAR(box.min.z, 1.0, 1e-6);
+    EXPECT_NEAR(box.max.z, 1.009, 1e-6);
+    EXPECT_NEAR(box.min.x, -0.1 * 1.009, 1e-6);
+    EXPECT_NEAR(box.max.x, -0.01 * 1.0, 1e-6);
+    EXPECT_NEAR(box.min.y, -0.1 * 1.009, 1e-6);
+    EXPECT_NEAR(box.max.y, -0.01 * 1.0, 1e-6);
+
+    auto & background = msg.objects_in_boxes[1];
+    EXPECT_NEAR(background.min.z, 3.0, 1e-6);
+    EXPECT_NEAR(background.max.z, 3.0, 1e-6);
+  }
+}
+
+TEST(UnitTestDepthSegmenter, segment_SamplingStep)
+{
+  DepthSegmenter segmenter;
+  segmenter.setIntrinsics(getCameraInfo());
+  segmenter.setSamplingStep(3);
+  segmenter.setMinimumSamples(5);
+  object_msgs::msg::ObjectsInBoxes objs = getObjects();
+  objs.objects_vector.resize(1);
+  objs.objects_vector[0].roi.x_offset = 9;
+  objs.objects_vector[0].roi.y_offset = 4;
+  objs.objects_vector[0].roi.width = 12;
+  objs.objects_vector[0].roi.height = 12;
+  object_analytics_msgs::msg::ObjectsInBoxes3D msg;
+  ASSERT_TRUE(segmenter.segment(objs,
+    getDepthImage(sensor_msgs::image_encodings::TYPE_16UC1), msg));
+  ASSERT_EQ(msg.objects_in_boxes.size(), 1u);
+  EXPECT_NEAR(msg.objects_in_boxes[0].min.z, 1.002, 1e-6);
+  EXPECT_NEAR(msg.objects_in_boxes[0].max.z, 1.008, 1e-6);
+  EXPECT_NEAR(msg.objects_in_boxes[0].min.x, -0.08 * 1.008, 1e-6);
+
+  /* too few samples*/
+  segmenter.setMinimumSamples(10);
+  msg.objects_in_boxes.clear();
+  ASSERT_TRUE(segmenter.segment(objs,
+    getDepthImage(sensor_msgs::image_encodings::TYPE_16UC1), msg));
+  EXPECT_TRUE(msg.objects_in_boxes.empty());
+}
+
+TEST(UnitTestDepthSegmenter, segment_Unsupported)
+{
+  DepthSegmenter segmenter;
+  object_analytics_msgs::msg::ObjectsInBoxes3D msg;
+  EXPECT_FALSE(segmenter.segment(getObjects(),
+    getDepthImage(sensor_msgs::image_encodings::TYPE_16UC1), msg));
+  segmenter.setIntrinsics(getCameraInfo());
+  EXPECT_FALSE(segmenter.segment(getObjects(), getDepthImage("rgb8"), msg));
+  EXPECT_TRUE(msg.objects_in_boxes.empty());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/detection_filter.hpp"
+
+using object_analytics_node::util::DetectionFilter;
+
+static object_msgs::msg::ObjectInBox makeObject(
+  const std::string & name, float probability, uint32_t width, uint32_t height)
+{
+  object_msgs::msg::ObjectInBox obj;
+  obj.object.object_name = name;
+  obj.object.probability = probability;
+  obj.roi.width = width;
+  obj.roi.height = height;
+  return obj;
+}
+
+TEST(UnitTestDetectionFilter, accept_DefaultAcceptsAll)
+{
+  DetectionFilter filter;
+  EXPECT_TRUE(filter.accept(makeObject("person", 0.0f, 0, 0)));
+  EXPECT_TRUE(filter.accept(makeObject("", 1.0f, 10, 10)));
+}
+
+TEST(UnitTestDetectionFilter, accept_ProbabilityAndArea)
+{
+  DetectionFilter filter;
+  filter.setMinProbability(0.5f);
+  filter.setMinArea(100);
+  EXPECT_FALSE(filter.accept(makeObject("person", 0.4f, 20, 20)));
+  EXPECT_FALSE(filter.accept(makeObject("person", 0.9f, 9, 10)));
+  EXPECT_TRUE(filter.accept(makeObject("person", 0.5f, 10, 10)));
+}
+
+TEST(UnitTestDetectionFilter, accept_Classes)
+{
+  DetectionFilter filter;
+  filter.setClasses(std::vector<std::string>{"person", "car"});
+  EXPECT_TRUE(filter.accept(makeObject("person", 0.9f, 10, 10)));
+  EXPECT_TRUE(filter.accept(makeObject("car", 0.9f, 10, 10)));
+  EXPECT_FALSE(filter.accept(makeObject("chair", 0.9f, 10, 10)));
+
+  filter.setClasses(std::vector<std::string>());
+  EXPECT_TRUE(filter.accept(makeObject("chair", 0.9f, 10, 10)));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "object_analytics_node/dataset/frame_prefetcher.hpp"
+
+using datasets::FramePrefetcher;
+
+/* frames of a constant gray level each, so the order can be checked*/
+static std::vector<std::string> writeFrames(int count)
+{
+  std::vector<std::string> paths;
+  for (int i = 0; i < count; i++) {
+    std::string path = "/tmp/unittest_frameprefetcher_" + std::to_string(getpid()) + "_" +
+      std::to_string(i) + ".png";
+    cv::imwrite(path, cv::Mat(8, 8, CV_8UC3, cv::Scalar::all(i * 10)));
+    paths.push_back(path);
+  }
+  return paths;
+}
+
+TEST(UnitTestFramePrefetcher, next_InOrder)
+{
+  std::vector<std::string> paths = writeFrames(12);
+  FramePrefetcher prefetcher(4, 3);
+  prefetcher.start(paths);
+  cv::Mat frame;
+  for (int i = 0; i < 12; i++) {
+    ASSERT_TRUE(prefetcher.next(frame));
+    EXPECT_EQ(frame.type(), CV_8UC3);
+    EXPECT_EQ(frame.at<cv::Vec3b>(0, 0)[0], i * 10);
+  }
+  EXPECT_FALSE(prefetcher.next(frame));
+}
+
+TEST(UnitTestFramePrefetcher, start_Restarts)
+{
+  std::vector<std::string> paths = writeFrames(6);
+  FramePrefetcher prefetcher(2, 2);
+  prefetcher.start(paths);
+  cv::Mat frame;
+  ASSERT_TRUE(prefetcher.next(frame));
+  prefetcher.start(paths, 4);
+  ASSERT_TRUE(prefetcher.next(frame));
+  EXPECT_EQ(frame.at<cv::Vec3b>(0, 0)[0], 40);
+}
+
+TEST(UnitTestFramePrefetcher, next_SharedFrameKept)
+{
+  std::vector<std::string> paths = writeFrames(4);
+  FramePrefetcher prefetcher(1, 1);
+  prefetcher.start(paths);
+  cv::Mat frame;
+  ASSERT_TRUE(prefetcher.next(frame));
+  cv::Mat kept = frame;
+  for (int i = 1; i < 4; i++) {
+    ASSERT_TRUE(prefetcher.next(frame));
+  }
+  EXPECT_EQ(kept.at<cv::Vec3b>(0, 0)[0], 0);
+}
+
+TEST(UnitTestFramePrefetcher, next_MissingFileFails)
+{
+  std::vector<std::string> paths = writeFrames(1);
+  paths.push_back("/tmp/unittest_frameprefetcher_missing.png");
+  FramePrefetcher prefetcher(2, 1);
+  prefetcher.start(paths);
+  cv::Mat frame;
+  EXPECT_TRUE(prefetcher.next(frame));
+  EXPECT_FALSE(prefetcher.next(frame));
+  EXPECT_TRUE(frame.empty());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
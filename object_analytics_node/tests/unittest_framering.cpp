@@ -0,0 +1,103 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "frame_ring.hpp"
+
+TEST(UnitTestFrameRing, push_FullAndEmpty)
+{
+  frame_ring<int> ring(2);
+  EXPECT_EQ(static_cast<size_t>(2), ring.depth());
+  int item = 0;
+  EXPECT_FALSE(ring.pop(item));
+
+  int a = 1, b = 2, c = 3;
+  EXPECT_TRUE(ring.push(a));
+  EXPECT_TRUE(ring.push(b));
+  EXPECT_FALSE(ring.push(c));
+  EXPECT_EQ(static_cast<size_t>(2), ring.size());
+
+  /* the oldest first*/
+  ASSERT_TRUE(ring.pop(item));
+  EXPECT_EQ(1, item);
+  EXPECT_TRUE(ring.push(c));
+  ASSERT_TRUE(ring.pop(item));
+  EXPECT_EQ(2, item);
+  ASSERT_TRUE(ring.pop(item));
+  EXPECT_EQ(3, item);
+  EXPECT_EQ(static_cast<size_t>(0), ring.size());
+}
+
+TEST(UnitTestFrameRing, push_ZeroDepthHoldsOne)
+{
+  frame_ring<int> ring(0);
+  EXPECT_EQ(static_cast<size_t>(1), ring.depth());
+  int a = 1;
+  EXPECT_TRUE(ring.push(a));
+  EXPECT_FALSE(ring.push(a));
+}
+
+TEST(UnitTestFrameRing, push_SwapsBuffers)
+{
+  /* the slot content is handed back, buffers go round between the two sides*/
+  frame_ring<std::vector<int>> ring(1);
+  std::vector<int> in(100, 7);
+  const int * buffer = in.data();
+  ASSERT_TRUE(ring.push(in));
+  EXPECT_TRUE(in.empty());
+
+  std::vector<int> out;
+  ASSERT_TRUE(ring.pop(out));
+  EXPECT_EQ(buffer, out.data());
+  ASSERT_EQ(static_cast<size_t>(100), out.size());
+
+  std::vector<int> next(1, 8);
+  ASSERT_TRUE(ring.push(next));
+  EXPECT_TRUE(next.empty());
+}
+
+TEST(UnitTestFrameRing, pop_InOrderAcrossThreads)
+{
+  const int count = 10000;
+  frame_ring<int> ring(4);
+  std::thread producer([&ring]() {
+      for (int i = 0; i < count; i++) {
+        int item = i;
+        while (!ring.push(item)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  int expected = 0;
+  while (expected < count) {
+    int item = -1;
+    if (ring.pop(item)) {
+      ASSERT_EQ(expected, item);
+      expected++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  EXPECT_EQ(static_cast<size_t>(0), ring.size());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
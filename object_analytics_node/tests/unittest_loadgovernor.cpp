@@ -0,0 +1,88 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include "object_analytics_node/governor/load_governor.hpp"
+
+using object_analytics_node::governor::LoadGovernor;
+
+static LoadGovernor::Options options()
+{
+  LoadGovernor::Options opts;
+  opts.target_ms = 100;
+  opts.risk = 0.9;
+  opts.headroom = 0.6;
+  opts.max_level = 3;
+  opts.up_periods = 3;
+  opts.settle_periods = 1;
+  return opts;
+}
+
+TEST(UnitTestLoadGovernor, update_StepsDownAtRiskAfterSettling)
+{
+  LoadGovernor governor(options());
+  EXPECT_EQ(0, governor.update(80));
+  EXPECT_EQ(1, governor.update(95));
+  /* the step settles for a period whatever the latency*/
+  EXPECT_EQ(1, governor.update(200));
+  EXPECT_EQ(2, governor.update(200));
+  EXPECT_EQ(2, governor.update(200));
+  EXPECT_EQ(3, governor.update(200));
+  EXPECT_EQ(3, governor.update(200));
+  /* the lowest level is kept*/
+  EXPECT_EQ(3, governor.update(200));
+  EXPECT_EQ(3u, governor.getSteps());
+}
+
+TEST(UnitTestLoadGovernor, update_StepsUpAfterHeadroomPeriods)
+{
+  LoadGovernor governor(options());
+  governor.update(200);
+  governor.update(200);
+  governor.update(200);
+  ASSERT_EQ(2, governor.getLevel());
+  governor.update(50);
+  /* latency between headroom and risk resets the calm periods*/
+  EXPECT_EQ(2, governor.update(50));
+  EXPECT_EQ(2, governor.update(70));
+  EXPECT_EQ(2, governor.update(50));
+  EXPECT_EQ(2, governor.update(50));
+  EXPECT_EQ(1, governor.update(50));
+  EXPECT_EQ(1, governor.update(50));
+  EXPECT_EQ(1, governor.update(50));
+  EXPECT_EQ(1, governor.update(50));
+  EXPECT_EQ(0, governor.update(50));
+  EXPECT_EQ(0, governor.update(10));
+}
+
+TEST(UnitTestLoadGovernor, update_KeepsLevelWithoutData)
+{
+  LoadGovernor governor(options());
+  governor.update(200);
+  governor.update(200);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(1, governor.update(0));
+  }
+}
+
+TEST(UnitTestLoadGovernor, update_StepsDownOnQueueLimit)
+{
+  LoadGovernor::Options opts = options();
+  opts.queue_limit = 5;
+  LoadGovernor governor(opts);
+  EXPECT_EQ(0, governor.update(10, 4));
+  EXPECT_EQ(1, governor.update(10, 5));
+  EXPECT_EQ(1, governor.update(0, 8));
+  EXPECT_EQ(2, governor.update(0, 8));
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include "object_analytics_node/util/memory_account.hpp"
+
+using object_analytics_node::util::MemoryAccount;
+using PipelineStatsMsg = object_analytics_msgs::msg::PipelineStats;
+
+TEST(UnitTestMemoryAccount, update_KeepsHighWaterMark)
+{
+  MemoryAccount account("test.memory");
+  account.update(100);
+  account.update(300);
+  account.update(200);
+  EXPECT_EQ(account.getBytes(), 200u);
+  EXPECT_EQ(account.getPeak(), 300u);
+}
+
+TEST(UnitTestMemoryAccount, isOver_ZeroLimitUnlimited)
+{
+  MemoryAccount unlimited("test.unlimited");
+  EXPECT_FALSE(unlimited.isOver(UINT64_MAX));
+
+  MemoryAccount limited("test.limited", 1024);
+  EXPECT_FALSE(limited.isOver(1024));
+  EXPECT_TRUE(limited.isOver(1025));
+}
+
+TEST(UnitTestMemoryAccount, collect_AppendsToArrays)
+{
+  MemoryAccount first("test.first", 10);
+  MemoryAccount second("test.second");
+  first.update(4);
+  second.update(7);
+  second.update(5);
+
+  PipelineStatsMsg msg;
+  first.collect(msg);
+  second.collect(msg);
+  ASSERT_EQ(msg.memory_names.size(), 2u);
+  EXPECT_EQ(msg.memory_names[1], "test.second");
+  EXPECT_EQ(msg.memory_bytes[0], 4u);
+  EXPECT_EQ(msg.memory_bytes[1], 5u);
+  EXPECT_EQ(msg.memory_peaks[1], 7u);
+  EXPECT_EQ(msg.memory_limits[0], 10u);
+  EXPECT_EQ(msg.memory_limits[1], 0u);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
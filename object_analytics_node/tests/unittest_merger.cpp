@@ -0,0 +1,153 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include "object_analytics_node/merger/merger.hpp"
+
+using object_analytics_node::merger::Merger;
+using object_analytics_msgs::msg::MovingObjects;
+using object_analytics_msgs::msg::ObjectInBox3D;
+using object_analytics_msgs::msg::ObjectsInBoxes3D;
+using object_analytics_msgs::msg::TrackedObject;
+using object_analytics_msgs::msg::TrackedObjects;
+
+static sensor_msgs::msg::RegionOfInterest roi(uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+{
+  sensor_msgs::msg::RegionOfInterest r;
+  r.x_offset = x;
+  r.y_offset = y;
+  r.width = w;
+  r.height = h;
+  return r;
+}
+
+static TrackedObject track(int64_t id, const sensor_msgs::msg::RegionOfInterest & r)
+{
+  TrackedObject t;
+  t.id = id;
+  t.object.object_name = "person";
+  t.object.probability = 0.9f;
+  t.roi = r;
+  return t;
+}
+
+static ObjectInBox3D located(
+  int64_t id, const sensor_msgs::msg::RegionOfInterest & r, float x, float z)
+{
+  ObjectInBox3D o;
+  o.id = id;
+  o.roi = r;
+  o.min.x = x - 0.5f;
+  o.max.x = x + 0.5f;
+  o.min.z = z - 0.5f;
+  o.max.z = z + 0.5f;
+  return o;
+}
+
+static void stampAt(std_msgs::msg::Header & header, int32_t sec, uint32_t nanosec)
+{
+  header.stamp.sec = sec;
+  header.stamp.nanosec = nanosec;
+}
+
+TEST(UnitTestMerger, merge_ByIdThenRoi)
+{
+  Merger merger;
+  TrackedObjects tracks;
+  stampAt(tracks.header, 1, 0);
+  tracks.tracked_objects.push_back(track(1, roi(0, 0, 100, 100)));
+  tracks.tracked_objects.push_back(track(2, roi(200, 0, 100, 100)));
+  ObjectsInBoxes3D objs;
+  stampAt(objs.header, 1, 0);
+  /* the ROI of the first one overlaps track 2, its id says track 1*/
+  objs.objects_in_boxes.push_back(located(1, roi(210, 0, 100, 100), 1.0f, 2.0f));
+  objs.objects_in_boxes.push_back(located(-1, roi(205, 5, 100, 100), 3.0f, 2.0f));
+  MovingObjects moving;
+  merger.merge(tracks, objs, moving);
+
+  ASSERT_EQ(moving.objects.size(), 2u);
+  EXPECT_EQ(moving.objects[0].id, 1);
+  EXPECT_FLOAT_EQ(moving.objects[0].min.x, 0.5f);
+  EXPECT_EQ(moving.objects[1].id, 2);
+  EXPECT_FLOAT_EQ(moving.objects[1].min.x, 2.5f);
+  EXPECT_EQ(moving.objects[1].type, "person");
+  EXPECT_EQ(moving.objects[1].roi.x_offset, 200u);
+  EXPECT_EQ(merger.getUnmatched(), 0u);
+}
+
+TEST(UnitTestMerger, merge_KeepsWideIds)
+{
+  Merger merger;
+  TrackedObjects tracks;
+  int64_t id = (int64_t(1) << 40) + 3;
+  tracks.tracked_objects.push_back(track(id, roi(0, 0, 100, 100)));
+  ObjectsInBoxes3D objs;
+  objs.objects_in_boxes.push_back(located(id, roi(0, 0, 100, 100), 1.0f, 2.0f));
+  MovingObjects moving;
+  merger.merge(tracks, objs, moving);
+  ASSERT_EQ(moving.objects.size(), 1u);
+  EXPECT_EQ(moving.objects[0].id, id);
+}
+
+TEST(UnitTestMerger, merge_UnmatchedBelowMinIou)
+{
+  Merger merger;
+  TrackedObjects tracks;
+  tracks.tracked_objects.push_back(track(1, roi(0, 0, 100, 100)));
+  ObjectsInBoxes3D objs;
+  objs.objects_in_boxes.push_back(located(-1, roi(60, 0, 100, 100), 1.0f, 2.0f));
+  MovingObjects moving;
+  merger.merge(tracks, objs, moving);
+  EXPECT_TRUE(moving.objects.empty());
+  EXPECT_EQ(merger.getUnmatched(), 1u);
+
+  merger.setMinIou(0.2);
+  merger.merge(tracks, objs, moving);
+  EXPECT_EQ(moving.objects.size(), 1u);
+}
+
+TEST(UnitTestMerger, merge_FiniteDifferenceVelocity)
+{
+  Merger merger;
+  TrackedObjects tracks;
+  tracks.tracked_objects.push_back(track(1, roi(0, 0, 100, 100)));
+  ObjectsInBoxes3D objs;
+  objs.objects_in_boxes.push_back(located(1, roi(0, 0, 100, 100), 1.0f, 2.0f));
+  MovingObjects moving;
+  stampAt(tracks.header, 1, 0);
+  merger.merge(tracks, objs, moving);
+  ASSERT_EQ(moving.objects.size(), 1u);
+  EXPECT_DOUBLE_EQ(moving.objects[0].velocity.x, 0.0);
+
+  stampAt(tracks.header, 1, 500000000);
+  objs.objects_in_boxes[0] = located(1, roi(0, 0, 100, 100), 2.0f, 1.0f);
+  merger.merge(tracks, objs, moving);
+  ASSERT_EQ(moving.objects.size(), 1u);
+  EXPECT_NEAR(moving.objects[0].velocity.x, 2.0, 1e-6);
+  EXPECT_NEAR(moving.objects[0].velocity.z, -2.0, 1e-6);
+
+  /* an object missing a frame starts over*/
+  TrackedObjects none;
+  merger.merge(none, objs, moving);
+  stampAt(tracks.header, 2, 0);
+  merger.merge(tracks, objs, moving);
+  EXPECT_DOUBLE_EQ(moving.objects[0].velocity.x, 0.0);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <vector>
+#include "object_analytics_node/tracker/mot_evaluator.hpp"
+
+using object_analytics_node::tracker::MotEvaluator;
+
+TEST(UnitTestMotEvaluator, addFrame_Perfect)
+{
+  MotEvaluator mot;
+  for (int i = 0; i < 10; i++) {
+    std::vector<MotEvaluator::Box> gt = {{1, cv::Rect2d(i, 0, 10, 10)},
+      {2, cv::Rect2d(50 + i, 0, 10, 10)}};
+    std::vector<MotEvaluator::Box> hyp = {{7, cv::Rect2d(i, 0, 10, 10)},
+      {8, cv::Rect2d(50 + i, 0, 10, 10)}};
+    mot.addFrame(gt, hyp);
+  }
+  MotEvaluator::Summary s = mot.getSummary();
+  EXPECT_EQ(s.frames, 10u);
+  EXPECT_EQ(s.matches, 20u);
+  EXPECT_EQ(s.id_switches, 0u);
+  EXPECT_DOUBLE_EQ(s.mota, 1.);
+  EXPECT_DOUBLE_EQ(s.motp, 1.);
+  EXPECT_DOUBLE_EQ(s.idf1, 1.);
+}
+
+TEST(UnitTestMotEvaluator, addFrame_MissesAndFalsePositives)
+{
+  MotEvaluator mot;
+  std::vector<MotEvaluator::Box> gt = {{1, cv::Rect2d(0, 0, 10, 10)},
+    {2, cv::Rect2d(50, 0, 10, 10)}};
+  std::vector<MotEvaluator::Box> hyp = {{7, cv::Rect2d(0, 0, 10, 10)},
+    {8, cv::Rect2d(100, 100, 10, 10)}};
+  mot.addFrame(gt, hyp);
+  MotEvaluator::Summary s = mot.getSummary();
+  EXPECT_EQ(s.matches, 1u);
+  EXPECT_EQ(s.misses, 1u);
+  EXPECT_EQ(s.false_positives, 1u);
+  EXPECT_DOUBLE_EQ(s.mota, 0.);
+  EXPECT_DOUBLE_EQ(s.idf1, 0.5);
+}
+
+TEST(UnitTestMotEvaluator, addFrame_IdSwitch)
+{
+  MotEvaluator mot;
+  std::vector<MotEvaluator::Box> gt = {{1, cv::Rect2d(0, 0, 10, 10)}};
+  for (int i = 0; i < 4; i++) {
+    /* the tracking is lost and replaced by a new one half way*/
+    std::vector<MotEvaluator::Box> hyp = {{i < 2 ? 7 : 8, cv::Rect2d(0, 0, 10, 10)}};
+    mot.addFrame(gt, hyp);
+  }
+  MotEvaluator::Summary s = mot.getSummary();
+  EXPECT_EQ(s.id_switches, 1u);
+  EXPECT_DOUBLE_EQ(s.mota, 0.75);
+  EXPECT_DOUBLE_EQ(s.idf1, 0.5);
+}
+
+TEST(UnitTestMotEvaluator, addFrame_KeepsCorrespondence)
+{
+  MotEvaluator mot;
+  std::vector<MotEvaluator::Box> gt = {{1, cv::Rect2d(0, 0, 10, 10)}};
+  mot.addFrame(gt, {{7, cv::Rect2d(1, 0, 10, 10)}});
+  /* a better overlapping tracking does not take the target over*/
+  mot.addFrame(gt, {{7, cv::Rect2d(2, 0, 10, 10)}, {8, cv::Rect2d(0, 0, 10, 10)}});
+  MotEvaluator::Summary s = mot.getSummary();
+  EXPECT_EQ(s.id_switches, 0u);
+  EXPECT_EQ(s.false_positives, 1u);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
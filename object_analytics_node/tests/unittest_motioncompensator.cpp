@@ -0,0 +1,77 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <opencv2/imgproc.hpp>
+#include <vector>
+#include "object_analytics_node/tracker/motion_compensator.hpp"
+
+using object_analytics_node::tracker::FrameContext;
+using object_analytics_node::tracker::MotionCompensator;
+
+namespace
+{
+/* textured blocks over a flat background, shifted by the offset given*/
+cv::Mat getFrame(const cv::Point & offset)
+{
+  cv::Mat bgr(480, 640, CV_8UC3, cv::Scalar(60, 60, 60));
+  cv::RNG rng(7);
+  cv::Mat texture(120, 100, CV_8UC3);
+  rng.fill(texture, cv::RNG::UNIFORM, 0, 255);
+  cv::GaussianBlur(texture, texture, cv::Size(5, 5), 1.5);
+  texture.copyTo(bgr(cv::Rect(100 + offset.x, 100 + offset.y, 100, 120)));
+  texture.copyTo(bgr(cv::Rect(400, 250, 100, 120)));
+  return bgr;
+}
+}  // namespace
+
+TEST(UnitTestMotionCompensator, estimate_MedianShift)
+{
+  FrameContext from(getFrame(cv::Point(0, 0)));
+  FrameContext to(getFrame(cv::Point(6, -4)));
+  std::vector<cv::Rect2d> rois;
+  rois.push_back(cv::Rect2d(100, 100, 100, 120));
+  rois.push_back(cv::Rect2d(400, 250, 100, 120));
+  std::vector<cv::Point2d> shifts;
+  EXPECT_EQ(MotionCompensator::estimate(from, to, rois, shifts), static_cast<size_t>(2));
+  ASSERT_EQ(shifts.size(), static_cast<size_t>(2));
+  EXPECT_NEAR(shifts[0].x, 6, 0.5);
+  EXPECT_NEAR(shifts[0].y, -4, 0.5);
+  /* the still object is not moved*/
+  EXPECT_NEAR(shifts[1].x, 0, 0.5);
+  EXPECT_NEAR(shifts[1].y, 0, 0.5);
+}
+
+TEST(UnitTestMotionCompensator, estimate_Flat)
+{
+  /* no texture to track, the roi is left in place*/
+  cv::Mat flat(480, 640, CV_8UC3, cv::Scalar(60, 60, 60));
+  FrameContext from(flat);
+  FrameContext to(flat);
+  std::vector<cv::Rect2d> rois(1, cv::Rect2d(100, 100, 100, 120));
+  std::vector<cv::Point2d> shifts;
+  EXPECT_EQ(MotionCompensator::estimate(from, to, rois, shifts), static_cast<size_t>(0));
+  EXPECT_EQ(shifts[0], cv::Point2d(0, 0));
+
+  cv::Mat small(240, 320, CV_8UC3, cv::Scalar(60, 60, 60));
+  FrameContext other(small);
+  EXPECT_EQ(MotionCompensator::estimate(from, other, rois, shifts), static_cast<size_t>(0));
+}
+
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -35,6 +35,17 @@ TEST(UnitTestObject2D, getObject)
   EXPECT_TRUE(left == right);
 }
 
+TEST(UnitTestObject2D, view_ReferencesObject)
+{
+  ObjectInBox oib = getObjectInBox(0, 0, 100, 100, "table", 0.99);
+  Object2D obj = Object2D::view(oib);
+  EXPECT_TRUE(obj.getRoi() == getRoi(0, 0, 100, 100));
+  EXPECT_EQ(&obj.getObject(), &oib.object);
+  Object2D copy(obj);
+  EXPECT_EQ(&copy.getObject(), &oib.object);
+  EXPECT_TRUE(Object2D(oib).getObject() == getObject("table", 0.99));
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,93 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "object_analytics_node/util/object_pool.hpp"
+
+using object_analytics_node::util::ObjectPool;
+
+TEST(UnitTestObjectPool, acquire_ReusesReleased)
+{
+  ObjectPool<std::vector<int>> pool;
+  std::vector<int> * first;
+  {
+    std::shared_ptr<std::vector<int>> v = pool.acquire();
+    v->resize(100);
+    first = v.get();
+  }
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(1));
+  std::shared_ptr<std::vector<int>> v = pool.acquire();
+  EXPECT_EQ(v.get(), first);
+  EXPECT_GE(v->capacity(), static_cast<size_t>(100));
+  EXPECT_EQ(pool.getAllocations(), static_cast<size_t>(1));
+  EXPECT_EQ(pool.getAcquisitions(), static_cast<size_t>(2));
+}
+
+TEST(UnitTestObjectPool, acquire_AllocatesWhenNoneIdle)
+{
+  ObjectPool<std::vector<int>> pool;
+  std::shared_ptr<std::vector<int>> a = pool.acquire();
+  std::shared_ptr<std::vector<int>> b = pool.acquire();
+  EXPECT_NE(a.get(), b.get());
+  EXPECT_EQ(pool.getAllocations(), static_cast<size_t>(2));
+  a.reset();
+  b.reset();
+  for (int i = 0; i < 10; i++) {
+    a = pool.acquire();
+    b = pool.acquire();
+    a.reset();
+    b.reset();
+  }
+  EXPECT_EQ(pool.getAllocations(), static_cast<size_t>(2));
+}
+
+TEST(UnitTestObjectPool, release_AfterPoolDestroyed)
+{
+  std::shared_ptr<std::vector<int>> v;
+  {
+    ObjectPool<std::vector<int>> pool;
+    v = pool.acquire();
+  }
+  v->push_back(1);
+  v.reset();
+}
+
+TEST(UnitTestObjectPool, acquire_Concurrent)
+{
+  ObjectPool<std::vector<int>> pool;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&pool]() {
+        for (int i = 0; i < 1000; i++) {
+          std::shared_ptr<std::vector<int>> v = pool.acquire();
+          v->push_back(i);
+        }
+      });
+  }
+  for (auto & t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(pool.getAcquisitions(), static_cast<size_t>(4000));
+  EXPECT_LE(pool.getAllocations(), static_cast<size_t>(4));
+  EXPECT_EQ(pool.getIdle(), pool.getAllocations());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 #include <pcl/io/pcd_io.h>
 
+#include <cmath>
 #include <string>
 #include <utility>
 #include <vector>
@@ -324,6 +325,179 @@ TEST(UnitTestObjectUtils, getMatch_SameOverlapBetterDiviation)
     ObjectUtils::getMatch(origin, smallDiviation), ObjectUtils::getMatch(origin, bigDiviation));
 }
 
+TEST(UnitTestObjectUtils, getMatch_CoincidentCenters)
+{
+  cv::Rect2d origin(0, 0, 100, 100);
+  cv::Rect2d inner(25, 25, 50, 50);
+  double exact = ObjectUtils::getMatch(origin, origin);
+  EXPECT_DOUBLE_EQ(exact, 100);
+  EXPECT_DOUBLE_EQ(ObjectUtils::getMatch(origin, inner), 25);
+  EXPECT_GT(exact, ObjectUtils::getMatch(origin, inner));
+}
+
+TEST(UnitTestObjectUtils, getMatchBatch_SameAsGetMatch)
+{
+  std::vector<cv::Rect2d> a, b;
+  for (int i = 0; i < 7; i++) {
+    a.push_back(cv::Rect2d(i * 13, i * 7, 40 + i, 60 - i));
+  }
+  for (int j = 0; j < 11; j++) {
+    b.push_back(cv::Rect2d(j * 9, j * 11, 50 - j, 30 + j * 2));
+  }
+  b.push_back(a[3]);
+  std::vector<double> scores;
+  ObjectUtils::getMatchBatch(a, b, scores);
+  ASSERT_EQ(scores.size(), a.size() * b.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    for (size_t j = 0; j < b.size(); j++) {
+      EXPECT_NEAR(scores[i * b.size() + j], ObjectUtils::getMatch(a[i], b[j]), 1e-9);
+    }
+  }
+
+  ObjectUtils::getMatchBatch(a, std::vector<cv::Rect2d>(), scores);
+  EXPECT_TRUE(scores.empty());
+}
+
+TEST(UnitTestObjectUtils, getBounds_SameAsCopiedCloud)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/project.pcd", cloud);
+  // NOLINTNEXTLINE
+  int i[] = {15, 23, 24, 28, 32, 38, 42, 51, 54, 64, 72, 78, 86};
+  std::vector<int> indices(i, i + sizeof(i) / sizeof(int));
+
+  pcl::PointCloud<PointXYZPixel>::Ptr seg(new pcl::PointCloud<PointXYZPixel>);
+  ObjectUtils::copyPointCloud(cloud, indices, seg);
+  PointXYZPixel x_min, x_max, y_min, y_max, z_min, z_max;
+  ObjectUtils::getMinMaxPointsInX(seg, x_min, x_max);
+  ObjectUtils::getMinMaxPointsInY(seg, y_min, y_max);
+  ObjectUtils::getMinMaxPointsInZ(seg, z_min, z_max);
+  sensor_msgs::msg::RegionOfInterest expected_roi;
+  ObjectUtils::getProjectedROI(seg, expected_roi);
+
+  geometry_msgs::msg::Point32 min, max;
+  sensor_msgs::msg::RegionOfInterest roi;
+  ObjectUtils::getBounds(cloud, indices, min, max, roi);
+  EXPECT_TRUE(min == getPoint32(x_min.x, y_min.y, z_min.z));
+  EXPECT_TRUE(max == getPoint32(x_max.x, y_max.y, z_max.z));
+  EXPECT_TRUE(roi == expected_roi);
+
+  geometry_msgs::msg::Point32 trimmed_min, trimmed_max;
+  sensor_msgs::msg::RegionOfInterest trimmed_roi;
+  ObjectUtils::getTrimmedBounds(cloud, indices, 0.0f, trimmed_min, trimmed_max, trimmed_roi);
+  EXPECT_TRUE(trimmed_min == min);
+  EXPECT_TRUE(trimmed_max == max);
+  EXPECT_TRUE(trimmed_roi == expected_roi);
+}
+
+TEST(UnitTestObjectUtils, getTrimmedBounds_IgnoresOutliers)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  for (int k = 0; k < 100; k++) {
+    cloud->push_back(PointT(k, 2 * k, 3 * k));
+  }
+  cloud->points[7] = PointT(1000, -1000, 1000);
+  cloud->width = 10;
+  cloud->height = 10;
+  std::vector<int> indices;
+  for (int k = 0; k < 100; k++) {
+    indices.push_back(k);
+  }
+
+  geometry_msgs::msg::Point32 min, max;
+  sensor_msgs::msg::RegionOfInterest roi;
+  ObjectUtils::getTrimmedBounds(cloud, indices, 0.02f, min, max, roi);
+  EXPECT_TRUE(min == getPoint32(1, 0, 3));
+  EXPECT_TRUE(max == getPoint32(99, 196, 297));
+  EXPECT_TRUE(roi == getRoi(0, 0, 9, 9));
+
+  ObjectUtils::getBounds(cloud, indices, min, max, roi);
+  EXPECT_TRUE(min == getPoint32(0, -1000, 0));
+  EXPECT_TRUE(max == getPoint32(1000, 198, 1000));
+}
+
+TEST(UnitTestObjectUtils, getOrientedBounds_RotatedBox)
+{
+  /* a 4 x 2 x 1 grid of points centered at (1, 2, 3), turned 45 degrees around z*/
+  PointCloudT::Ptr cloud(new PointCloudT);
+  const float c = std::sqrt(0.5f);
+  for (int i = -4; i <= 4; i++) {
+    for (int j = -2; j <= 2; j++) {
+      for (int k = -1; k <= 1; k += 2) {
+        float x = 0.5f * i, y = 0.5f * j, z = 0.5f * k;
+        cloud->push_back(PointT(1 + c * (x - y), 2 + c * (x + y), 3 + z));
+      }
+    }
+  }
+  cloud->width = cloud->points.size();
+  cloud->height = 1;
+  std::vector<int> indices;
+  for (size_t k = 0; k < cloud->points.size(); k++) {
+    indices.push_back(k);
+  }
+
+  geometry_msgs::msg::Point32 min, max, expected_min, expected_max;
+  sensor_msgs::msg::RegionOfInterest roi, expected_roi;
+  geometry_msgs::msg::Pose pose;
+  geometry_msgs::msg::Vector3 size;
+  ObjectUtils::getOrientedBounds(cloud, indices, min, max, roi, pose, size);
+  ObjectUtils::getBounds(cloud, indices, expected_min, expected_max, expected_roi);
+  EXPECT_TRUE(min == expected_min);
+  EXPECT_TRUE(max == expected_max);
+  EXPECT_TRUE(roi == expected_roi);
+  EXPECT_NEAR(size.x, 4.0, 1e-4);
+  EXPECT_NEAR(size.y, 2.0, 1e-4);
+  EXPECT_NEAR(size.z, 1.0, 1e-4);
+  EXPECT_NEAR(pose.position.x, 1.0, 1e-4);
+  EXPECT_NEAR(pose.position.y, 2.0, 1e-4);
+  EXPECT_NEAR(pose.position.z, 3.0, 1e-4);
+  /* the x axis of the box is along (1, 1, 0), either way*/
+  const auto & q = pose.orientation;
+  double axis_x = 1 - 2 * (q.y * q.y + q.z * q.z);
+  double axis_y = 2 * (q.x * q.y + q.w * q.z);
+  EXPECT_NEAR(std::abs(axis_x), c, 1e-4);
+  EXPECT_NEAR(std::abs(axis_y), c, 1e-4);
+  EXPECT_GT(axis_x * axis_y, 0.0);
+
+  geometry_msgs::msg::Pose box_pose;
+  geometry_msgs::msg::Vector3 box_size;
+  ObjectUtils::getOrientedBox(cloud, indices, box_pose, box_size);
+  EXPECT_NEAR(box_size.x, size.x, 1e-6);
+  EXPECT_NEAR(box_pose.position.x, pose.position.x, 1e-6);
+}
+
+TEST(UnitTestObjectUtils, getBounds_MeanColor)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  for (int k = 0; k < 4; k++) {
+    cloud->push_back(PointT(k, k, k));
+  }
+  cloud->width = 4;
+  cloud->height = 1;
+  /* packed 0x00RRGGBB, the last point is not indexed*/
+  std::vector<uint32_t> colors = {0xff0000, 0x00ff00, 0xff00ff, 0xffffff};
+  std::vector<int> indices = {0, 1, 2};
+
+  geometry_msgs::msg::Point32 min, max;
+  sensor_msgs::msg::RegionOfInterest roi;
+  std_msgs::msg::ColorRGBA color;
+  ObjectUtils::getBounds(cloud, indices, min, max, roi, &colors, &color);
+  EXPECT_NEAR(color.r, 2.0 / 3, 1e-6);
+  EXPECT_NEAR(color.g, 1.0 / 3, 1e-6);
+  EXPECT_NEAR(color.b, 1.0 / 3, 1e-6);
+  EXPECT_EQ(color.a, 1.0f);
+
+  std_msgs::msg::ColorRGBA trimmed_color;
+  ObjectUtils::getTrimmedBounds(cloud, indices, 0.1f, min, max, roi, &colors, &trimmed_color);
+  EXPECT_TRUE(trimmed_color == color);
+
+  /* untouched without colors*/
+  std_msgs::msg::ColorRGBA none;
+  std::vector<uint32_t> empty;
+  ObjectUtils::getBounds(cloud, indices, min, max, roi, &empty, &none);
+  EXPECT_EQ(none.a, 0.0f);
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include "object_analytics_node/tracker/overload_gate.hpp"
+
+using object_analytics_node::tracker::OverloadGate;
+
+TEST(UnitTestOverloadGate, parse)
+{
+  OverloadGate::Policy policy;
+  EXPECT_TRUE(OverloadGate::parse("none", policy));
+  EXPECT_EQ(policy, OverloadGate::kNone);
+  EXPECT_TRUE(OverloadGate::parse("latest", policy));
+  EXPECT_EQ(policy, OverloadGate::kLatest);
+  EXPECT_TRUE(OverloadGate::parse("every_k", policy));
+  EXPECT_EQ(policy, OverloadGate::kEveryK);
+  EXPECT_TRUE(OverloadGate::parse("interpolate", policy));
+  EXPECT_EQ(policy, OverloadGate::kInterpolate);
+  EXPECT_FALSE(OverloadGate::parse("drop", policy));
+}
+
+TEST(UnitTestOverloadGate, admit_None)
+{
+  OverloadGate gate(OverloadGate::kNone, 10);
+  EXPECT_EQ(gate.admit(1000), OverloadGate::kTrack);
+  EXPECT_FALSE(gate.isOverloaded());
+  EXPECT_EQ(gate.getSkipped(), 0u);
+}
+
+TEST(UnitTestOverloadGate, admit_Latest)
+{
+  OverloadGate gate(OverloadGate::kLatest, 10, 2, 10);
+  EXPECT_EQ(gate.admit(5), OverloadGate::kTrack);
+  EXPECT_EQ(gate.admit(50), OverloadGate::kSkip);
+  EXPECT_EQ(gate.admit(40), OverloadGate::kSkip);
+  EXPECT_TRUE(gate.isOverloaded());
+  EXPECT_EQ(gate.getSkippedInOverload(), 2u);
+  EXPECT_EQ(gate.admit(10), OverloadGate::kTrack);
+  EXPECT_FALSE(gate.isOverloaded());
+  EXPECT_EQ(gate.getSkippedInOverload(), 0u);
+  EXPECT_EQ(gate.getSkipped(), 2u);
+}
+
+TEST(UnitTestOverloadGate, admit_EveryK)
+{
+  OverloadGate gate(OverloadGate::kEveryK, 10, 3);
+  EXPECT_EQ(gate.admit(50), OverloadGate::kSkip);
+  EXPECT_EQ(gate.admit(50), OverloadGate::kSkip);
+  EXPECT_EQ(gate.admit(50), OverloadGate::kTrack);
+  EXPECT_EQ(gate.admit(50), OverloadGate::kSkip);
+  EXPECT_EQ(gate.getSkipped(), 3u);
+}
+
+TEST(UnitTestOverloadGate, admit_Interpolate)
+{
+  OverloadGate gate(OverloadGate::kInterpolate, 10);
+  EXPECT_EQ(gate.admit(50), OverloadGate::kExtrapolate);
+  EXPECT_EQ(gate.admit(1), OverloadGate::kTrack);
+  EXPECT_EQ(gate.getSkipped(), 1u);
+}
+
+TEST(UnitTestOverloadGate, admit_MinimumCadence)
+{
+  /* a sustained overload still tracks one of every max_skip + 1 frames*/
+  OverloadGate latest(OverloadGate::kLatest, 10, 2, 2);
+  OverloadGate interpolate(OverloadGate::kInterpolate, 10, 2, 2);
+  for (int round = 0; round < 3; round++) {
+    EXPECT_EQ(latest.admit(50), OverloadGate::kSkip);
+    EXPECT_EQ(latest.admit(50), OverloadGate::kSkip);
+    EXPECT_EQ(latest.admit(50), OverloadGate::kTrack);
+    EXPECT_EQ(interpolate.admit(50), OverloadGate::kExtrapolate);
+    EXPECT_EQ(interpolate.admit(50), OverloadGate::kExtrapolate);
+    EXPECT_EQ(interpolate.admit(50), OverloadGate::kTrack);
+  }
+  EXPECT_TRUE(latest.isOverloaded());
+  EXPECT_EQ(latest.getSkippedInOverload(), 6u);
+
+  /* an interval or a cadence of 0 is taken as 1*/
+  OverloadGate zero(OverloadGate::kLatest, 10, 0, 0);
+  EXPECT_EQ(zero.admit(50), OverloadGate::kSkip);
+  EXPECT_EQ(zero.admit(50), OverloadGate::kTrack);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
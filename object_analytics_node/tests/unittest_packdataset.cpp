@@ -0,0 +1,245 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "object_analytics_node/dataset/track_dataset.hpp"
+
+using datasets::Obj_;
+using datasets::packDataset;
+using datasets::trDataset;
+
+/* sequences held in memory, frame i of a sequence is filled with base + i*/
+class MemDataset : public trDataset
+{
+public:
+  struct Seq
+  {
+    std::string name;
+    int start;
+    std::vector<cv::Mat> frames;
+    std::vector<std::vector<Obj_>> gt;
+  };
+
+  void add(const std::string & name, int start, int count, cv::Size size, int type, int base)
+  {
+    Seq s{name, start, {}, {}};
+    for (int i = 0; i < count; i++) {
+      s.frames.push_back(cv::Mat(size, type, cv::Scalar::all(base + i)));
+      std::vector<Obj_> boxes;
+      for (int k = 0; k < i % 3; k++) {
+        boxes.push_back({k, cv::Rect2d(i + 0.5, k + 0.25, 10.0 + i, 20.0 + k), 0.5f + 0.1f * k});
+      }
+      s.gt.push_back(boxes);
+    }
+    seqs.push_back(s);
+  }
+
+  void load(const std::string &) {}
+  int getDatasetsNum() {return static_cast<int>(seqs.size());}
+  std::string getDatasetName(int id) {return seqs[id - 1].name;}
+  int getDatasetLength(int id) {return static_cast<int>(seqs[id - 1].frames.size());}
+
+  bool initDataset(std::string dsName)
+  {
+    for (size_t i = 0; i < seqs.size(); i++) {
+      if (seqs[i].name == dsName) {
+        activeDatasetID = static_cast<int>(i) + 1;
+        frameIdx = seqs[i].start;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool getNextFrame(cv::Mat & frame)
+  {
+    if (!getIdxFrame(frame, frameIdx)) {
+      return false;
+    }
+    frameIdx++;
+    return true;
+  }
+
+  bool getIdxFrame(cv::Mat & frame, int idx)
+  {
+    Seq & s = seqs[activeDatasetID - 1];
+    int pos = idx - s.start;
+    if (pos < 0 || pos >= static_cast<int>(s.frames.size())) {
+      return false;
+    }
+    frame = s.frames[pos];
+    return true;
+  }
+
+  std::vector<std::vector<Obj_>> getGT() {return seqs[activeDatasetID - 1].gt;}
+
+  std::vector<Obj_> getIdxGT(int idx)
+  {
+    Seq & s = seqs[activeDatasetID - 1];
+    return s.gt[idx - s.start];
+  }
+
+  std::vector<Seq> seqs;
+};
+
+static std::string packPath(const std::string & name)
+{
+  return "/tmp/unittest_packdataset_" + std::to_string(getpid()) + "_" + name + ".pack";
+}
+
+static void expectSameBoxes(const std::vector<Obj_> & expected, const std::vector<Obj_> & boxes)
+{
+  ASSERT_EQ(expected.size(), boxes.size());
+  for (size_t k = 0; k < boxes.size(); k++) {
+    EXPECT_EQ(expected[k].objIdx, boxes[k].objIdx);
+    EXPECT_EQ(expected[k].bb, boxes[k].bb);
+    EXPECT_EQ(expected[k].confidence, boxes[k].confidence);
+  }
+}
+
+TEST(UnitTestPackDataset, write_RoundTrip)
+{
+  MemDataset ds;
+  ds.add("gray", 1, 5, cv::Size(33, 7), CV_8UC1, 10);
+  ds.add("color", 0, 4, cv::Size(16, 12), CV_8UC3, 100);
+  std::string file = packPath("roundtrip");
+  ASSERT_TRUE(packDataset::write(ds, std::vector<std::string>(), file));
+
+  packDataset pack;
+  pack.load(file);
+  ASSERT_EQ(2, pack.getDatasetsNum());
+  for (int id = 1; id <= 2; id++) {
+    MemDataset::Seq & s = ds.seqs[id - 1];
+    EXPECT_EQ(s.name, pack.getDatasetName(id));
+    EXPECT_EQ(static_cast<int>(s.frames.size()), pack.getDatasetLength(id));
+    ASSERT_TRUE(pack.initDataset(s.name));
+    EXPECT_EQ(s.start, pack.getFrameIdx());
+
+    cv::Mat frame;
+    for (size_t i = 0; i < s.frames.size(); i++) {
+      ASSERT_TRUE(pack.getNextFrame(frame));
+      ASSERT_EQ(s.frames[i].size(), frame.size());
+      ASSERT_EQ(s.frames[i].type(), frame.type());
+      EXPECT_EQ(0, cv::norm(s.frames[i], frame, cv::NORM_INF));
+      expectSameBoxes(s.gt[i], pack.getIdxGT(s.start + static_cast<int>(i)));
+    }
+    EXPECT_FALSE(pack.getNextFrame(frame));
+
+    std::vector<std::vector<Obj_>> gt = pack.getGT();
+    ASSERT_EQ(s.gt.size(), gt.size());
+    for (size_t i = 0; i < gt.size(); i++) {
+      expectSameBoxes(s.gt[i], gt[i]);
+    }
+  }
+
+  /* frames are mapped privately, writing to one leaves the file unchanged*/
+  ASSERT_TRUE(pack.initDataset("gray"));
+  cv::Mat frame;
+  ASSERT_TRUE(pack.getIdxFrame(frame, 1));
+  frame.setTo(cv::Scalar::all(255));
+  packDataset reloaded;
+  reloaded.load(file);
+  ASSERT_TRUE(reloaded.initDataset("gray"));
+  ASSERT_TRUE(reloaded.getIdxFrame(frame, 1));
+  EXPECT_EQ(10, frame.at<uint8_t>(0, 0));
+  std::remove(file.c_str());
+}
+
+TEST(UnitTestPackDataset, write_SelectedAndNonContinuous)
+{
+  /* frames cropped out of larger images are written row by row*/
+  MemDataset ds;
+  ds.add("crop", 0, 3, cv::Size(20, 10), CV_8UC1, 1);
+  ds.add("skipped", 0, 2, cv::Size(4, 4), CV_8UC1, 50);
+  for (auto & f : ds.seqs[0].frames) {
+    f = cv::Mat(f.rows + 4, f.cols + 8, f.type(), cv::Scalar::all(200));
+  }
+  for (size_t i = 0; i < ds.seqs[0].frames.size(); i++) {
+    cv::Mat full = ds.seqs[0].frames[i];
+    full(cv::Rect(4, 2, 20, 10)).setTo(cv::Scalar::all(1 + static_cast<int>(i)));
+    ds.seqs[0].frames[i] = full(cv::Rect(4, 2, 20, 10));
+    ASSERT_FALSE(ds.seqs[0].frames[i].isContinuous());
+  }
+  std::string file = packPath("selected");
+  ASSERT_TRUE(packDataset::write(ds, std::vector<std::string>{"crop"}, file));
+
+  packDataset pack;
+  pack.load(file);
+  ASSERT_EQ(1, pack.getDatasetsNum());
+  ASSERT_TRUE(pack.initDataset("crop"));
+  EXPECT_FALSE(pack.initDataset("skipped"));
+  ASSERT_TRUE(pack.initDataset("crop"));
+  cv::Mat frame;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(pack.getNextFrame(frame));
+    EXPECT_EQ(cv::Size(20, 10), frame.size());
+    EXPECT_EQ(0, cv::norm(ds.seqs[0].frames[i], frame, cv::NORM_INF));
+  }
+  std::remove(file.c_str());
+}
+
+TEST(UnitTestPackDataset, write_FailsOnMixedSizes)
+{
+  MemDataset ds;
+  ds.add("mixed", 0, 2, cv::Size(8, 8), CV_8UC1, 0);
+  ds.seqs[0].frames[1] = cv::Mat(9, 8, CV_8UC1, cv::Scalar::all(1));
+  std::string file = packPath("mixed");
+  EXPECT_FALSE(packDataset::write(ds, std::vector<std::string>(), file));
+  EXPECT_FALSE(packDataset::write(ds, std::vector<std::string>{"missing"}, file));
+  std::remove(file.c_str());
+}
+
+TEST(UnitTestPackDataset, load_RejectsBadFiles)
+{
+  MemDataset ds;
+  ds.add("gray", 0, 3, cv::Size(64, 64), CV_8UC1, 0);
+  std::string file = packPath("truncated");
+  ASSERT_TRUE(packDataset::write(ds, std::vector<std::string>(), file));
+
+  /* the frames end beyond a truncated file*/
+  std::ifstream in(file, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream out(file, std::ios::binary | std::ios::trunc);
+  out.write(bytes.data(), bytes.size() / 2);
+  out.close();
+  packDataset pack;
+  pack.load(file);
+  EXPECT_EQ(0, pack.getDatasetsNum());
+
+  /* not a pack file*/
+  out.open(file, std::ios::binary | std::ios::trunc);
+  out << "not a pack file at all";
+  out.close();
+  pack.load(file);
+  EXPECT_EQ(0, pack.getDatasetsNum());
+
+  std::remove(file.c_str());
+  pack.load(file);
+  EXPECT_EQ(0, pack.getDatasetsNum());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
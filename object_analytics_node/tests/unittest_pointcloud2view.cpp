@@ -0,0 +1,112 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define PCL_NO_PRECOMPILE
+#include <gtest/gtest.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <string>
+#include <vector>
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
+#include "unittest_util.hpp"
+
+using object_analytics_node::segmenter::PointCloud2View;
+
+TEST(UnitTestPointCloud2View, at_SameAsFromROSMsg)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+  sensor_msgs::msg::PointCloud2 msg;
+  pcl::toROSMsg(*cloud, msg);
+
+  ASSERT_TRUE(PointCloud2View::isSupported(msg));
+  PointCloud2View view(msg);
+  EXPECT_EQ(view.getWidth(), cloud->width);
+  EXPECT_EQ(view.getHeight(), cloud->height);
+  ASSERT_EQ(view.size(), cloud->size());
+  for (size_t i = 0; i < cloud->size(); i++) {
+    EXPECT_TRUE(view.at(i) == cloud->points[i]);
+    EXPECT_EQ(view.isFinite(i), std::isfinite(cloud->points[i].x));
+  }
+}
+
+TEST(UnitTestPointCloud2View, copy_Indices)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+  sensor_msgs::msg::PointCloud2 msg;
+  pcl::toROSMsg(*cloud, msg);
+
+  PointCloud2View view(msg);
+  std::vector<int> indices = {24, 0, 7};
+  PointCloudT out;
+  view.copy(indices, out);
+  ASSERT_EQ(out.size(), indices.size());
+  EXPECT_EQ(out.width, indices.size());
+  EXPECT_EQ(out.height, static_cast<uint32_t>(1));
+  for (size_t i = 0; i < indices.size(); i++) {
+    EXPECT_TRUE(out.points[i] == cloud->points[indices[i]]);
+  }
+}
+
+TEST(UnitTestPointCloud2View, copy_Colors)
+{
+  pcl::PointCloud<pcl::PointXYZRGB> cloud;
+  cloud.width = 2;
+  cloud.height = 2;
+  cloud.points.resize(4);
+  for (size_t i = 0; i < cloud.size(); i++) {
+    auto & p = cloud.points[i];
+    p.x = p.y = p.z = static_cast<float>(i);
+    p.r = static_cast<uint8_t>(10 * i);
+    p.g = static_cast<uint8_t>(20 * i);
+    p.b = static_cast<uint8_t>(30 * i);
+  }
+  sensor_msgs::msg::PointCloud2 msg;
+  pcl::toROSMsg(cloud, msg);
+
+  ASSERT_TRUE(PointCloud2View::isSupported(msg));
+  PointCloud2View view(msg);
+  ASSERT_TRUE(view.hasColor());
+  std::vector<int> indices = {3, 1};
+  PointCloudT out;
+  std::vector<uint32_t> colors;
+  view.copy(indices, out, &colors);
+  ASSERT_EQ(colors.size(), indices.size());
+  for (size_t i = 0; i < indices.size(); i++) {
+    const auto & p = cloud.points[indices[i]];
+    EXPECT_EQ(out.points[i].z, p.z);
+    EXPECT_EQ(colors[i] & 0xffffff, (uint32_t(p.r) << 16) | (uint32_t(p.g) << 8) | p.b);
+  }
+
+  /* an xyz cloud has no colors*/
+  PointCloudT xyz;
+  pcl::fromROSMsg(msg, xyz);
+  pcl::toROSMsg(xyz, msg);
+  PointCloud2View xyz_view(msg);
+  EXPECT_FALSE(xyz_view.hasColor());
+  xyz_view.copy(indices, out, &colors);
+  EXPECT_TRUE(colors.empty());
+}
+
+TEST(UnitTestPointCloud2View, isSupported_NoXYZ)
+{
+  sensor_msgs::msg::PointCloud2 msg;
+  EXPECT_FALSE(PointCloud2View::isSupported(msg));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <string>
+#include "object_analytics_node/util/qos_profiles.hpp"
+
+using object_analytics_node::util::QosProfiles;
+
+TEST(UnitTestQosProfiles, parse_Presets)
+{
+  rmw_qos_profile_t qos = rmw_qos_profile_default;
+  ASSERT_TRUE(QosProfiles::parse(QosProfiles::kSensor, qos));
+  EXPECT_EQ(qos.reliability, RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT);
+  EXPECT_EQ(qos.history, RMW_QOS_POLICY_HISTORY_KEEP_LAST);
+  EXPECT_EQ(qos.depth, 1u);
+
+  ASSERT_TRUE(QosProfiles::parse(QosProfiles::kReliable, qos));
+  EXPECT_EQ(qos.reliability, RMW_QOS_POLICY_RELIABILITY_RELIABLE);
+  EXPECT_EQ(qos.history, RMW_QOS_POLICY_HISTORY_KEEP_LAST);
+  EXPECT_EQ(qos.depth, rmw_qos_profile_default.depth);
+}
+
+TEST(UnitTestQosProfiles, parse_Depth)
+{
+  rmw_qos_profile_t qos = rmw_qos_profile_default;
+  ASSERT_TRUE(QosProfiles::parse("sensor:3", qos));
+  EXPECT_EQ(qos.reliability, RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT);
+  EXPECT_EQ(qos.depth, 3u);
+  ASSERT_TRUE(QosProfiles::parse("reliable:1", qos));
+  EXPECT_EQ(qos.reliability, RMW_QOS_POLICY_RELIABILITY_RELIABLE);
+  EXPECT_EQ(qos.depth, 1u);
+}
+
+TEST(UnitTestQosProfiles, parse_InvalidUnchanged)
+{
+  rmw_qos_profile_t qos = rmw_qos_profile_default;
+  qos.depth = 7;
+  EXPECT_FALSE(QosProfiles::parse("fast", qos));
+  EXPECT_FALSE(QosProfiles::parse("sensor:0", qos));
+  EXPECT_FALSE(QosProfiles::parse("sensor:", qos));
+  EXPECT_FALSE(QosProfiles::parse("reliable:2x", qos));
+  EXPECT_EQ(qos.depth, 7u);
+  EXPECT_EQ(qos.reliability, rmw_qos_profile_default.reliability);
+}
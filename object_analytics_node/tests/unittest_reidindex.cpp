@@ -0,0 +1,143 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <opencv2/imgproc.hpp>
+#include <vector>
+#include "object_analytics_node/tracker/reid_index.hpp"
+
+using object_analytics_node::tracker::ReidIndex;
+
+namespace
+{
+/* a person of a red shirt over blue trousers, or of the colors given*/
+cv::Mat getPerson(const cv::Scalar & upper, const cv::Scalar & lower)
+{
+  cv::Mat bgr(480, 640, CV_8UC3, cv::Scalar(90, 90, 90));
+  cv::rectangle(bgr, cv::Rect(100, 100, 80, 100), upper, cv::FILLED);
+  cv::rectangle(bgr, cv::Rect(100, 200, 80, 100), lower, cv::FILLED);
+  return bgr;
+}
+
+const cv::Rect2d kRoi(100, 100, 80, 200);
+const int64_t kSecond = 1000000000;
+}  // namespace
+
+TEST(UnitTestReidIndex, describe_Stable)
+{
+  std::vector<float> a, b, c;
+  ReidIndex::describe(getPerson(cv::Scalar(0, 0, 200), cv::Scalar(200, 0, 0)), kRoi, a);
+  ASSERT_EQ(a.size(), static_cast<size_t>(ReidIndex::kDims));
+  double norm = 0;
+  for (float v : a) {
+    norm += v * v;
+  }
+  EXPECT_NEAR(norm, 1.0, 1e-4);
+
+  /* the same colors shifted and scaled describe alike, swapped ones do not*/
+  cv::Mat moved(480, 640, CV_8UC3, cv::Scalar(90, 90, 90));
+  cv::rectangle(moved, cv::Rect(300, 50, 120, 150), cv::Scalar(0, 0, 200), cv::FILLED);
+  cv::rectangle(moved, cv::Rect(300, 200, 120, 150), cv::Scalar(200, 0, 0), cv::FILLED);
+  ReidIndex::describe(moved, cv::Rect2d(300, 50, 120, 300), b);
+  ReidIndex::describe(getPerson(cv::Scalar(200, 0, 0), cv::Scalar(0, 0, 200)), kRoi, c);
+  float same = 0, swapped = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    same += a[i] * b[i];
+    swapped += a[i] * c[i];
+  }
+  EXPECT_GT(same, 0.99f);
+  EXPECT_LT(swapped, 0.5f);
+
+  ReidIndex::describe(moved, cv::Rect2d(700, 0, 10, 10), b);
+  EXPECT_TRUE(b.empty());
+}
+
+TEST(UnitTestReidIndex, take_Similar)
+{
+  ReidIndex index(16, 0, 0.8);
+  std::vector<float> red, green;
+  ReidIndex::describe(getPerson(cv::Scalar(0, 0, 200), cv::Scalar(200, 0, 0)), kRoi, red);
+  ReidIndex::describe(getPerson(cv::Scalar(0, 200, 0), cv::Scalar(0, 200, 200)), kRoi, green);
+  index.insert(7, 1, red, 0);
+  index.insert(8, 1, green, 0);
+  EXPECT_EQ(index.size(), static_cast<size_t>(2));
+
+  /* another class is never matched*/
+  EXPECT_EQ(index.take(2, red, kSecond), -1);
+  EXPECT_EQ(index.take(1, red, kSecond), 7);
+  /* taken once only*/
+  EXPECT_EQ(index.take(1, red, kSecond), -1);
+  EXPECT_EQ(index.take(1, green, kSecond), 8);
+  EXPECT_EQ(index.size(), static_cast<size_t>(0));
+}
+
+TEST(UnitTestReidIndex, insert_Expire)
+{
+  ReidIndex index(2, 10 * kSecond, 0.8);
+  std::vector<float> desc;
+  ReidIndex::describe(getPerson(cv::Scalar(0, 0, 200), cv::Scalar(200, 0, 0)), kRoi, desc);
+  index.insert(1, 1, desc, 0);
+  index.insert(2, 1, desc, kSecond);
+  /* beyond the capacity, the oldest goes*/
+  index.insert(3, 1, desc, 2 * kSecond);
+  EXPECT_EQ(index.size(), static_cast<size_t>(2));
+  int64_t id = index.take(1, desc, 3 * kSecond);
+  EXPECT_TRUE(id == 2 || id == 3);
+
+  /* beyond the maximum age, all are gone*/
+  EXPECT_EQ(index.take(1, desc, 20 * kSecond), -1);
+  EXPECT_EQ(index.size(), static_cast<size_t>(0));
+}
+
+TEST(UnitTestReidIndex, insert_OrderBounded)
+{
+  ReidIndex index(4, 0, 0.8);
+  std::vector<float> red, green;
+  ReidIndex::describe(getPerson(cv::Scalar(0, 0, 200), cv::Scalar(200, 0, 0)), kRoi, red);
+  ReidIndex::describe(getPerson(cv::Scalar(0, 200, 0), cv::Scalar(0, 200, 200)), kRoi, green);
+  index.insert(1, 1, red, 0);
+  /* the oldest entry stays, so the places of those taken behind it are never shed at the front*/
+  for (int64_t id = 2; id < 1000; id++) {
+    index.insert(id, 1, green, id);
+    ASSERT_EQ(index.take(1, green, id), id);
+    ASSERT_LE(index.getOrdered(), static_cast<size_t>(2 * 4));
+  }
+  EXPECT_EQ(index.size(), static_cast<size_t>(1));
+  EXPECT_EQ(index.take(1, red, kSecond), 1);
+}
+
+TEST(UnitTestReidIndex, blend_Running)
+{
+  std::vector<float> running, red, green;
+  ReidIndex::describe(getPerson(cv::Scalar(0, 0, 200), cv::Scalar(200, 0, 0)), kRoi, red);
+  ReidIndex::describe(getPerson(cv::Scalar(0, 200, 0), cv::Scalar(0, 200, 200)), kRoi, green);
+  ReidIndex::blend(running, red, 0.3f);
+  EXPECT_EQ(running, red);
+  ReidIndex::blend(running, green, 0.3f);
+  float to_red = 0, to_green = 0, norm = 0;
+  for (size_t i = 0; i < running.size(); i++) {
+    to_red += running[i] * red[i];
+    to_green += running[i] * green[i];
+    norm += running[i] * running[i];
+  }
+  EXPECT_GT(to_red, to_green);
+  EXPECT_NEAR(norm, 1.0f, 1e-4);
+}
+
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
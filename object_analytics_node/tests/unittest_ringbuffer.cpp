@@ -0,0 +1,78 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include "object_analytics_node/util/stamped_ring_buffer.hpp"
+
+using object_analytics_node::util::StampedRingBuffer;
+
+TEST(UnitTestRingBuffer, push_OverwriteOldest)
+{
+  StampedRingBuffer<int> buffer(3);
+  for (int i = 0; i < 5; i++) {
+    buffer.push(i * 10, i);
+  }
+  ASSERT_EQ(buffer.size(), static_cast<size_t>(3));
+  EXPECT_EQ(buffer.stampAt(0), 20);
+  EXPECT_EQ(buffer.valueAt(2), 4);
+  EXPECT_EQ(buffer.find(10), nullptr);
+  ASSERT_NE(buffer.find(30), nullptr);
+  EXPECT_EQ(*buffer.find(30), 3);
+}
+
+TEST(UnitTestRingBuffer, push_OutOfOrder)
+{
+  StampedRingBuffer<std::string> buffer(4);
+  buffer.push(10, "a");
+  buffer.push(20, "b");
+  buffer.push(30, "c");
+  buffer.push(20, "d");
+  ASSERT_EQ(buffer.size(), static_cast<size_t>(2));
+  EXPECT_EQ(*buffer.find(20), std::string("d"));
+  EXPECT_EQ(buffer.find(30), nullptr);
+}
+
+TEST(UnitTestRingBuffer, lowerBound_DropBefore)
+{
+  StampedRingBuffer<int> buffer(8);
+  for (int i = 0; i < 6; i++) {
+    buffer.push(i * 10, i);
+  }
+  EXPECT_EQ(buffer.lowerBound(25), static_cast<size_t>(3));
+  EXPECT_EQ(buffer.lowerBound(100), static_cast<size_t>(6));
+  buffer.dropBefore(25);
+  ASSERT_EQ(buffer.size(), static_cast<size_t>(3));
+  EXPECT_EQ(buffer.stampAt(0), 30);
+}
+
+TEST(UnitTestRingBuffer, clear_SetCapacity)
+{
+  StampedRingBuffer<int> buffer(2);
+  buffer.push(1, 1);
+  buffer.clear();
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(buffer.find(1), nullptr);
+
+  buffer.push(1, 1);
+  buffer.setCapacity(60);
+  EXPECT_EQ(buffer.capacity(), static_cast<size_t>(60));
+  EXPECT_TRUE(buffer.empty());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
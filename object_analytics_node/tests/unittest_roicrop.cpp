@@ -0,0 +1,173 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define PCL_NO_PRECOMPILE
+#include <gtest/gtest.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <stdexcept>
+#include <vector>
+#include "object_analytics_node/segmenter/point_cloud2_view.hpp"
+#include "object_analytics_node/util/roi_crop.hpp"
+#include "unittest_util.hpp"
+
+using object_analytics_node::segmenter::PointCloud2View;
+using object_analytics_node::util::RoiCrop;
+using object_analytics_msgs::msg::CroppedPointCloud;
+
+static void getCloud(sensor_msgs::msg::PointCloud2 & msg)
+{
+  pcl::PointCloud<pcl::PointXYZRGB> cloud(64, 48);
+  for (size_t i = 0; i < cloud.size(); i++) {
+    cloud.points[i].x = (static_cast<float>(i % 64) - 32) * 0.01f;
+    cloud.points[i].y = (static_cast<float>(i / 64) - 24) * 0.01f;
+    cloud.points[i].z = 1.5f + 0.0001f * i;
+  }
+  pcl::toROSMsg(cloud, msg);
+}
+
+static void addRoi(object_msgs::msg::ObjectsInBoxes & objs, int x, int y, int w, int h)
+{
+  object_msgs::msg::ObjectInBox obj;
+  obj.roi.x_offset = x;
+  obj.roi.y_offset = y;
+  obj.roi.width = w;
+  obj.roi.height = h;
+  objs.objects_vector.push_back(obj);
+}
+
+TEST(UnitTestRoiCrop, getWindows_ExpandedClippedAndMerged)
+{
+  object_msgs::msg::ObjectsInBoxes objs;
+  std::vector<RoiCrop::Window> windows;
+  RoiCrop::getWindows(objs, 64, 48, 2, windows);
+  EXPECT_TRUE(windows.empty());
+
+  addRoi(objs, 0, 0, 10, 10);
+  addRoi(objs, 40, 30, 30, 30);
+  RoiCrop::getWindows(objs, 64, 48, 2, windows);
+  ASSERT_EQ(windows.size(), 2u);
+  EXPECT_EQ(windows[0].x_offset, 0u);
+  EXPECT_EQ(windows[0].width, 12u);
+  EXPECT_EQ(windows[0].height, 12u);
+  EXPECT_EQ(windows[1].x_offset, 38u);
+  EXPECT_EQ(windows[1].y_offset, 28u);
+  EXPECT_EQ(windows[1].width, 26u);
+  EXPECT_EQ(windows[1].height, 20u);
+
+  /* overlapping both once expanded*/
+  addRoi(objs, 12, 12, 26, 16);
+  RoiCrop::getWindows(objs, 64, 48, 2, windows);
+  ASSERT_EQ(windows.size(), 1u);
+  EXPECT_EQ(windows[0].x_offset, 0u);
+  EXPECT_EQ(windows[0].y_offset, 0u);
+  EXPECT_EQ(windows[0].width, 64u);
+  EXPECT_EQ(windows[0].height, 48u);
+
+  objs.objects_vector.clear();
+  addRoi(objs, 100, 100, 10, 10);
+  RoiCrop::getWindows(objs, 64, 48, 2, windows);
+  EXPECT_TRUE(windows.empty());
+}
+
+TEST(UnitTestRoiCrop, expand_SameInWindowsNaNOutside)
+{
+  sensor_msgs::msg::PointCloud2 msg, expanded;
+  getCloud(msg);
+  object_msgs::msg::ObjectsInBoxes objs;
+  addRoi(objs, 4, 4, 8, 6);
+  addRoi(objs, 30, 20, 10, 10);
+  std::vector<RoiCrop::Window> windows;
+  RoiCrop::getWindows(objs, msg.width, msg.height, 1, windows);
+  CroppedPointCloud cropped;
+  RoiCrop::crop(msg, windows, cropped);
+  EXPECT_EQ(cropped.points.width * cropped.points.height, 10u * 8u + 12u * 12u);
+
+  RoiCrop::expand(cropped, expanded);
+  EXPECT_EQ(expanded.header, msg.header);
+  EXPECT_EQ(expanded.width, msg.width);
+  EXPECT_EQ(expanded.height, msg.height);
+  PointCloud2View in(msg), out(expanded);
+  for (size_t i = 0; i < in.size(); i++) {
+    uint32_t x = i % msg.width, y = i / msg.width;
+    bool inside = false;
+    for (auto & w : windows) {
+      inside = inside || (x >= w.x_offset && x < w.x_offset + w.width &&
+        y >= w.y_offset && y < w.y_offset + w.height);
+    }
+    if (!inside) {
+      EXPECT_FALSE(out.isFinite(i));
+      continue;
+    }
+    EXPECT_EQ(in.at(i).x, out.at(i).x);
+    EXPECT_EQ(in.at(i).y, out.at(i).y);
+    EXPECT_EQ(in.at(i).z, out.at(i).z);
+  }
+}
+
+TEST(UnitTestRoiCrop, expand_ResetsOnlyWrittenWindows)
+{
+  sensor_msgs::msg::PointCloud2 msg, pooled, fresh;
+  getCloud(msg);
+  object_msgs::msg::ObjectsInBoxes first, second;
+  addRoi(first, 4, 4, 8, 6);
+  addRoi(second, 30, 20, 10, 10);
+  std::vector<RoiCrop::Window> windows;
+  CroppedPointCloud cropped;
+
+  RoiCrop::getWindows(first, msg.width, msg.height, 0, windows);
+  RoiCrop::crop(msg, windows, cropped);
+  RoiCrop::expand(cropped, pooled);
+  std::vector<RoiCrop::Window> written = windows;
+
+  /* the pooled cloud ends the same as one expanded from scratch*/
+  RoiCrop::getWindows(second, msg.width, msg.height, 0, windows);
+  RoiCrop::crop(msg, windows, cropped);
+  const uint8_t * data = pooled.data.data();
+  RoiCrop::expand(cropped, pooled, &written);
+  RoiCrop::expand(cropped, fresh);
+  EXPECT_EQ(data, pooled.data.data());
+  ASSERT_EQ(written.size(), windows.size());
+  EXPECT_EQ(written[0], windows[0]);
+  ASSERT_EQ(fresh.data.size(), pooled.data.size());
+  PointCloud2View out(pooled), expected(fresh);
+  for (size_t i = 0; i < out.size(); i++) {
+    ASSERT_EQ(expected.isFinite(i), out.isFinite(i));
+    if (out.isFinite(i)) {
+      EXPECT_EQ(expected.at(i).z, out.at(i).z);
+    }
+  }
+}
+
+TEST(UnitTestRoiCrop, expand_ThrowsOnMismatchedWindows)
+{
+  sensor_msgs::msg::PointCloud2 msg, expanded;
+  getCloud(msg);
+  object_msgs::msg::ObjectsInBoxes objs;
+  addRoi(objs, 4, 4, 8, 6);
+  std::vector<RoiCrop::Window> windows;
+  RoiCrop::getWindows(objs, msg.width, msg.height, 0, windows);
+  CroppedPointCloud cropped;
+  RoiCrop::crop(msg, windows, cropped);
+  cropped.windows[0].width++;
+  EXPECT_THROW(RoiCrop::expand(cropped, expanded), std::runtime_error);
+
+  windows[0].x_offset = 60;
+  EXPECT_THROW(RoiCrop::crop(msg, windows, cropped), std::runtime_error);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,7 @@
 #include <object_msgs/msg/object_in_box.hpp>
 #include <gtest/gtest.h>
 #include <pcl_conversions/pcl_conversions.h>
+#include <algorithm>
 #include <string>
 #include <cassert>
 #include <vector>
@@ -24,12 +25,23 @@
 #include "object_analytics_node/segmenter/segmenter.hpp"
 #include "object_analytics_node/segmenter/algorithm.hpp"
 #include "object_analytics_node/segmenter/algorithm_provider.hpp"
+#include "object_analytics_node/segmenter/algorithm_provider_impl.hpp"
+#include "object_analytics_node/segmenter/organized_multi_plane_segmenter.hpp"
+#ifdef OBJECT_ANALYTICS_NODE_OPENCL
+#include "object_analytics_node/segmenter/opencl_euclidean_segmenter.hpp"
+#endif
 #include "object_analytics_node/model/object2d.hpp"
 #include "unittest_util.hpp"
 
 using object_analytics_node::segmenter::Algorithm;
+using object_analytics_node::segmenter::AlgorithmConfig;
 using object_analytics_node::segmenter::AlgorithmProvider;
+using object_analytics_node::segmenter::AlgorithmProviderImpl;
+using object_analytics_node::segmenter::ObjectPointIndices;
+using object_analytics_node::segmenter::OrganizedMultiPlaneSegmenter;
 using object_analytics_node::segmenter::Segmenter;
+using object_analytics_node::segmenter::TrackedObjects;
+using object_analytics_msgs::msg::TrackedObject;
 using object_msgs::msg::ObjectsInBoxes;
 class Algo : public Algorithm
 {
@@ -49,6 +61,125 @@ public:
   }
 };
 
+class CountingAlgo : public Algo
+{
+public:
+  void segment(
+    const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud,
+    std::vector<pcl::PointIndices> & cluster_indices)
+  {
+    sizes.push_back(cloud->size());
+    Algo::segment(cloud, cluster_indices);
+  }
+
+  std::vector<size_t> sizes;
+};
+
+class CountingAlgoProvider : public AlgorithmProvider
+{
+public:
+  virtual std::shared_ptr<Algorithm> get()
+  {
+    return algo_;
+  }
+
+  CountingAlgoProvider()
+  : algo_(std::make_shared<CountingAlgo>())
+  {
+  }
+
+  std::shared_ptr<CountingAlgo> algo_;
+};
+
+class SceneAlgo : public Algo
+{
+public:
+  bool wantsScene(uint64_t stamp, const std::string & frame_id)
+  {
+    (void)frame_id;
+    bool wanted = stamps.empty() || stamps.back() != stamp;
+    stamps.push_back(stamp);
+    return wanted;
+  }
+
+  void setScene(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & scene)
+  {
+    scene_sizes.push_back(scene->size());
+  }
+
+  void clearScene()
+  {
+    stamps.clear();
+    scene_sizes.clear();
+    cleared++;
+  }
+
+  std::vector<uint64_t> stamps;
+  std::vector<size_t> scene_sizes;
+  size_t cleared = 0;
+};
+
+class SceneAlgoProvider : public AlgorithmProvider
+{
+public:
+  virtual std::shared_ptr<Algorithm> get()
+  {
+    return algo_;
+  }
+
+  SceneAlgoProvider()
+  : algo_(std::make_shared<SceneAlgo>())
+  {
+  }
+
+  std::shared_ptr<SceneAlgo> algo_;
+};
+
+class OrganizedAlgo : public Algo
+{
+public:
+  bool isOrganized() const
+  {
+    return true;
+  }
+
+  void setSearchCloud(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud)
+  {
+    search_cloud_ = cloud;
+  }
+
+  void segment(
+    const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & cloud, const std::vector<int> & indices,
+    std::vector<pcl::PointIndices> & cluster_indices)
+  {
+    EXPECT_EQ(cloud, search_cloud_);
+    EXPECT_TRUE(cloud->isOrganized());
+    pcl::PointIndices cluster;
+    cluster.indices = indices;
+    cluster_indices.push_back(cluster);
+  }
+
+private:
+  pcl::PointCloud<pcl::PointXYZ>::ConstPtr search_cloud_;
+};
+
+class OrganizedAlgoProvider : public AlgorithmProvider
+{
+public:
+  virtual std::shared_ptr<Algorithm> get()
+  {
+    return algo_;
+  }
+
+  OrganizedAlgoProvider()
+  : algo_(std::make_shared<OrganizedAlgo>())
+  {
+  }
+
+private:
+  std::shared_ptr<Algorithm> algo_;
+};
+
 class AlgoProvider : public AlgorithmProvider
 {
 public:
@@ -57,6 +188,11 @@ public:
     return algo_;
   }
 
+  virtual std::shared_ptr<Algorithm> create()
+  {
+    return std::make_shared<Algo>();
+  }
+
   AlgoProvider()
   : algo_(std::make_shared<Algo>())
   {
@@ -96,6 +232,540 @@ TEST(UnitTestSegmenter, segmenter)
   EXPECT_TRUE(obj3d.roi == getRoi(0, 0, 5, 5));
 }
 
+TEST(UnitTestSegmenter, segmenter_SharedSearch)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 5, 5, "person", 0.99));
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 3, 3, "dog", 0.9));
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+
+  std::unique_ptr<Segmenter> impl;
+  impl.reset(new Segmenter(std::unique_ptr<AlgoProvider>(new AlgoProvider())));
+  std::shared_ptr<ObjectsInBoxes3D> separate = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, separate);
+  impl->setSharedSearch(true);
+  std::shared_ptr<ObjectsInBoxes3D> shared = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, shared);
+
+  ASSERT_EQ(static_cast<size_t>(2), shared->objects_in_boxes.size());
+  ASSERT_EQ(separate->objects_in_boxes.size(), shared->objects_in_boxes.size());
+  for (size_t i = 0; i < shared->objects_in_boxes.size(); i++) {
+    EXPECT_TRUE(shared->objects_in_boxes[i].min == separate->objects_in_boxes[i].min);
+    EXPECT_TRUE(shared->objects_in_boxes[i].max == separate->objects_in_boxes[i].max);
+    EXPECT_TRUE(shared->objects_in_boxes[i].roi == separate->objects_in_boxes[i].roi);
+  }
+  EXPECT_TRUE(shared->objects_in_boxes[0].max == getPoint32(44.1, 44.2, 44.3));
+}
+
+TEST(UnitTestSegmenter, segmenter_ParallelInDetectionOrder)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  for (int i = 1; i <= 5; i++) {
+    objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, i, i, "person", 0.99));
+  }
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+
+  std::unique_ptr<Segmenter> impl;
+  impl.reset(new Segmenter(std::unique_ptr<AlgoProvider>(new AlgoProvider())));
+  std::shared_ptr<ObjectsInBoxes3D> serial = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, serial);
+  impl->setNumThreads(3);
+  std::shared_ptr<ObjectsInBoxes3D> parallel = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, parallel);
+
+  ASSERT_EQ(static_cast<size_t>(5), parallel->objects_in_boxes.size());
+  ASSERT_EQ(serial->objects_in_boxes.size(), parallel->objects_in_boxes.size());
+  for (size_t i = 0; i < parallel->objects_in_boxes.size(); i++) {
+    EXPECT_TRUE(parallel->objects_in_boxes[i].min == serial->objects_in_boxes[i].min);
+    EXPECT_TRUE(parallel->objects_in_boxes[i].max == serial->objects_in_boxes[i].max);
+    EXPECT_TRUE(parallel->objects_in_boxes[i].roi == getRoi(0, 0, i + 1, i + 1));
+  }
+}
+
+TEST(UnitTestSegmenter, segmenter_OrganizedView)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 5, 5, "person", 0.99));
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+
+  std::unique_ptr<Segmenter> impl;
+  impl.reset(new Segmenter(std::unique_ptr<OrganizedAlgoProvider>(new OrganizedAlgoProvider())));
+  std::shared_ptr<ObjectsInBoxes3D> obj3ds = std::make_shared<ObjectsInBoxes3D>();
+
+  impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+
+  ASSERT_EQ(static_cast<size_t>(1), obj3ds->objects_in_boxes.size());
+  ObjectInBox3D obj3d = obj3ds->objects_in_boxes[0];
+  EXPECT_TRUE(obj3d.min == getPoint32(0.1, 0.2, 0.3));
+  EXPECT_TRUE(obj3d.max == getPoint32(44.1, 44.2, 44.3));
+  EXPECT_TRUE(obj3d.roi == getRoi(0, 0, 5, 5));
+}
+
+TEST(UnitTestSegmenter, segmenter_BuffersReused)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 5, 5, "person", 0.99));
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 3, 3, "dog", 0.9));
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+
+  std::unique_ptr<Segmenter> impl;
+  impl.reset(new Segmenter(std::unique_ptr<AlgoProvider>(new AlgoProvider())));
+  for (bool shared : {false, true}) {
+    impl->setSharedSearch(shared);
+    std::shared_ptr<ObjectsInBoxes3D> warmup = std::make_shared<ObjectsInBoxes3D>();
+    impl->segment(objects_in_boxes2d, cloudMsg, warmup);
+    size_t allocations = impl->getBufferAllocations();
+    for (int frame = 0; frame < 3; frame++) {
+      std::shared_ptr<ObjectsInBoxes3D> obj3ds = std::make_shared<ObjectsInBoxes3D>();
+      impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+      EXPECT_EQ(warmup->objects_in_boxes.size(), obj3ds->objects_in_boxes.size());
+    }
+    EXPECT_EQ(allocations, impl->getBufferAllocations());
+  }
+}
+
+TEST(UnitTestSegmenter, segmenter_Warmup)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 5, 5, "person", 0.99));
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 3, 3, "dog", 0.5));
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+  object_analytics_node::util::DetectionFilter filter;
+  filter.setMinProbability(0.8f);
+
+  std::unique_ptr<Segmenter> impl;
+  impl.reset(new Segmenter(std::unique_ptr<AlgoProvider>(new AlgoProvider())));
+  impl->setFilter(filter);
+  impl->setNumThreads(2);
+  impl->warmup(64, 48);
+  std::shared_ptr<ObjectsInBoxes3D> obj3ds = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+
+  /* the filter is back in place, nothing of the synthetic frame is kept*/
+  ASSERT_EQ(static_cast<size_t>(1), obj3ds->objects_in_boxes.size());
+  ObjectInBox3D obj3d = obj3ds->objects_in_boxes[0];
+  EXPECT_TRUE(obj3d.min == getPoint32(0.1, 0.2, 0.3));
+  EXPECT_TRUE(obj3d.max == getPoint32(44.1, 44.2, 44.3));
+  EXPECT_TRUE(obj3d.roi == getRoi(0, 0, 5, 5));
+}
+
+TEST(UnitTestSegmenter, segmenter_SceneOncePerFrame)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 5, 5, "person", 0.99));
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 3, 3, "dog", 0.9));
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+
+  SceneAlgoProvider * provider = new SceneAlgoProvider();
+  std::shared_ptr<SceneAlgo> algo = provider->algo_;
+  std::unique_ptr<Segmenter> impl;
+  impl.reset(new Segmenter(std::unique_ptr<AlgorithmProvider>(provider)));
+
+  /* nothing of the synthetic frame is kept*/
+  impl->warmup(64, 48);
+  EXPECT_EQ(static_cast<size_t>(1), algo->cleared);
+  EXPECT_TRUE(algo->stamps.empty());
+
+  /* one scene of the full frame for both ROIs*/
+  std::shared_ptr<ObjectsInBoxes3D> obj3ds = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+  EXPECT_EQ(static_cast<size_t>(1), algo->stamps.size());
+  ASSERT_EQ(static_cast<size_t>(1), algo->scene_sizes.size());
+  EXPECT_GT(algo->scene_sizes[0], static_cast<size_t>(0));
+  EXPECT_LE(algo->scene_sizes[0], cloud->size());
+}
+
+TEST(UnitTestSegmenter, segmenter_ObjectPointIndices)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 5, 5, "person", 0.99));
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 3, 3, "dog", 0.9));
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+
+  std::unique_ptr<Segmenter> separate_impl(
+    new Segmenter(std::unique_ptr<AlgoProvider>(new AlgoProvider())));
+  std::unique_ptr<Segmenter> shared_impl(
+    new Segmenter(std::unique_ptr<AlgoProvider>(new AlgoProvider())));
+  shared_impl->setSharedSearch(true);
+  std::unique_ptr<Segmenter> organized_impl(
+    new Segmenter(std::unique_ptr<OrganizedAlgoProvider>(new OrganizedAlgoProvider())));
+
+  ObjectPointIndices expected;
+  for (auto impl : {separate_impl.get(), shared_impl.get(), organized_impl.get()}) {
+    std::shared_ptr<ObjectsInBoxes3D> obj3ds = std::make_shared<ObjectsInBoxes3D>();
+    ObjectPointIndices indices;
+    impl->segment(objects_in_boxes2d, cloudMsg, obj3ds, indices);
+    ASSERT_EQ(static_cast<size_t>(2), obj3ds->objects_in_boxes.size());
+    ASSERT_EQ(static_cast<size_t>(3), indices.offsets.size());
+    EXPECT_EQ(indices.offsets.back(), indices.indices.size());
+    EXPECT_EQ(indices.header, obj3ds->header);
+    for (size_t i = 0; i < obj3ds->objects_in_boxes.size(); i++) {
+      const ObjectInBox3D & obj3d = obj3ds->objects_in_boxes[i];
+      EXPECT_LT(indices.offsets[i], indices.offsets[i + 1]);
+      for (uint32_t p = indices.offsets[i]; p < indices.offsets[i + 1]; p++) {
+        /* the indices are into the cloud, within the ROI and the bounds of the object*/
+        uint32_t idx = indices.indices[p];
+        ASSERT_LT(idx, cloud->size());
+        EXPECT_LT(idx % cloud->width, obj3d.roi.x_offset + obj3d.roi.width);
+        EXPECT_LT(idx / cloud->width, obj3d.roi.y_offset + obj3d.roi.height);
+        EXPECT_GE(cloud->points[idx].z, obj3d.min.z);
+        EXPECT_LE(cloud->points[idx].z, obj3d.max.z);
+      }
+    }
+    std::sort(indices.indices.begin() + indices.offsets[0],
+      indices.indices.begin() + indices.offsets[1]);
+    std::sort(indices.indices.begin() + indices.offsets[1], indices.indices.end());
+    if (expected.indices.empty()) {
+      expected = indices;
+    } else {
+      EXPECT_EQ(expected.offsets, indices.offsets);
+      EXPECT_EQ(expected.indices, indices.indices);
+    }
+  }
+}
+
+TEST(UnitTestSegmenter, segmenter_TargetPoints)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 5, 5, "person", 0.99));
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 2, 2, "dog", 0.9));
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+
+  CountingAlgoProvider * provider = new CountingAlgoProvider();
+  std::shared_ptr<CountingAlgo> algo = provider->algo_;
+  std::unique_ptr<Segmenter> impl;
+  impl.reset(new Segmenter(std::unique_ptr<AlgorithmProvider>(provider)));
+
+  /* the big ROI is sampled sparsely, the small one keeps all its points*/
+  impl->setTargetPoints(4);
+  std::shared_ptr<ObjectsInBoxes3D> obj3ds = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+  ASSERT_EQ(static_cast<size_t>(2), algo->sizes.size());
+  EXPECT_EQ(static_cast<size_t>(4), algo->sizes[0]);
+  EXPECT_EQ(static_cast<size_t>(4), algo->sizes[1]);
+
+  /* the budget is shared among the ROIs*/
+  algo->sizes.clear();
+  impl->setTargetPoints(25, 2);
+  obj3ds = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+  ASSERT_EQ(static_cast<size_t>(2), algo->sizes.size());
+  EXPECT_EQ(static_cast<size_t>(1), algo->sizes[0]);
+  EXPECT_EQ(static_cast<size_t>(1), algo->sizes[1]);
+}
+
+TEST(UnitTestSegmenter, segmenter_TrackingReuse)
+{
+  PointCloudT::Ptr cloud(new PointCloudT);
+  ObjectsInBoxes::SharedPtr objects_in_boxes2d = std::make_shared<ObjectsInBoxes>();
+  std_msgs::msg::Header header2D =
+    createHeader(builtin_interfaces::msg::Time(), "camera_rgb_optical_frame");
+  objects_in_boxes2d->header = header2D;
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(0, 0, 2, 2, "person", 0.99));
+  objects_in_boxes2d->objects_vector.push_back(getObjectInBox(3, 3, 2, 2, "dog", 0.9));
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/segment.pcd", cloud);
+
+  sensor_msgs::msg::PointCloud2::SharedPtr cloudMsg =
+    std::make_shared<sensor_msgs::msg::PointCloud2>();
+  pcl::toROSMsg(*cloud, *cloudMsg);
+
+  CountingAlgoProvider * provider = new CountingAlgoProvider();
+  std::shared_ptr<CountingAlgo> algo = provider->algo_;
+  std::unique_ptr<Segmenter> impl;
+  impl.reset(new Segmenter(std::unique_ptr<AlgorithmProvider>(provider)));
+  impl->setTemporalReuse(1, 1.5f, 2);
+
+  TrackedObjects tracks;
+  TrackedObject track;
+  track.id = 7;
+  track.roi = getRoi(0, 0, 2, 2);
+  tracks.tracked_objects.push_back(track);
+  impl->setTrackedObjects(tracks);
+
+  /* the tracked object takes the tracking id*/
+  std::shared_ptr<ObjectsInBoxes3D> obj3ds = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+  ASSERT_EQ(static_cast<size_t>(2), obj3ds->objects_in_boxes.size());
+  EXPECT_EQ(7, obj3ds->objects_in_boxes[0].id);
+  EXPECT_EQ(-1, obj3ds->objects_in_boxes[1].id);
+  EXPECT_EQ(static_cast<size_t>(2), algo->sizes.size());
+  ObjectInBox3D first = obj3ds->objects_in_boxes[0];
+
+  /* bounds of the still object are reused up to 2 frames*/
+  for (int frame = 0; frame < 3; frame++) {
+    algo->sizes.clear();
+    obj3ds = std::make_shared<ObjectsInBoxes3D>();
+    impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+    ASSERT_EQ(static_cast<size_t>(2), obj3ds->objects_in_boxes.size());
+    EXPECT_EQ(7, obj3ds->objects_in_boxes[0].id);
+    EXPECT_TRUE(obj3ds->objects_in_boxes[0].min == first.min);
+    EXPECT_TRUE(obj3ds->objects_in_boxes[0].max == first.max);
+    EXPECT_EQ(static_cast<size_t>(frame < 2 ? 1 : 2), algo->sizes.size());
+  }
+
+  /* the moved object is segmented within its last depth range, 0.3 to 11.3*/
+  objects_in_boxes2d->objects_vector[0] = getObjectInBox(0, 0, 5, 5, "person", 0.99);
+  tracks.tracked_objects[0].roi = getRoi(0, 0, 5, 5);
+  impl->setTrackedObjects(tracks);
+  algo->sizes.clear();
+  obj3ds = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+  ASSERT_EQ(static_cast<size_t>(2), algo->sizes.size());
+  EXPECT_EQ(static_cast<size_t>(8), algo->sizes[0]);
+  EXPECT_EQ(7, obj3ds->objects_in_boxes[0].id);
+  EXPECT_TRUE(obj3ds->objects_in_boxes[0].max == getPoint32(12.1, 12.2, 12.3));
+
+  /* objects no longer tracked are segmented without ids*/
+  impl->setTrackedObjects(TrackedObjects());
+  algo->sizes.clear();
+  obj3ds = std::make_shared<ObjectsInBoxes3D>();
+  impl->segment(objects_in_boxes2d, cloudMsg, obj3ds);
+  ASSERT_EQ(static_cast<size_t>(2), algo->sizes.size());
+  EXPECT_EQ(static_cast<size_t>(25), algo->sizes[0]);
+  EXPECT_EQ(-1, obj3ds->objects_in_boxes[0].id);
+}
+
+TEST(UnitTestSegmenter, multiPlaneSegmenter_VoxelSameClusters)
+{
+  /* two 10 x 10 x 2 blocks of points 1cm apart, 1m away from each other*/
+  PointCloudT::Ptr cloud(new PointCloudT);
+  for (int block = 0; block < 2; block++) {
+    for (int x = 0; x < 10; x++) {
+      for (int y = 0; y < 10; y++) {
+        for (int z = 0; z < 2; z++) {
+          cloud->push_back(PointT(block + x * 0.01f, y * 0.01f, 1.0f + z * 0.01f));
+        }
+      }
+    }
+  }
+
+  std::vector<pcl::PointIndices> expected;
+  OrganizedMultiPlaneSegmenter plain;
+  plain.segment(cloud, expected);
+  ASSERT_EQ(static_cast<size_t>(2), expected.size());
+
+  AlgorithmConfig conf;
+  conf.set("VOXEL_LEAF_SIZE", "0.03");
+  std::vector<pcl::PointIndices> clusters;
+  OrganizedMultiPlaneSegmenter voxel(false, conf);
+  voxel.segment(cloud, clusters);
+  ASSERT_EQ(expected.size(), clusters.size());
+  for (auto & cluster : expected) {
+    std::sort(cluster.indices.begin(), cluster.indices.end());
+  }
+  auto by_first = [](const pcl::PointIndices & a, const pcl::PointIndices & b) {
+      return a.indices.front() < b.indices.front();
+    };
+  std::sort(expected.begin(), expected.end(), by_first);
+  std::sort(clusters.begin(), clusters.end(), by_first);
+  for (size_t i = 0; i < clusters.size(); i++) {
+    EXPECT_EQ(expected[i].indices, clusters[i].indices);
+  }
+}
+
+TEST(UnitTestSegmenter, algorithmProvider_BuildsOnFirstGet)
+{
+  AlgorithmProviderImpl provider(AlgorithmProviderImpl::kConnectedComponent);
+  std::shared_ptr<Algorithm> algo = provider.get();
+  ASSERT_NE(nullptr, algo);
+  EXPECT_TRUE(algo->isOrganized());
+  EXPECT_EQ(algo, provider.get());
+
+  std::shared_ptr<Algorithm> created = provider.create();
+  ASSERT_NE(nullptr, created);
+  EXPECT_NE(algo, created);
+
+  /* an unknown name falls back to the default algorithm*/
+  AlgorithmProviderImpl fallback("unknown");
+  EXPECT_EQ(AlgorithmProviderImpl::kMultiPlane, fallback.getName());
+  EXPECT_FALSE(fallback.get()->isOrganized());
+}
+
+TEST(UnitTestSegmenter, multiPlaneSegmenter_SetConfigReapplied)
+{
+  /* a 10 x 10 patch, one cluster of 100 points*/
+  PointCloudT::Ptr patch(new PointCloudT);
+  for (int x = 0; x < 10; x++) {
+    for (int y = 0; y < 10; y++) {
+      patch->push_back(PointT(x * 0.02f, y * 0.02f, 1.0f));
+    }
+  }
+  OrganizedMultiPlaneSegmenter algo;
+  std::vector<pcl::PointIndices> clusters;
+  algo.segment(patch, clusters);
+  ASSERT_EQ(static_cast<size_t>(1), clusters.size());
+
+  /* too small for the new minimum*/
+  AlgorithmConfig conf;
+  conf.set("OBJECT_MINIMUM_POINTS", "101");
+  algo.setConfig(conf);
+  clusters.clear();
+  algo.segment(patch, clusters);
+  EXPECT_EQ(static_cast<size_t>(0), clusters.size());
+
+  conf.set("OBJECT_MINIMUM_POINTS", "100");
+  algo.setConfig(conf);
+  clusters.clear();
+  algo.segment(patch, clusters);
+  EXPECT_EQ(static_cast<size_t>(1), clusters.size());
+}
+
+TEST(UnitTestSegmenter, multiPlaneSegmenter_PlaneCacheRemovesFloor)
+{
+  /* a 30 x 30 floor at z = 0 and a 5 x 5 x 4 box standing on it*/
+  PointCloudT::Ptr cloud(new PointCloudT);
+  for (int x = 0; x < 30; x++) {
+    for (int y = 0; y < 30; y++) {
+      cloud->push_back(PointT(x * 0.02f, y * 0.02f, 0.0f));
+    }
+  }
+  size_t floor_size = cloud->size();
+  for (int x = 0; x < 5; x++) {
+    for (int y = 0; y < 5; y++) {
+      for (int z = 0; z < 4; z++) {
+        cloud->push_back(PointT(0.2f + x * 0.02f, 0.2f + y * 0.02f, 0.03f + z * 0.02f));
+      }
+    }
+  }
+
+  std::vector<pcl::PointIndices> clusters;
+  OrganizedMultiPlaneSegmenter plain;
+  plain.segment(cloud, clusters);
+  ASSERT_EQ(static_cast<size_t>(1), clusters.size());
+  EXPECT_EQ(cloud->size(), clusters[0].indices.size());
+
+  AlgorithmConfig conf;
+  conf.set("PLANE_CACHE_FRAMES", "10");
+  OrganizedMultiPlaneSegmenter cached(false, conf);
+  for (int frame = 0; frame < 2; frame++) {
+    /* the plane is fitted on the first frame only, and kept for the next*/
+    EXPECT_EQ(frame == 0, cached.wantsScene(frame, "camera"));
+    EXPECT_FALSE(cached.wantsScene(frame, "camera"));
+    if (frame == 0) {
+      cached.setScene(cloud);
+    }
+    clusters.clear();
+    cached.segment(cloud, clusters);
+    ASSERT_EQ(static_cast<size_t>(1), clusters.size());
+    ASSERT_EQ(cloud->size() - floor_size, clusters[0].indices.size());
+    EXPECT_EQ(static_cast<int>(floor_size), clusters[0].indices.front());
+  }
+}
+
+TEST(UnitTestSegmenter, multiPlaneSegmenter_PlaneCacheNotFittedOnRoi)
+{
+  /* a ROI crop of a box without any floor, with no scene given there is no plane to remove*/
+  PointCloudT::Ptr box(new PointCloudT);
+  for (int x = 0; x < 10; x++) {
+    for (int y = 0; y < 10; y++) {
+      box->push_back(PointT(x * 0.02f, y * 0.02f, 1.0f));
+    }
+  }
+  AlgorithmConfig conf;
+  conf.set("PLANE_CACHE_FRAMES", "10");
+  OrganizedMultiPlaneSegmenter cached(false, conf);
+  EXPECT_TRUE(cached.wantsScene(0, "camera"));
+
+  std::vector<pcl::PointIndices> clusters;
+  cached.segment(box, clusters);
+  ASSERT_EQ(static_cast<size_t>(1), clusters.size());
+  EXPECT_EQ(box->size(), clusters[0].indices.size());
+
+  /* a new frame id drops the plane and asks for a scene again*/
+  EXPECT_FALSE(cached.wantsScene(0, "camera"));
+  EXPECT_TRUE(cached.wantsScene(0, "other"));
+}
+
+#ifdef OBJECT_ANALYTICS_NODE_OPENCL
+TEST(UnitTestSegmenter, openCLSegmenter_SameClustersAsCPU)
+{
+  /* a chain of points 5cm apart, cut in two by a 20cm gap, and a stray point*/
+  PointCloudT::Ptr cloud(new PointCloudT);
+  for (int k = 0; k < 150; k++) {
+    cloud->push_back(PointT((k < 80 ? k : k + 4) * 0.05f, 0.0f, 1.0f));
+  }
+  cloud->push_back(PointT(0.0f, 1.0f, 1.0f));
+
+  std::vector<pcl::PointIndices> expected;
+  OrganizedMultiPlaneSegmenter cpu;
+  cpu.segment(cloud, expected);
+  ASSERT_EQ(static_cast<size_t>(2), expected.size());
+
+  std::vector<pcl::PointIndices> clusters;
+  OpenCLEuclideanSegmenter gpu;
+  gpu.segment(cloud, clusters);
+  ASSERT_EQ(expected.size(), clusters.size());
+  for (size_t i = 0; i < clusters.size(); i++) {
+    std::sort(expected[i].indices.begin(), expected[i].indices.end());
+    EXPECT_EQ(expected[i].indices, clusters[i].indices);
+  }
+}
+#endif
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "object_analytics_node/segmenter/segmenter_node.hpp"
+
+using object_analytics_node::segmenter::SegmenterNode;
+
+static std::shared_ptr<SegmenterNode> createNode()
+{
+  rclcpp::NodeOptions options;
+  options.parameter_overrides({rclcpp::Parameter("warmup", false),
+    rclcpp::Parameter("publish_stats", false),
+    rclcpp::Parameter("algorithm.OBJECT_MINIMUM_POINTS", 60)});
+  return std::make_shared<SegmenterNode>(options);
+}
+
+TEST(UnitTestSegmenterNode, reconfigure_Applied)
+{
+  std::shared_ptr<SegmenterNode> node = createNode();
+  EXPECT_EQ(60, node->get_parameter("algorithm.OBJECT_MINIMUM_POINTS").as_int());
+
+  auto results = node->set_parameters({
+    rclcpp::Parameter("algorithm.OBJECT_MINIMUM_POINTS", 120),
+    rclcpp::Parameter("algorithm.OBJECT_DISTANCE_THRESHOLD", 0.05),
+    rclcpp::Parameter("algorithm.COMPARATOR", "EuclideanPlaneCoefficientComparator")});
+  ASSERT_EQ(static_cast<size_t>(3), results.size());
+  for (auto & result : results) {
+    EXPECT_TRUE(result.successful);
+  }
+  EXPECT_EQ(120, node->get_parameter("algorithm.OBJECT_MINIMUM_POINTS").as_int());
+  EXPECT_DOUBLE_EQ(0.05, node->get_parameter("algorithm.OBJECT_DISTANCE_THRESHOLD").as_double());
+
+  /* parameters of the node itself are not checked as algorithm items*/
+  EXPECT_TRUE(node->set_parameter(rclcpp::Parameter("sampling_step", 4)).successful);
+}
+
+TEST(UnitTestSegmenterNode, reconfigure_Rejected)
+{
+  std::shared_ptr<SegmenterNode> node = createNode();
+
+  /* negative, wrong types, a count given as a string*/
+  EXPECT_FALSE(node->set_parameter(
+      rclcpp::Parameter("algorithm.OBJECT_MINIMUM_POINTS", -1)).successful);
+  EXPECT_FALSE(node->set_parameter(
+      rclcpp::Parameter("algorithm.OBJECT_DISTANCE_THRESHOLD", -0.1)).successful);
+  EXPECT_FALSE(node->set_parameter(
+      rclcpp::Parameter("algorithm.OBJECT_MINIMUM_POINTS", "many")).successful);
+  EXPECT_FALSE(node->set_parameter(
+      rclcpp::Parameter("algorithm.COMPARATOR", 2)).successful);
+  EXPECT_FALSE(node->set_parameter(
+      rclcpp::Parameter("algorithm.VOXEL_LEAF_SIZE", true)).successful);
+  EXPECT_EQ(60, node->get_parameter("algorithm.OBJECT_MINIMUM_POINTS").as_int());
+
+  /* one bad item rejects the whole change*/
+  rcl_interfaces::msg::SetParametersResult result = node->set_parameters_atomically({
+    rclcpp::Parameter("algorithm.OBJECT_MINIMUM_POINTS", 90),
+    rclcpp::Parameter("algorithm.PLANE_MINIMUM_RATIO", -0.5)});
+  EXPECT_FALSE(result.successful);
+  EXPECT_FALSE(result.reason.empty());
+  EXPECT_EQ(60, node->get_parameter("algorithm.OBJECT_MINIMUM_POINTS").as_int());
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
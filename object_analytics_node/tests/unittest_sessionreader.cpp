@@ -0,0 +1,103 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "object_analytics_node/util/session_reader.hpp"
+
+using object_analytics_node::util::SessionReader;
+
+static std::string writeSession(const std::string & text)
+{
+  std::string file = "/tmp/unittest_sessionreader_" + std::to_string(getpid()) + ".csv";
+  std::ofstream out(file);
+  out << text;
+  return file;
+}
+
+TEST(UnitTestSessionReader, next_FramesOfConsecutiveStamps)
+{
+  std::string file = writeSession(
+    "# stamp_ns,image,pcd,name,probability,x,y,width,height\n"
+    "100,a.jpg,a.pcd,person,0.9,1,2,30,40\n"
+    "100,a.jpg,a.pcd,car,0.5,5,6,70,80\n"
+    "\n"
+    "200,/data/b.jpg,\n"
+    "300,c.jpg,c.pcd,dog,0.7,0,0,10,10\n");
+  SessionReader reader(file);
+  SessionReader::Frame frame;
+  ASSERT_TRUE(reader.next(frame));
+  EXPECT_EQ(frame.stamp, 100);
+  EXPECT_EQ(frame.image, "/tmp/a.jpg");
+  EXPECT_EQ(frame.pcd, "/tmp/a.pcd");
+  ASSERT_EQ(frame.objs->objects_vector.size(), 2u);
+  EXPECT_EQ(frame.objs->objects_vector[1].object.object_name, "car");
+  EXPECT_FLOAT_EQ(frame.objs->objects_vector[1].object.probability, 0.5f);
+  EXPECT_EQ(frame.objs->objects_vector[1].roi.x_offset, 5u);
+  EXPECT_EQ(frame.objs->objects_vector[1].roi.height, 80u);
+
+  ASSERT_TRUE(reader.next(frame));
+  EXPECT_EQ(frame.stamp, 200);
+  EXPECT_EQ(frame.image, "/data/b.jpg");
+  EXPECT_TRUE(frame.pcd.empty());
+  EXPECT_TRUE(frame.objs->objects_vector.empty());
+
+  ASSERT_TRUE(reader.next(frame));
+  EXPECT_EQ(frame.stamp, 300);
+  EXPECT_EQ(frame.objs->objects_vector.size(), 1u);
+  EXPECT_FALSE(reader.next(frame));
+  std::remove(file.c_str());
+}
+
+TEST(UnitTestSessionReader, next_ThrowsAtMalformedLines)
+{
+  const char * lines[] = {
+    "100,a.jpg\n",
+    "abc,a.jpg,a.pcd\n",
+    "100,a.jpg,a.pcd,person,high,1,2,30,40\n",
+    "100,a.jpg,a.pcd,person,0.9,-1,2,30,40\n",
+    "100,a.jpg,a.pcd,person,0.9,1,2,30x,40\n",
+    "100,,a.pcd\n",
+  };
+  for (auto line : lines) {
+    std::string file = writeSession(std::string("50,z.jpg,\n") + line);
+    SessionReader reader(file);
+    SessionReader::Frame frame;
+    /* the frames before the malformed line are read*/
+    EXPECT_TRUE(reader.next(frame)) << line;
+    try {
+      reader.next(frame);
+      ADD_FAILURE() << "no error at " << line;
+    } catch (const std::runtime_error & e) {
+      EXPECT_EQ(std::string(e.what()).find("line 2:"), 0u) << e.what();
+    }
+    std::remove(file.c_str());
+  }
+}
+
+TEST(UnitTestSessionReader, SessionReader_ThrowsWithoutFile)
+{
+  EXPECT_THROW(SessionReader reader("/nonexistent/session.csv"), std::runtime_error);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
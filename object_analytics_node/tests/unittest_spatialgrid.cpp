@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "object_analytics_node/tracker/spatial_grid.hpp"
+
+using object_analytics_node::tracker::SpatialGrid;
+
+TEST(UnitTestSpatialGrid, query_Nearby)
+{
+  std::vector<cv::Rect2d> rects;
+  rects.push_back(cv::Rect2d(0, 0, 50, 50));
+  rects.push_back(cv::Rect2d(400, 300, 50, 50));
+  rects.push_back(cv::Rect2d(30, 30, 50, 50));
+  SpatialGrid grid(50);
+  grid.build(rects);
+
+  std::vector<size_t> indices;
+  grid.query(cv::Rect2d(10, 10, 20, 20), indices);
+  ASSERT_EQ(indices.size(), static_cast<size_t>(2));
+  EXPECT_EQ(indices[0], static_cast<size_t>(0));
+  EXPECT_EQ(indices[1], static_cast<size_t>(2));
+
+  grid.query(cv::Rect2d(420, 320, 10, 10), indices);
+  ASSERT_EQ(indices.size(), static_cast<size_t>(1));
+  EXPECT_EQ(indices[0], static_cast<size_t>(1));
+
+  grid.query(cv::Rect2d(200, 200, 10, 10), indices);
+  EXPECT_TRUE(indices.empty());
+}
+
+TEST(UnitTestSpatialGrid, build_Rebuild)
+{
+  SpatialGrid grid;
+  std::vector<cv::Rect2d> rects;
+  rects.push_back(cv::Rect2d(0, 0, 100, 100));
+  grid.build(rects);
+  EXPECT_DOUBLE_EQ(grid.getCellSize(), 100);
+
+  rects.clear();
+  grid.build(rects);
+  std::vector<size_t> indices;
+  grid.query(cv::Rect2d(0, 0, 100, 100), indices);
+  EXPECT_TRUE(indices.empty());
+}
+
+TEST(UnitTestSpatialGrid, build_BoundedWhileMoving)
+{
+  /* rois sweeping across the image, and far beyond, frame after frame*/
+  SpatialGrid grid(50);
+  std::vector<cv::Rect2d> rects(2);
+  std::vector<size_t> indices;
+  for (int frame = 0; frame < 1000; frame++) {
+    rects[0] = cv::Rect2d(frame * 37, frame * 11, 40, 40);
+    rects[1] = cv::Rect2d(-frame * 53, frame * 29, 40, 40);
+    grid.build(rects);
+    /* 40 x 40 covers at most 2 x 2 cells of 50*/
+    EXPECT_LE(grid.getEntryCount(), static_cast<size_t>(8));
+    grid.query(rects[0], indices);
+    ASSERT_FALSE(indices.empty());
+    EXPECT_EQ(indices[0], static_cast<size_t>(0));
+  }
+
+  /* nothing left of the former frames*/
+  rects.clear();
+  grid.build(rects);
+  EXPECT_EQ(grid.getEntryCount(), static_cast<size_t>(0));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 #include <pcl_conversions/pcl_conversions.h>
 
+#include <cstring>
 #include <string>
 #include <cassert>
 #include <memory>
@@ -75,6 +76,45 @@ TEST(UNITTESTSplitter, split_EmptyInput)
   EXPECT_EQ(imageMsg->data.size(), static_cast<size_t>(0));
 }
 
+TEST(UnitTestSplitter, split_FusedSameAsTwoPass)
+{
+  PointCloudT::Ptr pclCloudOriginal(new PointCloudT);
+  readPointCloudFromPCD(std::string(RESOURCE_DIR) + "/split.pcd", pclCloudOriginal);
+  pcl::PointCloud<pcl::PointXYZRGB>::Ptr pclCloud(new pcl::PointCloud<pcl::PointXYZRGB>);
+  copyPointCloud(*pclCloudOriginal, *pclCloud);
+  for (size_t i = 0; i < pclCloud->size(); i++) {
+    pclCloud->points[i].r = i;
+    pclCloud->points[i].g = 2 * i;
+    pclCloud->points[i].b = 3 * i;
+  }
+
+  sensor_msgs::msg::PointCloud2 cloudMsg;
+  pcl::toROSMsg(*pclCloud, cloudMsg);
+
+  sensor_msgs::msg::Image image, imageFused;
+  sensor_msgs::msg::PointCloud2 pointsXYZ, pointsXYZFused;
+  Splitter::split(cloudMsg, image);
+  Splitter::splitPointsToXYZ(cloudMsg, pointsXYZ);
+  Splitter::split(cloudMsg, imageFused, pointsXYZFused);
+
+  EXPECT_EQ(image.header, imageFused.header);
+  EXPECT_EQ(image.width, imageFused.width);
+  EXPECT_EQ(image.height, imageFused.height);
+  EXPECT_EQ(image.encoding, imageFused.encoding);
+  EXPECT_EQ(image.step, imageFused.step);
+  EXPECT_EQ(image.data, imageFused.data);
+
+  EXPECT_EQ(pointsXYZ.fields, pointsXYZFused.fields);
+  EXPECT_EQ(pointsXYZ.point_step, pointsXYZFused.point_step);
+  EXPECT_EQ(pointsXYZ.row_step, pointsXYZFused.row_step);
+  ASSERT_EQ(pointsXYZ.data.size(), pointsXYZFused.data.size());
+  for (size_t i = 0; i < pclCloud->size(); i++) {
+    size_t offset = i * pointsXYZ.point_step;
+    EXPECT_EQ(0, std::memcmp(&pointsXYZ.data[offset], &pointsXYZFused.data[offset],
+      3 * sizeof(float)));
+  }
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
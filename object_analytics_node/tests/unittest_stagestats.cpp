@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/stage_stats.hpp"
+
+using object_analytics_node::util::ScopedStageTimer;
+using object_analytics_node::util::StageRegistry;
+using object_analytics_node::util::StageStats;
+using StageStatsMsg = object_analytics_msgs::msg::StageStats;
+
+TEST(UnitTestStageStats, collect_CountsMeanMaxHistogram)
+{
+  StageStats stats("test.stage");
+  stats.record(30000);
+  stats.record(150000);
+  stats.record(3000000);
+  stats.record(500000000);
+
+  StageStatsMsg msg;
+  stats.collect(msg);
+  EXPECT_EQ(msg.name, "test.stage");
+  EXPECT_EQ(msg.count, 4u);
+  EXPECT_DOUBLE_EQ(msg.max_ms, 500.0);
+  EXPECT_DOUBLE_EQ(msg.mean_ms, (0.03 + 0.15 + 3.0 + 500.0) / 4);
+  ASSERT_EQ(msg.histogram.size(), StageStats::kBuckets);
+  ASSERT_EQ(msg.bucket_bounds_ms.size(), StageStats::kBuckets - 1);
+  EXPECT_EQ(msg.histogram[0], 1u);
+  EXPECT_EQ(msg.histogram[2], 1u);
+  EXPECT_EQ(msg.histogram[6], 1u);
+  EXPECT_EQ(msg.histogram[StageStats::kBuckets - 1], 1u);
+}
+
+TEST(UnitTestStageStats, collect_ResetsPeriod)
+{
+  StageStats stats("test.stage");
+  stats.record(1000);
+  StageStatsMsg msg;
+  stats.collect(msg);
+  stats.collect(msg);
+  EXPECT_EQ(msg.count, 0u);
+  EXPECT_DOUBLE_EQ(msg.mean_ms, 0.0);
+  EXPECT_DOUBLE_EQ(msg.max_ms, 0.0);
+  for (auto count : msg.histogram) {
+    EXPECT_EQ(count, 0u);
+  }
+}
+
+TEST(UnitTestStageStats, ScopedStageTimer_RecordsOnce)
+{
+  StageStats stats("test.stage");
+  {
+    ScopedStageTimer timer(stats);
+  }
+  StageStatsMsg msg;
+  stats.collect(msg);
+  EXPECT_EQ(msg.count, 1u);
+  EXPECT_GE(msg.max_ms, 0.0);
+}
+
+TEST(UnitTestStageStats, StageRegistry_CollectsByPrefix)
+{
+  StageStats & a = StageRegistry::get("alpha.a");
+  StageStats & b = StageRegistry::get("alpha.b");
+  StageRegistry::get("beta.a").record(1000);
+  EXPECT_EQ(&a, &StageRegistry::get("alpha.a"));
+  a.record(1000);
+  b.record(1000);
+
+  std::vector<StageStatsMsg> stages;
+  StageRegistry::collect("alpha.", stages);
+  ASSERT_EQ(stages.size(), 2u);
+  EXPECT_EQ(stages[0].name, "alpha.a");
+  EXPECT_EQ(stages[1].name, "alpha.b");
+  EXPECT_EQ(stages[0].count, 1u);
+
+  stages.clear();
+  StageRegistry::collect("beta.", stages);
+  ASSERT_EQ(stages.size(), 1u);
+  EXPECT_EQ(stages[0].count, 1u);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "object_analytics_node/util/stamp_matcher.hpp"
+
+using object_analytics_node::util::StampMatcher;
+
+class UnitTestStampMatcher : public testing::Test
+{
+protected:
+  UnitTestStampMatcher()
+  : matcher_([this](const int & first, const std::string & second) {
+        pairs_.push_back(std::make_pair(first, second));
+      }, 100) {}
+
+  StampMatcher<int, std::string> matcher_;
+  std::vector<std::pair<int, std::string>> pairs_;
+};
+
+TEST_F(UnitTestStampMatcher, addFirst_MatchesExactStamp)
+{
+  matcher_.addSecond(10, "a", 10);
+  matcher_.addSecond(20, "b", 10);
+  matcher_.addSecond(30, "c", 10);
+  matcher_.addFirst(20, 2);
+  ASSERT_EQ(pairs_.size(), static_cast<size_t>(1));
+  EXPECT_EQ(pairs_[0], std::make_pair(2, std::string("b")));
+  /* older messages are dropped once matched*/
+  EXPECT_EQ(matcher_.getBuffered(), static_cast<size_t>(2));
+  EXPECT_EQ(matcher_.getBytes(), static_cast<size_t>(20));
+  EXPECT_EQ(matcher_.getDropped(), static_cast<uint64_t>(0));
+}
+
+TEST_F(UnitTestStampMatcher, addSecond_MatchesWaitingFirst)
+{
+  matcher_.addFirst(10, 1);
+  EXPECT_TRUE(pairs_.empty());
+  matcher_.addSecond(10, "a", 10);
+  ASSERT_EQ(pairs_.size(), static_cast<size_t>(1));
+  EXPECT_EQ(pairs_[0], std::make_pair(1, std::string("a")));
+}
+
+TEST_F(UnitTestStampMatcher, addFirst_DropsMissingStamp)
+{
+  matcher_.addSecond(10, "a", 10);
+  matcher_.addSecond(30, "c", 10);
+  matcher_.addFirst(20, 2);
+  EXPECT_TRUE(pairs_.empty());
+  EXPECT_EQ(matcher_.getDropped(), static_cast<uint64_t>(1));
+
+  /* waiting ones are dropped when a later second arrives*/
+  matcher_.addFirst(40, 4);
+  matcher_.addSecond(50, "e", 10);
+  EXPECT_TRUE(pairs_.empty());
+  EXPECT_EQ(matcher_.getDropped(), static_cast<uint64_t>(2));
+}
+
+TEST_F(UnitTestStampMatcher, setTolerance_MatchesNearest)
+{
+  matcher_.setTolerance(5);
+  matcher_.addSecond(10, "a", 10);
+  matcher_.addSecond(22, "b", 10);
+  matcher_.addFirst(18, 1);
+  ASSERT_EQ(pairs_.size(), static_cast<size_t>(1));
+  EXPECT_EQ(pairs_[0], std::make_pair(1, std::string("b")));
+
+  matcher_.addFirst(40, 4);
+  matcher_.addSecond(43, "c", 10);
+  ASSERT_EQ(pairs_.size(), static_cast<size_t>(2));
+  EXPECT_EQ(pairs_[1], std::make_pair(4, std::string("c")));
+
+  matcher_.addSecond(60, "d", 10);
+  matcher_.addFirst(50, 5);
+  EXPECT_EQ(pairs_.size(), static_cast<size_t>(2));
+  EXPECT_EQ(matcher_.getDropped(), static_cast<uint64_t>(1));
+}
+
+TEST_F(UnitTestStampMatcher, addSecond_EvictsByBytes)
+{
+  for (int i = 1; i <= 5; i++) {
+    matcher_.addSecond(i * 10, std::to_string(i), 30);
+  }
+  EXPECT_EQ(matcher_.getBuffered(), static_cast<size_t>(3));
+  EXPECT_EQ(matcher_.getBytes(), static_cast<size_t>(90));
+  EXPECT_EQ(matcher_.getEvicted(), static_cast<uint64_t>(2));
+
+  /* a message over the budget is kept alone*/
+  matcher_.addSecond(60, "6", 500);
+  EXPECT_EQ(matcher_.getBuffered(), static_cast<size_t>(1));
+  matcher_.addFirst(60, 6);
+  ASSERT_EQ(pairs_.size(), static_cast<size_t>(1));
+  EXPECT_EQ(pairs_[0], std::make_pair(6, std::string("6")));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include "stream_device.hpp"
+
+/* a stream of a fixed number of frames, fetches fail after the last one*/
+class FakeStream : public stream_device
+{
+public:
+  FakeStream(size_t frames, bool live, size_t good_resets)
+  : frames_(frames), live_(live), good_resets_(good_resets)
+  {
+    initialized_ = true;
+  }
+
+  /* the fetch thread calls into this class, stopped before it is gone*/
+  ~FakeStream()
+  {
+    stream_device::release_stream();
+  }
+
+  bool init_stream(int) {return true;}
+  bool init_stream(std::string &) {return true;}
+
+  /* a good reset brings one more frame*/
+  bool reset_stream()
+  {
+    resets_++;
+    if (good_resets_ == 0) {
+      return false;
+    }
+    good_resets_--;
+    frames_++;
+    return true;
+  }
+
+  bool fetch_frame(std::shared_ptr<sFrame> & frame)
+  {
+    if (fetched_ >= frames_) {
+      return false;
+    }
+    frame = std::make_shared<sFrame>();
+    frame->stamp = static_cast<std::time_t>(fetched_++);
+    return true;
+  }
+
+  bool is_live() const {return live_;}
+
+  std::atomic<size_t> resets_{0};
+
+private:
+  std::atomic<size_t> frames_;
+  std::atomic<size_t> fetched_{0};
+  bool live_;
+  size_t good_resets_;
+};
+
+/* frames read until the stream reports its end*/
+static size_t readAll(stream_device & stream)
+{
+  size_t frames = 0;
+  std::shared_ptr<sFrame> frame;
+  while (stream.read(frame)) {
+    EXPECT_EQ(static_cast<std::time_t>(frames), frame->stamp);
+    frames++;
+  }
+  return frames;
+}
+
+TEST(UnitTestStreamDevice, recover_FileEndsAtEof)
+{
+  FakeStream stream(3, false, 1);
+  ASSERT_TRUE(stream.process());
+  EXPECT_EQ(static_cast<size_t>(3), readAll(stream));
+  /* never rewound to loop the file*/
+  EXPECT_EQ(static_cast<size_t>(0), stream.resets_.load());
+  stream_device::stream_health health = stream.get_health();
+  EXPECT_EQ(static_cast<uint64_t>(0), health.reconnects);
+  EXPECT_EQ(static_cast<uint64_t>(0), health.reconnect_failures);
+}
+
+TEST(UnitTestStreamDevice, recover_LiveReconnects)
+{
+  FakeStream stream(1, true, 1);
+  stream.set_reconnect(1, 2, 2);
+  ASSERT_TRUE(stream.process());
+  EXPECT_EQ(static_cast<size_t>(2), readAll(stream));
+  stream_device::stream_health health = stream.get_health();
+  EXPECT_EQ(static_cast<uint64_t>(1), health.reconnects);
+  /* the second outage is retried twice, then given up*/
+  EXPECT_EQ(static_cast<uint64_t>(2), health.reconnect_failures);
+  EXPECT_EQ(static_cast<uint64_t>(4), health.failures);
+}
+
+TEST(UnitTestStreamDevice, setQueue_DropOldest)
+{
+  FakeStream stream(20, false, 0);
+  stream.set_queue(2, stream_device::drop_oldest);
+  ASSERT_TRUE(stream.process());
+  /* the fetch thread runs ahead of a reader that is not there yet*/
+  while (stream.get_dropped() < 10) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_LE(stream.get_queued(), static_cast<size_t>(2));
+
+  /* the newest frames are kept, the last slot tells the end*/
+  std::shared_ptr<sFrame> frame;
+  ASSERT_TRUE(stream.read(frame));
+  EXPECT_GE(frame->stamp, static_cast<std::time_t>(10));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
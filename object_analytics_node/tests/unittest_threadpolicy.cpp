@@ -0,0 +1,77 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "object_analytics_node/util/thread_policy.hpp"
+#include "object_analytics_node/util/thread_pool.hpp"
+
+using object_analytics_node::util::ThreadPolicy;
+using object_analytics_node::util::ThreadPool;
+
+/* first core the test may run on*/
+static int allowedCore()
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+  for (int core = 0; core < CPU_SETSIZE; core++) {
+    if (CPU_ISSET(core, &set)) {
+      return core;
+    }
+  }
+  return 0;
+}
+
+TEST(UnitTestThreadPolicy, parseCores_List)
+{
+  EXPECT_EQ(ThreadPolicy::parseCores("0,2,,3"), std::vector<int>({0, 2, 3}));
+  EXPECT_TRUE(ThreadPolicy::parseCores("").empty());
+  EXPECT_THROW(ThreadPolicy::parseCores("a"), std::invalid_argument);
+  EXPECT_THROW(ThreadPolicy::parseCores("1x"), std::invalid_argument);
+  EXPECT_THROW(ThreadPolicy::parseCores("99999999999"), std::invalid_argument);
+}
+
+TEST(UnitTestThreadPolicy, apply_EmptyChangesNothing)
+{
+  std::string before = ThreadPolicy::describe(pthread_self());
+  std::string error;
+  ThreadPolicy policy;
+  EXPECT_TRUE(policy.empty());
+  EXPECT_TRUE(policy.apply(pthread_self(), error));
+  EXPECT_TRUE(error.empty());
+  EXPECT_EQ(ThreadPolicy::describe(pthread_self()), before);
+}
+
+TEST(UnitTestThreadPolicy, setPolicy_PinsWorkers)
+{
+  int core = allowedCore();
+  ThreadPolicy policy;
+  policy.cores.push_back(core);
+  ThreadPool pool(2);
+  std::string error;
+  EXPECT_TRUE(pool.setPolicy(policy, error)) << error;
+  EXPECT_EQ(pool.getPolicy(), "cores " + std::to_string(core) + " SCHED_OTHER");
+
+  /* pinned workers still run the tasks*/
+  std::vector<int> hits(20, 0);
+  pool.parallelFor(hits.size(), [&hits](size_t i) {hits[i]++;});
+  for (auto hit : hits) {
+    EXPECT_EQ(hit, 1);
+  }
+  EXPECT_EQ(ThreadPool(0).getPolicy(), "no workers");
+}
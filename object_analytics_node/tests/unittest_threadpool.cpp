@@ -0,0 +1,73 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "object_analytics_node/util/thread_pool.hpp"
+
+using object_analytics_node::util::ThreadPool;
+
+TEST(UnitTestThreadPool, parallelFor_AllTasksRunOnce)
+{
+  ThreadPool pool(3);
+  std::vector<int> hits(100, 0);
+  pool.parallelFor(hits.size(), [&hits](size_t i) {hits[i]++;});
+  for (size_t i = 0; i < hits.size(); i++) {
+    EXPECT_EQ(hits[i], 1);
+  }
+}
+
+TEST(UnitTestThreadPool, parallelFor_ReusedAcrossCalls)
+{
+  ThreadPool pool(4);
+  std::atomic<int> sum(0);
+  for (int round = 0; round < 50; round++) {
+    pool.parallelFor(10, [&sum](size_t i) {sum += static_cast<int>(i);});
+  }
+  EXPECT_EQ(sum.load(), 50 * 45);
+}
+
+TEST(UnitTestThreadPool, parallelFor_NoWorkers)
+{
+  ThreadPool pool(0);
+  EXPECT_EQ(pool.getNumOfThread(), static_cast<size_t>(0));
+  std::vector<size_t> order;
+  pool.parallelFor(5, [&order](size_t i) {order.push_back(i);});
+  ASSERT_EQ(order.size(), static_cast<size_t>(5));
+  for (size_t i = 0; i < order.size(); i++) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(UnitTestThreadPool, parallelFor_RethrowException)
+{
+  ThreadPool pool(2);
+  std::atomic<int> done(0);
+  EXPECT_THROW(
+    pool.parallelFor(8, [&done](size_t i) {
+      if (i == 3) {
+        throw std::runtime_error("task failed");
+      }
+      done++;
+    }), std::runtime_error);
+  EXPECT_EQ(done.load(), 7);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "object_analytics_node/tracker/tracker_pool.hpp"
+
+using object_analytics_node::tracker::TrackerPool;
+
+TEST(UnitTestTrackerPool, create_OwnTrackersEmpty)
+{
+  EXPECT_FALSE(TrackerPool::create("KCF").empty());
+  EXPECT_TRUE(TrackerPool::create("KALMAN").empty());
+  EXPECT_TRUE(TrackerPool::create("PARTICLE").empty());
+  EXPECT_TRUE(TrackerPool::create("GOTURN_BATCH").empty());
+}
+
+TEST(UnitTestTrackerPool, prewarm_FillsStock)
+{
+  TrackerPool pool(3);
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(0));
+  pool.prewarm("KCF");
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(3));
+
+  /* already full, nothing added*/
+  pool.prewarm("KCF");
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(3));
+
+  /* own trackers are never stocked*/
+  pool.prewarm("KALMAN");
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(3));
+  EXPECT_EQ(pool.getAcquired(), static_cast<uint64_t>(0));
+}
+
+TEST(UnitTestTrackerPool, acquire_HitAndMiss)
+{
+  TrackerPool pool(2);
+  EXPECT_EQ(pool.getHitRate(), 0);
+  pool.prewarm("KCF");
+
+  cv::Ptr<cv::Tracker> first = pool.acquire("KCF");
+  cv::Ptr<cv::Tracker> second = pool.acquire("KCF");
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(0));
+
+  /* stock empty, created on the spot*/
+  cv::Ptr<cv::Tracker> third = pool.acquire("KCF");
+  EXPECT_FALSE(first.empty());
+  EXPECT_FALSE(second.empty());
+  EXPECT_FALSE(third.empty());
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_NE(second.get(), third.get());
+  EXPECT_EQ(pool.getAcquired(), static_cast<uint64_t>(3));
+  EXPECT_DOUBLE_EQ(pool.getHitRate(), 2.0 / 3);
+
+  /* own trackers are counted but never served*/
+  EXPECT_TRUE(pool.acquire("KALMAN").empty());
+  EXPECT_EQ(pool.getAcquired(), static_cast<uint64_t>(4));
+  EXPECT_DOUBLE_EQ(pool.getHitRate(), 2.0 / 4);
+}
+
+TEST(UnitTestTrackerPool, release_RetiredNotReused)
+{
+  TrackerPool pool(1);
+  pool.prewarm("KCF");
+  cv::Ptr<cv::Tracker> used = pool.acquire("KCF");
+  pool.release("KCF", used);
+  pool.release("KCF", cv::Ptr<cv::Tracker>());
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(0));
+
+  /* a released tracker is not handed out again*/
+  cv::Ptr<cv::Tracker> next = pool.acquire("KCF");
+  EXPECT_FALSE(next.empty());
+  EXPECT_NE(used.get(), next.get());
+  EXPECT_DOUBLE_EQ(pool.getHitRate(), 0.5);
+}
+
+TEST(UnitTestTrackerPool, release_RetiredCapped)
+{
+  /* never replenished, as by a caller of the manager alone*/
+  TrackerPool pool(2);
+  for (size_t i = 0; i < 3 * TrackerPool::kMinRetired; i++) {
+    pool.release("KCF", TrackerPool::create("KCF"));
+  }
+  EXPECT_EQ(pool.getRetired(), TrackerPool::kMinRetired);
+
+  /* a larger stock retires as many*/
+  pool.setStock(2 * TrackerPool::kMinRetired);
+  for (size_t i = 0; i < 3 * TrackerPool::kMinRetired; i++) {
+    pool.release("KCF", TrackerPool::create("KCF"));
+  }
+  EXPECT_EQ(pool.getRetired(), 2 * TrackerPool::kMinRetired);
+  pool.replenish();
+  EXPECT_EQ(pool.getRetired(), static_cast<size_t>(0));
+}
+
+TEST(UnitTestTrackerPool, replenish_RefillsUsedAlgos)
+{
+  TrackerPool pool(2);
+  pool.prewarm("KCF");
+  pool.release("KCF", pool.acquire("KCF"));
+  pool.release("KCF", pool.acquire("KCF"));
+  pool.release("KCF", pool.acquire("KCF"));
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(0));
+  pool.replenish();
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(2));
+
+  /* the stock follows setStock(), only for algorithms used*/
+  pool.setStock(4);
+  pool.acquire("KALMAN");
+  pool.replenish();
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(4));
+  pool.setStock(1);
+  pool.replenish();
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(4));
+}
+
+TEST(UnitTestTrackerPool, acquire_Concurrent)
+{
+  TrackerPool pool(4);
+  pool.prewarm("KCF");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.push_back(std::thread([&pool]() {
+        for (int k = 0; k < 25; k++) {
+          cv::Ptr<cv::Tracker> t = pool.acquire("KCF");
+          EXPECT_FALSE(t.empty());
+          pool.release("KCF", t);
+        }
+      }));
+  }
+  /* refilled meanwhile, as between frames*/
+  for (int k = 0; k < 10; k++) {
+    pool.replenish();
+  }
+  for (auto & t : threads) {
+    t.join();
+  }
+  pool.replenish();
+  EXPECT_EQ(pool.getAcquired(), static_cast<uint64_t>(100));
+  EXPECT_EQ(pool.getIdle(), static_cast<size_t>(4));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,6 +14,7 @@
 
 #define PCL_NO_PRECOMPILE
 #include <gtest/gtest.h>
+#include <opencv2/imgproc.hpp>
 #include <string>
 #include <cassert>
 #include "object_analytics_node/tracker/tracking.hpp"
@@ -22,7 +23,7 @@ TEST(UnitTestTracking, TrackingNomal)
 {
   object_analytics_node::tracker::Tracking t(2, "cat", 0.7, cv::Rect2d(100, 100, 200, 300));
   EXPECT_EQ(t.getObjName(), std::string("cat"));
-  EXPECT_EQ(t.getTrackingId(), int32_t(2));
+  EXPECT_EQ(t.getTrackingId(), int64_t(2));
   EXPECT_NEAR(t.getObjProbability(), 0.7, 0.000001);
   EXPECT_EQ(t.getTrackedRect().x, 100);
   EXPECT_EQ(t.getTrackedRect().y, 100);
@@ -38,7 +39,7 @@ TEST(UnitTestTracking, TrackingNullName)
 {
   object_analytics_node::tracker::Tracking t(2, "", 0.7, cv::Rect2d(100, 100, 200, 300));
   EXPECT_EQ(t.getObjName(), std::string(""));
-  EXPECT_EQ(t.getTrackingId(), int32_t(2));
+  EXPECT_EQ(t.getTrackingId(), int64_t(2));
   EXPECT_NEAR(t.getObjProbability(), 0.7, 0.000001);
   EXPECT_EQ(t.getTrackedRect().x, 100);
   EXPECT_EQ(t.getTrackedRect().y, 100);
@@ -50,6 +51,257 @@ TEST(UnitTestTracking, TrackingNullName)
   t.clearDetected();
   EXPECT_EQ(t.isDetected(), false);
 }
+TEST(UnitTestTracking, TrackingLifecycle)
+{
+  using object_analytics_node::tracker::Tracking;
+  Tracking::Lifecycle lifecycle;
+  lifecycle.confirm_hits = 2;
+  lifecycle.max_age = 2;
+  lifecycle.max_misses = 2;
+
+  /* tentative until detected twice, deleted on a miss*/
+  Tracking tentative(4, "cat", 0.9, cv::Rect2d(0, 0, 10, 10));
+  tentative.setLifecycle(lifecycle);
+  tentative.clearDetected();
+  tentative.setDetected();
+  tentative.updateState();
+  EXPECT_EQ(tentative.getState(), Tracking::kTentative);
+  tentative.clearDetected();
+  tentative.updateState();
+  EXPECT_EQ(tentative.getState(), Tracking::kDeleted);
+  EXPECT_FALSE(tentative.isActive());
+
+  Tracking t(5, "cat", 0.9, cv::Rect2d(0, 0, 10, 10));
+  t.setLifecycle(lifecycle);
+  t.setDetected();
+  t.setDetected();
+  EXPECT_EQ(t.getState(), Tracking::kConfirmed);
+
+  /* lost once aged out, confirmed again when detected*/
+  builtin_interfaces::msg::Time stamp;
+  t.extrapolate(stamp);
+  EXPECT_EQ(t.getState(), Tracking::kConfirmed);
+  t.extrapolate(stamp);
+  EXPECT_EQ(t.getState(), Tracking::kLost);
+  t.clearDetected();
+  t.setDetected();
+  EXPECT_EQ(t.getState(), Tracking::kConfirmed);
+
+  /* a failed update is lost at once, deleted after the misses*/
+  cv::Mat mat(20, 20, CV_8UC3, cv::Scalar(0, 0, 0));
+  EXPECT_FALSE(t.updateTracker(mat, stamp));
+  EXPECT_EQ(t.getState(), Tracking::kLost);
+  t.clearDetected();
+  t.updateState();
+  EXPECT_EQ(t.getState(), Tracking::kLost);
+  t.clearDetected();
+  t.updateState();
+  EXPECT_EQ(t.getState(), Tracking::kDeleted);
+}
+TEST(UnitTestTracking, TrackingHistory)
+{
+  object_analytics_node::tracker::Tracking t(3, "dog", 0.9, cv::Rect2d(0, 0, 10, 10));
+  t.setHistoryCapacity(2);
+  EXPECT_EQ(t.getHistoryCapacity(), static_cast<size_t>(2));
+  builtin_interfaces::msg::Time stamp;
+  stamp.sec = 1;
+  EXPECT_FALSE(t.checkTimeZone(stamp));
+  for (int i = 0; i < 3; i++) {
+    stamp.nanosec = i;
+    t.collectHistory(stamp, cv::Rect2d(i, i, 10, 10));
+  }
+  cv::Rect2d r;
+  stamp.nanosec = 0;
+  EXPECT_FALSE(t.getHisTrackedRect(stamp, r));
+  EXPECT_FALSE(t.checkTimeZone(stamp));
+  stamp.nanosec = 2;
+  EXPECT_TRUE(t.getHisTrackedRect(stamp, r));
+  EXPECT_EQ(r.x, 2);
+  EXPECT_TRUE(t.checkTimeZone(stamp));
+  t.clearHistory();
+  EXPECT_FALSE(t.checkTimeZone(stamp));
+}
+TEST(UnitTestTracking, TrackingKalman)
+{
+  object_analytics_node::tracker::Tracking t(4, "person", 0.9, cv::Rect2d(0, 0, 10, 10));
+  EXPECT_TRUE(t.setAlgo("KALMAN"));
+  cv::Mat mat(100, 100, CV_8UC3);
+  builtin_interfaces::msg::Time stamp;
+  for (int i = 0; i < 5; i++) {
+    stamp.sec = i;
+    cv::Rect2d r(i * 10, 0, 10, 10);
+    EXPECT_EQ(t.rectifyTracker(mat, r, r, stamp), i == 0);
+  }
+  stamp.sec = 5;
+  EXPECT_TRUE(t.updateTracker(mat, stamp));
+  EXPECT_NEAR(t.getTrackedRect().x, 50, 5);
+  EXPECT_NEAR(t.getTrackedRect().width, 10, 1);
+  EXPECT_NEAR(t.getVelocity().x, 10, 2);
+  EXPECT_NEAR(t.getVelocity().y, 0, 1);
+}
+
+TEST(UnitTestTracking, TrackingParticle)
+{
+  object_analytics_node::tracker::Tracking t(5, "person", 0.9, cv::Rect2d(20, 20, 20, 20));
+  EXPECT_TRUE(t.setAlgo("PARTICLE"));
+  t.setParticles(200);
+  builtin_interfaces::msg::Time stamp;
+  cv::Mat mat(100, 100, CV_8UC3, cv::Scalar(0, 0, 0));
+  cv::rectangle(mat, cv::Rect(20, 20, 20, 20), cv::Scalar(255, 255, 255), cv::FILLED);
+  EXPECT_TRUE(t.rectifyTracker(mat, cv::Rect2d(20, 20, 20, 20), cv::Rect2d(20, 20, 20, 20), stamp));
+  EXPECT_GT(t.getModelBytes(), 200 * 4 * sizeof(double));
+  for (int i = 1; i <= 5; i++) {
+    stamp.sec = i;
+    mat.setTo(cv::Scalar(0, 0, 0));
+    cv::rectangle(mat, cv::Rect(20 + i, 20, 20, 20), cv::Scalar(255, 255, 255), cv::FILLED);
+    EXPECT_TRUE(t.updateTracker(mat, stamp));
+  }
+  cv::Rect2d r = t.getTrackedRect();
+  EXPECT_NEAR(r.x + r.width / 2, 35, 3);
+  EXPECT_NEAR(r.y + r.height / 2, 30, 3);
+
+  /* the object is gone*/
+  stamp.sec = 6;
+  mat.setTo(cv::Scalar(0, 0, 0));
+  EXPECT_FALSE(t.updateTracker(mat, stamp));
+}
+
+TEST(UnitTestTracking, TrackingModelBudget)
+{
+  using object_analytics_node::tracker::Tracking;
+  Tracking budgeted(6, "person", 0.9, cv::Rect2d(30, 30, 30, 30));
+  Tracking unbounded(7, "person", 0.9, cv::Rect2d(30, 30, 30, 30));
+  EXPECT_TRUE(budgeted.setAlgo("MIL"));
+  EXPECT_TRUE(unbounded.setAlgo("MIL"));
+  /* any update is over the budget, the model is checked after 10 updates*/
+  budgeted.setModelBudget(0, 1e-6);
+  builtin_interfaces::msg::Time stamp;
+  cv::Mat mat(120, 120, CV_8UC3, cv::Scalar(0, 0, 0));
+  cv::rectangle(mat, cv::Rect(30, 30, 30, 30), cv::Scalar(255, 255, 255), cv::FILLED);
+  cv::circle(mat, cv::Point(45, 45), 8, cv::Scalar(0, 0, 255), cv::FILLED);
+  cv::Rect2d roi(30, 30, 30, 30);
+  EXPECT_TRUE(budgeted.rectifyTracker(mat, roi, roi, stamp));
+  EXPECT_TRUE(unbounded.rectifyTracker(mat, roi, roi, stamp));
+  for (int i = 1; i <= 12; i++) {
+    stamp.sec = i;
+    EXPECT_TRUE(budgeted.updateTracker(mat, stamp));
+    EXPECT_TRUE(unbounded.updateTracker(mat, stamp));
+  }
+  EXPECT_EQ(budgeted.getCompactions(), 1u);
+  EXPECT_EQ(budgeted.getModelUpdates(), 2u);
+  EXPECT_EQ(budgeted.getActiveAlgo(), std::string("MIL"));
+  EXPECT_EQ(unbounded.getCompactions(), 0u);
+  EXPECT_EQ(unbounded.getModelUpdates(), 12u);
+  EXPECT_GT(unbounded.getMeanUpdateCost(), 0);
+}
+
+TEST(UnitTestTracking, FrameContextEncoding)
+{
+  cv::Mat rgb(10, 10, CV_8UC3, cv::Scalar(255, 0, 0));
+  object_analytics_node::tracker::FrameContext rgb_ctx(rgb, "rgb8");
+  cv::Vec3b bgr = rgb_ctx.getBgr().at<cv::Vec3b>(0, 0);
+  EXPECT_EQ(bgr[0], 0);
+  EXPECT_EQ(bgr[2], 255);
+
+  cv::Mat mono(10, 10, CV_8UC1, cv::Scalar(128));
+  object_analytics_node::tracker::FrameContext mono_ctx(mono, "mono8");
+  EXPECT_EQ(mono_ctx.getGray().data, mono.data);
+  EXPECT_EQ(mono_ctx.getBgr().channels(), 3);
+  EXPECT_TRUE(object_analytics_node::tracker::FrameContext::isSupported("mono8"));
+  EXPECT_FALSE(object_analytics_node::tracker::FrameContext::isSupported("yuv422"));
+}
+
+TEST(UnitTestTracking, FrameContextInputLevels)
+{
+  cv::Mat bgr(101, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+  object_analytics_node::tracker::FrameContext ctx(bgr);
+  EXPECT_EQ(ctx.getInput("KCF", 0).data, bgr.data);
+  const cv::Mat & half = ctx.getInput("KCF", 1);
+  EXPECT_EQ(half.size(), cv::Size(32, 51));
+  EXPECT_EQ(half.channels(), 3);
+  EXPECT_EQ(ctx.getInput("KCF", 1).data, half.data);
+  EXPECT_EQ(ctx.getInput("TLD", 2).size(), cv::Size(16, 26));
+  EXPECT_EQ(ctx.getInput("TLD", 2).channels(), 1);
+  EXPECT_EQ(ctx.getInput("KCF", 9).size(), cv::Size(16, 26));
+}
+
+TEST(UnitTestTracking, FrameContextBytes)
+{
+  cv::Mat bgr(101, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+  object_analytics_node::tracker::FrameContext ctx(bgr);
+  EXPECT_EQ(ctx.getBytes(), 0u);
+  ctx.getInput("KCF", 0);
+  EXPECT_EQ(ctx.getBytes(), 0u);
+  ctx.getInput("KCF", 1);
+  size_t bytes = 32 * 51 * 3;
+  EXPECT_EQ(ctx.getBytes(), bytes);
+  ctx.getInput("TLD", 2);
+  bytes += 101 * 64 + 32 * 51 + 16 * 26;
+  EXPECT_EQ(ctx.getBytes(), bytes);
+  /* built once, counted once*/
+  ctx.getInput("TLD", 2);
+  ctx.getGray();
+  EXPECT_EQ(ctx.getBytes(), bytes);
+}
+
+/* smooth noise, textured for optical flow at each pyramid level*/
+static cv::Mat texture(int shift)
+{
+  cv::Mat noise(400, 400, CV_8UC3);
+  cv::RNG rng(7);
+  rng.fill(noise, cv::RNG::UNIFORM, 0, 255);
+  cv::GaussianBlur(noise, noise, cv::Size(7, 7), 2);
+  cv::Mat shifted(noise.size(), noise.type(), cv::Scalar(0, 0, 0));
+  noise(cv::Rect(0, 0, noise.cols - shift, noise.rows)).copyTo(
+    shifted(cv::Rect(shift, 0, noise.cols - shift, noise.rows)));
+  return shifted;
+}
+
+TEST(UnitTestTracking, TrackingCropping)
+{
+  object_analytics_node::tracker::Tracking t(5, "person", 0.9, cv::Rect2d(100, 100, 40, 40));
+  EXPECT_TRUE(t.setAlgo("MEDIAN_FLOW"));
+  t.setCropping(1.0, 0);
+  builtin_interfaces::msg::Time stamp;
+  cv::Rect2d r(100, 100, 40, 40);
+  EXPECT_TRUE(t.rectifyTracker(texture(0), r, r, stamp));
+  /* the object leaves the first window, trackers follow on new windows*/
+  for (int i = 1; i <= 20; i++) {
+    stamp.sec = i;
+    EXPECT_TRUE(t.updateTracker(texture(4 * i), stamp));
+  }
+  EXPECT_NEAR(t.getTrackedRect().x, 180, 4);
+  EXPECT_NEAR(t.getTrackedRect().y, 100, 4);
+
+  object_analytics_node::tracker::Tracking coarse(6, "person", 0.9, r);
+  EXPECT_TRUE(coarse.setAlgo("MEDIAN_FLOW"));
+  coarse.setCropping(1.0, 20);
+  EXPECT_TRUE(coarse.rectifyTracker(texture(0), r, r, stamp));
+  stamp.sec = 30;
+  EXPECT_TRUE(coarse.updateTracker(texture(4), stamp));
+  EXPECT_NEAR(coarse.getTrackedRect().x, 104, 4);
+  EXPECT_NEAR(coarse.getTrackedRect().width, 40, 4);
+}
+
+TEST(UnitTestTracking, TrackingRectifyThreshold)
+{
+  object_analytics_node::tracker::Tracking t(8, "person", 0.9, cv::Rect2d(100, 100, 40, 40));
+  EXPECT_TRUE(t.setAlgo("MEDIAN_FLOW"));
+  t.setRectifyThreshold(0.7);
+  builtin_interfaces::msg::Time stamp;
+  cv::Rect2d r(100, 100, 40, 40);
+  EXPECT_TRUE(t.rectifyTracker(texture(0), r, r, stamp));
+  stamp.sec = 1;
+  EXPECT_TRUE(t.updateTracker(texture(4), stamp));
+  /* IoU 38 * 40 / (2 * 1600 - 38 * 40) = 0.9 with the tracked roi, kept*/
+  cv::Rect2d agreed(106, 100, 40, 40);
+  EXPECT_FALSE(t.rectifyTracker(texture(4), agreed, agreed, stamp));
+  EXPECT_EQ(t.getDetectedRect(), agreed);
+  /* drifted, re-seeded at the detection*/
+  cv::Rect2d drifted(130, 100, 40, 40);
+  EXPECT_TRUE(t.rectifyTracker(texture(4), drifted, drifted, stamp));
+  EXPECT_EQ(t.getTrackedRect(), drifted);
+}
 
 int main(int argc, char ** argv)
 {
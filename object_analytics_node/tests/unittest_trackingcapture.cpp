@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <opencv2/imgproc.hpp>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "object_analytics_node/tracker/tracking_capture.hpp"
+
+using object_analytics_node::tracker::CaptureReader;
+using object_analytics_node::tracker::TrackingCapture;
+
+TEST(UnitTestTrackingCapture, next_SameOrderAsRecorded)
+{
+  std::string file = "/tmp/unittest_trackingcapture_" + std::to_string(getpid()) + ".bin";
+  cv::Mat image(48, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+  cv::rectangle(image, cv::Rect(8, 8, 16, 16), cv::Scalar(200, 100, 0), -1);
+  auto objs = std::make_shared<object_msgs::msg::ObjectsInBoxes>();
+  objs->objects_vector.resize(1);
+  objs->objects_vector[0].object.object_name = "person";
+  objs->objects_vector[0].object.probability = 0.9f;
+  objs->objects_vector[0].roi.x_offset = 8;
+  objs->objects_vector[0].roi.width = 16;
+  {
+    TrackingCapture capture(file, ".png");
+    capture.algo("MEDIAN_FLOW");
+    capture.algo("MEDIAN_FLOW");
+    capture.frame(1000000001, image, "bgr8", 0.5, nullptr);
+    capture.detect(1000000001, objs, nullptr);
+    capture.track(1000000002);
+    capture.extrapolate(1000000003);
+    capture.replenish();
+  }
+
+  CaptureReader reader(file);
+  CaptureReader::Record record;
+  ASSERT_TRUE(reader.next(record));
+  EXPECT_EQ(record.type, TrackingCapture::kAlgo);
+  EXPECT_EQ(record.algo, "MEDIAN_FLOW");
+
+  ASSERT_TRUE(reader.next(record));
+  EXPECT_EQ(record.type, TrackingCapture::kFrame);
+  EXPECT_EQ(record.stamp, 1000000001);
+  EXPECT_EQ(record.encoding, "bgr8");
+  EXPECT_EQ(record.scale, 0.5);
+  /* png is lossless*/
+  ASSERT_EQ(record.image.size(), image.size());
+  EXPECT_EQ(cv::norm(record.image, image, cv::NORM_INF), 0.);
+
+  ASSERT_TRUE(reader.next(record));
+  EXPECT_EQ(record.type, TrackingCapture::kDetect);
+  ASSERT_EQ(record.objs->objects_vector.size(), 1u);
+  EXPECT_EQ(record.objs->objects_vector[0].object.object_name, "person");
+  EXPECT_EQ(record.objs->objects_vector[0].object.probability, 0.9f);
+  EXPECT_TRUE(record.objs->objects_vector[0].roi == objs->objects_vector[0].roi);
+  EXPECT_EQ(record.objs->header.stamp.sec, 1);
+  EXPECT_EQ(record.objs->header.stamp.nanosec, 1u);
+  EXPECT_FALSE(record.loc);
+
+  ASSERT_TRUE(reader.next(record));
+  EXPECT_EQ(record.type, TrackingCapture::kTrack);
+  EXPECT_EQ(record.stamp, 1000000002);
+  ASSERT_TRUE(reader.next(record));
+  EXPECT_EQ(record.type, TrackingCapture::kExtrapolate);
+  ASSERT_TRUE(reader.next(record));
+  EXPECT_EQ(record.type, TrackingCapture::kReplenish);
+  EXPECT_FALSE(reader.next(record));
+  std::remove(file.c_str());
+}
+
+TEST(UnitTestTrackingCapture, CaptureReader_NotACapture)
+{
+  std::string file = "/tmp/unittest_trackingcapture_" + std::to_string(getpid()) + ".txt";
+  FILE * f = std::fopen(file.c_str(), "w");
+  ASSERT_NE(f, nullptr);
+  std::fputs("not a capture", f);
+  std::fclose(f);
+  EXPECT_THROW(CaptureReader reader(file), std::runtime_error);
+  std::remove(file.c_str());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -216,6 +216,149 @@ TEST(UnitTestTracking_Manager, getTrackedObjs_FirstPartialWithin_OtherPartialWit
   }
 }
 
+TEST(UnitTestTracking_Manager, getTrackedObjs_WorkingScale)
+{
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  objs->objects_vector.push_back(getObjectInBox(100, 60, 200, 120, "person", 0.9f));
+
+  /* frames tracked at half the camera resolution*/
+  cv::Mat mat(160, 240, CV_8UC3, cv::Scalar(0, 0, 0));
+  rclcpp::Node node("test_scale");
+  object_analytics_node::tracker::TrackingManager tr(&node);
+  tr.setWorkingScale(0.5);
+
+  tr.detect(mat, objs);
+  object_analytics_msgs::msg::TrackedObjects msg;
+  EXPECT_EQ(tr.getTrackedObjs(msg), 1);
+  EXPECT_EQ(msg.tracked_objects[0].roi.x_offset, static_cast<size_t>(100));
+  EXPECT_EQ(msg.tracked_objects[0].roi.y_offset, static_cast<size_t>(60));
+  EXPECT_EQ(msg.tracked_objects[0].roi.width, static_cast<size_t>(200));
+  EXPECT_EQ(msg.tracked_objects[0].roi.height, static_cast<size_t>(120));
+}
+
+TEST(UnitTestTracking_Manager, getTrackedObjs_Velocities)
+{
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  objs->objects_vector.push_back(getObjectInBox(20, 20, 40, 40, "person", 0.9f));
+  objs->objects_vector.push_back(getObjectInBox(100, 60, 40, 40, "chair", 0.9f));
+
+  cv::Mat mat(160, 240, CV_8UC3, cv::Scalar(0, 0, 0));
+  rclcpp::Node node("test_velocities");
+  object_analytics_node::tracker::TrackingManager tr(&node);
+  tr.detect(mat, objs);
+
+  /* one per object in order, unknown before a second frame*/
+  object_analytics_msgs::msg::TrackedObjects msg;
+  std::vector<cv::Point2d> velocities;
+  EXPECT_EQ(tr.getTrackedObjs(msg, &velocities), 2);
+  ASSERT_EQ(velocities.size(), msg.tracked_objects.size());
+  for (auto & v : velocities) {
+    EXPECT_DOUBLE_EQ(v.x, 0.);
+    EXPECT_DOUBLE_EQ(v.y, 0.);
+  }
+}
+
+TEST(UnitTestTracking_Manager, detect_DepthGate)
+{
+  /* two persons 4 meters apart in depth*/
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  objs->objects_vector.push_back(getObjectInBox(50, 50, 100, 100, "person", 0.9f));
+  objs->objects_vector.push_back(getObjectInBox(300, 50, 100, 100, "person", 0.9f));
+  object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr loc =
+    std::make_shared<object_analytics_msgs::msg::ObjectsInBoxes3D>();
+  loc->objects_in_boxes.push_back(
+    getObjectInBox3D(50, 50, 100, 100, 0, 0, 1, 1, 1, 2, "person", 0.9f));
+  loc->objects_in_boxes.push_back(
+    getObjectInBox3D(300, 50, 100, 100, 0, 0, 5, 1, 1, 6, "person", 0.9f));
+
+  /* the same rois in the next detection, the depths swapped*/
+  object_analytics_msgs::msg::ObjectsInBoxes3D::SharedPtr swapped =
+    std::make_shared<object_analytics_msgs::msg::ObjectsInBoxes3D>();
+  swapped->objects_in_boxes.push_back(
+    getObjectInBox3D(50, 50, 100, 100, 0, 0, 5, 1, 1, 6, "person", 0.9f));
+  swapped->objects_in_boxes.push_back(
+    getObjectInBox3D(300, 50, 100, 100, 0, 0, 1, 1, 1, 2, "person", 0.9f));
+
+  cv::Mat mat(320, 480, CV_8UC3, cv::Scalar(0, 0, 0));
+  rclcpp::Node node("test_depth_gate");
+  object_analytics_node::tracker::FrameContext ctx(mat);
+  object_analytics_node::tracker::TrackingManager ungated(&node);
+  ungated.detect(ctx, objs, loc);
+  ungated.detect(ctx, objs, swapped);
+  EXPECT_EQ(ungated.getTrackingCount(), static_cast<size_t>(2));
+  EXPECT_EQ(ungated.getDepthGated(), static_cast<uint64_t>(0));
+
+  object_analytics_node::tracker::TrackingManager gated(&node);
+  gated.setDepthGate(1.0);
+  gated.detect(ctx, objs, loc);
+  gated.detect(ctx, objs, swapped);
+  EXPECT_EQ(gated.getTrackingCount(), static_cast<size_t>(4));
+  EXPECT_EQ(gated.getDepthGated(), static_cast<uint64_t>(2));
+
+  /* pairs not localized are scored on their rois alone*/
+  object_analytics_node::tracker::TrackingManager partial(&node);
+  partial.setDepthGate(1.0);
+  partial.detect(ctx, objs, loc);
+  partial.detect(ctx, objs);
+  EXPECT_EQ(partial.getTrackingCount(), static_cast<size_t>(2));
+  EXPECT_EQ(partial.getDepthGated(), static_cast<uint64_t>(0));
+}
+
+TEST(UnitTestTracking_Manager, track_Occlusion)
+{
+  /* the first two overlap by 66% of either roi, the third apart*/
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  objs->objects_vector.push_back(getObjectInBox(20, 20, 40, 40, "person", 0.9f));
+  objs->objects_vector.push_back(getObjectInBox(25, 30, 40, 40, "person", 0.9f));
+  objs->objects_vector.push_back(getObjectInBox(150, 100, 40, 40, "chair", 0.9f));
+
+  cv::Mat mat(160, 240, CV_8UC3, cv::Scalar(0, 0, 0));
+  builtin_interfaces::msg::Time stamp;
+  stamp.nanosec = 33000000;
+  rclcpp::Node node("test_occlusion");
+  object_analytics_node::tracker::TrackingManager off(&node);
+  off.setAlgo("KALMAN");
+  off.detect(mat, objs);
+  off.track(mat, stamp);
+  EXPECT_EQ(off.getOccluded(), static_cast<uint64_t>(0));
+
+  object_analytics_node::tracker::TrackingManager loose(&node);
+  loose.setAlgo("KALMAN");
+  loose.setOcclusionThreshold(0.8);
+  loose.detect(mat, objs);
+  loose.track(mat, stamp);
+  EXPECT_EQ(loose.getOccluded(), static_cast<uint64_t>(0));
+
+  /* one of the pair frozen, still published*/
+  object_analytics_node::tracker::TrackingManager tight(&node);
+  tight.setAlgo("KALMAN");
+  tight.setOcclusionThreshold(0.5);
+  tight.detect(mat, objs);
+  tight.track(mat, stamp);
+  EXPECT_EQ(tight.getOccluded(), static_cast<uint64_t>(1));
+  object_analytics_msgs::msg::TrackedObjects msg;
+  EXPECT_EQ(tight.getTrackedObjs(msg), 3);
+}
+
+TEST(UnitTestTracking_Manager, warmup_NoTrackingLeft)
+{
+  rclcpp::Node node("test_warmup");
+  object_analytics_node::tracker::TrackingManager tr(&node, 2);
+  tr.setTrackerPoolSize(2);
+  tr.warmup(cv::Size(160, 120));
+  EXPECT_EQ(tr.getTrackingCount(), static_cast<size_t>(0));
+  EXPECT_EQ(tr.getTrackerPoolIdle(), static_cast<size_t>(2));
+
+  /* trackings added afterwards start from the next ID*/
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  objs->objects_vector.push_back(getObjectInBox(20, 20, 40, 40, "person", 0.9f));
+  cv::Mat mat(120, 160, CV_8UC3, cv::Scalar(0, 0, 0));
+  tr.detect(mat, objs);
+  object_analytics_msgs::msg::TrackedObjects msg;
+  EXPECT_EQ(tr.getTrackedObjs(msg), 1);
+  EXPECT_GE(msg.tracked_objects[0].id, 0);
+}
+
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
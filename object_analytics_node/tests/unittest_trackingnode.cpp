@@ -0,0 +1,83 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#define PCL_NO_PRECOMPILE
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "object_analytics_node/tracker/tracking_node.hpp"
+#include "unittest_util.hpp"
+
+using object_analytics_node::tracker::TrackingNode;
+
+TEST(UnitTestTrackingNode, getStreamThreads_Shared)
+{
+  EXPECT_EQ(4, TrackingNode::getStreamThreads(4, 1, 0));
+  EXPECT_EQ(2, TrackingNode::getStreamThreads(4, 2, 0));
+  EXPECT_EQ(2, TrackingNode::getStreamThreads(4, 2, 1));
+
+  /* the remainder to the first streams*/
+  EXPECT_EQ(3, TrackingNode::getStreamThreads(7, 3, 0));
+  EXPECT_EQ(2, TrackingNode::getStreamThreads(7, 3, 1));
+  EXPECT_EQ(2, TrackingNode::getStreamThreads(7, 3, 2));
+
+  /* each stream has its executor thread at least*/
+  EXPECT_EQ(1, TrackingNode::getStreamThreads(3, 4, 3));
+  EXPECT_EQ(1, TrackingNode::getStreamThreads(0, 1, 0));
+}
+
+TEST(UnitTestTrackingNode, streams_TwoShareThreads)
+{
+  rclcpp::NodeOptions options;
+  options.parameter_overrides({rclcpp::Parameter("streams", std::vector<std::string>{"cam0",
+      "cam1"}),
+    rclcpp::Parameter("tracking_threads", 5),
+    rclcpp::Parameter("warmup", false),
+    rclcpp::Parameter("publish_stats", false)});
+  auto node = std::make_shared<TrackingNode>(options);
+  ASSERT_EQ(static_cast<size_t>(2), node->getStreamCount());
+  EXPECT_EQ("cam0", node->getStream(0).getName());
+  EXPECT_EQ("cam1", node->getStream(1).getName());
+  EXPECT_EQ(static_cast<size_t>(3), node->getStream(0).getManager().getNumOfThread());
+  EXPECT_EQ(static_cast<size_t>(2), node->getStream(1).getManager().getNumOfThread());
+
+  /* the same objects seen by both cameras get IDs of their own*/
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  objs->objects_vector.push_back(getObjectInBox(20, 20, 40, 40, "person", 0.9f));
+  objs->objects_vector.push_back(getObjectInBox(100, 20, 40, 40, "chair", 0.9f));
+  cv::Mat mat(120, 160, CV_8UC3, cv::Scalar(0, 0, 0));
+  std::set<int64_t> ids;
+  for (size_t i = 0; i < node->getStreamCount(); i++) {
+    object_analytics_node::tracker::TrackingManager & tm = node->getStream(i).getManager();
+    tm.detect(mat, objs);
+    object_analytics_msgs::msg::TrackedObjects msg;
+    EXPECT_EQ(2, tm.getTrackedObjs(msg));
+    for (auto & obj : msg.tracked_objects) {
+      ids.insert(obj.id);
+    }
+  }
+  EXPECT_EQ(static_cast<size_t>(4), ids.size());
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "rclcpp/rclcpp.hpp"
+#include "object_analytics_node/tracker/tracking_manager.hpp"
+#include "object_analytics_node/tracker/tracking_snapshot.hpp"
+#include "unittest_util.hpp"
+
+using object_analytics_node::tracker::TrackingManager;
+using object_analytics_node::tracker::TrackingSnapshot;
+
+TEST(UnitTestTrackingSnapshot, load_SameAsSaved)
+{
+  std::string file = "/tmp/unittest_trackingsnapshot_" + std::to_string(getpid()) + ".bin";
+  std::vector<TrackingSnapshot::Entry> saved(1);
+  saved[0].id = 42;
+  saved[0].name = "person";
+  saved[0].probability = 0.9f;
+  saved[0].tracked = cv::Rect2d(10, 20, 30, 40);
+  saved[0].detected = cv::Rect2d(11, 21, 31, 41);
+  saved[0].state = 1;
+  saved[0].hits = 3;
+  saved[0].ageing = 2;
+  saved[0].misses = -1;
+  saved[0].localized = true;
+  saved[0].centroid = cv::Point3d(0.5, -0.5, 2.0);
+  saved[0].history.emplace_back(1000, cv::Rect2d(9, 20, 30, 40));
+  saved[0].history.emplace_back(2000, cv::Rect2d(10, 20, 30, 40));
+  ASSERT_TRUE(TrackingSnapshot::save(file, 123456789, saved));
+
+  int64_t stamp = 0;
+  std::vector<TrackingSnapshot::Entry> loaded;
+  ASSERT_TRUE(TrackingSnapshot::load(file, stamp, loaded));
+  EXPECT_EQ(stamp, 123456789);
+  ASSERT_EQ(loaded.size(), static_cast<size_t>(1));
+  EXPECT_EQ(loaded[0].id, 42);
+  EXPECT_EQ(loaded[0].name, "person");
+  EXPECT_EQ(loaded[0].tracked, saved[0].tracked);
+  EXPECT_EQ(loaded[0].detected, saved[0].detected);
+  EXPECT_EQ(loaded[0].hits, 3);
+  EXPECT_EQ(loaded[0].misses, -1);
+  EXPECT_TRUE(loaded[0].localized);
+  EXPECT_EQ(loaded[0].centroid, saved[0].centroid);
+  ASSERT_EQ(loaded[0].history.size(), static_cast<size_t>(2));
+  EXPECT_EQ(loaded[0].history[1].first, 2000);
+
+  /* truncated, nothing restored*/
+  {
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    out.write("OATS", 4);
+  }
+  EXPECT_FALSE(TrackingSnapshot::load(file, stamp, loaded));
+  EXPECT_TRUE(loaded.empty());
+  std::remove(file.c_str());
+  EXPECT_FALSE(TrackingSnapshot::load(file, stamp, loaded));
+}
+
+TEST(UnitTestTrackingSnapshot, restore_SameIdsTrackedBeforeDetection)
+{
+  object_msgs::msg::ObjectsInBoxes::SharedPtr objs = std::make_shared<ObjectsInBoxes>();
+  objs->objects_vector.push_back(getObjectInBox(20, 20, 40, 40, "person", 0.9f));
+  objs->objects_vector.push_back(getObjectInBox(150, 100, 40, 40, "chair", 0.9f));
+  cv::Mat mat(160, 240, CV_8UC3, cv::Scalar(0, 0, 0));
+  rclcpp::Node node("test_snapshot");
+
+  std::vector<TrackingSnapshot::Entry> entries;
+  object_analytics_msgs::msg::TrackedObjects before;
+  {
+    TrackingManager tm(&node);
+    tm.setAlgo("KALMAN");
+    tm.detect(mat, objs);
+    EXPECT_EQ(tm.getTrackedObjs(before), 2);
+    tm.snapshot(entries);
+  }
+  ASSERT_EQ(entries.size(), static_cast<size_t>(2));
+
+  /* the objects of the restarted manager are out at its first frame*/
+  TrackingManager tm(&node);
+  tm.setAlgo("KALMAN");
+  EXPECT_EQ(tm.restore(entries), static_cast<size_t>(2));
+  builtin_interfaces::msg::Time stamp;
+  stamp.sec = 5;
+  tm.track(mat, stamp);
+  object_analytics_msgs::msg::TrackedObjects after;
+  ASSERT_EQ(tm.getTrackedObjs(after), 2);
+  for (size_t i = 0; i < after.tracked_objects.size(); i++) {
+    EXPECT_EQ(after.tracked_objects[i].id, before.tracked_objects[i].id);
+    EXPECT_EQ(after.tracked_objects[i].roi, before.tracked_objects[i].roi);
+  }
+
+  /* new objects take IDs after the restored ones*/
+  objs->objects_vector.push_back(getObjectInBox(100, 20, 40, 40, "dog", 0.9f));
+  objs->header.stamp = stamp;
+  tm.detect(mat, objs);
+  object_analytics_msgs::msg::TrackedObjects later;
+  ASSERT_EQ(tm.getTrackedObjs(later), 3);
+  for (auto & obj : later.tracked_objects) {
+    if (obj.object.object_name == "dog") {
+      EXPECT_GT(obj.id, std::max(before.tracked_objects[0].id, before.tracked_objects[1].id));
+    }
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,213 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#define PCL_NO_PRECOMPILE
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "rclcpp/rclcpp.hpp"
+#include "object_analytics_node/const.hpp"
+#include "object_analytics_node/tracker/tracking_stream.hpp"
+#include "unittest_util.hpp"
+
+using object_analytics_msgs::msg::TrackedObject;
+using object_analytics_msgs::msg::TrackedObjects;
+using object_analytics_node::Const;
+using object_analytics_node::tracker::TrackingStream;
+
+static TrackedObject getTrackedObject(
+  int x, int y, int width, int height, const std::string & name, float probability)
+{
+  TrackedObject obj;
+  obj.object.object_name = name;
+  obj.object.probability = probability;
+  obj.roi.x_offset = x;
+  obj.roi.y_offset = y;
+  obj.roi.width = width;
+  obj.roi.height = height;
+  return obj;
+}
+
+TEST(UnitTestTrackingStream, needsRectify_TrackedWell)
+{
+  ObjectsInBoxes objs;
+  objs.objects_vector.push_back(getObjectInBox(100, 100, 100, 100, "person", 0.6f));
+  TrackedObjects tracked;
+  /* IoU 90 * 100 / (2 * 10000 - 9000) = 0.82*/
+  tracked.tracked_objects.push_back(getTrackedObject(110, 100, 100, 100, "person", 0.6f));
+  EXPECT_FALSE(TrackingStream::needsRectify(objs, tracked));
+}
+
+TEST(UnitTestTrackingStream, needsRectify_Drifted)
+{
+  ObjectsInBoxes objs;
+  objs.objects_vector.push_back(getObjectInBox(100, 100, 100, 100, "person", 0.6f));
+  TrackedObjects tracked;
+  /* IoU 70 * 100 / (2 * 10000 - 7000) = 0.54, below kCheckOverlap*/
+  tracked.tracked_objects.push_back(getTrackedObject(130, 100, 100, 100, "person", 0.6f));
+  EXPECT_TRUE(TrackingStream::needsRectify(objs, tracked));
+  /* disjoint*/
+  tracked.tracked_objects[0] = getTrackedObject(300, 300, 100, 100, "person", 0.6f);
+  EXPECT_TRUE(TrackingStream::needsRectify(objs, tracked));
+  /* empty rois, no union*/
+  objs.objects_vector[0] = getObjectInBox(100, 100, 0, 0, "person", 0.6f);
+  tracked.tracked_objects[0] = getTrackedObject(100, 100, 0, 0, "person", 0.6f);
+  EXPECT_TRUE(TrackingStream::needsRectify(objs, tracked));
+}
+
+TEST(UnitTestTrackingStream, needsRectify_NewOrTrackedWell)
+{
+  ObjectsInBoxes objs;
+  objs.objects_vector.push_back(getObjectInBox(100, 100, 100, 100, "person", 0.6f));
+  TrackedObjects tracked;
+  tracked.tracked_objects.push_back(getTrackedObject(100, 100, 100, 100, "chair", 0.6f));
+  EXPECT_TRUE(TrackingStream::needsRectify(objs, tracked));
+  tracked.tracked_objects.push_back(getTrackedObject(100, 100, 100, 100, "person", 0.6f));
+  EXPECT_FALSE(TrackingStream::needsRectify(objs, tracked));
+  /* confident detections passing the filter are skipped as well once tracked well*/
+  objs.objects_vector[0].object.probability = 0.9f;
+  EXPECT_FALSE(TrackingStream::needsRectify(objs, tracked));
+}
+
+TEST(UnitTestTrackingStream, needsRectify_BestOverlap)
+{
+  /* two people, each tracked well, listed in the other order*/
+  ObjectsInBoxes objs;
+  objs.objects_vector.push_back(getObjectInBox(100, 100, 100, 100, "person", 0.9f));
+  objs.objects_vector.push_back(getObjectInBox(400, 100, 100, 100, "person", 0.9f));
+  TrackedObjects tracked;
+  tracked.tracked_objects.push_back(getTrackedObject(405, 100, 100, 100, "person", 0.9f));
+  tracked.tracked_objects.push_back(getTrackedObject(105, 100, 100, 100, "person", 0.9f));
+  EXPECT_FALSE(TrackingStream::needsRectify(objs, tracked));
+
+  /* one of them drifted off, whatever the order*/
+  tracked.tracked_objects[0] = getTrackedObject(460, 100, 100, 100, "person", 0.9f);
+  EXPECT_TRUE(TrackingStream::needsRectify(objs, tracked));
+  std::swap(tracked.tracked_objects[0], tracked.tracked_objects[1]);
+  EXPECT_TRUE(TrackingStream::needsRectify(objs, tracked));
+}
+
+/* feeds a stream through its topics, the stream node spun only when asked*/
+class StreamFeeder
+{
+public:
+  explicit StreamFeeder(const std::string & name)
+  : node_(std::make_shared<rclcpp::Node>("test_" + name)),
+    feeder_(std::make_shared<rclcpp::Node>("test_" + name + "_feeder"))
+  {
+    TrackingStream::Options options;
+    options.warmup = false;
+    options.catch_up = false;
+    stream_.reset(new TrackingStream(node_.get(), name, options));
+    pub_rgb_ = feeder_->create_publisher<sensor_msgs::msg::Image>(
+      "/" + name + Const::kTopicRgb, rmw_qos_profile_default);
+    pub_obj_ = feeder_->create_publisher<ObjectsInBoxes>(
+      "/" + name + Const::kTopicDetection, rmw_qos_profile_default);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((pub_rgb_->get_subscription_count() == 0 ||
+      pub_obj_->get_subscription_count() == 0) && std::chrono::steady_clock::now() < deadline)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  void rgb(int32_t sec)
+  {
+    sensor_msgs::msg::Image img;
+    img.header.stamp.sec = sec;
+    img.header.frame_id = "camera";
+    img.width = 320;
+    img.height = 240;
+    img.encoding = "bgr8";
+    img.step = img.width * 3;
+    /* textured, so that trackers initialize on it*/
+    img.data.resize(img.step * img.height);
+    for (size_t i = 0; i < img.data.size(); i++) {
+      img.data[i] = static_cast<uint8_t>((i * 7 + i / img.step * 13) % 256);
+    }
+    pub_rgb_->publish(img);
+  }
+
+  void objs(int32_t sec, size_t count)
+  {
+    ObjectsInBoxes objs;
+    objs.header.stamp.sec = sec;
+    objs.header.frame_id = "camera";
+    for (size_t i = 0; i < count; i++) {
+      objs.objects_vector.push_back(getObjectInBox(10 + 60 * i, 10, 40, 40, "person", 0.9f));
+    }
+    pub_obj_->publish(objs);
+  }
+
+  /* let the messages published reach the queues of the stream, then take them*/
+  void deliver()
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    rclcpp::spin_some(node_);
+  }
+
+  std::shared_ptr<rclcpp::Node> node_;
+  std::shared_ptr<rclcpp::Node> feeder_;
+  std::unique_ptr<TrackingStream> stream_;
+  rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr pub_rgb_;
+  rclcpp::Publisher<ObjectsInBoxes>::SharedPtr pub_obj_;
+};
+
+TEST(UnitTestTrackingStream, coalesce_KeepsNewest)
+{
+  StreamFeeder feeder("coalesce_newest");
+  feeder.rgb(5);
+  feeder.deliver();
+
+  /* a burst, only the newest one has its rgb frame and two objects*/
+  for (int32_t sec = 1; sec <= 5; sec++) {
+    feeder.objs(sec, sec == 5 ? 2 : 1);
+  }
+  feeder.deliver();
+  EXPECT_EQ(static_cast<uint64_t>(4), feeder.stream_->getCoalesced());
+  EXPECT_EQ(static_cast<size_t>(2), feeder.stream_->getManager().getTrackingCount());
+}
+
+TEST(UnitTestTrackingStream, coalesce_SkipsMissedRgb)
+{
+  StreamFeeder feeder("coalesce_missed");
+  feeder.rgb(2);
+  feeder.rgb(4);
+  feeder.deliver();
+
+  /* the rgb frame of the newest was missed, the one before is taken*/
+  feeder.objs(1, 1);
+  feeder.objs(2, 2);
+  feeder.objs(3, 3);
+  feeder.deliver();
+  EXPECT_EQ(static_cast<uint64_t>(2), feeder.stream_->getCoalesced());
+  EXPECT_EQ(static_cast<size_t>(2), feeder.stream_->getManager().getTrackingCount());
+
+  /* one frame alone is not coalesced*/
+  feeder.objs(4, 1);
+  feeder.deliver();
+  EXPECT_EQ(static_cast<uint64_t>(2), feeder.stream_->getCoalesced());
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "object_analytics_node/logger/track_log.hpp"
+#include "object_analytics_node/util/class_table.hpp"
+
+using object_analytics_node::logger::TrackLog;
+using object_analytics_node::logger::TrackLogReader;
+using object_analytics_node::logger::TrackRow;
+using object_analytics_node::util::ClassTable;
+
+static std::string getPrefix()
+{
+  return "/tmp/unittest_tracklog_" + std::to_string(getpid());
+}
+
+static TrackRow getRow(int64_t stamp, int32_t id)
+{
+  TrackRow row;
+  row.stamp = stamp;
+  row.id = id;
+  row.class_id = ClassTable::intern(id % 2 ? "person" : "car");
+  row.x = static_cast<uint16_t>(id);
+  row.y = 2;
+  row.width = 30;
+  row.height = 40;
+  for (size_t i = 0; i < 3; i++) {
+    row.min[i] = 0.1f * id + i;
+    row.max[i] = 0.1f * id + i + 1.0f;
+  }
+  return row;
+}
+
+TEST(UnitTestTrackLog, next_SameRowsAsAppended)
+{
+  std::string prefix = getPrefix();
+  {
+    TrackLog log(prefix, 4);
+    for (int32_t i = 0; i < 10; i++) {
+      log.append(getRow(1000 + i, i));
+    }
+  }
+  TrackLogReader reader(TrackLog::getPath(prefix, 0));
+  std::vector<TrackRow> rows, all;
+  while (reader.next(rows)) {
+    EXPECT_LE(rows.size(), 4u);
+    all.insert(all.end(), rows.begin(), rows.end());
+  }
+  ASSERT_EQ(all.size(), 10u);
+  for (int32_t i = 0; i < 10; i++) {
+    TrackRow expected = getRow(1000 + i, i);
+    EXPECT_EQ(all[i].stamp, expected.stamp);
+    EXPECT_EQ(all[i].id, expected.id);
+    EXPECT_EQ(reader.getClassName(all[i].class_id), i % 2 ? "person" : "car");
+    EXPECT_EQ(all[i].x, expected.x);
+    EXPECT_EQ(all[i].height, expected.height);
+    for (size_t j = 0; j < 3; j++) {
+      EXPECT_EQ(all[i].min[j], expected.min[j]);
+      EXPECT_EQ(all[i].max[j], expected.max[j]);
+    }
+  }
+  std::remove(TrackLog::getPath(prefix, 0).c_str());
+}
+
+TEST(UnitTestTrackLog, next_WideIds)
+{
+  std::string prefix = getPrefix() + "_wide";
+  int64_t id = (int64_t(1) << 40) + 5;
+  {
+    TrackLog log(prefix, 4);
+    TrackRow row = getRow(1000, 1);
+    row.id = id;
+    log.append(row);
+  }
+  TrackLogReader reader(TrackLog::getPath(prefix, 0));
+  std::vector<TrackRow> rows;
+  ASSERT_TRUE(reader.next(rows));
+  ASSERT_EQ(rows.size(), 1u);
+  EXPECT_EQ(rows[0].id, id);
+  std::remove(TrackLog::getPath(prefix, 0).c_str());
+}
+
+TEST(UnitTestTrackLog, next_SkipsBlocksOutOfRange)
+{
+  std::string prefix = getPrefix();
+  {
+    TrackLog log(prefix, 5);
+    for (int32_t i = 0; i < 20; i++) {
+      log.append(getRow(i, i));
+    }
+  }
+  TrackLogReader reader(TrackLog::getPath(prefix, 0));
+  std::vector<TrackRow> rows;
+  ASSERT_TRUE(reader.next(rows, 11, 12));
+  ASSERT_EQ(rows.size(), 5u);
+  EXPECT_EQ(rows[0].stamp, 10);
+  EXPECT_EQ(reader.getClassName(rows[1].class_id), "person");
+  EXPECT_FALSE(reader.next(rows, 11, 12));
+  std::remove(TrackLog::getPath(prefix, 0).c_str());
+}
+
+TEST(UnitTestTrackLog, append_RotatesFiles)
+{
+  std::string prefix = getPrefix();
+  size_t files = 0;
+  {
+    /* fewer blocks than kMaxPendingBlocks, none dropped*/
+    TrackLog log(prefix, 4, 256);
+    for (int32_t i = 0; i < 40; i++) {
+      log.append(getRow(i, i));
+    }
+  }
+  std::vector<TrackRow> rows;
+  size_t total = 0;
+  for (; ; files++) {
+    std::string file = TrackLog::getPath(prefix, files);
+    if (access(file.c_str(), F_OK) != 0) {
+      break;
+    }
+    TrackLogReader reader(file);
+    while (reader.next(rows)) {
+      /* names are repeated in each file*/
+      EXPECT_FALSE(reader.getClassName(rows[0].class_id).empty());
+      total += rows.size();
+    }
+    std::remove(file.c_str());
+  }
+  EXPECT_GT(files, 1u);
+  EXPECT_EQ(total, 40u);
+}
+
+TEST(UnitTestTrackLog, TrackLogReader_NotATrackLog)
+{
+  std::string file = getPrefix() + ".txt";
+  {
+    std::ofstream out(file);
+    out << "not a track log";
+  }
+  EXPECT_THROW(TrackLogReader reader(file), std::runtime_error);
+  std::remove(file.c_str());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
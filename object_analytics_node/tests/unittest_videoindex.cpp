@@ -0,0 +1,93 @@
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
+#include "object_analytics_node/dataset/video_index.hpp"
+
+using datasets::VideoIndex;
+
+/* frames of a constant gray level each, so the position can be checked*/
+static std::string writeVideo(int count)
+{
+  std::string path = "/tmp/unittest_videoindex_" + std::to_string(getpid()) + ".avi";
+  std::remove(VideoIndex::getCachePath(path).c_str());
+  cv::VideoWriter writer(path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 25,
+    cv::Size(16, 16));
+  for (int i = 0; i < count; i++) {
+    writer << cv::Mat(16, 16, CV_8UC3, cv::Scalar::all(i * 4));
+  }
+  return path;
+}
+
+static int grayOf(const cv::Mat & frame)
+{
+  return frame.at<cv::Vec3b>(8, 8)[0];
+}
+
+TEST(UnitTestVideoIndex, open_IndexesAllFrames)
+{
+  std::string path = writeVideo(40);
+  VideoIndex index;
+  ASSERT_TRUE(index.open(path));
+  EXPECT_EQ(index.size(), 40u);
+  for (size_t i = 1; i < index.size(); i++) {
+    EXPECT_GT(index.getMsec(i), index.getMsec(i - 1));
+  }
+  EXPECT_EQ(index.find(index.getMsec(17)), 17u);
+}
+
+TEST(UnitTestVideoIndex, open_CachedUntilChanged)
+{
+  std::string path = writeVideo(20);
+  VideoIndex index;
+  ASSERT_TRUE(index.open(path));
+  std::string cache = VideoIndex::getCachePath(path);
+
+  VideoIndex cached;
+  ASSERT_TRUE(cached.load(cache));
+  EXPECT_EQ(cached.size(), 20u);
+
+  writeVideo(10);
+  EXPECT_FALSE(cached.load(cache));
+  ASSERT_TRUE(cached.open(path));
+  EXPECT_EQ(cached.size(), 10u);
+}
+
+TEST(UnitTestVideoIndex, read_RandomOrder)
+{
+  std::string path = writeVideo(60);
+  VideoIndex index;
+  ASSERT_TRUE(index.open(path));
+  cv::VideoCapture cap(path);
+  ASSERT_TRUE(cap.isOpened());
+
+  size_t pos = 0;
+  cv::Mat frame;
+  for (size_t idx : {30u, 31u, 35u, 5u, 0u, 59u, 12u}) {
+    ASSERT_TRUE(index.read(cap, pos, idx, frame));
+    EXPECT_NEAR(grayOf(frame), static_cast<int>(idx) * 4, 3);
+    EXPECT_EQ(pos, idx + 1);
+  }
+  EXPECT_FALSE(index.read(cap, pos, 60, frame));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
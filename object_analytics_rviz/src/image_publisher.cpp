@@ -21,8 +21,16 @@
 #include <geometry_msgs/msg/point.hpp>
 #include <object_analytics_msgs/msg/tracked_object.hpp>
 #include <object_analytics_msgs/msg/tracked_objects.hpp>
+#include <object_analytics_msgs/msg/overlay_primitives.hpp>
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <object_analytics_node/util/qos_profiles.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cinttypes>
+#include <cmath>
 #include <string>
 #include <vector>
 #include <memory>
@@ -30,15 +38,30 @@
 using namespace std::chrono_literals;
 using std::placeholders::_1;
 
+using object_analytics_node::util::QosProfiles;
 using ImageMsg = sensor_msgs::msg::Image;
+using CompressedImageMsg = sensor_msgs::msg::CompressedImage;
 using TrackingMsg = object_analytics_msgs::msg::TrackedObjects;
+using OverlayMsg = object_analytics_msgs::msg::OverlayPrimitives;
+using OverlayPrimitive = object_analytics_msgs::msg::OverlayPrimitive;
 
 using DetectionObject = object_msgs::msg::Object;
 using DetectionObjectInBox = object_msgs::msg::ObjectInBox;
 using TrackingObjectInBox = object_analytics_msgs::msg::TrackedObject;
 
 /* This demo code is desiged for showing object analytics result on rviz.
- * Subscribe image/tracking msg, publish tracking 2d box for display. */
+ * Subscribe image/tracking msg, publish tracking 2d box for display.
+ *
+ * With overlay_mode "image", the overlay is drawn into a pooled output image,
+ * which keeps its allocation while the resolution holds, at overlay_scale of
+ * the input resolution. With overlay_mode "primitives", only the overlay
+ * primitives are published on /object_analytics/image_publisher/overlay and
+ * compositing is left to the client. With compressed, the image is published
+ * JPEG encoded at jpeg_quality on /object_analytics/image_publisher/compressed
+ * instead of raw, for remote monitoring. Outputs are published every
+ * frame_decimation frames. The QoS of the topics is set by qos.rgb, "sensor"
+ * by default so a late frame is dropped rather than queued, qos.tracking and
+ * qos.output, "reliable" by default, see util::QosProfiles. */
 
 class ImagePublisher : public rclcpp::Node
 {
@@ -46,22 +69,50 @@ public:
   ImagePublisher()
   : Node("image_publisher")
   {
+    std::string mode = declare_parameter<std::string>("overlay_mode", "image");
+    primitives_only_ = mode == "primitives";
+    if (!primitives_only_ && mode != "image") {
+      RCLCPP_WARN(get_logger(), "unknown overlay_mode %s, use image", mode.c_str());
+    }
+    scale_ = declare_parameter<double>("overlay_scale", 1.0);
+    if (scale_ <= 0 || scale_ > 1) {
+      RCLCPP_WARN(get_logger(), "overlay_scale %.2f out of (0, 1], use 1", scale_);
+      scale_ = 1.0;
+    }
+    compressed_ = declare_parameter<bool>("compressed", false);
+    jpeg_params_ = {cv::IMWRITE_JPEG_QUALITY,
+      std::min(100, std::max(0, static_cast<int>(declare_parameter<int>("jpeg_quality", 80))))};
+    decimation_ = std::max(1, static_cast<int>(declare_parameter<int>("frame_decimation", 1)));
+
+    rmw_qos_profile_t image_qos = QosProfiles::declare(this, "rgb", QosProfiles::kSensor);
+    rmw_qos_profile_t tracking_qos =
+      QosProfiles::declare(this, "tracking", QosProfiles::kReliable);
+
     rclcpp::Node::SharedPtr node = std::shared_ptr<rclcpp::Node>(this);
-    f_image_sub_ = std::make_unique<FilteredImage>(node, kTopicImage_);
-    f_tracking_sub_ = std::make_unique<FilteredTracking>(node, kTopicTracking_);
+    f_image_sub_ = std::make_unique<FilteredImage>(node, kTopicImage_, image_qos);
+    f_tracking_sub_ = std::make_unique<FilteredTracking>(node, kTopicTracking_, tracking_qos);
 
     sync_sub_ =
       std::make_unique<FilteredSync>(*f_image_sub_, *f_tracking_sub_, 10);
     sync_sub_->registerCallback(&ImagePublisher::onObjectsReceived, this);
 
-    image_pub_ = create_publisher<ImageMsg>("/object_analytics/image_publisher");
+    rmw_qos_profile_t output_qos = QosProfiles::declare(this, "output", QosProfiles::kReliable);
+    if (primitives_only_) {
+      overlay_pub_ =
+        create_publisher<OverlayMsg>("/object_analytics/image_publisher/overlay", output_qos);
+    } else if (compressed_) {
+      compressed_pub_ = create_publisher<CompressedImageMsg>(
+        "/object_analytics/image_publisher/compressed", output_qos);
+    } else {
+      image_pub_ = create_publisher<ImageMsg>("/object_analytics/image_publisher", output_qos);
+    }
 
 
     RCLCPP_INFO(get_logger(), "Start ImagePublisher ...");
 
     // subscribe those topics for performance test
     tra_subscription_ = this->create_subscription<TrackingMsg>(
-      kTopicTracking_, std::bind(&ImagePublisher::tra_callback, this, _1));
+      kTopicTracking_, std::bind(&ImagePublisher::tra_callback, this, _1), tracking_qos);
   }
 
 private:
@@ -82,9 +133,24 @@ private:
   rclcpp::TimerBase::SharedPtr timer_;
   rclcpp::Subscription<TrackingMsg>::SharedPtr tra_subscription_;
   rclcpp::Publisher<ImageMsg>::SharedPtr image_pub_;
+  rclcpp::Publisher<OverlayMsg>::SharedPtr overlay_pub_;
+  rclcpp::Publisher<CompressedImageMsg>::SharedPtr compressed_pub_;
+
+  float tra_latency_ = 0;
+  float tra_fps_ = 0;
 
-  float tra_latency_;
-  float tra_fps_;
+  bool primitives_only_;
+  double scale_;
+  /* primitives of the current frame, reused across frames*/
+  OverlayMsg overlay_;
+  /* pooled output image, its data is reallocated only on resolution change*/
+  ImageMsg out_;
+  bool compressed_;
+  std::vector<int> jpeg_params_;
+  /* encoded output, its data keeps the capacity of the largest frame*/
+  CompressedImageMsg jpeg_;
+  int decimation_;
+  uint64_t frames_ = 0;
 
   /* after messages filter, receive msgs from img/tra three topics */
   void onObjectsReceived(
@@ -101,65 +167,135 @@ private:
       RCLCPP_WARN(get_logger(), "frame_id not match, do nothing");
       return;
     }
+    if (img->width == 0 || img->height == 0 || tra->tracked_objects.size() == 0) {
+      return;
+    }
+    if (frames_++ % decimation_ != 0) {
+      return;
+    }
 
-    cv_bridge::CvImagePtr cv_ptr = cv_bridge::toCvCopy(img, "bgr8");
-    if (cv_ptr->image.size != 0 && tra->tracked_objects.size() != 0) {
-      cv_ptr->header = tra->header;
-      std::vector<TrackingObjectInBox> objects_tracked;
-      objects_tracked = tra->tracked_objects;
+    overlay_.header = tra->header;
+    overlay_.width = std::max(1, static_cast<int>(std::lround(img->width * scale_)));
+    overlay_.height = std::max(1, static_cast<int>(std::lround(img->height * scale_)));
+    overlay_.primitives.clear();
+    findObject(tra->tracked_objects);
+    if (primitives_only_) {
+      overlay_pub_->publish(overlay_);
+      return;
+    }
 
-      findObject(cv_ptr, objects_tracked);
-      image_pub_->publish(cv_ptr->toImageMsg());
+    /* shares the message data when already bgr8*/
+    cv_bridge::CvImageConstPtr cv_ptr = cv_bridge::toCvShare(img, "bgr8");
+    out_.header = tra->header;
+    out_.width = overlay_.width;
+    out_.height = overlay_.height;
+    out_.encoding = "bgr8";
+    out_.is_bigendian = 0;
+    out_.step = out_.width * 3;
+    out_.data.resize(out_.step * out_.height);
+    cv::Mat canvas(out_.height, out_.width, CV_8UC3, out_.data.data(), out_.step);
+    if (canvas.size() == cv_ptr->image.size()) {
+      cv_ptr->image.copyTo(canvas);
+    } else {
+      cv::resize(cv_ptr->image, canvas, canvas.size(), 0, 0, cv::INTER_AREA);
     }
+    render(canvas);
+    if (compressed_) {
+      jpeg_.header = out_.header;
+      jpeg_.format = "bgr8; jpeg compressed bgr8";
+      if (!cv::imencode(".jpg", canvas, jpeg_.data, jpeg_params_)) {
+        RCLCPP_WARN(get_logger(), "jpeg encoding failed");
+        return;
+      }
+      compressed_pub_->publish(jpeg_);
+      return;
+    }
+    image_pub_->publish(out_);
   }
 
   /* Find object with ROI */
-  void findObject(
-    cv_bridge::CvImagePtr cv_ptr, std::vector<TrackingObjectInBox> tra_objects)
+  void findObject(const std::vector<TrackingObjectInBox> & tra_objects)
   {
     // make sure all the msgs are none-empty
-    for (auto tra : tra_objects) {
-      ObjectRoi roi = tra.roi;
+    for (const auto & tra : tra_objects) {
+      const ObjectRoi & roi = tra.roi;
       if (roi.x_offset != 0 && roi.y_offset != 0 && roi.width != 0 && roi.height != 0) {
-        std::string obj_name = tra.object.object_name;
-        drawObject(cv_ptr, roi, obj_name, tra.id);
+        drawObject(roi, tra.object.object_name, tra.id);
       }
     }
+
+    // Draw measure result on the left up
+    char ss_tra[100];
+    snprintf(ss_tra, sizeof(ss_tra), "Tracking:fps=%.2fHz,latency=%.2fSec",
+      tra_fps_, tra_latency_);
+    addText(ss_tra, 2, 30, 1.0, 1.0, 0.0, 0.0);
   }
 
   /* publish object_name, object_id, mix points, max points, 3d box bounaries*/
-  void drawObject(
-    cv_bridge::CvImagePtr & cv_ptr, ObjectRoi roi, std::string obj_name, int32_t obj_id)
+  void drawObject(const ObjectRoi & roi, const std::string & obj_name, int64_t obj_id)
   {
-    RCLCPP_DEBUG(this->get_logger(), "Draw: name=%s, id=%d, roi(%d,%d,%d,%d), img(%d,%d)",
+    RCLCPP_DEBUG(this->get_logger(), "Draw: name=%s, id=%" PRId64 ", roi(%d,%d,%d,%d), img(%d,%d)",
       obj_name.c_str(), obj_id, roi.x_offset, roi.y_offset,
-      roi.height, roi.width, cv_ptr->image.cols, cv_ptr->image.rows);
+      roi.height, roi.width, overlay_.width, overlay_.height);
 
     // Draw rectangle same size and position as roi.
-    cv::Point bottom_left = cv::Point(roi.x_offset, roi.y_offset);
-    cv::Point middle_left = cv::Point(roi.x_offset, (roi.y_offset + roi.height / 2));
-    cv::Point top_right = cv::Point(roi.x_offset + roi.width, roi.y_offset + roi.height);
-    cv::rectangle(cv_ptr->image, bottom_left, top_right, cv::Scalar(255, 255, 0), 2, 8, 0);
+    OverlayPrimitive rect;
+    rect.type = OverlayPrimitive::RECT;
+    rect.x = std::lround(roi.x_offset * scale_);
+    rect.y = std::lround(roi.y_offset * scale_);
+    rect.width = std::lround(roi.width * scale_);
+    rect.height = std::lround(roi.height * scale_);
+    rect.color.g = 1.0;
+    rect.color.b = 1.0;
+    rect.color.a = 1.0;
+    rect.thickness = 2;
+    overlay_.primitives.push_back(rect);
 
     // Draw roi text on the top left position.
     std::stringstream ss_roi;
     ss_roi << "ROI[" << roi.x_offset << "," << roi.y_offset << "," << roi.width << "," <<
       roi.height << "]";
-    cv::putText(cv_ptr->image, ss_roi.str(), bottom_left, cv::FONT_HERSHEY_SIMPLEX, 0.8,
-      cv::Scalar(0, 255, 0), 2);
+    addText(ss_roi.str(), roi.x_offset, roi.y_offset, 0.8, 0.0, 1.0, 0.0);
 
     // Draw object name and tracking id together in the middle left of the rectangle
     std::stringstream ss_name_id;
     ss_name_id << obj_name << "(#" << obj_id << ")";
-    cv::putText(cv_ptr->image, ss_name_id.str(), middle_left, cv::FONT_HERSHEY_SIMPLEX, 0.8,
-      cv::Scalar(0, 255, 0), 2);
+    addText(ss_name_id.str(), roi.x_offset, roi.y_offset + roi.height / 2, 0.8, 0.0, 1.0, 0.0);
+  }
 
-    // Draw measure result on the left up
-    char ss_tra[100];
-    snprintf(ss_tra, sizeof(ss_tra), "Tracking:fps=%.2fHz,latency=%.2fSec",
-      tra_fps_, tra_latency_);
-    cv::putText(cv_ptr->image, ss_tra, cvPoint(2, 30), cv::FONT_HERSHEY_SIMPLEX, 1.0,
-      cv::Scalar(0, 0, 255), 2);
+  /* add a text primitive at x, y in pixels of the input image*/
+  void addText(
+    const std::string & text, int x, int y, float font_scale, float r, float g, float b)
+  {
+    OverlayPrimitive primitive;
+    primitive.type = OverlayPrimitive::TEXT;
+    primitive.x = std::lround(x * scale_);
+    primitive.y = std::lround(y * scale_);
+    primitive.text = text;
+    primitive.scale = font_scale * scale_;
+    primitive.color.r = r;
+    primitive.color.g = g;
+    primitive.color.b = b;
+    primitive.color.a = 1.0;
+    primitive.thickness = 2;
+    overlay_.primitives.push_back(primitive);
+  }
+
+  /* draw the primitives of the current frame into the bgr8 canvas*/
+  void render(cv::Mat & canvas)
+  {
+    for (const auto & primitive : overlay_.primitives) {
+      cv::Scalar color(primitive.color.b * 255, primitive.color.g * 255,
+        primitive.color.r * 255);
+      cv::Point origin(primitive.x, primitive.y);
+      if (primitive.type == OverlayPrimitive::RECT) {
+        cv::Point corner(primitive.x + primitive.width, primitive.y + primitive.height);
+        cv::rectangle(canvas, origin, corner, color, primitive.thickness, 8, 0);
+      } else {
+        cv::putText(canvas, primitive.text, origin, cv::FONT_HERSHEY_SIMPLEX, primitive.scale,
+          color, primitive.thickness);
+      }
+    }
   }
 
   /* tracking callback for performance test */
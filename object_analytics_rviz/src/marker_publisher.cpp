@@ -21,8 +21,12 @@
 #include <object_analytics_msgs/msg/tracked_objects.hpp>
 #include <object_analytics_msgs/msg/objects_in_boxes3_d.hpp>
 #include <object_analytics_msgs/msg/tracked_object.hpp>
+#include <object_analytics_node/util/qos_profiles.hpp>
 
 #include <chrono>
+#include <cmath>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <memory>
@@ -30,14 +34,26 @@
 using namespace std::chrono_literals;
 using std::placeholders::_1;
 
+using object_analytics_node::util::QosProfiles;
 using TrackingMsg = object_analytics_msgs::msg::TrackedObjects;
 using LocalizationMsg = object_analytics_msgs::msg::ObjectsInBoxes3D;
 using TrackingObjectInBox = object_analytics_msgs::msg::TrackedObject;
 using LocalizationObjectInBox = object_analytics_msgs::msg::ObjectInBox3D;
 
 const int kMsgQueueSize = 10;
+/* markers of an object within this distance in meters are not republished*/
+const double kBoxEpsilon = 0.001;
 /* This demo code is desiged for showing object analytics result on rviz.
- * Subscribe localization/tracking msg, publish box_3d_markers for display. */
+ * Subscribe localization/tracking msg, publish box_3d_markers for display.
+ *
+ * Markers of an object are keyed by its tracking ID, or by its position in the
+ * frame if not tracked, and only changes are published: ADD for new or moved
+ * objects, DELETE for objects gone. With marker_lifetime in seconds, RViz
+ * expires markers not refreshed, and unchanged ones are refreshed at half of
+ * it, 0 to keep markers till deleted. marker_rate in Hz caps the marker output
+ * independently of the input rate, 0 for no cap; performance statistics still
+ * count every message. The QoS of the topics is set by qos.localization and
+ * qos.output, "reliable" by default, see util::QosProfiles. */
 
 class MarkerPublisher : public rclcpp::Node
 {
@@ -45,14 +61,16 @@ public:
   MarkerPublisher()
   : Node("marker_publisher")
   {
-    loc_performance_subscription_ = this->create_subscription<LocalizationMsg>(
-      "/object_analytics/localization",
-      std::bind(&MarkerPublisher::loc_performance_callback, this, _1));
-    loc_marker_subscription_ = this->create_subscription<LocalizationMsg>(
-      "/object_analytics/localization", std::bind(&MarkerPublisher::loc_marker_callback, this, _1));
-    marker_pub_ =
-      create_publisher<visualization_msgs::msg::MarkerArray>("/object_analytics/marker_publisher");
-
+    loc_subscription_ = this->create_subscription<LocalizationMsg>(
+      "/object_analytics/localization", std::bind(&MarkerPublisher::loc_callback, this, _1),
+      QosProfiles::declare(this, "localization", QosProfiles::kReliable));
+    marker_pub_ = create_publisher<visualization_msgs::msg::MarkerArray>(
+      "/object_analytics/marker_publisher",
+      QosProfiles::declare(this, "output", QosProfiles::kReliable));
+    lifetime_ = declare_parameter<double>("marker_lifetime", 1.0);
+    double marker_rate = declare_parameter<double>("marker_rate", 0.0);
+    marker_interval_ = std::chrono::nanoseconds(marker_rate > 0 ?
+        static_cast<int64_t>(1e9 / marker_rate) : 0);
 
     RCLCPP_INFO(get_logger(), "Start MarkerPublisher ...");
   }
@@ -62,45 +80,97 @@ private:
 
   rclcpp::Publisher<std_msgs::msg::String>::SharedPtr publisher_;
   rclcpp::TimerBase::SharedPtr timer_;
-  rclcpp::Subscription<LocalizationMsg>::SharedPtr loc_marker_subscription_;
-  rclcpp::Subscription<LocalizationMsg>::SharedPtr loc_performance_subscription_;
+  rclcpp::Subscription<LocalizationMsg>::SharedPtr loc_subscription_;
   rclcpp::Subscription<TrackingMsg>::SharedPtr tra_subscription_;
   rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr marker_pub_;
 
-  float loc_latency_;
-  float loc_fps_;
-  float tra_latency_;
-  float tra_fps_;
+  float loc_latency_ = 0;
+  float loc_fps_ = 0;
+  float tra_latency_ = 0;
+  float tra_fps_ = 0;
 
-  /* create 3d boxes of objects */
-  void loc_marker_callback(
-    const LocalizationMsg::SharedPtr loc)
+  /* markers of an object as last published*/
+  struct PublishedObject
+  {
+    geometry_msgs::msg::Point32 min;
+    geometry_msgs::msg::Point32 max;
+    std::string name;
+    rclcpp::Time sent;
+  };
+  std::map<int64_t, PublishedObject> published_;
+  std::string performance_text_;
+  bool cleared_ = false;
+  double lifetime_;
+  std::chrono::nanoseconds marker_interval_;
+  std::chrono::steady_clock::time_point last_marker_;
+
+  /* update statistics, create 3d boxes of objects unless capped by marker_rate*/
+  void loc_callback(const LocalizationMsg::SharedPtr loc)
   {
-    if (loc->objects_in_boxes.size() != 0) {
-      std::vector<LocalizationObjectInBox> objects_localized;
-      std_msgs::msg::Header header = loc->header;
-      objects_localized = loc->objects_in_boxes;
-      MarkerPublisher::createMarker(header, objects_localized);
+    loc_performance(*loc);
+    if (marker_interval_.count() > 0) {
+      auto now = std::chrono::steady_clock::now();
+      if (now - last_marker_ < marker_interval_) {
+        return;
+      }
+      last_marker_ = now;
     }
+    /* an empty frame still deletes the markers of objects gone*/
+    MarkerPublisher::createMarker(loc->header, loc->objects_in_boxes);
+  }
+
+  static bool sameBox(const PublishedObject & p, const LocalizationObjectInBox & loc)
+  {
+    return std::fabs(p.min.x - loc.min.x) < kBoxEpsilon &&
+           std::fabs(p.min.y - loc.min.y) < kBoxEpsilon &&
+           std::fabs(p.min.z - loc.min.z) < kBoxEpsilon &&
+           std::fabs(p.max.x - loc.max.x) < kBoxEpsilon &&
+           std::fabs(p.max.y - loc.max.y) < kBoxEpsilon &&
+           std::fabs(p.max.z - loc.max.z) < kBoxEpsilon;
+  }
+
+  /* marker ID of an object key, tracking IDs wrap into the positive int32 range*/
+  static int32_t markerId(int64_t key)
+  {
+    return key >= 0 ? static_cast<int32_t>(key & 0x7fffffff) : static_cast<int32_t>(key);
   }
 
   void createMarker(
-    std_msgs::msg::Header header,
-    std::vector<LocalizationObjectInBox> loc_objects)
+    const std_msgs::msg::Header & header,
+    const std::vector<LocalizationObjectInBox> & loc_objects)
   {
     visualization_msgs::msg::MarkerArray marker_array_loc;
-    visualization_msgs::msg::Marker marker_clear;
-    marker_array_loc.markers = std::vector<visualization_msgs::msg::Marker>();
-    marker_clear.action = visualization_msgs::msg::Marker::DELETEALL;
-    marker_clear.header = header;
-    marker_array_loc.markers.emplace_back(marker_clear);
-    int marker_id = 0;
-    for (auto loc : loc_objects) {
+    /* markers left by a previous run are cleared once*/
+    if (!cleared_) {
+      visualization_msgs::msg::Marker marker_clear;
+      marker_clear.action = visualization_msgs::msg::Marker::DELETEALL;
+      marker_clear.header = header;
+      marker_array_loc.markers.emplace_back(marker_clear);
+      cleared_ = true;
+    }
+    rclcpp::Time now = this->now();
+    std::set<int64_t> seen;
+    for (size_t i = 0; i < loc_objects.size(); i++) {
+      const LocalizationObjectInBox & loc = loc_objects[i];
       if (loc.min.x == 0 && loc.min.y == 0 && loc.min.z == 0 &&
         loc.max.x == 0 && loc.max.y == 0 && loc.max.z == 0)
       {
         break;
       }
+      int64_t key = loc.id >= 0 ? loc.id : -1 - static_cast<int64_t>(i);
+      seen.insert(key);
+      auto it = published_.find(key);
+      if (it != published_.end() && it->second.name == loc.object.object_name &&
+        sameBox(it->second, loc) &&
+        (lifetime_ <= 0 || (now - it->second.sent).seconds() < lifetime_ / 2))
+      {
+        continue;
+      }
+      PublishedObject & published = published_[key];
+      published.min = loc.min;
+      published.max = loc.max;
+      published.name = loc.object.object_name;
+      published.sent = now;
       geometry_msgs::msg::Point box_min;
       box_min.x = loc.min.x;
       box_min.y = loc.min.y;
@@ -109,29 +179,57 @@ private:
       box_max.x = loc.max.x;
       box_max.y = loc.max.y;
       box_max.z = loc.max.z;
-      std::string obj_name = loc.object.object_name;
       MarkerPublisher::addMarker(marker_array_loc, header, box_min, box_max,
-        obj_name, marker_id);
+        loc.object.object_name, markerId(key));
+    }
+    for (auto it = published_.begin(); it != published_.end(); ) {
+      if (seen.count(it->first) == 0) {
+        MarkerPublisher::addDeleteMarker(marker_array_loc, header, markerId(it->first));
+        it = published_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    MarkerPublisher::addPerformanceMarker(marker_array_loc, header, loc_fps_, loc_latency_);
+    if (!marker_array_loc.markers.empty()) {
+      marker_pub_->publish(marker_array_loc);
+    }
+  }
+
+  /* delete the markers of an object*/
+  void addDeleteMarker(
+    visualization_msgs::msg::MarkerArray & marker_array,
+    const std_msgs::msg::Header & header, int32_t marker_id)
+  {
+    for (const char * ns : {"name", "min", "max", "box"}) {
+      auto marker = visualization_msgs::msg::Marker();
+      marker.header = header;
+      marker.ns = ns;
+      marker.id = marker_id;
+      marker.action = visualization_msgs::msg::Marker::DELETE;
+      marker_array.markers.emplace_back(marker);
     }
-    MarkerPublisher::addPerformanceMarker(marker_array_loc, header, loc_fps_, loc_latency_,
-      ++marker_id);
-    marker_pub_->publish(marker_array_loc);
   }
 
+  /* the performance text is updated once per second, republished only then*/
   void addPerformanceMarker(
     visualization_msgs::msg::MarkerArray & marker_array,
-    std_msgs::msg::Header header, float loc_fps_, float loc_latency_,
-    int & marker_id)
+    const std_msgs::msg::Header & header, float loc_fps_, float loc_latency_)
   {
+    char performance_text[100];
+    snprintf(performance_text, sizeof(performance_text), "Localization:fps=%.2fHz,latency=%.2fSec",
+      loc_fps_, loc_latency_);
+    if (performance_text_ == performance_text) {
+      return;
+    }
+    performance_text_ = performance_text;
+
     auto marker = visualization_msgs::msg::Marker();
     marker.header = header;
-    marker.id = marker_id;
+    marker.ns = "performance";
+    marker.id = 0;
     marker.type = visualization_msgs::msg::Marker::TEXT_VIEW_FACING;
     marker.action = visualization_msgs::msg::Marker::ADD;
-
-    char performance_text[100];
-    snprintf(performance_text, sizeof(performance_text), "Localization:fps=%.2fHz,latency=%.2fSec",
-      loc_fps_, loc_latency_);
     marker.scale.z = 0.05;
     marker.color.a = 1.0;
     marker.color.r = 1.0;
@@ -145,15 +243,26 @@ private:
   }
   /* add the marker composed by object_name, object_id, mix points, max points, 3d box bounaries*/
   void addMarker(
-    visualization_msgs::msg::MarkerArray & marker_array, std_msgs::msg::Header header,
-    geometry_msgs::msg::Point box_min, geometry_msgs::msg::Point box_max,
-    std::string obj_name, int & marker_id)
+    visualization_msgs::msg::MarkerArray & marker_array, const std_msgs::msg::Header & header,
+    const geometry_msgs::msg::Point & box_min, const geometry_msgs::msg::Point & box_max,
+    const std::string & obj_name, int marker_id)
   {
     auto name_id_text_marker =
-      createNameIDMarker(header, box_min, box_max, obj_name, ++marker_id);
-    auto min_text_marker = createTextMarker(header, box_min, "Min", ++marker_id);
-    auto max_text_marker = createTextMarker(header, box_max, "Max", ++marker_id);
-    auto box_line_marker = createBoxLineMarker(header, box_min, box_max, ++marker_id);
+      createNameIDMarker(header, box_min, box_max, obj_name, marker_id);
+    auto min_text_marker = createTextMarker(header, box_min, "Min", marker_id);
+    auto max_text_marker = createTextMarker(header, box_max, "Max", marker_id);
+    auto box_line_marker = createBoxLineMarker(header, box_min, box_max, marker_id);
+    name_id_text_marker.ns = "name";
+    min_text_marker.ns = "min";
+    max_text_marker.ns = "max";
+    box_line_marker.ns = "box";
+    builtin_interfaces::msg::Duration lifetime =
+      rclcpp::Duration(static_cast<rcl_duration_value_t>(lifetime_ * 1e9));
+    for (auto marker : {&name_id_text_marker, &min_text_marker, &max_text_marker,
+        &box_line_marker})
+    {
+      marker->lifetime = lifetime;
+    }
 
     marker_array.markers.emplace_back(min_text_marker);
     marker_array.markers.emplace_back(max_text_marker);
@@ -166,10 +275,10 @@ private:
 
   /* Name and ID marker */
   visualization_msgs::msg::Marker createNameIDMarker(
-    std_msgs::msg::Header header,
-    geometry_msgs::msg::Point box_min,
-    geometry_msgs::msg::Point box_max,
-    std::string & name, int & marker_id)
+    const std_msgs::msg::Header & header,
+    const geometry_msgs::msg::Point & box_min,
+    const geometry_msgs::msg::Point & box_max,
+    const std::string & name, int marker_id)
   {
     auto marker = visualization_msgs::msg::Marker();
     marker.header = header;
@@ -184,8 +293,7 @@ private:
     marker.color.r = 0.0;
     marker.color.g = 1.0;
     marker.color.b = 0.0;
-    std::string name_text = name;
-    marker.text = name_text;
+    marker.text = name;
 
     marker.pose.position.x = (box_min.x + box_max.x) / 2;
     marker.pose.position.y = (box_min.y + box_max.y) / 2;
@@ -195,9 +303,9 @@ private:
 
   /* Min and Max Text Marker */
   visualization_msgs::msg::Marker createTextMarker(
-    std_msgs::msg::Header header,
-    geometry_msgs::msg::Point position,
-    const std::string & name, int & marker_id)
+    const std_msgs::msg::Header & header,
+    const geometry_msgs::msg::Point & position,
+    const std::string & name, int marker_id)
   {
     auto marker = visualization_msgs::msg::Marker();
     marker.header = header;
@@ -233,14 +341,13 @@ private:
 
   /* Box Line Marker */
   visualization_msgs::msg::Marker createBoxLineMarker(
-    std_msgs::msg::Header header,
-    geometry_msgs::msg::Point position_min,
-    geometry_msgs::msg::Point position_max,
-    int & marker_id)
+    const std_msgs::msg::Header & header,
+    const geometry_msgs::msg::Point & position_min,
+    const geometry_msgs::msg::Point & position_max,
+    int marker_id)
   {
     auto marker = visualization_msgs::msg::Marker();
     marker.header = header;
-    marker.ns = "marker_test_line_list";
     marker.id = marker_id;
 
     marker.type = visualization_msgs::msg::Marker::LINE_LIST;
@@ -314,8 +421,8 @@ private:
     return marker;
   }
 
-  /* localization callback for performance test */
-  void loc_performance_callback(const LocalizationMsg::SharedPtr msg)
+  /* localization statistics for performance test */
+  void loc_performance(const LocalizationMsg & msg)
   {
     struct timespec time_start = {0, 0};
     clock_gettime(CLOCK_REALTIME, &time_start);
@@ -325,8 +432,8 @@ private:
     double interval = 0;
     double current_sec = time_start.tv_sec;
     double current_nsec = time_start.tv_nsec;
-    double msg_sec = msg->header.stamp.sec;
-    double msg_nsec = msg->header.stamp.nanosec;
+    double msg_sec = msg.header.stamp.sec;
+    double msg_nsec = msg.header.stamp.nanosec;
 
     count++;
     interval = (current_sec - last_sec) + ((current_nsec - last_nsec) / 1000000000);